@@ -244,6 +244,15 @@ lws_adopt_socket_vhost_readbuf(struct lws_vhost *vhost,
 #define LWS_CAUDP_BIND (1 << 0)
 #define LWS_CAUDP_BROADCAST (1 << 1)
 #define LWS_CAUDP_PF_PACKET (1 << 2)
+#define LWS_CAUDP_MMSG (1 << 3)
+	/**< rx with recvmmsg(), delivered in LWS_CALLBACK_RAW_RX_BATCH, and
+	 * allow tx batching with lws_udp_queue() */
+#define LWS_CAUDP_GRO (1 << 4)
+	/**< like LWS_CAUDP_MMSG, but also let the kernel coalesce rx with
+	 * UDP_GRO, they are split back into datagrams for you */
+#define LWS_CAUDP_GSO (1 << 5)
+	/**< like LWS_CAUDP_MMSG, but also send runs of same-size datagrams
+	 * to the same peer as one UDP_SEGMENT send */
 
 #if defined(LWS_WITH_UDP)
 /**
@@ -252,7 +261,7 @@ lws_adopt_socket_vhost_readbuf(struct lws_vhost *vhost,
  * \param vhost:	 lws vhost
  * \param ads:		 NULL or address to do dns lookup on
  * \param port:		 UDP port to bind to, -1 means unbound
- * \param flags:	 0 or LWS_CAUDP_NO_BIND
+ * \param flags:	 0 or OR-ed LWS_CAUDP_ flags
  * \param protocol_name: Name of protocol on vhost to bind wsi to
  * \param ifname:	 NULL, for network interface name to bind socket to
  * \param parent_wsi:	 NULL or parent wsi new wsi will be a child of
@@ -272,6 +281,51 @@ lws_create_adopt_udp(struct lws_vhost *vhost, const char *ads, int port,
 		     int flags, const char *protocol_name, const char *ifname,
 		     struct lws *parent_wsi, void *opaque,
 		     const lws_retry_bo_t *retry_policy, const char *fi_wsi_name);
+
+#if defined(LWS_WITH_UDP_MMSG)
+/*
+ * One datagram in the array passed to LWS_CALLBACK_RAW_RX_BATCH
+ */
+typedef struct lws_udp_dgram {
+	const uint8_t		*buf;	/**< datagram payload */
+	size_t			len;	/**< datagram length */
+	lws_sockaddr46		sa46;	/**< peer that sent it */
+} lws_udp_dgram_t;
+
+/**
+ * lws_udp_queue() - queue a datagram on a batched UDP wsi
+ *
+ * \param wsi:	 UDP wsi created with LWS_CAUDP_MMSG
+ * \param buf:	 datagram payload, copied, it needs no LWS_PRE
+ * \param len:	 datagram length
+ * \param dest: NULL to send to the last peer we heard from (or the peer the
+ *		 socket was connected to), else the peer to send it to
+ *
+ * Datagrams are copied into a per-wsi queue, and sent with as few
+ * sendmmsg() as possible when the queue is flushed.  lws flushes it for you
+ * after LWS_CALLBACK_RAW_RX_BATCH and LWS_CALLBACK_RAW_WRITEABLE return, if
+ * you queue from elsewhere, call lws_udp_flush() when you're done.
+ *
+ * Returns 0 if queued, 1 if the queue is full and the kernel won't take
+ * any more yet, you'll get a LWS_CALLBACK_RAW_WRITEABLE when it drained, or
+ * -1 for fatal error.
+ */
+LWS_VISIBLE LWS_EXTERN int
+lws_udp_queue(struct lws *wsi, const uint8_t *buf, size_t len,
+	      const lws_sockaddr46 *dest);
+
+/**
+ * lws_udp_flush() - send what's queued on a batched UDP wsi
+ *
+ * \param wsi:	 UDP wsi created with LWS_CAUDP_MMSG
+ *
+ * Returns 0 if the queue was sent, 1 if the kernel pushed back and some is
+ * still queued (it's sent when the socket is writeable, before the next
+ * LWS_CALLBACK_RAW_WRITEABLE), or -1 for fatal error.
+ */
+LWS_VISIBLE LWS_EXTERN int
+lws_udp_flush(struct lws *wsi);
+#endif
 #endif
 
 
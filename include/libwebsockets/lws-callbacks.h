@@ -777,6 +777,12 @@ enum lws_callback_reasons {
 	LWS_CALLBACK_RAW_CONNECTED				= 101,
 	/**< outgoing client RAW mode connection was connected */
 
+	LWS_CALLBACK_RAW_RX_BATCH				= 106,
+	/**< UDP wsi created with LWS_CAUDP_MMSG received one or more
+	 * datagrams.  in points to an array of lws_udp_dgram_t and len is
+	 * the number of them.  The datagram buffers are only valid during
+	 * the callback. */
+
 	LWS_CALLBACK_RAW_SKT_BIND_PROTOCOL			= 81,
 	LWS_CALLBACK_RAW_SKT_DROP_PROTOCOL			= 82,
 
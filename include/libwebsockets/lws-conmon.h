@@ -78,6 +78,32 @@ typedef enum lws_conmon_dns_disposition {
 	/**< DNS server replied but nothing usable */
 } lws_conmon_dns_disposition_t;
 
+typedef enum lws_conmon_attempt_disposition {
+	LWSCONMON_ATTEMPT_ONGOING,
+	/**< the connection ended before the attempt did */
+	LWSCONMON_ATTEMPT_CONNECTED			= 1,
+	/**< this is the attempt the connection was made with */
+	LWSCONMON_ATTEMPT_FAILED			= 2,
+	/**< the attempt failed, eg, it was refused */
+	LWSCONMON_ATTEMPT_TIMED_OUT			= 3,
+	/**< the attempt got no answer in time */
+	LWSCONMON_ATTEMPT_CANCELLED			= 4,
+	/**< a different attempt made the connection first */
+} lws_conmon_attempt_disposition_t;
+
+#define LWS_CONMON_MAX_ATTEMPTS 6
+
+typedef struct lws_conmon_attempt {
+	lws_sockaddr46				peer46;
+	/**< the DNS result this attempt tried to connect to */
+	lws_conmon_interval_us_t		ciu_start;
+	/**< us after the first attempt that this attempt started */
+	lws_conmon_interval_us_t		ciu_attempt;
+	/**< us the attempt took to reach its disposition */
+	uint8_t					disposition;
+	/**< lws_conmon_attempt_disposition_t */
+} lws_conmon_attempt_t;
+
 struct lws_conmon {
 	lws_sockaddr46				peer46;
 	/**< The peer we actually connected to, if any.  .peer46.sa4.sa_family
@@ -119,6 +145,13 @@ struct lws_conmon {
 
 	lws_conmon_dns_disposition_t		dns_disposition;
 	/**< indicates general disposition of DNS request */
+
+	lws_conmon_attempt_t			attempts[LWS_CONMON_MAX_ATTEMPTS];
+	/**< the first count_attempts socket connection attempts, in the
+	 * order they were started.  With LWS_WITH_HAPPY_EYEBALLS, several
+	 * may have been in flight at the same time */
+	uint8_t					count_attempts;
+	/**< how many of attempts[] are valid */
 };
 
 /**
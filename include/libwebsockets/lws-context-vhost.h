@@ -242,6 +242,59 @@
 #define LWS_SERVER_OPTION_DISABLE_TLS_SESSION_CACHE		 (1ll << 39)
 	/**< (VHOST) Disallow use of client tls caching (on by default) */
 
+#define LWS_SERVER_OPTION_EPOLL					 (1ll << 40)
+	/**< (CTX) Use the built-in Linux epoll event loop instead of poll() */
+
+#define LWS_SERVER_OPTION_IO_URING				 (1ll << 41)
+	/**< (CTX) Use the built-in Linux io_uring event loop instead of poll() */
+
+#define LWS_SERVER_OPTION_KTLS					 (1ll << 42)
+	/**< (VHOST) Ask OpenSSL to hand the connection's record layer to the
+	 * kernel (kTLS) after the handshake, where the kernel and OpenSSL
+	 * support it.  Tx then uses plain socket writes and static files can
+	 * go out by sendfile() over https.  Connections the kernel won't take
+	 * silently stay in userspace tls, see lws_tls_ktls_state(). */
+
+#define LWS_SERVER_OPTION_SMP_LISTEN_SHARD			 (1ll << 43)
+	/**< (VHOST) On Linux with more than one service thread, each service
+	 * thread already gets its own SO_REUSEPORT listen socket for the vhost.
+	 * Normally connections accepted there are handed to whichever service
+	 * thread is least busy.  With this, they stay on the service thread
+	 * whose listen socket accepted them, so the kernel's reuseport
+	 * distribution decides the sharding and accepts don't cross threads. */
+
+#define LWS_SERVER_OPTION_SMP_LISTEN_STEER_CPU			 (1ll << 44)
+	/**< (VHOST) With LWS_SERVER_OPTION_SMP_LISTEN_SHARD, also attach a
+	 * reuseport bpf program that picks service thread n's listen socket
+	 * for connections arriving on cpu n (mod the number of service
+	 * threads), and set SO_INCOMING_CPU on them to match.  This only makes
+	 * sense if you pin service thread n to cpu n and the nic spreads its
+	 * irqs over those cpus. */
+
+#define LWS_SERVER_OPTION_H2_PRIORITY				 (1ll << 45)
+	/**< (VHOST) Share out writeable callbacks among the streams on an h2
+	 * connection by priority, instead of taking them in turn.  Streams
+	 * with a better RFC9218 urgency (from a "priority:" request header)
+	 * go first, non-incremental streams of the same urgency go one at a
+	 * time, and the rest share bandwidth according to their RFC7540
+	 * weight.  Streams that didn't say anything are treated as urgency 3,
+	 * incremental, weight 16, so they share as before. */
+
+#define LWS_SERVER_OPTION_WS_LAZY_RX_BUF			 (1ll << 46)
+	/**< (VHOST) Ws connections normally allocate an rx buffer of their
+	 * protocol's rx_buffer_size when they are established, and keep it
+	 * until they close.  With this, they only hold one while they have
+	 * frame payload to collect, and give it back to a small per-service
+	 * thread pool when they go idle, which saves a lot of memory when
+	 * most connections are idle most of the time. */
+
+#define LWS_SERVER_OPTION_VH_HTTP_PRECOMPRESSED			 (1ll << 47)
+	/**< (VHOST) When serving file.ext from a mount, if file.ext.br or
+	 * file.ext.gz exists, is not older than file.ext, and the client
+	 * accepts that encoding, serve that instead with the matching
+	 * Content-Encoding: (brotli is preferred if the client has no
+	 * preference) */
+
 
 	/****** add new things just above ---^ ******/
 
@@ -933,6 +986,59 @@ struct lws_context_creation_info {
 	 */
 #endif
 
+#if defined(LWS_WITH_ACCESS_LOG)
+	unsigned int				log_ring_size;
+	/**< VHOST: 0 for default of 64KB, or the size of the ring completed
+	 * access log lines wait on before being written to log_filepath.  If
+	 * it fills, new lines are dropped and counted in the vhost's .alog
+	 * metric instead of waiting for the disk. */
+	unsigned int				log_batch;
+	/**< VHOST: 0 for default of half the ring, or the number of bytes of
+	 * queued lines that causes them to be written out immediately */
+	unsigned int				log_latency_ms;
+	/**< VHOST: 0 for default of 1000ms, or the longest a queued line
+	 * waits before being written out if the batch doesn't fill */
+#endif
+
+	unsigned int				http_header_pool_prealloc;
+	/**< CONTEXT: 0, or how many ah (the storage for one http request's
+	 * headers, see max_http_header_data) each service thread allocates
+	 * in one block at context creation, up to max_http_header_pool.
+	 * Detached ah are always kept for reuse instead of being freed, but
+	 * ones beyond this count are freed after being unused for 10s. */
+
+#if defined(LWS_WITH_WSI_SLAB)
+	void *(*slab_chunk_alloc)(struct lws_context *cx, size_t len);
+	/**< CONTEXT: NULL to use lws_malloc(), or a function returning len
+	 * bytes of memory for the per-service thread slab caches that struct
+	 * lws and the per-connection role structs are allocated from.  Chunks
+	 * hold 16 objects of one kind; one wholly unused chunk per kind is
+	 * kept, the others are given back via slab_chunk_free. */
+	void (*slab_chunk_free)(struct lws_context *cx, void *p);
+	/**< CONTEXT: NULL to use lws_free(), or a function that takes back a
+	 * chunk that slab_chunk_alloc returned */
+#endif
+
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+	unsigned int				connect_attempt_delay_ms;
+	/**< VHOST: 0 for default of 250ms, or how long a client connection
+	 * attempt to one DNS result is given before an attempt to the next
+	 * one is started alongside it (RFC 8305 "Connection Attempt Delay").
+	 * The first attempt to connect wins, the others are closed. */
+#endif
+
+#if defined(LWS_WITH_HTTP_STREAM_COMPRESSION) && defined(LWS_WITH_DISKCACHE)
+	const char				*http_compression_cache_dir;
+	/**< VHOST: NULL, or a directory to keep the output of compressing
+	 * files served from mounts on the fly, eg, "/var/cache/lws-comp".  The
+	 * next request for the same file, modification time and encoding is
+	 * served from there instead of being compressed again.  The string
+	 * must exist for the life of the vhost. */
+	uint64_t				http_compression_cache_size;
+	/**< VHOST: 0 for default of 64MiB, or the size the compression cache
+	 * is trimmed to, oldest first */
+#endif
+
 	/* Add new things just above here ---^
 	 * This is part of the ABI, don't needlessly break compatibility
 	 *
@@ -337,6 +337,9 @@ enum lws_token_indexes {
 #endif
 	WSI_TOKEN_X_AUTH_TOKEN,
 	WSI_TOKEN_DSS_SIGNATURE,
+#if defined(LWS_ROLE_H2) || defined(LWS_HTTP_HEADERS_ALL)
+	WSI_TOKEN_HTTP_PRIORITY, /* RFC9218 */
+#endif
 
 	/****** add new things just above ---^ ******/
 
@@ -208,10 +208,13 @@ struct _lejp_stack {
 	char			b; /* user bitfield */
 };
 
+struct lejp_path_table;
+
 struct _lejp_parsing_stack {
 	void			*user;	/* private to the stack level */
 	signed char 		(*callback)(struct lejp_ctx *ctx, char reason);
 	const char * const	*paths;
+	const struct lejp_path_table *pt; /* NULL, or compiled paths */
 	uint8_t			count_paths;
 	uint8_t			ppos;
 	uint8_t			path_match;
@@ -297,6 +300,53 @@ lejp_parser_push(struct lejp_ctx *ctx, void *user, const char * const *paths,
 LWS_VISIBLE LWS_EXTERN int
 lejp_parser_pop(struct lejp_ctx *ctx);
 
+/**
+ * lejp_path_table_create() - compile a table of paths for faster matching
+ *
+ * \param paths: your array of name elements, as for lejp_construct()
+ * \param count_paths: LWS_ARRAY_SIZE() of \p paths
+ * \param stride: 0 if \p paths is an array of char *, else the size of the
+ *		  structs whose first member is the char *, as for path_stride
+ *
+ * Each time lejp parses a member name, it compares the JSON path against
+ * each of the paths in turn, which gets costly for tables with many paths.
+ * This compiles the table once into a trie, so the matching costs in
+ * proportion to the length of the JSON path, however many paths there are.
+ * Use lejp_set_path_table() after each lejp_construct() to use it.
+ *
+ * The path strings are not copied and must outlive the compiled table.
+ * Matching doesn't change the compiled table, so it may be shared by any
+ * number of lejp_ctx, on any thread.
+ *
+ * Returns NULL on OOM or if the table is too large to compile, lejp can
+ * still use the table as it is then.
+ */
+LWS_VISIBLE LWS_EXTERN struct lejp_path_table *
+lejp_path_table_create(const char * const *paths, unsigned char count_paths,
+		       size_t stride);
+
+/**
+ * lejp_path_table_destroy() - free a compiled path table
+ *
+ * \param pt: pointer to the compiled path table pointer, set to NULL after
+ */
+LWS_VISIBLE LWS_EXTERN void
+lejp_path_table_destroy(struct lejp_path_table **pt);
+
+/**
+ * lejp_set_path_table() - match using a compiled path table
+ *
+ * \param ctx: the lejp_ctx
+ * \param pt: compiled path table from lejp_path_table_create(), or NULL
+ *
+ * Sets the paths at the current parser stack level to the ones \p pt was
+ * compiled from, and matches using \p pt from then on.  Call it after
+ * lejp_construct() for the top level, or after lejp_parser_push() for a
+ * pushed level.  Both of those start out matching without a compiled table.
+ */
+LWS_VISIBLE LWS_EXTERN void
+lejp_set_path_table(struct lejp_ctx *ctx, const struct lejp_path_table *pt);
+
 /* exported for use when reevaluating a path for use with a subcontext */
 LWS_VISIBLE LWS_EXTERN void
 lejp_check_path_match(struct lejp_ctx *ctx);
@@ -869,6 +869,21 @@ lws_get_tsi(struct lws *wsi);
  */
 LWS_VISIBLE LWS_EXTERN int
 lws_is_ssl(struct lws *wsi);
+
+#define LWS_TLS_KTLS_TX		(1 << 0)
+#define LWS_TLS_KTLS_RX		(1 << 1)
+
+/**
+ * lws_tls_ktls_state() - Find out if the kernel is doing the connection's tls
+ * \param wsi:	connection to check
+ *
+ * Returns a bitmap of LWS_TLS_KTLS_TX and LWS_TLS_KTLS_RX, showing which
+ * directions of the tls tunnel the kernel took over after the handshake, when
+ * the vhost had LWS_SERVER_OPTION_KTLS.  Zero means the tls, if any, is all
+ * being done in userspace.  h2 streams report their network connection.
+ */
+LWS_VISIBLE LWS_EXTERN int
+lws_tls_ktls_state(struct lws *wsi);
 /**
  * lws_is_cgi() - find out if this wsi is running a cgi process
  *
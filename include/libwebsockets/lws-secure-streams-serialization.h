@@ -596,6 +596,16 @@ extern const lws_transport_proxy_ops_t lws_transport_mux_proxy_ops;
 extern const lws_transport_client_ops_t lws_txp_inside_sspc;
 extern const lws_transport_proxy_ops_t lws_txp_inside_proxy;
 
+#if defined(LWS_WITH_SECURE_STREAMS_PROXY_SHM)
+/*
+ * Linux-only transport passing the serialized streams through a pair of
+ * shared memory rings, with a Unix Domain Socket just for the rendezvous.
+ * Select with info.txp_ops_sspc / info.txp_ops_ssproxy on both sides.
+ */
+extern const lws_transport_client_ops_t lws_transport_shm_client_ops;
+extern const lws_transport_proxy_ops_t lws_transport_shm_proxy_ops;
+#endif
+
 #if defined(STANDALONE)
 #undef lws_context
 #endif
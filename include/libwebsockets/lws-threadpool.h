@@ -68,6 +68,10 @@ enum lws_threadpool_task_return {
 struct lws_threadpool_create_args {
 	int threads;
 	int max_queue_depth;
+	int cpu_affinity;
+	/**< 0 leaves the workers to the scheduler, otherwise worker n is
+	 * pinned to cpu (cpu_affinity - 1 + n) modulo the cpus online.  Only
+	 * has an effect where pthread_setaffinity_np() is available */
 };
 
 struct lws_threadpool_task_args {
@@ -106,6 +110,13 @@ struct lws_threadpool_task_args {
  * Creates a pool of worker threads with \p threads and a queue of up to
  * \p max_queue_depth waiting tasks if all the threads are busy.
  *
+ * Each worker has its own queue and done list with its own lock, so
+ * enqueueing from several service threads and workers finishing tasks
+ * don't all contend on one lock.  A worker with nothing on its own queue
+ * takes the newest task waiting on another worker's queue.  The queue
+ * depth limit applies to the sum of the workers' queues, and is approximate
+ * when more than one service thread is enqueueing at the same time.
+ *
  * Returns NULL if OOM, or a struct lws_threadpool pointer that must be
  * destroyed by lws_threadpool_destroy().
  */
@@ -154,6 +165,9 @@ lws_threadpool_destroy(struct lws_threadpool *tp);
  * The args defines the wsi, a user-private pointer, a timeout in secs and
  * a pointer to the task function.
  *
+ * When the task completes, only the service thread the wsi is bound to is
+ * woken to reap it.
+ *
  * Returns NULL or an opaque pointer to the queued (or running, or completed)
  * task.
  *
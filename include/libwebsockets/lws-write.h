@@ -240,6 +240,84 @@ lws_write_ws_flags(int initial, int is_start, int is_end)
 	return r;
 }
 
+#if defined(LWS_ROLE_WS)
+/*
+ * Encode-once ws broadcast
+ *
+ * When the same message goes to many ws connections, using lws_write() on
+ * each one means it's framed, and if permessage-deflate is active compressed,
+ * once per connection.  Instead you can wrap the message in a broadcast
+ * object and queue that on each connection: lws frames it once for each
+ * distinct wire format in use (uncompressed, or compressed with a particular
+ * window size) and writes the same bytes to every connection.
+ *
+ * The compressed forms are made without context takeover, so they can be
+ * decoded by any peer at a message boundary.  Connections whose own
+ * compressor keeps context reset it after a broadcast went out on them.
+ *
+ * Queued broadcasts are sent when the connection is writeable, between whole
+ * messages and before your WRITEABLE callback gets a chance to write.
+ *
+ * All of these must be used from the service thread of the connections.
+ */
+struct lws_ws_bcast;
+
+/**
+ * lws_ws_bcast_create() - make a broadcast object from a message
+ *
+ * \param buf: the message payload, no LWS_PRE needed
+ * \param len: length of the payload
+ * \param wp: LWS_WRITE_TEXT or LWS_WRITE_BINARY
+ *
+ * Copies the payload into a new, refcounted broadcast object and returns it
+ * holding one reference for the caller, or NULL on OOM.  Queue it on as many
+ * connections as you like with lws_ws_bcast_queue(), then drop the caller's
+ * reference with lws_ws_bcast_release().  It's freed when the last connection
+ * finished writing it.
+ */
+LWS_VISIBLE LWS_EXTERN struct lws_ws_bcast *
+lws_ws_bcast_create(const uint8_t *buf, size_t len,
+		    enum lws_write_protocol wp);
+
+/**
+ * lws_ws_bcast_queue() - queue a broadcast on a ws connection
+ *
+ * \param wsi: the ws connection to send it on
+ * \param b: the broadcast object
+ *
+ * Takes a reference on \p b and asks for a writeable callback on \p wsi.
+ *
+ * Returns 0 if it was queued, -1 on OOM or if too many broadcasts are
+ * already queued on \p wsi, or 1 if \p wsi can't take a shared frame (client
+ * connections that must mask, ws-over-h2 streams, or active extensions other
+ * than permessage-deflate).  In that case, send the message on \p wsi with
+ * lws_write() as usual.
+ */
+LWS_VISIBLE LWS_EXTERN int
+lws_ws_bcast_queue(struct lws *wsi, struct lws_ws_bcast *b);
+
+/**
+ * lws_ws_bcast_release() - drop a reference on a broadcast object
+ *
+ * \param b: the broadcast object
+ *
+ * The object is freed when the last reference is dropped.
+ */
+LWS_VISIBLE LWS_EXTERN void
+lws_ws_bcast_release(struct lws_ws_bcast *b);
+
+/**
+ * lws_ws_bcast_pending() - count broadcasts queued on a connection
+ *
+ * \param wsi: the ws connection
+ *
+ * Returns how many broadcasts are waiting to be sent on \p wsi, eg, so you
+ * can notice and deal with a peer that is not keeping up.
+ */
+LWS_VISIBLE LWS_EXTERN unsigned int
+lws_ws_bcast_pending(struct lws *wsi);
+#endif
+
 /**
  * lws_raw_transaction_completed() - Helper for flushing before close
  *
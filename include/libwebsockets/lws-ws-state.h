@@ -90,4 +90,5 @@ lws_partial_buffered(struct lws *wsi);
  */
 LWS_VISIBLE LWS_EXTERN int LWS_WARN_UNUSED_RESULT
 lws_frame_is_binary(struct lws *wsi);
+
 ///@}
@@ -119,7 +119,7 @@ lws_create_new_server_wsi(struct lws_vhost *vhost, int fixed_tsi, int group,
 static struct lws *
 __lws_adopt_descriptor_vhost1(struct lws_vhost *vh, lws_adoption_type type,
 			    const char *vh_prot_name, struct lws *parent,
-			    void *opaque, const char *fi_wsi_name)
+			    void *opaque, const char *fi_wsi_name, int tsi)
 {
 	struct lws_context *context;
 	struct lws_context_per_thread *pt;
@@ -139,7 +139,7 @@ __lws_adopt_descriptor_vhost1(struct lws_vhost *vh, lws_adoption_type type,
 
 	lws_context_assert_lock_held(vh->context);
 
-	n = -1;
+	n = tsi;
 	if (parent)
 		n = parent->tsi;
 	new_wsi = lws_create_new_server_wsi(vh, n, LWSLCG_WSI_SERVER, fi_wsi_name);
@@ -221,7 +221,7 @@ bail:
 	lws_pt_unlock(pt);
 	__lws_vhost_unbind_wsi(new_wsi); /* req cx, acq vh lock */
 
-	lws_free(new_wsi);
+	lws_slab_free(new_wsi);
 
 	return NULL;
 }
@@ -495,6 +495,17 @@ lws_adopt_descriptor_vhost(struct lws_vhost *vh, lws_adoption_type type,
 
 struct lws *
 lws_adopt_descriptor_vhost_via_info(const lws_adopt_desc_t *info)
+{
+	return lws_adopt_descriptor_vhost_tsi(info, -1);
+}
+
+/*
+ * tsi -1 means put it on the least busy service thread, otherwise it goes on
+ * the given one (unless there's a parent, it always goes with the parent)
+ */
+
+struct lws *
+lws_adopt_descriptor_vhost_tsi(const lws_adopt_desc_t *info, int tsi)
 {
 	socklen_t slen = sizeof(lws_sockaddr46);
 	struct lws *new_wsi;
@@ -524,7 +535,8 @@ lws_adopt_descriptor_vhost_via_info(const lws_adopt_desc_t *info)
 
 	new_wsi = __lws_adopt_descriptor_vhost1(info->vh, info->type,
 					      info->vh_prot_name, info->parent,
-					      info->opaque, info->fi_wsi_name);
+					      info->opaque, info->fi_wsi_name,
+					      tsi);
 	if (!new_wsi) {
 		if (info->type & LWS_ADOPT_SOCKET)
 			compatible_close(info->fd.sockfd);
@@ -719,6 +731,10 @@ lws_create_adopt_udp2(struct lws *wsi, const char *ads,
 			       (const char *)&bc, sizeof(bc)) < 0)
 			lwsl_err("%s: failed to set broadcast\n", __func__);
 
+#if defined(LWS_WITH_UDP_MMSG)
+		lws_udp_mmsg_skt_options(wsi, sock.sockfd);
+#endif
+
 		/* Bind the udp socket to a particular network interface */
 
 		if (opaque &&
@@ -816,7 +832,7 @@ lws_create_adopt_udp(struct lws_vhost *vhost, const char *ads, int port,
 	wsi = __lws_adopt_descriptor_vhost1(vhost, LWS_ADOPT_SOCKET |
 						 LWS_ADOPT_RAW_SOCKET_UDP,
 					  protocol_name, parent_wsi, opaque,
-					  fi_wsi_name);
+					  fi_wsi_name, -1);
 
 	lws_context_unlock(vhost->context);
 	if (!wsi) {
@@ -835,6 +851,15 @@ lws_create_adopt_udp(struct lws_vhost *vhost, const char *ads, int port,
 	else
 		wsi->retry_policy = vhost->retry_policy;
 
+#if defined(LWS_WITH_UDP_MMSG)
+	if ((flags & (LWS_CAUDP_MMSG | LWS_CAUDP_GRO | LWS_CAUDP_GSO)) &&
+	    lws_udp_mmsg_create(wsi, flags)) {
+		lws_close_free_wsi(wsi, LWS_CLOSE_STATUS_NOSTATUS,
+				   "udp mmsg alloc fail");
+		return NULL;
+	}
+#endif
+
 #if !defined(LWS_WITH_SYS_ASYNC_DNS)
 	{
 		struct addrinfo *r, h;
@@ -133,6 +133,60 @@ lws_conmon_addrinfo_destroy(struct addrinfo *ai)
 	}
 }
 
+/*
+ * Each socket connection attempt gets a record in the conmon of the wsi the
+ * connection is for.  With happy eyeballs, an attempt may be being made by a
+ * raced wsi on behalf of that one.
+ */
+
+void
+lws_conmon_attempt_start(struct lws *wsi)
+{
+	struct lws *w = wsi;
+	lws_conmon_attempt_t *a;
+	lws_usec_t now = lws_now_usecs();
+
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+	w = lws_client_he_owner(wsi);
+#endif
+
+	wsi->conmon_attempt = 0;
+	if (w->conmon.count_attempts == LWS_CONMON_MAX_ATTEMPTS)
+		return;
+
+	if (!w->conmon.count_attempts)
+		w->conmon_first_attempt = now;
+
+	a = &w->conmon.attempts[w->conmon.count_attempts++];
+	a->peer46 = wsi->sa46_peer;
+	a->ciu_start = (lws_conmon_interval_us_t)(now - w->conmon_first_attempt);
+	a->ciu_attempt = 0;
+	a->disposition = LWSCONMON_ATTEMPT_ONGOING;
+
+	wsi->conmon_attempt = w->conmon.count_attempts;
+}
+
+void
+lws_conmon_attempt_end(struct lws *wsi, lws_conmon_attempt_disposition_t disp)
+{
+	struct lws *w = wsi;
+	lws_conmon_attempt_t *a;
+
+	if (!wsi->conmon_attempt)
+		return;
+
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+	w = lws_client_he_owner(wsi);
+#endif
+
+	a = &w->conmon.attempts[wsi->conmon_attempt - 1];
+	a->ciu_attempt = (lws_conmon_interval_us_t)(lws_now_usecs() -
+			w->conmon_first_attempt) - a->ciu_start;
+	a->disposition = (uint8_t)disp;
+
+	wsi->conmon_attempt = 0;
+}
+
 void
 lws_conmon_wsi_take(struct lws *wsi, struct lws_conmon *dest)
 {
@@ -158,6 +158,7 @@ lws_client_connect_3_connect(struct lws *wsi, const char *ads,
 	uint16_t port = wsi->conn_port;
 	char dcce[48], t16[16];
 	lws_dns_sort_t *curr;
+	struct lws *cw = wsi;
 	ssize_t plen = 0;
 	lws_dll2_t *d;
 #if defined(LWS_WITH_SYS_FAULT_INJECTION)
@@ -189,6 +190,12 @@ lws_client_connect_3_connect(struct lws *wsi, const char *ads,
 		freeaddrinfo((struct addrinfo *)result);
 #endif
 		result = NULL;
+
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+		if (lwsi_state(wsi) == LRS_WAITING_CONNECT)
+			/* results arriving while we connect can be raced */
+			lws_client_he_arm(wsi, 0);
+#endif
 	}
 
 #if defined(LWS_WITH_UNIX_SOCK)
@@ -204,6 +211,11 @@ lws_client_connect_3_connect(struct lws *wsi, const char *ads,
 	if (!lws_dll2_is_detached(&wsi->dll2_cli_txn_queue))
 		return wsi;
 
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+	/* if we are a raced attempt, this is the wsi we are connecting for */
+	cw = lws_client_he_owner(wsi);
+#endif
+
 	if (n &&  /* calling back with a problem */
 	    !wsi->dns_sorted_list.count && /* there's no results */
 	    !lws_socket_is_valid(wsi->desc.sockfd) && /* no attempt ongoing */
@@ -243,6 +255,13 @@ lws_client_connect_3_connect(struct lws *wsi, const char *ads,
 			/*
 			 * Oh, it has happened...
 			 */
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+			if (wsi->he_speculative) {
+				/* ... for an attempt we raced for another wsi */
+				lws_client_he_won(wsi);
+				return NULL;
+			}
+#endif
 			goto conn_good;
 		case LCCCR_CONTINUE:
 			return NULL;
@@ -432,10 +451,10 @@ ads_known:
 		lws_set_timeout(wsi, PENDING_TIMEOUT_AWAITING_CONNECT_RESPONSE,
 				wsi->a.vhost->connect_timeout_secs);
 
-		iface = lws_wsi_client_stash_item(wsi, CIS_IFACE,
+		iface = lws_wsi_client_stash_item(cw, CIS_IFACE,
 						  _WSI_TOKEN_CLIENT_IFACE);
 
-		local_port = lws_wsi_client_stash_item(wsi, CIS_LOCALPORT,
+		local_port = lws_wsi_client_stash_item(cw, CIS_LOCALPORT,
 						  _WSI_TOKEN_CLIENT_LOCALPORT);
 
 		if ((iface && *iface) || (local_port && atoi(local_port))) {
@@ -492,8 +511,8 @@ ads_known:
 	wsi->socket_is_permanently_unusable = 0;
 
 	if (lws_fi(&wsi->fic, "conn_cb_rej") ||
-	    user_callback_handle_rxflow(wsi->a.protocol->callback, wsi,
-			LWS_CALLBACK_CONNECTING, wsi->user_space,
+	    user_callback_handle_rxflow(cw->a.protocol->callback, cw,
+			LWS_CALLBACK_CONNECTING, cw->user_space,
 			(void *)(intptr_t)wsi->desc.sockfd, 0)) {
 		lwsl_wsi_info(wsi, "CONNECTION CB closed");
 		goto failed1;
@@ -518,6 +537,7 @@ ads_known:
 #if defined(LWS_WITH_CONMON)
 	wsi->conmon_datum = lws_now_usecs();
 	wsi->conmon.ciu_sockconn = 0;
+	lws_conmon_attempt_start(wsi);
 #endif
 
 	if (m == -1) {
@@ -617,6 +637,11 @@ ads_known:
 		if (lws_change_pollfd(wsi, 0, LWS_POLLOUT))
 			goto try_next_dns_result_fds;
 
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+		/* race the next DNS result if this is still going later */
+		lws_client_he_arm(wsi, 1);
+#endif
+
 		return wsi;
 	}
 
@@ -629,6 +654,7 @@ conn_good:
 #if defined(LWS_WITH_CONMON)
 	wsi->conmon.ciu_sockconn = (lws_conmon_interval_us_t)
 					(lws_now_usecs() - wsi->conmon_datum);
+	lws_conmon_attempt_end(wsi, LWSCONMON_ATTEMPT_CONNECTED);
 #endif
 
 #if !defined(LWS_PLAT_OPTEE)
@@ -657,6 +683,10 @@ conn_good:
 #endif
 
 	lws_sul_cancel(&wsi->sul_connect_timeout);
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+	/* any attempts we raced lost */
+	lws_client_he_cancel(wsi);
+#endif
 	lws_metrics_caliper_report(wsi->cal_conn, METRES_GO);
 
 	lws_addrinfo_clean(wsi);
@@ -712,8 +742,14 @@ connect_to:
 	 * It looks like the sul_connect_timeout fired
 	 */
 	lwsl_wsi_info(wsi, "abandoning connect due to timeout");
+#if defined(LWS_WITH_CONMON)
+	lws_conmon_attempt_end(wsi, LWSCONMON_ATTEMPT_TIMED_OUT);
+#endif
 
 try_next_dns_result_fds:
+#if defined(LWS_WITH_CONMON)
+	lws_conmon_attempt_end(wsi, LWSCONMON_ATTEMPT_FAILED);
+#endif
 	lws_pt_lock(pt, __func__);
 	__remove_wsi_socket_from_fds(wsi);
 	lws_pt_unlock(pt);
@@ -730,6 +766,10 @@ try_next_dns_result:
 	if (lws_dll2_get_head(&wsi->dns_sorted_list))
 		goto next_dns_result;
 
+	if (wsi->speculative_connect_owner.count)
+		/* attempts raced for us are still going, one may connect */
+		return wsi;
+
 	lws_addrinfo_clean(wsi);
 	lws_inform_client_conn_fail(wsi, (void *)cce, strlen(cce));
 
@@ -0,0 +1,296 @@
+/*
+ * libwebsockets - small server side websockets and web server implementation
+ *
+ * Copyright (C) 2010 - 2021 Andy Green <andy@warmcat.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * Happy Eyeballs (RFC 8305) connection attempt racing
+ *
+ * Otherwise connect3 tries the sorted DNS results one after another, and an
+ * attempt to an address that silently drops our SYNs has to time out before
+ * the next one is tried.
+ *
+ * Here, if an attempt is still in progress after the vhost's
+ * connect_attempt_delay_ms, an attempt to the next DNS result is started
+ * alongside it, and so on.  Each raced attempt is made by a bare wsi listed
+ * on the speculative_connect_owner of the wsi the connection is for, with its
+ * own socket in the fds table and going through connect3 like any other.
+ *
+ * The first attempt to connect wins.  If it was a raced one, its socket is
+ * moved over to the real wsi.  Then all the other attempts are closed.
+ *
+ * Because the socket moves between wsi, we only race on event loops that
+ * don't bind anything to the wsi's socket at accept time.
+ */
+
+#include "private-lib-core.h"
+
+static void
+lws_client_he_stagger(lws_sorted_usec_list_t *sul);
+
+struct lws *
+lws_client_he_owner(struct lws *wsi)
+{
+	if (lws_dll2_is_detached(&wsi->speculative_list))
+		return wsi;
+
+	return lws_container_of(wsi->speculative_list.owner, struct lws,
+				speculative_connect_owner);
+}
+
+static int
+lws_client_he_can_race(struct lws *wsi)
+{
+	if (wsi->a.context->event_loop_ops->sock_accept)
+		return 0;
+
+#if defined(LWS_WITH_UNIX_SOCK)
+	if (wsi->unix_skt)
+		return 0;
+#endif
+
+	return 1;
+}
+
+/*
+ * An attempt has started (restart), or more DNS results arrived while we are
+ * connecting.  If there's something left to try, make sure we will race it
+ * after the attempt delay.
+ */
+
+void
+lws_client_he_arm(struct lws *wsi, int restart)
+{
+	struct lws *w = lws_client_he_owner(wsi);
+
+	if (!w->dns_sorted_list.count || !lws_client_he_can_race(w) ||
+	    (!restart && w->sul_he.list.owner))
+		return;
+
+	lws_sul_schedule(w->a.context, w->tsi, &w->sul_he,
+			 lws_client_he_stagger,
+			 (lws_usec_t)w->a.vhost->connect_attempt_delay_ms *
+							LWS_US_PER_MS);
+}
+
+/*
+ * Start an attempt to our next DNS result on a new wsi, alongside the one(s)
+ * already in progress
+ */
+
+static void
+lws_client_he_race(struct lws *wsi)
+{
+	struct lws_context *cx = wsi->a.context;
+	lws_dns_sort_t *ds;
+	struct lws *w;
+
+	lws_context_lock(cx, __func__);
+	w = __lws_wsi_create_with_role(cx, wsi->tsi, NULL, wsi->lc.log_cx);
+	lws_context_unlock(cx);
+	if (!w) {
+		lwsl_wsi_warn(wsi, "OOM");
+		return;
+	}
+
+	__lws_lc_tag(cx, &cx->lcg[LWSLCG_WSI_CLIENT], &w->lc, "he/%s",
+		     lws_wsi_tag(wsi));
+
+	lws_role_transition(w, (enum lwsi_role)lwsi_role(wsi), LRS_UNCONNECTED,
+			    wsi->role_ops);
+	w->he_speculative = 1;
+	/* any failure is reported on the wsi we are racing for */
+	w->already_did_cce = 1;
+	w->flags = wsi->flags;
+	w->c_pri = wsi->c_pri;
+	w->conn_port = wsi->conn_port;
+	w->a.protocol = wsi->a.protocol;
+	lws_vhost_bind_wsi(wsi->a.vhost, w);
+
+	/* the next DNS result becomes the only one it has */
+
+	ds = lws_container_of(lws_dll2_get_head(&wsi->dns_sorted_list),
+			      lws_dns_sort_t, list);
+	lws_dll2_remove(&ds->list);
+	lws_dll2_add_tail(&ds->list, &w->dns_sorted_list);
+
+	lws_dll2_add_tail(&w->speculative_list,
+			  &wsi->speculative_connect_owner);
+
+	lwsl_wsi_info(wsi, "racing %s", lws_wsi_tag(w));
+
+	/* if the attempt can't start, this closes w, which reschedules us */
+	lws_client_connect_3_connect(w, NULL, NULL, 0, NULL);
+}
+
+static void
+lws_client_he_stagger(lws_sorted_usec_list_t *sul)
+{
+	struct lws *wsi = lws_container_of(sul, struct lws, sul_he);
+	static const char cce[] = "Unable to connect";
+
+	if (lwsi_state(wsi) != LRS_WAITING_CONNECT)
+		return;
+
+	if (wsi->dns_sorted_list.count) {
+		if (lws_socket_is_valid(wsi->desc.sockfd))
+			lws_client_he_race(wsi);
+		else
+			/* our own attempt already failed, make the next one */
+			lws_client_connect_3_connect(wsi, NULL, NULL, 0, NULL);
+
+		return;
+	}
+
+	if (wsi->speculative_connect_owner.count ||
+	    lws_socket_is_valid(wsi->desc.sockfd))
+		return;
+
+	/* every attempt we made or raced has failed */
+
+	lws_inform_client_conn_fail(wsi, (void *)cce, strlen(cce));
+	lws_close_free_wsi(wsi, LWS_CLOSE_STATUS_NOSTATUS, "he: all failed");
+}
+
+/*
+ * A raced attempt connected first.  Its socket replaces whatever attempt the
+ * wsi it was racing for has in progress, and that wsi carries on from connect3
+ * as if it had connected by itself.
+ */
+
+void
+lws_client_he_won(struct lws *w)
+{
+	struct lws_context_per_thread *pt = &w->a.context->pt[(int)w->tsi];
+	struct lws *wsi = lws_client_he_owner(w);
+	lws_sockfd_type fd = w->desc.sockfd;
+	static const char cce[] = "conn fail: insert fd";
+	int n;
+
+	lwsl_wsi_info(wsi, "%s won", lws_wsi_tag(w));
+
+#if defined(LWS_WITH_CONMON)
+	lws_conmon_attempt_end(wsi, LWSCONMON_ATTEMPT_CANCELLED);
+	wsi->conmon_attempt = w->conmon_attempt;
+	wsi->conmon_datum = w->conmon_datum;
+	w->conmon_attempt = 0;
+#endif
+
+	lws_dll2_remove(&w->speculative_list);
+
+	lws_pt_lock(pt, __func__);
+	__remove_wsi_socket_from_fds(w);
+	w->desc.sockfd = LWS_SOCK_INVALID;
+
+	if (lws_socket_is_valid(wsi->desc.sockfd)) {
+		__remove_wsi_socket_from_fds(wsi);
+		compatible_close(wsi->desc.sockfd);
+	}
+
+	wsi->desc.sockfd = fd;
+	wsi->sa46_peer = w->sa46_peer;
+#if defined(LWS_WITH_NETLINK)
+	wsi->peer_route_uidx = w->peer_route_uidx;
+#endif
+	n = __insert_wsi_socket_into_fds(wsi->a.context, wsi);
+	lws_pt_unlock(pt);
+
+	lws_close_free_wsi(w, LWS_CLOSE_STATUS_NOSTATUS, "he: won");
+
+	if (n || lws_change_pollfd(wsi, 0, LWS_POLLIN)) {
+		lws_inform_client_conn_fail(wsi, (void *)cce, strlen(cce));
+		lws_close_free_wsi(wsi, LWS_CLOSE_STATUS_NOSTATUS, "he: won");
+		return;
+	}
+
+	/* connect3 only believes the connection check while this is pending */
+
+	lws_sul_schedule(wsi->a.context, wsi->tsi, &wsi->sul_connect_timeout,
+			 lws_client_conn_wait_timeout,
+			 wsi->a.context->timeout_secs * LWS_USEC_PER_SEC);
+
+	lws_client_connect_3_connect(wsi, NULL, NULL, 0, NULL);
+}
+
+static void
+lws_client_he_close_attempts(struct lws *wsi, int locked)
+{
+	lws_sul_cancel(&wsi->sul_he);
+
+	lws_start_foreach_dll_safe(struct lws_dll2 *, d, d1,
+			lws_dll2_get_head(&wsi->speculative_connect_owner)) {
+		struct lws *w = lws_container_of(d, struct lws,
+						 speculative_list);
+
+#if defined(LWS_WITH_CONMON)
+		lws_conmon_attempt_end(w, LWSCONMON_ATTEMPT_CANCELLED);
+#endif
+		lws_dll2_remove(d);
+
+		if (locked)
+			__lws_close_free_wsi(w, LWS_CLOSE_STATUS_NOSTATUS,
+					     "he: cancelled");
+		else
+			lws_close_free_wsi(w, LWS_CLOSE_STATUS_NOSTATUS,
+					   "he: cancelled");
+
+	} lws_end_foreach_dll_safe(d, d1);
+}
+
+/*
+ * The wsi connected with its own attempt, the raced ones lost
+ */
+
+void
+lws_client_he_cancel(struct lws *wsi)
+{
+	lws_client_he_close_attempts(wsi, 0);
+}
+
+/* requires cx + pt lock */
+
+void
+__lws_client_he_close(struct lws *wsi)
+{
+	struct lws *owner;
+
+	if (lws_dll2_is_detached(&wsi->speculative_list)) {
+		/* if we are closing, nothing we are racing can win */
+		lws_client_he_close_attempts(wsi, 1);
+
+		return;
+	}
+
+	/*
+	 * A raced attempt failed... let the wsi it was for start the next
+	 * attempt now, or give up if this was the last one
+	 */
+
+	owner = lws_client_he_owner(wsi);
+
+#if defined(LWS_WITH_CONMON)
+	lws_conmon_attempt_end(wsi, LWSCONMON_ATTEMPT_FAILED);
+#endif
+	lws_dll2_remove(&wsi->speculative_list);
+
+	if (lwsi_state(owner) == LRS_WAITING_CONNECT)
+		lws_sul_schedule(owner->a.context, owner->tsi, &owner->sul_he,
+				 lws_client_he_stagger, 1);
+}
@@ -554,6 +554,49 @@ lws_sort_dns_compare(const lws_dll2_t *a, const lws_dll2_t *b)
 
 #endif /* ipv6 + netlink */
 
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+
+/*
+ * RFC 8305 Section 4: after sorting, interleave the address families, so if
+ * the preferred family is broken, an attempt to the other family is raced
+ * against the first one, not after every address of the broken family
+ */
+
+static void
+lws_sort_dns_interleave(struct lws *wsi)
+{
+	lws_dll2_owner_t fam[2];
+	lws_dns_sort_t *s;
+	lws_dll2_t *d;
+	int af, n = 0;
+
+	d = lws_dll2_get_head(&wsi->dns_sorted_list);
+	if (!d)
+		return;
+
+	memset(fam, 0, sizeof(fam));
+	af = lws_container_of(d, lws_dns_sort_t, list)->dest.sa4.sin_family;
+
+	while ((d = lws_dll2_get_head(&wsi->dns_sorted_list))) {
+		s = lws_container_of(d, lws_dns_sort_t, list);
+		lws_dll2_remove(d);
+		lws_dll2_add_tail(d, &fam[s->dest.sa4.sin_family != af]);
+	}
+
+	/* take one from each family in turn, starting with the preferred */
+
+	while (fam[0].count || fam[1].count) {
+		d = lws_dll2_get_head(&fam[n]);
+		if (d) {
+			lws_dll2_remove(d);
+			lws_dll2_add_tail(d, &wsi->dns_sorted_list);
+		}
+		n ^= 1;
+	}
+}
+
+#endif
+
 #if defined(_DEBUG)
 
 static void
@@ -770,6 +813,10 @@ next:
 	//lwsl_notice("%s: sorted table: %d\n", __func__,
 	//		wsi->dns_sorted_list.count);
 
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+	lws_sort_dns_interleave(wsi);
+#endif
+
 #if defined(_DEBUG)
 	lws_sort_dns_dump(wsi);
 #endif
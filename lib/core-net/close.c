@@ -58,6 +58,8 @@ __lws_reset_wsi(struct lws *wsi)
 		wsi->conmon.ciu_sockconn =
 		wsi->conmon.ciu_tls =
 		wsi->conmon.ciu_txn_resp = 0;
+	wsi->conmon.count_attempts = 0;
+	wsi->conmon_attempt = 0;
 #endif
 
 	/*
@@ -118,6 +120,9 @@ __lws_reset_wsi(struct lws *wsi)
 				      sizeof(*wsi->udp), "close udp wsi");
 		lws_free_set_NULL(wsi->udp);
 	}
+#endif
+#if defined(LWS_WITH_UDP_MMSG)
+	lws_udp_mmsg_destroy(wsi);
 #endif
 	wsi->retry = 0;
 
@@ -265,7 +270,7 @@ __lws_free_wsi(struct lws *wsi)
 	lws_sul_debug_zombies(wsi->a.context, wsi, sizeof(*wsi), __func__);
 
 	__lws_lc_untag(wsi->a.context, &wsi->lc);
-	lws_free(wsi);
+	lws_slab_free(wsi);
 }
 
 
@@ -369,6 +374,12 @@ __lws_close_free_wsi(struct lws *wsi, enum lws_close_status reason,
 	if (pt->pipe_wsi == wsi)
 		pt->pipe_wsi = NULL;
 
+#if defined(LWS_WITH_TX_BATCH)
+	/* send what it wrote in this pass before anything close writes */
+	if (pt->tx_batch_wsi == wsi)
+		lws_tx_batch_end(pt);
+#endif
+
 #if defined(LWS_WITH_SYS_METRICS) && \
     (defined(LWS_WITH_CLIENT) || defined(LWS_WITH_SERVER))
 	/* wsi level: only reports if dangling caliper */
@@ -402,6 +413,9 @@ __lws_close_free_wsi(struct lws *wsi, enum lws_close_status reason,
 	wsi->client_mux_substream_was = wsi->client_mux_substream;
 
 	lws_addrinfo_clean(wsi);
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+	__lws_client_he_close(wsi);
+#endif
 #endif
 
 #if defined(LWS_WITH_HTTP2)
@@ -595,6 +609,9 @@ just_kill_connection:
 		lws_free_set_NULL(wsi->udp);
 	}
 #endif
+#if defined(LWS_WITH_UDP_MMSG)
+	lws_udp_mmsg_destroy(wsi);
+#endif
 
 	if (lws_rops_fidx(wsi->role_ops, LWS_ROPS_close_kill_connection))
 		lws_rops_func_fidx(wsi->role_ops,
@@ -673,6 +690,10 @@ just_kill_connection:
 			if (!wsi->socket_is_permanently_unusable &&
 			    lws_socket_is_valid(wsi->desc.sockfd)) {
 				wsi->socket_is_permanently_unusable = 1;
+#if defined(LWS_WITH_IO_URING)
+				/* after his queued tx, if any */
+				if (!lws_io_uring_shutdown(wsi))
+#endif
 				n = shutdown(wsi->desc.sockfd, SHUT_WR);
 			}
 		}
@@ -989,7 +1010,12 @@ __lws_close_free_wsi_final(struct lws *wsi)
 #endif
 
 	/* outermost destroy notification for wsi (user_space still intact) */
-	if (wsi->a.vhost)
+	if (wsi->a.vhost
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+	    /* user code never saw raced connection attempts */
+	    && !wsi->he_speculative
+#endif
+	)
 		wsi->a.vhost->protocols[0].callback(wsi, LWS_CALLBACK_WSI_DESTROY,
 						  wsi->user_space, NULL, 0);
 
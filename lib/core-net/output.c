@@ -24,6 +24,109 @@
 
 #include "private-lib-core.h"
 
+#if defined(LWS_WITH_TX_BATCH)
+
+/*
+ * Send everything collected in the batch as one write, so one tls record.
+ * Whatever the socket won't take now goes on the batching wsi's buflist_out
+ * like any other partial write, and is sent first next time.
+ */
+
+static int
+lws_tx_batch_flush(struct lws_context_per_thread *pt)
+{
+	struct lws *wsi = pt->tx_batch_wsi;
+	size_t len = pt->tx_batch_len;
+	int m;
+
+	if (!len)
+		return 0;
+
+	if (wsi->socket_is_permanently_unusable) {
+		pt->tx_batch_len = 0;
+		pt->tx_batch_frames = 0;
+
+		return -1;
+	}
+
+#if defined(LWS_WITH_SYS_METRICS)
+	lws_metric_event(pt->context->mt_tx_batch, METRES_GO,
+			 pt->tx_batch_frames);
+#endif
+
+	pt->tx_batch_len = 0;
+	pt->tx_batch_frames = 0;
+
+	if (lws_fi(&wsi->fic, "sendfail"))
+		m = LWS_SSL_CAPABLE_ERROR;
+	else
+		m = lws_ssl_capable_write(wsi, pt->tx_batch, len);
+
+	lwsl_wsi_info(wsi, "batch of %d says %d", (int)len, m);
+
+	wsi->could_have_pending = 1;
+
+	switch (m) {
+	case LWS_SSL_CAPABLE_ERROR:
+		wsi->socket_is_permanently_unusable = 1;
+		return -1;
+	case LWS_SSL_CAPABLE_MORE_SERVICE:
+		m = 0;
+		break;
+	}
+
+	if ((size_t)m == len)
+		return 0;
+
+	if (lws_buflist_append_segment(&wsi->buflist_out, pt->tx_batch + m,
+				       len - (size_t)m) < 0)
+		return -1;
+
+	lws_callback_on_writable(wsi);
+
+	return 0;
+}
+
+/*
+ * Start collecting what the network wsi writes on the pt's batch buffer,
+ * returns nonzero if we can't do that right now
+ */
+
+int
+lws_tx_batch_begin(struct lws_context_per_thread *pt, struct lws *wsi)
+{
+	if (pt->tx_batch_wsi)
+		return 1;
+
+	if (!pt->tx_batch) {
+		pt->tx_batch = lws_malloc(LWS_TX_BATCH_SIZE, "tx batch");
+		if (!pt->tx_batch)
+			return 1;
+	}
+
+	pt->tx_batch_wsi = wsi;
+	pt->tx_batch_len = 0;
+	pt->tx_batch_frames = 0;
+
+	return 0;
+}
+
+int
+lws_tx_batch_end(struct lws_context_per_thread *pt)
+{
+	int n;
+
+	if (!pt->tx_batch_wsi)
+		return 0;
+
+	n = lws_tx_batch_flush(pt);
+	pt->tx_batch_wsi = NULL;
+
+	return n;
+}
+
+#endif
+
 /*
  * notice this returns number of bytes consumed, or -1
  */
@@ -82,6 +185,33 @@ lws_issue_raw(struct lws *wsi, unsigned char *buf, size_t len)
 	if (!len || !buf)
 		return 0;
 
+#if defined(LWS_WITH_TX_BATCH)
+	if (!wsi->buflist_out &&
+	    context->pt[(int)wsi->tsi].tx_batch_wsi == wsi) {
+		struct lws_context_per_thread *pt = &context->pt[(int)wsi->tsi];
+
+		if (pt->tx_batch_len &&
+		    pt->tx_batch_len + len > LWS_TX_BATCH_SIZE) {
+			/* no room for it, send what we have so far first */
+			if (lws_tx_batch_flush(pt))
+				return -1;
+			if (wsi->buflist_out)
+				/* that got stuck, queue this up behind it */
+				return lws_issue_raw(wsi, buf, len);
+		}
+
+		if (len <= LWS_TX_BATCH_SIZE) {
+			memcpy(pt->tx_batch + pt->tx_batch_len, buf, len);
+			pt->tx_batch_len += len;
+			pt->tx_batch_frames++;
+
+			return (int)len;
+		}
+
+		/* too big to be worth copying, just send it directly */
+	}
+#endif
+
 	if (!wsi->mux_substream && !lws_socket_is_valid(wsi->desc.sockfd))
 		lwsl_wsi_err(wsi, "invalid sock");
 
@@ -260,6 +390,12 @@ lws_ssl_capable_read_no_ssl(struct lws *wsi, unsigned char *buf, size_t len)
 				len, 0,
 				sa46_sockaddr(&wsi->udp->sa46), &slt);
 	} else
+#endif
+#if defined(LWS_WITH_IO_URING)
+	if (lws_io_uring_rx_owned(wsi))
+		/* the kernel already received it into a provided buffer */
+		n = (int)lws_io_uring_recv(wsi, buf, len);
+	else
 #endif
 		n = (int)recv(wsi->desc.sockfd, (char *)buf,
 #if defined(WIN32)
@@ -344,6 +480,11 @@ lws_ssl_capable_write_no_ssl(struct lws *wsi, unsigned char *buf, size_t len)
 #endif
 					len);
 		else
+#if defined(LWS_WITH_IO_URING)
+		if (lws_io_uring_tx_owned(wsi))
+			n = (int)lws_io_uring_send(wsi, buf, len);
+		else
+#endif
 			n = (int)send(wsi->desc.sockfd, (char *)buf,
 #if defined(WIN32)
 				(int)
@@ -52,9 +52,9 @@ struct lws_muxable {
 extern "C" {
 #endif
 
-#define __lws_sul_insert_us(owner, sul, _us) \
+#define __lws_sul_insert_us(pt, n, sul, _us) \
 		(sul)->us = lws_now_usecs() + (lws_usec_t)(_us); \
-		__lws_sul_insert(owner, sul)
+		__lws_sul_pt_insert(pt, n, sul)
 
 
 /*
@@ -237,11 +237,65 @@ struct client_info_stash {
 #define lws_wsi_is_udp(___wsi) (!!___wsi->udp)
 #endif
 
+#if defined(LWS_WITH_UDP_MMSG)
+struct lws_udp_mmsg;
+
+int
+lws_udp_mmsg_create(struct lws *wsi, int flags);
+void
+lws_udp_mmsg_destroy(struct lws *wsi);
+void
+lws_udp_mmsg_skt_options(struct lws *wsi, lws_sockfd_type fd);
+int
+lws_udp_mmsg_rx(struct lws *wsi);
+#endif
+
 #define LWS_H2_FRAME_HEADER_LENGTH 9
 
 lws_usec_t
 __lws_sul_service_ripe(lws_dll2_owner_t *own, int num_own, lws_usec_t usnow);
 
+/*
+ * Service just one of the pt sul owner lists, with the caller's idea of the
+ * time, for tests that drive the scheduler with a synthetic clock.  Internal
+ * lws timers are on LWSSULLI_MISS_IF_SUSPENDED and reschedule themselves
+ * from the real time, so driving that one far ahead keeps finding them ripe.
+ */
+lws_usec_t
+lws_sul_service_owner(struct lws_context *ctx, int tsi, int owner,
+		      lws_usec_t usnow);
+
+#if defined(LWS_WITH_SUL_WHEEL)
+
+/*
+ * Optional hierarchical timer wheel in front of each pt_sul_owner[] list.
+ *
+ * pt_sul_owner[n] keeps only the suls due before .limit, sorted as usual.
+ * Later suls sit unsorted in a slot on the lowest level that can hold them,
+ *
+ *  - L0: 256 x 131ms slots for the rest of .limit's L1 slot
+ *  - L1:  64 x 33.5s slots for the rest of .limit's L2 slot
+ *  - L2:  64 x 35.8min slots for the next ~38h
+ *
+ * or failing that, on the sorted .later list.  Slots are cascaded down as the
+ * service time reaches them, so scheduling and cancelling is O(1).
+ *
+ * Everything stays on a dll2 owner, so sul->list.owner still means the sul
+ * is scheduled and lws_dll2_remove(&sul->list) still cancels it.
+ */
+
+#define LWS_SUL_WHEEL_LEVELS		3
+#define LWS_SUL_WHEEL_SLOTS		(256 + 64 + 64)
+
+struct lws_sul_wheel {
+	lws_dll2_owner_t		slot[LWS_SUL_WHEEL_SLOTS];
+	lws_dll2_owner_t		later;
+	uint64_t			map[LWS_SUL_WHEEL_SLOTS / 64];
+					/* ^ may have stale bits set */
+	lws_usec_t			limit; /* L0 slot aligned */
+};
+#endif
+
 /*
  * lws_async_dns
  */
@@ -286,6 +340,41 @@ lws_async_dns_cancel(struct lws *wsi);
 void
 lws_async_dns_drop_server(lws_async_dns_server_t *dsrv);
 
+/*
+ * Per-pt slab caches for the objects every connection allocates, so an
+ * accept storm doesn't hammer the general purpose allocator (and its lock)
+ */
+
+typedef enum {
+	LWS_SLAB_WSI,		/* struct lws + evlib_size_wsi */
+	LWS_SLAB_WS,		/* struct _lws_websocket_related */
+	LWS_SLAB_H2N,		/* struct lws_h2_netconn */
+	LWS_SLAB_H2_PPS,	/* struct lws_h2_protocol_send */
+
+	LWS_SLAB_COUNT
+} lws_slab_class_t;
+
+#if defined(LWS_WITH_WSI_SLAB)
+
+struct lws_slab {
+	lws_dll2_owner_t	chunks; /* ones with free objects at the head */
+	size_t			size; /* object size, set by first allocation */
+	uint16_t		empty; /* chunks with nothing in use */
+};
+
+void *
+lws_slab_zalloc(struct lws_context_per_thread *pt, lws_slab_class_t c,
+		size_t size);
+void
+lws_slab_free(void *p);
+void
+lws_slab_destroy(struct lws_context_per_thread *pt);
+
+#else
+#define lws_slab_zalloc(_pt, _c, _size) lws_zalloc(_size, #_c)
+#define lws_slab_free(_p) lws_free(_p)
+#endif
+
 /*
  * so we can have n connections being serviced simultaneously,
  * these things need to be isolated per-thread.
@@ -310,6 +399,9 @@ struct lws_context_per_thread {
 #endif
 
 	struct lws_dll2_owner pt_sul_owner[LWS_COUNT_PT_SUL_OWNERS];
+#if defined(LWS_WITH_SUL_WHEEL)
+	struct lws_sul_wheel pt_sul_wheel[LWS_COUNT_PT_SUL_OWNERS];
+#endif
 
 #if (defined(LWS_ROLE_H1) || defined(LWS_ROLE_H2)) && defined(LWS_WITH_SERVER)
 	lws_sorted_usec_list_t sul_ah_lifecheck;
@@ -353,9 +445,24 @@ struct lws_context_per_thread {
 	lws_sockfd_type dummy_pipe_fds[2];
 	struct lws *pipe_wsi;
 
+#if defined(LWS_WITH_TX_BATCH)
+	/*
+	 * While tx_batch_wsi is having its POLLOUT pass, what it writes is
+	 * collected here and sent as one write when the pass ends
+	 */
+	struct lws *tx_batch_wsi;
+	uint8_t *tx_batch;	/* LWS_TX_BATCH_SIZE, allocated on first use */
+	size_t tx_batch_len;
+	uint16_t tx_batch_frames;
+#endif
+
+#if defined(LWS_WITH_WSI_SLAB)
+	struct lws_slab slab[LWS_SLAB_COUNT];
+#endif
+
 	/* --- role based members --- */
 
-#if defined(LWS_ROLE_WS) && !defined(LWS_WITHOUT_EXTENSIONS)
+#if defined(LWS_ROLE_WS)
 	struct lws_pt_role_ws ws;
 #endif
 #if defined(LWS_ROLE_H1) || defined(LWS_ROLE_H2)
@@ -522,11 +629,15 @@ struct lws_vhost {
 	int keepalive_timeout;
 	int timeout_secs_ah_idle;
 	int connect_timeout_secs;
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+	unsigned int connect_attempt_delay_ms;
+#endif
 	int fo_listen_queue;
 
 	int count_bound_wsi;
 
 #ifdef LWS_WITH_ACCESS_LOG
+	struct lws_access_log_ring *alog;
 	int log_fd;
 #endif
 
@@ -657,7 +768,8 @@ struct lws {
 
 	/* lifetime members */
 
-#if defined(LWS_WITH_EVENT_LIBS)
+#if defined(LWS_WITH_EVENT_LIBS) || defined(LWS_WITH_EPOLL) || \
+    defined(LWS_WITH_IO_URING)
 	void				*evlib_wsi; /* overallocated */
 #endif
 
@@ -665,6 +777,9 @@ struct lws {
 	lws_sorted_usec_list_t		sul_hrtimer;
 	lws_sorted_usec_list_t		sul_validity;
 	lws_sorted_usec_list_t		sul_connect_timeout;
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+	lws_sorted_usec_list_t		sul_he; /* next raced connect attempt */
+#endif
 
 	struct lws_dll2			dll_buflist; /* guys with pending rxflow */
 	struct lws_dll2			same_vh_protocol;
@@ -726,6 +841,9 @@ struct lws {
 #if defined(LWS_WITH_UDP)
 	struct lws_udp			*udp;
 #endif
+#if defined(LWS_WITH_UDP_MMSG)
+	struct lws_udp_mmsg		*udp_mmsg;
+#endif
 #if defined(LWS_WITH_CLIENT)
 	struct client_info_stash	*stash;
 	char				*cli_hostname_copy;
@@ -733,6 +851,9 @@ struct lws {
 #if defined(LWS_WITH_CONMON)
 	struct lws_conmon		conmon;
 	lws_usec_t			conmon_datum;
+	lws_usec_t			conmon_first_attempt;
+	uint8_t				conmon_attempt;
+	/* 0, or 1 + our ongoing attempt's index in conmon.attempts[] */
 #endif
 #endif /* WITH_CLIENT */
 	void				*user_space;
@@ -847,6 +968,10 @@ struct lws {
 	unsigned int			perf_done:1;
 	unsigned int			close_is_redirect:1;
 	unsigned int			client_mux_substream_was:1;
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+	unsigned int			he_speculative:1;
+	/* we are only a connection attempt raced for another wsi */
+#endif
 #endif
 
 #ifdef _WIN32
@@ -952,6 +1077,10 @@ lws_spawn_reap(struct lws_spawn_piped *lsp);
 void
 lws_service_do_ripe_rxflow(struct lws_context_per_thread *pt);
 
+int
+__lws_sul_pt_insert(struct lws_context_per_thread *pt, int n,
+		    lws_sorted_usec_list_t *sul);
+
 const struct lws_role_ops *
 lws_role_by_name(const char *name);
 
@@ -986,6 +1115,26 @@ lws_conmon_addrinfo_destroy(struct addrinfo *ai);
 int
 lws_conmon_append_copy_new_dns_results(struct lws *wsi,
 				       const struct addrinfo *cai);
+void
+lws_conmon_attempt_start(struct lws *wsi);
+void
+lws_conmon_attempt_end(struct lws *wsi, lws_conmon_attempt_disposition_t disp);
+
+void
+lws_client_conn_wait_timeout(lws_sorted_usec_list_t *sul);
+
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+struct lws *
+lws_client_he_owner(struct lws *wsi);
+void
+lws_client_he_arm(struct lws *wsi, int restart);
+void
+lws_client_he_won(struct lws *wsi);
+void
+lws_client_he_cancel(struct lws *wsi);
+void
+__lws_client_he_close(struct lws *wsi);
+#endif
 
 #if LWS_MAX_SMP > 1
 
@@ -1215,6 +1364,15 @@ __insert_wsi_socket_into_fds(struct lws_context *context, struct lws *wsi);
 int LWS_WARN_UNUSED_RESULT
 lws_issue_raw(struct lws *wsi, unsigned char *buf, size_t len);
 
+#if defined(LWS_WITH_TX_BATCH)
+#define LWS_TX_BATCH_SIZE 16384 /* the most one tls record can carry */
+
+int
+lws_tx_batch_begin(struct lws_context_per_thread *pt, struct lws *wsi);
+int
+lws_tx_batch_end(struct lws_context_per_thread *pt);
+#endif
+
 lws_usec_t
 __lws_seq_timeout_check(struct lws_context_per_thread *pt, lws_usec_t usnow);
 
@@ -1232,6 +1390,9 @@ struct lws * LWS_WARN_UNUSED_RESULT
 lws_create_new_server_wsi(struct lws_vhost *vhost, int fixed_tsi,
 				int group, const char *desc);
 
+struct lws *
+lws_adopt_descriptor_vhost_tsi(const lws_adopt_desc_t *info, int tsi);
+
 char * LWS_WARN_UNUSED_RESULT
 lws_generate_client_handshake(struct lws *wsi, char *pkt);
 
@@ -1287,6 +1448,11 @@ int
 lws_access_log(struct lws *wsi);
 void
 lws_prepare_access_log_info(struct lws *wsi, char *uri_ptr, int len, int meth);
+int
+lws_access_log_init(struct lws_vhost *vh,
+		    const struct lws_context_creation_info *info);
+void
+lws_access_log_destroy(struct lws_vhost *vh);
 #else
 #define lws_access_log(_a)
 #endif
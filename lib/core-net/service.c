@@ -58,8 +58,8 @@ lws_callback_as_writeable(struct lws *wsi)
 	return m;
 }
 
-int
-lws_handle_POLLOUT_event(struct lws *wsi, struct lws_pollfd *pollfd)
+static int
+_lws_handle_POLLOUT_event(struct lws *wsi, struct lws_pollfd *pollfd)
 {
 	volatile struct lws *vwsi = (volatile struct lws *)wsi;
 	int n;
@@ -244,6 +244,35 @@ bail_die:
 	return -1;
 }
 
+int
+lws_handle_POLLOUT_event(struct lws *wsi, struct lws_pollfd *pollfd)
+{
+#if defined(LWS_WITH_TX_BATCH)
+	struct lws_context_per_thread *pt = &wsi->a.context->pt[(int)wsi->tsi];
+	int n;
+
+	/*
+	 * h2 and ws can write many small frames on the network connection in
+	 * one writeable pass, collect them and send them together at the end
+	 */
+
+	if (wsi->mux_substream || (!lwsi_role_h2(wsi) && !lwsi_role_ws(wsi)) ||
+	    lws_tx_batch_begin(pt, wsi))
+		return _lws_handle_POLLOUT_event(wsi, pollfd);
+
+	n = _lws_handle_POLLOUT_event(wsi, pollfd);
+
+	/* if the wsi was closed meanwhile, close already sent the batch */
+
+	if (pt->tx_batch_wsi == wsi && lws_tx_batch_end(pt))
+		return -1;
+
+	return n;
+#else
+	return _lws_handle_POLLOUT_event(wsi, pollfd);
+#endif
+}
+
 int
 lws_rxflow_cache(struct lws *wsi, unsigned char *buf, size_t n, size_t len)
 {
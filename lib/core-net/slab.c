@@ -0,0 +1,218 @@
+/*
+ * libwebsockets - small server side websockets and web server implementation
+ *
+ * Copyright (C) 2010 - 2021 Andy Green <andy@warmcat.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "private-lib-core.h"
+
+/*
+ * Each pt has one slab cache per kind of object.  A cache is a list of
+ * chunks that each hold LWS_SLAB_CHUNK_OBJS objects, preceded by a pointer
+ * back to their chunk so they can be freed without knowing where they came
+ * from.  Free objects are linked through their own first bytes.
+ *
+ * Chunks with free objects are kept at the head of the list, so allocation
+ * only ever looks at the head.  One chunk per cache with nothing in use is
+ * kept for the next burst, others are given back as soon as they empty.
+ */
+
+#define LWS_SLAB_ALIGN		16
+#define LWS_SLAB_CHUNK_OBJS	16
+#define lws_slab_round(_s)	(((_s) + LWS_SLAB_ALIGN - 1) & \
+				 ~((size_t)LWS_SLAB_ALIGN - 1))
+
+typedef struct lws_slab_chunk {
+	lws_dll2_t			list;
+	struct lws_context_per_thread	*pt;
+	void				*free;
+	uint16_t			in_use;
+	uint8_t				cls;
+} lws_slab_chunk_t;
+
+#define LWS_SLAB_HDR		lws_slab_round(sizeof(lws_slab_chunk_t))
+#define LWS_SLAB_OBJ_HDR	lws_slab_round(sizeof(lws_slab_chunk_t *))
+#define lws_slab_stride(_sl)	(LWS_SLAB_OBJ_HDR + lws_slab_round((_sl)->size))
+
+#if defined(LWS_WITH_SYS_METRICS)
+static const char * const slab_hit[] = {
+	"wsi/hit", "ws/hit", "h2n/hit", "pps/hit"
+}, * const slab_miss[] = {
+	"wsi/miss", "ws/miss", "h2n/miss", "pps/miss"
+};
+#endif
+
+static void
+lws_slab_metric(struct lws_context *cx, lws_slab_class_t c, int hit)
+{
+#if defined(LWS_WITH_SYS_METRICS)
+	if (cx->mth_slab)
+		lws_metrics_hist_bump_priv(cx->mth_slab,
+					   hit ? slab_hit[c] : slab_miss[c]);
+#endif
+}
+
+static void
+lws_slab_chunk_destroy(struct lws_slab *sl, lws_slab_chunk_t *ch)
+{
+	struct lws_context *cx = ch->pt->context;
+
+	lws_dll2_remove(&ch->list);
+
+	if (cx->slab_chunk_free)
+		cx->slab_chunk_free(cx, ch);
+	else
+		lws_free(ch);
+}
+
+void *
+lws_slab_zalloc(struct lws_context_per_thread *pt, lws_slab_class_t c,
+		size_t size)
+{
+	struct lws_slab *sl = &pt->slab[c];
+	struct lws_context *cx = pt->context;
+	lws_slab_chunk_t *ch = NULL;
+	uint8_t *p;
+	size_t n;
+
+	lws_pt_lock(pt, __func__); /* -------------- pt { */
+
+	if (!sl->size)
+		sl->size = size;
+	assert(size == sl->size);
+
+	if (sl->chunks.head) {
+		ch = lws_container_of(sl->chunks.head, lws_slab_chunk_t, list);
+		if (!ch->free)
+			ch = NULL;
+	}
+
+	if (!ch) {
+		n = LWS_SLAB_HDR + (LWS_SLAB_CHUNK_OBJS * lws_slab_stride(sl));
+
+		if (cx->slab_chunk_alloc)
+			ch = (lws_slab_chunk_t *)cx->slab_chunk_alloc(cx, n);
+		else
+			ch = (lws_slab_chunk_t *)lws_malloc(n, "slab");
+		if (!ch) {
+			lws_pt_unlock(pt); /* } pt -------------- */
+			return NULL;
+		}
+
+		memset(ch, 0, sizeof(*ch));
+		ch->pt = pt;
+		ch->cls = (uint8_t)c;
+
+		p = (uint8_t *)ch + LWS_SLAB_HDR +
+		    ((LWS_SLAB_CHUNK_OBJS - 1) * lws_slab_stride(sl));
+		for (n = 0; n < LWS_SLAB_CHUNK_OBJS; n++) {
+			*(lws_slab_chunk_t **)p = ch;
+			*(void **)(p + LWS_SLAB_OBJ_HDR) = ch->free;
+			ch->free = p + LWS_SLAB_OBJ_HDR;
+			p -= lws_slab_stride(sl);
+		}
+
+		lws_dll2_add_head(&ch->list, &sl->chunks);
+		sl->empty++;
+
+		lws_slab_metric(cx, c, 0);
+	} else
+		lws_slab_metric(cx, c, 1);
+
+	p = (uint8_t *)ch->free;
+	ch->free = *(void **)p;
+	if (!ch->in_use++)
+		sl->empty--;
+
+	if (!ch->free) {
+		/* full chunks live at the tail */
+		lws_dll2_remove(&ch->list);
+		lws_dll2_add_tail(&ch->list, &sl->chunks);
+	}
+
+	lws_pt_unlock(pt); /* } pt -------------- */
+
+	memset(p, 0, size);
+
+	return p;
+}
+
+void
+lws_slab_free(void *p)
+{
+	lws_slab_chunk_t *ch;
+	struct lws_slab *sl;
+
+	if (!p)
+		return;
+
+	ch = *(lws_slab_chunk_t **)((uint8_t *)p - LWS_SLAB_OBJ_HDR);
+	sl = &ch->pt->slab[ch->cls];
+
+	lws_pt_lock(ch->pt, __func__); /* -------------- pt { */
+
+	assert(ch->in_use);
+
+	if (!ch->free) {
+		/* it was full, it has something to offer again */
+		lws_dll2_remove(&ch->list);
+		lws_dll2_add_head(&ch->list, &sl->chunks);
+	}
+
+	*(void **)p = ch->free;
+	ch->free = p;
+
+	if (!--ch->in_use) {
+		if (sl->empty) {
+			struct lws_context_per_thread *pt = ch->pt;
+
+			lws_slab_chunk_destroy(sl, ch);
+			lws_pt_unlock(pt); /* } pt -------------- */
+
+			return;
+		}
+		sl->empty++;
+	}
+
+	lws_pt_unlock(ch->pt); /* } pt -------------- */
+}
+
+void
+lws_slab_destroy(struct lws_context_per_thread *pt)
+{
+	int n;
+
+	for (n = 0; n < LWS_SLAB_COUNT; n++) {
+		struct lws_slab *sl = &pt->slab[n];
+
+		while (sl->chunks.head) {
+			lws_slab_chunk_t *ch = lws_container_of(
+					sl->chunks.head, lws_slab_chunk_t, list);
+
+			if (ch->in_use)
+				lwsl_cx_err(pt->context, "slab %d: %u leaked",
+					    n, ch->in_use);
+			lws_slab_chunk_destroy(sl, ch);
+		}
+
+		sl->empty = 0;
+	}
+}
@@ -64,6 +64,347 @@ __lws_sul_insert(lws_dll2_owner_t *own, lws_sorted_usec_list_t *sul)
 	return 0;
 }
 
+#if defined(LWS_WITH_SUL_WHEEL)
+
+static const struct sul_wheel_level {
+	uint8_t		shift;
+	uint16_t	first;
+	uint16_t	count;
+} lv[LWS_SUL_WHEEL_LEVELS] = {
+	{ 17,   0, 256 },
+	{ 25, 256,  64 },
+	{ 31, 320,  64 },
+};
+
+#define LVTOP (LWS_SUL_WHEEL_LEVELS - 1)
+#define lv_mask(_k) ((lws_usec_t)((1ll << lv[_k].shift) - 1))
+#define lv_block(_us, _k) ((_us) >> lv[_k].shift)
+#define lv_index(_us, _k) ((int)(lv_block(_us, _k) & (lv[_k].count - 1)))
+
+static int
+sul_ctz64(uint64_t m)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(m);
+#else
+	int n = 0;
+
+	while (!(m & 1)) {
+		m >>= 1;
+		n++;
+	}
+
+	return n;
+#endif
+}
+
+/*
+ * Sorted insert that searches from the tail... suls are overwhelmingly added
+ * in roughly ascending time order, so this is usually O(1).  Equal times go
+ * after the existing ones, like lws_dll2_add_sorted().
+ */
+
+static void
+sul_add_sorted_from_tail(lws_dll2_owner_t *own, lws_sorted_usec_list_t *sul)
+{
+	struct lws_dll2 *p = lws_dll2_get_tail(own);
+
+	while (p && ((lws_sorted_usec_list_t *)p)->us > sul->us)
+		p = p->prev;
+
+	if (p)
+		lws_dll2_add_insert(&sul->list, p);
+	else
+		lws_dll2_add_head(&sul->list, own);
+}
+
+/*
+ * Place a detached sul on the sorted list, or the wheel slot, that matches its
+ * distance from w->limit
+ */
+
+static void
+sul_wheel_place(lws_dll2_owner_t *own, struct lws_sul_wheel *w,
+		lws_sorted_usec_list_t *sul)
+{
+	int k, s;
+
+	if (sul->us < w->limit) {
+		sul_add_sorted_from_tail(own, sul);
+		return;
+	}
+
+	for (k = 0; k < LVTOP; k++)
+		if (lv_block(sul->us, k + 1) == lv_block(w->limit, k + 1))
+			break;
+
+	if (k == LVTOP && lv_block(sul->us, k) - lv_block(w->limit, k) >=
+							lv[k].count) {
+		sul_add_sorted_from_tail(&w->later, sul);
+		return;
+	}
+
+	s = lv[k].first + lv_index(sul->us, k);
+	lws_dll2_add_tail(&sul->list, &w->slot[s]);
+	w->map[s >> 6] |= 1ull << (s & 63);
+}
+
+/*
+ * Index of the first populated slot in [from, to), or -1.  Cancelled suls
+ * leave their slot's map bit set, we clean those up as we find them.
+ */
+
+static int
+sul_wheel_scan(struct lws_sul_wheel *w, int from, int to)
+{
+	while (from < to) {
+		uint64_t m = w->map[from >> 6] >> (from & 63);
+
+		if (!m) {
+			from = (from | 63) + 1;
+			continue;
+		}
+
+		from += sul_ctz64(m);
+		if (from >= to)
+			break;
+
+		if (w->slot[from].count)
+			return from;
+
+		w->map[from >> 6] &= ~(1ull << (from & 63));
+		from++;
+	}
+
+	return -1;
+}
+
+static void
+sul_wheel_replace_all(lws_dll2_owner_t *own, struct lws_sul_wheel *w,
+		      lws_dll2_owner_t *o)
+{
+	lws_sorted_usec_list_t *sul;
+
+	while ((sul = (lws_sorted_usec_list_t *)lws_dll2_get_head(o))) {
+		lws_dll2_remove(&sul->list);
+		sul_wheel_place(own, w, sul);
+	}
+}
+
+/*
+ * Move w->limit forward to t, where everything before t has already been
+ * taken off the wheel.  The slots that t starts on the upper levels cascade
+ * down, and anything on .later that has come inside the top level moves up.
+ */
+
+static void
+sul_wheel_advance(lws_dll2_owner_t *own, struct lws_sul_wheel *w,
+		  lws_usec_t t)
+{
+	lws_sorted_usec_list_t *sul;
+	int k, s;
+
+	w->limit = t;
+
+	for (k = LVTOP; k > 0; k--) {
+		if (t & lv_mask(k))
+			continue;
+
+		s = lv[k].first + lv_index(t, k);
+		w->map[s >> 6] &= ~(1ull << (s & 63));
+		sul_wheel_replace_all(own, w, &w->slot[s]);
+	}
+
+	while ((sul = (lws_sorted_usec_list_t *)lws_dll2_get_head(&w->later)) &&
+	       lv_block(sul->us, LVTOP) - lv_block(t, LVTOP) <
+							lv[LVTOP].count) {
+		lws_dll2_remove(&sul->list);
+		sul_wheel_place(own, w, sul);
+	}
+}
+
+/*
+ * Find the earliest sul for pt_sul_owner[n], cascading wheel slots down onto
+ * the sorted list as far as usnow has reached.
+ *
+ * Returns 0 if nothing is scheduled.  Otherwise *pus is set to the earliest
+ * time and *psul to the sul, or, if the earliest is still in a wheel slot that
+ * usnow hasn't reached, *psul is NULL and *pus is the slot start... that's
+ * early but never late, and it's cascaded when we come back then.
+ */
+
+static int
+sul_wheel_peek(struct lws_context_per_thread *pt, int n, lws_usec_t usnow,
+	       lws_sorted_usec_list_t **psul, lws_usec_t *pus)
+{
+	lws_dll2_owner_t *own = &pt->pt_sul_owner[n];
+	struct lws_sul_wheel *w = &pt->pt_sul_wheel[n];
+	lws_sorted_usec_list_t *sul;
+	lws_usec_t t = 0;
+	int k, s, cur;
+
+	do {
+		sul = (lws_sorted_usec_list_t *)lws_dll2_get_head(own);
+		if (sul && sul->us < w->limit)
+			/* nothing in the wheel can be earlier than this */
+			goto exact;
+
+		/*
+		 * Find the next populated slot, lowest level first.  L0
+		 * includes the slot .limit is in, the others start after it,
+		 * and only the top level wraps.
+		 */
+
+		for (k = 0; k < LWS_SUL_WHEEL_LEVELS; k++) {
+			cur = lv_index(w->limit, k);
+			s = sul_wheel_scan(w, lv[k].first + cur + !!k,
+					   lv[k].first + lv[k].count);
+			if (s < 0 && k == LVTOP)
+				s = sul_wheel_scan(w, lv[k].first,
+						   lv[k].first + cur);
+			if (s < 0)
+				continue;
+
+			s -= lv[k].first;
+			if (k == LVTOP)
+				t = (lv_block(w->limit, k) +
+				     ((s - cur) & (lv[k].count - 1))) <<
+								lv[k].shift;
+			else
+				t = (w->limit & ~lv_mask(k + 1)) +
+					((lws_usec_t)s << lv[k].shift);
+			break;
+		}
+
+		if (k == LWS_SUL_WHEEL_LEVELS) {
+			if (!w->later.count) {
+				/*
+				 * The wheel is empty, bring it up to date so
+				 * new suls don't land on .later
+				 */
+				t = usnow & ~lv_mask(0);
+				if (t > w->limit)
+					w->limit = t;
+
+				if (!sul)
+					return 0;
+
+				goto exact;
+			}
+
+			t = ((lws_sorted_usec_list_t *)lws_dll2_get_head(
+					&w->later))->us & ~lv_mask(LVTOP);
+		}
+
+		if (t > usnow) {
+			if (sul && sul->us <= t)
+				goto exact;
+
+			*psul = NULL;
+			*pus = t;
+
+			return 1;
+		}
+
+		if (k) {
+			sul_wheel_advance(own, w, t);
+			continue;
+		}
+
+		/* sort the L0 slot's suls onto the list, it's all < limit */
+
+		s += lv[0].first;
+		w->map[s >> 6] &= ~(1ull << (s & 63));
+		w->limit = t + lv_mask(0) + 1;
+		sul_wheel_replace_all(own, w, &w->slot[s]);
+		if (!(w->limit & lv_mask(1)))
+			sul_wheel_advance(own, w, w->limit);
+	} while (1);
+
+exact:
+	*psul = sul;
+	*pus = sul->us;
+
+	return 1;
+}
+
+#endif
+
+/*
+ * The k-th of the LWS_SUL_PT_LISTS lists that can hold suls scheduled on
+ * pt_sul_owner[n]
+ */
+
+#if defined(LWS_WITH_SUL_WHEEL) || defined(LWS_WITH_SUL_DEBUGGING)
+
+#if defined(LWS_WITH_SUL_WHEEL)
+#define LWS_SUL_PT_LISTS (2 + LWS_SUL_WHEEL_SLOTS)
+#else
+#define LWS_SUL_PT_LISTS 1
+#endif
+
+static lws_dll2_owner_t *
+sul_pt_list(struct lws_context_per_thread *pt, int n, int k)
+{
+#if defined(LWS_WITH_SUL_WHEEL)
+	struct lws_sul_wheel *w = &pt->pt_sul_wheel[n];
+
+	if (k > LWS_SUL_WHEEL_SLOTS)
+		return &w->later;
+	if (k)
+		return &w->slot[k - 1];
+#endif
+
+	return &pt->pt_sul_owner[n];
+}
+
+#endif
+
+static int
+sul_pt_peek(struct lws_context_per_thread *pt, int n, lws_usec_t usnow,
+	    lws_sorted_usec_list_t **psul, lws_usec_t *pus)
+{
+#if defined(LWS_WITH_SUL_WHEEL)
+	return sul_wheel_peek(pt, n, usnow, psul, pus);
+#else
+	if (!pt->pt_sul_owner[n].count)
+		return 0;
+
+	*psul = (lws_sorted_usec_list_t *)lws_dll2_get_head(
+						&pt->pt_sul_owner[n]);
+	*pus = (*psul)->us;
+
+	return 1;
+#endif
+}
+
+/*
+ * Schedule on one of a pt's sul owners, the pt lock must be held.  sul->us was
+ * already computed.
+ */
+
+int
+__lws_sul_pt_insert(struct lws_context_per_thread *pt, int n,
+		    lws_sorted_usec_list_t *sul)
+{
+#if defined(LWS_WITH_SUL_WHEEL)
+	struct lws_sul_wheel *w = &pt->pt_sul_wheel[n];
+
+	lws_dll2_remove(&sul->list);
+
+	assert(sul->cb);
+
+	if (!w->limit)
+		w->limit = lws_now_usecs() & ~lv_mask(0);
+
+	sul_wheel_place(&pt->pt_sul_owner[n], w, sul);
+
+	return 0;
+#else
+	return __lws_sul_insert(&pt->pt_sul_owner[n], sul);
+#endif
+}
+
 void
 lws_sul_cancel(lws_sorted_usec_list_t *sul)
 {
@@ -83,8 +424,7 @@ lws_sul2_schedule(struct lws_context *context, int tsi, int flags,
 
 	assert(sul->cb);
 
-	__lws_sul_insert(
-		&pt->pt_sul_owner[!!(flags & LWSSULLI_WAKE_IF_SUSPENDED)], sul);
+	__lws_sul_pt_insert(pt, !!(flags & LWSSULLI_WAKE_IF_SUSPENDED), sul);
 }
 
 /*
@@ -96,13 +436,10 @@ lws_sul2_schedule(struct lws_context *context, int tsi, int flags,
  * earliest scheduled event on any list.
  */
 
-lws_usec_t
-__lws_sul_service_ripe(lws_dll2_owner_t *own, int own_len, lws_usec_t usnow)
+static lws_usec_t
+sul_service_ripe(struct lws_context_per_thread *pt, int first, int own_len,
+		 lws_usec_t usnow)
 {
-	struct lws_context_per_thread *pt = (struct lws_context_per_thread *)
-			lws_container_of(own, struct lws_context_per_thread,
-					 pt_sul_owner);
-
 	if (pt->attach_owner.count)
 		lws_system_do_attach(pt);
 
@@ -123,27 +460,31 @@ __lws_sul_service_ripe(lws_dll2_owner_t *own, int own_len, lws_usec_t usnow)
 	do {
 		lws_sorted_usec_list_t *hit = NULL;
 		lws_usec_t lowest = 0;
-		int n = 0;
+		int n = 0, any = 0;
 
-		for (n = 0; n < own_len; n++) {
+		for (n = first; n < first + own_len; n++) {
 			lws_sorted_usec_list_t *sul;
-			if (!own[n].count)
+			lws_usec_t us;
+
+			if (!sul_pt_peek(pt, n, usnow, &sul, &us))
 				continue;
-			 sul = (lws_sorted_usec_list_t *)
-						     lws_dll2_get_head(&own[n]);
 
-			if (!hit || sul->us <= lowest) {
+			if (!any || us <= lowest) {
 				hit = sul;
-				lowest = sul->us;
+				lowest = us;
+				any = 1;
 			}
 		}
 
-		if (!hit)
+		if (!any)
 			return 0;
 
 		if (lowest > usnow)
 			return lowest - usnow;
 
+		/* only suls still waiting in a wheel slot are inexact */
+		assert(hit);
+
 		/* his moment has come... remove him from his owning list */
 
 		lws_dll2_remove(&hit->list);
@@ -162,6 +503,32 @@ __lws_sul_service_ripe(lws_dll2_owner_t *own, int own_len, lws_usec_t usnow)
 	return 0;
 }
 
+lws_usec_t
+__lws_sul_service_ripe(lws_dll2_owner_t *own, int own_len, lws_usec_t usnow)
+{
+	struct lws_context_per_thread *pt = (struct lws_context_per_thread *)
+			lws_container_of(own, struct lws_context_per_thread,
+					 pt_sul_owner);
+
+	return sul_service_ripe(pt, 0, own_len, usnow);
+}
+
+lws_usec_t
+lws_sul_service_owner(struct lws_context *ctx, int tsi, int owner,
+		      lws_usec_t usnow)
+{
+	struct lws_context_per_thread *pt = &ctx->pt[tsi];
+	lws_usec_t us;
+
+	assert(owner >= 0 && owner < LWS_COUNT_PT_SUL_OWNERS);
+
+	lws_pt_lock(pt, __func__);
+	us = sul_service_ripe(pt, owner, 1, usnow);
+	lws_pt_unlock(pt);
+
+	return us;
+}
+
 /*
  * Normally we use the OS monotonic time, which does not step when the
  * gettimeofday() time is adjusted after, eg, ntpclient.  But on some OSes,
@@ -197,6 +564,40 @@ lws_sul_nonmonotonic_adjust(struct lws_context *ctx, int64_t step_us)
 		lws_pt_lock(pt, __func__);
 
 		for (n = 0; n < LWS_COUNT_PT_SUL_OWNERS; n++) {
+#if defined(LWS_WITH_SUL_WHEEL)
+			lws_dll2_owner_t tmp;
+			lws_sorted_usec_list_t *sul;
+			lws_dll2_owner_t *o;
+			int k;
+
+			/*
+			 * The wheel slots are keyed by time, so collect
+			 * everything, step it and place it again
+			 */
+
+			memset(&tmp, 0, sizeof(tmp));
+			for (k = 0; k < LWS_SUL_PT_LISTS; k++) {
+				o = sul_pt_list(pt, n, k);
+				while ((sul = (lws_sorted_usec_list_t *)
+						lws_dll2_get_head(o))) {
+					lws_dll2_remove(&sul->list);
+					lws_dll2_add_tail(&sul->list, &tmp);
+				}
+			}
+
+			if (pt->pt_sul_wheel[n].limit)
+				pt->pt_sul_wheel[n].limit =
+					(pt->pt_sul_wheel[n].limit + step_us) &
+							~lv_mask(0);
+
+			while ((sul = (lws_sorted_usec_list_t *)
+						lws_dll2_get_head(&tmp))) {
+				lws_dll2_remove(&sul->list);
+				sul->us += step_us;
+				sul_wheel_place(&pt->pt_sul_owner[n],
+						&pt->pt_sul_wheel[n], sul);
+			}
+#else
 
 			if (!pt->pt_sul_owner[n].count)
 				continue;
@@ -218,6 +619,7 @@ lws_sul_nonmonotonic_adjust(struct lws_context *ctx, int64_t step_us)
 				sul->us += step_us;
 
 			} lws_end_foreach_dll(p);
+#endif
 		}
 
 		lws_pt_unlock(pt);
@@ -236,22 +638,25 @@ int
 lws_sul_earliest_wakeable_event(struct lws_context *ctx, lws_usec_t *pearliest)
 {
 	struct lws_context_per_thread *pt;
+	lws_sorted_usec_list_t *sul;
 	int n = 0, hit = -1;
-	lws_usec_t lowest = 0;
+	lws_usec_t lowest = 0, us;
 
 	for (n = 0; n < ctx->count_threads; n++) {
 		pt = &ctx->pt[n];
 
 		lws_pt_lock(pt, __func__);
 
-		if (pt->pt_sul_owner[LWSSULLI_WAKE_IF_SUSPENDED].count) {
-			lws_sorted_usec_list_t *sul = (lws_sorted_usec_list_t *)
-					lws_dll2_get_head(&pt->pt_sul_owner[
-					           LWSSULLI_WAKE_IF_SUSPENDED]);
+		/*
+		 * With LWS_WITH_SUL_WHEEL, this may be the start of the wheel
+		 * slot holding the earliest sul, ie, a little early
+		 */
 
-			if (hit == -1 || sul->us < lowest) {
+		if (sul_pt_peek(pt, LWSSULLI_WAKE_IF_SUSPENDED,
+				lws_now_usecs(), &sul, &us)) {
+			if (hit == -1 || us < lowest) {
 				hit = n;
-				lowest = sul->us;
+				lowest = us;
 			}
 		}
 
@@ -332,10 +737,13 @@ lws_sul_debug_zombies(struct lws_context *ctx, void *po, size_t len,
 
 		lws_pt_lock(pt, __func__);
 
-		for (m = 0; m < LWS_COUNT_PT_SUL_OWNERS; m++) {
+		for (m = 0; m < LWS_COUNT_PT_SUL_OWNERS * LWS_SUL_PT_LISTS;
+		     m++) {
 
 			lws_start_foreach_dll(struct lws_dll2 *, p,
-				      lws_dll2_get_head(&pt->pt_sul_owner[m])) {
+				      lws_dll2_get_head(sul_pt_list(pt,
+						m / LWS_SUL_PT_LISTS,
+						m % LWS_SUL_PT_LISTS))) {
 				lws_sorted_usec_list_t *sul =
 					lws_container_of(p,
 						lws_sorted_usec_list_t, list);
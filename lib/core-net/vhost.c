@@ -567,6 +567,22 @@ static const struct lws_protocols protocols_dummy[] = {
 };
 
 
+#if defined(LWS_WITH_HTTP_STREAM_COMPRESSION) && defined(LWS_WITH_DISKCACHE)
+static void
+lws_vhost_comp_cache_trim(lws_sorted_usec_list_t *sul)
+{
+	struct lws_vhost *vh = lws_container_of(sul, struct lws_vhost,
+						http.sul_comp_cache);
+	int secs;
+
+	lws_diskcache_trim(vh->http.comp_cache);
+
+	secs = lws_diskcache_secs_to_idle(vh->http.comp_cache);
+	lws_sul_schedule(vh->context, 0, sul, lws_vhost_comp_cache_trim,
+			 (secs ? secs : 1) * LWS_US_PER_SEC);
+}
+#endif
+
 #ifdef LWS_PLAT_OPTEE
 #undef LWS_HAVE_GETENV
 #endif
@@ -674,6 +690,12 @@ lws_create_vhost(struct lws_context *context,
 		vh->connect_timeout_secs = (int)info->connect_timeout_secs;
 	else
 		vh->connect_timeout_secs = 20;
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+	if (info->connect_attempt_delay_ms)
+		vh->connect_attempt_delay_ms = info->connect_attempt_delay_ms;
+	else
+		vh->connect_attempt_delay_ms = 250;
+#endif
 #endif
 	/* apply the context default lws_retry */
 
@@ -881,6 +903,23 @@ lws_create_vhost(struct lws_context *context,
 	vh->http.mount_list = info->mounts;
 #endif
 
+#if defined(LWS_WITH_HTTP_STREAM_COMPRESSION) && defined(LWS_WITH_DISKCACHE)
+	if (info->http_compression_cache_dir) {
+		/* we may still be privileged, make it ours after we drop it */
+		lws_diskcache_prepare(info->http_compression_cache_dir, 0700,
+				      context->uid ? context->uid : (uid_t)-1);
+		vh->http.comp_cache = lws_diskcache_create(
+				info->http_compression_cache_dir,
+				info->http_compression_cache_size ?
+					info->http_compression_cache_size :
+					64 * 1024 * 1024);
+		if (vh->http.comp_cache)
+			lws_sul_schedule(context, 0, &vh->http.sul_comp_cache,
+					 lws_vhost_comp_cache_trim,
+					 LWS_US_PER_SEC);
+	}
+#endif
+
 #if defined(LWS_WITH_SYS_METRICS) && defined(LWS_WITH_SERVER)
 	{
 		char *end = buf + sizeof(buf) - 1;
@@ -988,6 +1027,10 @@ lws_create_vhost(struct lws_context *context,
 					   info->log_filepath);
 			goto bail;
 		}
+		if (lws_access_log_init(vh, info)) {
+			close(vh->log_fd);
+			goto bail;
+		}
 #ifndef WIN32
 		if (context->uid != (uid_t)-1)
 			if (chown(info->log_filepath, context->uid,
@@ -1170,7 +1213,7 @@ lws_destroy_event_pipe(struct lws *wsi)
 	n = lws_wsi_extract_from_loop(wsi);
 	lws_plat_pipe_close(wsi);
 	if (!n)
-		lws_free(wsi);
+		lws_slab_free(wsi);
 }
 
 /*
@@ -1533,7 +1576,14 @@ __lws_vhost_destroy2(struct lws_vhost *vh)
 	LWS_FOR_EVERY_AVAILABLE_ROLE_END;
 #endif
 
+#if defined(LWS_WITH_HTTP_STREAM_COMPRESSION) && defined(LWS_WITH_DISKCACHE)
+	lws_sul_cancel(&vh->http.sul_comp_cache);
+	if (vh->http.comp_cache)
+		lws_diskcache_destroy(&vh->http.comp_cache);
+#endif
+
 #ifdef LWS_WITH_ACCESS_LOG
+	lws_access_log_destroy(vh);
 	if (vh->log_fd != (int)LWS_INVALID_FILE)
 		close(vh->log_fd);
 #endif
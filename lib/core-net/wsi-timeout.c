@@ -30,6 +30,9 @@ __lws_wsi_remove_from_sul(struct lws *wsi)
 	lws_sul_cancel(&wsi->sul_timeout);
 	lws_sul_cancel(&wsi->sul_hrtimer);
 	lws_sul_cancel(&wsi->sul_validity);
+#if defined(LWS_WITH_HAPPY_EYEBALLS)
+	lws_sul_cancel(&wsi->sul_he);
+#endif
 #if defined(LWS_WITH_SYS_FAULT_INJECTION)
 	lws_sul_cancel(&wsi->sul_fault_timedclose);
 #endif
@@ -57,7 +60,7 @@ __lws_set_timer_usecs(struct lws *wsi, lws_usec_t us)
 	struct lws_context_per_thread *pt = &wsi->a.context->pt[(int)wsi->tsi];
 
 	wsi->sul_hrtimer.cb = lws_sul_hrtimer_cb;
-	__lws_sul_insert_us(&pt->pt_sul_owner[LWSSULLI_MISS_IF_SUSPENDED],
+	__lws_sul_insert_us(pt, LWSSULLI_MISS_IF_SUSPENDED,
 			    &wsi->sul_hrtimer, us);
 }
 
@@ -127,7 +130,7 @@ __lws_set_timeout(struct lws *wsi, enum pending_timeout reason, int secs)
 	struct lws_context_per_thread *pt = &wsi->a.context->pt[(int)wsi->tsi];
 
 	wsi->sul_timeout.cb = lws_sul_wsitimeout_cb;
-	__lws_sul_insert_us(&pt->pt_sul_owner[LWSSULLI_MISS_IF_SUSPENDED],
+	__lws_sul_insert_us(pt, LWSSULLI_MISS_IF_SUSPENDED,
 			    &wsi->sul_timeout,
 			    ((lws_usec_t)secs) * LWS_US_PER_SEC);
 
@@ -185,7 +188,7 @@ lws_set_timeout_us(struct lws *wsi, enum pending_timeout reason, lws_usec_t us)
 		return;
 
 	lws_pt_lock(pt, __func__);
-	__lws_sul_insert_us(&pt->pt_sul_owner[LWSSULLI_MISS_IF_SUSPENDED],
+	__lws_sul_insert_us(pt, LWSSULLI_MISS_IF_SUSPENDED,
 			    &wsi->sul_timeout, us);
 
 	lwsl_wsi_notice(wsi, "%llu us, reason %d",
@@ -234,7 +237,7 @@ lws_validity_cb(lws_sorted_usec_list_t *sul)
 	assert(rbo->secs_since_valid_hangup > rbo->secs_since_valid_ping);
 
 	wsi->validity_hup = 1;
-	__lws_sul_insert_us(&pt->pt_sul_owner[!!wsi->conn_validity_wakesuspend],
+	__lws_sul_insert_us(pt, !!wsi->conn_validity_wakesuspend,
 			    &wsi->sul_validity,
 			    ((uint64_t)rbo->secs_since_valid_hangup -
 				 rbo->secs_since_valid_ping) * LWS_US_PER_SEC);
@@ -265,7 +268,7 @@ _lws_validity_confirmed_role(struct lws *wsi)
 					    rbo->secs_since_valid_ping,
 			   wsi->validity_hup);
 
-	__lws_sul_insert_us(&pt->pt_sul_owner[!!wsi->conn_validity_wakesuspend],
+	__lws_sul_insert_us(pt, !!wsi->conn_validity_wakesuspend,
 			    &wsi->sul_validity,
 			    ((uint64_t)(wsi->validity_hup ?
 				rbo->secs_since_valid_hangup :
@@ -297,11 +297,12 @@ __lws_wsi_create_with_role(struct lws_context *context, int tsi,
 
 	lws_context_assert_lock_held(context);
 
-#if defined(LWS_WITH_EVENT_LIBS)
+#if defined(LWS_WITH_EVENT_LIBS) || defined(LWS_WITH_EPOLL) || \
+    defined(LWS_WITH_IO_URING)
 	s += context->event_loop_ops->evlib_size_wsi;
 #endif
 
-	wsi = lws_zalloc(s, __func__);
+	wsi = lws_slab_zalloc(&context->pt[tsi], LWS_SLAB_WSI, s);
 
 	if (!wsi) {
 		lwsl_cx_err(context, "OOM");
@@ -313,7 +314,8 @@ __lws_wsi_create_with_role(struct lws_context *context, int tsi,
 	else
 		wsi->lc.log_cx = context->log_cx;
 
-#if defined(LWS_WITH_EVENT_LIBS)
+#if defined(LWS_WITH_EVENT_LIBS) || defined(LWS_WITH_EPOLL) || \
+    defined(LWS_WITH_IO_URING)
 	wsi->evlib_wsi = (uint8_t *)wsi + sizeof(*wsi);
 #endif
 	wsi->a.context = context;
@@ -333,7 +335,7 @@ __lws_wsi_create_with_role(struct lws_context *context, int tsi,
 
 	if (lws_fi(&wsi->fic, "createfail")) {
 		lws_fi_destroy(&wsi->fic);
-		lws_free(wsi);
+		lws_slab_free(wsi);
 		return NULL;
 	}
 
@@ -614,6 +616,20 @@ lws_is_ssl(struct lws *wsi)
 #endif
 }
 
+int
+lws_tls_ktls_state(struct lws *wsi)
+{
+#if defined(LWS_WITH_TLS)
+	wsi = lws_get_network_wsi(wsi);
+
+	return (wsi->tls.ktls_tx ? LWS_TLS_KTLS_TX : 0) |
+	       (wsi->tls.ktls_rx ? LWS_TLS_KTLS_RX : 0);
+#else
+	(void)wsi;
+	return 0;
+#endif
+}
+
 #if defined(LWS_WITH_TLS) && !defined(LWS_WITH_MBEDTLS)
 lws_tls_conn*
 lws_get_ssl(struct lws *wsi)
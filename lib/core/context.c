@@ -478,6 +478,26 @@ lws_create_context(const struct lws_context_creation_info *info)
 	}
 #endif
 
+#if defined(LWS_WITH_EPOLL)
+	if (!info->event_lib_custom &&
+	    lws_check_opt(info->options, LWS_SERVER_OPTION_EPOLL)) {
+		extern const lws_plugin_evlib_t evlib_epoll;
+		plev = &evlib_epoll;
+		/* epoll_wait() also only has ms resolution */
+		us_wait_resolution = 1000;
+	}
+#endif
+
+#if defined(LWS_WITH_IO_URING)
+	if (!info->event_lib_custom &&
+	    lws_check_opt(info->options, LWS_SERVER_OPTION_IO_URING)) {
+		extern const lws_plugin_evlib_t evlib_io_uring;
+		plev = &evlib_io_uring;
+		/* we wait in ms to share the poll() timeout computation */
+		us_wait_resolution = 1000;
+	}
+#endif
+
 #if defined(LWS_WITH_EVLIB_PLUGINS) && defined(LWS_WITH_EVENT_LIBS)
 
 	/*
@@ -779,6 +799,21 @@ lws_create_context(const struct lws_context_creation_info *info)
 					     LWSMTFL_REPORT_HIST, "n.srv");
 #endif /* network + metrics + server */
 
+#if defined(LWS_ROLE_H1) || defined(LWS_ROLE_H2)
+	context->mth_ah = lws_metric_create(context, LWSMTFL_REPORT_HIST,
+					    "n.http.ah");
+#endif
+
+#if defined(LWS_WITH_TX_BATCH)
+	context->mt_tx_batch = lws_metric_create(context, LWSMTFL_REPORT_MEAN,
+						 "n.tx.batch");
+#endif
+
+#if defined(LWS_WITH_WSI_SLAB)
+	context->mth_slab = lws_metric_create(context, LWSMTFL_REPORT_HIST,
+					      "n.slab");
+#endif
+
 #endif /* network + metrics */
 
 #endif /* network */
@@ -1059,6 +1094,11 @@ lws_create_context(const struct lws_context_creation_info *info)
 			context->max_http_header_pool = context->max_fds;
 #endif
 
+#if defined(LWS_WITH_WSI_SLAB)
+	context->slab_chunk_alloc = info->slab_chunk_alloc;
+	context->slab_chunk_free = info->slab_chunk_free;
+#endif
+
 	if (info->fd_limit_per_thread)
 		context->fd_limit_per_thread = lpf;
 	else
@@ -1137,11 +1177,18 @@ lws_create_context(const struct lws_context_creation_info *info)
 		context->pt[n].evlib_pt = u;
 		u += plev->ops->evlib_size_pt;
 
+		lws_pt_mutex_init(&context->pt[n]);
+
 #if defined(LWS_ROLE_H1) || defined(LWS_ROLE_H2)
-		context->pt[n].http.ah_list = NULL;
-		context->pt[n].http.ah_pool_length = 0;
+		if (info->http_header_pool_prealloc &&
+		    _lws_ah_pool_prealloc(&context->pt[n],
+				info->http_header_pool_prealloc <
+					context->max_http_header_pool ?
+				info->http_header_pool_prealloc :
+					context->max_http_header_pool,
+				(ah_data_idx_t)context->max_http_header_data))
+			lwsl_cx_warn(context, "unable to preallocate ah pool");
 #endif
-		lws_pt_mutex_init(&context->pt[n]);
 
 #if defined(LWS_WITH_CGI)
 		if (lws_rops_fidx(&role_ops_cgi, LWS_ROPS_pt_init_destroy))
@@ -1786,10 +1833,19 @@ lws_pt_destroy(struct lws_context_per_thread *pt)
 #endif
 
 #if defined(LWS_ROLE_H1) || defined(LWS_ROLE_H2)
-		while (pt->http.ah_list)
-			_lws_destroy_ah(pt, pt->http.ah_list);
+		_lws_ah_pool_destroy(pt);
 #endif
 
+#endif
+
+#if defined(LWS_WITH_TX_BATCH)
+	lws_free_set_NULL(pt->tx_batch);
+#endif
+#if defined(LWS_ROLE_WS)
+	lws_ws_rx_pool_destroy(pt);
+#endif
+#if defined(LWS_WITH_WSI_SLAB)
+	lws_slab_destroy(pt);
 #endif
 
 	lws_pt_unlock(pt);
@@ -2131,8 +2187,7 @@ next:
 #endif
 
 #if defined(LWS_ROLE_H1) || defined(LWS_ROLE_H2)
-			while (pt->http.ah_list)
-				_lws_destroy_ah(pt, pt->http.ah_list);
+			_lws_ah_pool_destroy(pt);
 #endif
 			lwsl_cx_info(context, "pt destroy %d", n);
 			lws_pt_destroy(pt);
@@ -2266,6 +2321,8 @@ next:
 		if (context->ac_policy)
 			lwsac_free(&context->ac_policy);
 
+		lejp_path_table_destroy(&context->pol_paths);
+
 #if defined(LWS_WITH_SERVER)
 		/* ... for every sink... */
 		lws_start_foreach_dll_safe(struct lws_dll2 *, d, d1,
@@ -540,6 +540,19 @@ struct lws_context {
 #if defined(LWS_WITH_SERVER)
 	lws_metric_t			*mth_srv;
 #endif
+#if defined(LWS_WITH_SYS_METRICS) && defined(LWS_WITH_TX_BATCH)
+	lws_metric_t			*mt_tx_batch; /* frames per batched write */
+#endif
+#if defined(LWS_ROLE_H1) || defined(LWS_ROLE_H2)
+	lws_metric_t			*mth_ah; /* ah pool hit / miss / wait */
+#endif
+#if defined(LWS_WITH_WSI_SLAB)
+	void *(*slab_chunk_alloc)(struct lws_context *cx, size_t len);
+	void (*slab_chunk_free)(struct lws_context *cx, void *p);
+#if defined(LWS_WITH_SYS_METRICS)
+	lws_metric_t			*mth_slab; /* slab cache hit / miss */
+#endif
+#endif
 
 #if defined(LWS_WITH_EVENT_LIBS)
 	struct lws_plugin		*evlib_plugin_list;
@@ -623,6 +636,7 @@ struct lws_context {
 	struct lws_fd_hashtable fd_hashtable[FD_HASHTABLE_MODULUS];
 #else
 	struct lws **lws_lookup;
+	unsigned int lws_lookup_size; /* pow2 if max_fds_unrelated_to_ulimit */
 
 #endif
 
@@ -678,6 +692,7 @@ struct lws_context {
 	const char			*pss_policies_json;
 	struct lwsac			*ac_policy;
 	void				*pol_args;
+	struct lejp_path_table		*pol_paths;
 #endif
 	const lws_ss_policy_t		*pss_policies;
 	const lws_ss_auth_t		*pss_auths;
@@ -952,6 +967,12 @@ __lws_create_event_pipes(struct lws_context *context);
 int
 lws_plat_apply_FD_CLOEXEC(int n);
 
+#if defined(LWS_HAVE_SYS_SENDFILE_H)
+int
+lws_plat_file_sendfile(lws_fop_fd_t fop_fd, lws_sockfd_type sockfd,
+		       lws_filepos_t len);
+#endif
+
 const struct lws_plat_file_ops *
 lws_vfs_select_fops(const struct lws_plat_file_ops *fops, const char *vfs_path,
 		    const char **vpath);
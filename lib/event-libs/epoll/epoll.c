@@ -0,0 +1,241 @@
+ /*
+ * libwebsockets - small server side websockets and web server implementation
+ *
+ * Copyright (C) 2010 - 2021 Andy Green <andy@warmcat.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE
+ *
+ * The epoll event lib is built into lws alongside poll, and reuses the whole
+ * of the default lws_service() flow, including pt->fds[] and its bookkeeping.
+ * The difference is that the kernel keeps the interest set, we keep it in sync
+ * from the io() op that __lws_change_pollfd() already calls, and the wait
+ * returns only the fds that are ready.  So a pt with 50K mostly idle
+ * connections only pays for the ones that actually have events.
+ */
+
+#include <private-lib-core.h>
+#include "private-lib-event-libs-epoll.h"
+
+#define pt_to_priv_epoll(_pt) ((struct lws_pt_eventlibs_epoll *)(_pt)->evlib_pt)
+#define wsi_to_priv_epoll(_w) ((struct lws_wsi_eventlibs_epoll *)(_w)->evlib_wsi)
+
+static int
+elops_foreign_thread_epoll(struct lws_context *cx, int tsi)
+{
+	struct lws_context_per_thread *pt = &cx->pt[tsi];
+	volatile struct lws_context_per_thread *vpt =
+				(volatile struct lws_context_per_thread *)pt;
+
+	/* same probabilistic check as poll, we share the wait bookkeeping */
+
+	return vpt->inside_poll;
+}
+
+static int
+elops_init_pt_epoll(struct lws_context *cx, void *_loop, int tsi)
+{
+	struct lws_pt_eventlibs_epoll *ptpr = pt_to_priv_epoll(&cx->pt[tsi]);
+
+	ptpr->count_ready = 0;
+	ptpr->epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (ptpr->epfd < 0) {
+		lwsl_cx_err(cx, "epoll_create1 failed, errno %d", errno);
+		return 1;
+	}
+
+	return 0;
+}
+
+static void
+elops_destroy_pt_epoll(struct lws_context *cx, int tsi)
+{
+	struct lws_pt_eventlibs_epoll *ptpr = pt_to_priv_epoll(&cx->pt[tsi]);
+
+	if (ptpr->epfd >= 0) {
+		close(ptpr->epfd);
+		ptpr->epfd = -1;
+	}
+	ptpr->count_ready = 0;
+}
+
+static void
+elops_io_epoll(struct lws *wsi, unsigned int flags)
+{
+	struct lws_context_per_thread *pt = &wsi->a.context->pt[(int)wsi->tsi];
+	struct lws_pt_eventlibs_epoll *ptpr = pt_to_priv_epoll(pt);
+	struct lws_wsi_eventlibs_epoll *w = wsi_to_priv_epoll(wsi);
+	uint32_t e = (uint32_t)(((flags & LWS_EV_WRITE) ? EPOLLOUT : 0) |
+				((flags & LWS_EV_READ) ? EPOLLIN : 0)), u;
+	struct epoll_event ev;
+	int op;
+
+	if (ptpr->epfd < 0 || !lws_socket_is_valid(wsi->desc.sockfd))
+		return;
+
+	assert((flags & (LWS_EV_START | LWS_EV_STOP)) &&
+	       (flags & (LWS_EV_READ | LWS_EV_WRITE)));
+
+	if ((flags & LWS_EV_STOP) &&
+	    (flags & (LWS_EV_READ | LWS_EV_WRITE)) ==
+					(LWS_EV_READ | LWS_EV_WRITE)) {
+		/*
+		 * __lws_change_pollfd() only ever changes one direction at a
+		 * time, stopping both at once is the fd leaving pt->fds[].
+		 * This happens before the fd is closed, so it can't be
+		 * confused with a new fd that reused the number.
+		 */
+		if (w->registered &&
+		    epoll_ctl(ptpr->epfd, EPOLL_CTL_DEL, w->fd, NULL) &&
+		    errno != EBADF && errno != ENOENT)
+			lwsl_wsi_info(wsi, "EPOLL_CTL_DEL fd %d: errno %d",
+				      (int)w->fd, errno);
+		w->registered = 0;
+		w->actual_events = 0;
+
+		return;
+	}
+
+	u = w->actual_events;
+	if (flags & LWS_EV_START)
+		u |= e;
+	if (flags & LWS_EV_STOP)
+		u &= ~e;
+
+	if (w->registered && w->fd == wsi->desc.sockfd &&
+	    u == w->actual_events)
+		return;
+
+	op = EPOLL_CTL_MOD;
+	if (!w->registered || w->fd != wsi->desc.sockfd)
+		op = EPOLL_CTL_ADD;
+
+	memset(&ev, 0, sizeof(ev));
+	ev.events = u;
+	ev.data.fd = wsi->desc.sockfd;
+
+	if (epoll_ctl(ptpr->epfd, op, wsi->desc.sockfd, &ev)) {
+		if (op != EPOLL_CTL_ADD || errno != EEXIST) {
+			lwsl_wsi_err(wsi, "epoll_ctl %d fd %d: errno %d", op,
+				     (int)wsi->desc.sockfd, errno);
+			return;
+		}
+		/* already there (eg, from a dup'd descriptor), update it */
+		if (epoll_ctl(ptpr->epfd, EPOLL_CTL_MOD, wsi->desc.sockfd,
+			      &ev)) {
+			lwsl_wsi_err(wsi, "EPOLL_CTL_MOD fd %d: errno %d",
+				     (int)wsi->desc.sockfd, errno);
+			return;
+		}
+	}
+
+	w->fd = wsi->desc.sockfd;
+	w->actual_events = u;
+	w->registered = 1;
+}
+
+int
+lws_epoll_service_wait(struct lws_context_per_thread *pt, int timeout_ms)
+{
+	struct lws_pt_eventlibs_epoll *ptpr = pt_to_priv_epoll(pt);
+	int n;
+
+	ptpr->count_ready = 0;
+
+	n = epoll_wait(ptpr->epfd, ptpr->ev, LWS_EPOLL_MAX_EVENTS, timeout_ms);
+	if (n < 0) {
+		if (errno != EINTR)
+			lwsl_cx_err(pt->context, "epoll_wait: errno %d", errno);
+
+		return 0;
+	}
+
+	ptpr->count_ready = n;
+
+	return n;
+}
+
+int
+lws_epoll_service_ready(struct lws_context *cx, int tsi)
+{
+	struct lws_context_per_thread *pt = &cx->pt[tsi];
+	struct lws_pt_eventlibs_epoll *ptpr = pt_to_priv_epoll(pt);
+	int n, count = ptpr->count_ready;
+
+	ptpr->count_ready = 0;
+
+	for (n = 0; n < count; n++) {
+		uint32_t e = ptpr->ev[n].events;
+		struct lws_pollfd *pfd;
+		struct lws *wsi;
+		short rev;
+
+		/*
+		 * Servicing an earlier fd in the batch may have closed this
+		 * one, look it up again rather than trust a stale pointer
+		 */
+		wsi = wsi_from_fd(cx, ptpr->ev[n].data.fd);
+		if (!wsi || wsi->position_in_fds_table == LWS_NO_FDS_POS)
+			continue;
+
+		pfd = &pt->fds[wsi->position_in_fds_table];
+
+		rev = (short)(((e & EPOLLIN) ? LWS_POLLIN : 0) |
+			      ((e & EPOLLOUT) ? LWS_POLLOUT : 0) |
+			      ((e & EPOLLHUP) ? LWS_POLLHUP : 0) |
+			      ((e & EPOLLERR) ? POLLERR : 0));
+
+		/* the events may also have changed since the wait */
+		pfd->revents = (short)(pfd->revents | (rev & (pfd->events |
+						LWS_POLLHUP | POLLERR)));
+		if (!pfd->revents)
+			continue;
+
+		if (lws_service_fd_tsi(cx, pfd, tsi) < 0) {
+			lwsl_cx_err(cx, "lws_service_fd_tsi failed");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+struct lws_event_loop_ops event_loop_ops_epoll = {
+	.name				= "epoll",
+
+	.init_pt			= elops_init_pt_epoll,
+	.io				= elops_io_epoll,
+	.destroy_pt			= elops_destroy_pt_epoll,
+	.foreign_thread			= elops_foreign_thread_epoll,
+
+	.flags				= LELOF_ISPOLL,
+
+	.evlib_size_pt			= sizeof(struct lws_pt_eventlibs_epoll),
+	.evlib_size_wsi			= sizeof(struct lws_wsi_eventlibs_epoll),
+};
+
+const lws_plugin_evlib_t evlib_epoll = {
+	.hdr = {
+		"epoll",
+		"lws_evlib_plugin",
+		"n/a",
+		LWS_PLUGIN_API_MAGIC
+	},
+
+	.ops	= &event_loop_ops_epoll
+};
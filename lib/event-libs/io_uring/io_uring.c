@@ -0,0 +1,1251 @@
+ /*
+ * libwebsockets - small server side websockets and web server implementation
+ *
+ * Copyright (C) 2010 - 2021 Andy Green <andy@warmcat.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE
+ *
+ * The io_uring event lib is built into lws like poll and epoll, and uses the
+ * same default lws_service() flow.  It talks to the kernel directly via the
+ * syscalls, there's no dependency on liburing.
+ *
+ * Everything the pt asks of the kernel during a pass only queues SQEs, which
+ * are all submitted together with the wait in a single io_uring_enter() per
+ * service loop.
+ *
+ * For most fds that's a oneshot IORING_OP_POLL_ADD with the current events,
+ * rearmed after service.  But plain tcp connections accepted by a server
+ * (no tls, since OpenSSL does its own socket io) do their io as completions:
+ *
+ *  - rx is a multishot IORING_OP_RECV into a registered ring of provided
+ *    buffers, each pt_serv_buf_size.  Filled buffers queue on the wsi and
+ *    lws_ssl_capable_read_no_ssl() takes from them instead of recv(), the
+ *    buffer goes back on the ring once it's used up
+ *
+ *  - tx is copied into a per-pt pool of pt_serv_buf_size buffers queued on
+ *    the wsi, the head one with an IORING_OP_SEND in flight.  Like a socket
+ *    buffer, writes see EAGAIN when the wsi has LWS_IO_URING_TX_PER_WSI
+ *    buffers queued or the pool is empty, and the wsi gets POLLOUT when its
+ *    queue drains.  If lws closes the fd with tx still queued, the socket is
+ *    kept open on a dup until it has all gone out
+ *
+ * Listen sockets use a multishot IORING_OP_ACCEPT, the accepted fds wait on
+ * the pt until the listen role takes them via lws_io_uring_accept().
+ *
+ * Filled rx buffers and accepted fds that weren't taken during the pass put
+ * their wsi on the pt pending list, which gets them serviced again without
+ * waiting while they still want POLLIN.
+ *
+ * If the kernel can't do any of this (registered buffer rings and multishot
+ * accept need 5.19, multishot recv needs 6.0), or a wsi's multishot op ends
+ * with an error such as running out of provided buffers, that fd goes back
+ * to polling for POLLIN and reading or accepting the usual way until it is
+ * next serviced.
+ *
+ * Pending SQEs are tagged with the op, a per-pt generation and the fd (or
+ * tx buffer index), so a completion for something that was cancelled, or for
+ * a previous user of a recycled fd number, is recognized as stale.
+ *
+ * Needs Linux 5.11+ for IORING_FEAT_EXT_ARG (timeout on the wait itself).
+ */
+
+#include <private-lib-core.h>
+#include "private-lib-event-libs-io_uring.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <signal.h>
+
+#define pt_to_priv_uring(_pt) \
+		((struct lws_pt_eventlibs_io_uring *)(_pt)->evlib_pt)
+#define wsi_to_priv_uring(_w) \
+		((struct lws_wsi_eventlibs_io_uring *)(_w)->evlib_wsi)
+
+enum {
+	LWS_URING_OP_POLL = 1,
+	LWS_URING_OP_RECV,
+	LWS_URING_OP_ACCEPT,
+	LWS_URING_OP_SEND,
+};
+
+/* user_data 0 is reserved for fire-and-forget, the op is never 0 */
+#define lws_uring_ud(_op, _gen, _fd) (((uint64_t)(_op) << 56) | \
+				      (((uint64_t)(_gen) & 0xffffff) << 32) | \
+				      (uint32_t)(_fd))
+#define lws_uring_ud_op(_ud) ((int)((_ud) >> 56))
+#define lws_uring_ud_fd(_ud) ((lws_sockfd_type)(int)(uint32_t)(_ud))
+
+static int
+lws_uring_enter(struct lws_pt_eventlibs_io_uring *ptpr, unsigned int submit,
+		unsigned int min_complete, unsigned int flags, void *arg,
+		size_t argsz)
+{
+	return (int)syscall(__NR_io_uring_enter, ptpr->ring_fd, submit,
+			    min_complete, flags, arg, argsz);
+}
+
+static void
+lws_uring_submitted(struct lws_pt_eventlibs_io_uring *ptpr)
+{
+	/* the kernel moves sq_head along for whatever it consumed */
+	ptpr->to_submit = *ptpr->sq_tail -
+			  __atomic_load_n(ptpr->sq_head, __ATOMIC_ACQUIRE);
+}
+
+static void
+lws_uring_flush(struct lws_pt_eventlibs_io_uring *ptpr)
+{
+	if (!ptpr->to_submit)
+		return;
+
+	lws_uring_enter(ptpr, ptpr->to_submit, 0, 0, NULL, 0);
+	lws_uring_submitted(ptpr);
+}
+
+static struct io_uring_sqe *
+lws_uring_get_sqe(struct lws_pt_eventlibs_io_uring *ptpr)
+{
+	unsigned int tail = *ptpr->sq_tail, idx;
+	struct io_uring_sqe *sqe;
+
+	if (tail - __atomic_load_n(ptpr->sq_head, __ATOMIC_ACQUIRE) >=
+							ptpr->sq_entries) {
+		/* SQ is full of queued changes, hand them to the kernel now */
+		lws_uring_flush(ptpr);
+		if (tail - __atomic_load_n(ptpr->sq_head, __ATOMIC_ACQUIRE) >=
+							ptpr->sq_entries)
+			return NULL;
+	}
+
+	idx = tail & *ptpr->sq_mask;
+	sqe = &ptpr->sqes[idx];
+	memset(sqe, 0, sizeof(*sqe));
+	ptpr->sq_array[idx] = idx;
+
+	return sqe;
+}
+
+static void
+lws_uring_commit_sqe(struct lws_pt_eventlibs_io_uring *ptpr,
+		     struct io_uring_sqe *sqe, int op, uint32_t tag)
+{
+	sqe->user_data = lws_uring_ud(op, ++ptpr->gen, tag);
+	__atomic_store_n(ptpr->sq_tail, *ptpr->sq_tail + 1, __ATOMIC_RELEASE);
+	ptpr->to_submit++;
+}
+
+static void
+lws_uring_cancel(struct lws_pt_eventlibs_io_uring *ptpr, uint64_t *ud)
+{
+	struct io_uring_sqe *sqe;
+
+	if (!*ud)
+		return;
+
+	sqe = lws_uring_get_sqe(ptpr);
+	if (sqe) {
+		sqe->opcode	= IORING_OP_ASYNC_CANCEL;
+		sqe->fd		= -1;
+		sqe->addr	= *ud;
+		/* fire-and-forget */
+		__atomic_store_n(ptpr->sq_tail, *ptpr->sq_tail + 1,
+				 __ATOMIC_RELEASE);
+		ptpr->to_submit++;
+	}
+
+	/* even if we couldn't cancel it, its completion will be stale now */
+	*ud = 0;
+}
+
+static int
+lws_uring_ready(struct lws_pt_eventlibs_io_uring *ptpr, lws_sockfd_type fd,
+		uint32_t revents)
+{
+	int n;
+
+	for (n = 0; n < ptpr->count_ready; n++)
+		if (ptpr->ready[n].fd == fd) {
+			ptpr->ready[n].revents |= revents;
+			return 1;
+		}
+
+	if (ptpr->count_ready == LWS_IO_URING_MAX_READY)
+		return 0;
+
+	ptpr->ready[ptpr->count_ready].fd = fd;
+	ptpr->ready[ptpr->count_ready++].revents = revents;
+
+	return 1;
+}
+
+/*
+ * Plain tcp connections accepted by a server can do their rx and tx as
+ * completions.  Client connections may still be talking to a proxy directly
+ * on the socket, and tls connections have OpenSSL doing the socket io.
+ */
+
+static int
+lws_uring_io_capable(struct lws *wsi)
+{
+	return lwsi_role_server(wsi) && !lws_is_ssl(wsi) &&
+	       !wsi->role_ops->file_handle &&
+#if defined(LWS_WITH_SERVER)
+	       wsi->role_ops != &role_ops_listen &&
+#endif
+#if defined(LWS_WITH_UDP)
+	       !wsi->udp &&
+#endif
+	       wsi->role_ops != &role_ops_pipe && !lwsi_role_cgi(wsi);
+}
+
+static int
+lws_uring_is_listen(struct lws *wsi)
+{
+#if defined(LWS_WITH_SERVER)
+	return wsi->role_ops == &role_ops_listen;
+#else
+	return 0;
+#endif
+}
+
+static int
+lws_uring_acc_find(struct lws_pt_eventlibs_io_uring *ptpr,
+		   lws_sockfd_type listen_fd)
+{
+	int n;
+
+	for (n = 0; n < ptpr->acc_count; n++)
+		if (ptpr->acc[n].listen_fd == listen_fd)
+			return n;
+
+	return -1;
+}
+
+static void
+lws_uring_acc_remove(struct lws_pt_eventlibs_io_uring *ptpr, int n)
+{
+	ptpr->acc_count--;
+	memmove(&ptpr->acc[n], &ptpr->acc[n + 1],
+		(size_t)(ptpr->acc_count - n) * sizeof(ptpr->acc[0]));
+}
+
+/* is there rx or an accepted fd on the wsi that lws didn't take yet? */
+
+static void
+lws_uring_check_pending(struct lws_pt_eventlibs_io_uring *ptpr,
+			struct lws_wsi_eventlibs_io_uring *w)
+{
+	int p = w->rx_head || w->rx_eof ||
+		(lws_uring_is_listen(w->wsi) &&
+		 lws_uring_acc_find(ptpr, w->fd) >= 0);
+
+	if (p && !w->pending.owner)
+		lws_dll2_add_tail(&w->pending, &ptpr->pending);
+	if (!p && w->pending.owner)
+		lws_dll2_remove(&w->pending);
+}
+
+static void
+lws_uring_rxb_return(struct lws_pt_eventlibs_io_uring *ptpr, int bid)
+{
+	uint16_t tail = ptpr->br->tail;
+	struct io_uring_buf *b = &ptpr->br->bufs[tail &
+						 (LWS_IO_URING_RX_BUFS - 1)];
+
+	b->addr	= (uint64_t)(uintptr_t)(ptpr->rx_pool +
+					(size_t)bid * ptpr->buf_size);
+	b->len	= (uint32_t)ptpr->buf_size;
+	b->bid	= (uint16_t)bid;
+
+	__atomic_store_n(&ptpr->br->tail, (uint16_t)(tail + 1),
+			 __ATOMIC_RELEASE);
+}
+
+static void
+lws_uring_send(struct lws_pt_eventlibs_io_uring *ptpr, int i)
+{
+	struct lws_io_uring_txb *t = &ptpr->txb[i];
+	struct io_uring_sqe *sqe = lws_uring_get_sqe(ptpr);
+
+	if (!sqe) {
+		lwsl_err("%s: SQ full, fd %d tx stalled\n", __func__,
+			 (int)t->fd);
+		return;
+	}
+
+	sqe->opcode	= IORING_OP_SEND;
+	sqe->fd		= t->fd;
+	sqe->addr	= (uint64_t)(uintptr_t)(t->buf + t->ofs);
+	sqe->len	= t->len - t->ofs;
+	sqe->msg_flags	= MSG_NOSIGNAL;
+	lws_uring_commit_sqe(ptpr, sqe, LWS_URING_OP_SEND, (uint32_t)i);
+
+	t->ud = sqe->user_data;
+}
+
+static void
+lws_uring_arm_rx(struct lws_pt_eventlibs_io_uring *ptpr,
+		 struct lws_wsi_eventlibs_io_uring *w, int listen)
+{
+	struct io_uring_sqe *sqe = lws_uring_get_sqe(ptpr);
+
+	if (!sqe)
+		return; /* we'll poll for it instead */
+
+	sqe->fd = w->fd;
+	if (listen) {
+		sqe->opcode		= IORING_OP_ACCEPT;
+		sqe->ioprio		= IORING_ACCEPT_MULTISHOT;
+		sqe->accept_flags	= SOCK_NONBLOCK | SOCK_CLOEXEC;
+	} else {
+		sqe->opcode		= IORING_OP_RECV;
+		sqe->ioprio		= IORING_RECV_MULTISHOT;
+		sqe->flags		= IOSQE_BUFFER_SELECT;
+		sqe->buf_group		= 0;
+	}
+	lws_uring_commit_sqe(ptpr, sqe, listen ? LWS_URING_OP_ACCEPT :
+						 LWS_URING_OP_RECV,
+			     (uint32_t)w->fd);
+
+	w->rx_armed = sqe->user_data;
+}
+
+/*
+ * Bring what we have in flight for the wsi into line with what it wants
+ */
+
+static void
+lws_uring_update(struct lws_pt_eventlibs_io_uring *ptpr,
+		 struct lws_wsi_eventlibs_io_uring *w)
+{
+	int listen = lws_uring_is_listen(w->wsi), rx;
+	uint32_t pe = w->actual_events;
+	struct io_uring_sqe *sqe;
+
+	if (listen)
+		rx = !ptpr->no_accept_multishot;
+	else
+		rx = ptpr->br && !ptpr->no_recv_multishot && !w->rx_eof &&
+		     lws_uring_io_capable(w->wsi);
+
+	if (pe & POLLIN) {
+		if (rx && !w->rx_poll && !w->rx_armed)
+			lws_uring_arm_rx(ptpr, w, listen);
+		if (w->rx_armed)
+			pe &= ~(uint32_t)POLLIN;
+	} else
+		/* eg, rx flow control, stop the kernel reading for us */
+		lws_uring_cancel(ptpr, &w->rx_armed);
+
+	/* the end of the tx queue will tell him */
+	if (w->tx_head)
+		pe &= ~(uint32_t)POLLOUT;
+
+	if (w->armed && w->poll_events == pe)
+		return;
+
+	/* a pending poll with the old events must be replaced */
+	lws_uring_cancel(ptpr, &w->armed);
+
+	w->poll_events = pe;
+	if (!pe)
+		return;
+
+	sqe = lws_uring_get_sqe(ptpr);
+	if (!sqe) {
+		lwsl_err("%s: SQ full, fd %d not armed\n", __func__,
+			 (int)w->fd);
+		return;
+	}
+
+	sqe->opcode		= IORING_OP_POLL_ADD;
+	sqe->fd			= w->fd;
+	sqe->poll32_events	= pe;
+	lws_uring_commit_sqe(ptpr, sqe, LWS_URING_OP_POLL, (uint32_t)w->fd);
+
+	w->armed = sqe->user_data;
+}
+
+/*
+ * The fd is leaving pt->fds[], and will be closed right after
+ */
+
+static void
+lws_uring_release(struct lws_pt_eventlibs_io_uring *ptpr,
+		  struct lws_wsi_eventlibs_io_uring *w)
+{
+	lws_sockfd_type fd;
+	int n;
+
+	lws_uring_cancel(ptpr, &w->armed);
+	lws_uring_cancel(ptpr, &w->rx_armed);
+
+	/* nobody is going to read what's queued */
+
+	while (w->rx_head) {
+		n = w->rx_head - 1;
+		w->rx_head = ptpr->rxb[n].next;
+		lws_uring_rxb_return(ptpr, n);
+	}
+
+	while ((n = lws_uring_acc_find(ptpr, w->fd)) >= 0) {
+		close(ptpr->acc[n].fd);
+		lws_uring_acc_remove(ptpr, n);
+	}
+
+	if (w->tx_head) {
+		/*
+		 * Keep the socket open on a dup until the queued tx went
+		 * out, the end of the queue closes it
+		 */
+		fd = dup(w->fd);
+		if (fd < 0)
+			lwsl_warn("%s: fd %d: dup failed, losing tx\n",
+				  __func__, (int)w->fd);
+
+		for (n = w->tx_head; n; n = ptpr->txb[n - 1].next)
+			ptpr->txb[n - 1].fd = fd < 0 ? -1 : fd;
+		ptpr->txb[w->tx_tail - 1].flags |= LWS_IO_URING_TXB_CLOSE;
+	}
+
+	lws_dll2_remove(&w->pending);
+
+	w->rx_tail = w->tx_head = w->tx_tail = 0;
+	w->tx_count = w->rx_eof = w->tx_err = w->rx_poll = 0;
+	w->registered = 0;
+	w->actual_events = w->poll_events = 0;
+
+	/*
+	 * Anything we queued that still names the fd number must reach the
+	 * kernel before the fd is closed, and maybe reused
+	 */
+	lws_uring_flush(ptpr);
+}
+
+static void
+lws_uring_tx_done(struct lws_context_per_thread *pt, int i, int res)
+{
+	struct lws_pt_eventlibs_io_uring *ptpr = pt_to_priv_uring(pt);
+	struct lws_io_uring_txb *t = &ptpr->txb[i];
+	struct lws_wsi_eventlibs_io_uring *w = NULL;
+	lws_sockfd_type fd = t->fd;
+	struct lws *wsi;
+	int next;
+
+	t->ud = 0;
+
+	/* if the wsi has gone, it's a dup we're draining for nobody */
+
+	wsi = fd < 0 ? NULL : wsi_from_fd(pt->context, fd);
+	if (wsi) {
+		w = wsi_to_priv_uring(wsi);
+		if (w->tx_head != i + 1)
+			w = NULL;
+	}
+
+	if (res >= 0) {
+		t->ofs += (uint32_t)res;
+		if (t->ofs < t->len) {
+			/* short send, or more was added behind it */
+			lws_uring_send(ptpr, i);
+			return;
+		}
+	}
+
+	do {
+		next = t->next;
+		if (res >= 0 && (t->flags & LWS_IO_URING_TXB_SHUT_WR))
+			shutdown(fd, SHUT_WR);
+		if ((t->flags & LWS_IO_URING_TXB_CLOSE) && fd >= 0)
+			close(fd);
+
+		t->next = ptpr->tx_free;
+		ptpr->tx_free = (int16_t)(i + 1);
+		if (w)
+			w->tx_count--;
+
+		/* after an error, the rest of the queue is dropped */
+		if (res >= 0 || !next)
+			break;
+
+		i = next - 1;
+		t = &ptpr->txb[i];
+	} while (1);
+
+	if (!w) {
+		if (next)
+			lws_uring_send(ptpr, next - 1);
+		return;
+	}
+
+	w->tx_head = (int16_t)next;
+	if (next) {
+		lws_uring_send(ptpr, next - 1);
+		return;
+	}
+
+	w->tx_tail = 0;
+
+	if (res < 0) {
+		lwsl_wsi_info(wsi, "send failed %d", res);
+		w->tx_err = 1;
+		if (!lws_uring_ready(ptpr, fd, POLLHUP))
+			lws_uring_update(ptpr, w);
+		return;
+	}
+
+	/* he can have POLLOUT now, or poll for it if we can't tell him */
+
+	if (!(w->actual_events & POLLOUT) ||
+	    !lws_uring_ready(ptpr, fd, POLLOUT))
+		lws_uring_update(ptpr, w);
+}
+
+static void
+lws_uring_rx_done(struct lws_context_per_thread *pt,
+		  struct io_uring_cqe *cqe)
+{
+	struct lws_pt_eventlibs_io_uring *ptpr = pt_to_priv_uring(pt);
+	lws_sockfd_type fd = lws_uring_ud_fd(cqe->user_data);
+	struct lws_wsi_eventlibs_io_uring *w = NULL;
+	int bid = -1, accept = lws_uring_ud_op(cqe->user_data) ==
+							LWS_URING_OP_ACCEPT;
+	struct lws *wsi;
+
+	wsi = wsi_from_fd(pt->context, fd);
+	if (wsi) {
+		w = wsi_to_priv_uring(wsi);
+		if (w->rx_armed != cqe->user_data)
+			w = NULL; /* stale: cancelled or previous fd user */
+	}
+
+	if (cqe->flags & IORING_CQE_F_BUFFER)
+		bid = (int)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+
+	if (!w) {
+		if (bid >= 0)
+			lws_uring_rxb_return(ptpr, bid);
+		if (accept && cqe->res >= 0)
+			close(cqe->res);
+		return;
+	}
+
+	if (!(cqe->flags & IORING_CQE_F_MORE))
+		w->rx_armed = 0; /* the multishot op has finished */
+
+	if (accept && cqe->res >= 0) {
+		if (ptpr->acc_count == LWS_IO_URING_ACCEPTS) {
+			lwsl_warn("%s: accept queue full\n", __func__);
+			close(cqe->res);
+		} else {
+			ptpr->acc[ptpr->acc_count].fd = cqe->res;
+			ptpr->acc[ptpr->acc_count++].listen_fd = fd;
+		}
+	}
+
+	if (!accept && cqe->res > 0 && bid >= 0) {
+		ptpr->rxb[bid].len = (uint32_t)cqe->res;
+		ptpr->rxb[bid].ofs = 0;
+		ptpr->rxb[bid].next = 0;
+		if (w->rx_tail)
+			ptpr->rxb[w->rx_tail - 1].next = (int16_t)(bid + 1);
+		else
+			w->rx_head = (int16_t)(bid + 1);
+		w->rx_tail = (int16_t)(bid + 1);
+		bid = -1;
+	}
+
+	if (bid >= 0)
+		lws_uring_rxb_return(ptpr, bid);
+
+	if (!accept && !cqe->res)
+		w->rx_eof = 1;
+
+	if (cqe->res < 0)
+		switch (-cqe->res) {
+		case EINVAL:
+			/* kernel can't do this multishot op */
+			if (accept)
+				ptpr->no_accept_multishot = 1;
+			else
+				ptpr->no_recv_multishot = 1;
+			break;
+		case ECANCELED:
+			break;
+		case ENOBUFS:
+			/* no provided buffer, recv() the usual way for now */
+			w->rx_poll = 1;
+			break;
+		default:
+			if (accept) {
+				lwsl_info("%s: accept: %d\n", __func__,
+					  cqe->res);
+				w->rx_poll = 1;
+				break;
+			}
+			w->rx_eof = 2;
+			break;
+		}
+
+	lws_uring_check_pending(ptpr, w);
+
+	if (cqe->res >= 0 || w->rx_eof)
+		lws_uring_ready(ptpr, fd, POLLIN);
+
+	if (!w->rx_armed)
+		/* don't lose POLLIN while the multishot op isn't there */
+		lws_uring_update(ptpr, w);
+}
+
+static int
+elops_foreign_thread_io_uring(struct lws_context *cx, int tsi)
+{
+	struct lws_context_per_thread *pt = &cx->pt[tsi];
+	volatile struct lws_context_per_thread *vpt =
+				(volatile struct lws_context_per_thread *)pt;
+
+	/* same probabilistic check as poll, we share the wait bookkeeping */
+
+	return vpt->inside_poll;
+}
+
+static void
+elops_destroy_pt_io_uring(struct lws_context *cx, int tsi)
+{
+	struct lws_pt_eventlibs_io_uring *ptpr = pt_to_priv_uring(&cx->pt[tsi]);
+	int n;
+
+	if (ptpr->ring_fd > 0)
+		close(ptpr->ring_fd);
+
+	while (ptpr->acc_count)
+		close(ptpr->acc[--ptpr->acc_count].fd);
+
+	if (ptpr->tx_pool)
+		for (n = 0; n < LWS_IO_URING_TX_BUFS; n++)
+			if ((ptpr->txb[n].flags & LWS_IO_URING_TXB_CLOSE) &&
+			    ptpr->txb[n].fd >= 0)
+				close(ptpr->txb[n].fd);
+
+	if (ptpr->sqes)
+		munmap(ptpr->sqes, ptpr->sqes_len);
+	if (ptpr->ring)
+		munmap(ptpr->ring, ptpr->ring_len);
+	if (ptpr->br)
+		munmap(ptpr->br, ptpr->br_len);
+	lws_free(ptpr->rx_pool);
+	lws_free(ptpr->tx_pool);
+
+	memset(ptpr, 0, sizeof(*ptpr));
+}
+
+/*
+ * The provided rx buffers are a ring registered with the kernel.  If that
+ * fails, eg, before 5.19, rx is just polled for as usual.
+ */
+
+static void
+lws_uring_init_buffers(struct lws_context *cx,
+		       struct lws_pt_eventlibs_io_uring *ptpr)
+{
+	struct io_uring_buf_reg reg;
+	int n;
+
+	ptpr->buf_size = cx->pt_serv_buf_size;
+
+	ptpr->tx_pool = lws_malloc(LWS_IO_URING_TX_BUFS * ptpr->buf_size,
+				   "uring tx");
+	if (ptpr->tx_pool) {
+		for (n = 0; n < LWS_IO_URING_TX_BUFS; n++) {
+			ptpr->txb[n].buf = ptpr->tx_pool +
+					   (size_t)n * ptpr->buf_size;
+			ptpr->txb[n].next = (int16_t)(n + 2);
+		}
+		ptpr->txb[LWS_IO_URING_TX_BUFS - 1].next = 0;
+		ptpr->tx_free = 1;
+	}
+
+	ptpr->rx_pool = lws_malloc(LWS_IO_URING_RX_BUFS * ptpr->buf_size,
+				   "uring rx");
+	if (!ptpr->rx_pool)
+		return;
+
+	ptpr->br_len = LWS_IO_URING_RX_BUFS * sizeof(struct io_uring_buf);
+	ptpr->br = mmap(NULL, ptpr->br_len, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ptpr->br == MAP_FAILED) {
+		ptpr->br = NULL;
+		goto bail;
+	}
+
+	memset(&reg, 0, sizeof(reg));
+	reg.ring_addr		= (uint64_t)(uintptr_t)ptpr->br;
+	reg.ring_entries	= LWS_IO_URING_RX_BUFS;
+	reg.bgid		= 0;
+
+	if (syscall(__NR_io_uring_register, ptpr->ring_fd,
+		    IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+		lwsl_cx_info(cx, "no provided buffer ring, errno %d", errno);
+		munmap(ptpr->br, ptpr->br_len);
+		ptpr->br = NULL;
+		goto bail;
+	}
+
+	for (n = 0; n < LWS_IO_URING_RX_BUFS; n++)
+		lws_uring_rxb_return(ptpr, n);
+
+	return;
+
+bail:
+	lws_free_set_NULL(ptpr->rx_pool);
+}
+
+static int
+elops_init_pt_io_uring(struct lws_context *cx, void *_loop, int tsi)
+{
+	struct lws_pt_eventlibs_io_uring *ptpr = pt_to_priv_uring(&cx->pt[tsi]);
+	struct io_uring_params p;
+	uint8_t *r;
+
+	memset(ptpr, 0, sizeof(*ptpr));
+	memset(&p, 0, sizeof(p));
+
+	ptpr->ring_fd = (int)syscall(__NR_io_uring_setup, LWS_IO_URING_ENTRIES,
+				     &p);
+	if (ptpr->ring_fd < 0) {
+		lwsl_cx_err(cx, "io_uring_setup failed, errno %d", errno);
+		ptpr->ring_fd = 0;
+
+		return 1;
+	}
+
+	if ((p.features & (IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP |
+			   IORING_FEAT_EXT_ARG)) !=
+	    (IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG)) {
+		lwsl_cx_err(cx, "kernel io_uring too old (features 0x%x)",
+			    p.features);
+		goto bail;
+	}
+
+	ptpr->ring_len = p.sq_off.array + p.sq_entries * sizeof(unsigned int);
+	if (ptpr->ring_len < p.cq_off.cqes +
+			     p.cq_entries * sizeof(struct io_uring_cqe))
+		ptpr->ring_len = p.cq_off.cqes +
+				 p.cq_entries * sizeof(struct io_uring_cqe);
+
+	ptpr->ring = mmap(NULL, ptpr->ring_len, PROT_READ | PROT_WRITE,
+			  MAP_SHARED | MAP_POPULATE, ptpr->ring_fd,
+			  IORING_OFF_SQ_RING);
+	if (ptpr->ring == MAP_FAILED) {
+		ptpr->ring = NULL;
+		goto bail;
+	}
+
+	ptpr->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+	ptpr->sqes = mmap(NULL, ptpr->sqes_len, PROT_READ | PROT_WRITE,
+			  MAP_SHARED | MAP_POPULATE, ptpr->ring_fd,
+			  IORING_OFF_SQES);
+	if (ptpr->sqes == MAP_FAILED) {
+		ptpr->sqes = NULL;
+		goto bail;
+	}
+
+	r = (uint8_t *)ptpr->ring;
+	ptpr->sq_head	= (unsigned int *)(r + p.sq_off.head);
+	ptpr->sq_tail	= (unsigned int *)(r + p.sq_off.tail);
+	ptpr->sq_mask	= (unsigned int *)(r + p.sq_off.ring_mask);
+	ptpr->sq_array	= (unsigned int *)(r + p.sq_off.array);
+	ptpr->cq_head	= (unsigned int *)(r + p.cq_off.head);
+	ptpr->cq_tail	= (unsigned int *)(r + p.cq_off.tail);
+	ptpr->cq_mask	= (unsigned int *)(r + p.cq_off.ring_mask);
+	ptpr->cqes	= (struct io_uring_cqe *)(r + p.cq_off.cqes);
+	ptpr->sq_entries = p.sq_entries;
+
+	lws_uring_init_buffers(cx, ptpr);
+
+	lwsl_cx_info(cx, "tsi %d: io_uring sq %u, cq %u, rx bufs %d, "
+			 "tx bufs %d of %u", tsi, p.sq_entries, p.cq_entries,
+			 ptpr->br ? LWS_IO_URING_RX_BUFS : 0,
+			 ptpr->tx_pool ? LWS_IO_URING_TX_BUFS : 0,
+			 cx->pt_serv_buf_size);
+
+	return 0;
+
+bail:
+	lwsl_cx_err(cx, "io_uring init failed, errno %d", errno);
+	elops_destroy_pt_io_uring(cx, tsi);
+
+	return 1;
+}
+
+static void
+elops_io_io_uring(struct lws *wsi, unsigned int flags)
+{
+	struct lws_context_per_thread *pt = &wsi->a.context->pt[(int)wsi->tsi];
+	struct lws_pt_eventlibs_io_uring *ptpr = pt_to_priv_uring(pt);
+	struct lws_wsi_eventlibs_io_uring *w = wsi_to_priv_uring(wsi);
+	uint32_t e = (uint32_t)(((flags & LWS_EV_WRITE) ? POLLOUT : 0) |
+				((flags & LWS_EV_READ) ? POLLIN : 0)), u;
+
+	if (!ptpr->sqes || !lws_socket_is_valid(wsi->desc.sockfd))
+		return;
+
+	assert((flags & (LWS_EV_START | LWS_EV_STOP)) &&
+	       (flags & (LWS_EV_READ | LWS_EV_WRITE)));
+
+	if ((flags & LWS_EV_STOP) &&
+	    (flags & (LWS_EV_READ | LWS_EV_WRITE)) ==
+					(LWS_EV_READ | LWS_EV_WRITE)) {
+		/* the fd is leaving pt->fds[], see the epoll io() op */
+		if (w->registered)
+			lws_uring_release(ptpr, w);
+
+		return;
+	}
+
+	if (w->registered && w->fd != wsi->desc.sockfd)
+		lws_uring_release(ptpr, w);
+
+	u = w->actual_events;
+	if (flags & LWS_EV_START)
+		u |= e;
+	if (flags & LWS_EV_STOP)
+		u &= ~e;
+
+	if (w->registered && u == w->actual_events)
+		return;
+
+	w->wsi = wsi;
+	w->fd = wsi->desc.sockfd;
+	w->actual_events = u;
+	w->registered = 1;
+
+	lws_uring_update(ptpr, w);
+	lws_uring_check_pending(ptpr, w);
+}
+
+static void
+elops_destroy_wsi_io_uring(struct lws *wsi)
+{
+	struct lws_context_per_thread *pt = &wsi->a.context->pt[(int)wsi->tsi];
+	struct lws_wsi_eventlibs_io_uring *w = wsi_to_priv_uring(wsi);
+
+	if (w->registered && pt_to_priv_uring(pt)->sqes)
+		lws_uring_release(pt_to_priv_uring(pt), w);
+}
+
+static void
+lws_uring_reap(struct lws_context_per_thread *pt)
+{
+	struct lws_pt_eventlibs_io_uring *ptpr = pt_to_priv_uring(pt);
+	unsigned int head = *ptpr->cq_head,
+		     tail = __atomic_load_n(ptpr->cq_tail, __ATOMIC_ACQUIRE);
+
+	/*
+	 * Everything a completion tells us is kept on the wsi, or in a poll we
+	 * rearm, so we can take all of them even if the ready list fills
+	 */
+
+	while (head != tail) {
+		struct io_uring_cqe *cqe = &ptpr->cqes[head & *ptpr->cq_mask];
+		struct lws_wsi_eventlibs_io_uring *w;
+		struct lws *wsi;
+		int i;
+
+		head++;
+
+		switch (lws_uring_ud_op(cqe->user_data)) {
+		case LWS_URING_OP_POLL:
+			wsi = wsi_from_fd(pt->context,
+					  lws_uring_ud_fd(cqe->user_data));
+			if (!wsi)
+				break;
+			w = wsi_to_priv_uring(wsi);
+			if (w->armed != cqe->user_data)
+				break; /* stale: cancelled or previous fd user */
+
+			/* the oneshot poll is used up, we rearm after service */
+			w->armed = 0;
+
+			if (!lws_uring_ready(ptpr, w->fd, cqe->res < 0 ?
+					(uint32_t)POLLERR : (uint32_t)cqe->res))
+				/* no room, it'll just fire again */
+				lws_uring_update(ptpr, w);
+			break;
+
+		case LWS_URING_OP_RECV:
+		case LWS_URING_OP_ACCEPT:
+			lws_uring_rx_done(pt, cqe);
+			break;
+
+		case LWS_URING_OP_SEND:
+			i = (int)(uint32_t)cqe->user_data;
+			if (i < LWS_IO_URING_TX_BUFS &&
+			    ptpr->txb[i].ud == cqe->user_data)
+				lws_uring_tx_done(pt, i, cqe->res);
+			break;
+		}
+	}
+
+	__atomic_store_n(ptpr->cq_head, head, __ATOMIC_RELEASE);
+}
+
+/* wsi with rx or accepts queued still need servicing while they want POLLIN */
+
+static void
+lws_uring_add_pending(struct lws_pt_eventlibs_io_uring *ptpr)
+{
+	lws_start_foreach_dll(struct lws_dll2 *, d,
+			      lws_dll2_get_head(&ptpr->pending)) {
+		struct lws_wsi_eventlibs_io_uring *w = lws_container_of(d,
+				struct lws_wsi_eventlibs_io_uring, pending);
+
+		if ((w->actual_events & POLLIN) &&
+		    !lws_uring_ready(ptpr, w->fd, POLLIN))
+			break;
+	} lws_end_foreach_dll(d);
+}
+
+int
+lws_io_uring_service_wait(struct lws_context_per_thread *pt, int timeout_ms)
+{
+	struct lws_pt_eventlibs_io_uring *ptpr = pt_to_priv_uring(pt);
+	struct io_uring_getevents_arg arg;
+	struct __kernel_timespec ts;
+	int n;
+
+	ptpr->count_ready = 0;
+
+	/* if there are already completions or pending rx, don't block */
+
+	lws_uring_reap(pt);
+	lws_uring_add_pending(ptpr);
+	if (ptpr->count_ready) {
+		lws_uring_flush(ptpr);
+
+		return ptpr->count_ready;
+	}
+
+	memset(&arg, 0, sizeof(arg));
+	ts.tv_sec = timeout_ms / 1000;
+	ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000ll;
+	arg.sigmask_sz = _NSIG / 8;
+	arg.ts = (uint64_t)(uintptr_t)&ts;
+
+	/* submit all the queued io and interest changes and wait, in one go */
+
+	n = lws_uring_enter(ptpr, ptpr->to_submit, timeout_ms ? 1 : 0,
+			    IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+			    &arg, sizeof(arg));
+	if (n < 0 && errno != ETIME && errno != EINTR && errno != EBUSY)
+		lwsl_cx_err(pt->context, "io_uring_enter: errno %d", errno);
+	lws_uring_submitted(ptpr);
+
+	lws_uring_reap(pt);
+	lws_uring_add_pending(ptpr);
+
+	return ptpr->count_ready;
+}
+
+int
+lws_io_uring_service_ready(struct lws_context *cx, int tsi)
+{
+	struct lws_context_per_thread *pt = &cx->pt[tsi];
+	struct lws_pt_eventlibs_io_uring *ptpr = pt_to_priv_uring(pt);
+	int n, count = ptpr->count_ready;
+
+	ptpr->count_ready = 0;
+
+	for (n = 0; n < count; n++) {
+		struct lws_wsi_eventlibs_io_uring *w;
+		struct lws_pollfd *pfd;
+		struct lws *wsi;
+
+		wsi = wsi_from_fd(cx, ptpr->ready[n].fd);
+		if (!wsi || wsi->position_in_fds_table == LWS_NO_FDS_POS)
+			continue;
+
+		pfd = &pt->fds[wsi->position_in_fds_table];
+		pfd->revents = (short)(pfd->revents |
+				((short)ptpr->ready[n].revents &
+				 (pfd->events | LWS_POLLHUP | POLLERR)));
+
+		if (pfd->revents &&
+		    lws_service_fd_tsi(cx, pfd, tsi) < 0) {
+			lwsl_cx_err(cx, "lws_service_fd_tsi failed");
+			return -1;
+		}
+
+		/* if he's still around and interested, rearm him */
+
+		wsi = wsi_from_fd(cx, ptpr->ready[n].fd);
+		if (!wsi)
+			continue;
+		w = wsi_to_priv_uring(wsi);
+		if (!w->registered)
+			continue;
+		w->rx_poll = 0;
+		lws_uring_update(ptpr, w);
+	}
+
+	return 0;
+}
+
+static struct lws_wsi_eventlibs_io_uring *
+lws_uring_wsi(struct lws *wsi)
+{
+	struct lws_wsi_eventlibs_io_uring *w;
+
+	if (wsi->a.context->event_loop_ops != &event_loop_ops_io_uring)
+		return NULL;
+
+	w = wsi_to_priv_uring(wsi);
+
+	return w->registered ? w : NULL;
+}
+
+int
+lws_io_uring_rx_owned(struct lws *wsi)
+{
+	struct lws_wsi_eventlibs_io_uring *w = lws_uring_wsi(wsi);
+
+	return w && (w->rx_armed || w->rx_head || w->rx_eof);
+}
+
+ssize_t
+lws_io_uring_recv(struct lws *wsi, uint8_t *buf, size_t len)
+{
+	struct lws_pt_eventlibs_io_uring *ptpr = pt_to_priv_uring(
+					&wsi->a.context->pt[(int)wsi->tsi]);
+	struct lws_wsi_eventlibs_io_uring *w = wsi_to_priv_uring(wsi);
+	size_t done = 0, n;
+
+	if (!w->rx_head) {
+		if (w->rx_eof == 1)
+			return 0;
+
+		errno = w->rx_eof ? ECONNRESET : EAGAIN;
+
+		return -1;
+	}
+
+	while (len && w->rx_head) {
+		int bid = w->rx_head - 1;
+		struct lws_io_uring_rxb *b = &ptpr->rxb[bid];
+
+		n = b->len - b->ofs;
+		if (n > len)
+			n = len;
+		memcpy(buf, ptpr->rx_pool + (size_t)bid * ptpr->buf_size +
+			    b->ofs, n);
+		b->ofs += (uint32_t)n;
+		buf += n;
+		len -= n;
+		done += n;
+
+		if (b->ofs == b->len) {
+			w->rx_head = b->next;
+			if (!w->rx_head)
+				w->rx_tail = 0;
+			lws_uring_rxb_return(ptpr, bid);
+		}
+	}
+
+	lws_uring_check_pending(ptpr, w);
+
+	return (ssize_t)done;
+}
+
+int
+lws_io_uring_tx_owned(struct lws *wsi)
+{
+	struct lws_wsi_eventlibs_io_uring *w = lws_uring_wsi(wsi);
+
+	return w && pt_to_priv_uring(&wsi->a.context->pt[(int)wsi->tsi])->
+								tx_pool &&
+	       lws_uring_io_capable(wsi);
+}
+
+int
+lws_io_uring_tx_busy(struct lws *wsi)
+{
+	struct lws_wsi_eventlibs_io_uring *w = lws_uring_wsi(wsi);
+
+	return w && w->tx_head;
+}
+
+ssize_t
+lws_io_uring_send(struct lws *wsi, const uint8_t *buf, size_t len)
+{
+	struct lws_pt_eventlibs_io_uring *ptpr = pt_to_priv_uring(
+					&wsi->a.context->pt[(int)wsi->tsi]);
+	struct lws_wsi_eventlibs_io_uring *w = wsi_to_priv_uring(wsi);
+	struct lws_io_uring_txb *t;
+	size_t done = 0, n;
+	int i;
+
+	if (w->tx_err) {
+		errno = EPIPE;
+		return -1;
+	}
+
+	while (len) {
+		if (w->tx_tail) {
+			/*
+			 * Fill up the last buffer, even if it's being sent;
+			 * the send completing short of t->len sends the rest
+			 */
+			t = &ptpr->txb[w->tx_tail - 1];
+			n = ptpr->buf_size - t->len;
+			if (n) {
+				if (n > len)
+					n = len;
+				memcpy(t->buf + t->len, buf, n);
+				t->len += (uint32_t)n;
+				buf += n;
+				len -= n;
+				done += n;
+				continue;
+			}
+		}
+
+		if (w->tx_count == LWS_IO_URING_TX_PER_WSI || !ptpr->tx_free)
+			break;
+
+		i = ptpr->tx_free - 1;
+		t = &ptpr->txb[i];
+		ptpr->tx_free = t->next;
+
+		t->fd = w->fd;
+		t->len = t->ofs = 0;
+		t->next = 0;
+		t->flags = 0;
+		t->ud = 0;
+
+		if (w->tx_tail)
+			ptpr->txb[w->tx_tail - 1].next = (int16_t)(i + 1);
+		else
+			w->tx_head = (int16_t)(i + 1);
+		w->tx_tail = (int16_t)(i + 1);
+		w->tx_count++;
+	}
+
+	if (w->tx_head && !ptpr->txb[w->tx_head - 1].ud &&
+	    ptpr->txb[w->tx_head - 1].len) {
+		lws_uring_send(ptpr, w->tx_head - 1);
+		/* the end of the tx queue will tell him about POLLOUT */
+		lws_uring_update(ptpr, w);
+	}
+
+	if (!done) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	return (ssize_t)done;
+}
+
+int
+lws_io_uring_shutdown(struct lws *wsi)
+{
+	struct lws_wsi_eventlibs_io_uring *w = lws_uring_wsi(wsi);
+
+	if (!w || !w->tx_head)
+		return 0;
+
+	/* do it after the queued tx went out */
+
+	pt_to_priv_uring(&wsi->a.context->pt[(int)wsi->tsi])->
+			txb[w->tx_tail - 1].flags |= LWS_IO_URING_TXB_SHUT_WR;
+
+	return 1;
+}
+
+lws_sockfd_type
+lws_io_uring_accept(struct lws *wsi, struct sockaddr *sa, socklen_t *salen)
+{
+	struct lws_pt_eventlibs_io_uring *ptpr = pt_to_priv_uring(
+					&wsi->a.context->pt[(int)wsi->tsi]);
+	struct lws_wsi_eventlibs_io_uring *w = wsi_to_priv_uring(wsi);
+	lws_sockfd_type fd;
+	int n = lws_uring_acc_find(ptpr, wsi->desc.sockfd);
+
+	if (n < 0) {
+		if (!w->rx_armed)
+			/* we're polling for it */
+			return accept(wsi->desc.sockfd, sa, salen);
+
+		errno = EAGAIN;
+
+		return LWS_SOCK_INVALID;
+	}
+
+	fd = ptpr->acc[n].fd;
+	lws_uring_acc_remove(ptpr, n);
+	if (w->registered)
+		lws_uring_check_pending(ptpr, w);
+
+	/* multishot accept doesn't give us the peer address */
+
+	if (getpeername(fd, sa, salen))
+		*salen = 0;
+
+	return fd;
+}
+
+int
+lws_io_uring_accept_pending(struct lws *wsi)
+{
+	struct lws_context_per_thread *pt = &wsi->a.context->pt[(int)wsi->tsi];
+	struct lws_wsi_eventlibs_io_uring *w = wsi_to_priv_uring(wsi);
+
+	if (lws_uring_acc_find(pt_to_priv_uring(pt), wsi->desc.sockfd) >= 0)
+		return 1;
+
+	if (w->rx_armed)
+		return 0;
+
+	return lws_poll_listen_fd(&pt->fds[wsi->position_in_fds_table]) > 0;
+}
+
+struct lws_event_loop_ops event_loop_ops_io_uring = {
+	.name				= "io_uring",
+
+	.init_pt			= elops_init_pt_io_uring,
+	.io				= elops_io_io_uring,
+	.destroy_pt			= elops_destroy_pt_io_uring,
+	.destroy_wsi			= elops_destroy_wsi_io_uring,
+	.foreign_thread			= elops_foreign_thread_io_uring,
+
+	.flags				= LELOF_ISPOLL,
+
+	.evlib_size_pt			= sizeof(struct lws_pt_eventlibs_io_uring),
+	.evlib_size_wsi			= sizeof(struct lws_wsi_eventlibs_io_uring),
+};
+
+const lws_plugin_evlib_t evlib_io_uring = {
+	.hdr = {
+		"io_uring",
+		"lws_evlib_plugin",
+		"n/a",
+		LWS_PLUGIN_API_MAGIC
+	},
+
+	.ops	= &event_loop_ops_io_uring
+};
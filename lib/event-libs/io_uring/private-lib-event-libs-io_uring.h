@@ -0,0 +1,141 @@
+/*
+ * libwebsockets - small server side websockets and web server implementation
+ *
+ * Copyright (C) 2010 - 2021 Andy Green <andy@warmcat.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <linux/io_uring.h>
+
+/* submission queue depth, if it fills we flush early */
+#define LWS_IO_URING_ENTRIES		256
+/* max completions we collect for servicing per wait */
+#define LWS_IO_URING_MAX_READY		64
+/*
+ * Provided rx buffers and tx buffers per pt, each pt_serv_buf_size.  The rx
+ * count must be a power of two, since they're a registered buffer ring.
+ */
+#define LWS_IO_URING_RX_BUFS		256
+#define LWS_IO_URING_TX_BUFS		256
+/* tx buffers one wsi may have queued before its writes see EAGAIN */
+#define LWS_IO_URING_TX_PER_WSI		4
+/* accepted fds waiting for their listen wsi to be serviced, per pt */
+#define LWS_IO_URING_ACCEPTS		64
+
+struct lws_io_uring_ready {
+	lws_sockfd_type				fd;
+	uint32_t				revents;
+};
+
+/*
+ * A provided rx buffer the kernel filled, queued on its wsi until lws reads
+ * it.  The buffer id is the index.  Buffer links here and in the wsi are the
+ * index + 1, so 0 means none.
+ */
+
+struct lws_io_uring_rxb {
+	uint32_t				len;
+	uint32_t				ofs;
+	int16_t					next;
+};
+
+/*
+ * A tx buffer on a wsi's send queue, or on the free list.  Only the head of
+ * each queue has a send in flight, later writes are appended to the tail
+ * buffer while it has room, so small writes go out together.
+ */
+
+struct lws_io_uring_txb {
+	uint8_t					*buf;
+	uint64_t				ud; /* send in flight, or 0 */
+	lws_sockfd_type				fd;
+	uint32_t				len;
+	uint32_t				ofs;
+	int16_t					next;
+	uint8_t					flags;
+};
+
+#define LWS_IO_URING_TXB_SHUT_WR		(1 << 0)
+#define LWS_IO_URING_TXB_CLOSE		(1 << 1)
+
+struct lws_io_uring_accepted {
+	lws_sockfd_type				fd;
+	lws_sockfd_type				listen_fd;
+};
+
+struct lws_pt_eventlibs_io_uring {
+	struct lws_io_uring_ready		ready[LWS_IO_URING_MAX_READY];
+	struct lws_io_uring_rxb			rxb[LWS_IO_URING_RX_BUFS];
+	struct lws_io_uring_txb			txb[LWS_IO_URING_TX_BUFS];
+	struct lws_io_uring_accepted		acc[LWS_IO_URING_ACCEPTS];
+
+	lws_dll2_owner_t			pending; /* queued rx / accepts */
+
+	void					*ring;
+	size_t					ring_len;
+	struct io_uring_sqe			*sqes;
+	size_t					sqes_len;
+
+	struct io_uring_buf_ring		*br;	/* NULL: no rx offload */
+	size_t					br_len;
+	uint8_t					*rx_pool;
+	uint8_t					*tx_pool;
+	size_t					buf_size;
+
+	unsigned int				*sq_head;
+	unsigned int				*sq_tail;
+	unsigned int				*sq_mask;
+	unsigned int				*sq_array;
+	unsigned int				*cq_head;
+	unsigned int				*cq_tail;
+	unsigned int				*cq_mask;
+	struct io_uring_cqe			*cqes;
+
+	unsigned int				sq_entries;
+	unsigned int				to_submit;
+	uint32_t				gen;
+
+	int					ring_fd;
+	int					count_ready;
+	int					acc_count;
+	int16_t					tx_free;
+
+	uint8_t					no_recv_multishot;
+	uint8_t					no_accept_multishot;
+};
+
+struct lws_wsi_eventlibs_io_uring {
+	lws_dll2_t				pending; /* on pt pending */
+	struct lws				*wsi;
+	uint64_t				armed; /* poll user_data in flight */
+	uint64_t				rx_armed; /* recv or accept */
+	lws_sockfd_type				fd;
+	uint32_t				actual_events;
+	uint32_t				poll_events;
+	int16_t					rx_head;
+	int16_t					rx_tail;
+	int16_t					tx_head;
+	int16_t					tx_tail;
+	uint8_t					tx_count;
+	uint8_t					registered;
+	uint8_t					rx_eof;
+	uint8_t					tx_err;
+	uint8_t					rx_poll; /* until serviced */
+};
@@ -24,4 +24,46 @@
  *  This is included from private-lib-core.h
  */
 
+#if defined(LWS_WITH_EPOLL)
+/*
+ * epoll is built into the lib like poll, and the unix wait calls into it
+ * directly instead of poll() when it was selected at context creation
+ */
+struct lws_context_per_thread;
+extern struct lws_event_loop_ops event_loop_ops_epoll;
+
+int
+lws_epoll_service_wait(struct lws_context_per_thread *pt, int timeout_ms);
+int
+lws_epoll_service_ready(struct lws_context *cx, int tsi);
+#endif
+
+#if defined(LWS_WITH_IO_URING)
+struct lws_context_per_thread;
+extern struct lws_event_loop_ops event_loop_ops_io_uring;
+
+int
+lws_io_uring_service_wait(struct lws_context_per_thread *pt, int timeout_ms);
+int
+lws_io_uring_service_ready(struct lws_context *cx, int tsi);
+
+/* plain tcp server connections do their socket io as completions */
+int
+lws_io_uring_rx_owned(struct lws *wsi);
+ssize_t
+lws_io_uring_recv(struct lws *wsi, uint8_t *buf, size_t len);
+int
+lws_io_uring_tx_owned(struct lws *wsi);
+int
+lws_io_uring_tx_busy(struct lws *wsi);
+ssize_t
+lws_io_uring_send(struct lws *wsi, const uint8_t *buf, size_t len);
+int
+lws_io_uring_shutdown(struct lws *wsi);
+lws_sockfd_type
+lws_io_uring_accept(struct lws *wsi, struct sockaddr *sa, socklen_t *salen);
+int
+lws_io_uring_accept_pending(struct lws *wsi);
+#endif
+
 
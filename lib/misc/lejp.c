@@ -87,6 +87,7 @@ lejp_construct(struct lejp_ctx *ctx,
 	ctx->pst_sp = 0;
 	ctx->pst[0].callback = callback;
 	ctx->pst[0].paths = paths;
+	ctx->pst[0].pt = NULL;
 	ctx->pst[0].count_paths = count_paths;
 	ctx->pst[0].user = NULL;
 	ctx->pst[0].ppos = 0;
@@ -144,6 +145,230 @@ lejp_change_callback(struct lejp_ctx *ctx,
 	ctx->pst[0].callback(ctx, LEJPCB_START);
 }
 
+/*
+ * A compiled path table is a trie of the path chars, with one node per char.
+ * A '*' in a path has its own edge out of the node for the char before it,
+ * since it doesn't match a fixed char.
+ *
+ * Node 0 is the root, so 0 also means "none" for the links.
+ */
+
+typedef struct lejp_pt_node {
+	uint16_t		child;	/* first literal child */
+	uint16_t		sibling; /* next literal child of our parent */
+	uint16_t		star;	/* child for a '*' */
+	uint8_t			term;	/* 1 + index of first path ending here */
+	uint8_t			min;	/* 1 + lowest path index through here */
+	char			c;
+} lejp_pt_node_t;
+
+struct lejp_path_table {
+	const char * const	*paths;
+	lejp_pt_node_t		*node;	/* follows us in the same allocation */
+	uint16_t		count_nodes;
+	uint8_t			count_paths;
+};
+
+struct lejp_pt_walk {
+	const lejp_pt_node_t	*node;
+	const char		*path;
+	uint16_t		cur[LEJP_MAX_INDEX_DEPTH];
+	uint16_t		wild[LEJP_MAX_INDEX_DEPTH];
+	unsigned int		best;
+	unsigned int		wildcount;
+};
+
+static const char *
+lejp_path(const char * const *paths, size_t stride, unsigned int n)
+{
+	return *((const char **)(((const char *)paths) + (n * stride)));
+}
+
+struct lejp_path_table *
+lejp_path_table_create(const char * const *paths, unsigned char count_paths,
+		       size_t stride)
+{
+	size_t s = stride ? stride : sizeof(char *), nodes = 1;
+	struct lejp_path_table *pt, *pt1;
+	unsigned int n, ni, ci;
+	lejp_pt_node_t *node;
+	const char *p;
+
+	/* worst case, every char of every path needs its own node */
+
+	for (n = 0; n < count_paths; n++)
+		nodes += strlen(lejp_path(paths, s, n));
+
+	if (nodes > 0xffff)
+		return NULL;
+
+	pt = lws_zalloc(sizeof(*pt) + (nodes * sizeof(*node)), __func__);
+	if (!pt)
+		return NULL;
+
+	node = (lejp_pt_node_t *)&pt[1];
+	pt->paths = paths;
+	pt->count_paths = count_paths;
+	pt->count_nodes = 1;
+
+	for (n = 0; n < count_paths; n++) {
+		ni = 0;
+		if (!node[0].min)
+			node[0].min = (uint8_t)(n + 1);
+
+		for (p = lejp_path(paths, s, n); *p; p++) {
+			if (*p == '*') {
+				ci = node[ni].star;
+				if (!ci) {
+					ci = pt->count_nodes++;
+					node[ni].star = (uint16_t)ci;
+					node[ci].c = '*';
+				}
+			} else {
+				ci = node[ni].child;
+				while (ci && node[ci].c != *p)
+					ci = node[ci].sibling;
+				if (!ci) {
+					ci = pt->count_nodes++;
+					node[ci].c = *p;
+					node[ci].sibling = node[ni].child;
+					node[ni].child = (uint16_t)ci;
+				}
+			}
+
+			/* paths are added in order, the first one is lowest */
+			if (!node[ci].min)
+				node[ci].min = (uint8_t)(n + 1);
+			ni = ci;
+		}
+
+		if (!node[ni].term)
+			node[ni].term = (uint8_t)(n + 1);
+	}
+
+	/* paths sharing prefixes mean we usually need far fewer nodes */
+
+	pt1 = lws_realloc(pt, sizeof(*pt) + (pt->count_nodes * sizeof(*node)),
+			  __func__);
+	if (pt1)
+		pt = pt1;
+	pt->node = (lejp_pt_node_t *)&pt[1];
+
+	return pt;
+}
+
+void
+lejp_path_table_destroy(struct lejp_path_table **pt)
+{
+	lws_free_set_NULL(*pt);
+}
+
+void
+lejp_set_path_table(struct lejp_ctx *ctx, const struct lejp_path_table *pt)
+{
+	struct _lejp_parsing_stack *p = &ctx->pst[ctx->pst_sp];
+
+	p->pt = pt;
+	if (!pt)
+		return;
+
+	p->paths = pt->paths;
+	p->count_paths = pt->count_paths;
+}
+
+static void
+lejp_pt_found(struct lejp_pt_walk *w, unsigned int idx, unsigned int wc)
+{
+	w->best = idx;
+	w->wildcount = wc;
+	memcpy(w->wild, w->cur, wc * sizeof(w->cur[0]));
+}
+
+/*
+ * This finds the same path the linear compare would, ie, the first one in
+ * the table that matches.  A '*' followed by more path eats up to the next
+ * '.' or '[', and a trailing '*' eats everything, so where a '*' edge and a
+ * literal edge both leave a node, both might lead to a match and we have to
+ * look down both.  We skip anything that can only lead to a path later in
+ * the table than one we already found.
+ */
+
+static void
+lejp_pt_walk(struct lejp_pt_walk *w, unsigned int ni, const char *p,
+	     unsigned int wc)
+{
+	const lejp_pt_node_t *n, *s;
+	const char *q;
+	unsigned int ci;
+
+	while (1) {
+		n = &w->node[ni];
+		if (n->min >= w->best)
+			return;
+
+		if (!*p) {
+			if (n->term && n->term < w->best)
+				lejp_pt_found(w, n->term, wc);
+
+			return;
+		}
+
+		if (n->star && wc < LWS_ARRAY_SIZE(w->cur)) {
+			s = &w->node[n->star];
+			w->cur[wc] = (uint16_t)lws_ptr_diff_size_t(p, w->path);
+
+			if (s->term && s->term < w->best)
+				lejp_pt_found(w, s->term, wc + 1);
+
+			if (s->child || s->star) {
+				q = p;
+				while (*q && *q != '.' && *q != '[')
+					q++;
+				lejp_pt_walk(w, n->star, q, wc + 1);
+			}
+		}
+
+		ci = n->child;
+		while (ci && w->node[ci].c != *p)
+			ci = w->node[ci].sibling;
+		if (!ci)
+			return;
+
+		ni = ci;
+		p++;
+	}
+}
+
+static void
+lejp_check_path_match_compiled(struct lejp_ctx *ctx)
+{
+	const struct lejp_path_table *pt = ctx->pst[ctx->pst_sp].pt;
+	struct lejp_pt_walk w;
+
+	w.node = pt->node;
+	w.path = ctx->path;
+	w.best = 0x100;
+	w.wildcount = 0;
+
+	lejp_pt_walk(&w, 0, ctx->path, 0);
+
+	if (w.best == 0x100) {
+		/*
+		 * Like the linear compare, we leave any existing match
+		 * alone, but we also leave its wildcards
+		 */
+		if (!ctx->path_match)
+			ctx->wildcount = 0;
+
+		return;
+	}
+
+	memcpy(ctx->wild, w.wild, w.wildcount * sizeof(w.wild[0]));
+	ctx->wildcount = (uint8_t)w.wildcount;
+	ctx->path_match = (uint8_t)w.best;
+	ctx->path_match_len = ctx->pst[ctx->pst_sp].ppos;
+}
+
 void
 lejp_check_path_match(struct lejp_ctx *ctx)
 {
@@ -151,6 +376,11 @@ lejp_check_path_match(struct lejp_ctx *ctx)
 	int n;
 	size_t s = sizeof(char *);
 
+	if (ctx->pst[ctx->pst_sp].pt) {
+		lejp_check_path_match_compiled(ctx);
+		return;
+	}
+
 	if (ctx->path_stride)
 		s = ctx->path_stride;
 
@@ -907,6 +1137,7 @@ lejp_parser_push(struct lejp_ctx *ctx, void *user, const char * const *paths,
 	p->user = user;
 	p->callback = lejp_cb;
 	p->paths = paths;
+	p->pt = NULL;
 	p->count_paths = paths_count;
 	p->ppos = 0;
 
@@ -40,9 +40,25 @@
 #include <stdio.h>
 
 struct lws_threadpool;
+struct lws_pool;
+
+/*
+ * Each worker has its own queue of waiting tasks and its own list of done
+ * tasks, protected by its own qlock, so producers on different pts and the
+ * workers mostly don't contend.  task->where says which of the lists of
+ * task->pool the task is on, or that it's running on that worker; both only
+ * change with task->pool's qlock held.
+ */
+
+enum lws_tp_where {
+	LWS_TPW_QUEUED,
+	LWS_TPW_RUNNING,
+	LWS_TPW_DONE,
+};
 
 struct lws_threadpool_task {
-	struct lws_threadpool_task	*task_queue_next;
+	lws_dll2_t			qlist; /* on pool's queue or done list */
+	struct lws_pool			*pool;
 
 	struct lws_threadpool		*tp;
 	char				name[32];
@@ -63,7 +79,9 @@ struct lws_threadpool_task {
 	enum lws_threadpool_task_status status;
 
 	int				late_sync_retries;
+	int				tsi; /* of the wsi, to notify its pt */
 
+	uint8_t				where; /* enum lws_tp_where */
 	char				wanted_writeable_cb;
 	char				outlive;
 };
@@ -72,31 +90,31 @@ struct lws_pool {
 	struct lws_threadpool		*tp;
 	pthread_t			thread;
 	pthread_mutex_t			lock; /* part of task wake_idle */
+	pthread_mutex_t			qlock; /* protects the lists, task, idle */
+	pthread_cond_t			wake_idle;
+	lws_dll2_owner_t		queue; /* waiting tasks, oldest at head */
+	lws_dll2_owner_t		done; /* tasks waiting to be reaped */
 	struct lws_threadpool_task	*task;
 	lws_usec_t			acquired;
 	int				worker_index;
+	volatile char			idle; /* waiting on wake_idle */
 };
 
 struct lws_threadpool {
-	pthread_mutex_t			lock; /* protects all pool lists */
-	pthread_cond_t			wake_idle;
 	struct lws_pool			*pool_list;
 
 	struct lws_context		*context;
 	struct lws_threadpool		*tp_list; /* context list of threadpools */
 
-	struct lws_threadpool_task	*task_queue_head;
-	struct lws_threadpool_task	*task_done_head;
-
 	char				name[32];
 
 	int				threads_in_pool;
-	int				queue_depth;
-	int				done_queue_depth;
 	int				max_queue_depth;
-	int				running_tasks;
+	int				cpu_affinity;
+
+	unsigned int			rr; /* next worker to offer tasks to */
 
-	unsigned int			destroying:1;
+	volatile char			destroying;
 };
 
 static int
@@ -173,63 +191,40 @@ lws_threadpool_dump(struct lws_threadpool *tp)
 {
 #if 0
 	//defined(_DEBUG)
-	struct lws_threadpool_task **c;
 	char buf[160];
-	int n, count;
-
-	pthread_mutex_lock(&tp->lock); /* ======================== tpool lock */
-
-	lwsl_thread("%s: tp: %s, Queued: %d, Run: %d, Done: %d\n", __func__,
-		    tp->name, tp->queue_depth, tp->running_tasks,
-		    tp->done_queue_depth);
-
-	count = 0;
-	c = &tp->task_queue_head;
-	while (*c) {
-		struct lws_threadpool_task *task = *c;
-		__lws_threadpool_task_dump(task, buf, sizeof(buf));
-		lwsl_thread("  - %s\n", buf);
-		count++;
-
-		c = &(*c)->task_queue_next;
-	}
-
-	if (count != tp->queue_depth)
-		lwsl_err("%s: tp says queue depth %d, but actually %d\n",
-			 __func__, tp->queue_depth, count);
+	int n;
 
-	count = 0;
 	for (n = 0; n < tp->threads_in_pool; n++) {
 		struct lws_pool *pool = &tp->pool_list[n];
-		struct lws_threadpool_task *task = pool->task;
 
-		if (task) {
-			__lws_threadpool_task_dump(task, buf, sizeof(buf));
-			lwsl_thread("  - worker %d: %s\n", n, buf);
-			count++;
-		}
-	}
+		pthread_mutex_lock(&pool->qlock); /* ============= pool qlock */
 
-	if (count != tp->running_tasks)
-		lwsl_err("%s: tp says %d running_tasks, but actually %d\n",
-			 __func__, tp->running_tasks, count);
+		lwsl_thread("%s: tp: %s, worker %d: Queued: %d, Run: %d, "
+			    "Done: %d\n", __func__, tp->name, n,
+			    (int)pool->queue.count, !!pool->task,
+			    (int)pool->done.count);
 
-	count = 0;
-	c = &tp->task_done_head;
-	while (*c) {
-		struct lws_threadpool_task *task = *c;
-		__lws_threadpool_task_dump(task, buf, sizeof(buf));
-		lwsl_thread("  - %s\n", buf);
-		count++;
+		lws_start_foreach_dll(struct lws_dll2 *, d, pool->queue.head) {
+			__lws_threadpool_task_dump(lws_container_of(d,
+				struct lws_threadpool_task, qlist), buf,
+				sizeof(buf));
+			lwsl_thread("  - %s\n", buf);
+		} lws_end_foreach_dll(d);
 
-		c = &(*c)->task_queue_next;
-	}
+		if (pool->task) {
+			__lws_threadpool_task_dump(pool->task, buf, sizeof(buf));
+			lwsl_thread("  - running: %s\n", buf);
+		}
 
-	if (count != tp->done_queue_depth)
-		lwsl_err("%s: tp says done_queue_depth %d, but actually %d\n",
-			 __func__, tp->done_queue_depth, count);
+		lws_start_foreach_dll(struct lws_dll2 *, d, pool->done.head) {
+			__lws_threadpool_task_dump(lws_container_of(d,
+				struct lws_threadpool_task, qlist), buf,
+				sizeof(buf));
+			lwsl_thread("  - %s\n", buf);
+		} lws_end_foreach_dll(d);
 
-	pthread_mutex_unlock(&tp->lock); /* --------------- tp unlock */
+		pthread_mutex_unlock(&pool->qlock); /* --------- pool unqlock */
+	}
 #endif
 }
 
@@ -262,49 +257,103 @@ lws_threadpool_task_cleanup_destroy(struct lws_threadpool_task *task)
 	lwsl_thread("%s: tp %p: cleaned finished task for %s\n",
 		    __func__, task->tp, lws_wsi_tag(task_to_wsi(task)));
 
+	pthread_cond_destroy(&task->wake_idle);
 	lws_free(task);
 }
 
+/*
+ * Return with the qlock held of the worker the task currently belongs to.
+ * Queued tasks may be stolen by another worker while we wait for the lock,
+ * in which case we have to try again on the new owner.
+ */
+
+static struct lws_pool *
+lws_threadpool_task_lock(struct lws_threadpool_task *task)
+{
+	struct lws_pool *pool;
+
+	while (1) {
+		pool = task->pool;
+		pthread_mutex_lock(&pool->qlock); /* ============== pool qlock */
+		if (pool == task->pool)
+			return pool;
+		pthread_mutex_unlock(&pool->qlock); /* ---------- pool unqlock */
+	}
+}
+
+/*
+ * Ask the service thread of the pt the task's wsi is bound to, and only that
+ * one, to come and take a look at the task.
+ */
+
 static void
-__lws_threadpool_reap(struct lws_threadpool_task *task)
+lws_threadpool_notify(struct lws_threadpool *tp, int tsi)
 {
-	struct lws_threadpool_task **c, *t = NULL;
-	struct lws_threadpool *tp = task->tp;
+	struct lws_context *cx = tp->context;
 
-	/* remove the task from the done queue */
+	if (cx->service_no_longer_possible || !cx->pt[tsi].pipe_wsi)
+		return;
 
-	if (tp) {
-		c = &tp->task_done_head;
+	lws_plat_pipe_signal(cx, tsi);
+}
 
-		while (*c) {
-			if ((*c) == task) {
-				t = *c;
-				*c = t->task_queue_next;
-				t->task_queue_next = NULL;
-				tp->done_queue_depth--;
+static void
+lws_threadpool_want_cow(struct lws_threadpool_task *task, int tsi,
+			struct lws **wsis, int *count)
+{
+	struct lws *wsi = task_to_wsi(task);
 
-				lwsl_thread("%s: tp %s: reaped task %s\n", __func__,
-					   tp->name, lws_wsi_tag(task_to_wsi(task)));
+	if (!wsi || wsi->tsi != tsi ||
+	    (!task->wanted_writeable_cb &&
+	     task->status != LWS_TP_STATUS_SYNCING))
+		return;
+
+	task->wanted_writeable_cb = 0;
+	wsis[(*count)++] = wsi;
+}
 
+static void
+lws_threadpool_tsi_pool(struct lws_pool *pool, int tsi)
+{
+	struct lws *wsis[16];
+	int n, count;
+
+	/*
+	 * Collect a batch of wsis under the qlock, but ask for the callbacks
+	 * after dropping it, so the worker isn't held up by the pt lock
+	 */
+
+	do {
+		count = 0;
+
+		pthread_mutex_lock(&pool->qlock); /* ============== pool qlock */
+
+		/* for the running (syncing...) task... */
+
+		if (pool->task)
+			lws_threadpool_want_cow(pool->task, tsi, wsis, &count);
+
+		/* for the done tasks... */
+
+		lws_start_foreach_dll(struct lws_dll2 *, d, pool->done.head) {
+			if (count == (int)LWS_ARRAY_SIZE(wsis))
 				break;
-			}
-			c = &(*c)->task_queue_next;
-		}
+			lws_threadpool_want_cow(lws_container_of(d,
+					struct lws_threadpool_task, qlist),
+					tsi, wsis, &count);
+		} lws_end_foreach_dll(d);
 
-		if (!t) {
-			lwsl_err("%s: task %p not in done queue\n", __func__, task);
-			/*
-			 * This shouldn't occur, but in this case not really
-			 * safe to assume there's a task to destroy
-			 */
-			return;
-		}
-	} else
-		lwsl_err("%s: task->tp NULL already\n", __func__);
+		pthread_mutex_unlock(&pool->qlock); /* ---------- pool unqlock */
+
+		/*
+		 * finally... we can ask for the callback on writable from the
+		 * correct service thread context
+		 */
 
-	/* call the task's cleanup and delete the task itself */
+		for (n = 0; n < count; n++)
+			lws_callback_on_writable(wsis[n]);
 
-	lws_threadpool_task_cleanup_destroy(task);
+	} while (count == (int)LWS_ARRAY_SIZE(wsis));
 }
 
 /*
@@ -316,69 +365,15 @@ __lws_threadpool_reap(struct lws_threadpool_task *task)
 int
 lws_threadpool_tsi_context(struct lws_context *context, int tsi)
 {
-	struct lws_threadpool_task **c, *task = NULL;
 	struct lws_threadpool *tp;
-	struct lws *wsi;
+	int n;
 
 	lws_context_lock(context, __func__);
 
 	tp = context->tp_list_head;
 	while (tp) {
-		int n;
-
-		/* for the running (syncing...) tasks... */
-
-		for (n = 0; n < tp->threads_in_pool; n++) {
-			struct lws_pool *pool = &tp->pool_list[n];
-
-			task = pool->task;
-			if (!task)
-				continue;
-
-			wsi = task_to_wsi(task);
-			if (!wsi || wsi->tsi != tsi ||
-			    (!task->wanted_writeable_cb &&
-			     task->status != LWS_TP_STATUS_SYNCING))
-				continue;
-
-			task->wanted_writeable_cb = 0;
-			lws_memory_barrier();
-
-			/*
-			 * finally... we can ask for the callback on
-			 * writable from the correct service thread
-			 * context
-			 */
-
-			lws_callback_on_writable(wsi);
-		}
-
-		/* for the done tasks... */
-
-		c = &tp->task_done_head;
-
-		while (*c) {
-			task = *c;
-			wsi = task_to_wsi(task);
-
-			if (wsi && wsi->tsi == tsi &&
-			    (task->wanted_writeable_cb ||
-			     task->status == LWS_TP_STATUS_SYNCING)) {
-
-				task->wanted_writeable_cb = 0;
-				lws_memory_barrier();
-
-				/*
-				 * finally... we can ask for the callback on
-				 * writable from the correct service thread
-				 * context
-				 */
-
-				lws_callback_on_writable(wsi);
-			}
-
-			c = &task->task_queue_next;
-		}
+		for (n = 0; n < tp->threads_in_pool; n++)
+			lws_threadpool_tsi_pool(&tp->pool_list[n], tsi);
 
 		tp = tp->tp_list;
 	}
@@ -388,7 +383,7 @@ lws_threadpool_tsi_context(struct lws_context *context, int tsi)
 	return 0;
 }
 
-static int
+static void
 lws_threadpool_worker_sync(struct lws_pool *pool,
 			   struct lws_threadpool_task *task)
 {
@@ -440,10 +435,10 @@ lws_threadpool_worker_sync(struct lws_pool *pool,
 
 		/*
 		 * This will cause lws_threadpool_tsi_context() to get called
-		 * from each tsi service context, where we can safely ask for
-		 * a callback on writeable on the wsi we are associated with.
+		 * from the tsi service context of the wsi, where we can safely
+		 * ask for a callback on writeable on it.
 		 */
-		lws_cancel_service(lws_get_context(wsi));
+		lws_threadpool_notify(pool->tp, task->tsi);
 
 		/*
 		 * so the danger here is that we asked for a writable callback
@@ -462,9 +457,13 @@ lws_threadpool_worker_sync(struct lws_pool *pool,
 					 __func__, pool->tp->name, task,
 					 task->name, lws_wsi_tag(task_to_wsi(task)));
 
-				pthread_mutex_unlock(&pool->lock); /* ----------------- - pool unlock */
-				lws_threadpool_dequeue_task(task);
-				return 1; /* destroyed task */
+				/*
+				 * The task is ours until we put it on the done
+				 * list, so stop it from here rather than
+				 * dequeueing it out from under ourselves
+				 */
+				state_transition(task, LWS_TP_STATUS_STOPPING);
+				goto done;
 			}
 
 			continue;
@@ -479,80 +478,188 @@ lws_threadpool_worker_sync(struct lws_pool *pool,
 
 done:
 	pthread_mutex_unlock(&pool->lock); /* ----------------- - pool unlock */
+}
 
-	return 0;
+/*
+ * With the pool qlock held, make the task the one running on pool.  If it's
+ * still on pool's queue, it's taken off it.
+ */
+
+static void
+__lws_threadpool_acquire(struct lws_pool *pool, struct lws_threadpool_task *task)
+{
+	lws_dll2_remove(&task->qlist);
+	task->pool = pool;
+	task->where = LWS_TPW_RUNNING;
+	task->wanted_writeable_cb = 0;
+	task->acquired = pool->acquired = lws_now_usecs();
+	pool->task = task;
+	/* mark it as running */
+	state_transition(task, LWS_TP_STATUS_RUNNING);
 }
 
-#if !defined(WIN32)
-static int dummy;
-#endif
+/*
+ * Find the next task for pool to run: the oldest one on its own queue, or
+ * failing that, the newest one on another worker's queue
+ */
 
-static void *
-lws_threadpool_worker(void *d)
+static struct lws_threadpool_task *
+lws_threadpool_take(struct lws_pool *pool)
 {
-	struct lws_threadpool_task **c, **c2, *task;
-	struct lws_pool *pool = d;
 	struct lws_threadpool *tp = pool->tp;
-	char buf[160];
+	struct lws_threadpool_task *task = NULL;
+	struct lws_pool *victim;
+	int n;
 
-	while (!tp->destroying) {
+	pthread_mutex_lock(&pool->qlock); /* ====================== pool qlock */
+	if (pool->queue.head) {
+		task = lws_container_of(pool->queue.head,
+					struct lws_threadpool_task, qlist);
+		__lws_threadpool_acquire(pool, task);
+	}
+	pthread_mutex_unlock(&pool->qlock); /* ------------------ pool unqlock */
 
-		/* we have no running task... wait and get one from the queue */
+	if (task)
+		return task;
 
-		pthread_mutex_lock(&tp->lock); /* =================== tp lock */
+	for (n = 1; n < tp->threads_in_pool && !task; n++) {
+		victim = &tp->pool_list[(pool->worker_index + n) %
+					tp->threads_in_pool];
 
-		/*
-		 * if there's no task already waiting in the queue, wait for
-		 * the wake_idle condition to signal us that might have changed
-		 */
-		while (!tp->task_queue_head && !tp->destroying)
-			pthread_cond_wait(&tp->wake_idle, &tp->lock);
+		/* unlocked peek, it's just a hint that it's worth locking */
+		if (!victim->queue.count)
+			continue;
 
-		if (tp->destroying) {
-			lwsl_notice("%s: bailing\n", __func__);
-			goto doneski;
+		pthread_mutex_lock(&victim->qlock); /* ========== victim qlock */
+		if (victim->queue.tail) {
+			task = lws_container_of(victim->queue.tail,
+					struct lws_threadpool_task, qlist);
+			lws_dll2_remove(&task->qlist);
+			task->pool = pool;
+			task->where = LWS_TPW_RUNNING;
 		}
+		pthread_mutex_unlock(&victim->qlock); /* ------ victim unqlock */
+	}
 
-		c = &tp->task_queue_head;
-		c2 = NULL;
-		task = NULL;
-		pool->task = NULL;
+	if (!task)
+		return NULL;
 
-		/* look at the queue tail */
-		while (*c) {
-			c2 = c;
-			c = &(*c)->task_queue_next;
-		}
+	pthread_mutex_lock(&pool->qlock); /* ====================== pool qlock */
+	__lws_threadpool_acquire(pool, task);
+	pthread_mutex_unlock(&pool->qlock); /* ------------------ pool unqlock */
+
+	lwsl_thread("%s: %s: worker %d stole %s\n", __func__, tp->name,
+		    pool->worker_index, task->name);
 
-		/* is there a task at the queue tail? */
-		if (c2 && *c2) {
-			pool->task = task = *c2;
-			task->acquired = pool->acquired = lws_now_usecs();
-			/* remove it from the queue */
-			*c2 = task->task_queue_next;
-			task->task_queue_next = NULL;
-			tp->queue_depth--;
-			/* mark it as running */
-			state_transition(task, LWS_TP_STATUS_RUNNING);
+	return task;
+}
+
+static int
+lws_threadpool_queued(struct lws_threadpool *tp)
+{
+	int n, depth = 0;
+
+	/* unlocked, so only a snapshot */
+
+	for (n = 0; n < tp->threads_in_pool; n++)
+		depth += (int)tp->pool_list[n].queue.count;
+
+	return depth;
+}
+
+/*
+ * Wake a worker that is sleeping for lack of anything to do, preferring the
+ * one the task was queued on; any other idle one will steal it.
+ */
+
+static void
+lws_threadpool_wake(struct lws_threadpool *tp, struct lws_pool *pool)
+{
+	struct lws_pool *p;
+	int n;
+
+	/* pairs with the barrier in the worker after it sets idle */
+	lws_memory_barrier();
+
+	for (n = 0; n < tp->threads_in_pool; n++) {
+		p = &tp->pool_list[(pool->worker_index + n) %
+				   tp->threads_in_pool];
+		if (!p->idle)
+			continue;
+
+		pthread_mutex_lock(&p->qlock); /* ================= pool qlock */
+		if (p->idle) {
+			p->idle = 0;
+			pthread_cond_signal(&p->wake_idle);
+			pthread_mutex_unlock(&p->qlock); /* ----- pool unqlock */
+
+			return;
 		}
+		pthread_mutex_unlock(&p->qlock); /* ------------- pool unqlock */
+	}
+}
+
+static void
+lws_threadpool_pin(struct lws_pool *pool)
+{
+#if defined(LWS_HAS_PTHREAD_SETAFFINITY_NP)
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	cpu_set_t cs;
+
+	if (!pool->tp->cpu_affinity || cpus < 1)
+		return;
+
+	CPU_ZERO(&cs);
+	CPU_SET((size_t)((pool->tp->cpu_affinity - 1 + pool->worker_index) %
+								cpus), &cs);
+	if (pthread_setaffinity_np(pool->thread, sizeof(cs), &cs))
+		lwsl_warn("%s: %s: unable to pin worker %d\n", __func__,
+			  pool->tp->name, pool->worker_index);
+#endif
+}
+
+#if !defined(WIN32)
+static int dummy;
+#endif
+
+static void *
+lws_threadpool_worker(void *d)
+{
+	enum lws_threadpool_task_status final;
+	struct lws_threadpool_task *task;
+	struct lws_pool *pool = d;
+	struct lws_threadpool *tp = pool->tp;
+	char buf[160];
+	int reap;
+
+	while (!tp->destroying) {
 
-		/* someone else got it first... wait and try again */
+		task = lws_threadpool_take(pool);
 		if (!task) {
-			pthread_mutex_unlock(&tp->lock);  /* ------ tp unlock */
+			/*
+			 * Nothing on any queue... sleep until an enqueue wakes
+			 * us.  Enqueuers look at idle after adding their task
+			 * and we look at the queues after setting idle, so one
+			 * of us must see the other.
+			 */
+			pthread_mutex_lock(&pool->qlock); /* ====== pool qlock */
+			pool->idle = 1;
+			lws_memory_barrier();
+			if (!tp->destroying && !lws_threadpool_queued(tp))
+				pthread_cond_wait(&pool->wake_idle,
+						  &pool->qlock);
+			pool->idle = 0;
+			pthread_mutex_unlock(&pool->qlock); /* -- pool unqlock */
+
 			continue;
 		}
 
-		task->wanted_writeable_cb = 0;
-
 		/* we have acquired a new task */
 
 		__lws_threadpool_task_dump(task, buf, sizeof(buf));
 
 		lwsl_thread("%s: %s: worker %d ACQUIRING: %s\n",
 			    __func__, tp->name, pool->worker_index, buf);
-		tp->running_tasks++;
-
-		pthread_mutex_unlock(&tp->lock); /* --------------- tp unlock */
 
 		/*
 		 * 1) The task can return with LWS_TP_RETURN_CHECKING_IN to
@@ -575,8 +682,12 @@ lws_threadpool_worker(void *d)
 		 *
 		 * 4) The task can return with LWS_TP_RETURN_STOPPED to indicate
 		 * it stopped and cleaned up after incomplete work.
+		 *
+		 * The final FINISHED or STOPPED is only published, along with
+		 * the task moving to the done list, under the qlock.
 		 */
 
+		final = LWS_TP_STATUS_RUNNING;
 		do {
 			lws_usec_t then;
 			int n;
@@ -606,71 +717,57 @@ lws_threadpool_worker(void *d)
 				}
 				/* block until writable acknowledges */
 				then = lws_now_usecs();
-				if (lws_threadpool_worker_sync(pool, task)) {
-					lwsl_notice("%s: Sync failed\n", __func__);
-					goto doneski;
-				}
+				lws_threadpool_worker_sync(pool, task);
 				us_accrue(&task->acc_syncing, then);
 				break;
 			case LWS_TP_RETURN_FINISHED:
-				state_transition(task, LWS_TP_STATUS_FINISHED);
+				final = LWS_TP_STATUS_FINISHED;
 				break;
 			case LWS_TP_RETURN_STOPPED:
-				state_transition(task, LWS_TP_STATUS_STOPPED);
+				final = LWS_TP_STATUS_STOPPED;
 				break;
 			}
-		} while (task->status == LWS_TP_STATUS_RUNNING);
-
-		pthread_mutex_lock(&tp->lock); /* =================== tp lock */
-
-		tp->running_tasks--;
-
-		if (pool->task->status == LWS_TP_STATUS_STOPPING)
-			state_transition(task, LWS_TP_STATUS_STOPPED);
+		} while (final == LWS_TP_STATUS_RUNNING &&
+			 task->status == LWS_TP_STATUS_RUNNING);
 
-		/* move the task to the done queue */
+		if (final == LWS_TP_STATUS_RUNNING)
+			/* it was asked to stop */
+			final = LWS_TP_STATUS_STOPPED;
 
-		pool->task->task_queue_next = tp->task_done_head;
-		tp->task_done_head = task;
-		tp->done_queue_depth++;
-		pool->task->done = lws_now_usecs();
+		pthread_mutex_lock(&pool->qlock); /* ============== pool qlock */
 
-		if (!pool->task->args.wsi &&
-		    (pool->task->status == LWS_TP_STATUS_STOPPED ||
-		     pool->task->status == LWS_TP_STATUS_FINISHED)) {
+		state_transition(task, final);
+		task->done = lws_now_usecs();
+		pool->task = NULL;
 
-			__lws_threadpool_task_dump(pool->task, buf, sizeof(buf));
-			lwsl_thread("%s: %s: worker %d REAPING: %s\n",
-				    __func__, tp->name, pool->worker_index,
-				    buf);
+		__lws_threadpool_task_dump(task, buf, sizeof(buf));
 
-			/*
-			 * there is no longer any wsi attached, so nothing is
-			 * going to take care of reaping us.  So we must take
-			 * care of it ourselves.
-			 */
-			__lws_threadpool_reap(pool->task);
-		} else {
+		/*
+		 * if there is no longer any wsi attached, nothing is going to
+		 * take care of reaping it, so we must do it ourselves
+		 */
+		reap = !task_to_wsi(task);
+		if (!reap) {
+			lwsl_thread("%s: %s: worker %d DONE: %s\n", __func__,
+				    tp->name, pool->worker_index, buf);
 
-			__lws_threadpool_task_dump(pool->task, buf, sizeof(buf));
-			lwsl_thread("%s: %s: worker %d DONE: %s\n",
-				    __func__, tp->name, pool->worker_index,
-				    buf);
+			task->where = LWS_TPW_DONE;
+			lws_dll2_add_tail(&task->qlist, &pool->done);
 
 			/* signal the associated wsi to take a fresh look at
 			 * task status */
 
-			if (task_to_wsi(pool->task)) {
-				task->wanted_writeable_cb = 1;
-
-				lws_cancel_service(
-					lws_get_context(task_to_wsi(pool->task)));
-			}
+			task->wanted_writeable_cb = 1;
+			lws_threadpool_notify(tp, task->tsi);
 		}
 
-doneski:
-		pool->task = NULL;
-		pthread_mutex_unlock(&tp->lock); /* --------------- tp unlock */
+		pthread_mutex_unlock(&pool->qlock); /* ---------- pool unqlock */
+
+		if (reap) {
+			lwsl_thread("%s: %s: worker %d REAPING: %s\n", __func__,
+				    tp->name, pool->worker_index, buf);
+			lws_threadpool_task_cleanup_destroy(task);
+		}
 	}
 
 	lwsl_notice("%s: Exiting\n", __func__);
@@ -700,6 +797,7 @@ lws_threadpool_create(struct lws_context *context,
 	memset(tp, 0, sizeof(*tp) + (sizeof(struct lws_pool) * (unsigned int)args->threads));
 	tp->pool_list = (struct lws_pool *)(tp + 1);
 	tp->max_queue_depth = args->max_queue_depth;
+	tp->cpu_affinity = args->cpu_affinity;
 
 	va_start(ap, format);
 	n = vsnprintf(tp->name, sizeof(tp->name) - 1, format, ap);
@@ -713,26 +811,45 @@ lws_threadpool_create(struct lws_context *context,
 
 	lws_context_unlock(context);
 
-	pthread_mutex_init(&tp->lock, NULL);
-	pthread_cond_init(&tp->wake_idle, NULL);
-
 	for (n = 0; n < args->threads; n++) {
+		/*
+		 * Only the pools whose thread started are counted, so keep them
+		 * contiguous at the start of the list
+		 */
+		struct lws_pool *pool = &tp->pool_list[tp->threads_in_pool];
 #if defined(LWS_HAS_PTHREAD_SETNAME_NP)
 		char name[16];
 #endif
-		tp->pool_list[n].tp = tp;
-		tp->pool_list[n].worker_index = n;
-		pthread_mutex_init(&tp->pool_list[n].lock, NULL);
-		if (pthread_create(&tp->pool_list[n].thread, NULL,
-				   lws_threadpool_worker, &tp->pool_list[n])) {
+		pool->tp = tp;
+		pool->worker_index = tp->threads_in_pool;
+		pthread_mutex_init(&pool->lock, NULL);
+		pthread_mutex_init(&pool->qlock, NULL);
+		pthread_cond_init(&pool->wake_idle, NULL);
+
+		/*
+		 * the worker looks at threads_in_pool to find others to steal
+		 * from, so it mustn't see its own pool until it's live
+		 */
+		pthread_mutex_lock(&pool->qlock); /* ============== pool qlock */
+
+		if (pthread_create(&pool->thread, NULL,
+				   lws_threadpool_worker, pool)) {
+			pthread_mutex_unlock(&pool->qlock);
 			lwsl_err("thread creation failed\n");
-		} else {
+			pthread_cond_destroy(&pool->wake_idle);
+			pthread_mutex_destroy(&pool->qlock);
+			pthread_mutex_destroy(&pool->lock);
+			continue;
+		}
+
 #if defined(LWS_HAS_PTHREAD_SETNAME_NP)
-			lws_snprintf(name, sizeof(name), "%s-%d", tp->name, n);
-			pthread_setname_np(tp->pool_list[n].thread, name);
+		lws_snprintf(name, sizeof(name), "%s-%d", tp->name, n);
+		pthread_setname_np(pool->thread, name);
 #endif
-			tp->threads_in_pool++;
-		}
+		lws_threadpool_pin(pool);
+		tp->threads_in_pool++;
+
+		pthread_mutex_unlock(&pool->qlock); /* ---------- pool unqlock */
 	}
 
 	return tp;
@@ -741,39 +858,44 @@ lws_threadpool_create(struct lws_context *context,
 void
 lws_threadpool_finish(struct lws_threadpool *tp)
 {
-	struct lws_threadpool_task **c, *task;
-
-	pthread_mutex_lock(&tp->lock); /* ======================== tpool lock */
+	struct lws_threadpool_task *task;
+	struct lws_pool *pool;
+	int n;
 
 	/* nothing new can start, running jobs will abort as STOPPED and the
 	 * pool threads will exit ASAP (they are joined in destroy) */
 	tp->destroying = 1;
+	lws_memory_barrier();
 
-	/* stop everyone in the pending queue and move to the done queue */
-
-	c = &tp->task_queue_head;
-	while (*c) {
-		task = *c;
-		*c = task->task_queue_next;
-		task->task_queue_next = tp->task_done_head;
-		tp->task_done_head = task;
-		state_transition(task, LWS_TP_STATUS_STOPPED);
-		tp->queue_depth--;
-		tp->done_queue_depth++;
-		task->done = lws_now_usecs();
+	for (n = 0; n < tp->threads_in_pool; n++) {
+		pool = &tp->pool_list[n];
 
-		c = &task->task_queue_next;
-	}
+		pthread_mutex_lock(&pool->qlock); /* ============== pool qlock */
+
+		/* stop everyone in the pending queue and move to the done
+		 * queue */
 
-	pthread_cond_broadcast(&tp->wake_idle);
-	pthread_mutex_unlock(&tp->lock); /* -------------------- tpool unlock */
+		while (pool->queue.head) {
+			task = lws_container_of(pool->queue.head,
+					struct lws_threadpool_task, qlist);
+			lws_dll2_remove(&task->qlist);
+			task->where = LWS_TPW_DONE;
+			lws_dll2_add_tail(&task->qlist, &pool->done);
+			state_transition(task, LWS_TP_STATUS_STOPPED);
+			task->done = lws_now_usecs();
+		}
+
+		pthread_cond_broadcast(&pool->wake_idle);
+		pthread_mutex_unlock(&pool->qlock); /* ---------- pool unqlock */
+	}
 }
 
 void
 lws_threadpool_destroy(struct lws_threadpool *tp)
 {
-	struct lws_threadpool_task *task, *next;
+	struct lws_threadpool_task *task;
 	struct lws_threadpool **ptp;
+	struct lws_pool *pool;
 	void *retval;
 	int n;
 
@@ -796,10 +918,15 @@ lws_threadpool_destroy(struct lws_threadpool *tp)
 	 * Wake up the threadpool guys and tell them to exit
 	 */
 
-	pthread_mutex_lock(&tp->lock); /* ======================== tpool lock */
 	tp->destroying = 1;
-	pthread_cond_broadcast(&tp->wake_idle);
-	pthread_mutex_unlock(&tp->lock); /* -------------------- tpool unlock */
+	lws_memory_barrier();
+
+	for (n = 0; n < tp->threads_in_pool; n++) {
+		pool = &tp->pool_list[n];
+		pthread_mutex_lock(&pool->qlock); /* ============== pool qlock */
+		pthread_cond_broadcast(&pool->wake_idle);
+		pthread_mutex_unlock(&pool->qlock); /* ---------- pool unqlock */
+	}
 
 	lws_threadpool_dump(tp);
 
@@ -808,26 +935,37 @@ lws_threadpool_destroy(struct lws_threadpool *tp)
 	Sleep(1000);
 #endif
 
-	for (n = 0; n < tp->threads_in_pool; n++) {
-		task = tp->pool_list[n].task;
-
+	for (n = 0; n < tp->threads_in_pool; n++)
 		pthread_join(tp->pool_list[n].thread, &retval);
-		pthread_mutex_destroy(&tp->pool_list[n].lock);
-	}
+
 	lwsl_info("%s: all threadpools exited\n", __func__);
 #if defined(WIN32)
 	Sleep(1000);
 #endif
 
-	task = tp->task_done_head;
-	while (task) {
-		next = task->task_queue_next;
-		lws_threadpool_task_cleanup_destroy(task);
-		tp->done_queue_depth--;
-		task = next;
-	}
+	for (n = 0; n < tp->threads_in_pool; n++) {
+		pool = &tp->pool_list[n];
 
-	pthread_mutex_destroy(&tp->lock);
+		/* anything still queued if we weren't finished first */
+
+		while (pool->queue.head) {
+			task = lws_container_of(pool->queue.head,
+					struct lws_threadpool_task, qlist);
+			lws_dll2_remove(&task->qlist);
+			lws_threadpool_task_cleanup_destroy(task);
+		}
+
+		while (pool->done.head) {
+			task = lws_container_of(pool->done.head,
+					struct lws_threadpool_task, qlist);
+			lws_dll2_remove(&task->qlist);
+			lws_threadpool_task_cleanup_destroy(task);
+		}
+
+		pthread_cond_destroy(&pool->wake_idle);
+		pthread_mutex_destroy(&pool->qlock);
+		pthread_mutex_destroy(&pool->lock);
+	}
 
 	memset(tp, 0xdd, sizeof(*tp));
 	lws_free(tp);
@@ -841,11 +979,14 @@ int
 lws_threadpool_dequeue_task(struct lws_threadpool_task *task)
 {
 	struct lws_threadpool *tp;
-	struct lws_threadpool_task **c;
-	int n;
+	struct lws_pool *pool;
+	int destroy = 0;
+
+	if (!task)
+		return 0;
 
 	tp = task->tp;
-	pthread_mutex_lock(&tp->lock); /* ======================== tpool lock */
+	pool = lws_threadpool_task_lock(task);
 
 	if (task->outlive && !tp->destroying) {
 
@@ -860,55 +1001,23 @@ lws_threadpool_dequeue_task(struct lws_threadpool_task *task)
 		goto bail;
 	}
 
+	switch (task->where) {
+	case LWS_TPW_QUEUED:
+		/* he's still waiting for a chance to run */
+		lwsl_debug("%s: tp %p: removed queued task %s\n",
+			    __func__, tp, lws_wsi_tag(task_to_wsi(task)));
+		/* fallthru */
+	case LWS_TPW_DONE:
+		lws_dll2_remove(&task->qlist);
+		destroy = 1;
+		break;
 
-	c = &tp->task_queue_head;
-
-	/* is he queued waiting for a chance to run?  Mark him as stopped and
-	 * move him on to the done queue */
-
-	while (*c) {
-		if ((*c) == task) {
-			*c = task->task_queue_next;
-			task->task_queue_next = tp->task_done_head;
-			tp->task_done_head = task;
-			state_transition(task, LWS_TP_STATUS_STOPPED);
-			tp->queue_depth--;
-			tp->done_queue_depth++;
-			task->done = lws_now_usecs();
-
-			lwsl_debug("%s: tp %p: removed queued task %s\n",
-				    __func__, tp, lws_wsi_tag(task_to_wsi(task)));
-
-			break;
-		}
-		c = &(*c)->task_queue_next;
-	}
-
-	/* is he on the done queue? */
-
-	c = &tp->task_done_head;
-	while (*c) {
-		if ((*c) == task) {
-			*c = task->task_queue_next;
-			task->task_queue_next = NULL;
-			lws_threadpool_task_cleanup_destroy(task);
-			tp->done_queue_depth--;
-			goto bail;
-		}
-		c = &(*c)->task_queue_next;
-	}
-
-	/* he's not in the queue... is he already running on a thread? */
-
-	for (n = 0; n < tp->threads_in_pool; n++) {
-		if (!tp->pool_list[n].task || tp->pool_list[n].task != task)
-			continue;
-
+	default:
 		/*
-		 * ensure we don't collide with tests or changes in the
-		 * worker thread
+		 * he's already running on a thread... ensure we don't collide
+		 * with tests or changes in the worker thread
 		 */
-		pthread_mutex_lock(&tp->pool_list[n].lock);
+		pthread_mutex_lock(&pool->lock); /* =============== pool lock */
 
 		/*
 		 * mark him as having been requested to stop...
@@ -917,36 +1026,27 @@ lws_threadpool_dequeue_task(struct lws_threadpool_task *task)
 		 */
 		state_transition(task, LWS_TP_STATUS_STOPPING);
 
-		/* disconnect from wsi, and wsi from task */
-
-		lws_dll2_remove(&task->list);
-		task->args.wsi = NULL;
-#if defined(LWS_WITH_SECURE_STREAMS)
-		task->args.ss = NULL;
-#endif
-
-		pthread_mutex_unlock(&tp->pool_list[n].lock);
-
 		lwsl_debug("%s: tp %p: request stop running task "
 			    "for %s\n", __func__, tp,
 			    lws_wsi_tag(task_to_wsi(task)));
 
-		break;
-	}
+		/* disconnect from wsi, and wsi from task */
 
-	if (n == tp->threads_in_pool) {
-		/* can't find it */
-		lwsl_notice("%s: tp %p: no task for %s, decoupling\n",
-			    __func__, tp, lws_wsi_tag(task_to_wsi(task)));
 		lws_dll2_remove(&task->list);
 		task->args.wsi = NULL;
 #if defined(LWS_WITH_SECURE_STREAMS)
 		task->args.ss = NULL;
 #endif
+
+		pthread_mutex_unlock(&pool->lock); /* ----------- pool unlock */
+		break;
 	}
 
 bail:
-	pthread_mutex_unlock(&tp->lock); /* -------------------- tpool unlock */
+	pthread_mutex_unlock(&pool->qlock); /* ------------------ pool unqlock */
+
+	if (destroy)
+		lws_threadpool_task_cleanup_destroy(task);
 
 	return 0;
 }
@@ -966,33 +1066,53 @@ lws_threadpool_dequeue(struct lws *wsi) /* deprecated */
 	return lws_threadpool_dequeue_task(task);
 }
 
+/*
+ * Offer the task to an idle worker if there is one, otherwise go round the
+ * workers in turn.  rr is only a hint, so it's fine that it isn't atomic.
+ */
+
+static struct lws_pool *
+lws_threadpool_pick(struct lws_threadpool *tp)
+{
+	unsigned int start = tp->rr++, n;
+	struct lws_pool *pool;
+
+	for (n = 0; n < (unsigned int)tp->threads_in_pool; n++) {
+		pool = &tp->pool_list[(start + n) %
+				      (unsigned int)tp->threads_in_pool];
+		if (pool->idle)
+			return pool;
+	}
+
+	return &tp->pool_list[start % (unsigned int)tp->threads_in_pool];
+}
+
 struct lws_threadpool_task *
 lws_threadpool_enqueue(struct lws_threadpool *tp,
 		       const struct lws_threadpool_task_args *args,
 		       const char *format, ...)
 {
-	struct lws_threadpool_task *task = NULL;
+	struct lws_threadpool_task *task;
+	struct lws_pool *pool;
 	va_list ap;
 
-	if (tp->destroying)
+	if (tp->destroying || !tp->threads_in_pool)
 		return NULL;
 
 #if defined(LWS_WITH_SECURE_STREAMS)
 	assert(args->ss || args->wsi);
 #endif
 
-	pthread_mutex_lock(&tp->lock); /* ======================== tpool lock */
-
 	/*
-	 * if there's room on the queue, the job always goes on the queue
-	 * first, then any free thread may pick it up after the wake_idle
+	 * The queues are summed without locking them, so the limit is only
+	 * approximate when several pts are enqueueing at once
 	 */
 
-	if (tp->queue_depth == tp->max_queue_depth) {
+	if (lws_threadpool_queued(tp) >= tp->max_queue_depth) {
 		lwsl_notice("%s: queue reached limit %d\n", __func__,
 			    tp->max_queue_depth);
 
-		goto bail;
+		return NULL;
 	}
 
 	/*
@@ -1001,7 +1121,7 @@ lws_threadpool_enqueue(struct lws_threadpool *tp,
 
 	task = lws_malloc(sizeof(*task), __func__);
 	if (!task)
-		goto bail;
+		return NULL;
 
 	memset(task, 0, sizeof(*task));
 	pthread_cond_init(&task->wake_idle, NULL);
@@ -1013,15 +1133,6 @@ lws_threadpool_enqueue(struct lws_threadpool *tp,
 	vsnprintf(task->name, sizeof(task->name) - 1, format, ap);
 	va_end(ap);
 
-	/*
-	 * add him on the tp task queue
-	 */
-
-	task->task_queue_next = tp->task_queue_head;
-	state_transition(task, LWS_TP_STATUS_QUEUED);
-	tp->task_queue_head = task;
-	tp->queue_depth++;
-
 	/*
 	 * mark the wsi itself as depending on this tp (so wsi close for
 	 * whatever reason can clean up)
@@ -1034,17 +1145,28 @@ lws_threadpool_enqueue(struct lws_threadpool *tp,
 #endif
 		lws_dll2_add_tail(&task->list, &args->wsi->tp_task_owner);
 
-	lwsl_thread("%s: tp %s: enqueued task %p (%s) for %s, depth %d\n",
-		    __func__, tp->name, task, task->name,
-		    lws_wsi_tag(task_to_wsi(task)), tp->queue_depth);
+	task->tsi = task_to_wsi(task)->tsi;
 
-	/* alert any idle thread there's something new on the task list */
+	/*
+	 * add him on the tail of a worker's task queue
+	 */
 
-	lws_memory_barrier();
-	pthread_cond_signal(&tp->wake_idle);
+	pool = lws_threadpool_pick(tp);
 
-bail:
-	pthread_mutex_unlock(&tp->lock); /* -------------------- tpool unlock */
+	pthread_mutex_lock(&pool->qlock); /* ====================== pool qlock */
+	task->pool = pool;
+	task->where = LWS_TPW_QUEUED;
+	state_transition(task, LWS_TP_STATUS_QUEUED);
+	lws_dll2_add_tail(&task->qlist, &pool->queue);
+	pthread_mutex_unlock(&pool->qlock); /* ------------------ pool unqlock */
+
+	lwsl_thread("%s: tp %s: enqueued task %p (%s) for %s on worker %d\n",
+		    __func__, tp->name, task, task->name,
+		    lws_wsi_tag(task_to_wsi(task)), pool->worker_index);
+
+	/* alert an idle thread there's something new on the task lists */
+
+	lws_threadpool_wake(tp, pool);
 
 	return task;
 }
@@ -1056,6 +1178,8 @@ lws_threadpool_task_status(struct lws_threadpool_task *task, void **user)
 {
 	enum lws_threadpool_task_status status;
 	struct lws_threadpool *tp = task->tp;
+	struct lws_pool *pool;
+	int reap = 0;
 
 	if (!tp)
 		return LWS_TP_STATUS_FINISHED;
@@ -1067,13 +1191,24 @@ lws_threadpool_task_status(struct lws_threadpool_task *task, void **user)
 	    status == LWS_TP_STATUS_STOPPED) {
 		char buf[160];
 
-		pthread_mutex_lock(&tp->lock); /* ================ tpool lock */
-		__lws_threadpool_task_dump(task, buf, sizeof(buf));
-		lwsl_thread("%s: %s: service thread REAPING: %s\n",
-			    __func__, tp->name, buf);
-		__lws_threadpool_reap(task);
-		lws_memory_barrier();
-		pthread_mutex_unlock(&tp->lock); /* ------------ tpool unlock */
+		pool = lws_threadpool_task_lock(task);
+		if (task->where == LWS_TPW_DONE) {
+			/* remove the task from the done queue */
+			lws_dll2_remove(&task->qlist);
+			reap = 1;
+		} else
+			lwsl_err("%s: task %p not in done queue\n", __func__,
+				 task);
+		pthread_mutex_unlock(&pool->qlock); /* ---------- pool unqlock */
+
+		if (reap) {
+			__lws_threadpool_task_dump(task, buf, sizeof(buf));
+			lwsl_thread("%s: %s: service thread REAPING: %s\n",
+				    __func__, tp->name, buf);
+
+			/* call the task's cleanup and delete the task itself */
+			lws_threadpool_task_cleanup_destroy(task);
+		}
 	}
 
 	return status;
@@ -1109,6 +1244,8 @@ lws_threadpool_task_status_wsi(struct lws *wsi,
 void
 lws_threadpool_task_sync(struct lws_threadpool_task *task, int stop)
 {
+	struct lws_pool *pool;
+
 	lwsl_debug("%s\n", __func__);
 	if (!task)
 		return;
@@ -1116,40 +1253,37 @@ lws_threadpool_task_sync(struct lws_threadpool_task *task, int stop)
 	if (stop)
 		state_transition(task, LWS_TP_STATUS_STOPPING);
 
-	pthread_mutex_lock(&task->tp->lock);
+	/*
+	 * The syncing worker waits on the task's wake_idle with its pool lock,
+	 * it's running so it can't be stolen away from that pool meanwhile
+	 */
+
+	pool = task->pool;
+	pthread_mutex_lock(&pool->lock);
 	pthread_cond_signal(&task->wake_idle);
-	pthread_mutex_unlock(&task->tp->lock);
+	pthread_mutex_unlock(&pool->lock);
 }
 
+/*
+ * The wsi's task list is only changed from its service thread, which is where
+ * this is called from, so it doesn't need any threadpool lock
+ */
+
 int
 lws_threadpool_foreach_task_wsi(struct lws *wsi, void *user,
 				int (*cb)(struct lws_threadpool_task *task,
 					  void *user))
 {
-	struct lws_threadpool_task *task1;
-
-	if (wsi->tp_task_owner.head == NULL)
-		return 0;
-
-	task1 = lws_container_of(wsi->tp_task_owner.head,
-				 struct lws_threadpool_task, list);
-
-	pthread_mutex_lock(&task1->tp->lock); /* ================ tpool lock */
-
 	lws_start_foreach_dll_safe(struct lws_dll2 *, d, d1,
 				   wsi->tp_task_owner.head) {
 		struct lws_threadpool_task *task = lws_container_of(d,
 					struct lws_threadpool_task, list);
 
-		if (cb(task, user)) {
-			pthread_mutex_unlock(&task1->tp->lock); /* ------------ tpool unlock */
+		if (cb(task, user))
 			return 1;
-		}
 
 	} lws_end_foreach_dll_safe(d, d1);
 
-	pthread_mutex_unlock(&task1->tp->lock); /* ------------ tpool unlock */
-
 	return 0;
 }
 
@@ -1170,9 +1304,21 @@ static int
 disassociate_wsi(struct lws_threadpool_task *task,
 		  void *user)
 {
+	struct lws_pool *pool = lws_threadpool_task_lock(task);
+	int reap = task->where == LWS_TPW_DONE;
+
 	task->args.wsi = NULL;
 	lws_dll2_remove(&task->list);
 
+	/* nobody is going to ask about it any more if it's already done */
+	if (reap)
+		lws_dll2_remove(&task->qlist);
+
+	pthread_mutex_unlock(&pool->qlock); /* ------------------ pool unqlock */
+
+	if (reap)
+		lws_threadpool_task_cleanup_destroy(task);
+
 	return 0;
 }
 
@@ -27,26 +27,85 @@
 #endif
 #include "private-lib-core.h"
 
+/*
+ * When max_fds is unrelated to ulimit, lws_lookup is a linear-probed hash
+ * table keyed by the fd, with at least twice as many slots as max_fds so
+ * there's always an empty slot ending each probe chain.
+ *
+ * Multiplying by an odd constant is a bijection mod 2^n, so a run of
+ * consecutive fds, which is what the process usually hands us, lands on
+ * distinct slots.
+ */
+
+static unsigned int
+lws_lookup_slot(const struct lws_context *context, int fd)
+{
+	return ((unsigned int)fd * 0x9e3779b1u) &
+					(context->lws_lookup_size - 1);
+}
+
+static int
+lws_lookup_find(const struct lws_context *context, int fd,
+		const struct lws *wsi)
+{
+	unsigned int n = lws_lookup_slot(context, fd), m;
+
+	for (m = 0; m < context->lws_lookup_size; m++) {
+		struct lws *w = context->lws_lookup[n];
+
+		if (!w)
+			break;
+
+		if (wsi ? w == wsi : w->desc.sockfd == fd)
+			return (int)n;
+
+		n = (n + 1) & (context->lws_lookup_size - 1);
+	}
+
+	return -1;
+}
+
+/*
+ * Empty the slot, then pull back any later entries in the chain that would
+ * otherwise become unreachable, so we never need tombstones
+ */
+
+static void
+lws_lookup_remove_slot(const struct lws_context *context, unsigned int n)
+{
+	unsigned int mask = context->lws_lookup_size - 1, j = n, k;
+
+	context->lws_lookup[n] = NULL;
+
+	while (1) {
+		j = (j + 1) & mask;
+		if (!context->lws_lookup[j])
+			return;
+
+		k = lws_lookup_slot(context, context->lws_lookup[j]->desc.sockfd);
+		if (((j - k) & mask) < ((j - n) & mask))
+			/* its home is between the hole and it, leave it */
+			continue;
+
+		context->lws_lookup[n] = context->lws_lookup[j];
+		context->lws_lookup[j] = NULL;
+		n = j;
+	}
+}
+
 struct lws *
 wsi_from_fd(const struct lws_context *context, int fd)
 {
-	struct lws **p, **done;
+	int n;
 
 	if (!context->max_fds_unrelated_to_ulimit)
 		return context->lws_lookup[fd - lws_plat_socket_offset()];
 
-	/* slow fds handling */
-
-	p = context->lws_lookup;
-	done = &p[context->max_fds];
+	n = lws_lookup_find(context, fd, NULL);
+	if (n < 0)
+		return NULL;
 
-	while (p != done) {
-		if (*p && (*p)->desc.sockfd == fd)
-			return *p;
-		p++;
-	}
-
-	return NULL;
+	return context->lws_lookup[n];
 }
 
 #if defined(_DEBUG)
@@ -59,10 +118,10 @@ sanity_assert_no_wsi_traces(const struct lws_context *context, struct lws *wsi)
 		/* can't tell */
 		return 0;
 
-	/* slow fds handling */
+	/* we don't know what fd it was listed under, so look everywhere */
 
 	p = context->lws_lookup;
-	done = &p[context->max_fds];
+	done = &p[context->lws_lookup_size];
 
 	/* confirm the wsi doesn't already exist */
 
@@ -88,8 +147,6 @@ sanity_assert_no_sockfd_traces(const struct lws_context *context,
 	 */
 	return 0;
 #else
-	struct lws **p, **done;
-
 	if (sfd == LWS_SOCK_INVALID || !context->lws_lookup)
 		return 0;
 
@@ -99,17 +156,10 @@ sanity_assert_no_sockfd_traces(const struct lws_context *context,
 		return 1;
 	}
 
-	/* slow fds handling */
-
-	p = context->lws_lookup;
-	done = &p[context->max_fds];
-
 	/* confirm the sfd not already in use */
 
-	while (p != done && (!*p || (*p)->desc.sockfd != sfd))
-		p++;
-
-	if (p == done)
+	if (!context->max_fds_unrelated_to_ulimit ||
+	    lws_lookup_find(context, sfd, NULL) < 0)
 		return 0;
 
 	assert(0); /* this fd is still in the tables */
@@ -123,7 +173,7 @@ sanity_assert_no_sockfd_traces(const struct lws_context *context,
 int
 insert_wsi(const struct lws_context *context, struct lws *wsi)
 {
-	struct lws **p, **done;
+	unsigned int n, m;
 
 	if (sanity_assert_no_wsi_traces(context, wsi))
 		return 0;
@@ -138,31 +188,26 @@ insert_wsi(const struct lws_context *context, struct lws *wsi)
 		return 0;
 	}
 
-	/* slow fds handling */
-
-	p = context->lws_lookup;
-	done = &p[context->max_fds];
-
 	/* confirm fd isn't already in use by a wsi */
 
 	if (sanity_assert_no_sockfd_traces(context, wsi->desc.sockfd))
 		return 0;
 
-	p = context->lws_lookup;
-
-	/* find an empty slot */
+	/* find the first empty slot in its chain */
 
-	while (p != done && *p)
-		p++;
+	n = lws_lookup_slot(context, wsi->desc.sockfd);
+	for (m = 0; m < context->lws_lookup_size; m++) {
+		if (!context->lws_lookup[n]) {
+			context->lws_lookup[n] = wsi;
 
-	if (p == done) {
-		lwsl_err("%s: reached max fds\n", __func__);
-		return 1;
+			return 0;
+		}
+		n = (n + 1) & (context->lws_lookup_size - 1);
 	}
 
-	*p = wsi;
+	lwsl_err("%s: reached max fds\n", __func__);
 
-	return 0;
+	return 1;
 }
 
 
@@ -170,8 +215,7 @@ insert_wsi(const struct lws_context *context, struct lws *wsi)
 void
 delete_from_fd(const struct lws_context *context, int fd)
 {
-
-	struct lws **p, **done;
+	int n;
 
 	if (!context->max_fds_unrelated_to_ulimit) {
 		if (context->lws_lookup)
@@ -180,29 +224,17 @@ delete_from_fd(const struct lws_context *context, int fd)
 		return;
 	}
 
-	/* slow fds handling */
-
-	p = context->lws_lookup;
-	assert(p);
-
-	done = &p[context->max_fds];
-
-	/* find the match */
-
-	while (p != done && (!*p || (*p)->desc.sockfd != fd))
-		p++;
+	assert(context->lws_lookup);
 
-	if (p != done)
-		*p = NULL;
+	n = lws_lookup_find(context, fd, NULL);
+	if (n >= 0)
+		lws_lookup_remove_slot(context, (unsigned int)n);
 
 #if defined(_DEBUG)
-	p = context->lws_lookup;
-	while (p != done && (!*p || (*p)->desc.sockfd != fd))
-		p++;
-
-	if (p != done) {
+	n = lws_lookup_find(context, fd, NULL);
+	if (n >= 0) {
 		lwsl_err("%s: fd %d in lws_lookup again at %d\n", __func__,
-				fd, (int)(p - context->lws_lookup));
+				fd, n);
 		assert(0);
 	}
 #endif
@@ -211,25 +243,15 @@ delete_from_fd(const struct lws_context *context, int fd)
 void
 delete_from_fdwsi(const struct lws_context *context, struct lws *wsi)
 {
+	int n;
 
-	struct lws **p, **done;
-
-	if (!context->max_fds_unrelated_to_ulimit)
+	if (!context->max_fds_unrelated_to_ulimit ||
+	    !lws_socket_is_valid(wsi->desc.sockfd))
 		return;
 
-
-	/* slow fds handling */
-
-	p = context->lws_lookup;
-	done = &p[context->max_fds];
-
-	/* find the match */
-
-	while (p != done && (!*p || (*p) != wsi))
-		p++;
-
-	if (p != done)
-		*p = NULL;
+	n = lws_lookup_find(context, wsi->desc.sockfd, wsi);
+	if (n >= 0)
+		lws_lookup_remove_slot(context, (unsigned int)n);
 }
 
 void
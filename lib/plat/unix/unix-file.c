@@ -34,6 +34,9 @@
 #include <dlfcn.h>
 #endif
 #include <dirent.h>
+#if defined(LWS_HAVE_SYS_SENDFILE_H)
+#include <sys/sendfile.h>
+#endif
 
 int lws_plat_apply_FD_CLOEXEC(int n)
 {
@@ -164,6 +167,43 @@ _lws_plat_file_read(lws_fop_fd_t fop_fd, lws_filepos_t *amount,
 	return 0;
 }
 
+#if defined(LWS_HAVE_SYS_SENDFILE_H)
+/*
+ * Send up to len bytes of a fops_platform file from its current position
+ * directly to the socket, without it coming up through userland.  The file
+ * position moves on by what was sent, so seeks and reads afterwards work as
+ * usual.  Returns the amount sent, 0 if the socket can't take any more right
+ * now, or -1 on error.
+ */
+
+int
+lws_plat_file_sendfile(lws_fop_fd_t fop_fd, lws_sockfd_type sockfd,
+		       lws_filepos_t len)
+{
+	ssize_t n;
+
+	n = sendfile(sockfd, (int)fop_fd->fd, NULL, (size_t)len);
+	if (n < 0) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+			return 0;
+
+		lwsl_info("%s: errno %d\n", __func__, errno);
+
+		return -1;
+	}
+	if (!n && len) {
+		/* the file got shorter underneath us */
+		lwsl_info("%s: unexpected EOF\n", __func__);
+
+		return -1;
+	}
+
+	fop_fd->pos = (lws_filepos_t)(fop_fd->pos + (lws_filepos_t)n);
+
+	return (int)n;
+}
+#endif
+
 int
 _lws_plat_file_write(lws_fop_fd_t fop_fd, lws_filepos_t *amount,
 		     uint8_t *buf, lws_filepos_t len)
@@ -77,7 +77,7 @@ lws_sul_plat_unix(lws_sorted_usec_list_t *sul)
 	lws_context_unlock(context);
 #endif
 
-	__lws_sul_insert_us(&pt->pt_sul_owner[LWSSULLI_MISS_IF_SUSPENDED],
+	__lws_sul_insert_us(pt, LWSSULLI_MISS_IF_SUSPENDED,
 			    &pt->sul_plat, 30 * LWS_US_PER_SEC);
 }
 #endif
@@ -113,26 +113,34 @@ lws_plat_init(struct lws_context *context,
 	 *  - default: allocate a worst-case lookup array sized for ulimit -n
 	 *             and use the fd directly as an index into it
 	 *
-	 *  - slow:    allocate context->max_fds entries only (which can be
-	 *             forced at context creation time to be
-	 *             info->fd_limit_per_thread * the number of threads)
-	 *             and search the array to lookup fds
+	 *  - hashed:  allocate a small open-addressed hash table sized for
+	 *             context->max_fds entries only (which can be forced at
+	 *             context creation time to be info->fd_limit_per_thread *
+	 *             the number of threads), keyed by the fd
 	 *
 	 * the default way is optimized for server, if you only use one or two
-	 * client wsi the slow way may save a lot of memory.
+	 * client wsi the hashed way may save a lot of memory.
 	 *
 	 * Both ways allocate an array of struct lws *... one allocates it for
 	 * all possible fd indexes the process could produce and uses it as a
-	 * map, the other allocates for an amount of wsi the lws context is
-	 * expected to use and searches through it to manipulate it.
+	 * map, the other allocates a power of two at least twice the amount of
+	 * wsi the lws context is expected to use, so the probe chains stay
+	 * short even when it's full.
 	 */
 
+	context->lws_lookup_size = context->max_fds;
+	if (context->max_fds_unrelated_to_ulimit) {
+		context->lws_lookup_size = 8;
+		while (context->lws_lookup_size < context->max_fds * 2)
+			context->lws_lookup_size <<= 1;
+	}
+
 	context->lws_lookup = lws_zalloc(sizeof(struct lws *) *
-					 context->max_fds, "lws_lookup");
+					 context->lws_lookup_size, "lws_lookup");
 
 	if (!context->lws_lookup) {
 		lwsl_cx_err(context, "OOM on alloc lws_lookup array for %d conn",
-			 context->max_fds);
+			 context->lws_lookup_size);
 		return 1;
 	}
 
@@ -219,7 +227,7 @@ lws_plat_init(struct lws_context *context,
 	/* we only need to do this on pt[0] */
 
 	context->pt[0].sul_plat.cb = lws_sul_plat_unix;
-	__lws_sul_insert_us(&context->pt[0].pt_sul_owner[LWSSULLI_MISS_IF_SUSPENDED],
+	__lws_sul_insert_us(&context->pt[0], LWSSULLI_MISS_IF_SUSPENDED,
 			    &context->pt[0].sul_plat, 30 * LWS_US_PER_SEC);
 #endif
 
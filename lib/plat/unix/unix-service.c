@@ -149,6 +149,16 @@ _lws_plat_service_tsi(struct lws_context *context, int timeout_ms, int tsi)
 #endif
 	vpt->inside_poll = 1;
 	lws_memory_barrier();
+#if defined(LWS_WITH_EPOLL)
+	if (context->event_loop_ops == &event_loop_ops_epoll)
+		n = lws_epoll_service_wait(pt, (int)timeout_us /* ms now */);
+	else
+#endif
+#if defined(LWS_WITH_IO_URING)
+	if (context->event_loop_ops == &event_loop_ops_io_uring)
+		n = lws_io_uring_service_wait(pt, (int)timeout_us /* ms now */);
+	else
+#endif
 	n = poll(pt->fds, pt->fds_count, (int)timeout_us /* ms now */ );
 	vpt->inside_poll = 0;
 	lws_memory_barrier();
@@ -193,6 +203,27 @@ _lws_plat_service_tsi(struct lws_context *context, int timeout_ms, int tsi)
 
 	lws_pt_unlock(pt);
 
+#if defined(LWS_WITH_EPOLL)
+	if (context->event_loop_ops == &event_loop_ops_epoll) {
+		/*
+		 * epoll told us exactly which fds are ready, service just
+		 * those.  The walk of all pt->fds[] below is then only needed
+		 * if something else wants to fake POLLIN.
+		 */
+		if (n && lws_epoll_service_ready(context, tsi) < 0)
+			return -1;
+		n = 0;
+	}
+#endif
+#if defined(LWS_WITH_IO_URING)
+	if (context->event_loop_ops == &event_loop_ops_io_uring) {
+		/* same story as epoll, only the completed polls */
+		if (n && lws_io_uring_service_ready(context, tsi) < 0)
+			return -1;
+		n = 0;
+	}
+#endif
+
 #if (defined(LWS_ROLE_WS) && !defined(LWS_WITHOUT_EXTENSIONS)) || defined(LWS_WITH_TLS)
 	m = 0;
 #endif
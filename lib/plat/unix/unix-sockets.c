@@ -77,6 +77,12 @@ lws_send_pipe_choked(struct lws *wsi)
 	    )
 		return 1;
 
+#if defined(LWS_WITH_IO_URING)
+	/* the socket is only being written from his io_uring tx queue */
+	if (lws_io_uring_tx_owned(wsi_eff))
+		return lws_io_uring_tx_busy(wsi_eff);
+#endif
+
 	fds.fd = wsi_eff->desc.sockfd;
 	fds.events = POLLOUT;
 	fds.revents = 0;
@@ -875,9 +875,9 @@ rops_destroy_role_h1(struct lws *wsi)
 	lwsl_info("%s: ah det due to close\n", __func__);
 	__lws_header_table_detach(wsi, 0);
 
-	 ah = pt->http.ah_list;
-
-	while (ah) {
+	lws_start_foreach_dll(struct lws_dll2 *, d,
+			      lws_dll2_get_head(&pt->http.ah_owner)) {
+		ah = lws_container_of(d, struct allocated_headers, list);
 		if (ah->in_use && ah->wsi == wsi) {
 			lwsl_err("%s: ah leak: wsi %s\n", __func__,
 					lws_wsi_tag(wsi));
@@ -886,15 +886,15 @@ rops_destroy_role_h1(struct lws *wsi)
 			pt->http.ah_count_in_use--;
 			break;
 		}
-		ah = ah->next;
-	}
+	} lws_end_foreach_dll(d);
 
 #if defined(LWS_WITH_HTTP_STREAM_COMPRESSION)
 	lws_http_compression_destroy(wsi);
 #endif
 
 #ifdef LWS_ROLE_WS
-	lws_free_set_NULL(wsi->ws);
+	lws_slab_free(wsi->ws);
+	wsi->ws = NULL;
 #endif
 	return 0;
 }
@@ -1095,7 +1095,7 @@ rops_pt_init_destroy_h1(struct lws_context *context,
 
 		pt->sul_ah_lifecheck.cb = lws_sul_http_ah_lifecheck;
 
-		__lws_sul_insert_us(&pt->pt_sul_owner[LWSSULLI_MISS_IF_SUSPENDED],
+		__lws_sul_insert_us(pt, LWSSULLI_MISS_IF_SUSPENDED,
 				 &pt->sul_ah_lifecheck, 30 * LWS_US_PER_SEC);
 	} else
 		lws_dll2_remove(&pt->sul_ah_lifecheck.list);
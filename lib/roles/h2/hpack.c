@@ -193,16 +193,6 @@ static const char * const http2_canned[] = {
 
 #include "huftable.h"
 
-static int huftable_decode(int pos, char c)
-{
-	int q = pos + !!c;
-
-	if (lextable_terms[q >> 3] & (1 << (q & 7))) /* terminal */
-		return lextable[q] | 0x8000;
-
-	return pos + (lextable[q] << 1);
-}
-
 static int lws_frag_start(struct lws *wsi, int hdr_token_idx)
 {
 	struct allocated_headers *ah = wsi->http.ah;
@@ -351,13 +341,13 @@ static void lws_dump_header(struct lws *wsi, int hdr)
  */
 
 /*
- * returns 0 if dynamic entry (arg and len are filled)
+ * returns 0 if dynamic entry (dte is filled)
  * returns -1 if failure
  * returns nonzero token index if actually static token
  */
 static int
-lws_token_from_index(struct lws *wsi, int index, const char **arg, int *len,
-		     uint32_t *hdr_len)
+lws_token_from_index(struct lws *wsi, int index,
+		     const struct hpack_dt_entry **dte, uint32_t *hdr_len)
 {
 	struct hpack_dynamic_table *dyn;
 
@@ -375,10 +365,6 @@ lws_token_from_index(struct lws *wsi, int index, const char **arg, int *len,
 		return -1;
 
 	if (index < (int)LWS_ARRAY_SIZE(static_token)) {
-		if (arg && index < (int)LWS_ARRAY_SIZE(http2_canned)) {
-			*arg = http2_canned[index];
-			*len = (int)strlen(http2_canned[index]);
-		}
 		if (hdr_len)
 			*hdr_len = static_hdr_len[index];
 
@@ -406,10 +392,8 @@ lws_token_from_index(struct lws *wsi, int index, const char **arg, int *len,
 	lwsl_header("%s: dyn index %d, tok %d\n", __func__, index,
 		    dyn->entries[index].lws_hdr_idx);
 
-	if (arg && len) {
-		*arg = dyn->entries[index].value;
-		*len = dyn->entries[index].value_len;
-	}
+	if (dte)
+		*dte = &dyn->entries[index];
 
 	if (hdr_len)
 		*hdr_len = dyn->entries[index].hdr_len;
@@ -431,10 +415,11 @@ lws_h2_dynamic_table_dump(struct lws *wsi)
 	dyn = &nwsi->h2.h2n->hpack_dyn_table;
 
 	lwsl_header("Dump dyn table for nwsi %s (%d / %d members, pos = %d, "
-		    "start index %d, virt used %d / %d)\n", lws_wsi_tag(nwsi),
-		    dyn->used_entries, dyn->num_entries, dyn->pos,
-		    (uint32_t)LWS_ARRAY_SIZE(static_token),
-		    dyn->virtual_payload_usage, dyn->virtual_payload_max);
+		    "start index %d, virt used %d / %d, arena %u / %u)\n",
+		    lws_wsi_tag(nwsi), dyn->used_entries, dyn->num_entries,
+		    dyn->pos, (uint32_t)LWS_ARRAY_SIZE(static_token),
+		    dyn->virtual_payload_usage, dyn->virtual_payload_max,
+		    dyn->arena_used, dyn->arena_len);
 
 	for (n = 0; n < dyn->used_entries; n++) {
 		m = lws_safe_modulo(dyn->pos - 1 - n, dyn->num_entries);
@@ -445,10 +430,10 @@ lws_h2_dynamic_table_dump(struct lws *wsi)
 					dyn->entries[m].lws_hdr_idx);
 		else
 			p = "(ignored)";
-		lwsl_header("   %3d: tok %s: (len %d) val '%s'\n",
+		lwsl_header("   %3d: tok %s: (len %d) val at %u, len %d\n",
 			    (int)(n + LWS_ARRAY_SIZE(static_token)), p,
-			    dyn->entries[m].hdr_len, dyn->entries[m].value ?
-			    dyn->entries[m].value : "null");
+			    dyn->entries[m].hdr_len, dyn->entries[m].value_ofs,
+			    dyn->entries[m].value_len);
 	}
 #endif
 	return 0;
@@ -460,14 +445,65 @@ lws_dynamic_free(struct hpack_dynamic_table *dyn, int idx)
 	lwsl_header("freeing %d for reuse\n", idx);
 	dyn->virtual_payload_usage = (uint32_t)((unsigned int)dyn->virtual_payload_usage - (unsigned int)(dyn->entries[idx].value_len +
 				dyn->entries[idx].hdr_len));
-	lws_free_set_NULL(dyn->entries[idx].value);
-	dyn->entries[idx].value = NULL;
+	/* it's always the oldest, so its value is at the head of the arena */
+	if (dyn->entries[idx].lws_hdr_idx != LWS_HPACK_IGNORE_ENTRY)
+		dyn->arena_used -= dyn->entries[idx].value_len;
 	dyn->entries[idx].value_len = 0;
 	dyn->entries[idx].hdr_len = 0;
 	dyn->entries[idx].lws_hdr_idx = LWS_HPACK_IGNORE_ENTRY;
 	dyn->used_entries--;
 }
 
+/*
+ * Move the values of the entries into a new arena of len bytes, oldest first
+ * from the start of it.  len must be at least dyn->arena_used.
+ */
+
+static int
+lws_dynamic_arena_resize(struct hpack_dynamic_table *dyn, uint32_t len)
+{
+	struct hpack_dt_entry *e;
+	uint32_t o = 0, s, k;
+	char *a = NULL;
+	int n, m;
+
+	if (len) {
+		a = lws_malloc(len, "hpack dyn arena");
+		if (!a)
+			return 1;
+	}
+
+	for (n = 0; n < dyn->used_entries; n++) {
+		m = lws_safe_modulo(dyn->pos - dyn->used_entries + n,
+				    dyn->num_entries);
+		if (m < 0)
+			m += dyn->num_entries;
+		e = &dyn->entries[m];
+		if (e->lws_hdr_idx == LWS_HPACK_IGNORE_ENTRY)
+			continue;
+
+		s = e->value_ofs;
+		k = e->value_len;
+		if (s + k > dyn->arena_len) { /* it wraps */
+			memcpy(a + o, dyn->arena + s, dyn->arena_len - s);
+			k -= dyn->arena_len - s;
+			o += dyn->arena_len - s;
+			s = 0;
+		}
+		if (k)
+			memcpy(a + o, dyn->arena + s, k);
+		o += k;
+		e->value_ofs = o - e->value_len;
+	}
+
+	lws_free(dyn->arena);
+	dyn->arena = a;
+	dyn->arena_len = len;
+	dyn->arena_tail = len ? o % len : 0;
+
+	return 0;
+}
+
 /*
  * There are two address spaces, 1) internal ringbuffer and 2) HPACK indexes.
  *
@@ -487,6 +523,8 @@ lws_dynamic_token_insert(struct lws *wsi, int hdr_len,
 			 int lws_hdr_index, char *arg, size_t len)
 {
 	struct hpack_dynamic_table *dyn;
+	struct hpack_dt_entry *e;
+	uint32_t need, a, vlen;
 	int new_index;
 
 	/* dynamic table only belongs to network wsi */
@@ -527,35 +565,52 @@ lws_dynamic_token_insert(struct lws *wsi, int hdr_len,
 		lws_dynamic_free(dyn, n);
 	}
 
-	if (dyn->used_entries < dyn->num_entries)
-		dyn->used_entries++;
-
-	dyn->entries[new_index].value_len = 0;
+	/* we only keep the values of headers lws knows */
+	vlen = lws_hdr_index == LWS_HPACK_IGNORE_ENTRY ? 0 : (uint32_t)len;
 
-	if (lws_hdr_index != LWS_HPACK_IGNORE_ENTRY) {
-		if (dyn->entries[new_index].value)
-			lws_free_set_NULL(dyn->entries[new_index].value);
-		dyn->entries[new_index].value =
-				lws_malloc(len + 1, "hpack dyn");
-		if (!dyn->entries[new_index].value)
+	need = dyn->arena_used + vlen;
+	if (need > dyn->arena_len) {
+		/*
+		 * The eviction above means we never need more than about the
+		 * table size, except for a single huge header
+		 */
+		a = dyn->arena_len ? dyn->arena_len * 2 : 256;
+		if (a > dyn->virtual_payload_max + 1024)
+			a = dyn->virtual_payload_max + 1024;
+		if (a < need)
+			a = need;
+		if (lws_dynamic_arena_resize(dyn, a))
 			return 1;
+	}
 
-		memcpy(dyn->entries[new_index].value, arg, len);
-		dyn->entries[new_index].value[len] = '\0';
-		dyn->entries[new_index].value_len = (uint16_t)len;
-	} else
-		dyn->entries[new_index].value = NULL;
+	e = &dyn->entries[new_index];
+	e->value_ofs = dyn->arena_tail;
+	e->value_len = (uint16_t)len;
+
+	if (vlen) {
+		a = dyn->arena_len - dyn->arena_tail;
+		if (a > vlen)
+			a = vlen;
+		memcpy(dyn->arena + dyn->arena_tail, arg, a);
+		if (vlen > a) /* wraps */
+			memcpy(dyn->arena, arg + a, vlen - a);
 
-	dyn->entries[new_index].lws_hdr_idx = (uint16_t)lws_hdr_index;
-	dyn->entries[new_index].hdr_len = (uint16_t)hdr_len;
+		dyn->arena_tail = (dyn->arena_tail + vlen) % dyn->arena_len;
+		dyn->arena_used += vlen;
+	}
+
+	if (dyn->used_entries < dyn->num_entries)
+		dyn->used_entries++;
+
+	e->lws_hdr_idx = (uint16_t)lws_hdr_index;
+	e->hdr_len = (uint16_t)hdr_len;
 
 	dyn->virtual_payload_usage = (uint32_t)(dyn->virtual_payload_usage +
 					(unsigned int)hdr_len + len);
 
-	lwsl_info("%s: index %ld: lws_hdr_index 0x%x, hdr len %d, '%s' len %d\n",
+	lwsl_info("%s: index %ld: lws_hdr_index 0x%x, hdr len %d, '%.*s' len %d\n",
 		  __func__, (long)LWS_ARRAY_SIZE(static_token),
-		  lws_hdr_index, hdr_len, dyn->entries[new_index].value ?
-				 dyn->entries[new_index].value : "null", (int)len);
+		  lws_hdr_index, hdr_len, (int)vlen, vlen ? arg : "", (int)len);
 
 	dyn->pos = (uint16_t)lws_safe_modulo(dyn->pos + 1, dyn->num_entries);
 
@@ -571,6 +626,7 @@ lws_hpack_dynamic_size(struct lws *wsi, int size)
 	struct hpack_dt_entry *dte;
 	struct lws *nwsi;
 	int min, n = 0, m;
+	uint32_t a;
 
 	/*
 	 * "size" here is coming from the http/2 SETTING
@@ -598,8 +654,9 @@ lws_hpack_dynamic_size(struct lws *wsi, int size)
 		  (unsigned int)nwsi->a.vhost->h2.set.s[H2SET_HEADER_TABLE_SIZE]);
 
 	if (!size) {
+		/* the peer emptied its table */
 		size = dyn->num_entries * 8;
-		lws_hpack_destroy_dynamic_header(wsi);
+		lws_hpack_destroy_dynamic_header(nwsi);
 	}
 
 	if (size > (int)nwsi->a.vhost->h2.set.s[H2SET_HEADER_TABLE_SIZE]) {
@@ -621,15 +678,23 @@ lws_hpack_dynamic_size(struct lws *wsi, int size)
 	dyn->virtual_payload_max = (uint32_t)size;
 
 	size = size / 8;
-	min = size;
-	if (min > dyn->used_entries)
-		min = dyn->used_entries;
+
+	/* the oldest entries go first, whether it's for space or count */
+
+	while (dyn->used_entries &&
+	       ((dyn->virtual_payload_usage &&
+	         dyn->virtual_payload_usage > dyn->virtual_payload_max) ||
+		dyn->used_entries > size)) {
+		n = lws_safe_modulo(dyn->pos - dyn->used_entries, dyn->num_entries);
+		if (n < 0)
+			n += dyn->num_entries;
+		lws_dynamic_free(dyn, n);
+	}
 
 	if (size == dyn->num_entries)
 		return 0;
 
-	if (dyn->num_entries < min)
-		min = dyn->num_entries;
+	min = dyn->used_entries;
 
 	// lwsl_notice("dte requested size %d\n", size);
 
@@ -637,17 +702,6 @@ lws_hpack_dynamic_size(struct lws *wsi, int size)
 	if (!dte)
 		goto bail;
 
-	while (dyn->virtual_payload_usage && dyn->used_entries &&
-	       dyn->virtual_payload_usage > dyn->virtual_payload_max) {
-		n = lws_safe_modulo(dyn->pos - dyn->used_entries, dyn->num_entries);
-		if (n < 0)
-			n += dyn->num_entries;
-		lws_dynamic_free(dyn, n);
-	}
-
-	if (min > dyn->used_entries)
-		min = dyn->used_entries;
-
 	if (dyn->entries) {
 		for (n = 0; n < min; n++) {
 			m = (dyn->pos - dyn->used_entries + n) %
@@ -668,6 +722,16 @@ lws_hpack_dynamic_size(struct lws *wsi, int size)
 	else
 		dyn->pos = 0;
 
+	/* no need to keep more arena than the new size can use */
+
+	a = dyn->arena_len;
+	if (a > dyn->virtual_payload_max + 1024)
+		a = dyn->virtual_payload_max + 1024;
+	if (a < dyn->arena_used)
+		a = dyn->arena_used;
+	if (a != dyn->arena_len && lws_dynamic_arena_resize(dyn, a))
+		goto bail;
+
 	lws_h2_dynamic_table_dump(wsi);
 
 	return 0;
@@ -682,30 +746,27 @@ void
 lws_hpack_destroy_dynamic_header(struct lws *wsi)
 {
 	struct hpack_dynamic_table *dyn;
-	int n;
 
 	if (!wsi->h2.h2n)
 		return;
 
 	dyn = &wsi->h2.h2n->hpack_dyn_table;
 
-	if (!dyn->entries)
-		return;
-
-	for (n = 0; n < dyn->num_entries; n++)
-		if (dyn->entries[n].value)
-			lws_free_set_NULL(dyn->entries[n].value);
-
 	lws_free_set_NULL(dyn->entries);
+	lws_free_set_NULL(dyn->arena);
+	dyn->arena_len = dyn->arena_used = dyn->arena_tail = 0;
+	dyn->virtual_payload_usage = 0;
+	dyn->num_entries = dyn->used_entries = dyn->pos = 0;
 }
 
 static int
 lws_hpack_use_idx_hdr(struct lws *wsi, int idx, int known_token)
 {
-	const char *arg = NULL;
-	int len = 0;
+	const struct hpack_dt_entry *dte = NULL;
+	struct hpack_dynamic_table *dyn;
 	const char *p = NULL;
-	int tok = lws_token_from_index(wsi, idx, &arg, &len, NULL);
+	uint32_t o, n;
+	int tok = lws_token_from_index(wsi, idx, &dte, NULL);
 
 	if (tok == LWS_HPACK_IGNORE_ENTRY) {
 		lwsl_header("%s: lws_token says ignore, returning\n", __func__);
@@ -717,12 +778,11 @@ lws_hpack_use_idx_hdr(struct lws *wsi, int idx, int known_token)
 		return 1;
 	}
 
-	if (arg) {
+	if (dte) {
 		/* dynamic result */
 		if (known_token > 0)
 			tok = known_token;
-		lwsl_header("%s: dyn: idx %d '%s' tok %d\n", __func__, idx, arg,
-			   tok);
+		lwsl_header("%s: dyn: idx %d tok %d\n", __func__, idx, tok);
 	} else
 		lwsl_header("writing indexed hdr %d (tok %d '%s')\n", idx, tok,
 				lws_token_to_string((enum lws_token_indexes)tok));
@@ -730,9 +790,6 @@ lws_hpack_use_idx_hdr(struct lws *wsi, int idx, int known_token)
 	if (tok == LWS_HPACK_IGNORE_ENTRY)
 		return 0;
 
-	if (arg)
-		p = arg;
-
 	if (idx < (int)LWS_ARRAY_SIZE(http2_canned))
 		p = http2_canned[idx];
 
@@ -740,10 +797,21 @@ lws_hpack_use_idx_hdr(struct lws *wsi, int idx, int known_token)
 		return 1;
 
 	if (p)
-		while (*p && len--)
+		while (*p)
 			if (lws_frag_append(wsi, (unsigned char)*p++))
 				return 1;
 
+	if (dte) {
+		dyn = &lws_get_network_wsi(wsi)->h2.h2n->hpack_dyn_table;
+		o = dte->value_ofs;
+		for (n = 0; n < dte->value_len; n++) {
+			if (lws_frag_append(wsi, (unsigned char)dyn->arena[o]))
+				return 1;
+			if (++o == dyn->arena_len)
+				o = 0;
+		}
+	}
+
 	if (lws_frag_end(wsi))
 		return 1;
 
@@ -826,7 +894,7 @@ int lws_hpack_interpret(struct lws *wsi, unsigned char c)
 	struct lws *nwsi = lws_get_network_wsi(wsi);
 	struct lws_h2_netconn *h2n = nwsi->h2.h2n;
 	struct allocated_headers *ah = wsi->http.ah;
-	unsigned int prev;
+	const struct lws_huf_dec *hd;
 	unsigned char c1;
 	int n, m, plen;
 
@@ -846,8 +914,6 @@ int lws_hpack_interpret(struct lws *wsi, unsigned char c)
 
 	case HPKS_TYPE:
 		h2n->is_first_header_char = 1;
-		h2n->huff_pad = 0;
-		h2n->zero_huff_padding = 0;
 		h2n->last_action_dyntable_resize = 0;
 		h2n->ext_count = 0;
 		h2n->hpack_hdr_len = 0;
@@ -874,7 +940,7 @@ int lws_hpack_interpret(struct lws *wsi, unsigned char c)
 			}
 
 			m = lws_token_from_index(wsi, (int)h2n->hdr_idx,
-						 NULL, NULL, NULL);
+						 NULL, NULL);
 			if (lws_hpack_handle_pseudo_rules(nwsi, wsi, m))
 				return 1;
 
@@ -1028,6 +1094,7 @@ int lws_hpack_interpret(struct lws *wsi, unsigned char c)
 	case HPKS_HLEN: /* [ H | 7+ ] */
 		h2n->huff = !!(c & 0x80);
 		h2n->hpack_pos = 0;
+		h2n->huff_pad_ok = 1;
 		h2n->hpack_len = c & 0x7f;
 
 		if (h2n->hpack_len == 0x7f) {
@@ -1064,7 +1131,7 @@ pre_data:
 				h2n->hdr_idx = 1;
 		} else {
 			n = lws_token_from_index(wsi, (int)h2n->hdr_idx, NULL,
-						 NULL, NULL);
+						 NULL);
 			lwsl_header("  lws_tok_from_idx(%u) says %d\n",
 				   (unsigned int)h2n->hdr_idx, n);
 		}
@@ -1108,37 +1175,33 @@ pre_data:
 		//lwsl_header(" 0x%02X huff %d\n", c, h2n->huff);
 			c1 = c;
 
-		for (n = 0; n < 8; n++) {
+		for (n = 0; n < 2; n++) {
 			if (h2n->huff) {
-				char b = (c >> 7) & 1;
-				prev = h2n->hpack_pos;
-				h2n->hpack_pos = (uint16_t)huftable_decode(
-						(int)h2n->hpack_pos, b);
-				c = (unsigned char)(c << 1);
-				if (h2n->hpack_pos == 0xffff) {
-					lwsl_notice("Huffman err\n");
-					return 1;
-				}
-				if (!(h2n->hpack_pos & 0x8000)) {
-					if (!b)
-						h2n->zero_huff_padding = 1;
-					h2n->huff_pad++;
-					continue;
-				}
-				c1 = (uint8_t)(h2n->hpack_pos & 0x7fff);
-				h2n->hpack_pos = 0;
-				h2n->huff_pad = 0;
-				h2n->zero_huff_padding = 0;
+				/*
+				 * A nibble at a time, see minihuf.c... codes
+				 * are at least 5 bits, so each nibble
+				 * completes one octet at most
+				 */
+				hd = &huftable_dec[h2n->hpack_pos]
+						  [n ? c & 0xf : c >> 4];
 
 				/* EOS |11111111|11111111|11111111|111111 */
-				if (!c1 && prev == HUFTABLE_0x100_PREV) {
+				if (hd->flags & HUF_DEC_FAIL) {
 					lws_h2_goaway(nwsi,
 						H2_ERR_COMPRESSION_ERROR,
 						"Huffman EOT seen");
 					return 1;
 				}
+
+				h2n->hpack_pos = hd->state;
+				h2n->huff_pad_ok = !!(hd->flags &
+						      HUF_DEC_ACCEPT);
+				if (!(hd->flags & HUF_DEC_SYM))
+					continue;
+
+				c1 = hd->sym;
 			} else
-				n = 8;
+				n = 2;
 
 			if (h2n->value) { /* value */
 
@@ -1213,10 +1276,9 @@ swallow:
 		 * is complete.
 		 */
 
-		if (h2n->huff && (h2n->huff_pad > 7 ||
-		    (h2n->zero_huff_padding && h2n->huff_pad))) {
-			lwsl_info("zero_huff_padding: %d huff_pad: %d\n",
-				    h2n->zero_huff_padding, h2n->huff_pad);
+		if (h2n->huff && !h2n->huff_pad_ok) {
+			lwsl_info("%s: huffman state %d at end\n", __func__,
+				  h2n->hpack_pos);
 			lws_h2_goaway(nwsi, H2_ERR_COMPRESSION_ERROR,
 				      "Huffman padding excessive or wrong");
 			return 1;
@@ -1253,8 +1315,6 @@ fin:
 		if (!h2n->value) {
 			h2n->value = 1;
 			h2n->hpack = HPKS_HLEN;
-			h2n->huff_pad = 0;
-			h2n->zero_huff_padding = 0;
 			h2n->ext_count = 0;
 			break;
 		}
@@ -1271,7 +1331,7 @@ fin:
 		/* NEW indexed hdr with value */
 		case HPKT_INDEXED_HDR_6_VALUE_INCR:
 			/* header length is determined by known index */
-			m = lws_token_from_index(wsi, (int)h2n->hdr_idx, NULL, NULL,
+			m = lws_token_from_index(wsi, (int)h2n->hdr_idx, NULL,
 					&h2n->hpack_hdr_len);
 			if (m < 0)
 				/*
@@ -1336,7 +1396,7 @@ add_it:
 					m = -1;
 			} else
 				m = lws_token_from_index(wsi, (int)h2n->hdr_idx,
-							 NULL, NULL, NULL);
+							 NULL, NULL);
 		}
 
 		if (m != -1 && m != LWS_HPACK_IGNORE_ENTRY)
@@ -1389,6 +1449,473 @@ lws_h2_num(int starting_bits, unsigned long num,
 	return 0;
 }
 
+/*
+ * Header fields whose values are different nearly every time, that would
+ * only push useful things out of the peer's dynamic table
+ */
+
+static const unsigned char enc_no_index[] = {
+	WSI_TOKEN_HTTP_COLON_PATH,
+	WSI_TOKEN_HTTP_CONTENT_LENGTH,
+	WSI_TOKEN_HTTP_CONTENT_RANGE,
+	WSI_TOKEN_HTTP_DATE,
+	WSI_TOKEN_HTTP_ETAG,
+	WSI_TOKEN_HTTP_EXPIRES,
+	WSI_TOKEN_HTTP_LAST_MODIFIED,
+	WSI_TOKEN_HTTP_AGE,
+	WSI_TOKEN_HTTP_IF_MODIFIED_SINCE,
+	WSI_TOKEN_HTTP_IF_NONE_MATCH,
+};
+
+/* ... and ones that must never be indexed by anybody, RFC7541 7.1.3 */
+
+static const unsigned char enc_never_index[] = {
+	WSI_TOKEN_HTTP_AUTHORIZATION,
+	WSI_TOKEN_HTTP_PROXY_AUTHORIZATION,
+	WSI_TOKEN_HTTP_COOKIE,
+	WSI_TOKEN_HTTP_SET_COOKIE,
+};
+
+static int
+lws_hpack_tok_in(const unsigned char *list, size_t count, int tok)
+{
+	size_t n;
+
+	for (n = 0; n < count; n++)
+		if (list[n] == tok)
+			return 1;
+
+	return 0;
+}
+
+/* the lws token for a header name, or -1 */
+
+static int
+lws_hpack_name_to_token(const unsigned char *name, size_t len)
+{
+	const unsigned char *s;
+	int n;
+
+	for (n = 0; n < WSI_TOKEN_COUNT; n++) {
+		s = lws_token_to_string((enum lws_token_indexes)n);
+		if (s && !strncasecmp((const char *)s, (const char *)name, len) &&
+		    (!s[len] || (s[len] == ':' && !s[len + 1])))
+			return n;
+	}
+
+	return -1;
+}
+
+static size_t
+lws_hpack_huf_len(const unsigned char *s, size_t len, int lc)
+{
+	size_t bits = 0;
+
+	for (; len; len--, s++)
+		bits += huftable_enc[lc ? tolower((int)*s) : *s].len;
+
+	return (bits + 7) / 8;
+}
+
+/*
+ * Emit a string literal, Huffman-coded if that's shorter, optionally
+ * converting to lower case on the way (for header names)
+ */
+
+static int
+lws_hpack_str(const unsigned char *s, size_t len, int lc,
+	      unsigned char **p, unsigned char *end)
+{
+	size_t hl = lws_hpack_huf_len(s, len, lc);
+	uint64_t acc = 0;
+	unsigned int c;
+	int bits = 0;
+
+	if (hl >= len) {
+		*((*p)++) = (uint8_t)lws_h2_num_start(7, len);
+		if (lws_h2_num(7, len, p, end) || end - *p < (int)len)
+			return 1;
+		for (; len; len--, s++)
+			*((*p)++) = (uint8_t)(lc ? tolower((int)*s) : *s);
+
+		return 0;
+	}
+
+	*((*p)++) = (uint8_t)(0x80 | lws_h2_num_start(7, hl));
+	if (lws_h2_num(7, hl, p, end) || end - *p < (int)hl)
+		return 1;
+
+	for (; len; len--, s++) {
+		c = lc ? (unsigned int)tolower((int)*s) : *s;
+		acc = (acc << huftable_enc[c].len) | huftable_enc[c].code;
+		bits += huftable_enc[c].len;
+		while (bits >= 8) {
+			bits -= 8;
+			*((*p)++) = (uint8_t)(acc >> bits);
+		}
+		acc &= (1ull << bits) - 1;
+	}
+
+	/* pad with the start of EOS, ie, 1s */
+	if (bits)
+		*((*p)++) = (uint8_t)((acc << (8 - bits)) | (0xffu >> bits));
+
+	return 0;
+}
+
+static void
+lws_hpack_enc_free_slots(struct hpack_enc_table *e, uint16_t from,
+			 unsigned int count)
+{
+	while (count--) {
+		lws_free_set_NULL(e->ring[from].nv);
+		from = (uint16_t)((from + 1) % e->ring_len);
+	}
+}
+
+static void
+lws_hpack_enc_evict(struct hpack_enc_table *e, uint32_t limit)
+{
+	struct hpack_enc_entry *ee;
+
+	/* the strings are freed when the block is committed */
+
+	while (e->count && e->size > limit) {
+		ee = &e->ring[e->head];
+		e->size -= (uint32_t)(ee->name_len + ee->value_len + 32);
+		e->head = (uint16_t)((e->head + 1) % e->ring_len);
+		e->count--;
+	}
+}
+
+static void
+lws_hpack_enc_init(struct hpack_enc_table *e)
+{
+	if (e->inited)
+		return;
+
+	e->max = e->peer_max = e->peer_min = LWS_H2_HPACK_ENC_TABLE_MAX;
+	e->inited = 1;
+}
+
+static void
+lws_hpack_enc_rollback(struct hpack_enc_table *e)
+{
+	lwsl_info("%s: abandoning %d inserts\n", __func__, e->inserts);
+
+	lws_hpack_enc_free_slots(e, (uint16_t)((e->c_head + e->c_count) %
+					       e->ring_len), e->inserts);
+	e->head = e->c_head;
+	e->count = e->c_count;
+	e->size = e->c_size;
+	e->max = e->c_max;
+	if (e->block_updated) {
+		/* the peer never saw it */
+		e->update = 1;
+		if (e->c_peer_min < e->peer_min)
+			e->peer_min = e->c_peer_min;
+	}
+	e->block_wsi = NULL;
+}
+
+void
+lws_hpack_enc_commit(struct lws *wsi)
+{
+	struct lws *nwsi = lws_get_network_wsi(wsi);
+	struct hpack_enc_table *e;
+
+	if (!nwsi->h2.h2n)
+		return;
+
+	e = &nwsi->h2.h2n->hpack_enc;
+	if (e->block_wsi != wsi)
+		return;
+
+	/* what the block evicted is gone for good now */
+
+	lws_hpack_enc_free_slots(e, e->c_head, (unsigned int)(e->c_count +
+					       e->inserts - e->count));
+	e->block_wsi = NULL;
+}
+
+void
+lws_hpack_enc_peer_table_size(struct lws *nwsi, uint32_t size)
+{
+	struct hpack_enc_table *e;
+
+	if (!nwsi->h2.h2n)
+		return;
+
+	e = &nwsi->h2.h2n->hpack_enc;
+	lws_hpack_enc_init(e);
+
+	if (size > LWS_H2_HPACK_ENC_TABLE_MAX)
+		size = LWS_H2_HPACK_ENC_TABLE_MAX;
+	if (size < e->peer_min)
+		e->peer_min = size;
+	e->peer_max = size;
+
+	e->update = e->peer_min != e->max || e->peer_max != e->max;
+}
+
+void
+lws_hpack_enc_destroy(struct lws *wsi)
+{
+	struct hpack_enc_table *e;
+	struct lws *nwsi;
+	int n;
+
+	if (wsi->h2.h2n) {
+		e = &wsi->h2.h2n->hpack_enc;
+		if (e->ring) {
+			for (n = 0; n < e->ring_len; n++)
+				if (e->ring[n].nv)
+					lws_free(e->ring[n].nv);
+			lws_free_set_NULL(e->ring);
+		}
+		e->block_wsi = NULL;
+
+		return;
+	}
+
+	/* a stream going away before it wrote the block it was building */
+
+	nwsi = lws_get_network_wsi(wsi);
+	if (nwsi != wsi && nwsi->h2.h2n &&
+	    nwsi->h2.h2n->hpack_enc.block_wsi == wsi)
+		lws_hpack_enc_rollback(&nwsi->h2.h2n->hpack_enc);
+}
+
+static int
+lws_hpack_enc_size_update(uint32_t size, unsigned char **p, unsigned char *end)
+{
+	*((*p)++) = (uint8_t)(0x20 | lws_h2_num_start(5, size));
+
+	return lws_h2_num(5, size, p, end);
+}
+
+/*
+ * Find the encoder table for the block wsi is building, starting a new block
+ * if needed
+ */
+
+static struct hpack_enc_table *
+lws_hpack_enc_block(struct lws *wsi, int first, unsigned char **p,
+		    unsigned char *end)
+{
+	struct lws *nwsi = lws_get_network_wsi(wsi);
+	struct hpack_enc_table *e;
+
+	if (nwsi == wsi || !nwsi->h2.h2n)
+		return NULL;
+
+	e = &nwsi->h2.h2n->hpack_enc;
+	if (e->block_wsi == wsi && !first)
+		return e;
+
+	lws_hpack_enc_init(e);
+
+	if (e->block_wsi)
+		/* nobody is going to send that one */
+		lws_hpack_enc_rollback(e);
+
+	if (!e->ring) {
+		/*
+		 * Room for a full table, and for what one block can insert
+		 * before it is committed, each entry is at least 32
+		 */
+		e->ring_len = (2 * LWS_H2_HPACK_ENC_TABLE_MAX / 32) + 1;
+		e->ring = lws_zalloc(sizeof(*e->ring) * e->ring_len,
+				     "hpack enc");
+		if (!e->ring)
+			return NULL;
+	}
+
+	e->block_wsi = wsi;
+	e->c_head = e->head;
+	e->c_count = e->count;
+	e->c_size = e->size;
+	e->c_max = e->max;
+	e->c_peer_min = e->peer_min;
+	e->block_size = 0;
+	e->inserts = 0;
+	e->block_updated = 0;
+
+	if (!e->update)
+		return e;
+
+	/* RFC7541 4.2: if it went down in between, we must say so first */
+
+	if (e->peer_min < e->peer_max) {
+		if (lws_hpack_enc_size_update(e->peer_min, p, end))
+			return NULL;
+		lws_hpack_enc_evict(e, e->peer_min);
+	}
+	if (lws_hpack_enc_size_update(e->peer_max, p, end))
+		return NULL;
+	lws_hpack_enc_evict(e, e->peer_max);
+
+	e->max = e->peer_min = e->peer_max;
+	e->update = 0;
+	e->block_updated = 1;
+
+	return e;
+}
+
+/* HPACK index of a dynamic entry matching name and value, or name, or 0 */
+
+static int
+lws_hpack_enc_find(struct hpack_enc_table *e, const unsigned char *name,
+		   size_t nlen, const unsigned char *value, size_t vlen,
+		   int *name_idx)
+{
+	struct hpack_enc_entry *ee;
+	int n;
+
+	for (n = 0; n < e->count; n++) {
+		ee = &e->ring[(e->head + e->count - 1 - n) % e->ring_len];
+		if (ee->name_len != nlen ||
+		    strncasecmp(ee->nv, (const char *)name, nlen))
+			continue;
+
+		if (ee->value_len == vlen &&
+		    !memcmp(ee->nv + nlen, value, vlen))
+			return (int)LWS_ARRAY_SIZE(static_token) + n;
+
+		if (!*name_idx)
+			*name_idx = (int)LWS_ARRAY_SIZE(static_token) + n;
+	}
+
+	return 0;
+}
+
+static int
+lws_hpack_enc_insert(struct hpack_enc_table *e, const unsigned char *name,
+		     size_t nlen, const unsigned char *value, size_t vlen)
+{
+	uint32_t es = (uint32_t)(nlen + vlen + 32);
+	struct hpack_enc_entry *ee;
+	char *nv;
+	size_t n;
+
+	/* a block can't insert more than it can roll back */
+
+	if (es > e->max || e->block_size + es > e->max)
+		return 1;
+
+	nv = lws_malloc(nlen + vlen + 1, "hpack enc");
+	if (!nv)
+		return 1;
+
+	for (n = 0; n < nlen; n++)
+		nv[n] = (char)tolower((int)name[n]);
+	memcpy(nv + nlen, value, vlen);
+
+	lws_hpack_enc_evict(e, e->max - es);
+
+	ee = &e->ring[(e->head + e->count) % e->ring_len];
+	ee->nv = nv;
+	ee->name_len = (uint16_t)nlen;
+	ee->value_len = (uint16_t)vlen;
+
+	e->count++;
+	e->size += es;
+	e->block_size += es;
+	e->inserts++;
+
+	return 0;
+}
+
+/*
+ * tok is the lws token for name, or -1.  name is not NUL-terminated.
+ *
+ * If value is NULL, the caller is going to fill in length bytes of value
+ * after us, so it goes out literally and unindexed.
+ */
+
+static int
+lws_hpack_enc_field(struct lws *wsi, int tok, const unsigned char *name,
+		    size_t nlen, const unsigned char *value, int length,
+		    unsigned char **p, unsigned char *end)
+{
+	struct hpack_enc_table *e;
+	int n, idx = 0, nidx = 0;
+	size_t vlen = (size_t)length;
+
+	if (end - *p < (int)nlen + length + 24)
+		return 1;
+
+	e = lws_hpack_enc_block(wsi, tok == WSI_TOKEN_HTTP_COLON_STATUS ||
+				     tok == WSI_TOKEN_HTTP_COLON_METHOD, p, end);
+
+	/* the static table */
+
+	for (n = 1; n < (int)LWS_ARRAY_SIZE(static_token); n++) {
+		if (static_hdr_len[n] != nlen ||
+		    strncasecmp((const char *)lws_token_to_string(
+				(enum lws_token_indexes)static_token[n]),
+				(const char *)name, nlen))
+			continue;
+		if (!nidx)
+			nidx = n;
+		if (value && n < (int)LWS_ARRAY_SIZE(http2_canned) &&
+		    strlen(http2_canned[n]) == vlen && vlen &&
+		    !memcmp(http2_canned[n], value, vlen)) {
+			idx = n;
+			break;
+		}
+	}
+
+	if (!idx && e && value)
+		idx = lws_hpack_enc_find(e, name, nlen, value, vlen, &nidx);
+
+	if (idx) {
+		*((*p)++) = (uint8_t)(0x80 | lws_h2_num_start(7, (unsigned int)idx));
+
+		return lws_h2_num(7, (unsigned int)idx, p, end);
+	}
+
+	if (!value) {
+		*((*p)++) = (uint8_t)lws_h2_num_start(4, (unsigned int)nidx);
+		if (lws_h2_num(4, (unsigned int)nidx, p, end))
+			return 1;
+		if (!nidx && lws_hpack_str(name, nlen, 1, p, end))
+			return 1;
+
+		*((*p)++) = (uint8_t)lws_h2_num_start(7, vlen); /* non-HUF */
+		if (lws_h2_num(7, vlen, p, end))
+			return 1;
+		*p += length;
+
+		return 0;
+	}
+
+	/*
+	 * Names lws doesn't know are not indexed, since an lws peer can't
+	 * recover them from its dynamic table
+	 */
+
+	if (lws_hpack_tok_in(enc_never_index, sizeof(enc_never_index), tok)) {
+		*((*p)++) = (uint8_t)(0x10 | lws_h2_num_start(4, (unsigned int)nidx));
+		n = lws_h2_num(4, (unsigned int)nidx, p, end);
+	} else
+		if (e && tok >= 0 && !lws_hpack_tok_in(enc_no_index,
+					sizeof(enc_no_index), tok) &&
+		    !lws_hpack_enc_insert(e, name, nlen, value, vlen)) {
+			*((*p)++) = (uint8_t)(0x40 |
+				    lws_h2_num_start(6, (unsigned int)nidx));
+			n = lws_h2_num(6, (unsigned int)nidx, p, end);
+		} else {
+			*((*p)++) = (uint8_t)lws_h2_num_start(4, (unsigned int)nidx);
+			n = lws_h2_num(4, (unsigned int)nidx, p, end);
+		}
+
+	if (n || (!nidx && lws_hpack_str(name, nlen, 1, p, end)))
+		return 1;
+
+	return lws_hpack_str(value, vlen, 0, p, end);
+}
+
 int lws_add_http2_header_by_name(struct lws *wsi, const unsigned char *name,
 				 const unsigned char *value, int length,
 				 unsigned char **p, unsigned char *end)
@@ -1421,30 +1948,14 @@ int lws_add_http2_header_by_name(struct lws *wsi, const unsigned char *name,
 		return 0;
 	}
 
-	if (end - *p < len + length + 8)
-		return 1;
-
-	*((*p)++) = 0; /* literal hdr, literal name,  */
-
-	*((*p)++) = (uint8_t)(0 | (uint8_t)lws_h2_num_start(7, (unsigned long)len)); /* non-HUF */
-	if (lws_h2_num(7, (unsigned long)len, p, end))
-		return 1;
-
-	/* upper-case header names are verboten in h2, but OK on h1, so
-	 * they're not illegal per se.  Silently convert them for h2... */
-
-	while(len--)
-		*((*p)++) = (uint8_t)tolower((int)*name++);
-
-	*((*p)++) = (uint8_t)(0 | (uint8_t)lws_h2_num_start(7, (unsigned long)length)); /* non-HUF */
-	if (lws_h2_num(7, (unsigned long)length, p, end))
-		return 1;
-
-	if (value)
-		memcpy(*p, value, (unsigned int)length);
-	*p += length;
+	/*
+	 * upper-case header names are verboten in h2, but OK on h1, so
+	 * they're not illegal per se.  Silently convert them for h2...
+	 */
 
-	return 0;
+	return lws_hpack_enc_field(wsi, lws_hpack_name_to_token(name,
+				   (size_t)len), name, (size_t)len, value,
+				   length, p, end);
 }
 
 int lws_add_http2_header_by_token(struct lws *wsi, enum lws_token_indexes token,
@@ -1452,12 +1963,24 @@ int lws_add_http2_header_by_token(struct lws *wsi, enum lws_token_indexes token,
 				  unsigned char **p, unsigned char *end)
 {
 	const unsigned char *name;
+	size_t len;
 
 	name = lws_token_to_string(token);
 	if (!name)
 		return 1;
 
-	return lws_add_http2_header_by_name(wsi, name, value, length, p, end);
+	len = strlen((const char *)name);
+	if (len && name[len - 1] == ':')
+		len--;
+
+	if (wsi->mux_substream && token == WSI_TOKEN_HTTP_TRANSFER_ENCODING) {
+		lwsl_header("rejecting %s\n", name);
+
+		return 0;
+	}
+
+	return lws_hpack_enc_field(wsi, (int)token, name, len, value, length,
+				   p, end);
 }
 
 int lws_add_http2_header_status(struct lws *wsi, unsigned int code,
@@ -121,9 +121,11 @@ lws_h2_dump_settings(struct http2_settings *set)
 #endif
 
 struct lws_h2_protocol_send *
-lws_h2_new_pps(enum lws_h2_protocol_send_type type)
+lws_h2_new_pps(struct lws *wsi, enum lws_h2_protocol_send_type type)
 {
-	struct lws_h2_protocol_send *pps = lws_malloc(sizeof(*pps), "pps");
+	struct lws_h2_protocol_send *pps = lws_slab_zalloc(
+				&wsi->a.context->pt[(int)wsi->tsi],
+				LWS_SLAB_H2_PPS, sizeof(*pps));
 
 	if (pps)
 		pps->type = type;
@@ -167,7 +169,7 @@ lws_h2_update_peer_txcredit(struct lws *wsi, unsigned int sid, int bump)
 	lwsl_info("%s: sid %d: bump %d -> %d\n", __func__, sid, bump,
 			(int)wsi->txc.peer_tx_cr_est + bump);
 
-	pps = lws_h2_new_pps(LWS_H2_PPS_UPDATE_WINDOW);
+	pps = lws_h2_new_pps(wsi, LWS_H2_PPS_UPDATE_WINDOW);
 	if (!pps)
 		return 1;
 
@@ -179,7 +181,7 @@ lws_h2_update_peer_txcredit(struct lws *wsi, unsigned int sid, int bump)
 
 	lws_pps_schedule(wsi, pps);
 
-	pps = lws_h2_new_pps(LWS_H2_PPS_UPDATE_WINDOW);
+	pps = lws_h2_new_pps(wsi, LWS_H2_PPS_UPDATE_WINDOW);
 	if (!pps)
 		return 1;
 
@@ -280,6 +282,7 @@ __lws_wsi_server_new(struct lws_vhost *vh, struct lws *parent_wsi,
 
 	wsi->mux_substream = 1;
 	wsi->seen_nonpseudoheader = 0;
+	lws_h2_sched_init(wsi);
 
 	wsi->txc.tx_cr = (int32_t)nwsi->h2.h2n->peer_set.s[H2SET_INITIAL_WINDOW_SIZE];
 	wsi->txc.peer_tx_cr_est =
@@ -317,7 +320,7 @@ bail1:
 		lws_free_set_NULL(wsi->user_space);
 	vh->protocols[0].callback(wsi, LWS_CALLBACK_WSI_DESTROY, NULL, NULL, 0);
 	__lws_vhost_unbind_wsi(wsi);
-	lws_free(wsi);
+	lws_slab_free(wsi);
 
 	return NULL;
 }
@@ -341,6 +344,7 @@ lws_wsi_h2_adopt(struct lws *parent_wsi, struct lws *wsi)
 	wsi->client_mux_substream = 1;
 #endif
 	wsi->h2.initialized = 1;
+	lws_h2_sched_init(wsi);
 
 #if 0
 	/* only assign sid at header send time when we know it */
@@ -379,7 +383,7 @@ bail1:
 	if (wsi->user_space)
 		lws_free_set_NULL(wsi->user_space);
 	wsi->a.protocol->callback(wsi, LWS_CALLBACK_WSI_DESTROY, NULL, NULL, 0);
-	lws_free(wsi);
+	lws_slab_free(wsi);
 
 	return NULL;
 }
@@ -416,7 +420,7 @@ lws_h2_issue_preface(struct lws *wsi)
 	/*
 	 * we must send a settings frame
 	 */
-	pps = lws_h2_new_pps(LWS_H2_PPS_MY_SETTINGS);
+	pps = lws_h2_new_pps(wsi, LWS_H2_PPS_MY_SETTINGS);
 	if (!pps)
 		return 1;
 	lws_pps_schedule(wsi, pps);
@@ -433,7 +437,7 @@ lws_pps_schedule(struct lws *wsi, struct lws_h2_protocol_send *pps)
 
 	if (!h2n) {
 		lwsl_warn("%s: null h2n\n", __func__);
-		lws_free(pps);
+		lws_slab_free(pps);
 		return;
 	}
 
@@ -453,7 +457,7 @@ lws_h2_goaway(struct lws *wsi, uint32_t err, const char *reason)
 	if (h2n->type == LWS_H2_FRAME_TYPE_COUNT)
 		return 0;
 
-	pps = lws_h2_new_pps(LWS_H2_PPS_GOAWAY);
+	pps = lws_h2_new_pps(wsi, LWS_H2_PPS_GOAWAY);
 	if (!pps)
 		return 1;
 
@@ -482,7 +486,7 @@ lws_h2_rst_stream(struct lws *wsi, uint32_t err, const char *reason)
 	if (!wsi->h2_stream_carries_ws && h2n->type == LWS_H2_FRAME_TYPE_COUNT)
 		return 0;
 
-	pps = lws_h2_new_pps(LWS_H2_PPS_RST_STREAM);
+	pps = lws_h2_new_pps(wsi, LWS_H2_PPS_RST_STREAM);
 	if (!pps)
 		return 1;
 
@@ -521,6 +525,8 @@ lws_h2_settings(struct lws *wsi, struct http2_settings *settings,
 
 		switch (a) {
 		case H2SET_HEADER_TABLE_SIZE:
+			/* the size our encoder may use for its dynamic table */
+			lws_hpack_enc_peer_table_size(nwsi, b);
 			break;
 		case H2SET_ENABLE_PUSH:
 			if (b > 1) {
@@ -656,8 +662,81 @@ lws_h2_tx_cr_consume(struct lws *wsi, int consumed)
 
 	wsi->txc.tx_cr -= consumed;
 
-	if (nwsi != wsi)
+	if (nwsi != wsi) {
 		nwsi->txc.tx_cr -= consumed;
+
+		/* the less weight, the faster the stream uses up its share */
+		if (consumed > 0 && wsi->h2.sched_weight)
+			wsi->h2.sched_vt += ((uint64_t)consumed << 8) /
+					    wsi->h2.sched_weight;
+	}
+}
+
+/*
+ * Streams start out with the RFC9218 default urgency and the RFC7540 default
+ * weight.  RFC9218 says non-incremental by default, but streams that said
+ * nothing about their priority have always shared the connection in turn,
+ * so we keep that.
+ */
+
+void
+lws_h2_sched_init(struct lws *wsi)
+{
+	wsi->h2.sched_weight = 16;
+	wsi->h2.sched_urgency = 3;
+	wsi->h2.sched_incremental = 1;
+}
+
+/*
+ * Apply an RFC9218 priority field value, eg, "u=1, i".  It's a structured
+ * field dictionary, we only care about the u and i members and ignore the
+ * rest, along with any parameters.
+ */
+
+void
+lws_h2_sched_priority(struct lws *wsi, const char *p, size_t len)
+{
+	const char *end = p + len;
+
+	/* once there is a priority header, default is non-incremental */
+	wsi->h2.sched_incremental = 0;
+
+	while (p < end) {
+		char key;
+
+		while (p < end && (*p == ' ' || *p == '\t' || *p == ','))
+			p++;
+		if (p == end)
+			break;
+
+		key = *p++;
+		if ((key == 'u' || key == 'i') &&
+		    (p == end || *p == '=' || *p == ',' || *p == ';' ||
+		     *p == ' ')) {
+			if (key == 'u' && end - p >= 2 && p[0] == '=' &&
+			    p[1] >= '0' && p[1] <= '7' &&
+			    (end - p == 2 || p[2] == ',' || p[2] == ';' ||
+			     p[2] == ' '))
+				wsi->h2.sched_urgency = (uint8_t)(p[1] - '0');
+
+			if (key == 'i') {
+				if (p == end || *p != '=')
+					wsi->h2.sched_incremental = 1;
+				else
+					if (end - p >= 3 && p[1] == '?')
+						wsi->h2.sched_incremental =
+							p[2] == '1';
+			}
+		}
+
+		/* skip the rest of the member */
+		while (p < end && *p != ',')
+			p++;
+	}
+
+	lwsl_debug("%s: %s: urgency %d, incremental %d\n", __func__,
+		   lws_wsi_tag(wsi), wsi->h2.sched_urgency,
+		   wsi->h2.sched_incremental);
 }
 
 int lws_h2_frame_write(struct lws *wsi, int type, int flags,
@@ -943,12 +1022,12 @@ int lws_h2_do_pps_send(struct lws *wsi)
 		break;
 	}
 
-	lws_free(pps);
+	lws_slab_free(pps);
 
 	return 0;
 
 bail:
-	lws_free(pps);
+	lws_slab_free(pps);
 
 	return 1;
 }
@@ -1199,7 +1278,8 @@ lws_h2_parse_frame_header(struct lws *wsi)
 #endif
 					    !wsi->h2_acked_settings)) {
 
-				pps = lws_h2_new_pps(LWS_H2_PPS_ACK_SETTINGS);
+				pps = lws_h2_new_pps(wsi,
+							LWS_H2_PPS_ACK_SETTINGS);
 				if (!pps)
 					return 1;
 				lws_pps_schedule(wsi, pps);
@@ -1587,7 +1667,8 @@ lws_h2_parse_end_of_frame(struct lws *wsi)
 			if (!wsi->h2_acked_settings ||
 			    !(wsi->flags & LCCSCF_H2_QUIRK_NGHTTP2_END_STREAM)
 			) {
-				pps = lws_h2_new_pps(LWS_H2_PPS_ACK_SETTINGS);
+				pps = lws_h2_new_pps(wsi,
+							LWS_H2_PPS_ACK_SETTINGS);
 				if (!pps)
 					return 1;
 				lws_pps_schedule(wsi, pps);
@@ -1608,6 +1689,11 @@ lws_h2_parse_end_of_frame(struct lws *wsi)
 		if (!h2n->swsi)
 			break;
 
+		if (h2n->type == LWS_H2_FRAME_TYPE_HEADERS &&
+		    h2n->collected_priority)
+			h2n->swsi->h2.sched_weight =
+					(uint16_t)(h2n->weight_temp + 1);
+
 		/* service the http request itself */
 
 		if (h2n->last_action_dyntable_resize) {
@@ -1808,6 +1894,15 @@ lws_h2_parse_end_of_frame(struct lws *wsi)
 				break;
 			}
 
+		if (lws_hdr_total_length(h2n->swsi, WSI_TOKEN_HTTP_PRIORITY)) {
+			char pri[64];
+
+			n = lws_hdr_copy(h2n->swsi, pri, sizeof(pri),
+					 WSI_TOKEN_HTTP_PRIORITY);
+			if (n > 0)
+				lws_h2_sched_priority(h2n->swsi, pri, (size_t)n);
+		}
+
 		{
 			lwsl_debug("%s: setting DEF_ACT from 0x%x\n", __func__,
 				   (unsigned int)h2n->swsi->wsistate);
@@ -1881,7 +1976,7 @@ lws_h2_parse_end_of_frame(struct lws *wsi)
 		else {
 			/* they're sending us a ping request */
 			struct lws_h2_protocol_send *pps =
-					lws_h2_new_pps(LWS_H2_PPS_PONG);
+					lws_h2_new_pps(wsi, LWS_H2_PPS_PONG);
 			if (!pps)
 				return 1;
 
@@ -1986,6 +2081,16 @@ lws_h2_parse_end_of_frame(struct lws *wsi)
 			  (unsigned int)h2n->hpack_e_dep);
 		break;
 
+	case LWS_H2_FRAME_TYPE_PRIORITY:
+		/*
+		 * RFC9113 deprecated the dependency tree, we only take the
+		 * weight, which affects how incremental streams share
+		 */
+		if (h2n->swsi)
+			h2n->swsi->h2.sched_weight =
+					(uint16_t)(h2n->weight_temp + 1);
+		break;
+
 	case LWS_H2_FRAME_TYPE_COUNT: /* IGNORING FRAME */
 		break;
 	}
@@ -2044,7 +2149,7 @@ lws_h2_parser(struct lws *wsi, unsigned char *in, lws_filepos_t _inlen,
 			 * that must be the first thing sent by server
 			 * and the peer must send a SETTINGS with ACK flag...
 			 */
-			pps = lws_h2_new_pps(LWS_H2_PPS_MY_SETTINGS);
+			pps = lws_h2_new_pps(wsi, LWS_H2_PPS_MY_SETTINGS);
 			if (!pps)
 				goto fail;
 			lws_pps_schedule(wsi, pps);
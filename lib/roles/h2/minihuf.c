@@ -298,219 +298,251 @@ int code_bit(int idx, int bit)
 	return -1;
 }
 
-#include "huftable.h"
-
-#define PARALLEL 2
+/*
+ * The decode table we generate: for each state, ie, an internal node of the
+ * huffman tree, and each possible next 4 bits of input, the state we end up
+ * in and any octet that was completed on the way.  Codes are at least 5 bits,
+ * so at most one octet can complete per nibble.
+ */
 
-struct state {
-	int terminal;
-	int state[PARALLEL];
-	int bytepos;
+#define HUF_DEC_SYM	1 /* .sym was completed */
+#define HUF_DEC_ACCEPT	2 /* the input could end here, RFC7541 5.2 padding */
+#define HUF_DEC_FAIL	4 /* saw EOS */
 
-	int real_pos;
+struct node {
+	int child[2]; /* -1 = none yet */
+	int sym; /* -1 = internal node */
+	int id; /* decode state for internal nodes */
 };
 
-struct state state[2000];
-unsigned char terms[2000];
-int next = 1;
-
-int lextable_decode(int pos, char c)
-{
-	int q = pos + !!c;
-
-	if (lextable_terms[q >> 3] & (1 << (q & 7))) /* terminal */
-		return lextable[q] | 0x8000;
+static struct node node[600];
+static int nodes = 1;
 
-	return pos + (lextable[q] << 1);
-}
+#include "huftable.h"
 
-int main(void)
+static int
+add_code(int n)
 {
-	int n = 0;
-	int m = 0;
-	int prev;
-	char c;
-	int walk;
-	int saw;
-	int y;
-	int j;
-	int pos = 0;
-	int biggest = 0;
-	int fails = 0;
-
-	m = 0;
-	while (m < LWS_ARRAY_SIZE(state)) {
-		for (j = 0; j < PARALLEL; j++) {
-			state[m].state[j] = 0xffff;
-			state[m].terminal = 0;
+	int walk = 0, m, b;
+
+	for (m = 0; m < huf_literal[n].len; m++) {
+		b = code_bit(n, m);
+		if (node[walk].sym >= 0)
+			return 1; /* prefix of another code */
+		if (node[walk].child[b] < 0) {
+			node[walk].child[b] = nodes;
+			node[nodes].child[0] = node[nodes].child[1] = -1;
+			node[nodes].sym = -1;
+			nodes++;
 		}
-		m++;
+		walk = node[walk].child[b];
 	}
 
-	while (n < LWS_ARRAY_SIZE(huf_literal)) {
+	if (node[walk].child[0] >= 0 || node[walk].child[1] >= 0)
+		return 1;
 
-		m = 0;
-		walk = 0;
-		prev = 0;
+	node[walk].sym = n;
 
-		while (m < huf_literal[n].len) {
+	return 0;
+}
 
-			saw = 0;
-			if (state[walk].state[code_bit(n, m)] != 0xffff) {
-				/* exists -- go forward */
-				walk = state[walk].state[code_bit(n, m)];
-				goto again;
-			}
+#if defined(HUFTABLE_DEC_STATES)
 
-			/* something we didn't see before */
+/* decode a huffman string with the table from a previous run */
 
-			state[walk].state[code_bit(n, m)] = next;
-			walk = next++;
-again:
-			m++;
-		}
+static int
+test_decode(const unsigned char *in, int len, unsigned char *out)
+{
+	int state = 0, accept = 1, n, o = 0;
 
-		state[walk].terminal = n++;
-		state[walk].state[0] = 0; /* terminal marker */
-	}
+	for (n = 0; n < len * 2; n++) {
+		int nib = n & 1 ? in[n >> 1] & 0xf : in[n >> 1] >> 4;
 
-	walk = 0;
-	for (n = 0; n < next; n++) {
-		state[n].bytepos = walk;
-		walk += (2 * 2);
+		if (huftable_dec[state][nib].flags & HUF_DEC_FAIL)
+			return -1;
+		if (huftable_dec[state][nib].flags & HUF_DEC_SYM)
+			out[o++] = huftable_dec[state][nib].sym;
+		accept = !!(huftable_dec[state][nib].flags & HUF_DEC_ACCEPT);
+		state = huftable_dec[state][nib].state;
 	}
 
-	/* compute everyone's position first */
+	return accept ? o : -2;
+}
 
-	pos = 0;
-	walk = 0;
-	for (n = 0; n < next; n++) {
+static int
+test_encode(const unsigned char *in, int len, unsigned char *out)
+{
+	unsigned long long acc = 0;
+	int bits = 0, o = 0, n;
+
+	for (n = 0; n < len; n++) {
+		acc = (acc << huftable_enc[in[n]].len) | huftable_enc[in[n]].code;
+		bits += huftable_enc[in[n]].len;
+		while (bits >= 8) {
+			bits -= 8;
+			out[o++] = (unsigned char)(acc >> bits);
+		}
+	}
+	if (bits)
+		out[o++] = (unsigned char)((acc << (8 - bits)) | (0xff >> bits));
 
-		state[n].real_pos = pos;
+	return o;
+}
 
-		if (state[n].state[0]) /* nonterminal */
-			pos += 2;
+static int
+self_test(void)
+{
+	unsigned char in[64], enc[256], dec[64];
+	int n, m, len;
+
+	/* every octet by itself, and random strings */
+
+	for (n = 0; n < 256 + 10000; n++) {
+		if (n < 256) {
+			in[0] = (unsigned char)n;
+			len = 1;
+		} else {
+			len = rand() % (int)sizeof(in);
+			for (m = 0; m < len; m++)
+				in[m] = (unsigned char)rand();
+		}
 
-		walk ++;
+		m = test_decode(enc, test_encode(in, len, enc), dec);
+		if (m != len || memcmp(in, dec, (size_t)len)) {
+			fprintf(stderr, "decode failed %d: %d\n", n, m);
+			return 1;
+		}
 	}
 
-	fprintf(stdout, "static unsigned char lextable[] = {\n");
+	/* EOS must be refused, so must padding that is long or has a 0 */
 
-#define TERMINAL_MASK 0x8000
-
-	walk = 0;
-	pos = 0;
+	memset(enc, 0xff, 4);
+	if (test_decode(enc, 4, dec) != -1) {
+		fprintf(stderr, "EOS accepted\n");
+		return 1;
+	}
 
-	for (n = 0; n < next; n++) {
-		for (m = 0; m < 2; m++) {
-			saw = state[n].state[m];
+	in[0] = '0'; /* 00000 */
+	enc[0] = 0x07; /* '0' and 3 bits of good padding */
+	enc[1] = 0xff;
+	if (test_decode(enc, 1, dec) != 1 || test_decode(enc, 2, dec) != -2) {
+		fprintf(stderr, "padding checks failed\n");
+		return 1;
+	}
+	enc[0] = 0x06;
+	if (test_decode(enc, 1, dec) != -2) {
+		fprintf(stderr, "0 in padding accepted\n");
+		return 1;
+	}
 
-			if (saw == 0) { // c is a terminal then
-				m = 2;
-				continue;
-			}
-			if (!m)
-				fprintf(stdout, "/* pos %04x: %3d */ ",
-							  state[n].real_pos, n);
-			else
-				fprintf(stdout, "                    ");
-
-			if (saw == 0xffff) {
-				fprintf(stdout,
-				  "   0xff, 0xff, /* 0 = fail */\n                    ");
-				pos ++; /* fail */
-				fails++;
-				continue;
-			}
+	return 0;
+}
+#endif
 
-			if (state[saw].state[0] == 0) { /* points to terminal */
-				fprintf(stdout, "    /* terminal %d */ 0x%02X,\n",
-					state[saw].terminal,
-					state[saw].terminal & 0xff);
-				terms[(state[n].real_pos + m) >> 3] |=
-					1 << ((state[n].real_pos + m) & 7);
-				pos++;
-				walk++;
-				continue;
-			}
+int main(void)
+{
+	int n, m, b, walk, state, flags, sym, ones[8];
 
-			j = (state[saw].real_pos - q) >> 1;
+	node[0].child[0] = node[0].child[1] = -1;
+	node[0].sym = -1;
 
-			if (j > biggest)
-				biggest = j;
+	for (n = 0; n < (int)LWS_ARRAY_SIZE(huf_literal); n++)
+		if (add_code(n)) {
+			fprintf(stderr, "bad code for %d\n", n);
+			return 1;
+		}
 
-			if (j > 0xffff) {
-				fprintf(stderr,
-				  "Jump > 64K bytes ahead (%d to %d)\n",
-					state[n].real_pos, state[saw].real_pos);
-				return 1;
-			}
+	/* give the internal nodes state numbers, the root is 0 */
 
-			fprintf(stdout, "   /* %d */ 0x%02X  "
-				"/* (to 0x%04X state %3d) */,\n",
-				m,
-				j & 0xff,
-				state[saw].real_pos, saw);
-			pos++;
+	m = 0;
+	for (n = 0; n < nodes; n++)
+		if (node[n].sym < 0)
+			node[n].id = m++;
 
-			walk++;
-		}
+	if (m > 256) {
+		fprintf(stderr, "too many states: %d\n", m);
+		return 1;
 	}
 
-	fprintf(stdout, "/* total size %d bytes, biggest jump %d/256, fails=%d */\n};\n"
-			"\n static unsigned char lextable_terms[] = {\n",
-	 		pos, biggest, fails);
+	/* the nodes we can end on: up to 7 bits of 1s since the last octet */
 
-	for (n = 0; n < (walk + 7) / 8; n++) {
-		if (!(n & 7))
-			fprintf(stdout, "\n\t");
-		fprintf(stdout, "0x%02x, ", terms[n]);
+	walk = 0;
+	for (n = 0; n < 8; n++) {
+		ones[n] = walk;
+		walk = node[walk].child[1];
 	}
-	fprintf(stdout, "\n};\n");
-
-	/*
-	 * Try to parse every legal input string
-	 */
 
-	for (n = 0; n < LWS_ARRAY_SIZE(huf_literal); n++) {
-		walk = 0;
-		m = 0;
-		y = -1;
-
-		fprintf(stderr, "  trying %d\n", n);
+	fprintf(stdout, "/* generated by minihuf.c */\n\n"
+			"#define HUFTABLE_DEC_STATES %d\n\n"
+			"#define HUF_DEC_SYM\t%d\n"
+			"#define HUF_DEC_ACCEPT\t%d\n"
+			"#define HUF_DEC_FAIL\t%d\n\n"
+			"/*\n * huffman decode a nibble at a time: the state "
+			"after the next 4 bits of\n * input, and the octet "
+			"if one was completed on the way\n */\n\n"
+			"static const struct lws_huf_dec {\n\tunsigned char state;\n"
+			"\tunsigned char flags;\n\tunsigned char sym;\n"
+			"} huftable_dec[][16] = {\n", m,
+			HUF_DEC_SYM, HUF_DEC_ACCEPT, HUF_DEC_FAIL);
+
+	for (n = 0; n < nodes; n++) {
+		if (node[n].sym >= 0)
+			continue;
+
+		fprintf(stdout, "\t{ /* state %d */\n", node[n].id);
+
+		for (m = 0; m < 16; m++) {
+			walk = n;
+			flags = 0;
+			sym = 0;
+
+			for (b = 3; b >= 0; b--) {
+				walk = node[walk].child[(m >> b) & 1];
+				if (node[walk].sym < 0)
+					continue;
+				if (node[walk].sym == 256) {
+					flags = HUF_DEC_FAIL;
+					walk = 0;
+					break;
+				}
+				flags |= HUF_DEC_SYM;
+				sym = node[walk].sym;
+				walk = 0;
+			}
 
-		while (m < huf_literal[n].len) {
-			prev = walk;
-			walk = lextable_decode(walk, code_bit(n, m));
+			for (b = 0; b < 8; b++)
+				if (!(flags & HUF_DEC_FAIL) && walk == ones[b])
+					flags |= HUF_DEC_ACCEPT;
 
-			if (walk == 0xffff) {
-				fprintf(stderr, "failed\n");
-				return 3;
-			}
+			state = node[walk].id;
 
-			if (walk & 0x8000) {
-				y = walk & 0x7fff;
-				if (y == 0 && m == 29) {
-					y |= 0x100;
-					fprintf(stdout,
-						"\n/* state that points to "
-						"0x100 for disambiguation with "
-						"0x0 */\n"
-						"#define HUFTABLE_0x100_PREV "
-						"%d\n", prev);
-				}
-				break;
-			}
-			m++;
+			fprintf(stdout, "%s{ %3d, %d, 0x%02x },%s",
+				m & 3 ? " " : "\t\t", state, flags, sym,
+				(m & 3) == 3 ? "\n" : "");
 		}
 
-		if (y != n) {
-			fprintf(stderr, "decode failed %d got %d (0x%x)\n", n, y, y);
-			return 4;
-		}
+		fprintf(stdout, "\t},\n");
 	}
 
+	fprintf(stdout, "};\n");
+
+	fprintf(stdout, "\n/* huffman code and its length in bits for each "
+			"octet, and EOS, to encode */\n\n"
+			"static const struct {\n\tunsigned int code;\n"
+			"\tunsigned char len;\n} huftable_enc[] = {\n");
+	for (n = 0; n < (int)LWS_ARRAY_SIZE(huf_literal); n++)
+		fprintf(stdout, "\t{ 0x%x, %d }, /* 0x%02x */\n",
+			huf_literal[n].code, huf_literal[n].len, n);
+	fprintf(stdout, "};\n");
+
+#if defined(HUFTABLE_DEC_STATES)
+	if (self_test())
+		return 2;
+
 	fprintf(stderr, "All decode OK\n");
+#else
+	fprintf(stderr, "Run again to test the generated table\n");
+#endif
 
 	return 0;
 }
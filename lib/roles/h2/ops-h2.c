@@ -469,6 +469,8 @@ rops_write_role_protocol_h2(struct lws *wsi, unsigned char *buf, size_t len,
 	n = LWS_H2_FRAME_TYPE_DATA;
 	if (base == LWS_WRITE_HTTP_HEADERS) {
 		n = LWS_H2_FRAME_TYPE_HEADERS;
+		/* the peer will apply its dynamic table changes now */
+		lws_hpack_enc_commit(wsi);
 		if (!((*wp) & LWS_WRITE_NO_FIN))
 			flags = LWS_H2_FLAG_END_HEADERS;
 		if (wsi->h2.send_END_STREAM ||
@@ -591,7 +593,7 @@ rops_pt_init_destroy_h2(struct lws_context *context,
 
 		pt->sul_ah_lifecheck.cb = lws_sul_http_ah_lifecheck;
 
-		__lws_sul_insert_us(&pt->pt_sul_owner[LWSSULLI_MISS_IF_SUSPENDED],
+		__lws_sul_insert_us(pt, LWSSULLI_MISS_IF_SUSPENDED,
 				 &pt->sul_ah_lifecheck, 30 * LWS_US_PER_SEC);
 	} else
 		lws_dll2_remove(&pt->sul_ah_lifecheck.list);
@@ -647,9 +649,9 @@ rops_destroy_role_h2(struct lws *wsi)
 	lwsl_info("%s: %s: ah det due to close\n", __func__, lws_wsi_tag(wsi));
 	__lws_header_table_detach(wsi, 0);
 
-	ah = pt->http.ah_list;
-
-	while (ah) {
+	lws_start_foreach_dll(struct lws_dll2 *, d,
+			      lws_dll2_get_head(&pt->http.ah_owner)) {
+		ah = lws_container_of(d, struct allocated_headers, list);
 		if (ah->in_use && ah->wsi == wsi) {
 			lwsl_err("%s: ah leak: %s\n", __func__, lws_wsi_tag(wsi));
 			ah->in_use = 0;
@@ -657,18 +659,21 @@ rops_destroy_role_h2(struct lws *wsi)
 			pt->http.ah_count_in_use--;
 			break;
 		}
-		ah = ah->next;
-	}
+	} lws_end_foreach_dll(d);
 
 #if defined(LWS_WITH_HTTP_STREAM_COMPRESSION)
 	lws_http_compression_destroy(wsi);
 #endif
 
+	lws_hpack_enc_destroy(wsi);
+
 	if (wsi->upgraded_to_http2 || wsi->mux_substream) {
 		lws_hpack_destroy_dynamic_header(wsi);
 
-		if (wsi->h2.h2n)
-			lws_free_set_NULL(wsi->h2.h2n);
+		if (wsi->h2.h2n) {
+			lws_slab_free(wsi->h2.h2n);
+			wsi->h2.h2n = NULL;
+		}
 	}
 
 	return 0;
@@ -722,7 +727,7 @@ rops_close_kill_connection_h2(struct lws *wsi, enum lws_close_status reason)
 
 		while (w) {
 			w1 = w->next;
-			free(w);
+			lws_slab_free(w);
 			w = w1;
 		}
 		wsi->h2.h2n->pps = NULL;
@@ -906,11 +911,108 @@ lws_h2_bind_for_post_before_action(struct lws *wsi)
 }
 #endif
 
+/*
+ * With LWS_SERVER_OPTION_H2_PRIORITY, return the order two children waiting
+ * for POLLOUT should go in.  Streams that can't send DATA for lack of tx
+ * credit go last, then better RFC9218 urgency goes first.  Among the same
+ * urgency, non-incremental streams go first, one after another in sid order,
+ * and incremental ones share by weighted fair queueing: whoever sent least
+ * for their RFC7540 weight goes first.
+ */
+
+static int
+lws_h2_sched_before(struct lws *a, struct lws *b)
+{
+	int sa = lwsi_state(a) == LRS_ISSUING_FILE && a->txc.tx_cr <= 0,
+	    sb = lwsi_state(b) == LRS_ISSUING_FILE && b->txc.tx_cr <= 0;
+
+	if (sa != sb)
+		return sb;
+
+	if (a->h2.sched_urgency != b->h2.sched_urgency)
+		return a->h2.sched_urgency < b->h2.sched_urgency;
+
+	if (a->h2.sched_incremental != b->h2.sched_incremental)
+		return !a->h2.sched_incremental;
+
+	if (!a->h2.sched_incremental)
+		return a->mux.my_sid < b->mux.my_sid;
+
+	return a->h2.sched_vt < b->h2.sched_vt;
+}
+
+/*
+ * Find the best child waiting for POLLOUT that didn't go yet in this pass.
+ *
+ * A stream that was idle doesn't get to bank its share: its virtual time
+ * is brought up to the connection's before comparing, so new or returning
+ * streams compete on equal terms with ones that have been busy.
+ */
+
+static struct lws **
+lws_h2_sched_pick(struct lws *nwsi)
+{
+	struct lws_h2_netconn *h2n = nwsi->h2.h2n;
+	struct lws **pw = &nwsi->mux.child_list, **best = NULL;
+
+	while (*pw) {
+		struct lws *w = *pw;
+
+		if (w->mux.requested_POLLOUT &&
+		    w->h2.sched_pass != h2n->sched_pass) {
+			if (w->h2.sched_vt < h2n->sched_vt)
+				w->h2.sched_vt = h2n->sched_vt;
+			if (!best || lws_h2_sched_before(w, *best))
+				best = pw;
+		}
+
+		pw = &w->mux.sibling_list;
+	}
+
+	if (best) {
+		(*best)->h2.sched_pass = h2n->sched_pass;
+		if ((*best)->h2.sched_vt > h2n->sched_vt)
+			h2n->sched_vt = (*best)->h2.sched_vt;
+	}
+
+	return best;
+}
+
+/*
+ * A stream sending a file normally carries on until the connection is
+ * choked.  With LWS_SERVER_OPTION_H2_PRIORITY it stops early if a sibling
+ * that should go before it is waiting and hasn't gone yet in this pass, so
+ * that one doesn't have to queue up behind a socket full of our data.
+ */
+
+int
+lws_h2_sched_yield(struct lws *wsi)
+{
+	struct lws *nwsi, *w;
+
+	if (!wsi->mux_substream)
+		return 0;
+
+	nwsi = lws_get_network_wsi(wsi);
+	if (!nwsi->h2.h2n || !lws_check_opt(nwsi->a.vhost->options,
+					    LWS_SERVER_OPTION_H2_PRIORITY))
+		return 0;
+
+	for (w = nwsi->mux.child_list; w; w = w->mux.sibling_list)
+		if (w != wsi && w->mux.requested_POLLOUT &&
+		    w->h2.sched_pass != nwsi->h2.h2n->sched_pass &&
+		    lws_h2_sched_before(w, wsi))
+			return 1;
+
+	return 0;
+}
+
 /*
  * we are the 'network wsi' for potentially many muxed child wsi with
  * no network connection of their own, who have to use us for all their
  * network actions.  So we use a round-robin scheme to share out the
- * POLLOUT notifications to our children.
+ * POLLOUT notifications to our children, or with
+ * LWS_SERVER_OPTION_H2_PRIORITY, lws_h2_sched_pick() chooses the order.
  *
  * But because any child could exhaust the socket's ability to take
  * writes, we can only let one child get notified each time.
@@ -926,7 +1028,7 @@ rops_perform_user_POLLOUT_h2(struct lws *wsi)
 #if defined(LWS_ROLE_WS)
 	int write_type = LWS_WRITE_PONG;
 #endif
-	int n;
+	int n, prio;
 
 	wsi = lws_get_network_wsi(wsi);
 
@@ -942,9 +1044,20 @@ rops_perform_user_POLLOUT_h2(struct lws *wsi)
 	if (!*wsi2)
 		return 0;
 
+	prio = lws_check_opt(wsi->a.vhost->options,
+			     LWS_SERVER_OPTION_H2_PRIORITY);
+	if (prio)
+		wsi->h2.h2n->sched_pass++;
+
 	do {
 		struct lws *w, **wa;
 
+		if (prio) {
+			wsi2 = lws_h2_sched_pick(wsi);
+			if (!wsi2)
+				break;
+		}
+
 		wa = &(*wsi2)->mux.sibling_list;
 		if (!(*wsi2)->mux.requested_POLLOUT)
 			goto next_child;
@@ -1249,7 +1362,7 @@ rops_perform_user_POLLOUT_h2(struct lws *wsi)
 
 next_child:
 		wsi2 = wa;
-	} while (wsi2 && *wsi2 && !lws_send_pipe_choked(wsi));
+	} while ((prio || (wsi2 && *wsi2)) && !lws_send_pipe_choked(wsi));
 
 	// lws_wsi_mux_dump_waiting_children(wsi);
 
@@ -1294,7 +1407,9 @@ rops_alpn_negotiated_h2(struct lws *wsi, const char *alpn)
 	wsi->http.ah = ah;
 
 	if (!wsi->h2.h2n)
-		wsi->h2.h2n = lws_zalloc(sizeof(*wsi->h2.h2n), "h2n");
+		wsi->h2.h2n = lws_slab_zalloc(&wsi->a.context->pt[(int)wsi->tsi],
+					      LWS_SLAB_H2N,
+					      sizeof(*wsi->h2.h2n));
 	if (!wsi->h2.h2n)
 		return 1;
 
@@ -1332,7 +1447,7 @@ rops_issue_keepalive_h2(struct lws *wsi, int isvalid)
 
 	assert(wsi == nwsi);
 
-	pps = lws_h2_new_pps(LWS_H2_PPS_PING);
+	pps = lws_h2_new_pps(wsi, LWS_H2_PPS_PING);
 	if (!pps)
 		return 1;
 
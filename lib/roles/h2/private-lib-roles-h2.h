@@ -179,14 +179,24 @@ enum http2_hpack_type {
 
 
 struct hpack_dt_entry {
-	char *value; /* malloc'd */
+	uint32_t value_ofs; /* in the arena, unless IGNORE */
 	uint16_t value_len;
 	uint16_t hdr_len; /* virtual, for accounting */
 	uint16_t lws_hdr_idx; /* LWS_HPACK_IGNORE_ENTRY = IGNORE */
 };
 
+/*
+ * The values live one after the other in a ring of bytes, since entries are
+ * always evicted oldest first.  It grows as needed, up to about the
+ * negotiated table size, so there is no allocation per entry.
+ */
+
 struct hpack_dynamic_table {
 	struct hpack_dt_entry *entries; /* malloc'd */
+	char *arena; /* malloc'd */
+	uint32_t arena_len;
+	uint32_t arena_used; /* sum of value_len of entries not IGNORE */
+	uint32_t arena_tail; /* where the next value goes */
 	uint32_t virtual_payload_usage;
 	uint32_t virtual_payload_max;
 	uint16_t pos;
@@ -194,6 +204,51 @@ struct hpack_dynamic_table {
 	uint16_t num_entries;
 };
 
+/*
+ * Our HPACK encoder's view of the peer's dynamic table, for what we send.
+ *
+ * Fields we insert while a stream is building a header block only become
+ * real when the block is written... if it's abandoned, eg, because the
+ * headers didn't fit, we go back to how the table was before the block, so
+ * we stay in step with the peer's decoder.  Entries evicted during the block
+ * are kept until then for the same reason, and the ring has space for both.
+ */
+
+#define LWS_H2_HPACK_ENC_TABLE_MAX 4096
+
+struct hpack_enc_entry {
+	char *nv; /* malloc'd, name then value, not NUL-terminated */
+	uint16_t name_len;
+	uint16_t value_len;
+};
+
+struct hpack_enc_table {
+	struct hpack_enc_entry *ring; /* malloc'd */
+	struct lws *block_wsi; /* stream whose block is not written yet */
+
+	uint32_t size; /* RFC7541 4.1 size of entries in the table */
+	uint32_t max; /* table size the peer's decoder is using */
+	uint32_t peer_max; /* latest SETTINGS_HEADER_TABLE_SIZE, capped */
+	uint32_t peer_min; /* smallest one since our last size update */
+	uint32_t block_size; /* size of entries inserted by the block */
+
+	/* how things were before the block */
+	uint32_t c_size;
+	uint32_t c_max;
+	uint32_t c_peer_min;
+	uint16_t c_head;
+	uint16_t c_count;
+
+	uint16_t head; /* oldest entry in ring */
+	uint16_t count;
+	uint16_t ring_len;
+	uint16_t inserts; /* by the block */
+
+	uint8_t inited:1;
+	uint8_t update:1; /* next block must start with a size update */
+	uint8_t block_updated:1;
+};
+
 enum lws_h2_protocol_send_type {
 	LWS_PPS_NONE,
 	LWS_H2_PPS_MY_SETTINGS,
@@ -252,6 +307,7 @@ struct lws_h2_netconn {
 	struct http2_settings our_set;
 	struct http2_settings peer_set;
 	struct hpack_dynamic_table hpack_dyn_table;
+	struct hpack_enc_table hpack_enc;
 	uint8_t	ping_payload[8];
 	uint8_t one_setting[LWS_H2_SETTINGS_LEN];
 	char goaway_str[32]; /* for rx */
@@ -270,7 +326,7 @@ struct lws_h2_netconn {
 	unsigned int pad_length:1;
 	unsigned int collected_priority:1;
 	unsigned int is_first_header_char:1;
-	unsigned int zero_huff_padding:1;
+	unsigned int huff_pad_ok:1;
 	unsigned int last_action_dyntable_resize:1;
 	unsigned int sent_preface:1;
 
@@ -289,6 +345,9 @@ struct lws_h2_netconn {
 	uint32_t goaway_last_sid;
 	uint32_t goaway_err;
 	uint32_t hpack_hdr_len;
+	uint32_t sched_pass; /* count of POLLOUT passes */
+
+	uint64_t sched_vt; /* virtual time of the last stream picked */
 
 	uint16_t hpack_pos;
 
@@ -297,7 +356,6 @@ struct lws_h2_netconn {
 	uint8_t flags;
 	uint8_t padding;
 	uint8_t weight_temp;
-	uint8_t huff_pad;
 	char first_hdr_char;
 	uint8_t hpack_m;
 	uint8_t ext_count;
@@ -309,13 +367,19 @@ struct _lws_h2_related {
 
 	char			*pending_status_body;
 
+	uint64_t		sched_vt; /* data sent, scaled by weight */
+	uint32_t		sched_pass; /* last POLLOUT pass we were picked */
+	uint16_t		sched_weight; /* RFC7540 weight, 1 .. 256 */
+
 	uint8_t			h2_state; /* RFC7540 state of the connection */
+	uint8_t			sched_urgency; /* RFC9218, 0 (most) .. 7 */
 
 	uint8_t			END_STREAM:1;
 	uint8_t			END_HEADERS:1;
 	uint8_t			send_END_STREAM:1;
 	uint8_t			long_poll:1;
 	uint8_t			initialized:1;
+	uint8_t			sched_incremental:1;
 };
 
 #define HTTP2_IS_TOPLEVEL_WSI(wsi) (!wsi->mux.parent_wsi)
@@ -355,6 +419,12 @@ lws_add_http2_header_status(struct lws *wsi,
 			    unsigned char *end);
 void
 lws_hpack_destroy_dynamic_header(struct lws *wsi);
+void
+lws_hpack_enc_destroy(struct lws *wsi);
+void
+lws_hpack_enc_commit(struct lws *wsi);
+void
+lws_hpack_enc_peer_table_size(struct lws *nwsi, uint32_t size);
 int
 lws_hpack_dynamic_size(struct lws *wsi, int size);
 int
@@ -363,6 +433,12 @@ int
 lws_h2_tx_cr_get(struct lws *wsi);
 void
 lws_h2_tx_cr_consume(struct lws *wsi, int consumed);
+void
+lws_h2_sched_init(struct lws *wsi);
+void
+lws_h2_sched_priority(struct lws *wsi, const char *p, size_t len);
+int
+lws_h2_sched_yield(struct lws *wsi);
 int
 lws_hdr_extant(struct lws *wsi, enum lws_token_indexes h);
 void
@@ -381,4 +457,4 @@ lws_handle_POLLOUT_event_h2(struct lws *wsi);
 int
 lws_read_h2(struct lws *wsi, unsigned char *buf, lws_filepos_t len);
 struct lws_h2_protocol_send *
-lws_h2_new_pps(enum lws_h2_protocol_send_type type);
+lws_h2_new_pps(struct lws *wsi, enum lws_h2_protocol_send_type type);
@@ -85,3 +85,11 @@ lws_http_compression_transform(struct lws *wsi, unsigned char *buf,
 
 void
 lws_http_compression_destroy(struct lws *wsi);
+
+const char *
+lws_http_compression_choose(struct lws *wsi);
+
+#if defined(LWS_WITH_DISKCACHE)
+void
+lws_http_compression_cache_abort(struct lws *wsi);
+#endif
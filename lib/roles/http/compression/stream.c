@@ -57,6 +57,20 @@ lws_http_compression_validate(struct lws *wsi)
 	return 0;
 }
 
+/* the encoding lws_http_compression_apply() would choose for the client */
+
+const char *
+lws_http_compression_choose(struct lws *wsi)
+{
+	size_t n;
+
+	for (n = 0; n < LWS_ARRAY_SIZE(lcs_available); n++)
+		if (wsi->http.comp_accept_mask & (1 << n))
+			return lcs_available[n]->encoding_name;
+
+	return NULL;
+}
+
 int
 lws_http_compression_apply(struct lws *wsi, const char *name,
 			   unsigned char **p, unsigned char *end, char decomp)
@@ -104,9 +118,55 @@ lws_http_compression_apply(struct lws *wsi, const char *name,
 	return 0;
 }
 
+#if defined(LWS_WITH_DISKCACHE)
+
+/*
+ * We may be writing the compressed output into the vhost compression cache as
+ * well.  If the transform doesn't get to the end, the partial cache file is
+ * deleted.
+ */
+
+void
+lws_http_compression_cache_abort(struct lws *wsi)
+{
+	if (!wsi->http.comp_cache_name)
+		return;
+
+	close(wsi->http.comp_cache_fd);
+	unlink(wsi->http.comp_cache_name);
+	lws_free_set_NULL(wsi->http.comp_cache_name);
+}
+
+static void
+lws_http_compression_cache_write(struct lws *wsi, const uint8_t *buf,
+				 size_t len, int final)
+{
+	if (!wsi->http.comp_cache_name)
+		return;
+
+	if (len && write(wsi->http.comp_cache_fd, buf, len) != (ssize_t)len) {
+		lwsl_wsi_notice(wsi, "cache write failed");
+		lws_http_compression_cache_abort(wsi);
+		return;
+	}
+
+	if (!final)
+		return;
+
+	close(wsi->http.comp_cache_fd);
+	if (lws_diskcache_finalize_name(wsi->http.comp_cache_name))
+		unlink(wsi->http.comp_cache_name);
+	lws_free_set_NULL(wsi->http.comp_cache_name);
+}
+#endif
+
 void
 lws_http_compression_destroy(struct lws *wsi)
 {
+#if defined(LWS_WITH_DISKCACHE)
+	lws_http_compression_cache_abort(wsi);
+#endif
+
 	if (!wsi->http.lcs || !wsi->http.comp_ctx.u.generic_ctx_ptr)
 		return;
 
@@ -193,6 +253,11 @@ lws_http_compression_transform(struct lws *wsi, unsigned char *buf,
 
 		*wp = (unsigned int)(LWS_WRITE_HTTP_FINAL | ((*wp) & ~0x1fu));
 
+#if defined(LWS_WITH_DISKCACHE)
+	lws_http_compression_cache_write(wsi, *outbuf, *olen_oused,
+				((*wp) & 0x1f) == LWS_WRITE_HTTP_FINAL);
+#endif
+
 	lwsl_debug("%s: %s: more %d, ilen_iused %d\n", __func__, lws_wsi_tag(wsi),
 		   ctx->may_have_more, (int)ilen_iused);
 
@@ -671,6 +671,7 @@ lws_sul_http_ah_lifecheck(lws_sorted_usec_list_t *sul)
 	struct allocated_headers *ah;
 	struct lws_context_per_thread *pt = lws_container_of(sul,
 			struct lws_context_per_thread, sul_ah_lifecheck);
+	struct lws_dll2 *d;
 	struct lws *wsi;
 	time_t now;
 	int m;
@@ -679,17 +680,18 @@ lws_sul_http_ah_lifecheck(lws_sorted_usec_list_t *sul)
 
 	lws_pt_lock(pt, __func__);
 
-	ah = pt->http.ah_list;
-	while (ah) {
+	d = lws_dll2_get_head(&pt->http.ah_owner);
+	while (d) {
 		int len;
 		char buf[256];
 		const unsigned char *c;
 
+		ah = lws_container_of(d, struct allocated_headers, list);
 		if (!ah->in_use || !ah->wsi || !ah->assigned ||
 		    (ah->wsi->a.vhost &&
 		     (now - ah->assigned) <
 		     ah->wsi->a.vhost->timeout_secs_ah_idle + 360)) {
-			ah = ah->next;
+			d = d->next;
 			continue;
 		}
 
@@ -742,7 +744,7 @@ lws_sul_http_ah_lifecheck(lws_sorted_usec_list_t *sul)
 		__lws_close_free_wsi(wsi, LWS_CLOSE_STATUS_NOSTATUS,
 					     "excessive ah");
 
-		ah = pt->http.ah_list;
+		d = lws_dll2_get_head(&pt->http.ah_owner);
 	}
 
 	lws_pt_unlock(pt);
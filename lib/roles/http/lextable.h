@@ -51,7 +51,7 @@
 	/* 48: 82: head  */
 	/* 49: 86: x-auth-token: */
 	/* 50: 87: x-amzn-dss-signature: */
-	/* 51: 88:  */
+	/* 51: 89:  */
 /* pos 0000:   0 */    0x67 /* 'g' */, 0x34, 0x00  /* (to 0x0034 state   1) */,
                        0x70 /* 'p' */, 0x36, 0x00  /* (to 0x0039 state   5) */,
                        0x68 /* 'h' */, 0x3F, 0x00  /* (to 0x0045 state  10) */,
@@ -616,7 +616,7 @@
 	/* 68: 84: replay-nonce: */
 	/* 69: 86: x-auth-token: */
 	/* 70: 87: x-amzn-dss-signature: */
-	/* 71: 88:  */
+	/* 71: 89:  */
 /* pos 0000:   0 */    0x67 /* 'g' */, 0x3D, 0x00  /* (to 0x003D state   1) */,
                        0x70 /* 'p' */, 0x3F, 0x00  /* (to 0x0042 state   5) */,
                        0x68 /* 'h' */, 0x4E, 0x00  /* (to 0x0054 state  10) */,
@@ -1395,7 +1395,7 @@
 	/* 58: 82: head  */
 	/* 59: 86: x-auth-token: */
 	/* 60: 87: x-amzn-dss-signature: */
-	/* 61: 88:  */
+	/* 61: 89:  */
 /* pos 0000:   0 */    0x67 /* 'g' */, 0x3D, 0x00  /* (to 0x003D state   1) */,
                        0x70 /* 'p' */, 0x3F, 0x00  /* (to 0x0042 state   5) */,
                        0x68 /* 'h' */, 0x4E, 0x00  /* (to 0x0054 state  10) */,
@@ -2280,6 +2280,7 @@
 	/* 78: 84: replay-nonce: */
 	/* 79: 86: x-auth-token: */
 	/* 80: 87: x-amzn-dss-signature: */
+	/* 81: 89:  */
 /* pos 0000:   0 */    0x67 /* 'g' */, 0x3D, 0x00  /* (to 0x003D state   1) */,
                        0x70 /* 'p' */, 0x3F, 0x00  /* (to 0x0042 state   5) */,
                        0x68 /* 'h' */, 0x4E, 0x00  /* (to 0x0054 state  10) */,
@@ -3154,6 +3155,8 @@
 	/* 68: 85: :protocol */
 	/* 69: 86: x-auth-token: */
 	/* 70: 87: x-amzn-dss-signature: */
+	/* 71: 88: priority: */
+	/* 72: 89:  */
 /* pos 0000:   0 */    0x67 /* 'g' */, 0x40, 0x00  /* (to 0x0040 state   1) */,
                        0x70 /* 'p' */, 0x42, 0x00  /* (to 0x0045 state   5) */,
                        0x68 /* 'h' */, 0x51, 0x00  /* (to 0x0057 state  10) */,
@@ -3163,18 +3166,18 @@
                        0x0D /* '.' */, 0x98, 0x00  /* (to 0x00AA state  41) */,
                        0x61 /* 'a' */, 0xAD, 0x00  /* (to 0x00C2 state  51) */,
                        0x69 /* 'i' */, 0xCA, 0x00  /* (to 0x00E2 state  58) */,
-                       0x64 /* 'd' */, 0x73, 0x01  /* (to 0x018E state 160) */,
-                       0x72 /* 'r' */, 0x7C, 0x01  /* (to 0x019A state 165) */,
-                       0x65 /* 'e' */, 0xC8, 0x01  /* (to 0x01E9 state 229) */,
-                       0x66 /* 'f' */, 0xE4, 0x01  /* (to 0x0208 state 245) */,
-                       0x6C /* 'l' */, 0x06, 0x02  /* (to 0x022D state 278) */,
-                       0x73 /* 's' */, 0x4B, 0x02  /* (to 0x0275 state 321) */,
-                       0x74 /* 't' */, 0x69, 0x02  /* (to 0x0296 state 337) */,
-                       0x78 /* 'x' */, 0x8A, 0x02  /* (to 0x02BA state 364) */,
-                       0x6D /* 'm' */, 0x14, 0x03  /* (to 0x0347 state 474) */,
-                       0x76 /* 'v' */, 0x6D, 0x03  /* (to 0x03A3 state 549) */,
-                       0x77 /* 'w' */, 0x7A, 0x03  /* (to 0x03B3 state 557) */,
-                       0x3A /* ':' */, 0x32, 0x04  /* (to 0x046E state 692) */,
+                       0x64 /* 'd' */, 0x76, 0x01  /* (to 0x0191 state 160) */,
+                       0x72 /* 'r' */, 0x7F, 0x01  /* (to 0x019D state 165) */,
+                       0x65 /* 'e' */, 0xCB, 0x01  /* (to 0x01EC state 229) */,
+                       0x66 /* 'f' */, 0xE7, 0x01  /* (to 0x020B state 245) */,
+                       0x6C /* 'l' */, 0x09, 0x02  /* (to 0x0230 state 278) */,
+                       0x73 /* 's' */, 0x4E, 0x02  /* (to 0x0278 state 321) */,
+                       0x74 /* 't' */, 0x6C, 0x02  /* (to 0x0299 state 337) */,
+                       0x78 /* 'x' */, 0x8D, 0x02  /* (to 0x02BD state 364) */,
+                       0x6D /* 'm' */, 0x17, 0x03  /* (to 0x034A state 474) */,
+                       0x76 /* 'v' */, 0x70, 0x03  /* (to 0x03A6 state 549) */,
+                       0x77 /* 'w' */, 0x7D, 0x03  /* (to 0x03B6 state 557) */,
+                       0x3A /* ':' */, 0x35, 0x04  /* (to 0x0471 state 692) */,
                        0x08, /* fail */
 /* pos 0040:   1 */    0xE5 /* 'e' -> */,
 /* pos 0041:   2 */    0xF4 /* 't' -> */,
@@ -3182,8 +3185,8 @@
 /* pos 0043:   4 */    0x00, 0x00                  /* - terminal marker  0 - */,
 /* pos 0045:   5 */    0x6F /* 'o' */, 0x0D, 0x00  /* (to 0x0052 state   6) */,
                        0x72 /* 'r' */, 0xEC, 0x00  /* (to 0x0134 state 106) */,
-                       0x61 /* 'a' */, 0x7A, 0x03  /* (to 0x03C5 state 574) */,
-                       0x75 /* 'u' */, 0x7C, 0x03  /* (to 0x03CA state 578) */,
+                       0x61 /* 'a' */, 0x7D, 0x03  /* (to 0x03C8 state 574) */,
+                       0x75 /* 'u' */, 0x7F, 0x03  /* (to 0x03CD state 578) */,
                        0x08, /* fail */
 /* pos 0052:   6 */    0xF3 /* 's' -> */,
 /* pos 0053:   7 */    0xF4 /* 't' -> */,
@@ -3191,34 +3194,34 @@
 /* pos 0055:   9 */    0x00, 0x01                  /* - terminal marker  1 - */,
 /* pos 0057:  10 */    0x6F /* 'o' */, 0x0A, 0x00  /* (to 0x0061 state  11) */,
                        0x74 /* 't' */, 0x53, 0x00  /* (to 0x00AD state  43) */,
-                       0x65 /* 'e' */, 0x79, 0x02  /* (to 0x02D6 state 381) */,
+                       0x65 /* 'e' */, 0x7C, 0x02  /* (to 0x02D9 state 381) */,
                        0x08, /* fail */
 /* pos 0061:  11 */    0xF3 /* 's' -> */,
 /* pos 0062:  12 */    0xF4 /* 't' -> */,
 /* pos 0063:  13 */    0xBA /* ':' -> */,
 /* pos 0064:  14 */    0x00, 0x02                  /* - terminal marker  2 - */,
 /* pos 0066:  15 */    0x6F /* 'o' */, 0x07, 0x00  /* (to 0x006D state  16) */,
-                       0x61 /* 'a' */, 0xD8, 0x00  /* (to 0x0141 state 112) */,
+                       0x61 /* 'a' */, 0xDB, 0x00  /* (to 0x0144 state 112) */,
                        0x08, /* fail */
 /* pos 006d:  16 */    0x6E /* 'n' */, 0x07, 0x00  /* (to 0x0074 state  17) */,
-                       0x6F /* 'o' */, 0xED, 0x00  /* (to 0x015D state 138) */,
+                       0x6F /* 'o' */, 0xF0, 0x00  /* (to 0x0160 state 138) */,
                        0x08, /* fail */
 /* pos 0074:  17 */    0x6E /* 'n' */, 0x07, 0x00  /* (to 0x007B state  18) */,
-                       0x74 /* 't' */, 0xEC, 0x00  /* (to 0x0163 state 143) */,
+                       0x74 /* 't' */, 0xEF, 0x00  /* (to 0x0166 state 143) */,
                        0x08, /* fail */
 /* pos 007b:  18 */    0xE5 /* 'e' -> */,
 /* pos 007c:  19 */    0xE3 /* 'c' -> */,
 /* pos 007d:  20 */    0xF4 /* 't' -> */,
 /* pos 007e:  21 */    0x69 /* 'i' */, 0x07, 0x00  /* (to 0x0085 state  22) */,
-                       0x20 /* ' ' */, 0x53, 0x02  /* (to 0x02D4 state 380) */,
+                       0x20 /* ' ' */, 0x56, 0x02  /* (to 0x02D7 state 380) */,
                        0x08, /* fail */
 /* pos 0085:  22 */    0xEF /* 'o' -> */,
 /* pos 0086:  23 */    0xEE /* 'n' -> */,
 /* pos 0087:  24 */    0xBA /* ':' -> */,
 /* pos 0088:  25 */    0x00, 0x03                  /* - terminal marker  3 - */,
 /* pos 008a:  26 */    0x70 /* 'p' */, 0x0A, 0x00  /* (to 0x0094 state  27) */,
-                       0x72 /* 'r' */, 0x22, 0x02  /* (to 0x02AF state 355) */,
-                       0x73 /* 's' */, 0x08, 0x03  /* (to 0x0398 state 539) */,
+                       0x72 /* 'r' */, 0x25, 0x02  /* (to 0x02B2 state 355) */,
+                       0x73 /* 's' */, 0x0B, 0x03  /* (to 0x039B state 539) */,
                        0x08, /* fail */
 /* pos 0094:  27 */    0xE7 /* 'g' -> */,
 /* pos 0095:  28 */    0xF2 /* 'r' -> */,
@@ -3228,7 +3231,7 @@
 /* pos 0099:  32 */    0xBA /* ':' -> */,
 /* pos 009a:  33 */    0x00, 0x04                  /* - terminal marker  4 - */,
 /* pos 009c:  34 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x00A3 state  35) */,
-                       0x70 /* 'p' */, 0x61, 0x02  /* (to 0x0300 state 414) */,
+                       0x70 /* 'p' */, 0x64, 0x02  /* (to 0x0303 state 414) */,
                        0x08, /* fail */
 /* pos 00a3:  35 */    0xE9 /* 'i' -> */,
 /* pos 00a4:  36 */    0xE7 /* 'g' -> */,
@@ -3241,24 +3244,24 @@
 /* pos 00ad:  43 */    0xF4 /* 't' -> */,
 /* pos 00ae:  44 */    0xF0 /* 'p' -> */,
 /* pos 00af:  45 */    0x2F /* '/' */, 0x07, 0x00  /* (to 0x00B6 state  46) */,
-                       0x32 /* '2' */, 0xB0, 0x03  /* (to 0x0462 state 681) */,
+                       0x32 /* '2' */, 0xB3, 0x03  /* (to 0x0465 state 681) */,
                        0x08, /* fail */
 /* pos 00b6:  46 */    0xB1 /* '1' -> */,
 /* pos 00b7:  47 */    0xAE /* '.' -> */,
 /* pos 00b8:  48 */    0x31 /* '1' */, 0x07, 0x00  /* (to 0x00BF state  49) */,
-                       0x30 /* '0' */, 0xFC, 0x01  /* (to 0x02B7 state 362) */,
+                       0x30 /* '0' */, 0xFF, 0x01  /* (to 0x02BA state 362) */,
                        0x08, /* fail */
 /* pos 00bf:  49 */    0xA0 /* ' ' -> */,
 /* pos 00c0:  50 */    0x00, 0x07                  /* - terminal marker  7 - */,
 /* pos 00c2:  51 */    0x63 /* 'c' */, 0x0D, 0x00  /* (to 0x00CF state  52) */,
-                       0x75 /* 'u' */, 0x8A, 0x00  /* (to 0x014F state 125) */,
-                       0x67 /* 'g' */, 0xE7, 0x00  /* (to 0x01AF state 178) */,
-                       0x6C /* 'l' */, 0xE8, 0x00  /* (to 0x01B3 state 181) */,
+                       0x75 /* 'u' */, 0x8D, 0x00  /* (to 0x0152 state 125) */,
+                       0x67 /* 'g' */, 0xEA, 0x00  /* (to 0x01B2 state 178) */,
+                       0x6C /* 'l' */, 0xEB, 0x00  /* (to 0x01B6 state 181) */,
                        0x08, /* fail */
 /* pos 00cf:  52 */    0xE3 /* 'c' -> */,
 /* pos 00d0:  53 */    0xE5 /* 'e' -> */,
 /* pos 00d1:  54 */    0x70 /* 'p' */, 0x07, 0x00  /* (to 0x00D8 state  55) */,
-                       0x73 /* 's' */, 0x34, 0x02  /* (to 0x0308 state 421) */,
+                       0x73 /* 's' */, 0x37, 0x02  /* (to 0x030B state 421) */,
                        0x08, /* fail */
 /* pos 00d8:  55 */    0xF4 /* 't' -> */,
 /* pos 00d9:  56 */    0x3A /* ':' */, 0x07, 0x00  /* (to 0x00E0 state  57) */,
@@ -3269,11 +3272,11 @@
 /* pos 00e3:  59 */    0xAD /* '-' -> */,
 /* pos 00e4:  60 */    0x6D /* 'm' */, 0x0D, 0x00  /* (to 0x00F1 state  61) */,
                        0x6E /* 'n' */, 0x20, 0x00  /* (to 0x0107 state  76) */,
-                       0x72 /* 'r' */, 0x2A, 0x01  /* (to 0x0214 state 255) */,
-                       0x75 /* 'u' */, 0x2E, 0x01  /* (to 0x021B state 261) */,
+                       0x72 /* 'r' */, 0x2D, 0x01  /* (to 0x0217 state 255) */,
+                       0x75 /* 'u' */, 0x31, 0x01  /* (to 0x021E state 261) */,
                        0x08, /* fail */
 /* pos 00f1:  61 */    0x6F /* 'o' */, 0x07, 0x00  /* (to 0x00F8 state  62) */,
-                       0x61 /* 'a' */, 0x1A, 0x01  /* (to 0x020E state 250) */,
+                       0x61 /* 'a' */, 0x1D, 0x01  /* (to 0x0211 state 250) */,
                        0x08, /* fail */
 /* pos 00f8:  62 */    0xE4 /* 'd' -> */,
 /* pos 00f9:  63 */    0xE9 /* 'i' -> */,
@@ -3302,8 +3305,8 @@
 /* pos 0111:  86 */    0x00, 0x0B                  /* - terminal marker 11 - */,
 /* pos 0113:  87 */    0x65 /* 'e' */, 0x0D, 0x00  /* (to 0x0120 state  88) */,
                        0x6C /* 'l' */, 0x14, 0x00  /* (to 0x012A state  97) */,
-                       0x72 /* 'r' */, 0x8E, 0x00  /* (to 0x01A7 state 171) */,
-                       0x63 /* 'c' */, 0x14, 0x02  /* (to 0x0330 state 453) */,
+                       0x72 /* 'r' */, 0x91, 0x00  /* (to 0x01AA state 171) */,
+                       0x63 /* 'c' */, 0x17, 0x02  /* (to 0x0333 state 453) */,
                        0x08, /* fail */
 /* pos 0120:  88 */    0xEE /* 'n' -> */,
 /* pos 0121:  89 */    0xE3 /* 'c' -> */,
@@ -3323,696 +3326,704 @@
 /* pos 0130: 103 */    0xE5 /* 'e' -> */,
 /* pos 0131: 104 */    0xBA /* ':' -> */,
 /* pos 0132: 105 */    0x00, 0x0D                  /* - terminal marker 13 - */,
-/* pos 0134: 106 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x013B state 107) */,
-                       0x6F /* 'o' */, 0x1E, 0x02  /* (to 0x0355 state 487) */,
-                       0x08, /* fail */
-/* pos 013b: 107 */    0xE7 /* 'g' -> */,
-/* pos 013c: 108 */    0xED /* 'm' -> */,
-/* pos 013d: 109 */    0xE1 /* 'a' -> */,
-/* pos 013e: 110 */    0xBA /* ':' -> */,
-/* pos 013f: 111 */    0x00, 0x0E                  /* - terminal marker 14 - */,
-/* pos 0141: 112 */    0xE3 /* 'c' -> */,
-/* pos 0142: 113 */    0xE8 /* 'h' -> */,
-/* pos 0143: 114 */    0xE5 /* 'e' -> */,
-/* pos 0144: 115 */    0xAD /* '-' -> */,
-/* pos 0145: 116 */    0xE3 /* 'c' -> */,
-/* pos 0146: 117 */    0xEF /* 'o' -> */,
-/* pos 0147: 118 */    0xEE /* 'n' -> */,
-/* pos 0148: 119 */    0xF4 /* 't' -> */,
-/* pos 0149: 120 */    0xF2 /* 'r' -> */,
-/* pos 014a: 121 */    0xEF /* 'o' -> */,
-/* pos 014b: 122 */    0xEC /* 'l' -> */,
-/* pos 014c: 123 */    0xBA /* ':' -> */,
-/* pos 014d: 124 */    0x00, 0x0F                  /* - terminal marker 15 - */,
-/* pos 014f: 125 */    0xF4 /* 't' -> */,
-/* pos 0150: 126 */    0xE8 /* 'h' -> */,
-/* pos 0151: 127 */    0xEF /* 'o' -> */,
-/* pos 0152: 128 */    0xF2 /* 'r' -> */,
-/* pos 0153: 129 */    0xE9 /* 'i' -> */,
-/* pos 0154: 130 */    0xFA /* 'z' -> */,
-/* pos 0155: 131 */    0xE1 /* 'a' -> */,
-/* pos 0156: 132 */    0xF4 /* 't' -> */,
-/* pos 0157: 133 */    0xE9 /* 'i' -> */,
-/* pos 0158: 134 */    0xEF /* 'o' -> */,
-/* pos 0159: 135 */    0xEE /* 'n' -> */,
-/* pos 015a: 136 */    0xBA /* ':' -> */,
-/* pos 015b: 137 */    0x00, 0x10                  /* - terminal marker 16 - */,
-/* pos 015d: 138 */    0xEB /* 'k' -> */,
-/* pos 015e: 139 */    0xE9 /* 'i' -> */,
-/* pos 015f: 140 */    0xE5 /* 'e' -> */,
-/* pos 0160: 141 */    0xBA /* ':' -> */,
-/* pos 0161: 142 */    0x00, 0x11                  /* - terminal marker 17 - */,
-/* pos 0163: 143 */    0xE5 /* 'e' -> */,
-/* pos 0164: 144 */    0xEE /* 'n' -> */,
-/* pos 0165: 145 */    0xF4 /* 't' -> */,
-/* pos 0166: 146 */    0xAD /* '-' -> */,
-/* pos 0167: 147 */    0x6C /* 'l' */, 0x10, 0x00  /* (to 0x0177 state 148) */,
-                       0x74 /* 't' */, 0x1E, 0x00  /* (to 0x0188 state 155) */,
-                       0x64 /* 'd' */, 0x4C, 0x00  /* (to 0x01B9 state 186) */,
-                       0x65 /* 'e' */, 0x56, 0x00  /* (to 0x01C6 state 198) */,
-                       0x72 /* 'r' */, 0x6F, 0x00  /* (to 0x01E2 state 223) */,
-                       0x08, /* fail */
-/* pos 0177: 148 */    0x65 /* 'e' */, 0x0A, 0x00  /* (to 0x0181 state 149) */,
-                       0x61 /* 'a' */, 0x56, 0x00  /* (to 0x01D0 state 207) */,
-                       0x6F /* 'o' */, 0x5C, 0x00  /* (to 0x01D9 state 215) */,
-                       0x08, /* fail */
-/* pos 0181: 149 */    0xEE /* 'n' -> */,
-/* pos 0182: 150 */    0xE7 /* 'g' -> */,
-/* pos 0183: 151 */    0xF4 /* 't' -> */,
-/* pos 0184: 152 */    0xE8 /* 'h' -> */,
-/* pos 0185: 153 */    0xBA /* ':' -> */,
-/* pos 0186: 154 */    0x00, 0x12                  /* - terminal marker 18 - */,
-/* pos 0188: 155 */    0xF9 /* 'y' -> */,
-/* pos 0189: 156 */    0xF0 /* 'p' -> */,
-/* pos 018a: 157 */    0xE5 /* 'e' -> */,
-/* pos 018b: 158 */    0xBA /* ':' -> */,
-/* pos 018c: 159 */    0x00, 0x13                  /* - terminal marker 19 - */,
-/* pos 018e: 160 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0195 state 161) */,
-                       0x65 /* 'e' */, 0x3C, 0x02  /* (to 0x03CD state 580) */,
-                       0x08, /* fail */
-/* pos 0195: 161 */    0xF4 /* 't' -> */,
-/* pos 0196: 162 */    0xE5 /* 'e' -> */,
-/* pos 0197: 163 */    0xBA /* ':' -> */,
-/* pos 0198: 164 */    0x00, 0x14                  /* - terminal marker 20 - */,
-/* pos 019a: 165 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x01A1 state 166) */,
-                       0x65 /* 'e' */, 0xB6, 0x00  /* (to 0x0253 state 304) */,
-                       0x08, /* fail */
-/* pos 01a1: 166 */    0xEE /* 'n' -> */,
-/* pos 01a2: 167 */    0xE7 /* 'g' -> */,
-/* pos 01a3: 168 */    0xE5 /* 'e' -> */,
-/* pos 01a4: 169 */    0xBA /* ':' -> */,
-/* pos 01a5: 170 */    0x00, 0x15                  /* - terminal marker 21 - */,
-/* pos 01a7: 171 */    0xE1 /* 'a' -> */,
-/* pos 01a8: 172 */    0xEE /* 'n' -> */,
-/* pos 01a9: 173 */    0xE7 /* 'g' -> */,
-/* pos 01aa: 174 */    0xE5 /* 'e' -> */,
-/* pos 01ab: 175 */    0xF3 /* 's' -> */,
-/* pos 01ac: 176 */    0xBA /* ':' -> */,
-/* pos 01ad: 177 */    0x00, 0x1D                  /* - terminal marker 29 - */,
-/* pos 01af: 178 */    0xE5 /* 'e' -> */,
-/* pos 01b0: 179 */    0xBA /* ':' -> */,
-/* pos 01b1: 180 */    0x00, 0x1F                  /* - terminal marker 31 - */,
-/* pos 01b3: 181 */    0xEC /* 'l' -> */,
-/* pos 01b4: 182 */    0xEF /* 'o' -> */,
-/* pos 01b5: 183 */    0xF7 /* 'w' -> */,
-/* pos 01b6: 184 */    0xBA /* ':' -> */,
-/* pos 01b7: 185 */    0x00, 0x20                  /* - terminal marker 32 - */,
-/* pos 01b9: 186 */    0xE9 /* 'i' -> */,
-/* pos 01ba: 187 */    0xF3 /* 's' -> */,
-/* pos 01bb: 188 */    0xF0 /* 'p' -> */,
-/* pos 01bc: 189 */    0xEF /* 'o' -> */,
-/* pos 01bd: 190 */    0xF3 /* 's' -> */,
-/* pos 01be: 191 */    0xE9 /* 'i' -> */,
-/* pos 01bf: 192 */    0xF4 /* 't' -> */,
-/* pos 01c0: 193 */    0xE9 /* 'i' -> */,
-/* pos 01c1: 194 */    0xEF /* 'o' -> */,
-/* pos 01c2: 195 */    0xEE /* 'n' -> */,
-/* pos 01c3: 196 */    0xBA /* ':' -> */,
-/* pos 01c4: 197 */    0x00, 0x21                  /* - terminal marker 33 - */,
-/* pos 01c6: 198 */    0xEE /* 'n' -> */,
-/* pos 01c7: 199 */    0xE3 /* 'c' -> */,
-/* pos 01c8: 200 */    0xEF /* 'o' -> */,
-/* pos 01c9: 201 */    0xE4 /* 'd' -> */,
-/* pos 01ca: 202 */    0xE9 /* 'i' -> */,
-/* pos 01cb: 203 */    0xEE /* 'n' -> */,
-/* pos 01cc: 204 */    0xE7 /* 'g' -> */,
-/* pos 01cd: 205 */    0xBA /* ':' -> */,
-/* pos 01ce: 206 */    0x00, 0x22                  /* - terminal marker 34 - */,
-/* pos 01d0: 207 */    0xEE /* 'n' -> */,
-/* pos 01d1: 208 */    0xE7 /* 'g' -> */,
-/* pos 01d2: 209 */    0xF5 /* 'u' -> */,
-/* pos 01d3: 210 */    0xE1 /* 'a' -> */,
-/* pos 01d4: 211 */    0xE7 /* 'g' -> */,
-/* pos 01d5: 212 */    0xE5 /* 'e' -> */,
-/* pos 01d6: 213 */    0xBA /* ':' -> */,
-/* pos 01d7: 214 */    0x00, 0x23                  /* - terminal marker 35 - */,
-/* pos 01d9: 215 */    0xE3 /* 'c' -> */,
-/* pos 01da: 216 */    0xE1 /* 'a' -> */,
-/* pos 01db: 217 */    0xF4 /* 't' -> */,
-/* pos 01dc: 218 */    0xE9 /* 'i' -> */,
-/* pos 01dd: 219 */    0xEF /* 'o' -> */,
-/* pos 01de: 220 */    0xEE /* 'n' -> */,
-/* pos 01df: 221 */    0xBA /* ':' -> */,
-/* pos 01e0: 222 */    0x00, 0x24                  /* - terminal marker 36 - */,
-/* pos 01e2: 223 */    0xE1 /* 'a' -> */,
-/* pos 01e3: 224 */    0xEE /* 'n' -> */,
-/* pos 01e4: 225 */    0xE7 /* 'g' -> */,
-/* pos 01e5: 226 */    0xE5 /* 'e' -> */,
-/* pos 01e6: 227 */    0xBA /* ':' -> */,
-/* pos 01e7: 228 */    0x00, 0x25                  /* - terminal marker 37 - */,
-/* pos 01e9: 229 */    0x74 /* 't' */, 0x07, 0x00  /* (to 0x01F0 state 230) */,
-                       0x78 /* 'x' */, 0x09, 0x00  /* (to 0x01F5 state 234) */,
-                       0x08, /* fail */
-/* pos 01f0: 230 */    0xE1 /* 'a' -> */,
-/* pos 01f1: 231 */    0xE7 /* 'g' -> */,
-/* pos 01f2: 232 */    0xBA /* ':' -> */,
-/* pos 01f3: 233 */    0x00, 0x26                  /* - terminal marker 38 - */,
-/* pos 01f5: 234 */    0xF0 /* 'p' -> */,
-/* pos 01f6: 235 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x01FD state 236) */,
-                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x0202 state 240) */,
-                       0x08, /* fail */
-/* pos 01fd: 236 */    0xE3 /* 'c' -> */,
-/* pos 01fe: 237 */    0xF4 /* 't' -> */,
-/* pos 01ff: 238 */    0xBA /* ':' -> */,
-/* pos 0200: 239 */    0x00, 0x27                  /* - terminal marker 39 - */,
-/* pos 0202: 240 */    0xF2 /* 'r' -> */,
-/* pos 0203: 241 */    0xE5 /* 'e' -> */,
-/* pos 0204: 242 */    0xF3 /* 's' -> */,
-/* pos 0205: 243 */    0xBA /* ':' -> */,
-/* pos 0206: 244 */    0x00, 0x28                  /* - terminal marker 40 - */,
-/* pos 0208: 245 */    0xF2 /* 'r' -> */,
-/* pos 0209: 246 */    0xEF /* 'o' -> */,
-/* pos 020a: 247 */    0xED /* 'm' -> */,
-/* pos 020b: 248 */    0xBA /* ':' -> */,
-/* pos 020c: 249 */    0x00, 0x29                  /* - terminal marker 41 - */,
-/* pos 020e: 250 */    0xF4 /* 't' -> */,
-/* pos 020f: 251 */    0xE3 /* 'c' -> */,
-/* pos 0210: 252 */    0xE8 /* 'h' -> */,
-/* pos 0211: 253 */    0xBA /* ':' -> */,
-/* pos 0212: 254 */    0x00, 0x2A                  /* - terminal marker 42 - */,
-/* pos 0214: 255 */    0xE1 /* 'a' -> */,
-/* pos 0215: 256 */    0xEE /* 'n' -> */,
-/* pos 0216: 257 */    0xE7 /* 'g' -> */,
-/* pos 0217: 258 */    0xE5 /* 'e' -> */,
-/* pos 0218: 259 */    0xBA /* ':' -> */,
-/* pos 0219: 260 */    0x00, 0x2B                  /* - terminal marker 43 - */,
-/* pos 021b: 261 */    0xEE /* 'n' -> */,
-/* pos 021c: 262 */    0xED /* 'm' -> */,
-/* pos 021d: 263 */    0xEF /* 'o' -> */,
-/* pos 021e: 264 */    0xE4 /* 'd' -> */,
-/* pos 021f: 265 */    0xE9 /* 'i' -> */,
-/* pos 0220: 266 */    0xE6 /* 'f' -> */,
-/* pos 0221: 267 */    0xE9 /* 'i' -> */,
-/* pos 0222: 268 */    0xE5 /* 'e' -> */,
-/* pos 0223: 269 */    0xE4 /* 'd' -> */,
-/* pos 0224: 270 */    0xAD /* '-' -> */,
-/* pos 0225: 271 */    0xF3 /* 's' -> */,
-/* pos 0226: 272 */    0xE9 /* 'i' -> */,
-/* pos 0227: 273 */    0xEE /* 'n' -> */,
-/* pos 0228: 274 */    0xE3 /* 'c' -> */,
-/* pos 0229: 275 */    0xE5 /* 'e' -> */,
-/* pos 022a: 276 */    0xBA /* ':' -> */,
-/* pos 022b: 277 */    0x00, 0x2C                  /* - terminal marker 44 - */,
-/* pos 022d: 278 */    0x61 /* 'a' */, 0x0A, 0x00  /* (to 0x0237 state 279) */,
-                       0x69 /* 'i' */, 0x15, 0x00  /* (to 0x0245 state 292) */,
-                       0x6F /* 'o' */, 0x17, 0x00  /* (to 0x024A state 296) */,
-                       0x08, /* fail */
-/* pos 0237: 279 */    0xF3 /* 's' -> */,
-/* pos 0238: 280 */    0xF4 /* 't' -> */,
-/* pos 0239: 281 */    0xAD /* '-' -> */,
-/* pos 023a: 282 */    0xED /* 'm' -> */,
-/* pos 023b: 283 */    0xEF /* 'o' -> */,
-/* pos 023c: 284 */    0xE4 /* 'd' -> */,
-/* pos 023d: 285 */    0xE9 /* 'i' -> */,
-/* pos 023e: 286 */    0xE6 /* 'f' -> */,
-/* pos 023f: 287 */    0xE9 /* 'i' -> */,
-/* pos 0240: 288 */    0xE5 /* 'e' -> */,
-/* pos 0241: 289 */    0xE4 /* 'd' -> */,
-/* pos 0242: 290 */    0xBA /* ':' -> */,
-/* pos 0243: 291 */    0x00, 0x2D                  /* - terminal marker 45 - */,
-/* pos 0245: 292 */    0xEE /* 'n' -> */,
-/* pos 0246: 293 */    0xEB /* 'k' -> */,
-/* pos 0247: 294 */    0xBA /* ':' -> */,
-/* pos 0248: 295 */    0x00, 0x2E                  /* - terminal marker 46 - */,
-/* pos 024a: 296 */    0xE3 /* 'c' -> */,
-/* pos 024b: 297 */    0xE1 /* 'a' -> */,
-/* pos 024c: 298 */    0xF4 /* 't' -> */,
-/* pos 024d: 299 */    0xE9 /* 'i' -> */,
-/* pos 024e: 300 */    0xEF /* 'o' -> */,
-/* pos 024f: 301 */    0xEE /* 'n' -> */,
-/* pos 0250: 302 */    0xBA /* ':' -> */,
-/* pos 0251: 303 */    0x00, 0x2F                  /* - terminal marker 47 - */,
-/* pos 0253: 304 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x025D state 305) */,
-                       0x74 /* 't' */, 0x14, 0x00  /* (to 0x026A state 311) */,
-                       0x70 /* 'p' */, 0x88, 0x01  /* (to 0x03E1 state 596) */,
-                       0x08, /* fail */
-/* pos 025d: 305 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x0264 state 306) */,
-                       0x65 /* 'e' */, 0xCA, 0x00  /* (to 0x032A state 448) */,
-                       0x08, /* fail */
-/* pos 0264: 306 */    0xE5 /* 'e' -> */,
-/* pos 0265: 307 */    0xF3 /* 's' -> */,
-/* pos 0266: 308 */    0xE8 /* 'h' -> */,
-/* pos 0267: 309 */    0xBA /* ':' -> */,
-/* pos 0268: 310 */    0x00, 0x33                  /* - terminal marker 51 - */,
-/* pos 026a: 311 */    0xF2 /* 'r' -> */,
-/* pos 026b: 312 */    0xF9 /* 'y' -> */,
-/* pos 026c: 313 */    0xAD /* '-' -> */,
-/* pos 026d: 314 */    0xE1 /* 'a' -> */,
-/* pos 026e: 315 */    0xE6 /* 'f' -> */,
-/* pos 026f: 316 */    0xF4 /* 't' -> */,
-/* pos 0270: 317 */    0xE5 /* 'e' -> */,
-/* pos 0271: 318 */    0xF2 /* 'r' -> */,
-/* pos 0272: 319 */    0xBA /* ':' -> */,
-/* pos 0273: 320 */    0x00, 0x34                  /* - terminal marker 52 - */,
-/* pos 0275: 321 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x027C state 322) */,
-                       0x74 /* 't' */, 0x06, 0x01  /* (to 0x037E state 514) */,
-                       0x08, /* fail */
-/* pos 027c: 322 */    0x72 /* 'r' */, 0x0A, 0x00  /* (to 0x0286 state 323) */,
-                       0x74 /* 't' */, 0x0D, 0x00  /* (to 0x028C state 328) */,
-                       0x63 /* 'c' */, 0x6B, 0x01  /* (to 0x03ED state 607) */,
-                       0x08, /* fail */
-/* pos 0286: 323 */    0xF6 /* 'v' -> */,
-/* pos 0287: 324 */    0xE5 /* 'e' -> */,
-/* pos 0288: 325 */    0xF2 /* 'r' -> */,
-/* pos 0289: 326 */    0xBA /* ':' -> */,
-/* pos 028a: 327 */    0x00, 0x35                  /* - terminal marker 53 - */,
-/* pos 028c: 328 */    0xAD /* '-' -> */,
-/* pos 028d: 329 */    0xE3 /* 'c' -> */,
-/* pos 028e: 330 */    0xEF /* 'o' -> */,
-/* pos 028f: 331 */    0xEF /* 'o' -> */,
-/* pos 0290: 332 */    0xEB /* 'k' -> */,
-/* pos 0291: 333 */    0xE9 /* 'i' -> */,
-/* pos 0292: 334 */    0xE5 /* 'e' -> */,
-/* pos 0293: 335 */    0xBA /* ':' -> */,
-/* pos 0294: 336 */    0x00, 0x36                  /* - terminal marker 54 - */,
-/* pos 0296: 337 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x029D state 338) */,
-                       0x65 /* 'e' */, 0x45, 0x01  /* (to 0x03DE state 594) */,
-                       0x08, /* fail */
-/* pos 029d: 338 */    0xE1 /* 'a' -> */,
-/* pos 029e: 339 */    0xEE /* 'n' -> */,
-/* pos 029f: 340 */    0xF3 /* 's' -> */,
-/* pos 02a0: 341 */    0xE6 /* 'f' -> */,
-/* pos 02a1: 342 */    0xE5 /* 'e' -> */,
-/* pos 02a2: 343 */    0xF2 /* 'r' -> */,
-/* pos 02a3: 344 */    0xAD /* '-' -> */,
-/* pos 02a4: 345 */    0xE5 /* 'e' -> */,
-/* pos 02a5: 346 */    0xEE /* 'n' -> */,
-/* pos 02a6: 347 */    0xE3 /* 'c' -> */,
-/* pos 02a7: 348 */    0xEF /* 'o' -> */,
-/* pos 02a8: 349 */    0xE4 /* 'd' -> */,
-/* pos 02a9: 350 */    0xE9 /* 'i' -> */,
-/* pos 02aa: 351 */    0xEE /* 'n' -> */,
-/* pos 02ab: 352 */    0xE7 /* 'g' -> */,
-/* pos 02ac: 353 */    0xBA /* ':' -> */,
-/* pos 02ad: 354 */    0x00, 0x38                  /* - terminal marker 56 - */,
-/* pos 02af: 355 */    0xE9 /* 'i' -> */,
-/* pos 02b0: 356 */    0xAD /* '-' -> */,
-/* pos 02b1: 357 */    0xE1 /* 'a' -> */,
-/* pos 02b2: 358 */    0xF2 /* 'r' -> */,
-/* pos 02b3: 359 */    0xE7 /* 'g' -> */,
-/* pos 02b4: 360 */    0xF3 /* 's' -> */,
-/* pos 02b5: 361 */    0x00, 0x3D                  /* - terminal marker 61 - */,
-/* pos 02b7: 362 */    0xA0 /* ' ' -> */,
-/* pos 02b8: 363 */    0x00, 0x3E                  /* - terminal marker 62 - */,
-/* pos 02ba: 364 */    0xAD /* '-' -> */,
-/* pos 02bb: 365 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x02C5 state 366) */,
-                       0x61 /* 'a' */, 0x1D, 0x00  /* (to 0x02DB state 385) */,
-                       0x72 /* 'r' */, 0x14, 0x01  /* (to 0x03D5 state 586) */,
-                       0x08, /* fail */
-/* pos 02c5: 366 */    0xEF /* 'o' -> */,
-/* pos 02c6: 367 */    0xF2 /* 'r' -> */,
-/* pos 02c7: 368 */    0xF7 /* 'w' -> */,
-/* pos 02c8: 369 */    0xE1 /* 'a' -> */,
-/* pos 02c9: 370 */    0xF2 /* 'r' -> */,
-/* pos 02ca: 371 */    0xE4 /* 'd' -> */,
-/* pos 02cb: 372 */    0xE5 /* 'e' -> */,
-/* pos 02cc: 373 */    0xE4 /* 'd' -> */,
-/* pos 02cd: 374 */    0xAD /* '-' -> */,
-/* pos 02ce: 375 */    0xE6 /* 'f' -> */,
-/* pos 02cf: 376 */    0xEF /* 'o' -> */,
-/* pos 02d0: 377 */    0xF2 /* 'r' -> */,
-/* pos 02d1: 378 */    0xBA /* ':' -> */,
-/* pos 02d2: 379 */    0x00, 0x3F                  /* - terminal marker 63 - */,
-/* pos 02d4: 380 */    0x00, 0x40                  /* - terminal marker 64 - */,
-/* pos 02d6: 381 */    0xE1 /* 'a' -> */,
-/* pos 02d7: 382 */    0xE4 /* 'd' -> */,
-/* pos 02d8: 383 */    0xA0 /* ' ' -> */,
-/* pos 02d9: 384 */    0x00, 0x41                  /* - terminal marker 65 - */,
-/* pos 02db: 385 */    0x75 /* 'u' */, 0x07, 0x00  /* (to 0x02E2 state 386) */,
-                       0x6D /* 'm' */, 0x0F, 0x00  /* (to 0x02ED state 396) */,
-                       0x08, /* fail */
-/* pos 02e2: 386 */    0xF4 /* 't' -> */,
-/* pos 02e3: 387 */    0xE8 /* 'h' -> */,
-/* pos 02e4: 388 */    0xAD /* '-' -> */,
-/* pos 02e5: 389 */    0xF4 /* 't' -> */,
-/* pos 02e6: 390 */    0xEF /* 'o' -> */,
-/* pos 02e7: 391 */    0xEB /* 'k' -> */,
-/* pos 02e8: 392 */    0xE5 /* 'e' -> */,
-/* pos 02e9: 393 */    0xEE /* 'n' -> */,
-/* pos 02ea: 394 */    0xBA /* ':' -> */,
-/* pos 02eb: 395 */    0x00, 0x45                  /* - terminal marker 69 - */,
-/* pos 02ed: 396 */    0xFA /* 'z' -> */,
-/* pos 02ee: 397 */    0xEE /* 'n' -> */,
-/* pos 02ef: 398 */    0xAD /* '-' -> */,
-/* pos 02f0: 399 */    0xE4 /* 'd' -> */,
-/* pos 02f1: 400 */    0xF3 /* 's' -> */,
-/* pos 02f2: 401 */    0xF3 /* 's' -> */,
-/* pos 02f3: 402 */    0xAD /* '-' -> */,
-/* pos 02f4: 403 */    0xF3 /* 's' -> */,
-/* pos 02f5: 404 */    0xE9 /* 'i' -> */,
-/* pos 02f6: 405 */    0xE7 /* 'g' -> */,
-/* pos 02f7: 406 */    0xEE /* 'n' -> */,
-/* pos 02f8: 407 */    0xE1 /* 'a' -> */,
-/* pos 02f9: 408 */    0xF4 /* 't' -> */,
-/* pos 02fa: 409 */    0xF5 /* 'u' -> */,
-/* pos 02fb: 410 */    0xF2 /* 'r' -> */,
-/* pos 02fc: 411 */    0xE5 /* 'e' -> */,
-/* pos 02fd: 412 */    0xBA /* ':' -> */,
-/* pos 02fe: 413 */    0x00, 0x46                  /* - terminal marker 70 - */,
-/* pos 0300: 414 */    0xF4 /* 't' -> */,
-/* pos 0301: 415 */    0xE9 /* 'i' -> */,
-/* pos 0302: 416 */    0xEF /* 'o' -> */,
-/* pos 0303: 417 */    0xEE /* 'n' -> */,
-/* pos 0304: 418 */    0xF3 /* 's' -> */,
-/* pos 0305: 419 */    0xA0 /* ' ' -> */,
-/* pos 0306: 420 */    0x00, 0x02                  /* - terminal marker  2 - */,
-/* pos 0308: 421 */    0xF3 /* 's' -> */,
-/* pos 0309: 422 */    0xAD /* '-' -> */,
-/* pos 030a: 423 */    0xE3 /* 'c' -> */,
-/* pos 030b: 424 */    0xEF /* 'o' -> */,
-/* pos 030c: 425 */    0xEE /* 'n' -> */,
-/* pos 030d: 426 */    0xF4 /* 't' -> */,
-/* pos 030e: 427 */    0xF2 /* 'r' -> */,
-/* pos 030f: 428 */    0xEF /* 'o' -> */,
-/* pos 0310: 429 */    0xEC /* 'l' -> */,
-/* pos 0311: 430 */    0xAD /* '-' -> */,
-/* pos 0312: 431 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x0319 state 432) */,
-                       0x61 /* 'a' */, 0x24, 0x00  /* (to 0x0339 state 461) */,
-                       0x08, /* fail */
-/* pos 0319: 432 */    0xE5 /* 'e' -> */,
-/* pos 031a: 433 */    0xF1 /* 'q' -> */,
-/* pos 031b: 434 */    0xF5 /* 'u' -> */,
-/* pos 031c: 435 */    0xE5 /* 'e' -> */,
-/* pos 031d: 436 */    0xF3 /* 's' -> */,
-/* pos 031e: 437 */    0xF4 /* 't' -> */,
-/* pos 031f: 438 */    0xAD /* '-' -> */,
-/* pos 0320: 439 */    0xE8 /* 'h' -> */,
-/* pos 0321: 440 */    0xE5 /* 'e' -> */,
-/* pos 0322: 441 */    0xE1 /* 'a' -> */,
-/* pos 0323: 442 */    0xE4 /* 'd' -> */,
-/* pos 0324: 443 */    0xE5 /* 'e' -> */,
-/* pos 0325: 444 */    0xF2 /* 'r' -> */,
-/* pos 0326: 445 */    0xF3 /* 's' -> */,
-/* pos 0327: 446 */    0xBA /* ':' -> */,
-/* pos 0328: 447 */    0x00, 0x11                  /* - terminal marker 17 - */,
-/* pos 032a: 448 */    0xF2 /* 'r' -> */,
-/* pos 032b: 449 */    0xE5 /* 'e' -> */,
-/* pos 032c: 450 */    0xF2 /* 'r' -> */,
-/* pos 032d: 451 */    0xBA /* ':' -> */,
-/* pos 032e: 452 */    0x00, 0x16                  /* - terminal marker 22 - */,
-/* pos 0330: 453 */    0xE8 /* 'h' -> */,
-/* pos 0331: 454 */    0xE1 /* 'a' -> */,
-/* pos 0332: 455 */    0xF2 /* 'r' -> */,
-/* pos 0333: 456 */    0xF3 /* 's' -> */,
-/* pos 0334: 457 */    0xE5 /* 'e' -> */,
-/* pos 0335: 458 */    0xF4 /* 't' -> */,
-/* pos 0336: 459 */    0xBA /* ':' -> */,
-/* pos 0337: 460 */    0x00, 0x1C                  /* - terminal marker 28 - */,
-/* pos 0339: 461 */    0xEC /* 'l' -> */,
-/* pos 033a: 462 */    0xEC /* 'l' -> */,
-/* pos 033b: 463 */    0xEF /* 'o' -> */,
-/* pos 033c: 464 */    0xF7 /* 'w' -> */,
-/* pos 033d: 465 */    0xAD /* '-' -> */,
-/* pos 033e: 466 */    0xEF /* 'o' -> */,
-/* pos 033f: 467 */    0xF2 /* 'r' -> */,
-/* pos 0340: 468 */    0xE9 /* 'i' -> */,
-/* pos 0341: 469 */    0xE7 /* 'g' -> */,
-/* pos 0342: 470 */    0xE9 /* 'i' -> */,
-/* pos 0343: 471 */    0xEE /* 'n' -> */,
-/* pos 0344: 472 */    0xBA /* ':' -> */,
-/* pos 0345: 473 */    0x00, 0x1E                  /* - terminal marker 30 - */,
-/* pos 0347: 474 */    0xE1 /* 'a' -> */,
-/* pos 0348: 475 */    0xF8 /* 'x' -> */,
-/* pos 0349: 476 */    0xAD /* '-' -> */,
-/* pos 034a: 477 */    0xE6 /* 'f' -> */,
-/* pos 034b: 478 */    0xEF /* 'o' -> */,
-/* pos 034c: 479 */    0xF2 /* 'r' -> */,
-/* pos 034d: 480 */    0xF7 /* 'w' -> */,
-/* pos 034e: 481 */    0xE1 /* 'a' -> */,
-/* pos 034f: 482 */    0xF2 /* 'r' -> */,
-/* pos 0350: 483 */    0xE4 /* 'd' -> */,
-/* pos 0351: 484 */    0xF3 /* 's' -> */,
-/* pos 0352: 485 */    0xBA /* ':' -> */,
-/* pos 0353: 486 */    0x00, 0x30                  /* - terminal marker 48 - */,
-/* pos 0355: 487 */    0xF8 /* 'x' -> */,
-/* pos 0356: 488 */    0xF9 /* 'y' -> */,
-/* pos 0357: 489 */    0x2D /* '-' */, 0x07, 0x00  /* (to 0x035E state 490) */,
-                       0x20 /* ' ' */, 0x79, 0x00  /* (to 0x03D3 state 585) */,
-                       0x08, /* fail */
-/* pos 035e: 490 */    0xE1 /* 'a' -> */,
-/* pos 035f: 491 */    0xF5 /* 'u' -> */,
-/* pos 0360: 492 */    0xF4 /* 't' -> */,
-/* pos 0361: 493 */    0xE8 /* 'h' -> */,
-/* pos 0362: 494 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x0369 state 495) */,
-                       0x6F /* 'o' */, 0x0E, 0x00  /* (to 0x0373 state 504) */,
-                       0x08, /* fail */
-/* pos 0369: 495 */    0xEE /* 'n' -> */,
-/* pos 036a: 496 */    0xF4 /* 't' -> */,
-/* pos 036b: 497 */    0xE9 /* 'i' -> */,
-/* pos 036c: 498 */    0xE3 /* 'c' -> */,
-/* pos 036d: 499 */    0xE1 /* 'a' -> */,
-/* pos 036e: 500 */    0xF4 /* 't' -> */,
-/* pos 036f: 501 */    0xE5 /* 'e' -> */,
-/* pos 0370: 502 */    0xBA /* ':' -> */,
-/* pos 0371: 503 */    0x00, 0x31                  /* - terminal marker 49 - */,
-/* pos 0373: 504 */    0xF2 /* 'r' -> */,
-/* pos 0374: 505 */    0xE9 /* 'i' -> */,
-/* pos 0375: 506 */    0xFA /* 'z' -> */,
-/* pos 0376: 507 */    0xE1 /* 'a' -> */,
-/* pos 0377: 508 */    0xF4 /* 't' -> */,
-/* pos 0378: 509 */    0xE9 /* 'i' -> */,
-/* pos 0379: 510 */    0xEF /* 'o' -> */,
-/* pos 037a: 511 */    0xEE /* 'n' -> */,
-/* pos 037b: 512 */    0xBA /* ':' -> */,
-/* pos 037c: 513 */    0x00, 0x32                  /* - terminal marker 50 - */,
-/* pos 037e: 514 */    0xF2 /* 'r' -> */,
-/* pos 037f: 515 */    0xE9 /* 'i' -> */,
-/* pos 0380: 516 */    0xE3 /* 'c' -> */,
-/* pos 0381: 517 */    0xF4 /* 't' -> */,
-/* pos 0382: 518 */    0xAD /* '-' -> */,
-/* pos 0383: 519 */    0xF4 /* 't' -> */,
-/* pos 0384: 520 */    0xF2 /* 'r' -> */,
-/* pos 0385: 521 */    0xE1 /* 'a' -> */,
-/* pos 0386: 522 */    0xEE /* 'n' -> */,
-/* pos 0387: 523 */    0xF3 /* 's' -> */,
-/* pos 0388: 524 */    0xF0 /* 'p' -> */,
-/* pos 0389: 525 */    0xEF /* 'o' -> */,
-/* pos 038a: 526 */    0xF2 /* 'r' -> */,
-/* pos 038b: 527 */    0xF4 /* 't' -> */,
-/* pos 038c: 528 */    0xAD /* '-' -> */,
-/* pos 038d: 529 */    0xF3 /* 's' -> */,
-/* pos 038e: 530 */    0xE5 /* 'e' -> */,
-/* pos 038f: 531 */    0xE3 /* 'c' -> */,
-/* pos 0390: 532 */    0xF5 /* 'u' -> */,
-/* pos 0391: 533 */    0xF2 /* 'r' -> */,
-/* pos 0392: 534 */    0xE9 /* 'i' -> */,
-/* pos 0393: 535 */    0xF4 /* 't' -> */,
-/* pos 0394: 536 */    0xF9 /* 'y' -> */,
-/* pos 0395: 537 */    0xBA /* ':' -> */,
-/* pos 0396: 538 */    0x00, 0x37                  /* - terminal marker 55 - */,
-/* pos 0398: 539 */    0xE5 /* 'e' -> */,
-/* pos 0399: 540 */    0xF2 /* 'r' -> */,
-/* pos 039a: 541 */    0xAD /* '-' -> */,
-/* pos 039b: 542 */    0xE1 /* 'a' -> */,
-/* pos 039c: 543 */    0xE7 /* 'g' -> */,
-/* pos 039d: 544 */    0xE5 /* 'e' -> */,
-/* pos 039e: 545 */    0xEE /* 'n' -> */,
-/* pos 039f: 546 */    0xF4 /* 't' -> */,
-/* pos 03a0: 547 */    0xBA /* ':' -> */,
-/* pos 03a1: 548 */    0x00, 0x39                  /* - terminal marker 57 - */,
-/* pos 03a3: 549 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x03AA state 550) */,
-                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x03AF state 554) */,
-                       0x08, /* fail */
-/* pos 03aa: 550 */    0xF2 /* 'r' -> */,
-/* pos 03ab: 551 */    0xF9 /* 'y' -> */,
-/* pos 03ac: 552 */    0xBA /* ':' -> */,
-/* pos 03ad: 553 */    0x00, 0x3A                  /* - terminal marker 58 - */,
-/* pos 03af: 554 */    0xE1 /* 'a' -> */,
-/* pos 03b0: 555 */    0xBA /* ':' -> */,
-/* pos 03b1: 556 */    0x00, 0x3B                  /* - terminal marker 59 - */,
-/* pos 03b3: 557 */    0xF7 /* 'w' -> */,
-/* pos 03b4: 558 */    0xF7 /* 'w' -> */,
-/* pos 03b5: 559 */    0xAD /* '-' -> */,
-/* pos 03b6: 560 */    0xE1 /* 'a' -> */,
-/* pos 03b7: 561 */    0xF5 /* 'u' -> */,
-/* pos 03b8: 562 */    0xF4 /* 't' -> */,
-/* pos 03b9: 563 */    0xE8 /* 'h' -> */,
-/* pos 03ba: 564 */    0xE5 /* 'e' -> */,
-/* pos 03bb: 565 */    0xEE /* 'n' -> */,
-/* pos 03bc: 566 */    0xF4 /* 't' -> */,
-/* pos 03bd: 567 */    0xE9 /* 'i' -> */,
-/* pos 03be: 568 */    0xE3 /* 'c' -> */,
-/* pos 03bf: 569 */    0xE1 /* 'a' -> */,
-/* pos 03c0: 570 */    0xF4 /* 't' -> */,
-/* pos 03c1: 571 */    0xE5 /* 'e' -> */,
-/* pos 03c2: 572 */    0xBA /* ':' -> */,
-/* pos 03c3: 573 */    0x00, 0x3C                  /* - terminal marker 60 - */,
-/* pos 03c5: 574 */    0xF4 /* 't' -> */,
-/* pos 03c6: 575 */    0xE3 /* 'c' -> */,
-/* pos 03c7: 576 */    0xE8 /* 'h' -> */,
-/* pos 03c8: 577 */    0x00, 0x43                  /* - terminal marker 67 - */,
-/* pos 03ca: 578 */    0xF4 /* 't' -> */,
-/* pos 03cb: 579 */    0x00, 0x44                  /* - terminal marker 68 - */,
-/* pos 03cd: 580 */    0xEC /* 'l' -> */,
-/* pos 03ce: 581 */    0xE5 /* 'e' -> */,
-/* pos 03cf: 582 */    0xF4 /* 't' -> */,
-/* pos 03d0: 583 */    0xE5 /* 'e' -> */,
-/* pos 03d1: 584 */    0x00, 0x45                  /* - terminal marker 69 - */,
-/* pos 03d3: 585 */    0x00, 0x47                  /* - terminal marker 71 - */,
-/* pos 03d5: 586 */    0xE5 /* 'e' -> */,
-/* pos 03d6: 587 */    0xE1 /* 'a' -> */,
-/* pos 03d7: 588 */    0xEC /* 'l' -> */,
-/* pos 03d8: 589 */    0xAD /* '-' -> */,
-/* pos 03d9: 590 */    0xE9 /* 'i' -> */,
-/* pos 03da: 591 */    0xF0 /* 'p' -> */,
-/* pos 03db: 592 */    0xBA /* ':' -> */,
-/* pos 03dc: 593 */    0x00, 0x48                  /* - terminal marker 72 - */,
-/* pos 03de: 594 */    0xBA /* ':' -> */,
-/* pos 03df: 595 */    0x00, 0x42                  /* - terminal marker 66 - */,
-/* pos 03e1: 596 */    0xEC /* 'l' -> */,
-/* pos 03e2: 597 */    0xE1 /* 'a' -> */,
-/* pos 03e3: 598 */    0xF9 /* 'y' -> */,
-/* pos 03e4: 599 */    0xAD /* '-' -> */,
-/* pos 03e5: 600 */    0xEE /* 'n' -> */,
-/* pos 03e6: 601 */    0xEF /* 'o' -> */,
-/* pos 03e7: 602 */    0xEE /* 'n' -> */,
-/* pos 03e8: 603 */    0xE3 /* 'c' -> */,
-/* pos 03e9: 604 */    0xE5 /* 'e' -> */,
-/* pos 03ea: 605 */    0xBA /* ':' -> */,
-/* pos 03eb: 606 */    0x00, 0x43                  /* - terminal marker 67 - */,
-/* pos 03ed: 607 */    0xAD /* '-' -> */,
-/* pos 03ee: 608 */    0xF7 /* 'w' -> */,
-/* pos 03ef: 609 */    0xE5 /* 'e' -> */,
-/* pos 03f0: 610 */    0xE2 /* 'b' -> */,
-/* pos 03f1: 611 */    0xF3 /* 's' -> */,
-/* pos 03f2: 612 */    0xEF /* 'o' -> */,
-/* pos 03f3: 613 */    0xE3 /* 'c' -> */,
-/* pos 03f4: 614 */    0xEB /* 'k' -> */,
-/* pos 03f5: 615 */    0xE5 /* 'e' -> */,
-/* pos 03f6: 616 */    0xF4 /* 't' -> */,
-/* pos 03f7: 617 */    0xAD /* '-' -> */,
-/* pos 03f8: 618 */    0x64 /* 'd' */, 0x19, 0x00  /* (to 0x0411 state 619) */,
-                       0x65 /* 'e' */, 0x1D, 0x00  /* (to 0x0418 state 625) */,
-                       0x6B /* 'k' */, 0x26, 0x00  /* (to 0x0424 state 636) */,
-                       0x70 /* 'p' */, 0x35, 0x00  /* (to 0x0436 state 643) */,
-                       0x61 /* 'a' */, 0x3C, 0x00  /* (to 0x0440 state 652) */,
-                       0x6E /* 'n' */, 0x41, 0x00  /* (to 0x0448 state 659) */,
-                       0x76 /* 'v' */, 0x47, 0x00  /* (to 0x0451 state 666) */,
-                       0x6F /* 'o' */, 0x4D, 0x00  /* (to 0x045A state 674) */,
-                       0x08, /* fail */
-/* pos 0411: 619 */    0xF2 /* 'r' -> */,
-/* pos 0412: 620 */    0xE1 /* 'a' -> */,
-/* pos 0413: 621 */    0xE6 /* 'f' -> */,
-/* pos 0414: 622 */    0xF4 /* 't' -> */,
-/* pos 0415: 623 */    0xBA /* ':' -> */,
-/* pos 0416: 624 */    0x00, 0x07                  /* - terminal marker  7 - */,
-/* pos 0418: 625 */    0xF8 /* 'x' -> */,
-/* pos 0419: 626 */    0xF4 /* 't' -> */,
-/* pos 041a: 627 */    0xE5 /* 'e' -> */,
-/* pos 041b: 628 */    0xEE /* 'n' -> */,
-/* pos 041c: 629 */    0xF3 /* 's' -> */,
-/* pos 041d: 630 */    0xE9 /* 'i' -> */,
-/* pos 041e: 631 */    0xEF /* 'o' -> */,
-/* pos 041f: 632 */    0xEE /* 'n' -> */,
-/* pos 0420: 633 */    0xF3 /* 's' -> */,
-/* pos 0421: 634 */    0xBA /* ':' -> */,
-/* pos 0422: 635 */    0x00, 0x09                  /* - terminal marker  9 - */,
-/* pos 0424: 636 */    0xE5 /* 'e' -> */,
-/* pos 0425: 637 */    0xF9 /* 'y' -> */,
-/* pos 0426: 638 */    0x31 /* '1' */, 0x0A, 0x00  /* (to 0x0430 state 639) */,
-                       0x32 /* '2' */, 0x0A, 0x00  /* (to 0x0433 state 641) */,
-                       0x3A /* ':' */, 0x23, 0x00  /* (to 0x044F state 665) */,
-                       0x08, /* fail */
-/* pos 0430: 639 */    0xBA /* ':' -> */,
-/* pos 0431: 640 */    0x00, 0x0A                  /* - terminal marker 10 - */,
-/* pos 0433: 641 */    0xBA /* ':' -> */,
-/* pos 0434: 642 */    0x00, 0x0B                  /* - terminal marker 11 - */,
-/* pos 0436: 643 */    0xF2 /* 'r' -> */,
-/* pos 0437: 644 */    0xEF /* 'o' -> */,
-/* pos 0438: 645 */    0xF4 /* 't' -> */,
-/* pos 0439: 646 */    0xEF /* 'o' -> */,
-/* pos 043a: 647 */    0xE3 /* 'c' -> */,
-/* pos 043b: 648 */    0xEF /* 'o' -> */,
-/* pos 043c: 649 */    0xEC /* 'l' -> */,
-/* pos 043d: 650 */    0xBA /* ':' -> */,
-/* pos 043e: 651 */    0x00, 0x0C                  /* - terminal marker 12 - */,
-/* pos 0440: 652 */    0xE3 /* 'c' -> */,
-/* pos 0441: 653 */    0xE3 /* 'c' -> */,
-/* pos 0442: 654 */    0xE5 /* 'e' -> */,
-/* pos 0443: 655 */    0xF0 /* 'p' -> */,
-/* pos 0444: 656 */    0xF4 /* 't' -> */,
-/* pos 0445: 657 */    0xBA /* ':' -> */,
-/* pos 0446: 658 */    0x00, 0x0D                  /* - terminal marker 13 - */,
-/* pos 0448: 659 */    0xEF /* 'o' -> */,
-/* pos 0449: 660 */    0xEE /* 'n' -> */,
-/* pos 044a: 661 */    0xE3 /* 'c' -> */,
-/* pos 044b: 662 */    0xE5 /* 'e' -> */,
-/* pos 044c: 663 */    0xBA /* ':' -> */,
-/* pos 044d: 664 */    0x00, 0x0E                  /* - terminal marker 14 - */,
-/* pos 044f: 665 */    0x00, 0x1F                  /* - terminal marker 31 - */,
-/* pos 0451: 666 */    0xE5 /* 'e' -> */,
-/* pos 0452: 667 */    0xF2 /* 'r' -> */,
-/* pos 0453: 668 */    0xF3 /* 's' -> */,
-/* pos 0454: 669 */    0xE9 /* 'i' -> */,
-/* pos 0455: 670 */    0xEF /* 'o' -> */,
-/* pos 0456: 671 */    0xEE /* 'n' -> */,
-/* pos 0457: 672 */    0xBA /* ':' -> */,
-/* pos 0458: 673 */    0x00, 0x20                  /* - terminal marker 32 - */,
-/* pos 045a: 674 */    0xF2 /* 'r' -> */,
-/* pos 045b: 675 */    0xE9 /* 'i' -> */,
-/* pos 045c: 676 */    0xE7 /* 'g' -> */,
-/* pos 045d: 677 */    0xE9 /* 'i' -> */,
-/* pos 045e: 678 */    0xEE /* 'n' -> */,
-/* pos 045f: 679 */    0xBA /* ':' -> */,
-/* pos 0460: 680 */    0x00, 0x21                  /* - terminal marker 33 - */,
-/* pos 0462: 681 */    0xAD /* '-' -> */,
-/* pos 0463: 682 */    0xF3 /* 's' -> */,
-/* pos 0464: 683 */    0xE5 /* 'e' -> */,
-/* pos 0465: 684 */    0xF4 /* 't' -> */,
-/* pos 0466: 685 */    0xF4 /* 't' -> */,
-/* pos 0467: 686 */    0xE9 /* 'i' -> */,
-/* pos 0468: 687 */    0xEE /* 'n' -> */,
-/* pos 0469: 688 */    0xE7 /* 'g' -> */,
-/* pos 046a: 689 */    0xF3 /* 's' -> */,
-/* pos 046b: 690 */    0xBA /* ':' -> */,
-/* pos 046c: 691 */    0x00, 0x08                  /* - terminal marker  8 - */,
-/* pos 046e: 692 */    0x61 /* 'a' */, 0x0D, 0x00  /* (to 0x047B state 693) */,
-                       0x6D /* 'm' */, 0x14, 0x00  /* (to 0x0485 state 702) */,
-                       0x70 /* 'p' */, 0x18, 0x00  /* (to 0x048C state 708) */,
-                       0x73 /* 's' */, 0x20, 0x00  /* (to 0x0497 state 712) */,
-                       0x08, /* fail */
-/* pos 047b: 693 */    0xF5 /* 'u' -> */,
-/* pos 047c: 694 */    0xF4 /* 't' -> */,
-/* pos 047d: 695 */    0xE8 /* 'h' -> */,
-/* pos 047e: 696 */    0xEF /* 'o' -> */,
-/* pos 047f: 697 */    0xF2 /* 'r' -> */,
-/* pos 0480: 698 */    0xE9 /* 'i' -> */,
-/* pos 0481: 699 */    0xF4 /* 't' -> */,
-/* pos 0482: 700 */    0xF9 /* 'y' -> */,
-/* pos 0483: 701 */    0x00, 0x17                  /* - terminal marker 23 - */,
-/* pos 0485: 702 */    0xE5 /* 'e' -> */,
-/* pos 0486: 703 */    0xF4 /* 't' -> */,
-/* pos 0487: 704 */    0xE8 /* 'h' -> */,
-/* pos 0488: 705 */    0xEF /* 'o' -> */,
-/* pos 0489: 706 */    0xE4 /* 'd' -> */,
-/* pos 048a: 707 */    0x00, 0x18                  /* - terminal marker 24 - */,
-/* pos 048c: 708 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0493 state 709) */,
-                       0x72 /* 'r' */, 0x1B, 0x00  /* (to 0x04AA state 723) */,
-                       0x08, /* fail */
-/* pos 0493: 709 */    0xF4 /* 't' -> */,
-/* pos 0494: 710 */    0xE8 /* 'h' -> */,
-/* pos 0495: 711 */    0x00, 0x19                  /* - terminal marker 25 - */,
-/* pos 0497: 712 */    0x63 /* 'c' */, 0x07, 0x00  /* (to 0x049E state 713) */,
-                       0x74 /* 't' */, 0x0A, 0x00  /* (to 0x04A4 state 718) */,
-                       0x08, /* fail */
-/* pos 049e: 713 */    0xE8 /* 'h' -> */,
-/* pos 049f: 714 */    0xE5 /* 'e' -> */,
-/* pos 04a0: 715 */    0xED /* 'm' -> */,
-/* pos 04a1: 716 */    0xE5 /* 'e' -> */,
-/* pos 04a2: 717 */    0x00, 0x1A                  /* - terminal marker 26 - */,
-/* pos 04a4: 718 */    0xE1 /* 'a' -> */,
-/* pos 04a5: 719 */    0xF4 /* 't' -> */,
-/* pos 04a6: 720 */    0xF5 /* 'u' -> */,
-/* pos 04a7: 721 */    0xF3 /* 's' -> */,
-/* pos 04a8: 722 */    0x00, 0x1B                  /* - terminal marker 27 - */,
-/* pos 04aa: 723 */    0xEF /* 'o' -> */,
-/* pos 04ab: 724 */    0xF4 /* 't' -> */,
-/* pos 04ac: 725 */    0xEF /* 'o' -> */,
-/* pos 04ad: 726 */    0xE3 /* 'c' -> */,
-/* pos 04ae: 727 */    0xEF /* 'o' -> */,
-/* pos 04af: 728 */    0xEC /* 'l' -> */,
-/* pos 04b0: 729 */    0x00, 0x44                  /* - terminal marker 68 - */,
-/* total size 1202 bytes */
+/* pos 0134: 106 */    0x61 /* 'a' */, 0x0A, 0x00  /* (to 0x013E state 107) */,
+                       0x6F /* 'o' */, 0x21, 0x02  /* (to 0x0358 state 487) */,
+                       0x69 /* 'i' */, 0x7B, 0x03  /* (to 0x04B5 state 730) */,
+                       0x08, /* fail */
+/* pos 013e: 107 */    0xE7 /* 'g' -> */,
+/* pos 013f: 108 */    0xED /* 'm' -> */,
+/* pos 0140: 109 */    0xE1 /* 'a' -> */,
+/* pos 0141: 110 */    0xBA /* ':' -> */,
+/* pos 0142: 111 */    0x00, 0x0E                  /* - terminal marker 14 - */,
+/* pos 0144: 112 */    0xE3 /* 'c' -> */,
+/* pos 0145: 113 */    0xE8 /* 'h' -> */,
+/* pos 0146: 114 */    0xE5 /* 'e' -> */,
+/* pos 0147: 115 */    0xAD /* '-' -> */,
+/* pos 0148: 116 */    0xE3 /* 'c' -> */,
+/* pos 0149: 117 */    0xEF /* 'o' -> */,
+/* pos 014a: 118 */    0xEE /* 'n' -> */,
+/* pos 014b: 119 */    0xF4 /* 't' -> */,
+/* pos 014c: 120 */    0xF2 /* 'r' -> */,
+/* pos 014d: 121 */    0xEF /* 'o' -> */,
+/* pos 014e: 122 */    0xEC /* 'l' -> */,
+/* pos 014f: 123 */    0xBA /* ':' -> */,
+/* pos 0150: 124 */    0x00, 0x0F                  /* - terminal marker 15 - */,
+/* pos 0152: 125 */    0xF4 /* 't' -> */,
+/* pos 0153: 126 */    0xE8 /* 'h' -> */,
+/* pos 0154: 127 */    0xEF /* 'o' -> */,
+/* pos 0155: 128 */    0xF2 /* 'r' -> */,
+/* pos 0156: 129 */    0xE9 /* 'i' -> */,
+/* pos 0157: 130 */    0xFA /* 'z' -> */,
+/* pos 0158: 131 */    0xE1 /* 'a' -> */,
+/* pos 0159: 132 */    0xF4 /* 't' -> */,
+/* pos 015a: 133 */    0xE9 /* 'i' -> */,
+/* pos 015b: 134 */    0xEF /* 'o' -> */,
+/* pos 015c: 135 */    0xEE /* 'n' -> */,
+/* pos 015d: 136 */    0xBA /* ':' -> */,
+/* pos 015e: 137 */    0x00, 0x10                  /* - terminal marker 16 - */,
+/* pos 0160: 138 */    0xEB /* 'k' -> */,
+/* pos 0161: 139 */    0xE9 /* 'i' -> */,
+/* pos 0162: 140 */    0xE5 /* 'e' -> */,
+/* pos 0163: 141 */    0xBA /* ':' -> */,
+/* pos 0164: 142 */    0x00, 0x11                  /* - terminal marker 17 - */,
+/* pos 0166: 143 */    0xE5 /* 'e' -> */,
+/* pos 0167: 144 */    0xEE /* 'n' -> */,
+/* pos 0168: 145 */    0xF4 /* 't' -> */,
+/* pos 0169: 146 */    0xAD /* '-' -> */,
+/* pos 016a: 147 */    0x6C /* 'l' */, 0x10, 0x00  /* (to 0x017A state 148) */,
+                       0x74 /* 't' */, 0x1E, 0x00  /* (to 0x018B state 155) */,
+                       0x64 /* 'd' */, 0x4C, 0x00  /* (to 0x01BC state 186) */,
+                       0x65 /* 'e' */, 0x56, 0x00  /* (to 0x01C9 state 198) */,
+                       0x72 /* 'r' */, 0x6F, 0x00  /* (to 0x01E5 state 223) */,
+                       0x08, /* fail */
+/* pos 017a: 148 */    0x65 /* 'e' */, 0x0A, 0x00  /* (to 0x0184 state 149) */,
+                       0x61 /* 'a' */, 0x56, 0x00  /* (to 0x01D3 state 207) */,
+                       0x6F /* 'o' */, 0x5C, 0x00  /* (to 0x01DC state 215) */,
+                       0x08, /* fail */
+/* pos 0184: 149 */    0xEE /* 'n' -> */,
+/* pos 0185: 150 */    0xE7 /* 'g' -> */,
+/* pos 0186: 151 */    0xF4 /* 't' -> */,
+/* pos 0187: 152 */    0xE8 /* 'h' -> */,
+/* pos 0188: 153 */    0xBA /* ':' -> */,
+/* pos 0189: 154 */    0x00, 0x12                  /* - terminal marker 18 - */,
+/* pos 018b: 155 */    0xF9 /* 'y' -> */,
+/* pos 018c: 156 */    0xF0 /* 'p' -> */,
+/* pos 018d: 157 */    0xE5 /* 'e' -> */,
+/* pos 018e: 158 */    0xBA /* ':' -> */,
+/* pos 018f: 159 */    0x00, 0x13                  /* - terminal marker 19 - */,
+/* pos 0191: 160 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0198 state 161) */,
+                       0x65 /* 'e' */, 0x3C, 0x02  /* (to 0x03D0 state 580) */,
+                       0x08, /* fail */
+/* pos 0198: 161 */    0xF4 /* 't' -> */,
+/* pos 0199: 162 */    0xE5 /* 'e' -> */,
+/* pos 019a: 163 */    0xBA /* ':' -> */,
+/* pos 019b: 164 */    0x00, 0x14                  /* - terminal marker 20 - */,
+/* pos 019d: 165 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x01A4 state 166) */,
+                       0x65 /* 'e' */, 0xB6, 0x00  /* (to 0x0256 state 304) */,
+                       0x08, /* fail */
+/* pos 01a4: 166 */    0xEE /* 'n' -> */,
+/* pos 01a5: 167 */    0xE7 /* 'g' -> */,
+/* pos 01a6: 168 */    0xE5 /* 'e' -> */,
+/* pos 01a7: 169 */    0xBA /* ':' -> */,
+/* pos 01a8: 170 */    0x00, 0x15                  /* - terminal marker 21 - */,
+/* pos 01aa: 171 */    0xE1 /* 'a' -> */,
+/* pos 01ab: 172 */    0xEE /* 'n' -> */,
+/* pos 01ac: 173 */    0xE7 /* 'g' -> */,
+/* pos 01ad: 174 */    0xE5 /* 'e' -> */,
+/* pos 01ae: 175 */    0xF3 /* 's' -> */,
+/* pos 01af: 176 */    0xBA /* ':' -> */,
+/* pos 01b0: 177 */    0x00, 0x1D                  /* - terminal marker 29 - */,
+/* pos 01b2: 178 */    0xE5 /* 'e' -> */,
+/* pos 01b3: 179 */    0xBA /* ':' -> */,
+/* pos 01b4: 180 */    0x00, 0x1F                  /* - terminal marker 31 - */,
+/* pos 01b6: 181 */    0xEC /* 'l' -> */,
+/* pos 01b7: 182 */    0xEF /* 'o' -> */,
+/* pos 01b8: 183 */    0xF7 /* 'w' -> */,
+/* pos 01b9: 184 */    0xBA /* ':' -> */,
+/* pos 01ba: 185 */    0x00, 0x20                  /* - terminal marker 32 - */,
+/* pos 01bc: 186 */    0xE9 /* 'i' -> */,
+/* pos 01bd: 187 */    0xF3 /* 's' -> */,
+/* pos 01be: 188 */    0xF0 /* 'p' -> */,
+/* pos 01bf: 189 */    0xEF /* 'o' -> */,
+/* pos 01c0: 190 */    0xF3 /* 's' -> */,
+/* pos 01c1: 191 */    0xE9 /* 'i' -> */,
+/* pos 01c2: 192 */    0xF4 /* 't' -> */,
+/* pos 01c3: 193 */    0xE9 /* 'i' -> */,
+/* pos 01c4: 194 */    0xEF /* 'o' -> */,
+/* pos 01c5: 195 */    0xEE /* 'n' -> */,
+/* pos 01c6: 196 */    0xBA /* ':' -> */,
+/* pos 01c7: 197 */    0x00, 0x21                  /* - terminal marker 33 - */,
+/* pos 01c9: 198 */    0xEE /* 'n' -> */,
+/* pos 01ca: 199 */    0xE3 /* 'c' -> */,
+/* pos 01cb: 200 */    0xEF /* 'o' -> */,
+/* pos 01cc: 201 */    0xE4 /* 'd' -> */,
+/* pos 01cd: 202 */    0xE9 /* 'i' -> */,
+/* pos 01ce: 203 */    0xEE /* 'n' -> */,
+/* pos 01cf: 204 */    0xE7 /* 'g' -> */,
+/* pos 01d0: 205 */    0xBA /* ':' -> */,
+/* pos 01d1: 206 */    0x00, 0x22                  /* - terminal marker 34 - */,
+/* pos 01d3: 207 */    0xEE /* 'n' -> */,
+/* pos 01d4: 208 */    0xE7 /* 'g' -> */,
+/* pos 01d5: 209 */    0xF5 /* 'u' -> */,
+/* pos 01d6: 210 */    0xE1 /* 'a' -> */,
+/* pos 01d7: 211 */    0xE7 /* 'g' -> */,
+/* pos 01d8: 212 */    0xE5 /* 'e' -> */,
+/* pos 01d9: 213 */    0xBA /* ':' -> */,
+/* pos 01da: 214 */    0x00, 0x23                  /* - terminal marker 35 - */,
+/* pos 01dc: 215 */    0xE3 /* 'c' -> */,
+/* pos 01dd: 216 */    0xE1 /* 'a' -> */,
+/* pos 01de: 217 */    0xF4 /* 't' -> */,
+/* pos 01df: 218 */    0xE9 /* 'i' -> */,
+/* pos 01e0: 219 */    0xEF /* 'o' -> */,
+/* pos 01e1: 220 */    0xEE /* 'n' -> */,
+/* pos 01e2: 221 */    0xBA /* ':' -> */,
+/* pos 01e3: 222 */    0x00, 0x24                  /* - terminal marker 36 - */,
+/* pos 01e5: 223 */    0xE1 /* 'a' -> */,
+/* pos 01e6: 224 */    0xEE /* 'n' -> */,
+/* pos 01e7: 225 */    0xE7 /* 'g' -> */,
+/* pos 01e8: 226 */    0xE5 /* 'e' -> */,
+/* pos 01e9: 227 */    0xBA /* ':' -> */,
+/* pos 01ea: 228 */    0x00, 0x25                  /* - terminal marker 37 - */,
+/* pos 01ec: 229 */    0x74 /* 't' */, 0x07, 0x00  /* (to 0x01F3 state 230) */,
+                       0x78 /* 'x' */, 0x09, 0x00  /* (to 0x01F8 state 234) */,
+                       0x08, /* fail */
+/* pos 01f3: 230 */    0xE1 /* 'a' -> */,
+/* pos 01f4: 231 */    0xE7 /* 'g' -> */,
+/* pos 01f5: 232 */    0xBA /* ':' -> */,
+/* pos 01f6: 233 */    0x00, 0x26                  /* - terminal marker 38 - */,
+/* pos 01f8: 234 */    0xF0 /* 'p' -> */,
+/* pos 01f9: 235 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x0200 state 236) */,
+                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x0205 state 240) */,
+                       0x08, /* fail */
+/* pos 0200: 236 */    0xE3 /* 'c' -> */,
+/* pos 0201: 237 */    0xF4 /* 't' -> */,
+/* pos 0202: 238 */    0xBA /* ':' -> */,
+/* pos 0203: 239 */    0x00, 0x27                  /* - terminal marker 39 - */,
+/* pos 0205: 240 */    0xF2 /* 'r' -> */,
+/* pos 0206: 241 */    0xE5 /* 'e' -> */,
+/* pos 0207: 242 */    0xF3 /* 's' -> */,
+/* pos 0208: 243 */    0xBA /* ':' -> */,
+/* pos 0209: 244 */    0x00, 0x28                  /* - terminal marker 40 - */,
+/* pos 020b: 245 */    0xF2 /* 'r' -> */,
+/* pos 020c: 246 */    0xEF /* 'o' -> */,
+/* pos 020d: 247 */    0xED /* 'm' -> */,
+/* pos 020e: 248 */    0xBA /* ':' -> */,
+/* pos 020f: 249 */    0x00, 0x29                  /* - terminal marker 41 - */,
+/* pos 0211: 250 */    0xF4 /* 't' -> */,
+/* pos 0212: 251 */    0xE3 /* 'c' -> */,
+/* pos 0213: 252 */    0xE8 /* 'h' -> */,
+/* pos 0214: 253 */    0xBA /* ':' -> */,
+/* pos 0215: 254 */    0x00, 0x2A                  /* - terminal marker 42 - */,
+/* pos 0217: 255 */    0xE1 /* 'a' -> */,
+/* pos 0218: 256 */    0xEE /* 'n' -> */,
+/* pos 0219: 257 */    0xE7 /* 'g' -> */,
+/* pos 021a: 258 */    0xE5 /* 'e' -> */,
+/* pos 021b: 259 */    0xBA /* ':' -> */,
+/* pos 021c: 260 */    0x00, 0x2B                  /* - terminal marker 43 - */,
+/* pos 021e: 261 */    0xEE /* 'n' -> */,
+/* pos 021f: 262 */    0xED /* 'm' -> */,
+/* pos 0220: 263 */    0xEF /* 'o' -> */,
+/* pos 0221: 264 */    0xE4 /* 'd' -> */,
+/* pos 0222: 265 */    0xE9 /* 'i' -> */,
+/* pos 0223: 266 */    0xE6 /* 'f' -> */,
+/* pos 0224: 267 */    0xE9 /* 'i' -> */,
+/* pos 0225: 268 */    0xE5 /* 'e' -> */,
+/* pos 0226: 269 */    0xE4 /* 'd' -> */,
+/* pos 0227: 270 */    0xAD /* '-' -> */,
+/* pos 0228: 271 */    0xF3 /* 's' -> */,
+/* pos 0229: 272 */    0xE9 /* 'i' -> */,
+/* pos 022a: 273 */    0xEE /* 'n' -> */,
+/* pos 022b: 274 */    0xE3 /* 'c' -> */,
+/* pos 022c: 275 */    0xE5 /* 'e' -> */,
+/* pos 022d: 276 */    0xBA /* ':' -> */,
+/* pos 022e: 277 */    0x00, 0x2C                  /* - terminal marker 44 - */,
+/* pos 0230: 278 */    0x61 /* 'a' */, 0x0A, 0x00  /* (to 0x023A state 279) */,
+                       0x69 /* 'i' */, 0x15, 0x00  /* (to 0x0248 state 292) */,
+                       0x6F /* 'o' */, 0x17, 0x00  /* (to 0x024D state 296) */,
+                       0x08, /* fail */
+/* pos 023a: 279 */    0xF3 /* 's' -> */,
+/* pos 023b: 280 */    0xF4 /* 't' -> */,
+/* pos 023c: 281 */    0xAD /* '-' -> */,
+/* pos 023d: 282 */    0xED /* 'm' -> */,
+/* pos 023e: 283 */    0xEF /* 'o' -> */,
+/* pos 023f: 284 */    0xE4 /* 'd' -> */,
+/* pos 0240: 285 */    0xE9 /* 'i' -> */,
+/* pos 0241: 286 */    0xE6 /* 'f' -> */,
+/* pos 0242: 287 */    0xE9 /* 'i' -> */,
+/* pos 0243: 288 */    0xE5 /* 'e' -> */,
+/* pos 0244: 289 */    0xE4 /* 'd' -> */,
+/* pos 0245: 290 */    0xBA /* ':' -> */,
+/* pos 0246: 291 */    0x00, 0x2D                  /* - terminal marker 45 - */,
+/* pos 0248: 292 */    0xEE /* 'n' -> */,
+/* pos 0249: 293 */    0xEB /* 'k' -> */,
+/* pos 024a: 294 */    0xBA /* ':' -> */,
+/* pos 024b: 295 */    0x00, 0x2E                  /* - terminal marker 46 - */,
+/* pos 024d: 296 */    0xE3 /* 'c' -> */,
+/* pos 024e: 297 */    0xE1 /* 'a' -> */,
+/* pos 024f: 298 */    0xF4 /* 't' -> */,
+/* pos 0250: 299 */    0xE9 /* 'i' -> */,
+/* pos 0251: 300 */    0xEF /* 'o' -> */,
+/* pos 0252: 301 */    0xEE /* 'n' -> */,
+/* pos 0253: 302 */    0xBA /* ':' -> */,
+/* pos 0254: 303 */    0x00, 0x2F                  /* - terminal marker 47 - */,
+/* pos 0256: 304 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x0260 state 305) */,
+                       0x74 /* 't' */, 0x14, 0x00  /* (to 0x026D state 311) */,
+                       0x70 /* 'p' */, 0x88, 0x01  /* (to 0x03E4 state 596) */,
+                       0x08, /* fail */
+/* pos 0260: 305 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x0267 state 306) */,
+                       0x65 /* 'e' */, 0xCA, 0x00  /* (to 0x032D state 448) */,
+                       0x08, /* fail */
+/* pos 0267: 306 */    0xE5 /* 'e' -> */,
+/* pos 0268: 307 */    0xF3 /* 's' -> */,
+/* pos 0269: 308 */    0xE8 /* 'h' -> */,
+/* pos 026a: 309 */    0xBA /* ':' -> */,
+/* pos 026b: 310 */    0x00, 0x33                  /* - terminal marker 51 - */,
+/* pos 026d: 311 */    0xF2 /* 'r' -> */,
+/* pos 026e: 312 */    0xF9 /* 'y' -> */,
+/* pos 026f: 313 */    0xAD /* '-' -> */,
+/* pos 0270: 314 */    0xE1 /* 'a' -> */,
+/* pos 0271: 315 */    0xE6 /* 'f' -> */,
+/* pos 0272: 316 */    0xF4 /* 't' -> */,
+/* pos 0273: 317 */    0xE5 /* 'e' -> */,
+/* pos 0274: 318 */    0xF2 /* 'r' -> */,
+/* pos 0275: 319 */    0xBA /* ':' -> */,
+/* pos 0276: 320 */    0x00, 0x34                  /* - terminal marker 52 - */,
+/* pos 0278: 321 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x027F state 322) */,
+                       0x74 /* 't' */, 0x06, 0x01  /* (to 0x0381 state 514) */,
+                       0x08, /* fail */
+/* pos 027f: 322 */    0x72 /* 'r' */, 0x0A, 0x00  /* (to 0x0289 state 323) */,
+                       0x74 /* 't' */, 0x0D, 0x00  /* (to 0x028F state 328) */,
+                       0x63 /* 'c' */, 0x6B, 0x01  /* (to 0x03F0 state 607) */,
+                       0x08, /* fail */
+/* pos 0289: 323 */    0xF6 /* 'v' -> */,
+/* pos 028a: 324 */    0xE5 /* 'e' -> */,
+/* pos 028b: 325 */    0xF2 /* 'r' -> */,
+/* pos 028c: 326 */    0xBA /* ':' -> */,
+/* pos 028d: 327 */    0x00, 0x35                  /* - terminal marker 53 - */,
+/* pos 028f: 328 */    0xAD /* '-' -> */,
+/* pos 0290: 329 */    0xE3 /* 'c' -> */,
+/* pos 0291: 330 */    0xEF /* 'o' -> */,
+/* pos 0292: 331 */    0xEF /* 'o' -> */,
+/* pos 0293: 332 */    0xEB /* 'k' -> */,
+/* pos 0294: 333 */    0xE9 /* 'i' -> */,
+/* pos 0295: 334 */    0xE5 /* 'e' -> */,
+/* pos 0296: 335 */    0xBA /* ':' -> */,
+/* pos 0297: 336 */    0x00, 0x36                  /* - terminal marker 54 - */,
+/* pos 0299: 337 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x02A0 state 338) */,
+                       0x65 /* 'e' */, 0x45, 0x01  /* (to 0x03E1 state 594) */,
+                       0x08, /* fail */
+/* pos 02a0: 338 */    0xE1 /* 'a' -> */,
+/* pos 02a1: 339 */    0xEE /* 'n' -> */,
+/* pos 02a2: 340 */    0xF3 /* 's' -> */,
+/* pos 02a3: 341 */    0xE6 /* 'f' -> */,
+/* pos 02a4: 342 */    0xE5 /* 'e' -> */,
+/* pos 02a5: 343 */    0xF2 /* 'r' -> */,
+/* pos 02a6: 344 */    0xAD /* '-' -> */,
+/* pos 02a7: 345 */    0xE5 /* 'e' -> */,
+/* pos 02a8: 346 */    0xEE /* 'n' -> */,
+/* pos 02a9: 347 */    0xE3 /* 'c' -> */,
+/* pos 02aa: 348 */    0xEF /* 'o' -> */,
+/* pos 02ab: 349 */    0xE4 /* 'd' -> */,
+/* pos 02ac: 350 */    0xE9 /* 'i' -> */,
+/* pos 02ad: 351 */    0xEE /* 'n' -> */,
+/* pos 02ae: 352 */    0xE7 /* 'g' -> */,
+/* pos 02af: 353 */    0xBA /* ':' -> */,
+/* pos 02b0: 354 */    0x00, 0x38                  /* - terminal marker 56 - */,
+/* pos 02b2: 355 */    0xE9 /* 'i' -> */,
+/* pos 02b3: 356 */    0xAD /* '-' -> */,
+/* pos 02b4: 357 */    0xE1 /* 'a' -> */,
+/* pos 02b5: 358 */    0xF2 /* 'r' -> */,
+/* pos 02b6: 359 */    0xE7 /* 'g' -> */,
+/* pos 02b7: 360 */    0xF3 /* 's' -> */,
+/* pos 02b8: 361 */    0x00, 0x3D                  /* - terminal marker 61 - */,
+/* pos 02ba: 362 */    0xA0 /* ' ' -> */,
+/* pos 02bb: 363 */    0x00, 0x3E                  /* - terminal marker 62 - */,
+/* pos 02bd: 364 */    0xAD /* '-' -> */,
+/* pos 02be: 365 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x02C8 state 366) */,
+                       0x61 /* 'a' */, 0x1D, 0x00  /* (to 0x02DE state 385) */,
+                       0x72 /* 'r' */, 0x14, 0x01  /* (to 0x03D8 state 586) */,
+                       0x08, /* fail */
+/* pos 02c8: 366 */    0xEF /* 'o' -> */,
+/* pos 02c9: 367 */    0xF2 /* 'r' -> */,
+/* pos 02ca: 368 */    0xF7 /* 'w' -> */,
+/* pos 02cb: 369 */    0xE1 /* 'a' -> */,
+/* pos 02cc: 370 */    0xF2 /* 'r' -> */,
+/* pos 02cd: 371 */    0xE4 /* 'd' -> */,
+/* pos 02ce: 372 */    0xE5 /* 'e' -> */,
+/* pos 02cf: 373 */    0xE4 /* 'd' -> */,
+/* pos 02d0: 374 */    0xAD /* '-' -> */,
+/* pos 02d1: 375 */    0xE6 /* 'f' -> */,
+/* pos 02d2: 376 */    0xEF /* 'o' -> */,
+/* pos 02d3: 377 */    0xF2 /* 'r' -> */,
+/* pos 02d4: 378 */    0xBA /* ':' -> */,
+/* pos 02d5: 379 */    0x00, 0x3F                  /* - terminal marker 63 - */,
+/* pos 02d7: 380 */    0x00, 0x40                  /* - terminal marker 64 - */,
+/* pos 02d9: 381 */    0xE1 /* 'a' -> */,
+/* pos 02da: 382 */    0xE4 /* 'd' -> */,
+/* pos 02db: 383 */    0xA0 /* ' ' -> */,
+/* pos 02dc: 384 */    0x00, 0x41                  /* - terminal marker 65 - */,
+/* pos 02de: 385 */    0x75 /* 'u' */, 0x07, 0x00  /* (to 0x02E5 state 386) */,
+                       0x6D /* 'm' */, 0x0F, 0x00  /* (to 0x02F0 state 396) */,
+                       0x08, /* fail */
+/* pos 02e5: 386 */    0xF4 /* 't' -> */,
+/* pos 02e6: 387 */    0xE8 /* 'h' -> */,
+/* pos 02e7: 388 */    0xAD /* '-' -> */,
+/* pos 02e8: 389 */    0xF4 /* 't' -> */,
+/* pos 02e9: 390 */    0xEF /* 'o' -> */,
+/* pos 02ea: 391 */    0xEB /* 'k' -> */,
+/* pos 02eb: 392 */    0xE5 /* 'e' -> */,
+/* pos 02ec: 393 */    0xEE /* 'n' -> */,
+/* pos 02ed: 394 */    0xBA /* ':' -> */,
+/* pos 02ee: 395 */    0x00, 0x45                  /* - terminal marker 69 - */,
+/* pos 02f0: 396 */    0xFA /* 'z' -> */,
+/* pos 02f1: 397 */    0xEE /* 'n' -> */,
+/* pos 02f2: 398 */    0xAD /* '-' -> */,
+/* pos 02f3: 399 */    0xE4 /* 'd' -> */,
+/* pos 02f4: 400 */    0xF3 /* 's' -> */,
+/* pos 02f5: 401 */    0xF3 /* 's' -> */,
+/* pos 02f6: 402 */    0xAD /* '-' -> */,
+/* pos 02f7: 403 */    0xF3 /* 's' -> */,
+/* pos 02f8: 404 */    0xE9 /* 'i' -> */,
+/* pos 02f9: 405 */    0xE7 /* 'g' -> */,
+/* pos 02fa: 406 */    0xEE /* 'n' -> */,
+/* pos 02fb: 407 */    0xE1 /* 'a' -> */,
+/* pos 02fc: 408 */    0xF4 /* 't' -> */,
+/* pos 02fd: 409 */    0xF5 /* 'u' -> */,
+/* pos 02fe: 410 */    0xF2 /* 'r' -> */,
+/* pos 02ff: 411 */    0xE5 /* 'e' -> */,
+/* pos 0300: 412 */    0xBA /* ':' -> */,
+/* pos 0301: 413 */    0x00, 0x46                  /* - terminal marker 70 - */,
+/* pos 0303: 414 */    0xF4 /* 't' -> */,
+/* pos 0304: 415 */    0xE9 /* 'i' -> */,
+/* pos 0305: 416 */    0xEF /* 'o' -> */,
+/* pos 0306: 417 */    0xEE /* 'n' -> */,
+/* pos 0307: 418 */    0xF3 /* 's' -> */,
+/* pos 0308: 419 */    0xA0 /* ' ' -> */,
+/* pos 0309: 420 */    0x00, 0x02                  /* - terminal marker  2 - */,
+/* pos 030b: 421 */    0xF3 /* 's' -> */,
+/* pos 030c: 422 */    0xAD /* '-' -> */,
+/* pos 030d: 423 */    0xE3 /* 'c' -> */,
+/* pos 030e: 424 */    0xEF /* 'o' -> */,
+/* pos 030f: 425 */    0xEE /* 'n' -> */,
+/* pos 0310: 426 */    0xF4 /* 't' -> */,
+/* pos 0311: 427 */    0xF2 /* 'r' -> */,
+/* pos 0312: 428 */    0xEF /* 'o' -> */,
+/* pos 0313: 429 */    0xEC /* 'l' -> */,
+/* pos 0314: 430 */    0xAD /* '-' -> */,
+/* pos 0315: 431 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x031C state 432) */,
+                       0x61 /* 'a' */, 0x24, 0x00  /* (to 0x033C state 461) */,
+                       0x08, /* fail */
+/* pos 031c: 432 */    0xE5 /* 'e' -> */,
+/* pos 031d: 433 */    0xF1 /* 'q' -> */,
+/* pos 031e: 434 */    0xF5 /* 'u' -> */,
+/* pos 031f: 435 */    0xE5 /* 'e' -> */,
+/* pos 0320: 436 */    0xF3 /* 's' -> */,
+/* pos 0321: 437 */    0xF4 /* 't' -> */,
+/* pos 0322: 438 */    0xAD /* '-' -> */,
+/* pos 0323: 439 */    0xE8 /* 'h' -> */,
+/* pos 0324: 440 */    0xE5 /* 'e' -> */,
+/* pos 0325: 441 */    0xE1 /* 'a' -> */,
+/* pos 0326: 442 */    0xE4 /* 'd' -> */,
+/* pos 0327: 443 */    0xE5 /* 'e' -> */,
+/* pos 0328: 444 */    0xF2 /* 'r' -> */,
+/* pos 0329: 445 */    0xF3 /* 's' -> */,
+/* pos 032a: 446 */    0xBA /* ':' -> */,
+/* pos 032b: 447 */    0x00, 0x11                  /* - terminal marker 17 - */,
+/* pos 032d: 448 */    0xF2 /* 'r' -> */,
+/* pos 032e: 449 */    0xE5 /* 'e' -> */,
+/* pos 032f: 450 */    0xF2 /* 'r' -> */,
+/* pos 0330: 451 */    0xBA /* ':' -> */,
+/* pos 0331: 452 */    0x00, 0x16                  /* - terminal marker 22 - */,
+/* pos 0333: 453 */    0xE8 /* 'h' -> */,
+/* pos 0334: 454 */    0xE1 /* 'a' -> */,
+/* pos 0335: 455 */    0xF2 /* 'r' -> */,
+/* pos 0336: 456 */    0xF3 /* 's' -> */,
+/* pos 0337: 457 */    0xE5 /* 'e' -> */,
+/* pos 0338: 458 */    0xF4 /* 't' -> */,
+/* pos 0339: 459 */    0xBA /* ':' -> */,
+/* pos 033a: 460 */    0x00, 0x1C                  /* - terminal marker 28 - */,
+/* pos 033c: 461 */    0xEC /* 'l' -> */,
+/* pos 033d: 462 */    0xEC /* 'l' -> */,
+/* pos 033e: 463 */    0xEF /* 'o' -> */,
+/* pos 033f: 464 */    0xF7 /* 'w' -> */,
+/* pos 0340: 465 */    0xAD /* '-' -> */,
+/* pos 0341: 466 */    0xEF /* 'o' -> */,
+/* pos 0342: 467 */    0xF2 /* 'r' -> */,
+/* pos 0343: 468 */    0xE9 /* 'i' -> */,
+/* pos 0344: 469 */    0xE7 /* 'g' -> */,
+/* pos 0345: 470 */    0xE9 /* 'i' -> */,
+/* pos 0346: 471 */    0xEE /* 'n' -> */,
+/* pos 0347: 472 */    0xBA /* ':' -> */,
+/* pos 0348: 473 */    0x00, 0x1E                  /* - terminal marker 30 - */,
+/* pos 034a: 474 */    0xE1 /* 'a' -> */,
+/* pos 034b: 475 */    0xF8 /* 'x' -> */,
+/* pos 034c: 476 */    0xAD /* '-' -> */,
+/* pos 034d: 477 */    0xE6 /* 'f' -> */,
+/* pos 034e: 478 */    0xEF /* 'o' -> */,
+/* pos 034f: 479 */    0xF2 /* 'r' -> */,
+/* pos 0350: 480 */    0xF7 /* 'w' -> */,
+/* pos 0351: 481 */    0xE1 /* 'a' -> */,
+/* pos 0352: 482 */    0xF2 /* 'r' -> */,
+/* pos 0353: 483 */    0xE4 /* 'd' -> */,
+/* pos 0354: 484 */    0xF3 /* 's' -> */,
+/* pos 0355: 485 */    0xBA /* ':' -> */,
+/* pos 0356: 486 */    0x00, 0x30                  /* - terminal marker 48 - */,
+/* pos 0358: 487 */    0xF8 /* 'x' -> */,
+/* pos 0359: 488 */    0xF9 /* 'y' -> */,
+/* pos 035a: 489 */    0x2D /* '-' */, 0x07, 0x00  /* (to 0x0361 state 490) */,
+                       0x20 /* ' ' */, 0x79, 0x00  /* (to 0x03D6 state 585) */,
+                       0x08, /* fail */
+/* pos 0361: 490 */    0xE1 /* 'a' -> */,
+/* pos 0362: 491 */    0xF5 /* 'u' -> */,
+/* pos 0363: 492 */    0xF4 /* 't' -> */,
+/* pos 0364: 493 */    0xE8 /* 'h' -> */,
+/* pos 0365: 494 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x036C state 495) */,
+                       0x6F /* 'o' */, 0x0E, 0x00  /* (to 0x0376 state 504) */,
+                       0x08, /* fail */
+/* pos 036c: 495 */    0xEE /* 'n' -> */,
+/* pos 036d: 496 */    0xF4 /* 't' -> */,
+/* pos 036e: 497 */    0xE9 /* 'i' -> */,
+/* pos 036f: 498 */    0xE3 /* 'c' -> */,
+/* pos 0370: 499 */    0xE1 /* 'a' -> */,
+/* pos 0371: 500 */    0xF4 /* 't' -> */,
+/* pos 0372: 501 */    0xE5 /* 'e' -> */,
+/* pos 0373: 502 */    0xBA /* ':' -> */,
+/* pos 0374: 503 */    0x00, 0x31                  /* - terminal marker 49 - */,
+/* pos 0376: 504 */    0xF2 /* 'r' -> */,
+/* pos 0377: 505 */    0xE9 /* 'i' -> */,
+/* pos 0378: 506 */    0xFA /* 'z' -> */,
+/* pos 0379: 507 */    0xE1 /* 'a' -> */,
+/* pos 037a: 508 */    0xF4 /* 't' -> */,
+/* pos 037b: 509 */    0xE9 /* 'i' -> */,
+/* pos 037c: 510 */    0xEF /* 'o' -> */,
+/* pos 037d: 511 */    0xEE /* 'n' -> */,
+/* pos 037e: 512 */    0xBA /* ':' -> */,
+/* pos 037f: 513 */    0x00, 0x32                  /* - terminal marker 50 - */,
+/* pos 0381: 514 */    0xF2 /* 'r' -> */,
+/* pos 0382: 515 */    0xE9 /* 'i' -> */,
+/* pos 0383: 516 */    0xE3 /* 'c' -> */,
+/* pos 0384: 517 */    0xF4 /* 't' -> */,
+/* pos 0385: 518 */    0xAD /* '-' -> */,
+/* pos 0386: 519 */    0xF4 /* 't' -> */,
+/* pos 0387: 520 */    0xF2 /* 'r' -> */,
+/* pos 0388: 521 */    0xE1 /* 'a' -> */,
+/* pos 0389: 522 */    0xEE /* 'n' -> */,
+/* pos 038a: 523 */    0xF3 /* 's' -> */,
+/* pos 038b: 524 */    0xF0 /* 'p' -> */,
+/* pos 038c: 525 */    0xEF /* 'o' -> */,
+/* pos 038d: 526 */    0xF2 /* 'r' -> */,
+/* pos 038e: 527 */    0xF4 /* 't' -> */,
+/* pos 038f: 528 */    0xAD /* '-' -> */,
+/* pos 0390: 529 */    0xF3 /* 's' -> */,
+/* pos 0391: 530 */    0xE5 /* 'e' -> */,
+/* pos 0392: 531 */    0xE3 /* 'c' -> */,
+/* pos 0393: 532 */    0xF5 /* 'u' -> */,
+/* pos 0394: 533 */    0xF2 /* 'r' -> */,
+/* pos 0395: 534 */    0xE9 /* 'i' -> */,
+/* pos 0396: 535 */    0xF4 /* 't' -> */,
+/* pos 0397: 536 */    0xF9 /* 'y' -> */,
+/* pos 0398: 537 */    0xBA /* ':' -> */,
+/* pos 0399: 538 */    0x00, 0x37                  /* - terminal marker 55 - */,
+/* pos 039b: 539 */    0xE5 /* 'e' -> */,
+/* pos 039c: 540 */    0xF2 /* 'r' -> */,
+/* pos 039d: 541 */    0xAD /* '-' -> */,
+/* pos 039e: 542 */    0xE1 /* 'a' -> */,
+/* pos 039f: 543 */    0xE7 /* 'g' -> */,
+/* pos 03a0: 544 */    0xE5 /* 'e' -> */,
+/* pos 03a1: 545 */    0xEE /* 'n' -> */,
+/* pos 03a2: 546 */    0xF4 /* 't' -> */,
+/* pos 03a3: 547 */    0xBA /* ':' -> */,
+/* pos 03a4: 548 */    0x00, 0x39                  /* - terminal marker 57 - */,
+/* pos 03a6: 549 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x03AD state 550) */,
+                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x03B2 state 554) */,
+                       0x08, /* fail */
+/* pos 03ad: 550 */    0xF2 /* 'r' -> */,
+/* pos 03ae: 551 */    0xF9 /* 'y' -> */,
+/* pos 03af: 552 */    0xBA /* ':' -> */,
+/* pos 03b0: 553 */    0x00, 0x3A                  /* - terminal marker 58 - */,
+/* pos 03b2: 554 */    0xE1 /* 'a' -> */,
+/* pos 03b3: 555 */    0xBA /* ':' -> */,
+/* pos 03b4: 556 */    0x00, 0x3B                  /* - terminal marker 59 - */,
+/* pos 03b6: 557 */    0xF7 /* 'w' -> */,
+/* pos 03b7: 558 */    0xF7 /* 'w' -> */,
+/* pos 03b8: 559 */    0xAD /* '-' -> */,
+/* pos 03b9: 560 */    0xE1 /* 'a' -> */,
+/* pos 03ba: 561 */    0xF5 /* 'u' -> */,
+/* pos 03bb: 562 */    0xF4 /* 't' -> */,
+/* pos 03bc: 563 */    0xE8 /* 'h' -> */,
+/* pos 03bd: 564 */    0xE5 /* 'e' -> */,
+/* pos 03be: 565 */    0xEE /* 'n' -> */,
+/* pos 03bf: 566 */    0xF4 /* 't' -> */,
+/* pos 03c0: 567 */    0xE9 /* 'i' -> */,
+/* pos 03c1: 568 */    0xE3 /* 'c' -> */,
+/* pos 03c2: 569 */    0xE1 /* 'a' -> */,
+/* pos 03c3: 570 */    0xF4 /* 't' -> */,
+/* pos 03c4: 571 */    0xE5 /* 'e' -> */,
+/* pos 03c5: 572 */    0xBA /* ':' -> */,
+/* pos 03c6: 573 */    0x00, 0x3C                  /* - terminal marker 60 - */,
+/* pos 03c8: 574 */    0xF4 /* 't' -> */,
+/* pos 03c9: 575 */    0xE3 /* 'c' -> */,
+/* pos 03ca: 576 */    0xE8 /* 'h' -> */,
+/* pos 03cb: 577 */    0x00, 0x43                  /* - terminal marker 67 - */,
+/* pos 03cd: 578 */    0xF4 /* 't' -> */,
+/* pos 03ce: 579 */    0x00, 0x44                  /* - terminal marker 68 - */,
+/* pos 03d0: 580 */    0xEC /* 'l' -> */,
+/* pos 03d1: 581 */    0xE5 /* 'e' -> */,
+/* pos 03d2: 582 */    0xF4 /* 't' -> */,
+/* pos 03d3: 583 */    0xE5 /* 'e' -> */,
+/* pos 03d4: 584 */    0x00, 0x45                  /* - terminal marker 69 - */,
+/* pos 03d6: 585 */    0x00, 0x47                  /* - terminal marker 71 - */,
+/* pos 03d8: 586 */    0xE5 /* 'e' -> */,
+/* pos 03d9: 587 */    0xE1 /* 'a' -> */,
+/* pos 03da: 588 */    0xEC /* 'l' -> */,
+/* pos 03db: 589 */    0xAD /* '-' -> */,
+/* pos 03dc: 590 */    0xE9 /* 'i' -> */,
+/* pos 03dd: 591 */    0xF0 /* 'p' -> */,
+/* pos 03de: 592 */    0xBA /* ':' -> */,
+/* pos 03df: 593 */    0x00, 0x48                  /* - terminal marker 72 - */,
+/* pos 03e1: 594 */    0xBA /* ':' -> */,
+/* pos 03e2: 595 */    0x00, 0x42                  /* - terminal marker 66 - */,
+/* pos 03e4: 596 */    0xEC /* 'l' -> */,
+/* pos 03e5: 597 */    0xE1 /* 'a' -> */,
+/* pos 03e6: 598 */    0xF9 /* 'y' -> */,
+/* pos 03e7: 599 */    0xAD /* '-' -> */,
+/* pos 03e8: 600 */    0xEE /* 'n' -> */,
+/* pos 03e9: 601 */    0xEF /* 'o' -> */,
+/* pos 03ea: 602 */    0xEE /* 'n' -> */,
+/* pos 03eb: 603 */    0xE3 /* 'c' -> */,
+/* pos 03ec: 604 */    0xE5 /* 'e' -> */,
+/* pos 03ed: 605 */    0xBA /* ':' -> */,
+/* pos 03ee: 606 */    0x00, 0x43                  /* - terminal marker 67 - */,
+/* pos 03f0: 607 */    0xAD /* '-' -> */,
+/* pos 03f1: 608 */    0xF7 /* 'w' -> */,
+/* pos 03f2: 609 */    0xE5 /* 'e' -> */,
+/* pos 03f3: 610 */    0xE2 /* 'b' -> */,
+/* pos 03f4: 611 */    0xF3 /* 's' -> */,
+/* pos 03f5: 612 */    0xEF /* 'o' -> */,
+/* pos 03f6: 613 */    0xE3 /* 'c' -> */,
+/* pos 03f7: 614 */    0xEB /* 'k' -> */,
+/* pos 03f8: 615 */    0xE5 /* 'e' -> */,
+/* pos 03f9: 616 */    0xF4 /* 't' -> */,
+/* pos 03fa: 617 */    0xAD /* '-' -> */,
+/* pos 03fb: 618 */    0x64 /* 'd' */, 0x19, 0x00  /* (to 0x0414 state 619) */,
+                       0x65 /* 'e' */, 0x1D, 0x00  /* (to 0x041B state 625) */,
+                       0x6B /* 'k' */, 0x26, 0x00  /* (to 0x0427 state 636) */,
+                       0x70 /* 'p' */, 0x35, 0x00  /* (to 0x0439 state 643) */,
+                       0x61 /* 'a' */, 0x3C, 0x00  /* (to 0x0443 state 652) */,
+                       0x6E /* 'n' */, 0x41, 0x00  /* (to 0x044B state 659) */,
+                       0x76 /* 'v' */, 0x47, 0x00  /* (to 0x0454 state 666) */,
+                       0x6F /* 'o' */, 0x4D, 0x00  /* (to 0x045D state 674) */,
+                       0x08, /* fail */
+/* pos 0414: 619 */    0xF2 /* 'r' -> */,
+/* pos 0415: 620 */    0xE1 /* 'a' -> */,
+/* pos 0416: 621 */    0xE6 /* 'f' -> */,
+/* pos 0417: 622 */    0xF4 /* 't' -> */,
+/* pos 0418: 623 */    0xBA /* ':' -> */,
+/* pos 0419: 624 */    0x00, 0x07                  /* - terminal marker  7 - */,
+/* pos 041b: 625 */    0xF8 /* 'x' -> */,
+/* pos 041c: 626 */    0xF4 /* 't' -> */,
+/* pos 041d: 627 */    0xE5 /* 'e' -> */,
+/* pos 041e: 628 */    0xEE /* 'n' -> */,
+/* pos 041f: 629 */    0xF3 /* 's' -> */,
+/* pos 0420: 630 */    0xE9 /* 'i' -> */,
+/* pos 0421: 631 */    0xEF /* 'o' -> */,
+/* pos 0422: 632 */    0xEE /* 'n' -> */,
+/* pos 0423: 633 */    0xF3 /* 's' -> */,
+/* pos 0424: 634 */    0xBA /* ':' -> */,
+/* pos 0425: 635 */    0x00, 0x09                  /* - terminal marker  9 - */,
+/* pos 0427: 636 */    0xE5 /* 'e' -> */,
+/* pos 0428: 637 */    0xF9 /* 'y' -> */,
+/* pos 0429: 638 */    0x31 /* '1' */, 0x0A, 0x00  /* (to 0x0433 state 639) */,
+                       0x32 /* '2' */, 0x0A, 0x00  /* (to 0x0436 state 641) */,
+                       0x3A /* ':' */, 0x23, 0x00  /* (to 0x0452 state 665) */,
+                       0x08, /* fail */
+/* pos 0433: 639 */    0xBA /* ':' -> */,
+/* pos 0434: 640 */    0x00, 0x0A                  /* - terminal marker 10 - */,
+/* pos 0436: 641 */    0xBA /* ':' -> */,
+/* pos 0437: 642 */    0x00, 0x0B                  /* - terminal marker 11 - */,
+/* pos 0439: 643 */    0xF2 /* 'r' -> */,
+/* pos 043a: 644 */    0xEF /* 'o' -> */,
+/* pos 043b: 645 */    0xF4 /* 't' -> */,
+/* pos 043c: 646 */    0xEF /* 'o' -> */,
+/* pos 043d: 647 */    0xE3 /* 'c' -> */,
+/* pos 043e: 648 */    0xEF /* 'o' -> */,
+/* pos 043f: 649 */    0xEC /* 'l' -> */,
+/* pos 0440: 650 */    0xBA /* ':' -> */,
+/* pos 0441: 651 */    0x00, 0x0C                  /* - terminal marker 12 - */,
+/* pos 0443: 652 */    0xE3 /* 'c' -> */,
+/* pos 0444: 653 */    0xE3 /* 'c' -> */,
+/* pos 0445: 654 */    0xE5 /* 'e' -> */,
+/* pos 0446: 655 */    0xF0 /* 'p' -> */,
+/* pos 0447: 656 */    0xF4 /* 't' -> */,
+/* pos 0448: 657 */    0xBA /* ':' -> */,
+/* pos 0449: 658 */    0x00, 0x0D                  /* - terminal marker 13 - */,
+/* pos 044b: 659 */    0xEF /* 'o' -> */,
+/* pos 044c: 660 */    0xEE /* 'n' -> */,
+/* pos 044d: 661 */    0xE3 /* 'c' -> */,
+/* pos 044e: 662 */    0xE5 /* 'e' -> */,
+/* pos 044f: 663 */    0xBA /* ':' -> */,
+/* pos 0450: 664 */    0x00, 0x0E                  /* - terminal marker 14 - */,
+/* pos 0452: 665 */    0x00, 0x1F                  /* - terminal marker 31 - */,
+/* pos 0454: 666 */    0xE5 /* 'e' -> */,
+/* pos 0455: 667 */    0xF2 /* 'r' -> */,
+/* pos 0456: 668 */    0xF3 /* 's' -> */,
+/* pos 0457: 669 */    0xE9 /* 'i' -> */,
+/* pos 0458: 670 */    0xEF /* 'o' -> */,
+/* pos 0459: 671 */    0xEE /* 'n' -> */,
+/* pos 045a: 672 */    0xBA /* ':' -> */,
+/* pos 045b: 673 */    0x00, 0x20                  /* - terminal marker 32 - */,
+/* pos 045d: 674 */    0xF2 /* 'r' -> */,
+/* pos 045e: 675 */    0xE9 /* 'i' -> */,
+/* pos 045f: 676 */    0xE7 /* 'g' -> */,
+/* pos 0460: 677 */    0xE9 /* 'i' -> */,
+/* pos 0461: 678 */    0xEE /* 'n' -> */,
+/* pos 0462: 679 */    0xBA /* ':' -> */,
+/* pos 0463: 680 */    0x00, 0x21                  /* - terminal marker 33 - */,
+/* pos 0465: 681 */    0xAD /* '-' -> */,
+/* pos 0466: 682 */    0xF3 /* 's' -> */,
+/* pos 0467: 683 */    0xE5 /* 'e' -> */,
+/* pos 0468: 684 */    0xF4 /* 't' -> */,
+/* pos 0469: 685 */    0xF4 /* 't' -> */,
+/* pos 046a: 686 */    0xE9 /* 'i' -> */,
+/* pos 046b: 687 */    0xEE /* 'n' -> */,
+/* pos 046c: 688 */    0xE7 /* 'g' -> */,
+/* pos 046d: 689 */    0xF3 /* 's' -> */,
+/* pos 046e: 690 */    0xBA /* ':' -> */,
+/* pos 046f: 691 */    0x00, 0x08                  /* - terminal marker  8 - */,
+/* pos 0471: 692 */    0x61 /* 'a' */, 0x0D, 0x00  /* (to 0x047E state 693) */,
+                       0x6D /* 'm' */, 0x14, 0x00  /* (to 0x0488 state 702) */,
+                       0x70 /* 'p' */, 0x18, 0x00  /* (to 0x048F state 708) */,
+                       0x73 /* 's' */, 0x20, 0x00  /* (to 0x049A state 712) */,
+                       0x08, /* fail */
+/* pos 047e: 693 */    0xF5 /* 'u' -> */,
+/* pos 047f: 694 */    0xF4 /* 't' -> */,
+/* pos 0480: 695 */    0xE8 /* 'h' -> */,
+/* pos 0481: 696 */    0xEF /* 'o' -> */,
+/* pos 0482: 697 */    0xF2 /* 'r' -> */,
+/* pos 0483: 698 */    0xE9 /* 'i' -> */,
+/* pos 0484: 699 */    0xF4 /* 't' -> */,
+/* pos 0485: 700 */    0xF9 /* 'y' -> */,
+/* pos 0486: 701 */    0x00, 0x17                  /* - terminal marker 23 - */,
+/* pos 0488: 702 */    0xE5 /* 'e' -> */,
+/* pos 0489: 703 */    0xF4 /* 't' -> */,
+/* pos 048a: 704 */    0xE8 /* 'h' -> */,
+/* pos 048b: 705 */    0xEF /* 'o' -> */,
+/* pos 048c: 706 */    0xE4 /* 'd' -> */,
+/* pos 048d: 707 */    0x00, 0x18                  /* - terminal marker 24 - */,
+/* pos 048f: 708 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0496 state 709) */,
+                       0x72 /* 'r' */, 0x1B, 0x00  /* (to 0x04AD state 723) */,
+                       0x08, /* fail */
+/* pos 0496: 709 */    0xF4 /* 't' -> */,
+/* pos 0497: 710 */    0xE8 /* 'h' -> */,
+/* pos 0498: 711 */    0x00, 0x19                  /* - terminal marker 25 - */,
+/* pos 049a: 712 */    0x63 /* 'c' */, 0x07, 0x00  /* (to 0x04A1 state 713) */,
+                       0x74 /* 't' */, 0x0A, 0x00  /* (to 0x04A7 state 718) */,
+                       0x08, /* fail */
+/* pos 04a1: 713 */    0xE8 /* 'h' -> */,
+/* pos 04a2: 714 */    0xE5 /* 'e' -> */,
+/* pos 04a3: 715 */    0xED /* 'm' -> */,
+/* pos 04a4: 716 */    0xE5 /* 'e' -> */,
+/* pos 04a5: 717 */    0x00, 0x1A                  /* - terminal marker 26 - */,
+/* pos 04a7: 718 */    0xE1 /* 'a' -> */,
+/* pos 04a8: 719 */    0xF4 /* 't' -> */,
+/* pos 04a9: 720 */    0xF5 /* 'u' -> */,
+/* pos 04aa: 721 */    0xF3 /* 's' -> */,
+/* pos 04ab: 722 */    0x00, 0x1B                  /* - terminal marker 27 - */,
+/* pos 04ad: 723 */    0xEF /* 'o' -> */,
+/* pos 04ae: 724 */    0xF4 /* 't' -> */,
+/* pos 04af: 725 */    0xEF /* 'o' -> */,
+/* pos 04b0: 726 */    0xE3 /* 'c' -> */,
+/* pos 04b1: 727 */    0xEF /* 'o' -> */,
+/* pos 04b2: 728 */    0xEC /* 'l' -> */,
+/* pos 04b3: 729 */    0x00, 0x44                  /* - terminal marker 68 - */,
+/* pos 04b5: 730 */    0xEF /* 'o' -> */,
+/* pos 04b6: 731 */    0xF2 /* 'r' -> */,
+/* pos 04b7: 732 */    0xE9 /* 'i' -> */,
+/* pos 04b8: 733 */    0xF4 /* 't' -> */,
+/* pos 04b9: 734 */    0xF9 /* 'y' -> */,
+/* pos 04ba: 735 */    0xBA /* ':' -> */,
+/* pos 04bb: 736 */    0x00, 0x47                  /* - terminal marker 71 - */,
+/* total size 1213 bytes */
 #endif
 
 #if !defined(LWS_HTTP_HEADERS_ALL) &&  defined(LWS_WITH_HTTP_UNCOMMON_HEADERS) && !defined(LWS_ROLE_WS) &&  defined(LWS_ROLE_H2)
@@ -4095,6 +4106,8 @@
 	/* 75: 85: :protocol */
 	/* 76: 86: x-auth-token: */
 	/* 77: 87: x-amzn-dss-signature: */
+	/* 78: 88: priority: */
+	/* 79: 89:  */
 /* pos 0000:   0 */    0x67 /* 'g' */, 0x40, 0x00  /* (to 0x0040 state   1) */,
                        0x70 /* 'p' */, 0x42, 0x00  /* (to 0x0045 state   5) */,
                        0x68 /* 'h' */, 0x51, 0x00  /* (to 0x0057 state  10) */,
@@ -4104,18 +4117,18 @@
                        0x0D /* '.' */, 0x98, 0x00  /* (to 0x00AA state  41) */,
                        0x61 /* 'a' */, 0xAD, 0x00  /* (to 0x00C2 state  51) */,
                        0x69 /* 'i' */, 0xCA, 0x00  /* (to 0x00E2 state  58) */,
-                       0x64 /* 'd' */, 0x73, 0x01  /* (to 0x018E state 160) */,
-                       0x72 /* 'r' */, 0x7C, 0x01  /* (to 0x019A state 165) */,
-                       0x65 /* 'e' */, 0xC8, 0x01  /* (to 0x01E9 state 229) */,
-                       0x66 /* 'f' */, 0xE4, 0x01  /* (to 0x0208 state 245) */,
-                       0x6C /* 'l' */, 0x06, 0x02  /* (to 0x022D state 278) */,
-                       0x73 /* 's' */, 0x4B, 0x02  /* (to 0x0275 state 321) */,
-                       0x74 /* 't' */, 0x69, 0x02  /* (to 0x0296 state 337) */,
-                       0x78 /* 'x' */, 0x8A, 0x02  /* (to 0x02BA state 364) */,
-                       0x6D /* 'm' */, 0x14, 0x03  /* (to 0x0347 state 474) */,
-                       0x76 /* 'v' */, 0x6D, 0x03  /* (to 0x03A3 state 549) */,
-                       0x77 /* 'w' */, 0x7A, 0x03  /* (to 0x03B3 state 557) */,
-                       0x3A /* ':' */, 0x32, 0x04  /* (to 0x046E state 692) */,
+                       0x64 /* 'd' */, 0x76, 0x01  /* (to 0x0191 state 160) */,
+                       0x72 /* 'r' */, 0x7F, 0x01  /* (to 0x019D state 165) */,
+                       0x65 /* 'e' */, 0xCB, 0x01  /* (to 0x01EC state 229) */,
+                       0x66 /* 'f' */, 0xE7, 0x01  /* (to 0x020B state 245) */,
+                       0x6C /* 'l' */, 0x09, 0x02  /* (to 0x0230 state 278) */,
+                       0x73 /* 's' */, 0x4E, 0x02  /* (to 0x0278 state 321) */,
+                       0x74 /* 't' */, 0x6C, 0x02  /* (to 0x0299 state 337) */,
+                       0x78 /* 'x' */, 0x8D, 0x02  /* (to 0x02BD state 364) */,
+                       0x6D /* 'm' */, 0x17, 0x03  /* (to 0x034A state 474) */,
+                       0x76 /* 'v' */, 0x70, 0x03  /* (to 0x03A6 state 549) */,
+                       0x77 /* 'w' */, 0x7D, 0x03  /* (to 0x03B6 state 557) */,
+                       0x3A /* ':' */, 0x35, 0x04  /* (to 0x0471 state 692) */,
                        0x08, /* fail */
 /* pos 0040:   1 */    0xE5 /* 'e' -> */,
 /* pos 0041:   2 */    0xF4 /* 't' -> */,
@@ -4123,8 +4136,8 @@
 /* pos 0043:   4 */    0x00, 0x00                  /* - terminal marker  0 - */,
 /* pos 0045:   5 */    0x6F /* 'o' */, 0x0D, 0x00  /* (to 0x0052 state   6) */,
                        0x72 /* 'r' */, 0xEC, 0x00  /* (to 0x0134 state 106) */,
-                       0x61 /* 'a' */, 0x7A, 0x03  /* (to 0x03C5 state 574) */,
-                       0x75 /* 'u' */, 0x7C, 0x03  /* (to 0x03CA state 578) */,
+                       0x61 /* 'a' */, 0x7D, 0x03  /* (to 0x03C8 state 574) */,
+                       0x75 /* 'u' */, 0x7F, 0x03  /* (to 0x03CD state 578) */,
                        0x08, /* fail */
 /* pos 0052:   6 */    0xF3 /* 's' -> */,
 /* pos 0053:   7 */    0xF4 /* 't' -> */,
@@ -4132,34 +4145,34 @@
 /* pos 0055:   9 */    0x00, 0x01                  /* - terminal marker  1 - */,
 /* pos 0057:  10 */    0x6F /* 'o' */, 0x0A, 0x00  /* (to 0x0061 state  11) */,
                        0x74 /* 't' */, 0x53, 0x00  /* (to 0x00AD state  43) */,
-                       0x65 /* 'e' */, 0x79, 0x02  /* (to 0x02D6 state 381) */,
+                       0x65 /* 'e' */, 0x7C, 0x02  /* (to 0x02D9 state 381) */,
                        0x08, /* fail */
 /* pos 0061:  11 */    0xF3 /* 's' -> */,
 /* pos 0062:  12 */    0xF4 /* 't' -> */,
 /* pos 0063:  13 */    0xBA /* ':' -> */,
 /* pos 0064:  14 */    0x00, 0x03                  /* - terminal marker  3 - */,
 /* pos 0066:  15 */    0x6F /* 'o' */, 0x07, 0x00  /* (to 0x006D state  16) */,
-                       0x61 /* 'a' */, 0xD8, 0x00  /* (to 0x0141 state 112) */,
+                       0x61 /* 'a' */, 0xDB, 0x00  /* (to 0x0144 state 112) */,
                        0x08, /* fail */
 /* pos 006d:  16 */    0x6E /* 'n' */, 0x07, 0x00  /* (to 0x0074 state  17) */,
-                       0x6F /* 'o' */, 0xED, 0x00  /* (to 0x015D state 138) */,
+                       0x6F /* 'o' */, 0xF0, 0x00  /* (to 0x0160 state 138) */,
                        0x08, /* fail */
 /* pos 0074:  17 */    0x6E /* 'n' */, 0x07, 0x00  /* (to 0x007B state  18) */,
-                       0x74 /* 't' */, 0xEC, 0x00  /* (to 0x0163 state 143) */,
+                       0x74 /* 't' */, 0xEF, 0x00  /* (to 0x0166 state 143) */,
                        0x08, /* fail */
 /* pos 007b:  18 */    0xE5 /* 'e' -> */,
 /* pos 007c:  19 */    0xE3 /* 'c' -> */,
 /* pos 007d:  20 */    0xF4 /* 't' -> */,
 /* pos 007e:  21 */    0x69 /* 'i' */, 0x07, 0x00  /* (to 0x0085 state  22) */,
-                       0x20 /* ' ' */, 0x53, 0x02  /* (to 0x02D4 state 380) */,
+                       0x20 /* ' ' */, 0x56, 0x02  /* (to 0x02D7 state 380) */,
                        0x08, /* fail */
 /* pos 0085:  22 */    0xEF /* 'o' -> */,
 /* pos 0086:  23 */    0xEE /* 'n' -> */,
 /* pos 0087:  24 */    0xBA /* ':' -> */,
 /* pos 0088:  25 */    0x00, 0x04                  /* - terminal marker  4 - */,
 /* pos 008a:  26 */    0x70 /* 'p' */, 0x0A, 0x00  /* (to 0x0094 state  27) */,
-                       0x72 /* 'r' */, 0x22, 0x02  /* (to 0x02AF state 355) */,
-                       0x73 /* 's' */, 0x08, 0x03  /* (to 0x0398 state 539) */,
+                       0x72 /* 'r' */, 0x25, 0x02  /* (to 0x02B2 state 355) */,
+                       0x73 /* 's' */, 0x0B, 0x03  /* (to 0x039B state 539) */,
                        0x08, /* fail */
 /* pos 0094:  27 */    0xE7 /* 'g' -> */,
 /* pos 0095:  28 */    0xF2 /* 'r' -> */,
@@ -4169,7 +4182,7 @@
 /* pos 0099:  32 */    0xBA /* ':' -> */,
 /* pos 009a:  33 */    0x00, 0x05                  /* - terminal marker  5 - */,
 /* pos 009c:  34 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x00A3 state  35) */,
-                       0x70 /* 'p' */, 0x61, 0x02  /* (to 0x0300 state 414) */,
+                       0x70 /* 'p' */, 0x64, 0x02  /* (to 0x0303 state 414) */,
                        0x08, /* fail */
 /* pos 00a3:  35 */    0xE9 /* 'i' -> */,
 /* pos 00a4:  36 */    0xE7 /* 'g' -> */,
@@ -4182,24 +4195,24 @@
 /* pos 00ad:  43 */    0xF4 /* 't' -> */,
 /* pos 00ae:  44 */    0xF0 /* 'p' -> */,
 /* pos 00af:  45 */    0x2F /* '/' */, 0x07, 0x00  /* (to 0x00B6 state  46) */,
-                       0x32 /* '2' */, 0xB0, 0x03  /* (to 0x0462 state 681) */,
+                       0x32 /* '2' */, 0xB3, 0x03  /* (to 0x0465 state 681) */,
                        0x08, /* fail */
 /* pos 00b6:  46 */    0xB1 /* '1' -> */,
 /* pos 00b7:  47 */    0xAE /* '.' -> */,
 /* pos 00b8:  48 */    0x31 /* '1' */, 0x07, 0x00  /* (to 0x00BF state  49) */,
-                       0x30 /* '0' */, 0xFC, 0x01  /* (to 0x02B7 state 362) */,
+                       0x30 /* '0' */, 0xFF, 0x01  /* (to 0x02BA state 362) */,
                        0x08, /* fail */
 /* pos 00bf:  49 */    0xA0 /* ' ' -> */,
 /* pos 00c0:  50 */    0x00, 0x08                  /* - terminal marker  8 - */,
 /* pos 00c2:  51 */    0x63 /* 'c' */, 0x0D, 0x00  /* (to 0x00CF state  52) */,
-                       0x75 /* 'u' */, 0x8A, 0x00  /* (to 0x014F state 125) */,
-                       0x67 /* 'g' */, 0xE7, 0x00  /* (to 0x01AF state 178) */,
-                       0x6C /* 'l' */, 0xE8, 0x00  /* (to 0x01B3 state 181) */,
+                       0x75 /* 'u' */, 0x8D, 0x00  /* (to 0x0152 state 125) */,
+                       0x67 /* 'g' */, 0xEA, 0x00  /* (to 0x01B2 state 178) */,
+                       0x6C /* 'l' */, 0xEB, 0x00  /* (to 0x01B6 state 181) */,
                        0x08, /* fail */
 /* pos 00cf:  52 */    0xE3 /* 'c' -> */,
 /* pos 00d0:  53 */    0xE5 /* 'e' -> */,
 /* pos 00d1:  54 */    0x70 /* 'p' */, 0x07, 0x00  /* (to 0x00D8 state  55) */,
-                       0x73 /* 's' */, 0x34, 0x02  /* (to 0x0308 state 421) */,
+                       0x73 /* 's' */, 0x37, 0x02  /* (to 0x030B state 421) */,
                        0x08, /* fail */
 /* pos 00d8:  55 */    0xF4 /* 't' -> */,
 /* pos 00d9:  56 */    0x3A /* ':' */, 0x07, 0x00  /* (to 0x00E0 state  57) */,
@@ -4210,11 +4223,11 @@
 /* pos 00e3:  59 */    0xAD /* '-' -> */,
 /* pos 00e4:  60 */    0x6D /* 'm' */, 0x0D, 0x00  /* (to 0x00F1 state  61) */,
                        0x6E /* 'n' */, 0x20, 0x00  /* (to 0x0107 state  76) */,
-                       0x72 /* 'r' */, 0x2A, 0x01  /* (to 0x0214 state 255) */,
-                       0x75 /* 'u' */, 0x2E, 0x01  /* (to 0x021B state 261) */,
+                       0x72 /* 'r' */, 0x2D, 0x01  /* (to 0x0217 state 255) */,
+                       0x75 /* 'u' */, 0x31, 0x01  /* (to 0x021E state 261) */,
                        0x08, /* fail */
 /* pos 00f1:  61 */    0x6F /* 'o' */, 0x07, 0x00  /* (to 0x00F8 state  62) */,
-                       0x61 /* 'a' */, 0x1A, 0x01  /* (to 0x020E state 250) */,
+                       0x61 /* 'a' */, 0x1D, 0x01  /* (to 0x0211 state 250) */,
                        0x08, /* fail */
 /* pos 00f8:  62 */    0xE4 /* 'd' -> */,
 /* pos 00f9:  63 */    0xE9 /* 'i' -> */,
@@ -4243,8 +4256,8 @@
 /* pos 0111:  86 */    0x00, 0x0D                  /* - terminal marker 13 - */,
 /* pos 0113:  87 */    0x65 /* 'e' */, 0x0D, 0x00  /* (to 0x0120 state  88) */,
                        0x6C /* 'l' */, 0x14, 0x00  /* (to 0x012A state  97) */,
-                       0x72 /* 'r' */, 0x8E, 0x00  /* (to 0x01A7 state 171) */,
-                       0x63 /* 'c' */, 0x14, 0x02  /* (to 0x0330 state 453) */,
+                       0x72 /* 'r' */, 0x91, 0x00  /* (to 0x01AA state 171) */,
+                       0x63 /* 'c' */, 0x17, 0x02  /* (to 0x0333 state 453) */,
                        0x08, /* fail */
 /* pos 0120:  88 */    0xEE /* 'n' -> */,
 /* pos 0121:  89 */    0xE3 /* 'c' -> */,
@@ -4264,696 +4277,704 @@
 /* pos 0130: 103 */    0xE5 /* 'e' -> */,
 /* pos 0131: 104 */    0xBA /* ':' -> */,
 /* pos 0132: 105 */    0x00, 0x0F                  /* - terminal marker 15 - */,
-/* pos 0134: 106 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x013B state 107) */,
-                       0x6F /* 'o' */, 0x1E, 0x02  /* (to 0x0355 state 487) */,
-                       0x08, /* fail */
-/* pos 013b: 107 */    0xE7 /* 'g' -> */,
-/* pos 013c: 108 */    0xED /* 'm' -> */,
-/* pos 013d: 109 */    0xE1 /* 'a' -> */,
-/* pos 013e: 110 */    0xBA /* ':' -> */,
-/* pos 013f: 111 */    0x00, 0x10                  /* - terminal marker 16 - */,
-/* pos 0141: 112 */    0xE3 /* 'c' -> */,
-/* pos 0142: 113 */    0xE8 /* 'h' -> */,
-/* pos 0143: 114 */    0xE5 /* 'e' -> */,
-/* pos 0144: 115 */    0xAD /* '-' -> */,
-/* pos 0145: 116 */    0xE3 /* 'c' -> */,
-/* pos 0146: 117 */    0xEF /* 'o' -> */,
-/* pos 0147: 118 */    0xEE /* 'n' -> */,
-/* pos 0148: 119 */    0xF4 /* 't' -> */,
-/* pos 0149: 120 */    0xF2 /* 'r' -> */,
-/* pos 014a: 121 */    0xEF /* 'o' -> */,
-/* pos 014b: 122 */    0xEC /* 'l' -> */,
-/* pos 014c: 123 */    0xBA /* ':' -> */,
-/* pos 014d: 124 */    0x00, 0x11                  /* - terminal marker 17 - */,
-/* pos 014f: 125 */    0xF4 /* 't' -> */,
-/* pos 0150: 126 */    0xE8 /* 'h' -> */,
-/* pos 0151: 127 */    0xEF /* 'o' -> */,
-/* pos 0152: 128 */    0xF2 /* 'r' -> */,
-/* pos 0153: 129 */    0xE9 /* 'i' -> */,
-/* pos 0154: 130 */    0xFA /* 'z' -> */,
-/* pos 0155: 131 */    0xE1 /* 'a' -> */,
-/* pos 0156: 132 */    0xF4 /* 't' -> */,
-/* pos 0157: 133 */    0xE9 /* 'i' -> */,
-/* pos 0158: 134 */    0xEF /* 'o' -> */,
-/* pos 0159: 135 */    0xEE /* 'n' -> */,
-/* pos 015a: 136 */    0xBA /* ':' -> */,
-/* pos 015b: 137 */    0x00, 0x12                  /* - terminal marker 18 - */,
-/* pos 015d: 138 */    0xEB /* 'k' -> */,
-/* pos 015e: 139 */    0xE9 /* 'i' -> */,
-/* pos 015f: 140 */    0xE5 /* 'e' -> */,
-/* pos 0160: 141 */    0xBA /* ':' -> */,
-/* pos 0161: 142 */    0x00, 0x13                  /* - terminal marker 19 - */,
-/* pos 0163: 143 */    0xE5 /* 'e' -> */,
-/* pos 0164: 144 */    0xEE /* 'n' -> */,
-/* pos 0165: 145 */    0xF4 /* 't' -> */,
-/* pos 0166: 146 */    0xAD /* '-' -> */,
-/* pos 0167: 147 */    0x6C /* 'l' */, 0x10, 0x00  /* (to 0x0177 state 148) */,
-                       0x74 /* 't' */, 0x1E, 0x00  /* (to 0x0188 state 155) */,
-                       0x64 /* 'd' */, 0x4C, 0x00  /* (to 0x01B9 state 186) */,
-                       0x65 /* 'e' */, 0x56, 0x00  /* (to 0x01C6 state 198) */,
-                       0x72 /* 'r' */, 0x6F, 0x00  /* (to 0x01E2 state 223) */,
-                       0x08, /* fail */
-/* pos 0177: 148 */    0x65 /* 'e' */, 0x0A, 0x00  /* (to 0x0181 state 149) */,
-                       0x61 /* 'a' */, 0x56, 0x00  /* (to 0x01D0 state 207) */,
-                       0x6F /* 'o' */, 0x5C, 0x00  /* (to 0x01D9 state 215) */,
-                       0x08, /* fail */
-/* pos 0181: 149 */    0xEE /* 'n' -> */,
-/* pos 0182: 150 */    0xE7 /* 'g' -> */,
-/* pos 0183: 151 */    0xF4 /* 't' -> */,
-/* pos 0184: 152 */    0xE8 /* 'h' -> */,
-/* pos 0185: 153 */    0xBA /* ':' -> */,
-/* pos 0186: 154 */    0x00, 0x14                  /* - terminal marker 20 - */,
-/* pos 0188: 155 */    0xF9 /* 'y' -> */,
-/* pos 0189: 156 */    0xF0 /* 'p' -> */,
-/* pos 018a: 157 */    0xE5 /* 'e' -> */,
-/* pos 018b: 158 */    0xBA /* ':' -> */,
-/* pos 018c: 159 */    0x00, 0x15                  /* - terminal marker 21 - */,
-/* pos 018e: 160 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0195 state 161) */,
-                       0x65 /* 'e' */, 0x3C, 0x02  /* (to 0x03CD state 580) */,
-                       0x08, /* fail */
-/* pos 0195: 161 */    0xF4 /* 't' -> */,
-/* pos 0196: 162 */    0xE5 /* 'e' -> */,
-/* pos 0197: 163 */    0xBA /* ':' -> */,
-/* pos 0198: 164 */    0x00, 0x16                  /* - terminal marker 22 - */,
-/* pos 019a: 165 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x01A1 state 166) */,
-                       0x65 /* 'e' */, 0xB6, 0x00  /* (to 0x0253 state 304) */,
-                       0x08, /* fail */
-/* pos 01a1: 166 */    0xEE /* 'n' -> */,
-/* pos 01a2: 167 */    0xE7 /* 'g' -> */,
-/* pos 01a3: 168 */    0xE5 /* 'e' -> */,
-/* pos 01a4: 169 */    0xBA /* ':' -> */,
-/* pos 01a5: 170 */    0x00, 0x17                  /* - terminal marker 23 - */,
-/* pos 01a7: 171 */    0xE1 /* 'a' -> */,
-/* pos 01a8: 172 */    0xEE /* 'n' -> */,
-/* pos 01a9: 173 */    0xE7 /* 'g' -> */,
-/* pos 01aa: 174 */    0xE5 /* 'e' -> */,
-/* pos 01ab: 175 */    0xF3 /* 's' -> */,
-/* pos 01ac: 176 */    0xBA /* ':' -> */,
-/* pos 01ad: 177 */    0x00, 0x1F                  /* - terminal marker 31 - */,
-/* pos 01af: 178 */    0xE5 /* 'e' -> */,
-/* pos 01b0: 179 */    0xBA /* ':' -> */,
-/* pos 01b1: 180 */    0x00, 0x21                  /* - terminal marker 33 - */,
-/* pos 01b3: 181 */    0xEC /* 'l' -> */,
-/* pos 01b4: 182 */    0xEF /* 'o' -> */,
-/* pos 01b5: 183 */    0xF7 /* 'w' -> */,
-/* pos 01b6: 184 */    0xBA /* ':' -> */,
-/* pos 01b7: 185 */    0x00, 0x22                  /* - terminal marker 34 - */,
-/* pos 01b9: 186 */    0xE9 /* 'i' -> */,
-/* pos 01ba: 187 */    0xF3 /* 's' -> */,
-/* pos 01bb: 188 */    0xF0 /* 'p' -> */,
-/* pos 01bc: 189 */    0xEF /* 'o' -> */,
-/* pos 01bd: 190 */    0xF3 /* 's' -> */,
-/* pos 01be: 191 */    0xE9 /* 'i' -> */,
-/* pos 01bf: 192 */    0xF4 /* 't' -> */,
-/* pos 01c0: 193 */    0xE9 /* 'i' -> */,
-/* pos 01c1: 194 */    0xEF /* 'o' -> */,
-/* pos 01c2: 195 */    0xEE /* 'n' -> */,
-/* pos 01c3: 196 */    0xBA /* ':' -> */,
-/* pos 01c4: 197 */    0x00, 0x23                  /* - terminal marker 35 - */,
-/* pos 01c6: 198 */    0xEE /* 'n' -> */,
-/* pos 01c7: 199 */    0xE3 /* 'c' -> */,
-/* pos 01c8: 200 */    0xEF /* 'o' -> */,
-/* pos 01c9: 201 */    0xE4 /* 'd' -> */,
-/* pos 01ca: 202 */    0xE9 /* 'i' -> */,
-/* pos 01cb: 203 */    0xEE /* 'n' -> */,
-/* pos 01cc: 204 */    0xE7 /* 'g' -> */,
-/* pos 01cd: 205 */    0xBA /* ':' -> */,
-/* pos 01ce: 206 */    0x00, 0x24                  /* - terminal marker 36 - */,
-/* pos 01d0: 207 */    0xEE /* 'n' -> */,
-/* pos 01d1: 208 */    0xE7 /* 'g' -> */,
-/* pos 01d2: 209 */    0xF5 /* 'u' -> */,
-/* pos 01d3: 210 */    0xE1 /* 'a' -> */,
-/* pos 01d4: 211 */    0xE7 /* 'g' -> */,
-/* pos 01d5: 212 */    0xE5 /* 'e' -> */,
-/* pos 01d6: 213 */    0xBA /* ':' -> */,
-/* pos 01d7: 214 */    0x00, 0x25                  /* - terminal marker 37 - */,
-/* pos 01d9: 215 */    0xE3 /* 'c' -> */,
-/* pos 01da: 216 */    0xE1 /* 'a' -> */,
-/* pos 01db: 217 */    0xF4 /* 't' -> */,
-/* pos 01dc: 218 */    0xE9 /* 'i' -> */,
-/* pos 01dd: 219 */    0xEF /* 'o' -> */,
-/* pos 01de: 220 */    0xEE /* 'n' -> */,
-/* pos 01df: 221 */    0xBA /* ':' -> */,
-/* pos 01e0: 222 */    0x00, 0x26                  /* - terminal marker 38 - */,
-/* pos 01e2: 223 */    0xE1 /* 'a' -> */,
-/* pos 01e3: 224 */    0xEE /* 'n' -> */,
-/* pos 01e4: 225 */    0xE7 /* 'g' -> */,
-/* pos 01e5: 226 */    0xE5 /* 'e' -> */,
-/* pos 01e6: 227 */    0xBA /* ':' -> */,
-/* pos 01e7: 228 */    0x00, 0x27                  /* - terminal marker 39 - */,
-/* pos 01e9: 229 */    0x74 /* 't' */, 0x07, 0x00  /* (to 0x01F0 state 230) */,
-                       0x78 /* 'x' */, 0x09, 0x00  /* (to 0x01F5 state 234) */,
-                       0x08, /* fail */
-/* pos 01f0: 230 */    0xE1 /* 'a' -> */,
-/* pos 01f1: 231 */    0xE7 /* 'g' -> */,
-/* pos 01f2: 232 */    0xBA /* ':' -> */,
-/* pos 01f3: 233 */    0x00, 0x28                  /* - terminal marker 40 - */,
-/* pos 01f5: 234 */    0xF0 /* 'p' -> */,
-/* pos 01f6: 235 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x01FD state 236) */,
-                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x0202 state 240) */,
-                       0x08, /* fail */
-/* pos 01fd: 236 */    0xE3 /* 'c' -> */,
-/* pos 01fe: 237 */    0xF4 /* 't' -> */,
-/* pos 01ff: 238 */    0xBA /* ':' -> */,
-/* pos 0200: 239 */    0x00, 0x29                  /* - terminal marker 41 - */,
-/* pos 0202: 240 */    0xF2 /* 'r' -> */,
-/* pos 0203: 241 */    0xE5 /* 'e' -> */,
-/* pos 0204: 242 */    0xF3 /* 's' -> */,
-/* pos 0205: 243 */    0xBA /* ':' -> */,
-/* pos 0206: 244 */    0x00, 0x2A                  /* - terminal marker 42 - */,
-/* pos 0208: 245 */    0xF2 /* 'r' -> */,
-/* pos 0209: 246 */    0xEF /* 'o' -> */,
-/* pos 020a: 247 */    0xED /* 'm' -> */,
-/* pos 020b: 248 */    0xBA /* ':' -> */,
-/* pos 020c: 249 */    0x00, 0x2B                  /* - terminal marker 43 - */,
-/* pos 020e: 250 */    0xF4 /* 't' -> */,
-/* pos 020f: 251 */    0xE3 /* 'c' -> */,
-/* pos 0210: 252 */    0xE8 /* 'h' -> */,
-/* pos 0211: 253 */    0xBA /* ':' -> */,
-/* pos 0212: 254 */    0x00, 0x2C                  /* - terminal marker 44 - */,
-/* pos 0214: 255 */    0xE1 /* 'a' -> */,
-/* pos 0215: 256 */    0xEE /* 'n' -> */,
-/* pos 0216: 257 */    0xE7 /* 'g' -> */,
-/* pos 0217: 258 */    0xE5 /* 'e' -> */,
-/* pos 0218: 259 */    0xBA /* ':' -> */,
-/* pos 0219: 260 */    0x00, 0x2D                  /* - terminal marker 45 - */,
-/* pos 021b: 261 */    0xEE /* 'n' -> */,
-/* pos 021c: 262 */    0xED /* 'm' -> */,
-/* pos 021d: 263 */    0xEF /* 'o' -> */,
-/* pos 021e: 264 */    0xE4 /* 'd' -> */,
-/* pos 021f: 265 */    0xE9 /* 'i' -> */,
-/* pos 0220: 266 */    0xE6 /* 'f' -> */,
-/* pos 0221: 267 */    0xE9 /* 'i' -> */,
-/* pos 0222: 268 */    0xE5 /* 'e' -> */,
-/* pos 0223: 269 */    0xE4 /* 'd' -> */,
-/* pos 0224: 270 */    0xAD /* '-' -> */,
-/* pos 0225: 271 */    0xF3 /* 's' -> */,
-/* pos 0226: 272 */    0xE9 /* 'i' -> */,
-/* pos 0227: 273 */    0xEE /* 'n' -> */,
-/* pos 0228: 274 */    0xE3 /* 'c' -> */,
-/* pos 0229: 275 */    0xE5 /* 'e' -> */,
-/* pos 022a: 276 */    0xBA /* ':' -> */,
-/* pos 022b: 277 */    0x00, 0x2E                  /* - terminal marker 46 - */,
-/* pos 022d: 278 */    0x61 /* 'a' */, 0x0A, 0x00  /* (to 0x0237 state 279) */,
-                       0x69 /* 'i' */, 0x15, 0x00  /* (to 0x0245 state 292) */,
-                       0x6F /* 'o' */, 0x17, 0x00  /* (to 0x024A state 296) */,
-                       0x08, /* fail */
-/* pos 0237: 279 */    0xF3 /* 's' -> */,
-/* pos 0238: 280 */    0xF4 /* 't' -> */,
-/* pos 0239: 281 */    0xAD /* '-' -> */,
-/* pos 023a: 282 */    0xED /* 'm' -> */,
-/* pos 023b: 283 */    0xEF /* 'o' -> */,
-/* pos 023c: 284 */    0xE4 /* 'd' -> */,
-/* pos 023d: 285 */    0xE9 /* 'i' -> */,
-/* pos 023e: 286 */    0xE6 /* 'f' -> */,
-/* pos 023f: 287 */    0xE9 /* 'i' -> */,
-/* pos 0240: 288 */    0xE5 /* 'e' -> */,
-/* pos 0241: 289 */    0xE4 /* 'd' -> */,
-/* pos 0242: 290 */    0xBA /* ':' -> */,
-/* pos 0243: 291 */    0x00, 0x2F                  /* - terminal marker 47 - */,
-/* pos 0245: 292 */    0xEE /* 'n' -> */,
-/* pos 0246: 293 */    0xEB /* 'k' -> */,
-/* pos 0247: 294 */    0xBA /* ':' -> */,
-/* pos 0248: 295 */    0x00, 0x30                  /* - terminal marker 48 - */,
-/* pos 024a: 296 */    0xE3 /* 'c' -> */,
-/* pos 024b: 297 */    0xE1 /* 'a' -> */,
-/* pos 024c: 298 */    0xF4 /* 't' -> */,
-/* pos 024d: 299 */    0xE9 /* 'i' -> */,
-/* pos 024e: 300 */    0xEF /* 'o' -> */,
-/* pos 024f: 301 */    0xEE /* 'n' -> */,
-/* pos 0250: 302 */    0xBA /* ':' -> */,
-/* pos 0251: 303 */    0x00, 0x31                  /* - terminal marker 49 - */,
-/* pos 0253: 304 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x025D state 305) */,
-                       0x74 /* 't' */, 0x14, 0x00  /* (to 0x026A state 311) */,
-                       0x70 /* 'p' */, 0x88, 0x01  /* (to 0x03E1 state 596) */,
-                       0x08, /* fail */
-/* pos 025d: 305 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x0264 state 306) */,
-                       0x65 /* 'e' */, 0xCA, 0x00  /* (to 0x032A state 448) */,
-                       0x08, /* fail */
-/* pos 0264: 306 */    0xE5 /* 'e' -> */,
-/* pos 0265: 307 */    0xF3 /* 's' -> */,
-/* pos 0266: 308 */    0xE8 /* 'h' -> */,
-/* pos 0267: 309 */    0xBA /* ':' -> */,
-/* pos 0268: 310 */    0x00, 0x35                  /* - terminal marker 53 - */,
-/* pos 026a: 311 */    0xF2 /* 'r' -> */,
-/* pos 026b: 312 */    0xF9 /* 'y' -> */,
-/* pos 026c: 313 */    0xAD /* '-' -> */,
-/* pos 026d: 314 */    0xE1 /* 'a' -> */,
-/* pos 026e: 315 */    0xE6 /* 'f' -> */,
-/* pos 026f: 316 */    0xF4 /* 't' -> */,
-/* pos 0270: 317 */    0xE5 /* 'e' -> */,
-/* pos 0271: 318 */    0xF2 /* 'r' -> */,
-/* pos 0272: 319 */    0xBA /* ':' -> */,
-/* pos 0273: 320 */    0x00, 0x36                  /* - terminal marker 54 - */,
-/* pos 0275: 321 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x027C state 322) */,
-                       0x74 /* 't' */, 0x06, 0x01  /* (to 0x037E state 514) */,
-                       0x08, /* fail */
-/* pos 027c: 322 */    0x72 /* 'r' */, 0x0A, 0x00  /* (to 0x0286 state 323) */,
-                       0x74 /* 't' */, 0x0D, 0x00  /* (to 0x028C state 328) */,
-                       0x63 /* 'c' */, 0x6B, 0x01  /* (to 0x03ED state 607) */,
-                       0x08, /* fail */
-/* pos 0286: 323 */    0xF6 /* 'v' -> */,
-/* pos 0287: 324 */    0xE5 /* 'e' -> */,
-/* pos 0288: 325 */    0xF2 /* 'r' -> */,
-/* pos 0289: 326 */    0xBA /* ':' -> */,
-/* pos 028a: 327 */    0x00, 0x37                  /* - terminal marker 55 - */,
-/* pos 028c: 328 */    0xAD /* '-' -> */,
-/* pos 028d: 329 */    0xE3 /* 'c' -> */,
-/* pos 028e: 330 */    0xEF /* 'o' -> */,
-/* pos 028f: 331 */    0xEF /* 'o' -> */,
-/* pos 0290: 332 */    0xEB /* 'k' -> */,
-/* pos 0291: 333 */    0xE9 /* 'i' -> */,
-/* pos 0292: 334 */    0xE5 /* 'e' -> */,
-/* pos 0293: 335 */    0xBA /* ':' -> */,
-/* pos 0294: 336 */    0x00, 0x38                  /* - terminal marker 56 - */,
-/* pos 0296: 337 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x029D state 338) */,
-                       0x65 /* 'e' */, 0x45, 0x01  /* (to 0x03DE state 594) */,
-                       0x08, /* fail */
-/* pos 029d: 338 */    0xE1 /* 'a' -> */,
-/* pos 029e: 339 */    0xEE /* 'n' -> */,
-/* pos 029f: 340 */    0xF3 /* 's' -> */,
-/* pos 02a0: 341 */    0xE6 /* 'f' -> */,
-/* pos 02a1: 342 */    0xE5 /* 'e' -> */,
-/* pos 02a2: 343 */    0xF2 /* 'r' -> */,
-/* pos 02a3: 344 */    0xAD /* '-' -> */,
-/* pos 02a4: 345 */    0xE5 /* 'e' -> */,
-/* pos 02a5: 346 */    0xEE /* 'n' -> */,
-/* pos 02a6: 347 */    0xE3 /* 'c' -> */,
-/* pos 02a7: 348 */    0xEF /* 'o' -> */,
-/* pos 02a8: 349 */    0xE4 /* 'd' -> */,
-/* pos 02a9: 350 */    0xE9 /* 'i' -> */,
-/* pos 02aa: 351 */    0xEE /* 'n' -> */,
-/* pos 02ab: 352 */    0xE7 /* 'g' -> */,
-/* pos 02ac: 353 */    0xBA /* ':' -> */,
-/* pos 02ad: 354 */    0x00, 0x3A                  /* - terminal marker 58 - */,
-/* pos 02af: 355 */    0xE9 /* 'i' -> */,
-/* pos 02b0: 356 */    0xAD /* '-' -> */,
-/* pos 02b1: 357 */    0xE1 /* 'a' -> */,
-/* pos 02b2: 358 */    0xF2 /* 'r' -> */,
-/* pos 02b3: 359 */    0xE7 /* 'g' -> */,
-/* pos 02b4: 360 */    0xF3 /* 's' -> */,
-/* pos 02b5: 361 */    0x00, 0x42                  /* - terminal marker 66 - */,
-/* pos 02b7: 362 */    0xA0 /* ' ' -> */,
-/* pos 02b8: 363 */    0x00, 0x45                  /* - terminal marker 69 - */,
-/* pos 02ba: 364 */    0xAD /* '-' -> */,
-/* pos 02bb: 365 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x02C5 state 366) */,
-                       0x61 /* 'a' */, 0x1D, 0x00  /* (to 0x02DB state 385) */,
-                       0x72 /* 'r' */, 0x14, 0x01  /* (to 0x03D5 state 586) */,
-                       0x08, /* fail */
-/* pos 02c5: 366 */    0xEF /* 'o' -> */,
-/* pos 02c6: 367 */    0xF2 /* 'r' -> */,
-/* pos 02c7: 368 */    0xF7 /* 'w' -> */,
-/* pos 02c8: 369 */    0xE1 /* 'a' -> */,
-/* pos 02c9: 370 */    0xF2 /* 'r' -> */,
-/* pos 02ca: 371 */    0xE4 /* 'd' -> */,
-/* pos 02cb: 372 */    0xE5 /* 'e' -> */,
-/* pos 02cc: 373 */    0xE4 /* 'd' -> */,
-/* pos 02cd: 374 */    0xAD /* '-' -> */,
-/* pos 02ce: 375 */    0xE6 /* 'f' -> */,
-/* pos 02cf: 376 */    0xEF /* 'o' -> */,
-/* pos 02d0: 377 */    0xF2 /* 'r' -> */,
-/* pos 02d1: 378 */    0xBA /* ':' -> */,
-/* pos 02d2: 379 */    0x00, 0x46                  /* - terminal marker 70 - */,
-/* pos 02d4: 380 */    0x00, 0x47                  /* - terminal marker 71 - */,
-/* pos 02d6: 381 */    0xE1 /* 'a' -> */,
-/* pos 02d7: 382 */    0xE4 /* 'd' -> */,
-/* pos 02d8: 383 */    0xA0 /* ' ' -> */,
-/* pos 02d9: 384 */    0x00, 0x48                  /* - terminal marker 72 - */,
-/* pos 02db: 385 */    0x75 /* 'u' */, 0x07, 0x00  /* (to 0x02E2 state 386) */,
-                       0x6D /* 'm' */, 0x0F, 0x00  /* (to 0x02ED state 396) */,
-                       0x08, /* fail */
-/* pos 02e2: 386 */    0xF4 /* 't' -> */,
-/* pos 02e3: 387 */    0xE8 /* 'h' -> */,
-/* pos 02e4: 388 */    0xAD /* '-' -> */,
-/* pos 02e5: 389 */    0xF4 /* 't' -> */,
-/* pos 02e6: 390 */    0xEF /* 'o' -> */,
-/* pos 02e7: 391 */    0xEB /* 'k' -> */,
-/* pos 02e8: 392 */    0xE5 /* 'e' -> */,
-/* pos 02e9: 393 */    0xEE /* 'n' -> */,
-/* pos 02ea: 394 */    0xBA /* ':' -> */,
-/* pos 02eb: 395 */    0x00, 0x4C                  /* - terminal marker 76 - */,
-/* pos 02ed: 396 */    0xFA /* 'z' -> */,
-/* pos 02ee: 397 */    0xEE /* 'n' -> */,
-/* pos 02ef: 398 */    0xAD /* '-' -> */,
-/* pos 02f0: 399 */    0xE4 /* 'd' -> */,
-/* pos 02f1: 400 */    0xF3 /* 's' -> */,
-/* pos 02f2: 401 */    0xF3 /* 's' -> */,
-/* pos 02f3: 402 */    0xAD /* '-' -> */,
-/* pos 02f4: 403 */    0xF3 /* 's' -> */,
-/* pos 02f5: 404 */    0xE9 /* 'i' -> */,
-/* pos 02f6: 405 */    0xE7 /* 'g' -> */,
-/* pos 02f7: 406 */    0xEE /* 'n' -> */,
-/* pos 02f8: 407 */    0xE1 /* 'a' -> */,
-/* pos 02f9: 408 */    0xF4 /* 't' -> */,
-/* pos 02fa: 409 */    0xF5 /* 'u' -> */,
-/* pos 02fb: 410 */    0xF2 /* 'r' -> */,
-/* pos 02fc: 411 */    0xE5 /* 'e' -> */,
-/* pos 02fd: 412 */    0xBA /* ':' -> */,
-/* pos 02fe: 413 */    0x00, 0x4D                  /* - terminal marker 77 - */,
-/* pos 0300: 414 */    0xF4 /* 't' -> */,
-/* pos 0301: 415 */    0xE9 /* 'i' -> */,
-/* pos 0302: 416 */    0xEF /* 'o' -> */,
-/* pos 0303: 417 */    0xEE /* 'n' -> */,
-/* pos 0304: 418 */    0xF3 /* 's' -> */,
-/* pos 0305: 419 */    0xA0 /* ' ' -> */,
-/* pos 0306: 420 */    0x00, 0x02                  /* - terminal marker  2 - */,
-/* pos 0308: 421 */    0xF3 /* 's' -> */,
-/* pos 0309: 422 */    0xAD /* '-' -> */,
-/* pos 030a: 423 */    0xE3 /* 'c' -> */,
-/* pos 030b: 424 */    0xEF /* 'o' -> */,
-/* pos 030c: 425 */    0xEE /* 'n' -> */,
-/* pos 030d: 426 */    0xF4 /* 't' -> */,
-/* pos 030e: 427 */    0xF2 /* 'r' -> */,
-/* pos 030f: 428 */    0xEF /* 'o' -> */,
-/* pos 0310: 429 */    0xEC /* 'l' -> */,
-/* pos 0311: 430 */    0xAD /* '-' -> */,
-/* pos 0312: 431 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x0319 state 432) */,
-                       0x61 /* 'a' */, 0x24, 0x00  /* (to 0x0339 state 461) */,
-                       0x08, /* fail */
-/* pos 0319: 432 */    0xE5 /* 'e' -> */,
-/* pos 031a: 433 */    0xF1 /* 'q' -> */,
-/* pos 031b: 434 */    0xF5 /* 'u' -> */,
-/* pos 031c: 435 */    0xE5 /* 'e' -> */,
-/* pos 031d: 436 */    0xF3 /* 's' -> */,
-/* pos 031e: 437 */    0xF4 /* 't' -> */,
-/* pos 031f: 438 */    0xAD /* '-' -> */,
-/* pos 0320: 439 */    0xE8 /* 'h' -> */,
-/* pos 0321: 440 */    0xE5 /* 'e' -> */,
-/* pos 0322: 441 */    0xE1 /* 'a' -> */,
-/* pos 0323: 442 */    0xE4 /* 'd' -> */,
-/* pos 0324: 443 */    0xE5 /* 'e' -> */,
-/* pos 0325: 444 */    0xF2 /* 'r' -> */,
-/* pos 0326: 445 */    0xF3 /* 's' -> */,
-/* pos 0327: 446 */    0xBA /* ':' -> */,
-/* pos 0328: 447 */    0x00, 0x0B                  /* - terminal marker 11 - */,
-/* pos 032a: 448 */    0xF2 /* 'r' -> */,
-/* pos 032b: 449 */    0xE5 /* 'e' -> */,
-/* pos 032c: 450 */    0xF2 /* 'r' -> */,
-/* pos 032d: 451 */    0xBA /* ':' -> */,
-/* pos 032e: 452 */    0x00, 0x18                  /* - terminal marker 24 - */,
-/* pos 0330: 453 */    0xE8 /* 'h' -> */,
-/* pos 0331: 454 */    0xE1 /* 'a' -> */,
-/* pos 0332: 455 */    0xF2 /* 'r' -> */,
-/* pos 0333: 456 */    0xF3 /* 's' -> */,
-/* pos 0334: 457 */    0xE5 /* 'e' -> */,
-/* pos 0335: 458 */    0xF4 /* 't' -> */,
-/* pos 0336: 459 */    0xBA /* ':' -> */,
-/* pos 0337: 460 */    0x00, 0x1E                  /* - terminal marker 30 - */,
-/* pos 0339: 461 */    0xEC /* 'l' -> */,
-/* pos 033a: 462 */    0xEC /* 'l' -> */,
-/* pos 033b: 463 */    0xEF /* 'o' -> */,
-/* pos 033c: 464 */    0xF7 /* 'w' -> */,
-/* pos 033d: 465 */    0xAD /* '-' -> */,
-/* pos 033e: 466 */    0xEF /* 'o' -> */,
-/* pos 033f: 467 */    0xF2 /* 'r' -> */,
-/* pos 0340: 468 */    0xE9 /* 'i' -> */,
-/* pos 0341: 469 */    0xE7 /* 'g' -> */,
-/* pos 0342: 470 */    0xE9 /* 'i' -> */,
-/* pos 0343: 471 */    0xEE /* 'n' -> */,
-/* pos 0344: 472 */    0xBA /* ':' -> */,
-/* pos 0345: 473 */    0x00, 0x20                  /* - terminal marker 32 - */,
-/* pos 0347: 474 */    0xE1 /* 'a' -> */,
-/* pos 0348: 475 */    0xF8 /* 'x' -> */,
-/* pos 0349: 476 */    0xAD /* '-' -> */,
-/* pos 034a: 477 */    0xE6 /* 'f' -> */,
-/* pos 034b: 478 */    0xEF /* 'o' -> */,
-/* pos 034c: 479 */    0xF2 /* 'r' -> */,
-/* pos 034d: 480 */    0xF7 /* 'w' -> */,
-/* pos 034e: 481 */    0xE1 /* 'a' -> */,
-/* pos 034f: 482 */    0xF2 /* 'r' -> */,
-/* pos 0350: 483 */    0xE4 /* 'd' -> */,
-/* pos 0351: 484 */    0xF3 /* 's' -> */,
-/* pos 0352: 485 */    0xBA /* ':' -> */,
-/* pos 0353: 486 */    0x00, 0x32                  /* - terminal marker 50 - */,
-/* pos 0355: 487 */    0xF8 /* 'x' -> */,
-/* pos 0356: 488 */    0xF9 /* 'y' -> */,
-/* pos 0357: 489 */    0x2D /* '-' */, 0x07, 0x00  /* (to 0x035E state 490) */,
-                       0x20 /* ' ' */, 0x79, 0x00  /* (to 0x03D3 state 585) */,
-                       0x08, /* fail */
-/* pos 035e: 490 */    0xE1 /* 'a' -> */,
-/* pos 035f: 491 */    0xF5 /* 'u' -> */,
-/* pos 0360: 492 */    0xF4 /* 't' -> */,
-/* pos 0361: 493 */    0xE8 /* 'h' -> */,
-/* pos 0362: 494 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x0369 state 495) */,
-                       0x6F /* 'o' */, 0x0E, 0x00  /* (to 0x0373 state 504) */,
-                       0x08, /* fail */
-/* pos 0369: 495 */    0xEE /* 'n' -> */,
-/* pos 036a: 496 */    0xF4 /* 't' -> */,
-/* pos 036b: 497 */    0xE9 /* 'i' -> */,
-/* pos 036c: 498 */    0xE3 /* 'c' -> */,
-/* pos 036d: 499 */    0xE1 /* 'a' -> */,
-/* pos 036e: 500 */    0xF4 /* 't' -> */,
-/* pos 036f: 501 */    0xE5 /* 'e' -> */,
-/* pos 0370: 502 */    0xBA /* ':' -> */,
-/* pos 0371: 503 */    0x00, 0x33                  /* - terminal marker 51 - */,
-/* pos 0373: 504 */    0xF2 /* 'r' -> */,
-/* pos 0374: 505 */    0xE9 /* 'i' -> */,
-/* pos 0375: 506 */    0xFA /* 'z' -> */,
-/* pos 0376: 507 */    0xE1 /* 'a' -> */,
-/* pos 0377: 508 */    0xF4 /* 't' -> */,
-/* pos 0378: 509 */    0xE9 /* 'i' -> */,
-/* pos 0379: 510 */    0xEF /* 'o' -> */,
-/* pos 037a: 511 */    0xEE /* 'n' -> */,
-/* pos 037b: 512 */    0xBA /* ':' -> */,
-/* pos 037c: 513 */    0x00, 0x34                  /* - terminal marker 52 - */,
-/* pos 037e: 514 */    0xF2 /* 'r' -> */,
-/* pos 037f: 515 */    0xE9 /* 'i' -> */,
-/* pos 0380: 516 */    0xE3 /* 'c' -> */,
-/* pos 0381: 517 */    0xF4 /* 't' -> */,
-/* pos 0382: 518 */    0xAD /* '-' -> */,
-/* pos 0383: 519 */    0xF4 /* 't' -> */,
-/* pos 0384: 520 */    0xF2 /* 'r' -> */,
-/* pos 0385: 521 */    0xE1 /* 'a' -> */,
-/* pos 0386: 522 */    0xEE /* 'n' -> */,
-/* pos 0387: 523 */    0xF3 /* 's' -> */,
-/* pos 0388: 524 */    0xF0 /* 'p' -> */,
-/* pos 0389: 525 */    0xEF /* 'o' -> */,
-/* pos 038a: 526 */    0xF2 /* 'r' -> */,
-/* pos 038b: 527 */    0xF4 /* 't' -> */,
-/* pos 038c: 528 */    0xAD /* '-' -> */,
-/* pos 038d: 529 */    0xF3 /* 's' -> */,
-/* pos 038e: 530 */    0xE5 /* 'e' -> */,
-/* pos 038f: 531 */    0xE3 /* 'c' -> */,
-/* pos 0390: 532 */    0xF5 /* 'u' -> */,
-/* pos 0391: 533 */    0xF2 /* 'r' -> */,
-/* pos 0392: 534 */    0xE9 /* 'i' -> */,
-/* pos 0393: 535 */    0xF4 /* 't' -> */,
-/* pos 0394: 536 */    0xF9 /* 'y' -> */,
-/* pos 0395: 537 */    0xBA /* ':' -> */,
-/* pos 0396: 538 */    0x00, 0x39                  /* - terminal marker 57 - */,
-/* pos 0398: 539 */    0xE5 /* 'e' -> */,
-/* pos 0399: 540 */    0xF2 /* 'r' -> */,
-/* pos 039a: 541 */    0xAD /* '-' -> */,
-/* pos 039b: 542 */    0xE1 /* 'a' -> */,
-/* pos 039c: 543 */    0xE7 /* 'g' -> */,
-/* pos 039d: 544 */    0xE5 /* 'e' -> */,
-/* pos 039e: 545 */    0xEE /* 'n' -> */,
-/* pos 039f: 546 */    0xF4 /* 't' -> */,
-/* pos 03a0: 547 */    0xBA /* ':' -> */,
-/* pos 03a1: 548 */    0x00, 0x3B                  /* - terminal marker 59 - */,
-/* pos 03a3: 549 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x03AA state 550) */,
-                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x03AF state 554) */,
-                       0x08, /* fail */
-/* pos 03aa: 550 */    0xF2 /* 'r' -> */,
-/* pos 03ab: 551 */    0xF9 /* 'y' -> */,
-/* pos 03ac: 552 */    0xBA /* ':' -> */,
-/* pos 03ad: 553 */    0x00, 0x3C                  /* - terminal marker 60 - */,
-/* pos 03af: 554 */    0xE1 /* 'a' -> */,
-/* pos 03b0: 555 */    0xBA /* ':' -> */,
-/* pos 03b1: 556 */    0x00, 0x3D                  /* - terminal marker 61 - */,
-/* pos 03b3: 557 */    0xF7 /* 'w' -> */,
-/* pos 03b4: 558 */    0xF7 /* 'w' -> */,
-/* pos 03b5: 559 */    0xAD /* '-' -> */,
-/* pos 03b6: 560 */    0xE1 /* 'a' -> */,
-/* pos 03b7: 561 */    0xF5 /* 'u' -> */,
-/* pos 03b8: 562 */    0xF4 /* 't' -> */,
-/* pos 03b9: 563 */    0xE8 /* 'h' -> */,
-/* pos 03ba: 564 */    0xE5 /* 'e' -> */,
-/* pos 03bb: 565 */    0xEE /* 'n' -> */,
-/* pos 03bc: 566 */    0xF4 /* 't' -> */,
-/* pos 03bd: 567 */    0xE9 /* 'i' -> */,
-/* pos 03be: 568 */    0xE3 /* 'c' -> */,
-/* pos 03bf: 569 */    0xE1 /* 'a' -> */,
-/* pos 03c0: 570 */    0xF4 /* 't' -> */,
-/* pos 03c1: 571 */    0xE5 /* 'e' -> */,
-/* pos 03c2: 572 */    0xBA /* ':' -> */,
-/* pos 03c3: 573 */    0x00, 0x3E                  /* - terminal marker 62 - */,
-/* pos 03c5: 574 */    0xF4 /* 't' -> */,
-/* pos 03c6: 575 */    0xE3 /* 'c' -> */,
-/* pos 03c7: 576 */    0xE8 /* 'h' -> */,
-/* pos 03c8: 577 */    0x00, 0x3F                  /* - terminal marker 63 - */,
-/* pos 03ca: 578 */    0xF4 /* 't' -> */,
-/* pos 03cb: 579 */    0x00, 0x40                  /* - terminal marker 64 - */,
-/* pos 03cd: 580 */    0xEC /* 'l' -> */,
-/* pos 03ce: 581 */    0xE5 /* 'e' -> */,
-/* pos 03cf: 582 */    0xF4 /* 't' -> */,
-/* pos 03d0: 583 */    0xE5 /* 'e' -> */,
-/* pos 03d1: 584 */    0x00, 0x41                  /* - terminal marker 65 - */,
-/* pos 03d3: 585 */    0x00, 0x43                  /* - terminal marker 67 - */,
-/* pos 03d5: 586 */    0xE5 /* 'e' -> */,
-/* pos 03d6: 587 */    0xE1 /* 'a' -> */,
-/* pos 03d7: 588 */    0xEC /* 'l' -> */,
-/* pos 03d8: 589 */    0xAD /* '-' -> */,
-/* pos 03d9: 590 */    0xE9 /* 'i' -> */,
-/* pos 03da: 591 */    0xF0 /* 'p' -> */,
-/* pos 03db: 592 */    0xBA /* ':' -> */,
-/* pos 03dc: 593 */    0x00, 0x44                  /* - terminal marker 68 - */,
-/* pos 03de: 594 */    0xBA /* ':' -> */,
-/* pos 03df: 595 */    0x00, 0x49                  /* - terminal marker 73 - */,
-/* pos 03e1: 596 */    0xEC /* 'l' -> */,
-/* pos 03e2: 597 */    0xE1 /* 'a' -> */,
-/* pos 03e3: 598 */    0xF9 /* 'y' -> */,
-/* pos 03e4: 599 */    0xAD /* '-' -> */,
-/* pos 03e5: 600 */    0xEE /* 'n' -> */,
-/* pos 03e6: 601 */    0xEF /* 'o' -> */,
-/* pos 03e7: 602 */    0xEE /* 'n' -> */,
-/* pos 03e8: 603 */    0xE3 /* 'c' -> */,
-/* pos 03e9: 604 */    0xE5 /* 'e' -> */,
-/* pos 03ea: 605 */    0xBA /* ':' -> */,
-/* pos 03eb: 606 */    0x00, 0x4A                  /* - terminal marker 74 - */,
-/* pos 03ed: 607 */    0xAD /* '-' -> */,
-/* pos 03ee: 608 */    0xF7 /* 'w' -> */,
-/* pos 03ef: 609 */    0xE5 /* 'e' -> */,
-/* pos 03f0: 610 */    0xE2 /* 'b' -> */,
-/* pos 03f1: 611 */    0xF3 /* 's' -> */,
-/* pos 03f2: 612 */    0xEF /* 'o' -> */,
-/* pos 03f3: 613 */    0xE3 /* 'c' -> */,
-/* pos 03f4: 614 */    0xEB /* 'k' -> */,
-/* pos 03f5: 615 */    0xE5 /* 'e' -> */,
-/* pos 03f6: 616 */    0xF4 /* 't' -> */,
-/* pos 03f7: 617 */    0xAD /* '-' -> */,
-/* pos 03f8: 618 */    0x64 /* 'd' */, 0x19, 0x00  /* (to 0x0411 state 619) */,
-                       0x65 /* 'e' */, 0x1D, 0x00  /* (to 0x0418 state 625) */,
-                       0x6B /* 'k' */, 0x26, 0x00  /* (to 0x0424 state 636) */,
-                       0x70 /* 'p' */, 0x35, 0x00  /* (to 0x0436 state 643) */,
-                       0x61 /* 'a' */, 0x3C, 0x00  /* (to 0x0440 state 652) */,
-                       0x6E /* 'n' */, 0x41, 0x00  /* (to 0x0448 state 659) */,
-                       0x76 /* 'v' */, 0x47, 0x00  /* (to 0x0451 state 666) */,
-                       0x6F /* 'o' */, 0x4D, 0x00  /* (to 0x045A state 674) */,
-                       0x08, /* fail */
-/* pos 0411: 619 */    0xF2 /* 'r' -> */,
-/* pos 0412: 620 */    0xE1 /* 'a' -> */,
-/* pos 0413: 621 */    0xE6 /* 'f' -> */,
-/* pos 0414: 622 */    0xF4 /* 't' -> */,
-/* pos 0415: 623 */    0xBA /* ':' -> */,
-/* pos 0416: 624 */    0x00, 0x07                  /* - terminal marker  7 - */,
-/* pos 0418: 625 */    0xF8 /* 'x' -> */,
-/* pos 0419: 626 */    0xF4 /* 't' -> */,
-/* pos 041a: 627 */    0xE5 /* 'e' -> */,
-/* pos 041b: 628 */    0xEE /* 'n' -> */,
-/* pos 041c: 629 */    0xF3 /* 's' -> */,
-/* pos 041d: 630 */    0xE9 /* 'i' -> */,
-/* pos 041e: 631 */    0xEF /* 'o' -> */,
-/* pos 041f: 632 */    0xEE /* 'n' -> */,
-/* pos 0420: 633 */    0xF3 /* 's' -> */,
-/* pos 0421: 634 */    0xBA /* ':' -> */,
-/* pos 0422: 635 */    0x00, 0x09                  /* - terminal marker  9 - */,
-/* pos 0424: 636 */    0xE5 /* 'e' -> */,
-/* pos 0425: 637 */    0xF9 /* 'y' -> */,
-/* pos 0426: 638 */    0x31 /* '1' */, 0x0A, 0x00  /* (to 0x0430 state 639) */,
-                       0x32 /* '2' */, 0x0A, 0x00  /* (to 0x0433 state 641) */,
-                       0x3A /* ':' */, 0x23, 0x00  /* (to 0x044F state 665) */,
-                       0x08, /* fail */
-/* pos 0430: 639 */    0xBA /* ':' -> */,
-/* pos 0431: 640 */    0x00, 0x0A                  /* - terminal marker 10 - */,
-/* pos 0433: 641 */    0xBA /* ':' -> */,
-/* pos 0434: 642 */    0x00, 0x0B                  /* - terminal marker 11 - */,
-/* pos 0436: 643 */    0xF2 /* 'r' -> */,
-/* pos 0437: 644 */    0xEF /* 'o' -> */,
-/* pos 0438: 645 */    0xF4 /* 't' -> */,
-/* pos 0439: 646 */    0xEF /* 'o' -> */,
-/* pos 043a: 647 */    0xE3 /* 'c' -> */,
-/* pos 043b: 648 */    0xEF /* 'o' -> */,
-/* pos 043c: 649 */    0xEC /* 'l' -> */,
-/* pos 043d: 650 */    0xBA /* ':' -> */,
-/* pos 043e: 651 */    0x00, 0x0C                  /* - terminal marker 12 - */,
-/* pos 0440: 652 */    0xE3 /* 'c' -> */,
-/* pos 0441: 653 */    0xE3 /* 'c' -> */,
-/* pos 0442: 654 */    0xE5 /* 'e' -> */,
-/* pos 0443: 655 */    0xF0 /* 'p' -> */,
-/* pos 0444: 656 */    0xF4 /* 't' -> */,
-/* pos 0445: 657 */    0xBA /* ':' -> */,
-/* pos 0446: 658 */    0x00, 0x0D                  /* - terminal marker 13 - */,
-/* pos 0448: 659 */    0xEF /* 'o' -> */,
-/* pos 0449: 660 */    0xEE /* 'n' -> */,
-/* pos 044a: 661 */    0xE3 /* 'c' -> */,
-/* pos 044b: 662 */    0xE5 /* 'e' -> */,
-/* pos 044c: 663 */    0xBA /* ':' -> */,
-/* pos 044d: 664 */    0x00, 0x0E                  /* - terminal marker 14 - */,
-/* pos 044f: 665 */    0x00, 0x1F                  /* - terminal marker 31 - */,
-/* pos 0451: 666 */    0xE5 /* 'e' -> */,
-/* pos 0452: 667 */    0xF2 /* 'r' -> */,
-/* pos 0453: 668 */    0xF3 /* 's' -> */,
-/* pos 0454: 669 */    0xE9 /* 'i' -> */,
-/* pos 0455: 670 */    0xEF /* 'o' -> */,
-/* pos 0456: 671 */    0xEE /* 'n' -> */,
-/* pos 0457: 672 */    0xBA /* ':' -> */,
-/* pos 0458: 673 */    0x00, 0x20                  /* - terminal marker 32 - */,
-/* pos 045a: 674 */    0xF2 /* 'r' -> */,
-/* pos 045b: 675 */    0xE9 /* 'i' -> */,
-/* pos 045c: 676 */    0xE7 /* 'g' -> */,
-/* pos 045d: 677 */    0xE9 /* 'i' -> */,
-/* pos 045e: 678 */    0xEE /* 'n' -> */,
-/* pos 045f: 679 */    0xBA /* ':' -> */,
-/* pos 0460: 680 */    0x00, 0x21                  /* - terminal marker 33 - */,
-/* pos 0462: 681 */    0xAD /* '-' -> */,
-/* pos 0463: 682 */    0xF3 /* 's' -> */,
-/* pos 0464: 683 */    0xE5 /* 'e' -> */,
-/* pos 0465: 684 */    0xF4 /* 't' -> */,
-/* pos 0466: 685 */    0xF4 /* 't' -> */,
-/* pos 0467: 686 */    0xE9 /* 'i' -> */,
-/* pos 0468: 687 */    0xEE /* 'n' -> */,
-/* pos 0469: 688 */    0xE7 /* 'g' -> */,
-/* pos 046a: 689 */    0xF3 /* 's' -> */,
-/* pos 046b: 690 */    0xBA /* ':' -> */,
-/* pos 046c: 691 */    0x00, 0x09                  /* - terminal marker  9 - */,
-/* pos 046e: 692 */    0x61 /* 'a' */, 0x0D, 0x00  /* (to 0x047B state 693) */,
-                       0x6D /* 'm' */, 0x14, 0x00  /* (to 0x0485 state 702) */,
-                       0x70 /* 'p' */, 0x18, 0x00  /* (to 0x048C state 708) */,
-                       0x73 /* 's' */, 0x20, 0x00  /* (to 0x0497 state 712) */,
-                       0x08, /* fail */
-/* pos 047b: 693 */    0xF5 /* 'u' -> */,
-/* pos 047c: 694 */    0xF4 /* 't' -> */,
-/* pos 047d: 695 */    0xE8 /* 'h' -> */,
-/* pos 047e: 696 */    0xEF /* 'o' -> */,
-/* pos 047f: 697 */    0xF2 /* 'r' -> */,
-/* pos 0480: 698 */    0xE9 /* 'i' -> */,
-/* pos 0481: 699 */    0xF4 /* 't' -> */,
-/* pos 0482: 700 */    0xF9 /* 'y' -> */,
-/* pos 0483: 701 */    0x00, 0x19                  /* - terminal marker 25 - */,
-/* pos 0485: 702 */    0xE5 /* 'e' -> */,
-/* pos 0486: 703 */    0xF4 /* 't' -> */,
-/* pos 0487: 704 */    0xE8 /* 'h' -> */,
-/* pos 0488: 705 */    0xEF /* 'o' -> */,
-/* pos 0489: 706 */    0xE4 /* 'd' -> */,
-/* pos 048a: 707 */    0x00, 0x1A                  /* - terminal marker 26 - */,
-/* pos 048c: 708 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0493 state 709) */,
-                       0x72 /* 'r' */, 0x1B, 0x00  /* (to 0x04AA state 723) */,
-                       0x08, /* fail */
-/* pos 0493: 709 */    0xF4 /* 't' -> */,
-/* pos 0494: 710 */    0xE8 /* 'h' -> */,
-/* pos 0495: 711 */    0x00, 0x1B                  /* - terminal marker 27 - */,
-/* pos 0497: 712 */    0x63 /* 'c' */, 0x07, 0x00  /* (to 0x049E state 713) */,
-                       0x74 /* 't' */, 0x0A, 0x00  /* (to 0x04A4 state 718) */,
-                       0x08, /* fail */
-/* pos 049e: 713 */    0xE8 /* 'h' -> */,
-/* pos 049f: 714 */    0xE5 /* 'e' -> */,
-/* pos 04a0: 715 */    0xED /* 'm' -> */,
-/* pos 04a1: 716 */    0xE5 /* 'e' -> */,
-/* pos 04a2: 717 */    0x00, 0x1C                  /* - terminal marker 28 - */,
-/* pos 04a4: 718 */    0xE1 /* 'a' -> */,
-/* pos 04a5: 719 */    0xF4 /* 't' -> */,
-/* pos 04a6: 720 */    0xF5 /* 'u' -> */,
-/* pos 04a7: 721 */    0xF3 /* 's' -> */,
-/* pos 04a8: 722 */    0x00, 0x1D                  /* - terminal marker 29 - */,
-/* pos 04aa: 723 */    0xEF /* 'o' -> */,
-/* pos 04ab: 724 */    0xF4 /* 't' -> */,
-/* pos 04ac: 725 */    0xEF /* 'o' -> */,
-/* pos 04ad: 726 */    0xE3 /* 'c' -> */,
-/* pos 04ae: 727 */    0xEF /* 'o' -> */,
-/* pos 04af: 728 */    0xEC /* 'l' -> */,
-/* pos 04b0: 729 */    0x00, 0x4B                  /* - terminal marker 75 - */,
-/* total size 1202 bytes */
+/* pos 0134: 106 */    0x61 /* 'a' */, 0x0A, 0x00  /* (to 0x013E state 107) */,
+                       0x6F /* 'o' */, 0x21, 0x02  /* (to 0x0358 state 487) */,
+                       0x69 /* 'i' */, 0x7B, 0x03  /* (to 0x04B5 state 730) */,
+                       0x08, /* fail */
+/* pos 013e: 107 */    0xE7 /* 'g' -> */,
+/* pos 013f: 108 */    0xED /* 'm' -> */,
+/* pos 0140: 109 */    0xE1 /* 'a' -> */,
+/* pos 0141: 110 */    0xBA /* ':' -> */,
+/* pos 0142: 111 */    0x00, 0x10                  /* - terminal marker 16 - */,
+/* pos 0144: 112 */    0xE3 /* 'c' -> */,
+/* pos 0145: 113 */    0xE8 /* 'h' -> */,
+/* pos 0146: 114 */    0xE5 /* 'e' -> */,
+/* pos 0147: 115 */    0xAD /* '-' -> */,
+/* pos 0148: 116 */    0xE3 /* 'c' -> */,
+/* pos 0149: 117 */    0xEF /* 'o' -> */,
+/* pos 014a: 118 */    0xEE /* 'n' -> */,
+/* pos 014b: 119 */    0xF4 /* 't' -> */,
+/* pos 014c: 120 */    0xF2 /* 'r' -> */,
+/* pos 014d: 121 */    0xEF /* 'o' -> */,
+/* pos 014e: 122 */    0xEC /* 'l' -> */,
+/* pos 014f: 123 */    0xBA /* ':' -> */,
+/* pos 0150: 124 */    0x00, 0x11                  /* - terminal marker 17 - */,
+/* pos 0152: 125 */    0xF4 /* 't' -> */,
+/* pos 0153: 126 */    0xE8 /* 'h' -> */,
+/* pos 0154: 127 */    0xEF /* 'o' -> */,
+/* pos 0155: 128 */    0xF2 /* 'r' -> */,
+/* pos 0156: 129 */    0xE9 /* 'i' -> */,
+/* pos 0157: 130 */    0xFA /* 'z' -> */,
+/* pos 0158: 131 */    0xE1 /* 'a' -> */,
+/* pos 0159: 132 */    0xF4 /* 't' -> */,
+/* pos 015a: 133 */    0xE9 /* 'i' -> */,
+/* pos 015b: 134 */    0xEF /* 'o' -> */,
+/* pos 015c: 135 */    0xEE /* 'n' -> */,
+/* pos 015d: 136 */    0xBA /* ':' -> */,
+/* pos 015e: 137 */    0x00, 0x12                  /* - terminal marker 18 - */,
+/* pos 0160: 138 */    0xEB /* 'k' -> */,
+/* pos 0161: 139 */    0xE9 /* 'i' -> */,
+/* pos 0162: 140 */    0xE5 /* 'e' -> */,
+/* pos 0163: 141 */    0xBA /* ':' -> */,
+/* pos 0164: 142 */    0x00, 0x13                  /* - terminal marker 19 - */,
+/* pos 0166: 143 */    0xE5 /* 'e' -> */,
+/* pos 0167: 144 */    0xEE /* 'n' -> */,
+/* pos 0168: 145 */    0xF4 /* 't' -> */,
+/* pos 0169: 146 */    0xAD /* '-' -> */,
+/* pos 016a: 147 */    0x6C /* 'l' */, 0x10, 0x00  /* (to 0x017A state 148) */,
+                       0x74 /* 't' */, 0x1E, 0x00  /* (to 0x018B state 155) */,
+                       0x64 /* 'd' */, 0x4C, 0x00  /* (to 0x01BC state 186) */,
+                       0x65 /* 'e' */, 0x56, 0x00  /* (to 0x01C9 state 198) */,
+                       0x72 /* 'r' */, 0x6F, 0x00  /* (to 0x01E5 state 223) */,
+                       0x08, /* fail */
+/* pos 017a: 148 */    0x65 /* 'e' */, 0x0A, 0x00  /* (to 0x0184 state 149) */,
+                       0x61 /* 'a' */, 0x56, 0x00  /* (to 0x01D3 state 207) */,
+                       0x6F /* 'o' */, 0x5C, 0x00  /* (to 0x01DC state 215) */,
+                       0x08, /* fail */
+/* pos 0184: 149 */    0xEE /* 'n' -> */,
+/* pos 0185: 150 */    0xE7 /* 'g' -> */,
+/* pos 0186: 151 */    0xF4 /* 't' -> */,
+/* pos 0187: 152 */    0xE8 /* 'h' -> */,
+/* pos 0188: 153 */    0xBA /* ':' -> */,
+/* pos 0189: 154 */    0x00, 0x14                  /* - terminal marker 20 - */,
+/* pos 018b: 155 */    0xF9 /* 'y' -> */,
+/* pos 018c: 156 */    0xF0 /* 'p' -> */,
+/* pos 018d: 157 */    0xE5 /* 'e' -> */,
+/* pos 018e: 158 */    0xBA /* ':' -> */,
+/* pos 018f: 159 */    0x00, 0x15                  /* - terminal marker 21 - */,
+/* pos 0191: 160 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0198 state 161) */,
+                       0x65 /* 'e' */, 0x3C, 0x02  /* (to 0x03D0 state 580) */,
+                       0x08, /* fail */
+/* pos 0198: 161 */    0xF4 /* 't' -> */,
+/* pos 0199: 162 */    0xE5 /* 'e' -> */,
+/* pos 019a: 163 */    0xBA /* ':' -> */,
+/* pos 019b: 164 */    0x00, 0x16                  /* - terminal marker 22 - */,
+/* pos 019d: 165 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x01A4 state 166) */,
+                       0x65 /* 'e' */, 0xB6, 0x00  /* (to 0x0256 state 304) */,
+                       0x08, /* fail */
+/* pos 01a4: 166 */    0xEE /* 'n' -> */,
+/* pos 01a5: 167 */    0xE7 /* 'g' -> */,
+/* pos 01a6: 168 */    0xE5 /* 'e' -> */,
+/* pos 01a7: 169 */    0xBA /* ':' -> */,
+/* pos 01a8: 170 */    0x00, 0x17                  /* - terminal marker 23 - */,
+/* pos 01aa: 171 */    0xE1 /* 'a' -> */,
+/* pos 01ab: 172 */    0xEE /* 'n' -> */,
+/* pos 01ac: 173 */    0xE7 /* 'g' -> */,
+/* pos 01ad: 174 */    0xE5 /* 'e' -> */,
+/* pos 01ae: 175 */    0xF3 /* 's' -> */,
+/* pos 01af: 176 */    0xBA /* ':' -> */,
+/* pos 01b0: 177 */    0x00, 0x1F                  /* - terminal marker 31 - */,
+/* pos 01b2: 178 */    0xE5 /* 'e' -> */,
+/* pos 01b3: 179 */    0xBA /* ':' -> */,
+/* pos 01b4: 180 */    0x00, 0x21                  /* - terminal marker 33 - */,
+/* pos 01b6: 181 */    0xEC /* 'l' -> */,
+/* pos 01b7: 182 */    0xEF /* 'o' -> */,
+/* pos 01b8: 183 */    0xF7 /* 'w' -> */,
+/* pos 01b9: 184 */    0xBA /* ':' -> */,
+/* pos 01ba: 185 */    0x00, 0x22                  /* - terminal marker 34 - */,
+/* pos 01bc: 186 */    0xE9 /* 'i' -> */,
+/* pos 01bd: 187 */    0xF3 /* 's' -> */,
+/* pos 01be: 188 */    0xF0 /* 'p' -> */,
+/* pos 01bf: 189 */    0xEF /* 'o' -> */,
+/* pos 01c0: 190 */    0xF3 /* 's' -> */,
+/* pos 01c1: 191 */    0xE9 /* 'i' -> */,
+/* pos 01c2: 192 */    0xF4 /* 't' -> */,
+/* pos 01c3: 193 */    0xE9 /* 'i' -> */,
+/* pos 01c4: 194 */    0xEF /* 'o' -> */,
+/* pos 01c5: 195 */    0xEE /* 'n' -> */,
+/* pos 01c6: 196 */    0xBA /* ':' -> */,
+/* pos 01c7: 197 */    0x00, 0x23                  /* - terminal marker 35 - */,
+/* pos 01c9: 198 */    0xEE /* 'n' -> */,
+/* pos 01ca: 199 */    0xE3 /* 'c' -> */,
+/* pos 01cb: 200 */    0xEF /* 'o' -> */,
+/* pos 01cc: 201 */    0xE4 /* 'd' -> */,
+/* pos 01cd: 202 */    0xE9 /* 'i' -> */,
+/* pos 01ce: 203 */    0xEE /* 'n' -> */,
+/* pos 01cf: 204 */    0xE7 /* 'g' -> */,
+/* pos 01d0: 205 */    0xBA /* ':' -> */,
+/* pos 01d1: 206 */    0x00, 0x24                  /* - terminal marker 36 - */,
+/* pos 01d3: 207 */    0xEE /* 'n' -> */,
+/* pos 01d4: 208 */    0xE7 /* 'g' -> */,
+/* pos 01d5: 209 */    0xF5 /* 'u' -> */,
+/* pos 01d6: 210 */    0xE1 /* 'a' -> */,
+/* pos 01d7: 211 */    0xE7 /* 'g' -> */,
+/* pos 01d8: 212 */    0xE5 /* 'e' -> */,
+/* pos 01d9: 213 */    0xBA /* ':' -> */,
+/* pos 01da: 214 */    0x00, 0x25                  /* - terminal marker 37 - */,
+/* pos 01dc: 215 */    0xE3 /* 'c' -> */,
+/* pos 01dd: 216 */    0xE1 /* 'a' -> */,
+/* pos 01de: 217 */    0xF4 /* 't' -> */,
+/* pos 01df: 218 */    0xE9 /* 'i' -> */,
+/* pos 01e0: 219 */    0xEF /* 'o' -> */,
+/* pos 01e1: 220 */    0xEE /* 'n' -> */,
+/* pos 01e2: 221 */    0xBA /* ':' -> */,
+/* pos 01e3: 222 */    0x00, 0x26                  /* - terminal marker 38 - */,
+/* pos 01e5: 223 */    0xE1 /* 'a' -> */,
+/* pos 01e6: 224 */    0xEE /* 'n' -> */,
+/* pos 01e7: 225 */    0xE7 /* 'g' -> */,
+/* pos 01e8: 226 */    0xE5 /* 'e' -> */,
+/* pos 01e9: 227 */    0xBA /* ':' -> */,
+/* pos 01ea: 228 */    0x00, 0x27                  /* - terminal marker 39 - */,
+/* pos 01ec: 229 */    0x74 /* 't' */, 0x07, 0x00  /* (to 0x01F3 state 230) */,
+                       0x78 /* 'x' */, 0x09, 0x00  /* (to 0x01F8 state 234) */,
+                       0x08, /* fail */
+/* pos 01f3: 230 */    0xE1 /* 'a' -> */,
+/* pos 01f4: 231 */    0xE7 /* 'g' -> */,
+/* pos 01f5: 232 */    0xBA /* ':' -> */,
+/* pos 01f6: 233 */    0x00, 0x28                  /* - terminal marker 40 - */,
+/* pos 01f8: 234 */    0xF0 /* 'p' -> */,
+/* pos 01f9: 235 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x0200 state 236) */,
+                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x0205 state 240) */,
+                       0x08, /* fail */
+/* pos 0200: 236 */    0xE3 /* 'c' -> */,
+/* pos 0201: 237 */    0xF4 /* 't' -> */,
+/* pos 0202: 238 */    0xBA /* ':' -> */,
+/* pos 0203: 239 */    0x00, 0x29                  /* - terminal marker 41 - */,
+/* pos 0205: 240 */    0xF2 /* 'r' -> */,
+/* pos 0206: 241 */    0xE5 /* 'e' -> */,
+/* pos 0207: 242 */    0xF3 /* 's' -> */,
+/* pos 0208: 243 */    0xBA /* ':' -> */,
+/* pos 0209: 244 */    0x00, 0x2A                  /* - terminal marker 42 - */,
+/* pos 020b: 245 */    0xF2 /* 'r' -> */,
+/* pos 020c: 246 */    0xEF /* 'o' -> */,
+/* pos 020d: 247 */    0xED /* 'm' -> */,
+/* pos 020e: 248 */    0xBA /* ':' -> */,
+/* pos 020f: 249 */    0x00, 0x2B                  /* - terminal marker 43 - */,
+/* pos 0211: 250 */    0xF4 /* 't' -> */,
+/* pos 0212: 251 */    0xE3 /* 'c' -> */,
+/* pos 0213: 252 */    0xE8 /* 'h' -> */,
+/* pos 0214: 253 */    0xBA /* ':' -> */,
+/* pos 0215: 254 */    0x00, 0x2C                  /* - terminal marker 44 - */,
+/* pos 0217: 255 */    0xE1 /* 'a' -> */,
+/* pos 0218: 256 */    0xEE /* 'n' -> */,
+/* pos 0219: 257 */    0xE7 /* 'g' -> */,
+/* pos 021a: 258 */    0xE5 /* 'e' -> */,
+/* pos 021b: 259 */    0xBA /* ':' -> */,
+/* pos 021c: 260 */    0x00, 0x2D                  /* - terminal marker 45 - */,
+/* pos 021e: 261 */    0xEE /* 'n' -> */,
+/* pos 021f: 262 */    0xED /* 'm' -> */,
+/* pos 0220: 263 */    0xEF /* 'o' -> */,
+/* pos 0221: 264 */    0xE4 /* 'd' -> */,
+/* pos 0222: 265 */    0xE9 /* 'i' -> */,
+/* pos 0223: 266 */    0xE6 /* 'f' -> */,
+/* pos 0224: 267 */    0xE9 /* 'i' -> */,
+/* pos 0225: 268 */    0xE5 /* 'e' -> */,
+/* pos 0226: 269 */    0xE4 /* 'd' -> */,
+/* pos 0227: 270 */    0xAD /* '-' -> */,
+/* pos 0228: 271 */    0xF3 /* 's' -> */,
+/* pos 0229: 272 */    0xE9 /* 'i' -> */,
+/* pos 022a: 273 */    0xEE /* 'n' -> */,
+/* pos 022b: 274 */    0xE3 /* 'c' -> */,
+/* pos 022c: 275 */    0xE5 /* 'e' -> */,
+/* pos 022d: 276 */    0xBA /* ':' -> */,
+/* pos 022e: 277 */    0x00, 0x2E                  /* - terminal marker 46 - */,
+/* pos 0230: 278 */    0x61 /* 'a' */, 0x0A, 0x00  /* (to 0x023A state 279) */,
+                       0x69 /* 'i' */, 0x15, 0x00  /* (to 0x0248 state 292) */,
+                       0x6F /* 'o' */, 0x17, 0x00  /* (to 0x024D state 296) */,
+                       0x08, /* fail */
+/* pos 023a: 279 */    0xF3 /* 's' -> */,
+/* pos 023b: 280 */    0xF4 /* 't' -> */,
+/* pos 023c: 281 */    0xAD /* '-' -> */,
+/* pos 023d: 282 */    0xED /* 'm' -> */,
+/* pos 023e: 283 */    0xEF /* 'o' -> */,
+/* pos 023f: 284 */    0xE4 /* 'd' -> */,
+/* pos 0240: 285 */    0xE9 /* 'i' -> */,
+/* pos 0241: 286 */    0xE6 /* 'f' -> */,
+/* pos 0242: 287 */    0xE9 /* 'i' -> */,
+/* pos 0243: 288 */    0xE5 /* 'e' -> */,
+/* pos 0244: 289 */    0xE4 /* 'd' -> */,
+/* pos 0245: 290 */    0xBA /* ':' -> */,
+/* pos 0246: 291 */    0x00, 0x2F                  /* - terminal marker 47 - */,
+/* pos 0248: 292 */    0xEE /* 'n' -> */,
+/* pos 0249: 293 */    0xEB /* 'k' -> */,
+/* pos 024a: 294 */    0xBA /* ':' -> */,
+/* pos 024b: 295 */    0x00, 0x30                  /* - terminal marker 48 - */,
+/* pos 024d: 296 */    0xE3 /* 'c' -> */,
+/* pos 024e: 297 */    0xE1 /* 'a' -> */,
+/* pos 024f: 298 */    0xF4 /* 't' -> */,
+/* pos 0250: 299 */    0xE9 /* 'i' -> */,
+/* pos 0251: 300 */    0xEF /* 'o' -> */,
+/* pos 0252: 301 */    0xEE /* 'n' -> */,
+/* pos 0253: 302 */    0xBA /* ':' -> */,
+/* pos 0254: 303 */    0x00, 0x31                  /* - terminal marker 49 - */,
+/* pos 0256: 304 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x0260 state 305) */,
+                       0x74 /* 't' */, 0x14, 0x00  /* (to 0x026D state 311) */,
+                       0x70 /* 'p' */, 0x88, 0x01  /* (to 0x03E4 state 596) */,
+                       0x08, /* fail */
+/* pos 0260: 305 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x0267 state 306) */,
+                       0x65 /* 'e' */, 0xCA, 0x00  /* (to 0x032D state 448) */,
+                       0x08, /* fail */
+/* pos 0267: 306 */    0xE5 /* 'e' -> */,
+/* pos 0268: 307 */    0xF3 /* 's' -> */,
+/* pos 0269: 308 */    0xE8 /* 'h' -> */,
+/* pos 026a: 309 */    0xBA /* ':' -> */,
+/* pos 026b: 310 */    0x00, 0x35                  /* - terminal marker 53 - */,
+/* pos 026d: 311 */    0xF2 /* 'r' -> */,
+/* pos 026e: 312 */    0xF9 /* 'y' -> */,
+/* pos 026f: 313 */    0xAD /* '-' -> */,
+/* pos 0270: 314 */    0xE1 /* 'a' -> */,
+/* pos 0271: 315 */    0xE6 /* 'f' -> */,
+/* pos 0272: 316 */    0xF4 /* 't' -> */,
+/* pos 0273: 317 */    0xE5 /* 'e' -> */,
+/* pos 0274: 318 */    0xF2 /* 'r' -> */,
+/* pos 0275: 319 */    0xBA /* ':' -> */,
+/* pos 0276: 320 */    0x00, 0x36                  /* - terminal marker 54 - */,
+/* pos 0278: 321 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x027F state 322) */,
+                       0x74 /* 't' */, 0x06, 0x01  /* (to 0x0381 state 514) */,
+                       0x08, /* fail */
+/* pos 027f: 322 */    0x72 /* 'r' */, 0x0A, 0x00  /* (to 0x0289 state 323) */,
+                       0x74 /* 't' */, 0x0D, 0x00  /* (to 0x028F state 328) */,
+                       0x63 /* 'c' */, 0x6B, 0x01  /* (to 0x03F0 state 607) */,
+                       0x08, /* fail */
+/* pos 0289: 323 */    0xF6 /* 'v' -> */,
+/* pos 028a: 324 */    0xE5 /* 'e' -> */,
+/* pos 028b: 325 */    0xF2 /* 'r' -> */,
+/* pos 028c: 326 */    0xBA /* ':' -> */,
+/* pos 028d: 327 */    0x00, 0x37                  /* - terminal marker 55 - */,
+/* pos 028f: 328 */    0xAD /* '-' -> */,
+/* pos 0290: 329 */    0xE3 /* 'c' -> */,
+/* pos 0291: 330 */    0xEF /* 'o' -> */,
+/* pos 0292: 331 */    0xEF /* 'o' -> */,
+/* pos 0293: 332 */    0xEB /* 'k' -> */,
+/* pos 0294: 333 */    0xE9 /* 'i' -> */,
+/* pos 0295: 334 */    0xE5 /* 'e' -> */,
+/* pos 0296: 335 */    0xBA /* ':' -> */,
+/* pos 0297: 336 */    0x00, 0x38                  /* - terminal marker 56 - */,
+/* pos 0299: 337 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x02A0 state 338) */,
+                       0x65 /* 'e' */, 0x45, 0x01  /* (to 0x03E1 state 594) */,
+                       0x08, /* fail */
+/* pos 02a0: 338 */    0xE1 /* 'a' -> */,
+/* pos 02a1: 339 */    0xEE /* 'n' -> */,
+/* pos 02a2: 340 */    0xF3 /* 's' -> */,
+/* pos 02a3: 341 */    0xE6 /* 'f' -> */,
+/* pos 02a4: 342 */    0xE5 /* 'e' -> */,
+/* pos 02a5: 343 */    0xF2 /* 'r' -> */,
+/* pos 02a6: 344 */    0xAD /* '-' -> */,
+/* pos 02a7: 345 */    0xE5 /* 'e' -> */,
+/* pos 02a8: 346 */    0xEE /* 'n' -> */,
+/* pos 02a9: 347 */    0xE3 /* 'c' -> */,
+/* pos 02aa: 348 */    0xEF /* 'o' -> */,
+/* pos 02ab: 349 */    0xE4 /* 'd' -> */,
+/* pos 02ac: 350 */    0xE9 /* 'i' -> */,
+/* pos 02ad: 351 */    0xEE /* 'n' -> */,
+/* pos 02ae: 352 */    0xE7 /* 'g' -> */,
+/* pos 02af: 353 */    0xBA /* ':' -> */,
+/* pos 02b0: 354 */    0x00, 0x3A                  /* - terminal marker 58 - */,
+/* pos 02b2: 355 */    0xE9 /* 'i' -> */,
+/* pos 02b3: 356 */    0xAD /* '-' -> */,
+/* pos 02b4: 357 */    0xE1 /* 'a' -> */,
+/* pos 02b5: 358 */    0xF2 /* 'r' -> */,
+/* pos 02b6: 359 */    0xE7 /* 'g' -> */,
+/* pos 02b7: 360 */    0xF3 /* 's' -> */,
+/* pos 02b8: 361 */    0x00, 0x42                  /* - terminal marker 66 - */,
+/* pos 02ba: 362 */    0xA0 /* ' ' -> */,
+/* pos 02bb: 363 */    0x00, 0x45                  /* - terminal marker 69 - */,
+/* pos 02bd: 364 */    0xAD /* '-' -> */,
+/* pos 02be: 365 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x02C8 state 366) */,
+                       0x61 /* 'a' */, 0x1D, 0x00  /* (to 0x02DE state 385) */,
+                       0x72 /* 'r' */, 0x14, 0x01  /* (to 0x03D8 state 586) */,
+                       0x08, /* fail */
+/* pos 02c8: 366 */    0xEF /* 'o' -> */,
+/* pos 02c9: 367 */    0xF2 /* 'r' -> */,
+/* pos 02ca: 368 */    0xF7 /* 'w' -> */,
+/* pos 02cb: 369 */    0xE1 /* 'a' -> */,
+/* pos 02cc: 370 */    0xF2 /* 'r' -> */,
+/* pos 02cd: 371 */    0xE4 /* 'd' -> */,
+/* pos 02ce: 372 */    0xE5 /* 'e' -> */,
+/* pos 02cf: 373 */    0xE4 /* 'd' -> */,
+/* pos 02d0: 374 */    0xAD /* '-' -> */,
+/* pos 02d1: 375 */    0xE6 /* 'f' -> */,
+/* pos 02d2: 376 */    0xEF /* 'o' -> */,
+/* pos 02d3: 377 */    0xF2 /* 'r' -> */,
+/* pos 02d4: 378 */    0xBA /* ':' -> */,
+/* pos 02d5: 379 */    0x00, 0x46                  /* - terminal marker 70 - */,
+/* pos 02d7: 380 */    0x00, 0x47                  /* - terminal marker 71 - */,
+/* pos 02d9: 381 */    0xE1 /* 'a' -> */,
+/* pos 02da: 382 */    0xE4 /* 'd' -> */,
+/* pos 02db: 383 */    0xA0 /* ' ' -> */,
+/* pos 02dc: 384 */    0x00, 0x48                  /* - terminal marker 72 - */,
+/* pos 02de: 385 */    0x75 /* 'u' */, 0x07, 0x00  /* (to 0x02E5 state 386) */,
+                       0x6D /* 'm' */, 0x0F, 0x00  /* (to 0x02F0 state 396) */,
+                       0x08, /* fail */
+/* pos 02e5: 386 */    0xF4 /* 't' -> */,
+/* pos 02e6: 387 */    0xE8 /* 'h' -> */,
+/* pos 02e7: 388 */    0xAD /* '-' -> */,
+/* pos 02e8: 389 */    0xF4 /* 't' -> */,
+/* pos 02e9: 390 */    0xEF /* 'o' -> */,
+/* pos 02ea: 391 */    0xEB /* 'k' -> */,
+/* pos 02eb: 392 */    0xE5 /* 'e' -> */,
+/* pos 02ec: 393 */    0xEE /* 'n' -> */,
+/* pos 02ed: 394 */    0xBA /* ':' -> */,
+/* pos 02ee: 395 */    0x00, 0x4C                  /* - terminal marker 76 - */,
+/* pos 02f0: 396 */    0xFA /* 'z' -> */,
+/* pos 02f1: 397 */    0xEE /* 'n' -> */,
+/* pos 02f2: 398 */    0xAD /* '-' -> */,
+/* pos 02f3: 399 */    0xE4 /* 'd' -> */,
+/* pos 02f4: 400 */    0xF3 /* 's' -> */,
+/* pos 02f5: 401 */    0xF3 /* 's' -> */,
+/* pos 02f6: 402 */    0xAD /* '-' -> */,
+/* pos 02f7: 403 */    0xF3 /* 's' -> */,
+/* pos 02f8: 404 */    0xE9 /* 'i' -> */,
+/* pos 02f9: 405 */    0xE7 /* 'g' -> */,
+/* pos 02fa: 406 */    0xEE /* 'n' -> */,
+/* pos 02fb: 407 */    0xE1 /* 'a' -> */,
+/* pos 02fc: 408 */    0xF4 /* 't' -> */,
+/* pos 02fd: 409 */    0xF5 /* 'u' -> */,
+/* pos 02fe: 410 */    0xF2 /* 'r' -> */,
+/* pos 02ff: 411 */    0xE5 /* 'e' -> */,
+/* pos 0300: 412 */    0xBA /* ':' -> */,
+/* pos 0301: 413 */    0x00, 0x4D                  /* - terminal marker 77 - */,
+/* pos 0303: 414 */    0xF4 /* 't' -> */,
+/* pos 0304: 415 */    0xE9 /* 'i' -> */,
+/* pos 0305: 416 */    0xEF /* 'o' -> */,
+/* pos 0306: 417 */    0xEE /* 'n' -> */,
+/* pos 0307: 418 */    0xF3 /* 's' -> */,
+/* pos 0308: 419 */    0xA0 /* ' ' -> */,
+/* pos 0309: 420 */    0x00, 0x02                  /* - terminal marker  2 - */,
+/* pos 030b: 421 */    0xF3 /* 's' -> */,
+/* pos 030c: 422 */    0xAD /* '-' -> */,
+/* pos 030d: 423 */    0xE3 /* 'c' -> */,
+/* pos 030e: 424 */    0xEF /* 'o' -> */,
+/* pos 030f: 425 */    0xEE /* 'n' -> */,
+/* pos 0310: 426 */    0xF4 /* 't' -> */,
+/* pos 0311: 427 */    0xF2 /* 'r' -> */,
+/* pos 0312: 428 */    0xEF /* 'o' -> */,
+/* pos 0313: 429 */    0xEC /* 'l' -> */,
+/* pos 0314: 430 */    0xAD /* '-' -> */,
+/* pos 0315: 431 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x031C state 432) */,
+                       0x61 /* 'a' */, 0x24, 0x00  /* (to 0x033C state 461) */,
+                       0x08, /* fail */
+/* pos 031c: 432 */    0xE5 /* 'e' -> */,
+/* pos 031d: 433 */    0xF1 /* 'q' -> */,
+/* pos 031e: 434 */    0xF5 /* 'u' -> */,
+/* pos 031f: 435 */    0xE5 /* 'e' -> */,
+/* pos 0320: 436 */    0xF3 /* 's' -> */,
+/* pos 0321: 437 */    0xF4 /* 't' -> */,
+/* pos 0322: 438 */    0xAD /* '-' -> */,
+/* pos 0323: 439 */    0xE8 /* 'h' -> */,
+/* pos 0324: 440 */    0xE5 /* 'e' -> */,
+/* pos 0325: 441 */    0xE1 /* 'a' -> */,
+/* pos 0326: 442 */    0xE4 /* 'd' -> */,
+/* pos 0327: 443 */    0xE5 /* 'e' -> */,
+/* pos 0328: 444 */    0xF2 /* 'r' -> */,
+/* pos 0329: 445 */    0xF3 /* 's' -> */,
+/* pos 032a: 446 */    0xBA /* ':' -> */,
+/* pos 032b: 447 */    0x00, 0x0B                  /* - terminal marker 11 - */,
+/* pos 032d: 448 */    0xF2 /* 'r' -> */,
+/* pos 032e: 449 */    0xE5 /* 'e' -> */,
+/* pos 032f: 450 */    0xF2 /* 'r' -> */,
+/* pos 0330: 451 */    0xBA /* ':' -> */,
+/* pos 0331: 452 */    0x00, 0x18                  /* - terminal marker 24 - */,
+/* pos 0333: 453 */    0xE8 /* 'h' -> */,
+/* pos 0334: 454 */    0xE1 /* 'a' -> */,
+/* pos 0335: 455 */    0xF2 /* 'r' -> */,
+/* pos 0336: 456 */    0xF3 /* 's' -> */,
+/* pos 0337: 457 */    0xE5 /* 'e' -> */,
+/* pos 0338: 458 */    0xF4 /* 't' -> */,
+/* pos 0339: 459 */    0xBA /* ':' -> */,
+/* pos 033a: 460 */    0x00, 0x1E                  /* - terminal marker 30 - */,
+/* pos 033c: 461 */    0xEC /* 'l' -> */,
+/* pos 033d: 462 */    0xEC /* 'l' -> */,
+/* pos 033e: 463 */    0xEF /* 'o' -> */,
+/* pos 033f: 464 */    0xF7 /* 'w' -> */,
+/* pos 0340: 465 */    0xAD /* '-' -> */,
+/* pos 0341: 466 */    0xEF /* 'o' -> */,
+/* pos 0342: 467 */    0xF2 /* 'r' -> */,
+/* pos 0343: 468 */    0xE9 /* 'i' -> */,
+/* pos 0344: 469 */    0xE7 /* 'g' -> */,
+/* pos 0345: 470 */    0xE9 /* 'i' -> */,
+/* pos 0346: 471 */    0xEE /* 'n' -> */,
+/* pos 0347: 472 */    0xBA /* ':' -> */,
+/* pos 0348: 473 */    0x00, 0x20                  /* - terminal marker 32 - */,
+/* pos 034a: 474 */    0xE1 /* 'a' -> */,
+/* pos 034b: 475 */    0xF8 /* 'x' -> */,
+/* pos 034c: 476 */    0xAD /* '-' -> */,
+/* pos 034d: 477 */    0xE6 /* 'f' -> */,
+/* pos 034e: 478 */    0xEF /* 'o' -> */,
+/* pos 034f: 479 */    0xF2 /* 'r' -> */,
+/* pos 0350: 480 */    0xF7 /* 'w' -> */,
+/* pos 0351: 481 */    0xE1 /* 'a' -> */,
+/* pos 0352: 482 */    0xF2 /* 'r' -> */,
+/* pos 0353: 483 */    0xE4 /* 'd' -> */,
+/* pos 0354: 484 */    0xF3 /* 's' -> */,
+/* pos 0355: 485 */    0xBA /* ':' -> */,
+/* pos 0356: 486 */    0x00, 0x32                  /* - terminal marker 50 - */,
+/* pos 0358: 487 */    0xF8 /* 'x' -> */,
+/* pos 0359: 488 */    0xF9 /* 'y' -> */,
+/* pos 035a: 489 */    0x2D /* '-' */, 0x07, 0x00  /* (to 0x0361 state 490) */,
+                       0x20 /* ' ' */, 0x79, 0x00  /* (to 0x03D6 state 585) */,
+                       0x08, /* fail */
+/* pos 0361: 490 */    0xE1 /* 'a' -> */,
+/* pos 0362: 491 */    0xF5 /* 'u' -> */,
+/* pos 0363: 492 */    0xF4 /* 't' -> */,
+/* pos 0364: 493 */    0xE8 /* 'h' -> */,
+/* pos 0365: 494 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x036C state 495) */,
+                       0x6F /* 'o' */, 0x0E, 0x00  /* (to 0x0376 state 504) */,
+                       0x08, /* fail */
+/* pos 036c: 495 */    0xEE /* 'n' -> */,
+/* pos 036d: 496 */    0xF4 /* 't' -> */,
+/* pos 036e: 497 */    0xE9 /* 'i' -> */,
+/* pos 036f: 498 */    0xE3 /* 'c' -> */,
+/* pos 0370: 499 */    0xE1 /* 'a' -> */,
+/* pos 0371: 500 */    0xF4 /* 't' -> */,
+/* pos 0372: 501 */    0xE5 /* 'e' -> */,
+/* pos 0373: 502 */    0xBA /* ':' -> */,
+/* pos 0374: 503 */    0x00, 0x33                  /* - terminal marker 51 - */,
+/* pos 0376: 504 */    0xF2 /* 'r' -> */,
+/* pos 0377: 505 */    0xE9 /* 'i' -> */,
+/* pos 0378: 506 */    0xFA /* 'z' -> */,
+/* pos 0379: 507 */    0xE1 /* 'a' -> */,
+/* pos 037a: 508 */    0xF4 /* 't' -> */,
+/* pos 037b: 509 */    0xE9 /* 'i' -> */,
+/* pos 037c: 510 */    0xEF /* 'o' -> */,
+/* pos 037d: 511 */    0xEE /* 'n' -> */,
+/* pos 037e: 512 */    0xBA /* ':' -> */,
+/* pos 037f: 513 */    0x00, 0x34                  /* - terminal marker 52 - */,
+/* pos 0381: 514 */    0xF2 /* 'r' -> */,
+/* pos 0382: 515 */    0xE9 /* 'i' -> */,
+/* pos 0383: 516 */    0xE3 /* 'c' -> */,
+/* pos 0384: 517 */    0xF4 /* 't' -> */,
+/* pos 0385: 518 */    0xAD /* '-' -> */,
+/* pos 0386: 519 */    0xF4 /* 't' -> */,
+/* pos 0387: 520 */    0xF2 /* 'r' -> */,
+/* pos 0388: 521 */    0xE1 /* 'a' -> */,
+/* pos 0389: 522 */    0xEE /* 'n' -> */,
+/* pos 038a: 523 */    0xF3 /* 's' -> */,
+/* pos 038b: 524 */    0xF0 /* 'p' -> */,
+/* pos 038c: 525 */    0xEF /* 'o' -> */,
+/* pos 038d: 526 */    0xF2 /* 'r' -> */,
+/* pos 038e: 527 */    0xF4 /* 't' -> */,
+/* pos 038f: 528 */    0xAD /* '-' -> */,
+/* pos 0390: 529 */    0xF3 /* 's' -> */,
+/* pos 0391: 530 */    0xE5 /* 'e' -> */,
+/* pos 0392: 531 */    0xE3 /* 'c' -> */,
+/* pos 0393: 532 */    0xF5 /* 'u' -> */,
+/* pos 0394: 533 */    0xF2 /* 'r' -> */,
+/* pos 0395: 534 */    0xE9 /* 'i' -> */,
+/* pos 0396: 535 */    0xF4 /* 't' -> */,
+/* pos 0397: 536 */    0xF9 /* 'y' -> */,
+/* pos 0398: 537 */    0xBA /* ':' -> */,
+/* pos 0399: 538 */    0x00, 0x39                  /* - terminal marker 57 - */,
+/* pos 039b: 539 */    0xE5 /* 'e' -> */,
+/* pos 039c: 540 */    0xF2 /* 'r' -> */,
+/* pos 039d: 541 */    0xAD /* '-' -> */,
+/* pos 039e: 542 */    0xE1 /* 'a' -> */,
+/* pos 039f: 543 */    0xE7 /* 'g' -> */,
+/* pos 03a0: 544 */    0xE5 /* 'e' -> */,
+/* pos 03a1: 545 */    0xEE /* 'n' -> */,
+/* pos 03a2: 546 */    0xF4 /* 't' -> */,
+/* pos 03a3: 547 */    0xBA /* ':' -> */,
+/* pos 03a4: 548 */    0x00, 0x3B                  /* - terminal marker 59 - */,
+/* pos 03a6: 549 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x03AD state 550) */,
+                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x03B2 state 554) */,
+                       0x08, /* fail */
+/* pos 03ad: 550 */    0xF2 /* 'r' -> */,
+/* pos 03ae: 551 */    0xF9 /* 'y' -> */,
+/* pos 03af: 552 */    0xBA /* ':' -> */,
+/* pos 03b0: 553 */    0x00, 0x3C                  /* - terminal marker 60 - */,
+/* pos 03b2: 554 */    0xE1 /* 'a' -> */,
+/* pos 03b3: 555 */    0xBA /* ':' -> */,
+/* pos 03b4: 556 */    0x00, 0x3D                  /* - terminal marker 61 - */,
+/* pos 03b6: 557 */    0xF7 /* 'w' -> */,
+/* pos 03b7: 558 */    0xF7 /* 'w' -> */,
+/* pos 03b8: 559 */    0xAD /* '-' -> */,
+/* pos 03b9: 560 */    0xE1 /* 'a' -> */,
+/* pos 03ba: 561 */    0xF5 /* 'u' -> */,
+/* pos 03bb: 562 */    0xF4 /* 't' -> */,
+/* pos 03bc: 563 */    0xE8 /* 'h' -> */,
+/* pos 03bd: 564 */    0xE5 /* 'e' -> */,
+/* pos 03be: 565 */    0xEE /* 'n' -> */,
+/* pos 03bf: 566 */    0xF4 /* 't' -> */,
+/* pos 03c0: 567 */    0xE9 /* 'i' -> */,
+/* pos 03c1: 568 */    0xE3 /* 'c' -> */,
+/* pos 03c2: 569 */    0xE1 /* 'a' -> */,
+/* pos 03c3: 570 */    0xF4 /* 't' -> */,
+/* pos 03c4: 571 */    0xE5 /* 'e' -> */,
+/* pos 03c5: 572 */    0xBA /* ':' -> */,
+/* pos 03c6: 573 */    0x00, 0x3E                  /* - terminal marker 62 - */,
+/* pos 03c8: 574 */    0xF4 /* 't' -> */,
+/* pos 03c9: 575 */    0xE3 /* 'c' -> */,
+/* pos 03ca: 576 */    0xE8 /* 'h' -> */,
+/* pos 03cb: 577 */    0x00, 0x3F                  /* - terminal marker 63 - */,
+/* pos 03cd: 578 */    0xF4 /* 't' -> */,
+/* pos 03ce: 579 */    0x00, 0x40                  /* - terminal marker 64 - */,
+/* pos 03d0: 580 */    0xEC /* 'l' -> */,
+/* pos 03d1: 581 */    0xE5 /* 'e' -> */,
+/* pos 03d2: 582 */    0xF4 /* 't' -> */,
+/* pos 03d3: 583 */    0xE5 /* 'e' -> */,
+/* pos 03d4: 584 */    0x00, 0x41                  /* - terminal marker 65 - */,
+/* pos 03d6: 585 */    0x00, 0x43                  /* - terminal marker 67 - */,
+/* pos 03d8: 586 */    0xE5 /* 'e' -> */,
+/* pos 03d9: 587 */    0xE1 /* 'a' -> */,
+/* pos 03da: 588 */    0xEC /* 'l' -> */,
+/* pos 03db: 589 */    0xAD /* '-' -> */,
+/* pos 03dc: 590 */    0xE9 /* 'i' -> */,
+/* pos 03dd: 591 */    0xF0 /* 'p' -> */,
+/* pos 03de: 592 */    0xBA /* ':' -> */,
+/* pos 03df: 593 */    0x00, 0x44                  /* - terminal marker 68 - */,
+/* pos 03e1: 594 */    0xBA /* ':' -> */,
+/* pos 03e2: 595 */    0x00, 0x49                  /* - terminal marker 73 - */,
+/* pos 03e4: 596 */    0xEC /* 'l' -> */,
+/* pos 03e5: 597 */    0xE1 /* 'a' -> */,
+/* pos 03e6: 598 */    0xF9 /* 'y' -> */,
+/* pos 03e7: 599 */    0xAD /* '-' -> */,
+/* pos 03e8: 600 */    0xEE /* 'n' -> */,
+/* pos 03e9: 601 */    0xEF /* 'o' -> */,
+/* pos 03ea: 602 */    0xEE /* 'n' -> */,
+/* pos 03eb: 603 */    0xE3 /* 'c' -> */,
+/* pos 03ec: 604 */    0xE5 /* 'e' -> */,
+/* pos 03ed: 605 */    0xBA /* ':' -> */,
+/* pos 03ee: 606 */    0x00, 0x4A                  /* - terminal marker 74 - */,
+/* pos 03f0: 607 */    0xAD /* '-' -> */,
+/* pos 03f1: 608 */    0xF7 /* 'w' -> */,
+/* pos 03f2: 609 */    0xE5 /* 'e' -> */,
+/* pos 03f3: 610 */    0xE2 /* 'b' -> */,
+/* pos 03f4: 611 */    0xF3 /* 's' -> */,
+/* pos 03f5: 612 */    0xEF /* 'o' -> */,
+/* pos 03f6: 613 */    0xE3 /* 'c' -> */,
+/* pos 03f7: 614 */    0xEB /* 'k' -> */,
+/* pos 03f8: 615 */    0xE5 /* 'e' -> */,
+/* pos 03f9: 616 */    0xF4 /* 't' -> */,
+/* pos 03fa: 617 */    0xAD /* '-' -> */,
+/* pos 03fb: 618 */    0x64 /* 'd' */, 0x19, 0x00  /* (to 0x0414 state 619) */,
+                       0x65 /* 'e' */, 0x1D, 0x00  /* (to 0x041B state 625) */,
+                       0x6B /* 'k' */, 0x26, 0x00  /* (to 0x0427 state 636) */,
+                       0x70 /* 'p' */, 0x35, 0x00  /* (to 0x0439 state 643) */,
+                       0x61 /* 'a' */, 0x3C, 0x00  /* (to 0x0443 state 652) */,
+                       0x6E /* 'n' */, 0x41, 0x00  /* (to 0x044B state 659) */,
+                       0x76 /* 'v' */, 0x47, 0x00  /* (to 0x0454 state 666) */,
+                       0x6F /* 'o' */, 0x4D, 0x00  /* (to 0x045D state 674) */,
+                       0x08, /* fail */
+/* pos 0414: 619 */    0xF2 /* 'r' -> */,
+/* pos 0415: 620 */    0xE1 /* 'a' -> */,
+/* pos 0416: 621 */    0xE6 /* 'f' -> */,
+/* pos 0417: 622 */    0xF4 /* 't' -> */,
+/* pos 0418: 623 */    0xBA /* ':' -> */,
+/* pos 0419: 624 */    0x00, 0x07                  /* - terminal marker  7 - */,
+/* pos 041b: 625 */    0xF8 /* 'x' -> */,
+/* pos 041c: 626 */    0xF4 /* 't' -> */,
+/* pos 041d: 627 */    0xE5 /* 'e' -> */,
+/* pos 041e: 628 */    0xEE /* 'n' -> */,
+/* pos 041f: 629 */    0xF3 /* 's' -> */,
+/* pos 0420: 630 */    0xE9 /* 'i' -> */,
+/* pos 0421: 631 */    0xEF /* 'o' -> */,
+/* pos 0422: 632 */    0xEE /* 'n' -> */,
+/* pos 0423: 633 */    0xF3 /* 's' -> */,
+/* pos 0424: 634 */    0xBA /* ':' -> */,
+/* pos 0425: 635 */    0x00, 0x09                  /* - terminal marker  9 - */,
+/* pos 0427: 636 */    0xE5 /* 'e' -> */,
+/* pos 0428: 637 */    0xF9 /* 'y' -> */,
+/* pos 0429: 638 */    0x31 /* '1' */, 0x0A, 0x00  /* (to 0x0433 state 639) */,
+                       0x32 /* '2' */, 0x0A, 0x00  /* (to 0x0436 state 641) */,
+                       0x3A /* ':' */, 0x23, 0x00  /* (to 0x0452 state 665) */,
+                       0x08, /* fail */
+/* pos 0433: 639 */    0xBA /* ':' -> */,
+/* pos 0434: 640 */    0x00, 0x0A                  /* - terminal marker 10 - */,
+/* pos 0436: 641 */    0xBA /* ':' -> */,
+/* pos 0437: 642 */    0x00, 0x0B                  /* - terminal marker 11 - */,
+/* pos 0439: 643 */    0xF2 /* 'r' -> */,
+/* pos 043a: 644 */    0xEF /* 'o' -> */,
+/* pos 043b: 645 */    0xF4 /* 't' -> */,
+/* pos 043c: 646 */    0xEF /* 'o' -> */,
+/* pos 043d: 647 */    0xE3 /* 'c' -> */,
+/* pos 043e: 648 */    0xEF /* 'o' -> */,
+/* pos 043f: 649 */    0xEC /* 'l' -> */,
+/* pos 0440: 650 */    0xBA /* ':' -> */,
+/* pos 0441: 651 */    0x00, 0x0C                  /* - terminal marker 12 - */,
+/* pos 0443: 652 */    0xE3 /* 'c' -> */,
+/* pos 0444: 653 */    0xE3 /* 'c' -> */,
+/* pos 0445: 654 */    0xE5 /* 'e' -> */,
+/* pos 0446: 655 */    0xF0 /* 'p' -> */,
+/* pos 0447: 656 */    0xF4 /* 't' -> */,
+/* pos 0448: 657 */    0xBA /* ':' -> */,
+/* pos 0449: 658 */    0x00, 0x0D                  /* - terminal marker 13 - */,
+/* pos 044b: 659 */    0xEF /* 'o' -> */,
+/* pos 044c: 660 */    0xEE /* 'n' -> */,
+/* pos 044d: 661 */    0xE3 /* 'c' -> */,
+/* pos 044e: 662 */    0xE5 /* 'e' -> */,
+/* pos 044f: 663 */    0xBA /* ':' -> */,
+/* pos 0450: 664 */    0x00, 0x0E                  /* - terminal marker 14 - */,
+/* pos 0452: 665 */    0x00, 0x1F                  /* - terminal marker 31 - */,
+/* pos 0454: 666 */    0xE5 /* 'e' -> */,
+/* pos 0455: 667 */    0xF2 /* 'r' -> */,
+/* pos 0456: 668 */    0xF3 /* 's' -> */,
+/* pos 0457: 669 */    0xE9 /* 'i' -> */,
+/* pos 0458: 670 */    0xEF /* 'o' -> */,
+/* pos 0459: 671 */    0xEE /* 'n' -> */,
+/* pos 045a: 672 */    0xBA /* ':' -> */,
+/* pos 045b: 673 */    0x00, 0x20                  /* - terminal marker 32 - */,
+/* pos 045d: 674 */    0xF2 /* 'r' -> */,
+/* pos 045e: 675 */    0xE9 /* 'i' -> */,
+/* pos 045f: 676 */    0xE7 /* 'g' -> */,
+/* pos 0460: 677 */    0xE9 /* 'i' -> */,
+/* pos 0461: 678 */    0xEE /* 'n' -> */,
+/* pos 0462: 679 */    0xBA /* ':' -> */,
+/* pos 0463: 680 */    0x00, 0x21                  /* - terminal marker 33 - */,
+/* pos 0465: 681 */    0xAD /* '-' -> */,
+/* pos 0466: 682 */    0xF3 /* 's' -> */,
+/* pos 0467: 683 */    0xE5 /* 'e' -> */,
+/* pos 0468: 684 */    0xF4 /* 't' -> */,
+/* pos 0469: 685 */    0xF4 /* 't' -> */,
+/* pos 046a: 686 */    0xE9 /* 'i' -> */,
+/* pos 046b: 687 */    0xEE /* 'n' -> */,
+/* pos 046c: 688 */    0xE7 /* 'g' -> */,
+/* pos 046d: 689 */    0xF3 /* 's' -> */,
+/* pos 046e: 690 */    0xBA /* ':' -> */,
+/* pos 046f: 691 */    0x00, 0x09                  /* - terminal marker  9 - */,
+/* pos 0471: 692 */    0x61 /* 'a' */, 0x0D, 0x00  /* (to 0x047E state 693) */,
+                       0x6D /* 'm' */, 0x14, 0x00  /* (to 0x0488 state 702) */,
+                       0x70 /* 'p' */, 0x18, 0x00  /* (to 0x048F state 708) */,
+                       0x73 /* 's' */, 0x20, 0x00  /* (to 0x049A state 712) */,
+                       0x08, /* fail */
+/* pos 047e: 693 */    0xF5 /* 'u' -> */,
+/* pos 047f: 694 */    0xF4 /* 't' -> */,
+/* pos 0480: 695 */    0xE8 /* 'h' -> */,
+/* pos 0481: 696 */    0xEF /* 'o' -> */,
+/* pos 0482: 697 */    0xF2 /* 'r' -> */,
+/* pos 0483: 698 */    0xE9 /* 'i' -> */,
+/* pos 0484: 699 */    0xF4 /* 't' -> */,
+/* pos 0485: 700 */    0xF9 /* 'y' -> */,
+/* pos 0486: 701 */    0x00, 0x19                  /* - terminal marker 25 - */,
+/* pos 0488: 702 */    0xE5 /* 'e' -> */,
+/* pos 0489: 703 */    0xF4 /* 't' -> */,
+/* pos 048a: 704 */    0xE8 /* 'h' -> */,
+/* pos 048b: 705 */    0xEF /* 'o' -> */,
+/* pos 048c: 706 */    0xE4 /* 'd' -> */,
+/* pos 048d: 707 */    0x00, 0x1A                  /* - terminal marker 26 - */,
+/* pos 048f: 708 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0496 state 709) */,
+                       0x72 /* 'r' */, 0x1B, 0x00  /* (to 0x04AD state 723) */,
+                       0x08, /* fail */
+/* pos 0496: 709 */    0xF4 /* 't' -> */,
+/* pos 0497: 710 */    0xE8 /* 'h' -> */,
+/* pos 0498: 711 */    0x00, 0x1B                  /* - terminal marker 27 - */,
+/* pos 049a: 712 */    0x63 /* 'c' */, 0x07, 0x00  /* (to 0x04A1 state 713) */,
+                       0x74 /* 't' */, 0x0A, 0x00  /* (to 0x04A7 state 718) */,
+                       0x08, /* fail */
+/* pos 04a1: 713 */    0xE8 /* 'h' -> */,
+/* pos 04a2: 714 */    0xE5 /* 'e' -> */,
+/* pos 04a3: 715 */    0xED /* 'm' -> */,
+/* pos 04a4: 716 */    0xE5 /* 'e' -> */,
+/* pos 04a5: 717 */    0x00, 0x1C                  /* - terminal marker 28 - */,
+/* pos 04a7: 718 */    0xE1 /* 'a' -> */,
+/* pos 04a8: 719 */    0xF4 /* 't' -> */,
+/* pos 04a9: 720 */    0xF5 /* 'u' -> */,
+/* pos 04aa: 721 */    0xF3 /* 's' -> */,
+/* pos 04ab: 722 */    0x00, 0x1D                  /* - terminal marker 29 - */,
+/* pos 04ad: 723 */    0xEF /* 'o' -> */,
+/* pos 04ae: 724 */    0xF4 /* 't' -> */,
+/* pos 04af: 725 */    0xEF /* 'o' -> */,
+/* pos 04b0: 726 */    0xE3 /* 'c' -> */,
+/* pos 04b1: 727 */    0xEF /* 'o' -> */,
+/* pos 04b2: 728 */    0xEC /* 'l' -> */,
+/* pos 04b3: 729 */    0x00, 0x4B                  /* - terminal marker 75 - */,
+/* pos 04b5: 730 */    0xEF /* 'o' -> */,
+/* pos 04b6: 731 */    0xF2 /* 'r' -> */,
+/* pos 04b7: 732 */    0xE9 /* 'i' -> */,
+/* pos 04b8: 733 */    0xF4 /* 't' -> */,
+/* pos 04b9: 734 */    0xF9 /* 'y' -> */,
+/* pos 04ba: 735 */    0xBA /* ':' -> */,
+/* pos 04bb: 736 */    0x00, 0x4E                  /* - terminal marker 78 - */,
+/* total size 1213 bytes */
 #endif
 
 #if !defined(LWS_HTTP_HEADERS_ALL) && !defined(LWS_WITH_HTTP_UNCOMMON_HEADERS) &&  defined(LWS_ROLE_WS) &&  defined(LWS_ROLE_H2)
@@ -5039,6 +5060,8 @@
 	/* 78: 85: :protocol */
 	/* 79: 86: x-auth-token: */
 	/* 80: 87: x-amzn-dss-signature: */
+	/* 81: 88: priority: */
+	/* 82: 89:  */
 /* pos 0000:   0 */    0x67 /* 'g' */, 0x40, 0x00  /* (to 0x0040 state   1) */,
                        0x70 /* 'p' */, 0x42, 0x00  /* (to 0x0045 state   5) */,
                        0x68 /* 'h' */, 0x51, 0x00  /* (to 0x0057 state  10) */,
@@ -5048,18 +5071,18 @@
                        0x0D /* '.' */, 0x98, 0x00  /* (to 0x00AA state  41) */,
                        0x61 /* 'a' */, 0xAD, 0x00  /* (to 0x00C2 state  51) */,
                        0x69 /* 'i' */, 0xCA, 0x00  /* (to 0x00E2 state  58) */,
-                       0x64 /* 'd' */, 0x73, 0x01  /* (to 0x018E state 160) */,
-                       0x72 /* 'r' */, 0x7C, 0x01  /* (to 0x019A state 165) */,
-                       0x65 /* 'e' */, 0xC8, 0x01  /* (to 0x01E9 state 229) */,
-                       0x66 /* 'f' */, 0xE4, 0x01  /* (to 0x0208 state 245) */,
-                       0x6C /* 'l' */, 0x06, 0x02  /* (to 0x022D state 278) */,
-                       0x73 /* 's' */, 0x4B, 0x02  /* (to 0x0275 state 321) */,
-                       0x74 /* 't' */, 0x69, 0x02  /* (to 0x0296 state 337) */,
-                       0x78 /* 'x' */, 0x8A, 0x02  /* (to 0x02BA state 364) */,
-                       0x6D /* 'm' */, 0x14, 0x03  /* (to 0x0347 state 474) */,
-                       0x76 /* 'v' */, 0x6D, 0x03  /* (to 0x03A3 state 549) */,
-                       0x77 /* 'w' */, 0x7A, 0x03  /* (to 0x03B3 state 557) */,
-                       0x3A /* ':' */, 0x32, 0x04  /* (to 0x046E state 692) */,
+                       0x64 /* 'd' */, 0x76, 0x01  /* (to 0x0191 state 160) */,
+                       0x72 /* 'r' */, 0x7F, 0x01  /* (to 0x019D state 165) */,
+                       0x65 /* 'e' */, 0xCB, 0x01  /* (to 0x01EC state 229) */,
+                       0x66 /* 'f' */, 0xE7, 0x01  /* (to 0x020B state 245) */,
+                       0x6C /* 'l' */, 0x09, 0x02  /* (to 0x0230 state 278) */,
+                       0x73 /* 's' */, 0x4E, 0x02  /* (to 0x0278 state 321) */,
+                       0x74 /* 't' */, 0x6C, 0x02  /* (to 0x0299 state 337) */,
+                       0x78 /* 'x' */, 0x8D, 0x02  /* (to 0x02BD state 364) */,
+                       0x6D /* 'm' */, 0x17, 0x03  /* (to 0x034A state 474) */,
+                       0x76 /* 'v' */, 0x70, 0x03  /* (to 0x03A6 state 549) */,
+                       0x77 /* 'w' */, 0x7D, 0x03  /* (to 0x03B6 state 557) */,
+                       0x3A /* ':' */, 0x35, 0x04  /* (to 0x0471 state 692) */,
                        0x08, /* fail */
 /* pos 0040:   1 */    0xE5 /* 'e' -> */,
 /* pos 0041:   2 */    0xF4 /* 't' -> */,
@@ -5067,8 +5090,8 @@
 /* pos 0043:   4 */    0x00, 0x00                  /* - terminal marker  0 - */,
 /* pos 0045:   5 */    0x6F /* 'o' */, 0x0D, 0x00  /* (to 0x0052 state   6) */,
                        0x72 /* 'r' */, 0xEC, 0x00  /* (to 0x0134 state 106) */,
-                       0x61 /* 'a' */, 0x7A, 0x03  /* (to 0x03C5 state 574) */,
-                       0x75 /* 'u' */, 0x7C, 0x03  /* (to 0x03CA state 578) */,
+                       0x61 /* 'a' */, 0x7D, 0x03  /* (to 0x03C8 state 574) */,
+                       0x75 /* 'u' */, 0x7F, 0x03  /* (to 0x03CD state 578) */,
                        0x08, /* fail */
 /* pos 0052:   6 */    0xF3 /* 's' -> */,
 /* pos 0053:   7 */    0xF4 /* 't' -> */,
@@ -5076,34 +5099,34 @@
 /* pos 0055:   9 */    0x00, 0x01                  /* - terminal marker  1 - */,
 /* pos 0057:  10 */    0x6F /* 'o' */, 0x0A, 0x00  /* (to 0x0061 state  11) */,
                        0x74 /* 't' */, 0x53, 0x00  /* (to 0x00AD state  43) */,
-                       0x65 /* 'e' */, 0x79, 0x02  /* (to 0x02D6 state 381) */,
+                       0x65 /* 'e' */, 0x7C, 0x02  /* (to 0x02D9 state 381) */,
                        0x08, /* fail */
 /* pos 0061:  11 */    0xF3 /* 's' -> */,
 /* pos 0062:  12 */    0xF4 /* 't' -> */,
 /* pos 0063:  13 */    0xBA /* ':' -> */,
 /* pos 0064:  14 */    0x00, 0x02                  /* - terminal marker  2 - */,
 /* pos 0066:  15 */    0x6F /* 'o' */, 0x07, 0x00  /* (to 0x006D state  16) */,
-                       0x61 /* 'a' */, 0xD8, 0x00  /* (to 0x0141 state 112) */,
+                       0x61 /* 'a' */, 0xDB, 0x00  /* (to 0x0144 state 112) */,
                        0x08, /* fail */
 /* pos 006d:  16 */    0x6E /* 'n' */, 0x07, 0x00  /* (to 0x0074 state  17) */,
-                       0x6F /* 'o' */, 0xED, 0x00  /* (to 0x015D state 138) */,
+                       0x6F /* 'o' */, 0xF0, 0x00  /* (to 0x0160 state 138) */,
                        0x08, /* fail */
 /* pos 0074:  17 */    0x6E /* 'n' */, 0x07, 0x00  /* (to 0x007B state  18) */,
-                       0x74 /* 't' */, 0xEC, 0x00  /* (to 0x0163 state 143) */,
+                       0x74 /* 't' */, 0xEF, 0x00  /* (to 0x0166 state 143) */,
                        0x08, /* fail */
 /* pos 007b:  18 */    0xE5 /* 'e' -> */,
 /* pos 007c:  19 */    0xE3 /* 'c' -> */,
 /* pos 007d:  20 */    0xF4 /* 't' -> */,
 /* pos 007e:  21 */    0x69 /* 'i' */, 0x07, 0x00  /* (to 0x0085 state  22) */,
-                       0x20 /* ' ' */, 0x53, 0x02  /* (to 0x02D4 state 380) */,
+                       0x20 /* ' ' */, 0x56, 0x02  /* (to 0x02D7 state 380) */,
                        0x08, /* fail */
 /* pos 0085:  22 */    0xEF /* 'o' -> */,
 /* pos 0086:  23 */    0xEE /* 'n' -> */,
 /* pos 0087:  24 */    0xBA /* ':' -> */,
 /* pos 0088:  25 */    0x00, 0x03                  /* - terminal marker  3 - */,
 /* pos 008a:  26 */    0x70 /* 'p' */, 0x0A, 0x00  /* (to 0x0094 state  27) */,
-                       0x72 /* 'r' */, 0x22, 0x02  /* (to 0x02AF state 355) */,
-                       0x73 /* 's' */, 0x08, 0x03  /* (to 0x0398 state 539) */,
+                       0x72 /* 'r' */, 0x25, 0x02  /* (to 0x02B2 state 355) */,
+                       0x73 /* 's' */, 0x0B, 0x03  /* (to 0x039B state 539) */,
                        0x08, /* fail */
 /* pos 0094:  27 */    0xE7 /* 'g' -> */,
 /* pos 0095:  28 */    0xF2 /* 'r' -> */,
@@ -5113,7 +5136,7 @@
 /* pos 0099:  32 */    0xBA /* ':' -> */,
 /* pos 009a:  33 */    0x00, 0x04                  /* - terminal marker  4 - */,
 /* pos 009c:  34 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x00A3 state  35) */,
-                       0x70 /* 'p' */, 0x61, 0x02  /* (to 0x0300 state 414) */,
+                       0x70 /* 'p' */, 0x64, 0x02  /* (to 0x0303 state 414) */,
                        0x08, /* fail */
 /* pos 00a3:  35 */    0xE9 /* 'i' -> */,
 /* pos 00a4:  36 */    0xE7 /* 'g' -> */,
@@ -5126,24 +5149,24 @@
 /* pos 00ad:  43 */    0xF4 /* 't' -> */,
 /* pos 00ae:  44 */    0xF0 /* 'p' -> */,
 /* pos 00af:  45 */    0x2F /* '/' */, 0x07, 0x00  /* (to 0x00B6 state  46) */,
-                       0x32 /* '2' */, 0xB0, 0x03  /* (to 0x0462 state 681) */,
+                       0x32 /* '2' */, 0xB3, 0x03  /* (to 0x0465 state 681) */,
                        0x08, /* fail */
 /* pos 00b6:  46 */    0xB1 /* '1' -> */,
 /* pos 00b7:  47 */    0xAE /* '.' -> */,
 /* pos 00b8:  48 */    0x31 /* '1' */, 0x07, 0x00  /* (to 0x00BF state  49) */,
-                       0x30 /* '0' */, 0xFC, 0x01  /* (to 0x02B7 state 362) */,
+                       0x30 /* '0' */, 0xFF, 0x01  /* (to 0x02BA state 362) */,
                        0x08, /* fail */
 /* pos 00bf:  49 */    0xA0 /* ' ' -> */,
 /* pos 00c0:  50 */    0x00, 0x0E                  /* - terminal marker 14 - */,
 /* pos 00c2:  51 */    0x63 /* 'c' */, 0x0D, 0x00  /* (to 0x00CF state  52) */,
-                       0x75 /* 'u' */, 0x8A, 0x00  /* (to 0x014F state 125) */,
-                       0x67 /* 'g' */, 0xE7, 0x00  /* (to 0x01AF state 178) */,
-                       0x6C /* 'l' */, 0xE8, 0x00  /* (to 0x01B3 state 181) */,
+                       0x75 /* 'u' */, 0x8D, 0x00  /* (to 0x0152 state 125) */,
+                       0x67 /* 'g' */, 0xEA, 0x00  /* (to 0x01B2 state 178) */,
+                       0x6C /* 'l' */, 0xEB, 0x00  /* (to 0x01B6 state 181) */,
                        0x08, /* fail */
 /* pos 00cf:  52 */    0xE3 /* 'c' -> */,
 /* pos 00d0:  53 */    0xE5 /* 'e' -> */,
 /* pos 00d1:  54 */    0x70 /* 'p' */, 0x07, 0x00  /* (to 0x00D8 state  55) */,
-                       0x73 /* 's' */, 0x34, 0x02  /* (to 0x0308 state 421) */,
+                       0x73 /* 's' */, 0x37, 0x02  /* (to 0x030B state 421) */,
                        0x08, /* fail */
 /* pos 00d8:  55 */    0xF4 /* 't' -> */,
 /* pos 00d9:  56 */    0x3A /* ':' */, 0x07, 0x00  /* (to 0x00E0 state  57) */,
@@ -5154,11 +5177,11 @@
 /* pos 00e3:  59 */    0xAD /* '-' -> */,
 /* pos 00e4:  60 */    0x6D /* 'm' */, 0x0D, 0x00  /* (to 0x00F1 state  61) */,
                        0x6E /* 'n' */, 0x20, 0x00  /* (to 0x0107 state  76) */,
-                       0x72 /* 'r' */, 0x2A, 0x01  /* (to 0x0214 state 255) */,
-                       0x75 /* 'u' */, 0x2E, 0x01  /* (to 0x021B state 261) */,
+                       0x72 /* 'r' */, 0x2D, 0x01  /* (to 0x0217 state 255) */,
+                       0x75 /* 'u' */, 0x31, 0x01  /* (to 0x021E state 261) */,
                        0x08, /* fail */
 /* pos 00f1:  61 */    0x6F /* 'o' */, 0x07, 0x00  /* (to 0x00F8 state  62) */,
-                       0x61 /* 'a' */, 0x1A, 0x01  /* (to 0x020E state 250) */,
+                       0x61 /* 'a' */, 0x1D, 0x01  /* (to 0x0211 state 250) */,
                        0x08, /* fail */
 /* pos 00f8:  62 */    0xE4 /* 'd' -> */,
 /* pos 00f9:  63 */    0xE9 /* 'i' -> */,
@@ -5187,8 +5210,8 @@
 /* pos 0111:  86 */    0x00, 0x12                  /* - terminal marker 18 - */,
 /* pos 0113:  87 */    0x65 /* 'e' */, 0x0D, 0x00  /* (to 0x0120 state  88) */,
                        0x6C /* 'l' */, 0x14, 0x00  /* (to 0x012A state  97) */,
-                       0x72 /* 'r' */, 0x8E, 0x00  /* (to 0x01A7 state 171) */,
-                       0x63 /* 'c' */, 0x14, 0x02  /* (to 0x0330 state 453) */,
+                       0x72 /* 'r' */, 0x91, 0x00  /* (to 0x01AA state 171) */,
+                       0x63 /* 'c' */, 0x17, 0x02  /* (to 0x0333 state 453) */,
                        0x08, /* fail */
 /* pos 0120:  88 */    0xEE /* 'n' -> */,
 /* pos 0121:  89 */    0xE3 /* 'c' -> */,
@@ -5208,696 +5231,704 @@
 /* pos 0130: 103 */    0xE5 /* 'e' -> */,
 /* pos 0131: 104 */    0xBA /* ':' -> */,
 /* pos 0132: 105 */    0x00, 0x14                  /* - terminal marker 20 - */,
-/* pos 0134: 106 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x013B state 107) */,
-                       0x6F /* 'o' */, 0x1E, 0x02  /* (to 0x0355 state 487) */,
-                       0x08, /* fail */
-/* pos 013b: 107 */    0xE7 /* 'g' -> */,
-/* pos 013c: 108 */    0xED /* 'm' -> */,
-/* pos 013d: 109 */    0xE1 /* 'a' -> */,
-/* pos 013e: 110 */    0xBA /* ':' -> */,
-/* pos 013f: 111 */    0x00, 0x15                  /* - terminal marker 21 - */,
-/* pos 0141: 112 */    0xE3 /* 'c' -> */,
-/* pos 0142: 113 */    0xE8 /* 'h' -> */,
-/* pos 0143: 114 */    0xE5 /* 'e' -> */,
-/* pos 0144: 115 */    0xAD /* '-' -> */,
-/* pos 0145: 116 */    0xE3 /* 'c' -> */,
-/* pos 0146: 117 */    0xEF /* 'o' -> */,
-/* pos 0147: 118 */    0xEE /* 'n' -> */,
-/* pos 0148: 119 */    0xF4 /* 't' -> */,
-/* pos 0149: 120 */    0xF2 /* 'r' -> */,
-/* pos 014a: 121 */    0xEF /* 'o' -> */,
-/* pos 014b: 122 */    0xEC /* 'l' -> */,
-/* pos 014c: 123 */    0xBA /* ':' -> */,
-/* pos 014d: 124 */    0x00, 0x16                  /* - terminal marker 22 - */,
-/* pos 014f: 125 */    0xF4 /* 't' -> */,
-/* pos 0150: 126 */    0xE8 /* 'h' -> */,
-/* pos 0151: 127 */    0xEF /* 'o' -> */,
-/* pos 0152: 128 */    0xF2 /* 'r' -> */,
-/* pos 0153: 129 */    0xE9 /* 'i' -> */,
-/* pos 0154: 130 */    0xFA /* 'z' -> */,
-/* pos 0155: 131 */    0xE1 /* 'a' -> */,
-/* pos 0156: 132 */    0xF4 /* 't' -> */,
-/* pos 0157: 133 */    0xE9 /* 'i' -> */,
-/* pos 0158: 134 */    0xEF /* 'o' -> */,
-/* pos 0159: 135 */    0xEE /* 'n' -> */,
-/* pos 015a: 136 */    0xBA /* ':' -> */,
-/* pos 015b: 137 */    0x00, 0x17                  /* - terminal marker 23 - */,
-/* pos 015d: 138 */    0xEB /* 'k' -> */,
-/* pos 015e: 139 */    0xE9 /* 'i' -> */,
-/* pos 015f: 140 */    0xE5 /* 'e' -> */,
-/* pos 0160: 141 */    0xBA /* ':' -> */,
-/* pos 0161: 142 */    0x00, 0x18                  /* - terminal marker 24 - */,
-/* pos 0163: 143 */    0xE5 /* 'e' -> */,
-/* pos 0164: 144 */    0xEE /* 'n' -> */,
-/* pos 0165: 145 */    0xF4 /* 't' -> */,
-/* pos 0166: 146 */    0xAD /* '-' -> */,
-/* pos 0167: 147 */    0x6C /* 'l' */, 0x10, 0x00  /* (to 0x0177 state 148) */,
-                       0x74 /* 't' */, 0x1E, 0x00  /* (to 0x0188 state 155) */,
-                       0x64 /* 'd' */, 0x4C, 0x00  /* (to 0x01B9 state 186) */,
-                       0x65 /* 'e' */, 0x56, 0x00  /* (to 0x01C6 state 198) */,
-                       0x72 /* 'r' */, 0x6F, 0x00  /* (to 0x01E2 state 223) */,
-                       0x08, /* fail */
-/* pos 0177: 148 */    0x65 /* 'e' */, 0x0A, 0x00  /* (to 0x0181 state 149) */,
-                       0x61 /* 'a' */, 0x56, 0x00  /* (to 0x01D0 state 207) */,
-                       0x6F /* 'o' */, 0x5C, 0x00  /* (to 0x01D9 state 215) */,
-                       0x08, /* fail */
-/* pos 0181: 149 */    0xEE /* 'n' -> */,
-/* pos 0182: 150 */    0xE7 /* 'g' -> */,
-/* pos 0183: 151 */    0xF4 /* 't' -> */,
-/* pos 0184: 152 */    0xE8 /* 'h' -> */,
-/* pos 0185: 153 */    0xBA /* ':' -> */,
-/* pos 0186: 154 */    0x00, 0x19                  /* - terminal marker 25 - */,
-/* pos 0188: 155 */    0xF9 /* 'y' -> */,
-/* pos 0189: 156 */    0xF0 /* 'p' -> */,
-/* pos 018a: 157 */    0xE5 /* 'e' -> */,
-/* pos 018b: 158 */    0xBA /* ':' -> */,
-/* pos 018c: 159 */    0x00, 0x1A                  /* - terminal marker 26 - */,
-/* pos 018e: 160 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0195 state 161) */,
-                       0x65 /* 'e' */, 0x3C, 0x02  /* (to 0x03CD state 580) */,
-                       0x08, /* fail */
-/* pos 0195: 161 */    0xF4 /* 't' -> */,
-/* pos 0196: 162 */    0xE5 /* 'e' -> */,
-/* pos 0197: 163 */    0xBA /* ':' -> */,
-/* pos 0198: 164 */    0x00, 0x1B                  /* - terminal marker 27 - */,
-/* pos 019a: 165 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x01A1 state 166) */,
-                       0x65 /* 'e' */, 0xB6, 0x00  /* (to 0x0253 state 304) */,
-                       0x08, /* fail */
-/* pos 01a1: 166 */    0xEE /* 'n' -> */,
-/* pos 01a2: 167 */    0xE7 /* 'g' -> */,
-/* pos 01a3: 168 */    0xE5 /* 'e' -> */,
-/* pos 01a4: 169 */    0xBA /* ':' -> */,
-/* pos 01a5: 170 */    0x00, 0x1C                  /* - terminal marker 28 - */,
-/* pos 01a7: 171 */    0xE1 /* 'a' -> */,
-/* pos 01a8: 172 */    0xEE /* 'n' -> */,
-/* pos 01a9: 173 */    0xE7 /* 'g' -> */,
-/* pos 01aa: 174 */    0xE5 /* 'e' -> */,
-/* pos 01ab: 175 */    0xF3 /* 's' -> */,
-/* pos 01ac: 176 */    0xBA /* ':' -> */,
-/* pos 01ad: 177 */    0x00, 0x27                  /* - terminal marker 39 - */,
-/* pos 01af: 178 */    0xE5 /* 'e' -> */,
-/* pos 01b0: 179 */    0xBA /* ':' -> */,
-/* pos 01b1: 180 */    0x00, 0x29                  /* - terminal marker 41 - */,
-/* pos 01b3: 181 */    0xEC /* 'l' -> */,
-/* pos 01b4: 182 */    0xEF /* 'o' -> */,
-/* pos 01b5: 183 */    0xF7 /* 'w' -> */,
-/* pos 01b6: 184 */    0xBA /* ':' -> */,
-/* pos 01b7: 185 */    0x00, 0x2A                  /* - terminal marker 42 - */,
-/* pos 01b9: 186 */    0xE9 /* 'i' -> */,
-/* pos 01ba: 187 */    0xF3 /* 's' -> */,
-/* pos 01bb: 188 */    0xF0 /* 'p' -> */,
-/* pos 01bc: 189 */    0xEF /* 'o' -> */,
-/* pos 01bd: 190 */    0xF3 /* 's' -> */,
-/* pos 01be: 191 */    0xE9 /* 'i' -> */,
-/* pos 01bf: 192 */    0xF4 /* 't' -> */,
-/* pos 01c0: 193 */    0xE9 /* 'i' -> */,
-/* pos 01c1: 194 */    0xEF /* 'o' -> */,
-/* pos 01c2: 195 */    0xEE /* 'n' -> */,
-/* pos 01c3: 196 */    0xBA /* ':' -> */,
-/* pos 01c4: 197 */    0x00, 0x2B                  /* - terminal marker 43 - */,
-/* pos 01c6: 198 */    0xEE /* 'n' -> */,
-/* pos 01c7: 199 */    0xE3 /* 'c' -> */,
-/* pos 01c8: 200 */    0xEF /* 'o' -> */,
-/* pos 01c9: 201 */    0xE4 /* 'd' -> */,
-/* pos 01ca: 202 */    0xE9 /* 'i' -> */,
-/* pos 01cb: 203 */    0xEE /* 'n' -> */,
-/* pos 01cc: 204 */    0xE7 /* 'g' -> */,
-/* pos 01cd: 205 */    0xBA /* ':' -> */,
-/* pos 01ce: 206 */    0x00, 0x2C                  /* - terminal marker 44 - */,
-/* pos 01d0: 207 */    0xEE /* 'n' -> */,
-/* pos 01d1: 208 */    0xE7 /* 'g' -> */,
-/* pos 01d2: 209 */    0xF5 /* 'u' -> */,
-/* pos 01d3: 210 */    0xE1 /* 'a' -> */,
-/* pos 01d4: 211 */    0xE7 /* 'g' -> */,
-/* pos 01d5: 212 */    0xE5 /* 'e' -> */,
-/* pos 01d6: 213 */    0xBA /* ':' -> */,
-/* pos 01d7: 214 */    0x00, 0x2D                  /* - terminal marker 45 - */,
-/* pos 01d9: 215 */    0xE3 /* 'c' -> */,
-/* pos 01da: 216 */    0xE1 /* 'a' -> */,
-/* pos 01db: 217 */    0xF4 /* 't' -> */,
-/* pos 01dc: 218 */    0xE9 /* 'i' -> */,
-/* pos 01dd: 219 */    0xEF /* 'o' -> */,
-/* pos 01de: 220 */    0xEE /* 'n' -> */,
-/* pos 01df: 221 */    0xBA /* ':' -> */,
-/* pos 01e0: 222 */    0x00, 0x2E                  /* - terminal marker 46 - */,
-/* pos 01e2: 223 */    0xE1 /* 'a' -> */,
-/* pos 01e3: 224 */    0xEE /* 'n' -> */,
-/* pos 01e4: 225 */    0xE7 /* 'g' -> */,
-/* pos 01e5: 226 */    0xE5 /* 'e' -> */,
-/* pos 01e6: 227 */    0xBA /* ':' -> */,
-/* pos 01e7: 228 */    0x00, 0x2F                  /* - terminal marker 47 - */,
-/* pos 01e9: 229 */    0x74 /* 't' */, 0x07, 0x00  /* (to 0x01F0 state 230) */,
-                       0x78 /* 'x' */, 0x09, 0x00  /* (to 0x01F5 state 234) */,
-                       0x08, /* fail */
-/* pos 01f0: 230 */    0xE1 /* 'a' -> */,
-/* pos 01f1: 231 */    0xE7 /* 'g' -> */,
-/* pos 01f2: 232 */    0xBA /* ':' -> */,
-/* pos 01f3: 233 */    0x00, 0x30                  /* - terminal marker 48 - */,
-/* pos 01f5: 234 */    0xF0 /* 'p' -> */,
-/* pos 01f6: 235 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x01FD state 236) */,
-                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x0202 state 240) */,
-                       0x08, /* fail */
-/* pos 01fd: 236 */    0xE3 /* 'c' -> */,
-/* pos 01fe: 237 */    0xF4 /* 't' -> */,
-/* pos 01ff: 238 */    0xBA /* ':' -> */,
-/* pos 0200: 239 */    0x00, 0x31                  /* - terminal marker 49 - */,
-/* pos 0202: 240 */    0xF2 /* 'r' -> */,
-/* pos 0203: 241 */    0xE5 /* 'e' -> */,
-/* pos 0204: 242 */    0xF3 /* 's' -> */,
-/* pos 0205: 243 */    0xBA /* ':' -> */,
-/* pos 0206: 244 */    0x00, 0x32                  /* - terminal marker 50 - */,
-/* pos 0208: 245 */    0xF2 /* 'r' -> */,
-/* pos 0209: 246 */    0xEF /* 'o' -> */,
-/* pos 020a: 247 */    0xED /* 'm' -> */,
-/* pos 020b: 248 */    0xBA /* ':' -> */,
-/* pos 020c: 249 */    0x00, 0x33                  /* - terminal marker 51 - */,
-/* pos 020e: 250 */    0xF4 /* 't' -> */,
-/* pos 020f: 251 */    0xE3 /* 'c' -> */,
-/* pos 0210: 252 */    0xE8 /* 'h' -> */,
-/* pos 0211: 253 */    0xBA /* ':' -> */,
-/* pos 0212: 254 */    0x00, 0x34                  /* - terminal marker 52 - */,
-/* pos 0214: 255 */    0xE1 /* 'a' -> */,
-/* pos 0215: 256 */    0xEE /* 'n' -> */,
-/* pos 0216: 257 */    0xE7 /* 'g' -> */,
-/* pos 0217: 258 */    0xE5 /* 'e' -> */,
-/* pos 0218: 259 */    0xBA /* ':' -> */,
-/* pos 0219: 260 */    0x00, 0x35                  /* - terminal marker 53 - */,
-/* pos 021b: 261 */    0xEE /* 'n' -> */,
-/* pos 021c: 262 */    0xED /* 'm' -> */,
-/* pos 021d: 263 */    0xEF /* 'o' -> */,
-/* pos 021e: 264 */    0xE4 /* 'd' -> */,
-/* pos 021f: 265 */    0xE9 /* 'i' -> */,
-/* pos 0220: 266 */    0xE6 /* 'f' -> */,
-/* pos 0221: 267 */    0xE9 /* 'i' -> */,
-/* pos 0222: 268 */    0xE5 /* 'e' -> */,
-/* pos 0223: 269 */    0xE4 /* 'd' -> */,
-/* pos 0224: 270 */    0xAD /* '-' -> */,
-/* pos 0225: 271 */    0xF3 /* 's' -> */,
-/* pos 0226: 272 */    0xE9 /* 'i' -> */,
-/* pos 0227: 273 */    0xEE /* 'n' -> */,
-/* pos 0228: 274 */    0xE3 /* 'c' -> */,
-/* pos 0229: 275 */    0xE5 /* 'e' -> */,
-/* pos 022a: 276 */    0xBA /* ':' -> */,
-/* pos 022b: 277 */    0x00, 0x36                  /* - terminal marker 54 - */,
-/* pos 022d: 278 */    0x61 /* 'a' */, 0x0A, 0x00  /* (to 0x0237 state 279) */,
-                       0x69 /* 'i' */, 0x15, 0x00  /* (to 0x0245 state 292) */,
-                       0x6F /* 'o' */, 0x17, 0x00  /* (to 0x024A state 296) */,
-                       0x08, /* fail */
-/* pos 0237: 279 */    0xF3 /* 's' -> */,
-/* pos 0238: 280 */    0xF4 /* 't' -> */,
-/* pos 0239: 281 */    0xAD /* '-' -> */,
-/* pos 023a: 282 */    0xED /* 'm' -> */,
-/* pos 023b: 283 */    0xEF /* 'o' -> */,
-/* pos 023c: 284 */    0xE4 /* 'd' -> */,
-/* pos 023d: 285 */    0xE9 /* 'i' -> */,
-/* pos 023e: 286 */    0xE6 /* 'f' -> */,
-/* pos 023f: 287 */    0xE9 /* 'i' -> */,
-/* pos 0240: 288 */    0xE5 /* 'e' -> */,
-/* pos 0241: 289 */    0xE4 /* 'd' -> */,
-/* pos 0242: 290 */    0xBA /* ':' -> */,
-/* pos 0243: 291 */    0x00, 0x37                  /* - terminal marker 55 - */,
-/* pos 0245: 292 */    0xEE /* 'n' -> */,
-/* pos 0246: 293 */    0xEB /* 'k' -> */,
-/* pos 0247: 294 */    0xBA /* ':' -> */,
-/* pos 0248: 295 */    0x00, 0x38                  /* - terminal marker 56 - */,
-/* pos 024a: 296 */    0xE3 /* 'c' -> */,
-/* pos 024b: 297 */    0xE1 /* 'a' -> */,
-/* pos 024c: 298 */    0xF4 /* 't' -> */,
-/* pos 024d: 299 */    0xE9 /* 'i' -> */,
-/* pos 024e: 300 */    0xEF /* 'o' -> */,
-/* pos 024f: 301 */    0xEE /* 'n' -> */,
-/* pos 0250: 302 */    0xBA /* ':' -> */,
-/* pos 0251: 303 */    0x00, 0x39                  /* - terminal marker 57 - */,
-/* pos 0253: 304 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x025D state 305) */,
-                       0x74 /* 't' */, 0x14, 0x00  /* (to 0x026A state 311) */,
-                       0x70 /* 'p' */, 0x88, 0x01  /* (to 0x03E1 state 596) */,
-                       0x08, /* fail */
-/* pos 025d: 305 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x0264 state 306) */,
-                       0x65 /* 'e' */, 0xCA, 0x00  /* (to 0x032A state 448) */,
-                       0x08, /* fail */
-/* pos 0264: 306 */    0xE5 /* 'e' -> */,
-/* pos 0265: 307 */    0xF3 /* 's' -> */,
-/* pos 0266: 308 */    0xE8 /* 'h' -> */,
-/* pos 0267: 309 */    0xBA /* ':' -> */,
-/* pos 0268: 310 */    0x00, 0x3D                  /* - terminal marker 61 - */,
-/* pos 026a: 311 */    0xF2 /* 'r' -> */,
-/* pos 026b: 312 */    0xF9 /* 'y' -> */,
-/* pos 026c: 313 */    0xAD /* '-' -> */,
-/* pos 026d: 314 */    0xE1 /* 'a' -> */,
-/* pos 026e: 315 */    0xE6 /* 'f' -> */,
-/* pos 026f: 316 */    0xF4 /* 't' -> */,
-/* pos 0270: 317 */    0xE5 /* 'e' -> */,
-/* pos 0271: 318 */    0xF2 /* 'r' -> */,
-/* pos 0272: 319 */    0xBA /* ':' -> */,
-/* pos 0273: 320 */    0x00, 0x3E                  /* - terminal marker 62 - */,
-/* pos 0275: 321 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x027C state 322) */,
-                       0x74 /* 't' */, 0x06, 0x01  /* (to 0x037E state 514) */,
-                       0x08, /* fail */
-/* pos 027c: 322 */    0x72 /* 'r' */, 0x0A, 0x00  /* (to 0x0286 state 323) */,
-                       0x74 /* 't' */, 0x0D, 0x00  /* (to 0x028C state 328) */,
-                       0x63 /* 'c' */, 0x6B, 0x01  /* (to 0x03ED state 607) */,
-                       0x08, /* fail */
-/* pos 0286: 323 */    0xF6 /* 'v' -> */,
-/* pos 0287: 324 */    0xE5 /* 'e' -> */,
-/* pos 0288: 325 */    0xF2 /* 'r' -> */,
-/* pos 0289: 326 */    0xBA /* ':' -> */,
-/* pos 028a: 327 */    0x00, 0x3F                  /* - terminal marker 63 - */,
-/* pos 028c: 328 */    0xAD /* '-' -> */,
-/* pos 028d: 329 */    0xE3 /* 'c' -> */,
-/* pos 028e: 330 */    0xEF /* 'o' -> */,
-/* pos 028f: 331 */    0xEF /* 'o' -> */,
-/* pos 0290: 332 */    0xEB /* 'k' -> */,
-/* pos 0291: 333 */    0xE9 /* 'i' -> */,
-/* pos 0292: 334 */    0xE5 /* 'e' -> */,
-/* pos 0293: 335 */    0xBA /* ':' -> */,
-/* pos 0294: 336 */    0x00, 0x40                  /* - terminal marker 64 - */,
-/* pos 0296: 337 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x029D state 338) */,
-                       0x65 /* 'e' */, 0x45, 0x01  /* (to 0x03DE state 594) */,
-                       0x08, /* fail */
-/* pos 029d: 338 */    0xE1 /* 'a' -> */,
-/* pos 029e: 339 */    0xEE /* 'n' -> */,
-/* pos 029f: 340 */    0xF3 /* 's' -> */,
-/* pos 02a0: 341 */    0xE6 /* 'f' -> */,
-/* pos 02a1: 342 */    0xE5 /* 'e' -> */,
-/* pos 02a2: 343 */    0xF2 /* 'r' -> */,
-/* pos 02a3: 344 */    0xAD /* '-' -> */,
-/* pos 02a4: 345 */    0xE5 /* 'e' -> */,
-/* pos 02a5: 346 */    0xEE /* 'n' -> */,
-/* pos 02a6: 347 */    0xE3 /* 'c' -> */,
-/* pos 02a7: 348 */    0xEF /* 'o' -> */,
-/* pos 02a8: 349 */    0xE4 /* 'd' -> */,
-/* pos 02a9: 350 */    0xE9 /* 'i' -> */,
-/* pos 02aa: 351 */    0xEE /* 'n' -> */,
-/* pos 02ab: 352 */    0xE7 /* 'g' -> */,
-/* pos 02ac: 353 */    0xBA /* ':' -> */,
-/* pos 02ad: 354 */    0x00, 0x42                  /* - terminal marker 66 - */,
-/* pos 02af: 355 */    0xE9 /* 'i' -> */,
-/* pos 02b0: 356 */    0xAD /* '-' -> */,
-/* pos 02b1: 357 */    0xE1 /* 'a' -> */,
-/* pos 02b2: 358 */    0xF2 /* 'r' -> */,
-/* pos 02b3: 359 */    0xE7 /* 'g' -> */,
-/* pos 02b4: 360 */    0xF3 /* 's' -> */,
-/* pos 02b5: 361 */    0x00, 0x47                  /* - terminal marker 71 - */,
-/* pos 02b7: 362 */    0xA0 /* ' ' -> */,
-/* pos 02b8: 363 */    0x00, 0x48                  /* - terminal marker 72 - */,
-/* pos 02ba: 364 */    0xAD /* '-' -> */,
-/* pos 02bb: 365 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x02C5 state 366) */,
-                       0x61 /* 'a' */, 0x1D, 0x00  /* (to 0x02DB state 385) */,
-                       0x72 /* 'r' */, 0x14, 0x01  /* (to 0x03D5 state 586) */,
-                       0x08, /* fail */
-/* pos 02c5: 366 */    0xEF /* 'o' -> */,
-/* pos 02c6: 367 */    0xF2 /* 'r' -> */,
-/* pos 02c7: 368 */    0xF7 /* 'w' -> */,
-/* pos 02c8: 369 */    0xE1 /* 'a' -> */,
-/* pos 02c9: 370 */    0xF2 /* 'r' -> */,
-/* pos 02ca: 371 */    0xE4 /* 'd' -> */,
-/* pos 02cb: 372 */    0xE5 /* 'e' -> */,
-/* pos 02cc: 373 */    0xE4 /* 'd' -> */,
-/* pos 02cd: 374 */    0xAD /* '-' -> */,
-/* pos 02ce: 375 */    0xE6 /* 'f' -> */,
-/* pos 02cf: 376 */    0xEF /* 'o' -> */,
-/* pos 02d0: 377 */    0xF2 /* 'r' -> */,
-/* pos 02d1: 378 */    0xBA /* ':' -> */,
-/* pos 02d2: 379 */    0x00, 0x49                  /* - terminal marker 73 - */,
-/* pos 02d4: 380 */    0x00, 0x4A                  /* - terminal marker 74 - */,
-/* pos 02d6: 381 */    0xE1 /* 'a' -> */,
-/* pos 02d7: 382 */    0xE4 /* 'd' -> */,
-/* pos 02d8: 383 */    0xA0 /* ' ' -> */,
-/* pos 02d9: 384 */    0x00, 0x4B                  /* - terminal marker 75 - */,
-/* pos 02db: 385 */    0x75 /* 'u' */, 0x07, 0x00  /* (to 0x02E2 state 386) */,
-                       0x6D /* 'm' */, 0x0F, 0x00  /* (to 0x02ED state 396) */,
-                       0x08, /* fail */
-/* pos 02e2: 386 */    0xF4 /* 't' -> */,
-/* pos 02e3: 387 */    0xE8 /* 'h' -> */,
-/* pos 02e4: 388 */    0xAD /* '-' -> */,
-/* pos 02e5: 389 */    0xF4 /* 't' -> */,
-/* pos 02e6: 390 */    0xEF /* 'o' -> */,
-/* pos 02e7: 391 */    0xEB /* 'k' -> */,
-/* pos 02e8: 392 */    0xE5 /* 'e' -> */,
-/* pos 02e9: 393 */    0xEE /* 'n' -> */,
-/* pos 02ea: 394 */    0xBA /* ':' -> */,
-/* pos 02eb: 395 */    0x00, 0x4F                  /* - terminal marker 79 - */,
-/* pos 02ed: 396 */    0xFA /* 'z' -> */,
-/* pos 02ee: 397 */    0xEE /* 'n' -> */,
-/* pos 02ef: 398 */    0xAD /* '-' -> */,
-/* pos 02f0: 399 */    0xE4 /* 'd' -> */,
-/* pos 02f1: 400 */    0xF3 /* 's' -> */,
-/* pos 02f2: 401 */    0xF3 /* 's' -> */,
-/* pos 02f3: 402 */    0xAD /* '-' -> */,
-/* pos 02f4: 403 */    0xF3 /* 's' -> */,
-/* pos 02f5: 404 */    0xE9 /* 'i' -> */,
-/* pos 02f6: 405 */    0xE7 /* 'g' -> */,
-/* pos 02f7: 406 */    0xEE /* 'n' -> */,
-/* pos 02f8: 407 */    0xE1 /* 'a' -> */,
-/* pos 02f9: 408 */    0xF4 /* 't' -> */,
-/* pos 02fa: 409 */    0xF5 /* 'u' -> */,
-/* pos 02fb: 410 */    0xF2 /* 'r' -> */,
-/* pos 02fc: 411 */    0xE5 /* 'e' -> */,
-/* pos 02fd: 412 */    0xBA /* ':' -> */,
-/* pos 02fe: 413 */    0x00, 0x50                  /* - terminal marker 80 - */,
-/* pos 0300: 414 */    0xF4 /* 't' -> */,
-/* pos 0301: 415 */    0xE9 /* 'i' -> */,
-/* pos 0302: 416 */    0xEF /* 'o' -> */,
-/* pos 0303: 417 */    0xEE /* 'n' -> */,
-/* pos 0304: 418 */    0xF3 /* 's' -> */,
-/* pos 0305: 419 */    0xA0 /* ' ' -> */,
-/* pos 0306: 420 */    0x00, 0x02                  /* - terminal marker  2 - */,
-/* pos 0308: 421 */    0xF3 /* 's' -> */,
-/* pos 0309: 422 */    0xAD /* '-' -> */,
-/* pos 030a: 423 */    0xE3 /* 'c' -> */,
-/* pos 030b: 424 */    0xEF /* 'o' -> */,
-/* pos 030c: 425 */    0xEE /* 'n' -> */,
-/* pos 030d: 426 */    0xF4 /* 't' -> */,
-/* pos 030e: 427 */    0xF2 /* 'r' -> */,
-/* pos 030f: 428 */    0xEF /* 'o' -> */,
-/* pos 0310: 429 */    0xEC /* 'l' -> */,
-/* pos 0311: 430 */    0xAD /* '-' -> */,
-/* pos 0312: 431 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x0319 state 432) */,
-                       0x61 /* 'a' */, 0x24, 0x00  /* (to 0x0339 state 461) */,
-                       0x08, /* fail */
-/* pos 0319: 432 */    0xE5 /* 'e' -> */,
-/* pos 031a: 433 */    0xF1 /* 'q' -> */,
-/* pos 031b: 434 */    0xF5 /* 'u' -> */,
-/* pos 031c: 435 */    0xE5 /* 'e' -> */,
-/* pos 031d: 436 */    0xF3 /* 's' -> */,
-/* pos 031e: 437 */    0xF4 /* 't' -> */,
-/* pos 031f: 438 */    0xAD /* '-' -> */,
-/* pos 0320: 439 */    0xE8 /* 'h' -> */,
-/* pos 0321: 440 */    0xE5 /* 'e' -> */,
-/* pos 0322: 441 */    0xE1 /* 'a' -> */,
-/* pos 0323: 442 */    0xE4 /* 'd' -> */,
-/* pos 0324: 443 */    0xE5 /* 'e' -> */,
-/* pos 0325: 444 */    0xF2 /* 'r' -> */,
-/* pos 0326: 445 */    0xF3 /* 's' -> */,
-/* pos 0327: 446 */    0xBA /* ':' -> */,
-/* pos 0328: 447 */    0x00, 0x0B                  /* - terminal marker 11 - */,
-/* pos 032a: 448 */    0xF2 /* 'r' -> */,
-/* pos 032b: 449 */    0xE5 /* 'e' -> */,
-/* pos 032c: 450 */    0xF2 /* 'r' -> */,
-/* pos 032d: 451 */    0xBA /* ':' -> */,
-/* pos 032e: 452 */    0x00, 0x1D                  /* - terminal marker 29 - */,
-/* pos 0330: 453 */    0xE8 /* 'h' -> */,
-/* pos 0331: 454 */    0xE1 /* 'a' -> */,
-/* pos 0332: 455 */    0xF2 /* 'r' -> */,
-/* pos 0333: 456 */    0xF3 /* 's' -> */,
-/* pos 0334: 457 */    0xE5 /* 'e' -> */,
-/* pos 0335: 458 */    0xF4 /* 't' -> */,
-/* pos 0336: 459 */    0xBA /* ':' -> */,
-/* pos 0337: 460 */    0x00, 0x26                  /* - terminal marker 38 - */,
-/* pos 0339: 461 */    0xEC /* 'l' -> */,
-/* pos 033a: 462 */    0xEC /* 'l' -> */,
-/* pos 033b: 463 */    0xEF /* 'o' -> */,
-/* pos 033c: 464 */    0xF7 /* 'w' -> */,
-/* pos 033d: 465 */    0xAD /* '-' -> */,
-/* pos 033e: 466 */    0xEF /* 'o' -> */,
-/* pos 033f: 467 */    0xF2 /* 'r' -> */,
-/* pos 0340: 468 */    0xE9 /* 'i' -> */,
-/* pos 0341: 469 */    0xE7 /* 'g' -> */,
-/* pos 0342: 470 */    0xE9 /* 'i' -> */,
-/* pos 0343: 471 */    0xEE /* 'n' -> */,
-/* pos 0344: 472 */    0xBA /* ':' -> */,
-/* pos 0345: 473 */    0x00, 0x28                  /* - terminal marker 40 - */,
-/* pos 0347: 474 */    0xE1 /* 'a' -> */,
-/* pos 0348: 475 */    0xF8 /* 'x' -> */,
-/* pos 0349: 476 */    0xAD /* '-' -> */,
-/* pos 034a: 477 */    0xE6 /* 'f' -> */,
-/* pos 034b: 478 */    0xEF /* 'o' -> */,
-/* pos 034c: 479 */    0xF2 /* 'r' -> */,
-/* pos 034d: 480 */    0xF7 /* 'w' -> */,
-/* pos 034e: 481 */    0xE1 /* 'a' -> */,
-/* pos 034f: 482 */    0xF2 /* 'r' -> */,
-/* pos 0350: 483 */    0xE4 /* 'd' -> */,
-/* pos 0351: 484 */    0xF3 /* 's' -> */,
-/* pos 0352: 485 */    0xBA /* ':' -> */,
-/* pos 0353: 486 */    0x00, 0x3A                  /* - terminal marker 58 - */,
-/* pos 0355: 487 */    0xF8 /* 'x' -> */,
-/* pos 0356: 488 */    0xF9 /* 'y' -> */,
-/* pos 0357: 489 */    0x2D /* '-' */, 0x07, 0x00  /* (to 0x035E state 490) */,
-                       0x20 /* ' ' */, 0x79, 0x00  /* (to 0x03D3 state 585) */,
-                       0x08, /* fail */
-/* pos 035e: 490 */    0xE1 /* 'a' -> */,
-/* pos 035f: 491 */    0xF5 /* 'u' -> */,
-/* pos 0360: 492 */    0xF4 /* 't' -> */,
-/* pos 0361: 493 */    0xE8 /* 'h' -> */,
-/* pos 0362: 494 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x0369 state 495) */,
-                       0x6F /* 'o' */, 0x0E, 0x00  /* (to 0x0373 state 504) */,
-                       0x08, /* fail */
-/* pos 0369: 495 */    0xEE /* 'n' -> */,
-/* pos 036a: 496 */    0xF4 /* 't' -> */,
-/* pos 036b: 497 */    0xE9 /* 'i' -> */,
-/* pos 036c: 498 */    0xE3 /* 'c' -> */,
-/* pos 036d: 499 */    0xE1 /* 'a' -> */,
-/* pos 036e: 500 */    0xF4 /* 't' -> */,
-/* pos 036f: 501 */    0xE5 /* 'e' -> */,
-/* pos 0370: 502 */    0xBA /* ':' -> */,
-/* pos 0371: 503 */    0x00, 0x3B                  /* - terminal marker 59 - */,
-/* pos 0373: 504 */    0xF2 /* 'r' -> */,
-/* pos 0374: 505 */    0xE9 /* 'i' -> */,
-/* pos 0375: 506 */    0xFA /* 'z' -> */,
-/* pos 0376: 507 */    0xE1 /* 'a' -> */,
-/* pos 0377: 508 */    0xF4 /* 't' -> */,
-/* pos 0378: 509 */    0xE9 /* 'i' -> */,
-/* pos 0379: 510 */    0xEF /* 'o' -> */,
-/* pos 037a: 511 */    0xEE /* 'n' -> */,
-/* pos 037b: 512 */    0xBA /* ':' -> */,
-/* pos 037c: 513 */    0x00, 0x3C                  /* - terminal marker 60 - */,
-/* pos 037e: 514 */    0xF2 /* 'r' -> */,
-/* pos 037f: 515 */    0xE9 /* 'i' -> */,
-/* pos 0380: 516 */    0xE3 /* 'c' -> */,
-/* pos 0381: 517 */    0xF4 /* 't' -> */,
-/* pos 0382: 518 */    0xAD /* '-' -> */,
-/* pos 0383: 519 */    0xF4 /* 't' -> */,
-/* pos 0384: 520 */    0xF2 /* 'r' -> */,
-/* pos 0385: 521 */    0xE1 /* 'a' -> */,
-/* pos 0386: 522 */    0xEE /* 'n' -> */,
-/* pos 0387: 523 */    0xF3 /* 's' -> */,
-/* pos 0388: 524 */    0xF0 /* 'p' -> */,
-/* pos 0389: 525 */    0xEF /* 'o' -> */,
-/* pos 038a: 526 */    0xF2 /* 'r' -> */,
-/* pos 038b: 527 */    0xF4 /* 't' -> */,
-/* pos 038c: 528 */    0xAD /* '-' -> */,
-/* pos 038d: 529 */    0xF3 /* 's' -> */,
-/* pos 038e: 530 */    0xE5 /* 'e' -> */,
-/* pos 038f: 531 */    0xE3 /* 'c' -> */,
-/* pos 0390: 532 */    0xF5 /* 'u' -> */,
-/* pos 0391: 533 */    0xF2 /* 'r' -> */,
-/* pos 0392: 534 */    0xE9 /* 'i' -> */,
-/* pos 0393: 535 */    0xF4 /* 't' -> */,
-/* pos 0394: 536 */    0xF9 /* 'y' -> */,
-/* pos 0395: 537 */    0xBA /* ':' -> */,
-/* pos 0396: 538 */    0x00, 0x41                  /* - terminal marker 65 - */,
-/* pos 0398: 539 */    0xE5 /* 'e' -> */,
-/* pos 0399: 540 */    0xF2 /* 'r' -> */,
-/* pos 039a: 541 */    0xAD /* '-' -> */,
-/* pos 039b: 542 */    0xE1 /* 'a' -> */,
-/* pos 039c: 543 */    0xE7 /* 'g' -> */,
-/* pos 039d: 544 */    0xE5 /* 'e' -> */,
-/* pos 039e: 545 */    0xEE /* 'n' -> */,
-/* pos 039f: 546 */    0xF4 /* 't' -> */,
-/* pos 03a0: 547 */    0xBA /* ':' -> */,
-/* pos 03a1: 548 */    0x00, 0x43                  /* - terminal marker 67 - */,
-/* pos 03a3: 549 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x03AA state 550) */,
-                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x03AF state 554) */,
-                       0x08, /* fail */
-/* pos 03aa: 550 */    0xF2 /* 'r' -> */,
-/* pos 03ab: 551 */    0xF9 /* 'y' -> */,
-/* pos 03ac: 552 */    0xBA /* ':' -> */,
-/* pos 03ad: 553 */    0x00, 0x44                  /* - terminal marker 68 - */,
-/* pos 03af: 554 */    0xE1 /* 'a' -> */,
-/* pos 03b0: 555 */    0xBA /* ':' -> */,
-/* pos 03b1: 556 */    0x00, 0x45                  /* - terminal marker 69 - */,
-/* pos 03b3: 557 */    0xF7 /* 'w' -> */,
-/* pos 03b4: 558 */    0xF7 /* 'w' -> */,
-/* pos 03b5: 559 */    0xAD /* '-' -> */,
-/* pos 03b6: 560 */    0xE1 /* 'a' -> */,
-/* pos 03b7: 561 */    0xF5 /* 'u' -> */,
-/* pos 03b8: 562 */    0xF4 /* 't' -> */,
-/* pos 03b9: 563 */    0xE8 /* 'h' -> */,
-/* pos 03ba: 564 */    0xE5 /* 'e' -> */,
-/* pos 03bb: 565 */    0xEE /* 'n' -> */,
-/* pos 03bc: 566 */    0xF4 /* 't' -> */,
-/* pos 03bd: 567 */    0xE9 /* 'i' -> */,
-/* pos 03be: 568 */    0xE3 /* 'c' -> */,
-/* pos 03bf: 569 */    0xE1 /* 'a' -> */,
-/* pos 03c0: 570 */    0xF4 /* 't' -> */,
-/* pos 03c1: 571 */    0xE5 /* 'e' -> */,
-/* pos 03c2: 572 */    0xBA /* ':' -> */,
-/* pos 03c3: 573 */    0x00, 0x46                  /* - terminal marker 70 - */,
-/* pos 03c5: 574 */    0xF4 /* 't' -> */,
-/* pos 03c6: 575 */    0xE3 /* 'c' -> */,
-/* pos 03c7: 576 */    0xE8 /* 'h' -> */,
-/* pos 03c8: 577 */    0x00, 0x3F                  /* - terminal marker 63 - */,
-/* pos 03ca: 578 */    0xF4 /* 't' -> */,
-/* pos 03cb: 579 */    0x00, 0x40                  /* - terminal marker 64 - */,
-/* pos 03cd: 580 */    0xEC /* 'l' -> */,
-/* pos 03ce: 581 */    0xE5 /* 'e' -> */,
-/* pos 03cf: 582 */    0xF4 /* 't' -> */,
-/* pos 03d0: 583 */    0xE5 /* 'e' -> */,
-/* pos 03d1: 584 */    0x00, 0x41                  /* - terminal marker 65 - */,
-/* pos 03d3: 585 */    0x00, 0x43                  /* - terminal marker 67 - */,
-/* pos 03d5: 586 */    0xE5 /* 'e' -> */,
-/* pos 03d6: 587 */    0xE1 /* 'a' -> */,
-/* pos 03d7: 588 */    0xEC /* 'l' -> */,
-/* pos 03d8: 589 */    0xAD /* '-' -> */,
-/* pos 03d9: 590 */    0xE9 /* 'i' -> */,
-/* pos 03da: 591 */    0xF0 /* 'p' -> */,
-/* pos 03db: 592 */    0xBA /* ':' -> */,
-/* pos 03dc: 593 */    0x00, 0x44                  /* - terminal marker 68 - */,
-/* pos 03de: 594 */    0xBA /* ':' -> */,
-/* pos 03df: 595 */    0x00, 0x4C                  /* - terminal marker 76 - */,
-/* pos 03e1: 596 */    0xEC /* 'l' -> */,
-/* pos 03e2: 597 */    0xE1 /* 'a' -> */,
-/* pos 03e3: 598 */    0xF9 /* 'y' -> */,
-/* pos 03e4: 599 */    0xAD /* '-' -> */,
-/* pos 03e5: 600 */    0xEE /* 'n' -> */,
-/* pos 03e6: 601 */    0xEF /* 'o' -> */,
-/* pos 03e7: 602 */    0xEE /* 'n' -> */,
-/* pos 03e8: 603 */    0xE3 /* 'c' -> */,
-/* pos 03e9: 604 */    0xE5 /* 'e' -> */,
-/* pos 03ea: 605 */    0xBA /* ':' -> */,
-/* pos 03eb: 606 */    0x00, 0x4D                  /* - terminal marker 77 - */,
-/* pos 03ed: 607 */    0xAD /* '-' -> */,
-/* pos 03ee: 608 */    0xF7 /* 'w' -> */,
-/* pos 03ef: 609 */    0xE5 /* 'e' -> */,
-/* pos 03f0: 610 */    0xE2 /* 'b' -> */,
-/* pos 03f1: 611 */    0xF3 /* 's' -> */,
-/* pos 03f2: 612 */    0xEF /* 'o' -> */,
-/* pos 03f3: 613 */    0xE3 /* 'c' -> */,
-/* pos 03f4: 614 */    0xEB /* 'k' -> */,
-/* pos 03f5: 615 */    0xE5 /* 'e' -> */,
-/* pos 03f6: 616 */    0xF4 /* 't' -> */,
-/* pos 03f7: 617 */    0xAD /* '-' -> */,
-/* pos 03f8: 618 */    0x64 /* 'd' */, 0x19, 0x00  /* (to 0x0411 state 619) */,
-                       0x65 /* 'e' */, 0x1D, 0x00  /* (to 0x0418 state 625) */,
-                       0x6B /* 'k' */, 0x26, 0x00  /* (to 0x0424 state 636) */,
-                       0x70 /* 'p' */, 0x35, 0x00  /* (to 0x0436 state 643) */,
-                       0x61 /* 'a' */, 0x3C, 0x00  /* (to 0x0440 state 652) */,
-                       0x6E /* 'n' */, 0x41, 0x00  /* (to 0x0448 state 659) */,
-                       0x76 /* 'v' */, 0x47, 0x00  /* (to 0x0451 state 666) */,
-                       0x6F /* 'o' */, 0x4D, 0x00  /* (to 0x045A state 674) */,
-                       0x08, /* fail */
-/* pos 0411: 619 */    0xF2 /* 'r' -> */,
-/* pos 0412: 620 */    0xE1 /* 'a' -> */,
-/* pos 0413: 621 */    0xE6 /* 'f' -> */,
-/* pos 0414: 622 */    0xF4 /* 't' -> */,
-/* pos 0415: 623 */    0xBA /* ':' -> */,
-/* pos 0416: 624 */    0x00, 0x06                  /* - terminal marker  6 - */,
-/* pos 0418: 625 */    0xF8 /* 'x' -> */,
-/* pos 0419: 626 */    0xF4 /* 't' -> */,
-/* pos 041a: 627 */    0xE5 /* 'e' -> */,
-/* pos 041b: 628 */    0xEE /* 'n' -> */,
-/* pos 041c: 629 */    0xF3 /* 's' -> */,
-/* pos 041d: 630 */    0xE9 /* 'i' -> */,
-/* pos 041e: 631 */    0xEF /* 'o' -> */,
-/* pos 041f: 632 */    0xEE /* 'n' -> */,
-/* pos 0420: 633 */    0xF3 /* 's' -> */,
-/* pos 0421: 634 */    0xBA /* ':' -> */,
-/* pos 0422: 635 */    0x00, 0x08                  /* - terminal marker  8 - */,
-/* pos 0424: 636 */    0xE5 /* 'e' -> */,
-/* pos 0425: 637 */    0xF9 /* 'y' -> */,
-/* pos 0426: 638 */    0x31 /* '1' */, 0x0A, 0x00  /* (to 0x0430 state 639) */,
-                       0x32 /* '2' */, 0x0A, 0x00  /* (to 0x0433 state 641) */,
-                       0x3A /* ':' */, 0x23, 0x00  /* (to 0x044F state 665) */,
-                       0x08, /* fail */
-/* pos 0430: 639 */    0xBA /* ':' -> */,
-/* pos 0431: 640 */    0x00, 0x09                  /* - terminal marker  9 - */,
-/* pos 0433: 641 */    0xBA /* ':' -> */,
-/* pos 0434: 642 */    0x00, 0x0A                  /* - terminal marker 10 - */,
-/* pos 0436: 643 */    0xF2 /* 'r' -> */,
-/* pos 0437: 644 */    0xEF /* 'o' -> */,
-/* pos 0438: 645 */    0xF4 /* 't' -> */,
-/* pos 0439: 646 */    0xEF /* 'o' -> */,
-/* pos 043a: 647 */    0xE3 /* 'c' -> */,
-/* pos 043b: 648 */    0xEF /* 'o' -> */,
-/* pos 043c: 649 */    0xEC /* 'l' -> */,
-/* pos 043d: 650 */    0xBA /* ':' -> */,
-/* pos 043e: 651 */    0x00, 0x0B                  /* - terminal marker 11 - */,
-/* pos 0440: 652 */    0xE3 /* 'c' -> */,
-/* pos 0441: 653 */    0xE3 /* 'c' -> */,
-/* pos 0442: 654 */    0xE5 /* 'e' -> */,
-/* pos 0443: 655 */    0xF0 /* 'p' -> */,
-/* pos 0444: 656 */    0xF4 /* 't' -> */,
-/* pos 0445: 657 */    0xBA /* ':' -> */,
-/* pos 0446: 658 */    0x00, 0x0C                  /* - terminal marker 12 - */,
-/* pos 0448: 659 */    0xEF /* 'o' -> */,
-/* pos 0449: 660 */    0xEE /* 'n' -> */,
-/* pos 044a: 661 */    0xE3 /* 'c' -> */,
-/* pos 044b: 662 */    0xE5 /* 'e' -> */,
-/* pos 044c: 663 */    0xBA /* ':' -> */,
-/* pos 044d: 664 */    0x00, 0x0D                  /* - terminal marker 13 - */,
-/* pos 044f: 665 */    0x00, 0x1E                  /* - terminal marker 30 - */,
-/* pos 0451: 666 */    0xE5 /* 'e' -> */,
-/* pos 0452: 667 */    0xF2 /* 'r' -> */,
-/* pos 0453: 668 */    0xF3 /* 's' -> */,
-/* pos 0454: 669 */    0xE9 /* 'i' -> */,
-/* pos 0455: 670 */    0xEF /* 'o' -> */,
-/* pos 0456: 671 */    0xEE /* 'n' -> */,
-/* pos 0457: 672 */    0xBA /* ':' -> */,
-/* pos 0458: 673 */    0x00, 0x1F                  /* - terminal marker 31 - */,
-/* pos 045a: 674 */    0xF2 /* 'r' -> */,
-/* pos 045b: 675 */    0xE9 /* 'i' -> */,
-/* pos 045c: 676 */    0xE7 /* 'g' -> */,
-/* pos 045d: 677 */    0xE9 /* 'i' -> */,
-/* pos 045e: 678 */    0xEE /* 'n' -> */,
-/* pos 045f: 679 */    0xBA /* ':' -> */,
-/* pos 0460: 680 */    0x00, 0x20                  /* - terminal marker 32 - */,
-/* pos 0462: 681 */    0xAD /* '-' -> */,
-/* pos 0463: 682 */    0xF3 /* 's' -> */,
-/* pos 0464: 683 */    0xE5 /* 'e' -> */,
-/* pos 0465: 684 */    0xF4 /* 't' -> */,
-/* pos 0466: 685 */    0xF4 /* 't' -> */,
-/* pos 0467: 686 */    0xE9 /* 'i' -> */,
-/* pos 0468: 687 */    0xEE /* 'n' -> */,
-/* pos 0469: 688 */    0xE7 /* 'g' -> */,
-/* pos 046a: 689 */    0xF3 /* 's' -> */,
-/* pos 046b: 690 */    0xBA /* ':' -> */,
-/* pos 046c: 691 */    0x00, 0x0F                  /* - terminal marker 15 - */,
-/* pos 046e: 692 */    0x61 /* 'a' */, 0x0D, 0x00  /* (to 0x047B state 693) */,
-                       0x6D /* 'm' */, 0x14, 0x00  /* (to 0x0485 state 702) */,
-                       0x70 /* 'p' */, 0x18, 0x00  /* (to 0x048C state 708) */,
-                       0x73 /* 's' */, 0x20, 0x00  /* (to 0x0497 state 712) */,
-                       0x08, /* fail */
-/* pos 047b: 693 */    0xF5 /* 'u' -> */,
-/* pos 047c: 694 */    0xF4 /* 't' -> */,
-/* pos 047d: 695 */    0xE8 /* 'h' -> */,
-/* pos 047e: 696 */    0xEF /* 'o' -> */,
-/* pos 047f: 697 */    0xF2 /* 'r' -> */,
-/* pos 0480: 698 */    0xE9 /* 'i' -> */,
-/* pos 0481: 699 */    0xF4 /* 't' -> */,
-/* pos 0482: 700 */    0xF9 /* 'y' -> */,
-/* pos 0483: 701 */    0x00, 0x21                  /* - terminal marker 33 - */,
-/* pos 0485: 702 */    0xE5 /* 'e' -> */,
-/* pos 0486: 703 */    0xF4 /* 't' -> */,
-/* pos 0487: 704 */    0xE8 /* 'h' -> */,
-/* pos 0488: 705 */    0xEF /* 'o' -> */,
-/* pos 0489: 706 */    0xE4 /* 'd' -> */,
-/* pos 048a: 707 */    0x00, 0x22                  /* - terminal marker 34 - */,
-/* pos 048c: 708 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0493 state 709) */,
-                       0x72 /* 'r' */, 0x1B, 0x00  /* (to 0x04AA state 723) */,
-                       0x08, /* fail */
-/* pos 0493: 709 */    0xF4 /* 't' -> */,
-/* pos 0494: 710 */    0xE8 /* 'h' -> */,
-/* pos 0495: 711 */    0x00, 0x23                  /* - terminal marker 35 - */,
-/* pos 0497: 712 */    0x63 /* 'c' */, 0x07, 0x00  /* (to 0x049E state 713) */,
-                       0x74 /* 't' */, 0x0A, 0x00  /* (to 0x04A4 state 718) */,
-                       0x08, /* fail */
-/* pos 049e: 713 */    0xE8 /* 'h' -> */,
-/* pos 049f: 714 */    0xE5 /* 'e' -> */,
-/* pos 04a0: 715 */    0xED /* 'm' -> */,
-/* pos 04a1: 716 */    0xE5 /* 'e' -> */,
-/* pos 04a2: 717 */    0x00, 0x24                  /* - terminal marker 36 - */,
-/* pos 04a4: 718 */    0xE1 /* 'a' -> */,
-/* pos 04a5: 719 */    0xF4 /* 't' -> */,
-/* pos 04a6: 720 */    0xF5 /* 'u' -> */,
-/* pos 04a7: 721 */    0xF3 /* 's' -> */,
-/* pos 04a8: 722 */    0x00, 0x25                  /* - terminal marker 37 - */,
-/* pos 04aa: 723 */    0xEF /* 'o' -> */,
-/* pos 04ab: 724 */    0xF4 /* 't' -> */,
-/* pos 04ac: 725 */    0xEF /* 'o' -> */,
-/* pos 04ad: 726 */    0xE3 /* 'c' -> */,
-/* pos 04ae: 727 */    0xEF /* 'o' -> */,
-/* pos 04af: 728 */    0xEC /* 'l' -> */,
-/* pos 04b0: 729 */    0x00, 0x4E                  /* - terminal marker 78 - */,
-/* total size 1202 bytes */
+/* pos 0134: 106 */    0x61 /* 'a' */, 0x0A, 0x00  /* (to 0x013E state 107) */,
+                       0x6F /* 'o' */, 0x21, 0x02  /* (to 0x0358 state 487) */,
+                       0x69 /* 'i' */, 0x7B, 0x03  /* (to 0x04B5 state 730) */,
+                       0x08, /* fail */
+/* pos 013e: 107 */    0xE7 /* 'g' -> */,
+/* pos 013f: 108 */    0xED /* 'm' -> */,
+/* pos 0140: 109 */    0xE1 /* 'a' -> */,
+/* pos 0141: 110 */    0xBA /* ':' -> */,
+/* pos 0142: 111 */    0x00, 0x15                  /* - terminal marker 21 - */,
+/* pos 0144: 112 */    0xE3 /* 'c' -> */,
+/* pos 0145: 113 */    0xE8 /* 'h' -> */,
+/* pos 0146: 114 */    0xE5 /* 'e' -> */,
+/* pos 0147: 115 */    0xAD /* '-' -> */,
+/* pos 0148: 116 */    0xE3 /* 'c' -> */,
+/* pos 0149: 117 */    0xEF /* 'o' -> */,
+/* pos 014a: 118 */    0xEE /* 'n' -> */,
+/* pos 014b: 119 */    0xF4 /* 't' -> */,
+/* pos 014c: 120 */    0xF2 /* 'r' -> */,
+/* pos 014d: 121 */    0xEF /* 'o' -> */,
+/* pos 014e: 122 */    0xEC /* 'l' -> */,
+/* pos 014f: 123 */    0xBA /* ':' -> */,
+/* pos 0150: 124 */    0x00, 0x16                  /* - terminal marker 22 - */,
+/* pos 0152: 125 */    0xF4 /* 't' -> */,
+/* pos 0153: 126 */    0xE8 /* 'h' -> */,
+/* pos 0154: 127 */    0xEF /* 'o' -> */,
+/* pos 0155: 128 */    0xF2 /* 'r' -> */,
+/* pos 0156: 129 */    0xE9 /* 'i' -> */,
+/* pos 0157: 130 */    0xFA /* 'z' -> */,
+/* pos 0158: 131 */    0xE1 /* 'a' -> */,
+/* pos 0159: 132 */    0xF4 /* 't' -> */,
+/* pos 015a: 133 */    0xE9 /* 'i' -> */,
+/* pos 015b: 134 */    0xEF /* 'o' -> */,
+/* pos 015c: 135 */    0xEE /* 'n' -> */,
+/* pos 015d: 136 */    0xBA /* ':' -> */,
+/* pos 015e: 137 */    0x00, 0x17                  /* - terminal marker 23 - */,
+/* pos 0160: 138 */    0xEB /* 'k' -> */,
+/* pos 0161: 139 */    0xE9 /* 'i' -> */,
+/* pos 0162: 140 */    0xE5 /* 'e' -> */,
+/* pos 0163: 141 */    0xBA /* ':' -> */,
+/* pos 0164: 142 */    0x00, 0x18                  /* - terminal marker 24 - */,
+/* pos 0166: 143 */    0xE5 /* 'e' -> */,
+/* pos 0167: 144 */    0xEE /* 'n' -> */,
+/* pos 0168: 145 */    0xF4 /* 't' -> */,
+/* pos 0169: 146 */    0xAD /* '-' -> */,
+/* pos 016a: 147 */    0x6C /* 'l' */, 0x10, 0x00  /* (to 0x017A state 148) */,
+                       0x74 /* 't' */, 0x1E, 0x00  /* (to 0x018B state 155) */,
+                       0x64 /* 'd' */, 0x4C, 0x00  /* (to 0x01BC state 186) */,
+                       0x65 /* 'e' */, 0x56, 0x00  /* (to 0x01C9 state 198) */,
+                       0x72 /* 'r' */, 0x6F, 0x00  /* (to 0x01E5 state 223) */,
+                       0x08, /* fail */
+/* pos 017a: 148 */    0x65 /* 'e' */, 0x0A, 0x00  /* (to 0x0184 state 149) */,
+                       0x61 /* 'a' */, 0x56, 0x00  /* (to 0x01D3 state 207) */,
+                       0x6F /* 'o' */, 0x5C, 0x00  /* (to 0x01DC state 215) */,
+                       0x08, /* fail */
+/* pos 0184: 149 */    0xEE /* 'n' -> */,
+/* pos 0185: 150 */    0xE7 /* 'g' -> */,
+/* pos 0186: 151 */    0xF4 /* 't' -> */,
+/* pos 0187: 152 */    0xE8 /* 'h' -> */,
+/* pos 0188: 153 */    0xBA /* ':' -> */,
+/* pos 0189: 154 */    0x00, 0x19                  /* - terminal marker 25 - */,
+/* pos 018b: 155 */    0xF9 /* 'y' -> */,
+/* pos 018c: 156 */    0xF0 /* 'p' -> */,
+/* pos 018d: 157 */    0xE5 /* 'e' -> */,
+/* pos 018e: 158 */    0xBA /* ':' -> */,
+/* pos 018f: 159 */    0x00, 0x1A                  /* - terminal marker 26 - */,
+/* pos 0191: 160 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0198 state 161) */,
+                       0x65 /* 'e' */, 0x3C, 0x02  /* (to 0x03D0 state 580) */,
+                       0x08, /* fail */
+/* pos 0198: 161 */    0xF4 /* 't' -> */,
+/* pos 0199: 162 */    0xE5 /* 'e' -> */,
+/* pos 019a: 163 */    0xBA /* ':' -> */,
+/* pos 019b: 164 */    0x00, 0x1B                  /* - terminal marker 27 - */,
+/* pos 019d: 165 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x01A4 state 166) */,
+                       0x65 /* 'e' */, 0xB6, 0x00  /* (to 0x0256 state 304) */,
+                       0x08, /* fail */
+/* pos 01a4: 166 */    0xEE /* 'n' -> */,
+/* pos 01a5: 167 */    0xE7 /* 'g' -> */,
+/* pos 01a6: 168 */    0xE5 /* 'e' -> */,
+/* pos 01a7: 169 */    0xBA /* ':' -> */,
+/* pos 01a8: 170 */    0x00, 0x1C                  /* - terminal marker 28 - */,
+/* pos 01aa: 171 */    0xE1 /* 'a' -> */,
+/* pos 01ab: 172 */    0xEE /* 'n' -> */,
+/* pos 01ac: 173 */    0xE7 /* 'g' -> */,
+/* pos 01ad: 174 */    0xE5 /* 'e' -> */,
+/* pos 01ae: 175 */    0xF3 /* 's' -> */,
+/* pos 01af: 176 */    0xBA /* ':' -> */,
+/* pos 01b0: 177 */    0x00, 0x27                  /* - terminal marker 39 - */,
+/* pos 01b2: 178 */    0xE5 /* 'e' -> */,
+/* pos 01b3: 179 */    0xBA /* ':' -> */,
+/* pos 01b4: 180 */    0x00, 0x29                  /* - terminal marker 41 - */,
+/* pos 01b6: 181 */    0xEC /* 'l' -> */,
+/* pos 01b7: 182 */    0xEF /* 'o' -> */,
+/* pos 01b8: 183 */    0xF7 /* 'w' -> */,
+/* pos 01b9: 184 */    0xBA /* ':' -> */,
+/* pos 01ba: 185 */    0x00, 0x2A                  /* - terminal marker 42 - */,
+/* pos 01bc: 186 */    0xE9 /* 'i' -> */,
+/* pos 01bd: 187 */    0xF3 /* 's' -> */,
+/* pos 01be: 188 */    0xF0 /* 'p' -> */,
+/* pos 01bf: 189 */    0xEF /* 'o' -> */,
+/* pos 01c0: 190 */    0xF3 /* 's' -> */,
+/* pos 01c1: 191 */    0xE9 /* 'i' -> */,
+/* pos 01c2: 192 */    0xF4 /* 't' -> */,
+/* pos 01c3: 193 */    0xE9 /* 'i' -> */,
+/* pos 01c4: 194 */    0xEF /* 'o' -> */,
+/* pos 01c5: 195 */    0xEE /* 'n' -> */,
+/* pos 01c6: 196 */    0xBA /* ':' -> */,
+/* pos 01c7: 197 */    0x00, 0x2B                  /* - terminal marker 43 - */,
+/* pos 01c9: 198 */    0xEE /* 'n' -> */,
+/* pos 01ca: 199 */    0xE3 /* 'c' -> */,
+/* pos 01cb: 200 */    0xEF /* 'o' -> */,
+/* pos 01cc: 201 */    0xE4 /* 'd' -> */,
+/* pos 01cd: 202 */    0xE9 /* 'i' -> */,
+/* pos 01ce: 203 */    0xEE /* 'n' -> */,
+/* pos 01cf: 204 */    0xE7 /* 'g' -> */,
+/* pos 01d0: 205 */    0xBA /* ':' -> */,
+/* pos 01d1: 206 */    0x00, 0x2C                  /* - terminal marker 44 - */,
+/* pos 01d3: 207 */    0xEE /* 'n' -> */,
+/* pos 01d4: 208 */    0xE7 /* 'g' -> */,
+/* pos 01d5: 209 */    0xF5 /* 'u' -> */,
+/* pos 01d6: 210 */    0xE1 /* 'a' -> */,
+/* pos 01d7: 211 */    0xE7 /* 'g' -> */,
+/* pos 01d8: 212 */    0xE5 /* 'e' -> */,
+/* pos 01d9: 213 */    0xBA /* ':' -> */,
+/* pos 01da: 214 */    0x00, 0x2D                  /* - terminal marker 45 - */,
+/* pos 01dc: 215 */    0xE3 /* 'c' -> */,
+/* pos 01dd: 216 */    0xE1 /* 'a' -> */,
+/* pos 01de: 217 */    0xF4 /* 't' -> */,
+/* pos 01df: 218 */    0xE9 /* 'i' -> */,
+/* pos 01e0: 219 */    0xEF /* 'o' -> */,
+/* pos 01e1: 220 */    0xEE /* 'n' -> */,
+/* pos 01e2: 221 */    0xBA /* ':' -> */,
+/* pos 01e3: 222 */    0x00, 0x2E                  /* - terminal marker 46 - */,
+/* pos 01e5: 223 */    0xE1 /* 'a' -> */,
+/* pos 01e6: 224 */    0xEE /* 'n' -> */,
+/* pos 01e7: 225 */    0xE7 /* 'g' -> */,
+/* pos 01e8: 226 */    0xE5 /* 'e' -> */,
+/* pos 01e9: 227 */    0xBA /* ':' -> */,
+/* pos 01ea: 228 */    0x00, 0x2F                  /* - terminal marker 47 - */,
+/* pos 01ec: 229 */    0x74 /* 't' */, 0x07, 0x00  /* (to 0x01F3 state 230) */,
+                       0x78 /* 'x' */, 0x09, 0x00  /* (to 0x01F8 state 234) */,
+                       0x08, /* fail */
+/* pos 01f3: 230 */    0xE1 /* 'a' -> */,
+/* pos 01f4: 231 */    0xE7 /* 'g' -> */,
+/* pos 01f5: 232 */    0xBA /* ':' -> */,
+/* pos 01f6: 233 */    0x00, 0x30                  /* - terminal marker 48 - */,
+/* pos 01f8: 234 */    0xF0 /* 'p' -> */,
+/* pos 01f9: 235 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x0200 state 236) */,
+                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x0205 state 240) */,
+                       0x08, /* fail */
+/* pos 0200: 236 */    0xE3 /* 'c' -> */,
+/* pos 0201: 237 */    0xF4 /* 't' -> */,
+/* pos 0202: 238 */    0xBA /* ':' -> */,
+/* pos 0203: 239 */    0x00, 0x31                  /* - terminal marker 49 - */,
+/* pos 0205: 240 */    0xF2 /* 'r' -> */,
+/* pos 0206: 241 */    0xE5 /* 'e' -> */,
+/* pos 0207: 242 */    0xF3 /* 's' -> */,
+/* pos 0208: 243 */    0xBA /* ':' -> */,
+/* pos 0209: 244 */    0x00, 0x32                  /* - terminal marker 50 - */,
+/* pos 020b: 245 */    0xF2 /* 'r' -> */,
+/* pos 020c: 246 */    0xEF /* 'o' -> */,
+/* pos 020d: 247 */    0xED /* 'm' -> */,
+/* pos 020e: 248 */    0xBA /* ':' -> */,
+/* pos 020f: 249 */    0x00, 0x33                  /* - terminal marker 51 - */,
+/* pos 0211: 250 */    0xF4 /* 't' -> */,
+/* pos 0212: 251 */    0xE3 /* 'c' -> */,
+/* pos 0213: 252 */    0xE8 /* 'h' -> */,
+/* pos 0214: 253 */    0xBA /* ':' -> */,
+/* pos 0215: 254 */    0x00, 0x34                  /* - terminal marker 52 - */,
+/* pos 0217: 255 */    0xE1 /* 'a' -> */,
+/* pos 0218: 256 */    0xEE /* 'n' -> */,
+/* pos 0219: 257 */    0xE7 /* 'g' -> */,
+/* pos 021a: 258 */    0xE5 /* 'e' -> */,
+/* pos 021b: 259 */    0xBA /* ':' -> */,
+/* pos 021c: 260 */    0x00, 0x35                  /* - terminal marker 53 - */,
+/* pos 021e: 261 */    0xEE /* 'n' -> */,
+/* pos 021f: 262 */    0xED /* 'm' -> */,
+/* pos 0220: 263 */    0xEF /* 'o' -> */,
+/* pos 0221: 264 */    0xE4 /* 'd' -> */,
+/* pos 0222: 265 */    0xE9 /* 'i' -> */,
+/* pos 0223: 266 */    0xE6 /* 'f' -> */,
+/* pos 0224: 267 */    0xE9 /* 'i' -> */,
+/* pos 0225: 268 */    0xE5 /* 'e' -> */,
+/* pos 0226: 269 */    0xE4 /* 'd' -> */,
+/* pos 0227: 270 */    0xAD /* '-' -> */,
+/* pos 0228: 271 */    0xF3 /* 's' -> */,
+/* pos 0229: 272 */    0xE9 /* 'i' -> */,
+/* pos 022a: 273 */    0xEE /* 'n' -> */,
+/* pos 022b: 274 */    0xE3 /* 'c' -> */,
+/* pos 022c: 275 */    0xE5 /* 'e' -> */,
+/* pos 022d: 276 */    0xBA /* ':' -> */,
+/* pos 022e: 277 */    0x00, 0x36                  /* - terminal marker 54 - */,
+/* pos 0230: 278 */    0x61 /* 'a' */, 0x0A, 0x00  /* (to 0x023A state 279) */,
+                       0x69 /* 'i' */, 0x15, 0x00  /* (to 0x0248 state 292) */,
+                       0x6F /* 'o' */, 0x17, 0x00  /* (to 0x024D state 296) */,
+                       0x08, /* fail */
+/* pos 023a: 279 */    0xF3 /* 's' -> */,
+/* pos 023b: 280 */    0xF4 /* 't' -> */,
+/* pos 023c: 281 */    0xAD /* '-' -> */,
+/* pos 023d: 282 */    0xED /* 'm' -> */,
+/* pos 023e: 283 */    0xEF /* 'o' -> */,
+/* pos 023f: 284 */    0xE4 /* 'd' -> */,
+/* pos 0240: 285 */    0xE9 /* 'i' -> */,
+/* pos 0241: 286 */    0xE6 /* 'f' -> */,
+/* pos 0242: 287 */    0xE9 /* 'i' -> */,
+/* pos 0243: 288 */    0xE5 /* 'e' -> */,
+/* pos 0244: 289 */    0xE4 /* 'd' -> */,
+/* pos 0245: 290 */    0xBA /* ':' -> */,
+/* pos 0246: 291 */    0x00, 0x37                  /* - terminal marker 55 - */,
+/* pos 0248: 292 */    0xEE /* 'n' -> */,
+/* pos 0249: 293 */    0xEB /* 'k' -> */,
+/* pos 024a: 294 */    0xBA /* ':' -> */,
+/* pos 024b: 295 */    0x00, 0x38                  /* - terminal marker 56 - */,
+/* pos 024d: 296 */    0xE3 /* 'c' -> */,
+/* pos 024e: 297 */    0xE1 /* 'a' -> */,
+/* pos 024f: 298 */    0xF4 /* 't' -> */,
+/* pos 0250: 299 */    0xE9 /* 'i' -> */,
+/* pos 0251: 300 */    0xEF /* 'o' -> */,
+/* pos 0252: 301 */    0xEE /* 'n' -> */,
+/* pos 0253: 302 */    0xBA /* ':' -> */,
+/* pos 0254: 303 */    0x00, 0x39                  /* - terminal marker 57 - */,
+/* pos 0256: 304 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x0260 state 305) */,
+                       0x74 /* 't' */, 0x14, 0x00  /* (to 0x026D state 311) */,
+                       0x70 /* 'p' */, 0x88, 0x01  /* (to 0x03E4 state 596) */,
+                       0x08, /* fail */
+/* pos 0260: 305 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x0267 state 306) */,
+                       0x65 /* 'e' */, 0xCA, 0x00  /* (to 0x032D state 448) */,
+                       0x08, /* fail */
+/* pos 0267: 306 */    0xE5 /* 'e' -> */,
+/* pos 0268: 307 */    0xF3 /* 's' -> */,
+/* pos 0269: 308 */    0xE8 /* 'h' -> */,
+/* pos 026a: 309 */    0xBA /* ':' -> */,
+/* pos 026b: 310 */    0x00, 0x3D                  /* - terminal marker 61 - */,
+/* pos 026d: 311 */    0xF2 /* 'r' -> */,
+/* pos 026e: 312 */    0xF9 /* 'y' -> */,
+/* pos 026f: 313 */    0xAD /* '-' -> */,
+/* pos 0270: 314 */    0xE1 /* 'a' -> */,
+/* pos 0271: 315 */    0xE6 /* 'f' -> */,
+/* pos 0272: 316 */    0xF4 /* 't' -> */,
+/* pos 0273: 317 */    0xE5 /* 'e' -> */,
+/* pos 0274: 318 */    0xF2 /* 'r' -> */,
+/* pos 0275: 319 */    0xBA /* ':' -> */,
+/* pos 0276: 320 */    0x00, 0x3E                  /* - terminal marker 62 - */,
+/* pos 0278: 321 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x027F state 322) */,
+                       0x74 /* 't' */, 0x06, 0x01  /* (to 0x0381 state 514) */,
+                       0x08, /* fail */
+/* pos 027f: 322 */    0x72 /* 'r' */, 0x0A, 0x00  /* (to 0x0289 state 323) */,
+                       0x74 /* 't' */, 0x0D, 0x00  /* (to 0x028F state 328) */,
+                       0x63 /* 'c' */, 0x6B, 0x01  /* (to 0x03F0 state 607) */,
+                       0x08, /* fail */
+/* pos 0289: 323 */    0xF6 /* 'v' -> */,
+/* pos 028a: 324 */    0xE5 /* 'e' -> */,
+/* pos 028b: 325 */    0xF2 /* 'r' -> */,
+/* pos 028c: 326 */    0xBA /* ':' -> */,
+/* pos 028d: 327 */    0x00, 0x3F                  /* - terminal marker 63 - */,
+/* pos 028f: 328 */    0xAD /* '-' -> */,
+/* pos 0290: 329 */    0xE3 /* 'c' -> */,
+/* pos 0291: 330 */    0xEF /* 'o' -> */,
+/* pos 0292: 331 */    0xEF /* 'o' -> */,
+/* pos 0293: 332 */    0xEB /* 'k' -> */,
+/* pos 0294: 333 */    0xE9 /* 'i' -> */,
+/* pos 0295: 334 */    0xE5 /* 'e' -> */,
+/* pos 0296: 335 */    0xBA /* ':' -> */,
+/* pos 0297: 336 */    0x00, 0x40                  /* - terminal marker 64 - */,
+/* pos 0299: 337 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x02A0 state 338) */,
+                       0x65 /* 'e' */, 0x45, 0x01  /* (to 0x03E1 state 594) */,
+                       0x08, /* fail */
+/* pos 02a0: 338 */    0xE1 /* 'a' -> */,
+/* pos 02a1: 339 */    0xEE /* 'n' -> */,
+/* pos 02a2: 340 */    0xF3 /* 's' -> */,
+/* pos 02a3: 341 */    0xE6 /* 'f' -> */,
+/* pos 02a4: 342 */    0xE5 /* 'e' -> */,
+/* pos 02a5: 343 */    0xF2 /* 'r' -> */,
+/* pos 02a6: 344 */    0xAD /* '-' -> */,
+/* pos 02a7: 345 */    0xE5 /* 'e' -> */,
+/* pos 02a8: 346 */    0xEE /* 'n' -> */,
+/* pos 02a9: 347 */    0xE3 /* 'c' -> */,
+/* pos 02aa: 348 */    0xEF /* 'o' -> */,
+/* pos 02ab: 349 */    0xE4 /* 'd' -> */,
+/* pos 02ac: 350 */    0xE9 /* 'i' -> */,
+/* pos 02ad: 351 */    0xEE /* 'n' -> */,
+/* pos 02ae: 352 */    0xE7 /* 'g' -> */,
+/* pos 02af: 353 */    0xBA /* ':' -> */,
+/* pos 02b0: 354 */    0x00, 0x42                  /* - terminal marker 66 - */,
+/* pos 02b2: 355 */    0xE9 /* 'i' -> */,
+/* pos 02b3: 356 */    0xAD /* '-' -> */,
+/* pos 02b4: 357 */    0xE1 /* 'a' -> */,
+/* pos 02b5: 358 */    0xF2 /* 'r' -> */,
+/* pos 02b6: 359 */    0xE7 /* 'g' -> */,
+/* pos 02b7: 360 */    0xF3 /* 's' -> */,
+/* pos 02b8: 361 */    0x00, 0x47                  /* - terminal marker 71 - */,
+/* pos 02ba: 362 */    0xA0 /* ' ' -> */,
+/* pos 02bb: 363 */    0x00, 0x48                  /* - terminal marker 72 - */,
+/* pos 02bd: 364 */    0xAD /* '-' -> */,
+/* pos 02be: 365 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x02C8 state 366) */,
+                       0x61 /* 'a' */, 0x1D, 0x00  /* (to 0x02DE state 385) */,
+                       0x72 /* 'r' */, 0x14, 0x01  /* (to 0x03D8 state 586) */,
+                       0x08, /* fail */
+/* pos 02c8: 366 */    0xEF /* 'o' -> */,
+/* pos 02c9: 367 */    0xF2 /* 'r' -> */,
+/* pos 02ca: 368 */    0xF7 /* 'w' -> */,
+/* pos 02cb: 369 */    0xE1 /* 'a' -> */,
+/* pos 02cc: 370 */    0xF2 /* 'r' -> */,
+/* pos 02cd: 371 */    0xE4 /* 'd' -> */,
+/* pos 02ce: 372 */    0xE5 /* 'e' -> */,
+/* pos 02cf: 373 */    0xE4 /* 'd' -> */,
+/* pos 02d0: 374 */    0xAD /* '-' -> */,
+/* pos 02d1: 375 */    0xE6 /* 'f' -> */,
+/* pos 02d2: 376 */    0xEF /* 'o' -> */,
+/* pos 02d3: 377 */    0xF2 /* 'r' -> */,
+/* pos 02d4: 378 */    0xBA /* ':' -> */,
+/* pos 02d5: 379 */    0x00, 0x49                  /* - terminal marker 73 - */,
+/* pos 02d7: 380 */    0x00, 0x4A                  /* - terminal marker 74 - */,
+/* pos 02d9: 381 */    0xE1 /* 'a' -> */,
+/* pos 02da: 382 */    0xE4 /* 'd' -> */,
+/* pos 02db: 383 */    0xA0 /* ' ' -> */,
+/* pos 02dc: 384 */    0x00, 0x4B                  /* - terminal marker 75 - */,
+/* pos 02de: 385 */    0x75 /* 'u' */, 0x07, 0x00  /* (to 0x02E5 state 386) */,
+                       0x6D /* 'm' */, 0x0F, 0x00  /* (to 0x02F0 state 396) */,
+                       0x08, /* fail */
+/* pos 02e5: 386 */    0xF4 /* 't' -> */,
+/* pos 02e6: 387 */    0xE8 /* 'h' -> */,
+/* pos 02e7: 388 */    0xAD /* '-' -> */,
+/* pos 02e8: 389 */    0xF4 /* 't' -> */,
+/* pos 02e9: 390 */    0xEF /* 'o' -> */,
+/* pos 02ea: 391 */    0xEB /* 'k' -> */,
+/* pos 02eb: 392 */    0xE5 /* 'e' -> */,
+/* pos 02ec: 393 */    0xEE /* 'n' -> */,
+/* pos 02ed: 394 */    0xBA /* ':' -> */,
+/* pos 02ee: 395 */    0x00, 0x4F                  /* - terminal marker 79 - */,
+/* pos 02f0: 396 */    0xFA /* 'z' -> */,
+/* pos 02f1: 397 */    0xEE /* 'n' -> */,
+/* pos 02f2: 398 */    0xAD /* '-' -> */,
+/* pos 02f3: 399 */    0xE4 /* 'd' -> */,
+/* pos 02f4: 400 */    0xF3 /* 's' -> */,
+/* pos 02f5: 401 */    0xF3 /* 's' -> */,
+/* pos 02f6: 402 */    0xAD /* '-' -> */,
+/* pos 02f7: 403 */    0xF3 /* 's' -> */,
+/* pos 02f8: 404 */    0xE9 /* 'i' -> */,
+/* pos 02f9: 405 */    0xE7 /* 'g' -> */,
+/* pos 02fa: 406 */    0xEE /* 'n' -> */,
+/* pos 02fb: 407 */    0xE1 /* 'a' -> */,
+/* pos 02fc: 408 */    0xF4 /* 't' -> */,
+/* pos 02fd: 409 */    0xF5 /* 'u' -> */,
+/* pos 02fe: 410 */    0xF2 /* 'r' -> */,
+/* pos 02ff: 411 */    0xE5 /* 'e' -> */,
+/* pos 0300: 412 */    0xBA /* ':' -> */,
+/* pos 0301: 413 */    0x00, 0x50                  /* - terminal marker 80 - */,
+/* pos 0303: 414 */    0xF4 /* 't' -> */,
+/* pos 0304: 415 */    0xE9 /* 'i' -> */,
+/* pos 0305: 416 */    0xEF /* 'o' -> */,
+/* pos 0306: 417 */    0xEE /* 'n' -> */,
+/* pos 0307: 418 */    0xF3 /* 's' -> */,
+/* pos 0308: 419 */    0xA0 /* ' ' -> */,
+/* pos 0309: 420 */    0x00, 0x02                  /* - terminal marker  2 - */,
+/* pos 030b: 421 */    0xF3 /* 's' -> */,
+/* pos 030c: 422 */    0xAD /* '-' -> */,
+/* pos 030d: 423 */    0xE3 /* 'c' -> */,
+/* pos 030e: 424 */    0xEF /* 'o' -> */,
+/* pos 030f: 425 */    0xEE /* 'n' -> */,
+/* pos 0310: 426 */    0xF4 /* 't' -> */,
+/* pos 0311: 427 */    0xF2 /* 'r' -> */,
+/* pos 0312: 428 */    0xEF /* 'o' -> */,
+/* pos 0313: 429 */    0xEC /* 'l' -> */,
+/* pos 0314: 430 */    0xAD /* '-' -> */,
+/* pos 0315: 431 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x031C state 432) */,
+                       0x61 /* 'a' */, 0x24, 0x00  /* (to 0x033C state 461) */,
+                       0x08, /* fail */
+/* pos 031c: 432 */    0xE5 /* 'e' -> */,
+/* pos 031d: 433 */    0xF1 /* 'q' -> */,
+/* pos 031e: 434 */    0xF5 /* 'u' -> */,
+/* pos 031f: 435 */    0xE5 /* 'e' -> */,
+/* pos 0320: 436 */    0xF3 /* 's' -> */,
+/* pos 0321: 437 */    0xF4 /* 't' -> */,
+/* pos 0322: 438 */    0xAD /* '-' -> */,
+/* pos 0323: 439 */    0xE8 /* 'h' -> */,
+/* pos 0324: 440 */    0xE5 /* 'e' -> */,
+/* pos 0325: 441 */    0xE1 /* 'a' -> */,
+/* pos 0326: 442 */    0xE4 /* 'd' -> */,
+/* pos 0327: 443 */    0xE5 /* 'e' -> */,
+/* pos 0328: 444 */    0xF2 /* 'r' -> */,
+/* pos 0329: 445 */    0xF3 /* 's' -> */,
+/* pos 032a: 446 */    0xBA /* ':' -> */,
+/* pos 032b: 447 */    0x00, 0x0B                  /* - terminal marker 11 - */,
+/* pos 032d: 448 */    0xF2 /* 'r' -> */,
+/* pos 032e: 449 */    0xE5 /* 'e' -> */,
+/* pos 032f: 450 */    0xF2 /* 'r' -> */,
+/* pos 0330: 451 */    0xBA /* ':' -> */,
+/* pos 0331: 452 */    0x00, 0x1D                  /* - terminal marker 29 - */,
+/* pos 0333: 453 */    0xE8 /* 'h' -> */,
+/* pos 0334: 454 */    0xE1 /* 'a' -> */,
+/* pos 0335: 455 */    0xF2 /* 'r' -> */,
+/* pos 0336: 456 */    0xF3 /* 's' -> */,
+/* pos 0337: 457 */    0xE5 /* 'e' -> */,
+/* pos 0338: 458 */    0xF4 /* 't' -> */,
+/* pos 0339: 459 */    0xBA /* ':' -> */,
+/* pos 033a: 460 */    0x00, 0x26                  /* - terminal marker 38 - */,
+/* pos 033c: 461 */    0xEC /* 'l' -> */,
+/* pos 033d: 462 */    0xEC /* 'l' -> */,
+/* pos 033e: 463 */    0xEF /* 'o' -> */,
+/* pos 033f: 464 */    0xF7 /* 'w' -> */,
+/* pos 0340: 465 */    0xAD /* '-' -> */,
+/* pos 0341: 466 */    0xEF /* 'o' -> */,
+/* pos 0342: 467 */    0xF2 /* 'r' -> */,
+/* pos 0343: 468 */    0xE9 /* 'i' -> */,
+/* pos 0344: 469 */    0xE7 /* 'g' -> */,
+/* pos 0345: 470 */    0xE9 /* 'i' -> */,
+/* pos 0346: 471 */    0xEE /* 'n' -> */,
+/* pos 0347: 472 */    0xBA /* ':' -> */,
+/* pos 0348: 473 */    0x00, 0x28                  /* - terminal marker 40 - */,
+/* pos 034a: 474 */    0xE1 /* 'a' -> */,
+/* pos 034b: 475 */    0xF8 /* 'x' -> */,
+/* pos 034c: 476 */    0xAD /* '-' -> */,
+/* pos 034d: 477 */    0xE6 /* 'f' -> */,
+/* pos 034e: 478 */    0xEF /* 'o' -> */,
+/* pos 034f: 479 */    0xF2 /* 'r' -> */,
+/* pos 0350: 480 */    0xF7 /* 'w' -> */,
+/* pos 0351: 481 */    0xE1 /* 'a' -> */,
+/* pos 0352: 482 */    0xF2 /* 'r' -> */,
+/* pos 0353: 483 */    0xE4 /* 'd' -> */,
+/* pos 0354: 484 */    0xF3 /* 's' -> */,
+/* pos 0355: 485 */    0xBA /* ':' -> */,
+/* pos 0356: 486 */    0x00, 0x3A                  /* - terminal marker 58 - */,
+/* pos 0358: 487 */    0xF8 /* 'x' -> */,
+/* pos 0359: 488 */    0xF9 /* 'y' -> */,
+/* pos 035a: 489 */    0x2D /* '-' */, 0x07, 0x00  /* (to 0x0361 state 490) */,
+                       0x20 /* ' ' */, 0x79, 0x00  /* (to 0x03D6 state 585) */,
+                       0x08, /* fail */
+/* pos 0361: 490 */    0xE1 /* 'a' -> */,
+/* pos 0362: 491 */    0xF5 /* 'u' -> */,
+/* pos 0363: 492 */    0xF4 /* 't' -> */,
+/* pos 0364: 493 */    0xE8 /* 'h' -> */,
+/* pos 0365: 494 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x036C state 495) */,
+                       0x6F /* 'o' */, 0x0E, 0x00  /* (to 0x0376 state 504) */,
+                       0x08, /* fail */
+/* pos 036c: 495 */    0xEE /* 'n' -> */,
+/* pos 036d: 496 */    0xF4 /* 't' -> */,
+/* pos 036e: 497 */    0xE9 /* 'i' -> */,
+/* pos 036f: 498 */    0xE3 /* 'c' -> */,
+/* pos 0370: 499 */    0xE1 /* 'a' -> */,
+/* pos 0371: 500 */    0xF4 /* 't' -> */,
+/* pos 0372: 501 */    0xE5 /* 'e' -> */,
+/* pos 0373: 502 */    0xBA /* ':' -> */,
+/* pos 0374: 503 */    0x00, 0x3B                  /* - terminal marker 59 - */,
+/* pos 0376: 504 */    0xF2 /* 'r' -> */,
+/* pos 0377: 505 */    0xE9 /* 'i' -> */,
+/* pos 0378: 506 */    0xFA /* 'z' -> */,
+/* pos 0379: 507 */    0xE1 /* 'a' -> */,
+/* pos 037a: 508 */    0xF4 /* 't' -> */,
+/* pos 037b: 509 */    0xE9 /* 'i' -> */,
+/* pos 037c: 510 */    0xEF /* 'o' -> */,
+/* pos 037d: 511 */    0xEE /* 'n' -> */,
+/* pos 037e: 512 */    0xBA /* ':' -> */,
+/* pos 037f: 513 */    0x00, 0x3C                  /* - terminal marker 60 - */,
+/* pos 0381: 514 */    0xF2 /* 'r' -> */,
+/* pos 0382: 515 */    0xE9 /* 'i' -> */,
+/* pos 0383: 516 */    0xE3 /* 'c' -> */,
+/* pos 0384: 517 */    0xF4 /* 't' -> */,
+/* pos 0385: 518 */    0xAD /* '-' -> */,
+/* pos 0386: 519 */    0xF4 /* 't' -> */,
+/* pos 0387: 520 */    0xF2 /* 'r' -> */,
+/* pos 0388: 521 */    0xE1 /* 'a' -> */,
+/* pos 0389: 522 */    0xEE /* 'n' -> */,
+/* pos 038a: 523 */    0xF3 /* 's' -> */,
+/* pos 038b: 524 */    0xF0 /* 'p' -> */,
+/* pos 038c: 525 */    0xEF /* 'o' -> */,
+/* pos 038d: 526 */    0xF2 /* 'r' -> */,
+/* pos 038e: 527 */    0xF4 /* 't' -> */,
+/* pos 038f: 528 */    0xAD /* '-' -> */,
+/* pos 0390: 529 */    0xF3 /* 's' -> */,
+/* pos 0391: 530 */    0xE5 /* 'e' -> */,
+/* pos 0392: 531 */    0xE3 /* 'c' -> */,
+/* pos 0393: 532 */    0xF5 /* 'u' -> */,
+/* pos 0394: 533 */    0xF2 /* 'r' -> */,
+/* pos 0395: 534 */    0xE9 /* 'i' -> */,
+/* pos 0396: 535 */    0xF4 /* 't' -> */,
+/* pos 0397: 536 */    0xF9 /* 'y' -> */,
+/* pos 0398: 537 */    0xBA /* ':' -> */,
+/* pos 0399: 538 */    0x00, 0x41                  /* - terminal marker 65 - */,
+/* pos 039b: 539 */    0xE5 /* 'e' -> */,
+/* pos 039c: 540 */    0xF2 /* 'r' -> */,
+/* pos 039d: 541 */    0xAD /* '-' -> */,
+/* pos 039e: 542 */    0xE1 /* 'a' -> */,
+/* pos 039f: 543 */    0xE7 /* 'g' -> */,
+/* pos 03a0: 544 */    0xE5 /* 'e' -> */,
+/* pos 03a1: 545 */    0xEE /* 'n' -> */,
+/* pos 03a2: 546 */    0xF4 /* 't' -> */,
+/* pos 03a3: 547 */    0xBA /* ':' -> */,
+/* pos 03a4: 548 */    0x00, 0x43                  /* - terminal marker 67 - */,
+/* pos 03a6: 549 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x03AD state 550) */,
+                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x03B2 state 554) */,
+                       0x08, /* fail */
+/* pos 03ad: 550 */    0xF2 /* 'r' -> */,
+/* pos 03ae: 551 */    0xF9 /* 'y' -> */,
+/* pos 03af: 552 */    0xBA /* ':' -> */,
+/* pos 03b0: 553 */    0x00, 0x44                  /* - terminal marker 68 - */,
+/* pos 03b2: 554 */    0xE1 /* 'a' -> */,
+/* pos 03b3: 555 */    0xBA /* ':' -> */,
+/* pos 03b4: 556 */    0x00, 0x45                  /* - terminal marker 69 - */,
+/* pos 03b6: 557 */    0xF7 /* 'w' -> */,
+/* pos 03b7: 558 */    0xF7 /* 'w' -> */,
+/* pos 03b8: 559 */    0xAD /* '-' -> */,
+/* pos 03b9: 560 */    0xE1 /* 'a' -> */,
+/* pos 03ba: 561 */    0xF5 /* 'u' -> */,
+/* pos 03bb: 562 */    0xF4 /* 't' -> */,
+/* pos 03bc: 563 */    0xE8 /* 'h' -> */,
+/* pos 03bd: 564 */    0xE5 /* 'e' -> */,
+/* pos 03be: 565 */    0xEE /* 'n' -> */,
+/* pos 03bf: 566 */    0xF4 /* 't' -> */,
+/* pos 03c0: 567 */    0xE9 /* 'i' -> */,
+/* pos 03c1: 568 */    0xE3 /* 'c' -> */,
+/* pos 03c2: 569 */    0xE1 /* 'a' -> */,
+/* pos 03c3: 570 */    0xF4 /* 't' -> */,
+/* pos 03c4: 571 */    0xE5 /* 'e' -> */,
+/* pos 03c5: 572 */    0xBA /* ':' -> */,
+/* pos 03c6: 573 */    0x00, 0x46                  /* - terminal marker 70 - */,
+/* pos 03c8: 574 */    0xF4 /* 't' -> */,
+/* pos 03c9: 575 */    0xE3 /* 'c' -> */,
+/* pos 03ca: 576 */    0xE8 /* 'h' -> */,
+/* pos 03cb: 577 */    0x00, 0x3F                  /* - terminal marker 63 - */,
+/* pos 03cd: 578 */    0xF4 /* 't' -> */,
+/* pos 03ce: 579 */    0x00, 0x40                  /* - terminal marker 64 - */,
+/* pos 03d0: 580 */    0xEC /* 'l' -> */,
+/* pos 03d1: 581 */    0xE5 /* 'e' -> */,
+/* pos 03d2: 582 */    0xF4 /* 't' -> */,
+/* pos 03d3: 583 */    0xE5 /* 'e' -> */,
+/* pos 03d4: 584 */    0x00, 0x41                  /* - terminal marker 65 - */,
+/* pos 03d6: 585 */    0x00, 0x43                  /* - terminal marker 67 - */,
+/* pos 03d8: 586 */    0xE5 /* 'e' -> */,
+/* pos 03d9: 587 */    0xE1 /* 'a' -> */,
+/* pos 03da: 588 */    0xEC /* 'l' -> */,
+/* pos 03db: 589 */    0xAD /* '-' -> */,
+/* pos 03dc: 590 */    0xE9 /* 'i' -> */,
+/* pos 03dd: 591 */    0xF0 /* 'p' -> */,
+/* pos 03de: 592 */    0xBA /* ':' -> */,
+/* pos 03df: 593 */    0x00, 0x44                  /* - terminal marker 68 - */,
+/* pos 03e1: 594 */    0xBA /* ':' -> */,
+/* pos 03e2: 595 */    0x00, 0x4C                  /* - terminal marker 76 - */,
+/* pos 03e4: 596 */    0xEC /* 'l' -> */,
+/* pos 03e5: 597 */    0xE1 /* 'a' -> */,
+/* pos 03e6: 598 */    0xF9 /* 'y' -> */,
+/* pos 03e7: 599 */    0xAD /* '-' -> */,
+/* pos 03e8: 600 */    0xEE /* 'n' -> */,
+/* pos 03e9: 601 */    0xEF /* 'o' -> */,
+/* pos 03ea: 602 */    0xEE /* 'n' -> */,
+/* pos 03eb: 603 */    0xE3 /* 'c' -> */,
+/* pos 03ec: 604 */    0xE5 /* 'e' -> */,
+/* pos 03ed: 605 */    0xBA /* ':' -> */,
+/* pos 03ee: 606 */    0x00, 0x4D                  /* - terminal marker 77 - */,
+/* pos 03f0: 607 */    0xAD /* '-' -> */,
+/* pos 03f1: 608 */    0xF7 /* 'w' -> */,
+/* pos 03f2: 609 */    0xE5 /* 'e' -> */,
+/* pos 03f3: 610 */    0xE2 /* 'b' -> */,
+/* pos 03f4: 611 */    0xF3 /* 's' -> */,
+/* pos 03f5: 612 */    0xEF /* 'o' -> */,
+/* pos 03f6: 613 */    0xE3 /* 'c' -> */,
+/* pos 03f7: 614 */    0xEB /* 'k' -> */,
+/* pos 03f8: 615 */    0xE5 /* 'e' -> */,
+/* pos 03f9: 616 */    0xF4 /* 't' -> */,
+/* pos 03fa: 617 */    0xAD /* '-' -> */,
+/* pos 03fb: 618 */    0x64 /* 'd' */, 0x19, 0x00  /* (to 0x0414 state 619) */,
+                       0x65 /* 'e' */, 0x1D, 0x00  /* (to 0x041B state 625) */,
+                       0x6B /* 'k' */, 0x26, 0x00  /* (to 0x0427 state 636) */,
+                       0x70 /* 'p' */, 0x35, 0x00  /* (to 0x0439 state 643) */,
+                       0x61 /* 'a' */, 0x3C, 0x00  /* (to 0x0443 state 652) */,
+                       0x6E /* 'n' */, 0x41, 0x00  /* (to 0x044B state 659) */,
+                       0x76 /* 'v' */, 0x47, 0x00  /* (to 0x0454 state 666) */,
+                       0x6F /* 'o' */, 0x4D, 0x00  /* (to 0x045D state 674) */,
+                       0x08, /* fail */
+/* pos 0414: 619 */    0xF2 /* 'r' -> */,
+/* pos 0415: 620 */    0xE1 /* 'a' -> */,
+/* pos 0416: 621 */    0xE6 /* 'f' -> */,
+/* pos 0417: 622 */    0xF4 /* 't' -> */,
+/* pos 0418: 623 */    0xBA /* ':' -> */,
+/* pos 0419: 624 */    0x00, 0x06                  /* - terminal marker  6 - */,
+/* pos 041b: 625 */    0xF8 /* 'x' -> */,
+/* pos 041c: 626 */    0xF4 /* 't' -> */,
+/* pos 041d: 627 */    0xE5 /* 'e' -> */,
+/* pos 041e: 628 */    0xEE /* 'n' -> */,
+/* pos 041f: 629 */    0xF3 /* 's' -> */,
+/* pos 0420: 630 */    0xE9 /* 'i' -> */,
+/* pos 0421: 631 */    0xEF /* 'o' -> */,
+/* pos 0422: 632 */    0xEE /* 'n' -> */,
+/* pos 0423: 633 */    0xF3 /* 's' -> */,
+/* pos 0424: 634 */    0xBA /* ':' -> */,
+/* pos 0425: 635 */    0x00, 0x08                  /* - terminal marker  8 - */,
+/* pos 0427: 636 */    0xE5 /* 'e' -> */,
+/* pos 0428: 637 */    0xF9 /* 'y' -> */,
+/* pos 0429: 638 */    0x31 /* '1' */, 0x0A, 0x00  /* (to 0x0433 state 639) */,
+                       0x32 /* '2' */, 0x0A, 0x00  /* (to 0x0436 state 641) */,
+                       0x3A /* ':' */, 0x23, 0x00  /* (to 0x0452 state 665) */,
+                       0x08, /* fail */
+/* pos 0433: 639 */    0xBA /* ':' -> */,
+/* pos 0434: 640 */    0x00, 0x09                  /* - terminal marker  9 - */,
+/* pos 0436: 641 */    0xBA /* ':' -> */,
+/* pos 0437: 642 */    0x00, 0x0A                  /* - terminal marker 10 - */,
+/* pos 0439: 643 */    0xF2 /* 'r' -> */,
+/* pos 043a: 644 */    0xEF /* 'o' -> */,
+/* pos 043b: 645 */    0xF4 /* 't' -> */,
+/* pos 043c: 646 */    0xEF /* 'o' -> */,
+/* pos 043d: 647 */    0xE3 /* 'c' -> */,
+/* pos 043e: 648 */    0xEF /* 'o' -> */,
+/* pos 043f: 649 */    0xEC /* 'l' -> */,
+/* pos 0440: 650 */    0xBA /* ':' -> */,
+/* pos 0441: 651 */    0x00, 0x0B                  /* - terminal marker 11 - */,
+/* pos 0443: 652 */    0xE3 /* 'c' -> */,
+/* pos 0444: 653 */    0xE3 /* 'c' -> */,
+/* pos 0445: 654 */    0xE5 /* 'e' -> */,
+/* pos 0446: 655 */    0xF0 /* 'p' -> */,
+/* pos 0447: 656 */    0xF4 /* 't' -> */,
+/* pos 0448: 657 */    0xBA /* ':' -> */,
+/* pos 0449: 658 */    0x00, 0x0C                  /* - terminal marker 12 - */,
+/* pos 044b: 659 */    0xEF /* 'o' -> */,
+/* pos 044c: 660 */    0xEE /* 'n' -> */,
+/* pos 044d: 661 */    0xE3 /* 'c' -> */,
+/* pos 044e: 662 */    0xE5 /* 'e' -> */,
+/* pos 044f: 663 */    0xBA /* ':' -> */,
+/* pos 0450: 664 */    0x00, 0x0D                  /* - terminal marker 13 - */,
+/* pos 0452: 665 */    0x00, 0x1E                  /* - terminal marker 30 - */,
+/* pos 0454: 666 */    0xE5 /* 'e' -> */,
+/* pos 0455: 667 */    0xF2 /* 'r' -> */,
+/* pos 0456: 668 */    0xF3 /* 's' -> */,
+/* pos 0457: 669 */    0xE9 /* 'i' -> */,
+/* pos 0458: 670 */    0xEF /* 'o' -> */,
+/* pos 0459: 671 */    0xEE /* 'n' -> */,
+/* pos 045a: 672 */    0xBA /* ':' -> */,
+/* pos 045b: 673 */    0x00, 0x1F                  /* - terminal marker 31 - */,
+/* pos 045d: 674 */    0xF2 /* 'r' -> */,
+/* pos 045e: 675 */    0xE9 /* 'i' -> */,
+/* pos 045f: 676 */    0xE7 /* 'g' -> */,
+/* pos 0460: 677 */    0xE9 /* 'i' -> */,
+/* pos 0461: 678 */    0xEE /* 'n' -> */,
+/* pos 0462: 679 */    0xBA /* ':' -> */,
+/* pos 0463: 680 */    0x00, 0x20                  /* - terminal marker 32 - */,
+/* pos 0465: 681 */    0xAD /* '-' -> */,
+/* pos 0466: 682 */    0xF3 /* 's' -> */,
+/* pos 0467: 683 */    0xE5 /* 'e' -> */,
+/* pos 0468: 684 */    0xF4 /* 't' -> */,
+/* pos 0469: 685 */    0xF4 /* 't' -> */,
+/* pos 046a: 686 */    0xE9 /* 'i' -> */,
+/* pos 046b: 687 */    0xEE /* 'n' -> */,
+/* pos 046c: 688 */    0xE7 /* 'g' -> */,
+/* pos 046d: 689 */    0xF3 /* 's' -> */,
+/* pos 046e: 690 */    0xBA /* ':' -> */,
+/* pos 046f: 691 */    0x00, 0x0F                  /* - terminal marker 15 - */,
+/* pos 0471: 692 */    0x61 /* 'a' */, 0x0D, 0x00  /* (to 0x047E state 693) */,
+                       0x6D /* 'm' */, 0x14, 0x00  /* (to 0x0488 state 702) */,
+                       0x70 /* 'p' */, 0x18, 0x00  /* (to 0x048F state 708) */,
+                       0x73 /* 's' */, 0x20, 0x00  /* (to 0x049A state 712) */,
+                       0x08, /* fail */
+/* pos 047e: 693 */    0xF5 /* 'u' -> */,
+/* pos 047f: 694 */    0xF4 /* 't' -> */,
+/* pos 0480: 695 */    0xE8 /* 'h' -> */,
+/* pos 0481: 696 */    0xEF /* 'o' -> */,
+/* pos 0482: 697 */    0xF2 /* 'r' -> */,
+/* pos 0483: 698 */    0xE9 /* 'i' -> */,
+/* pos 0484: 699 */    0xF4 /* 't' -> */,
+/* pos 0485: 700 */    0xF9 /* 'y' -> */,
+/* pos 0486: 701 */    0x00, 0x21                  /* - terminal marker 33 - */,
+/* pos 0488: 702 */    0xE5 /* 'e' -> */,
+/* pos 0489: 703 */    0xF4 /* 't' -> */,
+/* pos 048a: 704 */    0xE8 /* 'h' -> */,
+/* pos 048b: 705 */    0xEF /* 'o' -> */,
+/* pos 048c: 706 */    0xE4 /* 'd' -> */,
+/* pos 048d: 707 */    0x00, 0x22                  /* - terminal marker 34 - */,
+/* pos 048f: 708 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0496 state 709) */,
+                       0x72 /* 'r' */, 0x1B, 0x00  /* (to 0x04AD state 723) */,
+                       0x08, /* fail */
+/* pos 0496: 709 */    0xF4 /* 't' -> */,
+/* pos 0497: 710 */    0xE8 /* 'h' -> */,
+/* pos 0498: 711 */    0x00, 0x23                  /* - terminal marker 35 - */,
+/* pos 049a: 712 */    0x63 /* 'c' */, 0x07, 0x00  /* (to 0x04A1 state 713) */,
+                       0x74 /* 't' */, 0x0A, 0x00  /* (to 0x04A7 state 718) */,
+                       0x08, /* fail */
+/* pos 04a1: 713 */    0xE8 /* 'h' -> */,
+/* pos 04a2: 714 */    0xE5 /* 'e' -> */,
+/* pos 04a3: 715 */    0xED /* 'm' -> */,
+/* pos 04a4: 716 */    0xE5 /* 'e' -> */,
+/* pos 04a5: 717 */    0x00, 0x24                  /* - terminal marker 36 - */,
+/* pos 04a7: 718 */    0xE1 /* 'a' -> */,
+/* pos 04a8: 719 */    0xF4 /* 't' -> */,
+/* pos 04a9: 720 */    0xF5 /* 'u' -> */,
+/* pos 04aa: 721 */    0xF3 /* 's' -> */,
+/* pos 04ab: 722 */    0x00, 0x25                  /* - terminal marker 37 - */,
+/* pos 04ad: 723 */    0xEF /* 'o' -> */,
+/* pos 04ae: 724 */    0xF4 /* 't' -> */,
+/* pos 04af: 725 */    0xEF /* 'o' -> */,
+/* pos 04b0: 726 */    0xE3 /* 'c' -> */,
+/* pos 04b1: 727 */    0xEF /* 'o' -> */,
+/* pos 04b2: 728 */    0xEC /* 'l' -> */,
+/* pos 04b3: 729 */    0x00, 0x4E                  /* - terminal marker 78 - */,
+/* pos 04b5: 730 */    0xEF /* 'o' -> */,
+/* pos 04b6: 731 */    0xF2 /* 'r' -> */,
+/* pos 04b7: 732 */    0xE9 /* 'i' -> */,
+/* pos 04b8: 733 */    0xF4 /* 't' -> */,
+/* pos 04b9: 734 */    0xF9 /* 'y' -> */,
+/* pos 04ba: 735 */    0xBA /* ':' -> */,
+/* pos 04bb: 736 */    0x00, 0x51                  /* - terminal marker 81 - */,
+/* total size 1213 bytes */
 #endif
 
 #if defined(LWS_HTTP_HEADERS_ALL) || ( defined(LWS_WITH_HTTP_UNCOMMON_HEADERS) &&  defined(LWS_ROLE_WS) &&  defined(LWS_ROLE_H2))
@@ -5990,6 +6021,8 @@
 	/* 85: 85: :protocol */
 	/* 86: 86: x-auth-token: */
 	/* 87: 87: x-amzn-dss-signature: */
+	/* 88: 88: priority: */
+	/* 89: 89:  */
 /* pos 0000:   0 */    0x67 /* 'g' */, 0x40, 0x00  /* (to 0x0040 state   1) */,
                        0x70 /* 'p' */, 0x42, 0x00  /* (to 0x0045 state   5) */,
                        0x68 /* 'h' */, 0x51, 0x00  /* (to 0x0057 state  10) */,
@@ -5999,18 +6032,18 @@
                        0x0D /* '.' */, 0x98, 0x00  /* (to 0x00AA state  41) */,
                        0x61 /* 'a' */, 0xAD, 0x00  /* (to 0x00C2 state  51) */,
                        0x69 /* 'i' */, 0xCA, 0x00  /* (to 0x00E2 state  58) */,
-                       0x64 /* 'd' */, 0x73, 0x01  /* (to 0x018E state 160) */,
-                       0x72 /* 'r' */, 0x7C, 0x01  /* (to 0x019A state 165) */,
-                       0x65 /* 'e' */, 0xC8, 0x01  /* (to 0x01E9 state 229) */,
-                       0x66 /* 'f' */, 0xE4, 0x01  /* (to 0x0208 state 245) */,
-                       0x6C /* 'l' */, 0x06, 0x02  /* (to 0x022D state 278) */,
-                       0x73 /* 's' */, 0x4B, 0x02  /* (to 0x0275 state 321) */,
-                       0x74 /* 't' */, 0x69, 0x02  /* (to 0x0296 state 337) */,
-                       0x78 /* 'x' */, 0x8A, 0x02  /* (to 0x02BA state 364) */,
-                       0x6D /* 'm' */, 0x14, 0x03  /* (to 0x0347 state 474) */,
-                       0x76 /* 'v' */, 0x6D, 0x03  /* (to 0x03A3 state 549) */,
-                       0x77 /* 'w' */, 0x7A, 0x03  /* (to 0x03B3 state 557) */,
-                       0x3A /* ':' */, 0x32, 0x04  /* (to 0x046E state 692) */,
+                       0x64 /* 'd' */, 0x76, 0x01  /* (to 0x0191 state 160) */,
+                       0x72 /* 'r' */, 0x7F, 0x01  /* (to 0x019D state 165) */,
+                       0x65 /* 'e' */, 0xCB, 0x01  /* (to 0x01EC state 229) */,
+                       0x66 /* 'f' */, 0xE7, 0x01  /* (to 0x020B state 245) */,
+                       0x6C /* 'l' */, 0x09, 0x02  /* (to 0x0230 state 278) */,
+                       0x73 /* 's' */, 0x4E, 0x02  /* (to 0x0278 state 321) */,
+                       0x74 /* 't' */, 0x6C, 0x02  /* (to 0x0299 state 337) */,
+                       0x78 /* 'x' */, 0x8D, 0x02  /* (to 0x02BD state 364) */,
+                       0x6D /* 'm' */, 0x17, 0x03  /* (to 0x034A state 474) */,
+                       0x76 /* 'v' */, 0x70, 0x03  /* (to 0x03A6 state 549) */,
+                       0x77 /* 'w' */, 0x7D, 0x03  /* (to 0x03B6 state 557) */,
+                       0x3A /* ':' */, 0x35, 0x04  /* (to 0x0471 state 692) */,
                        0x08, /* fail */
 /* pos 0040:   1 */    0xE5 /* 'e' -> */,
 /* pos 0041:   2 */    0xF4 /* 't' -> */,
@@ -6018,8 +6051,8 @@
 /* pos 0043:   4 */    0x00, 0x00                  /* - terminal marker  0 - */,
 /* pos 0045:   5 */    0x6F /* 'o' */, 0x0D, 0x00  /* (to 0x0052 state   6) */,
                        0x72 /* 'r' */, 0xEC, 0x00  /* (to 0x0134 state 106) */,
-                       0x61 /* 'a' */, 0x7A, 0x03  /* (to 0x03C5 state 574) */,
-                       0x75 /* 'u' */, 0x7C, 0x03  /* (to 0x03CA state 578) */,
+                       0x61 /* 'a' */, 0x7D, 0x03  /* (to 0x03C8 state 574) */,
+                       0x75 /* 'u' */, 0x7F, 0x03  /* (to 0x03CD state 578) */,
                        0x08, /* fail */
 /* pos 0052:   6 */    0xF3 /* 's' -> */,
 /* pos 0053:   7 */    0xF4 /* 't' -> */,
@@ -6027,34 +6060,34 @@
 /* pos 0055:   9 */    0x00, 0x01                  /* - terminal marker  1 - */,
 /* pos 0057:  10 */    0x6F /* 'o' */, 0x0A, 0x00  /* (to 0x0061 state  11) */,
                        0x74 /* 't' */, 0x53, 0x00  /* (to 0x00AD state  43) */,
-                       0x65 /* 'e' */, 0x79, 0x02  /* (to 0x02D6 state 381) */,
+                       0x65 /* 'e' */, 0x7C, 0x02  /* (to 0x02D9 state 381) */,
                        0x08, /* fail */
 /* pos 0061:  11 */    0xF3 /* 's' -> */,
 /* pos 0062:  12 */    0xF4 /* 't' -> */,
 /* pos 0063:  13 */    0xBA /* ':' -> */,
 /* pos 0064:  14 */    0x00, 0x03                  /* - terminal marker  3 - */,
 /* pos 0066:  15 */    0x6F /* 'o' */, 0x07, 0x00  /* (to 0x006D state  16) */,
-                       0x61 /* 'a' */, 0xD8, 0x00  /* (to 0x0141 state 112) */,
+                       0x61 /* 'a' */, 0xDB, 0x00  /* (to 0x0144 state 112) */,
                        0x08, /* fail */
 /* pos 006d:  16 */    0x6E /* 'n' */, 0x07, 0x00  /* (to 0x0074 state  17) */,
-                       0x6F /* 'o' */, 0xED, 0x00  /* (to 0x015D state 138) */,
+                       0x6F /* 'o' */, 0xF0, 0x00  /* (to 0x0160 state 138) */,
                        0x08, /* fail */
 /* pos 0074:  17 */    0x6E /* 'n' */, 0x07, 0x00  /* (to 0x007B state  18) */,
-                       0x74 /* 't' */, 0xEC, 0x00  /* (to 0x0163 state 143) */,
+                       0x74 /* 't' */, 0xEF, 0x00  /* (to 0x0166 state 143) */,
                        0x08, /* fail */
 /* pos 007b:  18 */    0xE5 /* 'e' -> */,
 /* pos 007c:  19 */    0xE3 /* 'c' -> */,
 /* pos 007d:  20 */    0xF4 /* 't' -> */,
 /* pos 007e:  21 */    0x69 /* 'i' */, 0x07, 0x00  /* (to 0x0085 state  22) */,
-                       0x20 /* ' ' */, 0x53, 0x02  /* (to 0x02D4 state 380) */,
+                       0x20 /* ' ' */, 0x56, 0x02  /* (to 0x02D7 state 380) */,
                        0x08, /* fail */
 /* pos 0085:  22 */    0xEF /* 'o' -> */,
 /* pos 0086:  23 */    0xEE /* 'n' -> */,
 /* pos 0087:  24 */    0xBA /* ':' -> */,
 /* pos 0088:  25 */    0x00, 0x04                  /* - terminal marker  4 - */,
 /* pos 008a:  26 */    0x70 /* 'p' */, 0x0A, 0x00  /* (to 0x0094 state  27) */,
-                       0x72 /* 'r' */, 0x22, 0x02  /* (to 0x02AF state 355) */,
-                       0x73 /* 's' */, 0x08, 0x03  /* (to 0x0398 state 539) */,
+                       0x72 /* 'r' */, 0x25, 0x02  /* (to 0x02B2 state 355) */,
+                       0x73 /* 's' */, 0x0B, 0x03  /* (to 0x039B state 539) */,
                        0x08, /* fail */
 /* pos 0094:  27 */    0xE7 /* 'g' -> */,
 /* pos 0095:  28 */    0xF2 /* 'r' -> */,
@@ -6064,7 +6097,7 @@
 /* pos 0099:  32 */    0xBA /* ':' -> */,
 /* pos 009a:  33 */    0x00, 0x05                  /* - terminal marker  5 - */,
 /* pos 009c:  34 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x00A3 state  35) */,
-                       0x70 /* 'p' */, 0x61, 0x02  /* (to 0x0300 state 414) */,
+                       0x70 /* 'p' */, 0x64, 0x02  /* (to 0x0303 state 414) */,
                        0x08, /* fail */
 /* pos 00a3:  35 */    0xE9 /* 'i' -> */,
 /* pos 00a4:  36 */    0xE7 /* 'g' -> */,
@@ -6077,24 +6110,24 @@
 /* pos 00ad:  43 */    0xF4 /* 't' -> */,
 /* pos 00ae:  44 */    0xF0 /* 'p' -> */,
 /* pos 00af:  45 */    0x2F /* '/' */, 0x07, 0x00  /* (to 0x00B6 state  46) */,
-                       0x32 /* '2' */, 0xB0, 0x03  /* (to 0x0462 state 681) */,
+                       0x32 /* '2' */, 0xB3, 0x03  /* (to 0x0465 state 681) */,
                        0x08, /* fail */
 /* pos 00b6:  46 */    0xB1 /* '1' -> */,
 /* pos 00b7:  47 */    0xAE /* '.' -> */,
 /* pos 00b8:  48 */    0x31 /* '1' */, 0x07, 0x00  /* (to 0x00BF state  49) */,
-                       0x30 /* '0' */, 0xFC, 0x01  /* (to 0x02B7 state 362) */,
+                       0x30 /* '0' */, 0xFF, 0x01  /* (to 0x02BA state 362) */,
                        0x08, /* fail */
 /* pos 00bf:  49 */    0xA0 /* ' ' -> */,
 /* pos 00c0:  50 */    0x00, 0x0F                  /* - terminal marker 15 - */,
 /* pos 00c2:  51 */    0x63 /* 'c' */, 0x0D, 0x00  /* (to 0x00CF state  52) */,
-                       0x75 /* 'u' */, 0x8A, 0x00  /* (to 0x014F state 125) */,
-                       0x67 /* 'g' */, 0xE7, 0x00  /* (to 0x01AF state 178) */,
-                       0x6C /* 'l' */, 0xE8, 0x00  /* (to 0x01B3 state 181) */,
+                       0x75 /* 'u' */, 0x8D, 0x00  /* (to 0x0152 state 125) */,
+                       0x67 /* 'g' */, 0xEA, 0x00  /* (to 0x01B2 state 178) */,
+                       0x6C /* 'l' */, 0xEB, 0x00  /* (to 0x01B6 state 181) */,
                        0x08, /* fail */
 /* pos 00cf:  52 */    0xE3 /* 'c' -> */,
 /* pos 00d0:  53 */    0xE5 /* 'e' -> */,
 /* pos 00d1:  54 */    0x70 /* 'p' */, 0x07, 0x00  /* (to 0x00D8 state  55) */,
-                       0x73 /* 's' */, 0x34, 0x02  /* (to 0x0308 state 421) */,
+                       0x73 /* 's' */, 0x37, 0x02  /* (to 0x030B state 421) */,
                        0x08, /* fail */
 /* pos 00d8:  55 */    0xF4 /* 't' -> */,
 /* pos 00d9:  56 */    0x3A /* ':' */, 0x07, 0x00  /* (to 0x00E0 state  57) */,
@@ -6105,11 +6138,11 @@
 /* pos 00e3:  59 */    0xAD /* '-' -> */,
 /* pos 00e4:  60 */    0x6D /* 'm' */, 0x0D, 0x00  /* (to 0x00F1 state  61) */,
                        0x6E /* 'n' */, 0x20, 0x00  /* (to 0x0107 state  76) */,
-                       0x72 /* 'r' */, 0x2A, 0x01  /* (to 0x0214 state 255) */,
-                       0x75 /* 'u' */, 0x2E, 0x01  /* (to 0x021B state 261) */,
+                       0x72 /* 'r' */, 0x2D, 0x01  /* (to 0x0217 state 255) */,
+                       0x75 /* 'u' */, 0x31, 0x01  /* (to 0x021E state 261) */,
                        0x08, /* fail */
 /* pos 00f1:  61 */    0x6F /* 'o' */, 0x07, 0x00  /* (to 0x00F8 state  62) */,
-                       0x61 /* 'a' */, 0x1A, 0x01  /* (to 0x020E state 250) */,
+                       0x61 /* 'a' */, 0x1D, 0x01  /* (to 0x0211 state 250) */,
                        0x08, /* fail */
 /* pos 00f8:  62 */    0xE4 /* 'd' -> */,
 /* pos 00f9:  63 */    0xE9 /* 'i' -> */,
@@ -6138,8 +6171,8 @@
 /* pos 0111:  86 */    0x00, 0x14                  /* - terminal marker 20 - */,
 /* pos 0113:  87 */    0x65 /* 'e' */, 0x0D, 0x00  /* (to 0x0120 state  88) */,
                        0x6C /* 'l' */, 0x14, 0x00  /* (to 0x012A state  97) */,
-                       0x72 /* 'r' */, 0x8E, 0x00  /* (to 0x01A7 state 171) */,
-                       0x63 /* 'c' */, 0x14, 0x02  /* (to 0x0330 state 453) */,
+                       0x72 /* 'r' */, 0x91, 0x00  /* (to 0x01AA state 171) */,
+                       0x63 /* 'c' */, 0x17, 0x02  /* (to 0x0333 state 453) */,
                        0x08, /* fail */
 /* pos 0120:  88 */    0xEE /* 'n' -> */,
 /* pos 0121:  89 */    0xE3 /* 'c' -> */,
@@ -6159,696 +6192,704 @@
 /* pos 0130: 103 */    0xE5 /* 'e' -> */,
 /* pos 0131: 104 */    0xBA /* ':' -> */,
 /* pos 0132: 105 */    0x00, 0x16                  /* - terminal marker 22 - */,
-/* pos 0134: 106 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x013B state 107) */,
-                       0x6F /* 'o' */, 0x1E, 0x02  /* (to 0x0355 state 487) */,
-                       0x08, /* fail */
-/* pos 013b: 107 */    0xE7 /* 'g' -> */,
-/* pos 013c: 108 */    0xED /* 'm' -> */,
-/* pos 013d: 109 */    0xE1 /* 'a' -> */,
-/* pos 013e: 110 */    0xBA /* ':' -> */,
-/* pos 013f: 111 */    0x00, 0x17                  /* - terminal marker 23 - */,
-/* pos 0141: 112 */    0xE3 /* 'c' -> */,
-/* pos 0142: 113 */    0xE8 /* 'h' -> */,
-/* pos 0143: 114 */    0xE5 /* 'e' -> */,
-/* pos 0144: 115 */    0xAD /* '-' -> */,
-/* pos 0145: 116 */    0xE3 /* 'c' -> */,
-/* pos 0146: 117 */    0xEF /* 'o' -> */,
-/* pos 0147: 118 */    0xEE /* 'n' -> */,
-/* pos 0148: 119 */    0xF4 /* 't' -> */,
-/* pos 0149: 120 */    0xF2 /* 'r' -> */,
-/* pos 014a: 121 */    0xEF /* 'o' -> */,
-/* pos 014b: 122 */    0xEC /* 'l' -> */,
-/* pos 014c: 123 */    0xBA /* ':' -> */,
-/* pos 014d: 124 */    0x00, 0x18                  /* - terminal marker 24 - */,
-/* pos 014f: 125 */    0xF4 /* 't' -> */,
-/* pos 0150: 126 */    0xE8 /* 'h' -> */,
-/* pos 0151: 127 */    0xEF /* 'o' -> */,
-/* pos 0152: 128 */    0xF2 /* 'r' -> */,
-/* pos 0153: 129 */    0xE9 /* 'i' -> */,
-/* pos 0154: 130 */    0xFA /* 'z' -> */,
-/* pos 0155: 131 */    0xE1 /* 'a' -> */,
-/* pos 0156: 132 */    0xF4 /* 't' -> */,
-/* pos 0157: 133 */    0xE9 /* 'i' -> */,
-/* pos 0158: 134 */    0xEF /* 'o' -> */,
-/* pos 0159: 135 */    0xEE /* 'n' -> */,
-/* pos 015a: 136 */    0xBA /* ':' -> */,
-/* pos 015b: 137 */    0x00, 0x19                  /* - terminal marker 25 - */,
-/* pos 015d: 138 */    0xEB /* 'k' -> */,
-/* pos 015e: 139 */    0xE9 /* 'i' -> */,
-/* pos 015f: 140 */    0xE5 /* 'e' -> */,
-/* pos 0160: 141 */    0xBA /* ':' -> */,
-/* pos 0161: 142 */    0x00, 0x1A                  /* - terminal marker 26 - */,
-/* pos 0163: 143 */    0xE5 /* 'e' -> */,
-/* pos 0164: 144 */    0xEE /* 'n' -> */,
-/* pos 0165: 145 */    0xF4 /* 't' -> */,
-/* pos 0166: 146 */    0xAD /* '-' -> */,
-/* pos 0167: 147 */    0x6C /* 'l' */, 0x10, 0x00  /* (to 0x0177 state 148) */,
-                       0x74 /* 't' */, 0x1E, 0x00  /* (to 0x0188 state 155) */,
-                       0x64 /* 'd' */, 0x4C, 0x00  /* (to 0x01B9 state 186) */,
-                       0x65 /* 'e' */, 0x56, 0x00  /* (to 0x01C6 state 198) */,
-                       0x72 /* 'r' */, 0x6F, 0x00  /* (to 0x01E2 state 223) */,
-                       0x08, /* fail */
-/* pos 0177: 148 */    0x65 /* 'e' */, 0x0A, 0x00  /* (to 0x0181 state 149) */,
-                       0x61 /* 'a' */, 0x56, 0x00  /* (to 0x01D0 state 207) */,
-                       0x6F /* 'o' */, 0x5C, 0x00  /* (to 0x01D9 state 215) */,
-                       0x08, /* fail */
-/* pos 0181: 149 */    0xEE /* 'n' -> */,
-/* pos 0182: 150 */    0xE7 /* 'g' -> */,
-/* pos 0183: 151 */    0xF4 /* 't' -> */,
-/* pos 0184: 152 */    0xE8 /* 'h' -> */,
-/* pos 0185: 153 */    0xBA /* ':' -> */,
-/* pos 0186: 154 */    0x00, 0x1B                  /* - terminal marker 27 - */,
-/* pos 0188: 155 */    0xF9 /* 'y' -> */,
-/* pos 0189: 156 */    0xF0 /* 'p' -> */,
-/* pos 018a: 157 */    0xE5 /* 'e' -> */,
-/* pos 018b: 158 */    0xBA /* ':' -> */,
-/* pos 018c: 159 */    0x00, 0x1C                  /* - terminal marker 28 - */,
-/* pos 018e: 160 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0195 state 161) */,
-                       0x65 /* 'e' */, 0x3C, 0x02  /* (to 0x03CD state 580) */,
-                       0x08, /* fail */
-/* pos 0195: 161 */    0xF4 /* 't' -> */,
-/* pos 0196: 162 */    0xE5 /* 'e' -> */,
-/* pos 0197: 163 */    0xBA /* ':' -> */,
-/* pos 0198: 164 */    0x00, 0x1D                  /* - terminal marker 29 - */,
-/* pos 019a: 165 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x01A1 state 166) */,
-                       0x65 /* 'e' */, 0xB6, 0x00  /* (to 0x0253 state 304) */,
-                       0x08, /* fail */
-/* pos 01a1: 166 */    0xEE /* 'n' -> */,
-/* pos 01a2: 167 */    0xE7 /* 'g' -> */,
-/* pos 01a3: 168 */    0xE5 /* 'e' -> */,
-/* pos 01a4: 169 */    0xBA /* ':' -> */,
-/* pos 01a5: 170 */    0x00, 0x1E                  /* - terminal marker 30 - */,
-/* pos 01a7: 171 */    0xE1 /* 'a' -> */,
-/* pos 01a8: 172 */    0xEE /* 'n' -> */,
-/* pos 01a9: 173 */    0xE7 /* 'g' -> */,
-/* pos 01aa: 174 */    0xE5 /* 'e' -> */,
-/* pos 01ab: 175 */    0xF3 /* 's' -> */,
-/* pos 01ac: 176 */    0xBA /* ':' -> */,
-/* pos 01ad: 177 */    0x00, 0x29                  /* - terminal marker 41 - */,
-/* pos 01af: 178 */    0xE5 /* 'e' -> */,
-/* pos 01b0: 179 */    0xBA /* ':' -> */,
-/* pos 01b1: 180 */    0x00, 0x2B                  /* - terminal marker 43 - */,
-/* pos 01b3: 181 */    0xEC /* 'l' -> */,
-/* pos 01b4: 182 */    0xEF /* 'o' -> */,
-/* pos 01b5: 183 */    0xF7 /* 'w' -> */,
-/* pos 01b6: 184 */    0xBA /* ':' -> */,
-/* pos 01b7: 185 */    0x00, 0x2C                  /* - terminal marker 44 - */,
-/* pos 01b9: 186 */    0xE9 /* 'i' -> */,
-/* pos 01ba: 187 */    0xF3 /* 's' -> */,
-/* pos 01bb: 188 */    0xF0 /* 'p' -> */,
-/* pos 01bc: 189 */    0xEF /* 'o' -> */,
-/* pos 01bd: 190 */    0xF3 /* 's' -> */,
-/* pos 01be: 191 */    0xE9 /* 'i' -> */,
-/* pos 01bf: 192 */    0xF4 /* 't' -> */,
-/* pos 01c0: 193 */    0xE9 /* 'i' -> */,
-/* pos 01c1: 194 */    0xEF /* 'o' -> */,
-/* pos 01c2: 195 */    0xEE /* 'n' -> */,
-/* pos 01c3: 196 */    0xBA /* ':' -> */,
-/* pos 01c4: 197 */    0x00, 0x2D                  /* - terminal marker 45 - */,
-/* pos 01c6: 198 */    0xEE /* 'n' -> */,
-/* pos 01c7: 199 */    0xE3 /* 'c' -> */,
-/* pos 01c8: 200 */    0xEF /* 'o' -> */,
-/* pos 01c9: 201 */    0xE4 /* 'd' -> */,
-/* pos 01ca: 202 */    0xE9 /* 'i' -> */,
-/* pos 01cb: 203 */    0xEE /* 'n' -> */,
-/* pos 01cc: 204 */    0xE7 /* 'g' -> */,
-/* pos 01cd: 205 */    0xBA /* ':' -> */,
-/* pos 01ce: 206 */    0x00, 0x2E                  /* - terminal marker 46 - */,
-/* pos 01d0: 207 */    0xEE /* 'n' -> */,
-/* pos 01d1: 208 */    0xE7 /* 'g' -> */,
-/* pos 01d2: 209 */    0xF5 /* 'u' -> */,
-/* pos 01d3: 210 */    0xE1 /* 'a' -> */,
-/* pos 01d4: 211 */    0xE7 /* 'g' -> */,
-/* pos 01d5: 212 */    0xE5 /* 'e' -> */,
-/* pos 01d6: 213 */    0xBA /* ':' -> */,
-/* pos 01d7: 214 */    0x00, 0x2F                  /* - terminal marker 47 - */,
-/* pos 01d9: 215 */    0xE3 /* 'c' -> */,
-/* pos 01da: 216 */    0xE1 /* 'a' -> */,
-/* pos 01db: 217 */    0xF4 /* 't' -> */,
-/* pos 01dc: 218 */    0xE9 /* 'i' -> */,
-/* pos 01dd: 219 */    0xEF /* 'o' -> */,
-/* pos 01de: 220 */    0xEE /* 'n' -> */,
-/* pos 01df: 221 */    0xBA /* ':' -> */,
-/* pos 01e0: 222 */    0x00, 0x30                  /* - terminal marker 48 - */,
-/* pos 01e2: 223 */    0xE1 /* 'a' -> */,
-/* pos 01e3: 224 */    0xEE /* 'n' -> */,
-/* pos 01e4: 225 */    0xE7 /* 'g' -> */,
-/* pos 01e5: 226 */    0xE5 /* 'e' -> */,
-/* pos 01e6: 227 */    0xBA /* ':' -> */,
-/* pos 01e7: 228 */    0x00, 0x31                  /* - terminal marker 49 - */,
-/* pos 01e9: 229 */    0x74 /* 't' */, 0x07, 0x00  /* (to 0x01F0 state 230) */,
-                       0x78 /* 'x' */, 0x09, 0x00  /* (to 0x01F5 state 234) */,
-                       0x08, /* fail */
-/* pos 01f0: 230 */    0xE1 /* 'a' -> */,
-/* pos 01f1: 231 */    0xE7 /* 'g' -> */,
-/* pos 01f2: 232 */    0xBA /* ':' -> */,
-/* pos 01f3: 233 */    0x00, 0x32                  /* - terminal marker 50 - */,
-/* pos 01f5: 234 */    0xF0 /* 'p' -> */,
-/* pos 01f6: 235 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x01FD state 236) */,
-                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x0202 state 240) */,
-                       0x08, /* fail */
-/* pos 01fd: 236 */    0xE3 /* 'c' -> */,
-/* pos 01fe: 237 */    0xF4 /* 't' -> */,
-/* pos 01ff: 238 */    0xBA /* ':' -> */,
-/* pos 0200: 239 */    0x00, 0x33                  /* - terminal marker 51 - */,
-/* pos 0202: 240 */    0xF2 /* 'r' -> */,
-/* pos 0203: 241 */    0xE5 /* 'e' -> */,
-/* pos 0204: 242 */    0xF3 /* 's' -> */,
-/* pos 0205: 243 */    0xBA /* ':' -> */,
-/* pos 0206: 244 */    0x00, 0x34                  /* - terminal marker 52 - */,
-/* pos 0208: 245 */    0xF2 /* 'r' -> */,
-/* pos 0209: 246 */    0xEF /* 'o' -> */,
-/* pos 020a: 247 */    0xED /* 'm' -> */,
-/* pos 020b: 248 */    0xBA /* ':' -> */,
-/* pos 020c: 249 */    0x00, 0x35                  /* - terminal marker 53 - */,
-/* pos 020e: 250 */    0xF4 /* 't' -> */,
-/* pos 020f: 251 */    0xE3 /* 'c' -> */,
-/* pos 0210: 252 */    0xE8 /* 'h' -> */,
-/* pos 0211: 253 */    0xBA /* ':' -> */,
-/* pos 0212: 254 */    0x00, 0x36                  /* - terminal marker 54 - */,
-/* pos 0214: 255 */    0xE1 /* 'a' -> */,
-/* pos 0215: 256 */    0xEE /* 'n' -> */,
-/* pos 0216: 257 */    0xE7 /* 'g' -> */,
-/* pos 0217: 258 */    0xE5 /* 'e' -> */,
-/* pos 0218: 259 */    0xBA /* ':' -> */,
-/* pos 0219: 260 */    0x00, 0x37                  /* - terminal marker 55 - */,
-/* pos 021b: 261 */    0xEE /* 'n' -> */,
-/* pos 021c: 262 */    0xED /* 'm' -> */,
-/* pos 021d: 263 */    0xEF /* 'o' -> */,
-/* pos 021e: 264 */    0xE4 /* 'd' -> */,
-/* pos 021f: 265 */    0xE9 /* 'i' -> */,
-/* pos 0220: 266 */    0xE6 /* 'f' -> */,
-/* pos 0221: 267 */    0xE9 /* 'i' -> */,
-/* pos 0222: 268 */    0xE5 /* 'e' -> */,
-/* pos 0223: 269 */    0xE4 /* 'd' -> */,
-/* pos 0224: 270 */    0xAD /* '-' -> */,
-/* pos 0225: 271 */    0xF3 /* 's' -> */,
-/* pos 0226: 272 */    0xE9 /* 'i' -> */,
-/* pos 0227: 273 */    0xEE /* 'n' -> */,
-/* pos 0228: 274 */    0xE3 /* 'c' -> */,
-/* pos 0229: 275 */    0xE5 /* 'e' -> */,
-/* pos 022a: 276 */    0xBA /* ':' -> */,
-/* pos 022b: 277 */    0x00, 0x38                  /* - terminal marker 56 - */,
-/* pos 022d: 278 */    0x61 /* 'a' */, 0x0A, 0x00  /* (to 0x0237 state 279) */,
-                       0x69 /* 'i' */, 0x15, 0x00  /* (to 0x0245 state 292) */,
-                       0x6F /* 'o' */, 0x17, 0x00  /* (to 0x024A state 296) */,
-                       0x08, /* fail */
-/* pos 0237: 279 */    0xF3 /* 's' -> */,
-/* pos 0238: 280 */    0xF4 /* 't' -> */,
-/* pos 0239: 281 */    0xAD /* '-' -> */,
-/* pos 023a: 282 */    0xED /* 'm' -> */,
-/* pos 023b: 283 */    0xEF /* 'o' -> */,
-/* pos 023c: 284 */    0xE4 /* 'd' -> */,
-/* pos 023d: 285 */    0xE9 /* 'i' -> */,
-/* pos 023e: 286 */    0xE6 /* 'f' -> */,
-/* pos 023f: 287 */    0xE9 /* 'i' -> */,
-/* pos 0240: 288 */    0xE5 /* 'e' -> */,
-/* pos 0241: 289 */    0xE4 /* 'd' -> */,
-/* pos 0242: 290 */    0xBA /* ':' -> */,
-/* pos 0243: 291 */    0x00, 0x39                  /* - terminal marker 57 - */,
-/* pos 0245: 292 */    0xEE /* 'n' -> */,
-/* pos 0246: 293 */    0xEB /* 'k' -> */,
-/* pos 0247: 294 */    0xBA /* ':' -> */,
-/* pos 0248: 295 */    0x00, 0x3A                  /* - terminal marker 58 - */,
-/* pos 024a: 296 */    0xE3 /* 'c' -> */,
-/* pos 024b: 297 */    0xE1 /* 'a' -> */,
-/* pos 024c: 298 */    0xF4 /* 't' -> */,
-/* pos 024d: 299 */    0xE9 /* 'i' -> */,
-/* pos 024e: 300 */    0xEF /* 'o' -> */,
-/* pos 024f: 301 */    0xEE /* 'n' -> */,
-/* pos 0250: 302 */    0xBA /* ':' -> */,
-/* pos 0251: 303 */    0x00, 0x3B                  /* - terminal marker 59 - */,
-/* pos 0253: 304 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x025D state 305) */,
-                       0x74 /* 't' */, 0x14, 0x00  /* (to 0x026A state 311) */,
-                       0x70 /* 'p' */, 0x88, 0x01  /* (to 0x03E1 state 596) */,
-                       0x08, /* fail */
-/* pos 025d: 305 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x0264 state 306) */,
-                       0x65 /* 'e' */, 0xCA, 0x00  /* (to 0x032A state 448) */,
-                       0x08, /* fail */
-/* pos 0264: 306 */    0xE5 /* 'e' -> */,
-/* pos 0265: 307 */    0xF3 /* 's' -> */,
-/* pos 0266: 308 */    0xE8 /* 'h' -> */,
-/* pos 0267: 309 */    0xBA /* ':' -> */,
-/* pos 0268: 310 */    0x00, 0x3F                  /* - terminal marker 63 - */,
-/* pos 026a: 311 */    0xF2 /* 'r' -> */,
-/* pos 026b: 312 */    0xF9 /* 'y' -> */,
-/* pos 026c: 313 */    0xAD /* '-' -> */,
-/* pos 026d: 314 */    0xE1 /* 'a' -> */,
-/* pos 026e: 315 */    0xE6 /* 'f' -> */,
-/* pos 026f: 316 */    0xF4 /* 't' -> */,
-/* pos 0270: 317 */    0xE5 /* 'e' -> */,
-/* pos 0271: 318 */    0xF2 /* 'r' -> */,
-/* pos 0272: 319 */    0xBA /* ':' -> */,
-/* pos 0273: 320 */    0x00, 0x40                  /* - terminal marker 64 - */,
-/* pos 0275: 321 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x027C state 322) */,
-                       0x74 /* 't' */, 0x06, 0x01  /* (to 0x037E state 514) */,
-                       0x08, /* fail */
-/* pos 027c: 322 */    0x72 /* 'r' */, 0x0A, 0x00  /* (to 0x0286 state 323) */,
-                       0x74 /* 't' */, 0x0D, 0x00  /* (to 0x028C state 328) */,
-                       0x63 /* 'c' */, 0x6B, 0x01  /* (to 0x03ED state 607) */,
-                       0x08, /* fail */
-/* pos 0286: 323 */    0xF6 /* 'v' -> */,
-/* pos 0287: 324 */    0xE5 /* 'e' -> */,
-/* pos 0288: 325 */    0xF2 /* 'r' -> */,
-/* pos 0289: 326 */    0xBA /* ':' -> */,
-/* pos 028a: 327 */    0x00, 0x41                  /* - terminal marker 65 - */,
-/* pos 028c: 328 */    0xAD /* '-' -> */,
-/* pos 028d: 329 */    0xE3 /* 'c' -> */,
-/* pos 028e: 330 */    0xEF /* 'o' -> */,
-/* pos 028f: 331 */    0xEF /* 'o' -> */,
-/* pos 0290: 332 */    0xEB /* 'k' -> */,
-/* pos 0291: 333 */    0xE9 /* 'i' -> */,
-/* pos 0292: 334 */    0xE5 /* 'e' -> */,
-/* pos 0293: 335 */    0xBA /* ':' -> */,
-/* pos 0294: 336 */    0x00, 0x42                  /* - terminal marker 66 - */,
-/* pos 0296: 337 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x029D state 338) */,
-                       0x65 /* 'e' */, 0x45, 0x01  /* (to 0x03DE state 594) */,
-                       0x08, /* fail */
-/* pos 029d: 338 */    0xE1 /* 'a' -> */,
-/* pos 029e: 339 */    0xEE /* 'n' -> */,
-/* pos 029f: 340 */    0xF3 /* 's' -> */,
-/* pos 02a0: 341 */    0xE6 /* 'f' -> */,
-/* pos 02a1: 342 */    0xE5 /* 'e' -> */,
-/* pos 02a2: 343 */    0xF2 /* 'r' -> */,
-/* pos 02a3: 344 */    0xAD /* '-' -> */,
-/* pos 02a4: 345 */    0xE5 /* 'e' -> */,
-/* pos 02a5: 346 */    0xEE /* 'n' -> */,
-/* pos 02a6: 347 */    0xE3 /* 'c' -> */,
-/* pos 02a7: 348 */    0xEF /* 'o' -> */,
-/* pos 02a8: 349 */    0xE4 /* 'd' -> */,
-/* pos 02a9: 350 */    0xE9 /* 'i' -> */,
-/* pos 02aa: 351 */    0xEE /* 'n' -> */,
-/* pos 02ab: 352 */    0xE7 /* 'g' -> */,
-/* pos 02ac: 353 */    0xBA /* ':' -> */,
-/* pos 02ad: 354 */    0x00, 0x44                  /* - terminal marker 68 - */,
-/* pos 02af: 355 */    0xE9 /* 'i' -> */,
-/* pos 02b0: 356 */    0xAD /* '-' -> */,
-/* pos 02b1: 357 */    0xE1 /* 'a' -> */,
-/* pos 02b2: 358 */    0xF2 /* 'r' -> */,
-/* pos 02b3: 359 */    0xE7 /* 'g' -> */,
-/* pos 02b4: 360 */    0xF3 /* 's' -> */,
-/* pos 02b5: 361 */    0x00, 0x4C                  /* - terminal marker 76 - */,
-/* pos 02b7: 362 */    0xA0 /* ' ' -> */,
-/* pos 02b8: 363 */    0x00, 0x4F                  /* - terminal marker 79 - */,
-/* pos 02ba: 364 */    0xAD /* '-' -> */,
-/* pos 02bb: 365 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x02C5 state 366) */,
-                       0x61 /* 'a' */, 0x1D, 0x00  /* (to 0x02DB state 385) */,
-                       0x72 /* 'r' */, 0x14, 0x01  /* (to 0x03D5 state 586) */,
-                       0x08, /* fail */
-/* pos 02c5: 366 */    0xEF /* 'o' -> */,
-/* pos 02c6: 367 */    0xF2 /* 'r' -> */,
-/* pos 02c7: 368 */    0xF7 /* 'w' -> */,
-/* pos 02c8: 369 */    0xE1 /* 'a' -> */,
-/* pos 02c9: 370 */    0xF2 /* 'r' -> */,
-/* pos 02ca: 371 */    0xE4 /* 'd' -> */,
-/* pos 02cb: 372 */    0xE5 /* 'e' -> */,
-/* pos 02cc: 373 */    0xE4 /* 'd' -> */,
-/* pos 02cd: 374 */    0xAD /* '-' -> */,
-/* pos 02ce: 375 */    0xE6 /* 'f' -> */,
-/* pos 02cf: 376 */    0xEF /* 'o' -> */,
-/* pos 02d0: 377 */    0xF2 /* 'r' -> */,
-/* pos 02d1: 378 */    0xBA /* ':' -> */,
-/* pos 02d2: 379 */    0x00, 0x50                  /* - terminal marker 80 - */,
-/* pos 02d4: 380 */    0x00, 0x51                  /* - terminal marker 81 - */,
-/* pos 02d6: 381 */    0xE1 /* 'a' -> */,
-/* pos 02d7: 382 */    0xE4 /* 'd' -> */,
-/* pos 02d8: 383 */    0xA0 /* ' ' -> */,
-/* pos 02d9: 384 */    0x00, 0x52                  /* - terminal marker 82 - */,
-/* pos 02db: 385 */    0x75 /* 'u' */, 0x07, 0x00  /* (to 0x02E2 state 386) */,
-                       0x6D /* 'm' */, 0x0F, 0x00  /* (to 0x02ED state 396) */,
-                       0x08, /* fail */
-/* pos 02e2: 386 */    0xF4 /* 't' -> */,
-/* pos 02e3: 387 */    0xE8 /* 'h' -> */,
-/* pos 02e4: 388 */    0xAD /* '-' -> */,
-/* pos 02e5: 389 */    0xF4 /* 't' -> */,
-/* pos 02e6: 390 */    0xEF /* 'o' -> */,
-/* pos 02e7: 391 */    0xEB /* 'k' -> */,
-/* pos 02e8: 392 */    0xE5 /* 'e' -> */,
-/* pos 02e9: 393 */    0xEE /* 'n' -> */,
-/* pos 02ea: 394 */    0xBA /* ':' -> */,
-/* pos 02eb: 395 */    0x00, 0x56                  /* - terminal marker 86 - */,
-/* pos 02ed: 396 */    0xFA /* 'z' -> */,
-/* pos 02ee: 397 */    0xEE /* 'n' -> */,
-/* pos 02ef: 398 */    0xAD /* '-' -> */,
-/* pos 02f0: 399 */    0xE4 /* 'd' -> */,
-/* pos 02f1: 400 */    0xF3 /* 's' -> */,
-/* pos 02f2: 401 */    0xF3 /* 's' -> */,
-/* pos 02f3: 402 */    0xAD /* '-' -> */,
-/* pos 02f4: 403 */    0xF3 /* 's' -> */,
-/* pos 02f5: 404 */    0xE9 /* 'i' -> */,
-/* pos 02f6: 405 */    0xE7 /* 'g' -> */,
-/* pos 02f7: 406 */    0xEE /* 'n' -> */,
-/* pos 02f8: 407 */    0xE1 /* 'a' -> */,
-/* pos 02f9: 408 */    0xF4 /* 't' -> */,
-/* pos 02fa: 409 */    0xF5 /* 'u' -> */,
-/* pos 02fb: 410 */    0xF2 /* 'r' -> */,
-/* pos 02fc: 411 */    0xE5 /* 'e' -> */,
-/* pos 02fd: 412 */    0xBA /* ':' -> */,
-/* pos 02fe: 413 */    0x00, 0x57                  /* - terminal marker 87 - */,
-/* pos 0300: 414 */    0xF4 /* 't' -> */,
-/* pos 0301: 415 */    0xE9 /* 'i' -> */,
-/* pos 0302: 416 */    0xEF /* 'o' -> */,
-/* pos 0303: 417 */    0xEE /* 'n' -> */,
-/* pos 0304: 418 */    0xF3 /* 's' -> */,
-/* pos 0305: 419 */    0xA0 /* ' ' -> */,
-/* pos 0306: 420 */    0x00, 0x02                  /* - terminal marker  2 - */,
-/* pos 0308: 421 */    0xF3 /* 's' -> */,
-/* pos 0309: 422 */    0xAD /* '-' -> */,
-/* pos 030a: 423 */    0xE3 /* 'c' -> */,
-/* pos 030b: 424 */    0xEF /* 'o' -> */,
-/* pos 030c: 425 */    0xEE /* 'n' -> */,
-/* pos 030d: 426 */    0xF4 /* 't' -> */,
-/* pos 030e: 427 */    0xF2 /* 'r' -> */,
-/* pos 030f: 428 */    0xEF /* 'o' -> */,
-/* pos 0310: 429 */    0xEC /* 'l' -> */,
-/* pos 0311: 430 */    0xAD /* '-' -> */,
-/* pos 0312: 431 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x0319 state 432) */,
-                       0x61 /* 'a' */, 0x24, 0x00  /* (to 0x0339 state 461) */,
-                       0x08, /* fail */
-/* pos 0319: 432 */    0xE5 /* 'e' -> */,
-/* pos 031a: 433 */    0xF1 /* 'q' -> */,
-/* pos 031b: 434 */    0xF5 /* 'u' -> */,
-/* pos 031c: 435 */    0xE5 /* 'e' -> */,
-/* pos 031d: 436 */    0xF3 /* 's' -> */,
-/* pos 031e: 437 */    0xF4 /* 't' -> */,
-/* pos 031f: 438 */    0xAD /* '-' -> */,
-/* pos 0320: 439 */    0xE8 /* 'h' -> */,
-/* pos 0321: 440 */    0xE5 /* 'e' -> */,
-/* pos 0322: 441 */    0xE1 /* 'a' -> */,
-/* pos 0323: 442 */    0xE4 /* 'd' -> */,
-/* pos 0324: 443 */    0xE5 /* 'e' -> */,
-/* pos 0325: 444 */    0xF2 /* 'r' -> */,
-/* pos 0326: 445 */    0xF3 /* 's' -> */,
-/* pos 0327: 446 */    0xBA /* ':' -> */,
-/* pos 0328: 447 */    0x00, 0x12                  /* - terminal marker 18 - */,
-/* pos 032a: 448 */    0xF2 /* 'r' -> */,
-/* pos 032b: 449 */    0xE5 /* 'e' -> */,
-/* pos 032c: 450 */    0xF2 /* 'r' -> */,
-/* pos 032d: 451 */    0xBA /* ':' -> */,
-/* pos 032e: 452 */    0x00, 0x1F                  /* - terminal marker 31 - */,
-/* pos 0330: 453 */    0xE8 /* 'h' -> */,
-/* pos 0331: 454 */    0xE1 /* 'a' -> */,
-/* pos 0332: 455 */    0xF2 /* 'r' -> */,
-/* pos 0333: 456 */    0xF3 /* 's' -> */,
-/* pos 0334: 457 */    0xE5 /* 'e' -> */,
-/* pos 0335: 458 */    0xF4 /* 't' -> */,
-/* pos 0336: 459 */    0xBA /* ':' -> */,
-/* pos 0337: 460 */    0x00, 0x28                  /* - terminal marker 40 - */,
-/* pos 0339: 461 */    0xEC /* 'l' -> */,
-/* pos 033a: 462 */    0xEC /* 'l' -> */,
-/* pos 033b: 463 */    0xEF /* 'o' -> */,
-/* pos 033c: 464 */    0xF7 /* 'w' -> */,
-/* pos 033d: 465 */    0xAD /* '-' -> */,
-/* pos 033e: 466 */    0xEF /* 'o' -> */,
-/* pos 033f: 467 */    0xF2 /* 'r' -> */,
-/* pos 0340: 468 */    0xE9 /* 'i' -> */,
-/* pos 0341: 469 */    0xE7 /* 'g' -> */,
-/* pos 0342: 470 */    0xE9 /* 'i' -> */,
-/* pos 0343: 471 */    0xEE /* 'n' -> */,
-/* pos 0344: 472 */    0xBA /* ':' -> */,
-/* pos 0345: 473 */    0x00, 0x2A                  /* - terminal marker 42 - */,
-/* pos 0347: 474 */    0xE1 /* 'a' -> */,
-/* pos 0348: 475 */    0xF8 /* 'x' -> */,
-/* pos 0349: 476 */    0xAD /* '-' -> */,
-/* pos 034a: 477 */    0xE6 /* 'f' -> */,
-/* pos 034b: 478 */    0xEF /* 'o' -> */,
-/* pos 034c: 479 */    0xF2 /* 'r' -> */,
-/* pos 034d: 480 */    0xF7 /* 'w' -> */,
-/* pos 034e: 481 */    0xE1 /* 'a' -> */,
-/* pos 034f: 482 */    0xF2 /* 'r' -> */,
-/* pos 0350: 483 */    0xE4 /* 'd' -> */,
-/* pos 0351: 484 */    0xF3 /* 's' -> */,
-/* pos 0352: 485 */    0xBA /* ':' -> */,
-/* pos 0353: 486 */    0x00, 0x3C                  /* - terminal marker 60 - */,
-/* pos 0355: 487 */    0xF8 /* 'x' -> */,
-/* pos 0356: 488 */    0xF9 /* 'y' -> */,
-/* pos 0357: 489 */    0x2D /* '-' */, 0x07, 0x00  /* (to 0x035E state 490) */,
-                       0x20 /* ' ' */, 0x79, 0x00  /* (to 0x03D3 state 585) */,
-                       0x08, /* fail */
-/* pos 035e: 490 */    0xE1 /* 'a' -> */,
-/* pos 035f: 491 */    0xF5 /* 'u' -> */,
-/* pos 0360: 492 */    0xF4 /* 't' -> */,
-/* pos 0361: 493 */    0xE8 /* 'h' -> */,
-/* pos 0362: 494 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x0369 state 495) */,
-                       0x6F /* 'o' */, 0x0E, 0x00  /* (to 0x0373 state 504) */,
-                       0x08, /* fail */
-/* pos 0369: 495 */    0xEE /* 'n' -> */,
-/* pos 036a: 496 */    0xF4 /* 't' -> */,
-/* pos 036b: 497 */    0xE9 /* 'i' -> */,
-/* pos 036c: 498 */    0xE3 /* 'c' -> */,
-/* pos 036d: 499 */    0xE1 /* 'a' -> */,
-/* pos 036e: 500 */    0xF4 /* 't' -> */,
-/* pos 036f: 501 */    0xE5 /* 'e' -> */,
-/* pos 0370: 502 */    0xBA /* ':' -> */,
-/* pos 0371: 503 */    0x00, 0x3D                  /* - terminal marker 61 - */,
-/* pos 0373: 504 */    0xF2 /* 'r' -> */,
-/* pos 0374: 505 */    0xE9 /* 'i' -> */,
-/* pos 0375: 506 */    0xFA /* 'z' -> */,
-/* pos 0376: 507 */    0xE1 /* 'a' -> */,
-/* pos 0377: 508 */    0xF4 /* 't' -> */,
-/* pos 0378: 509 */    0xE9 /* 'i' -> */,
-/* pos 0379: 510 */    0xEF /* 'o' -> */,
-/* pos 037a: 511 */    0xEE /* 'n' -> */,
-/* pos 037b: 512 */    0xBA /* ':' -> */,
-/* pos 037c: 513 */    0x00, 0x3E                  /* - terminal marker 62 - */,
-/* pos 037e: 514 */    0xF2 /* 'r' -> */,
-/* pos 037f: 515 */    0xE9 /* 'i' -> */,
-/* pos 0380: 516 */    0xE3 /* 'c' -> */,
-/* pos 0381: 517 */    0xF4 /* 't' -> */,
-/* pos 0382: 518 */    0xAD /* '-' -> */,
-/* pos 0383: 519 */    0xF4 /* 't' -> */,
-/* pos 0384: 520 */    0xF2 /* 'r' -> */,
-/* pos 0385: 521 */    0xE1 /* 'a' -> */,
-/* pos 0386: 522 */    0xEE /* 'n' -> */,
-/* pos 0387: 523 */    0xF3 /* 's' -> */,
-/* pos 0388: 524 */    0xF0 /* 'p' -> */,
-/* pos 0389: 525 */    0xEF /* 'o' -> */,
-/* pos 038a: 526 */    0xF2 /* 'r' -> */,
-/* pos 038b: 527 */    0xF4 /* 't' -> */,
-/* pos 038c: 528 */    0xAD /* '-' -> */,
-/* pos 038d: 529 */    0xF3 /* 's' -> */,
-/* pos 038e: 530 */    0xE5 /* 'e' -> */,
-/* pos 038f: 531 */    0xE3 /* 'c' -> */,
-/* pos 0390: 532 */    0xF5 /* 'u' -> */,
-/* pos 0391: 533 */    0xF2 /* 'r' -> */,
-/* pos 0392: 534 */    0xE9 /* 'i' -> */,
-/* pos 0393: 535 */    0xF4 /* 't' -> */,
-/* pos 0394: 536 */    0xF9 /* 'y' -> */,
-/* pos 0395: 537 */    0xBA /* ':' -> */,
-/* pos 0396: 538 */    0x00, 0x43                  /* - terminal marker 67 - */,
-/* pos 0398: 539 */    0xE5 /* 'e' -> */,
-/* pos 0399: 540 */    0xF2 /* 'r' -> */,
-/* pos 039a: 541 */    0xAD /* '-' -> */,
-/* pos 039b: 542 */    0xE1 /* 'a' -> */,
-/* pos 039c: 543 */    0xE7 /* 'g' -> */,
-/* pos 039d: 544 */    0xE5 /* 'e' -> */,
-/* pos 039e: 545 */    0xEE /* 'n' -> */,
-/* pos 039f: 546 */    0xF4 /* 't' -> */,
-/* pos 03a0: 547 */    0xBA /* ':' -> */,
-/* pos 03a1: 548 */    0x00, 0x45                  /* - terminal marker 69 - */,
-/* pos 03a3: 549 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x03AA state 550) */,
-                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x03AF state 554) */,
-                       0x08, /* fail */
-/* pos 03aa: 550 */    0xF2 /* 'r' -> */,
-/* pos 03ab: 551 */    0xF9 /* 'y' -> */,
-/* pos 03ac: 552 */    0xBA /* ':' -> */,
-/* pos 03ad: 553 */    0x00, 0x46                  /* - terminal marker 70 - */,
-/* pos 03af: 554 */    0xE1 /* 'a' -> */,
-/* pos 03b0: 555 */    0xBA /* ':' -> */,
-/* pos 03b1: 556 */    0x00, 0x47                  /* - terminal marker 71 - */,
-/* pos 03b3: 557 */    0xF7 /* 'w' -> */,
-/* pos 03b4: 558 */    0xF7 /* 'w' -> */,
-/* pos 03b5: 559 */    0xAD /* '-' -> */,
-/* pos 03b6: 560 */    0xE1 /* 'a' -> */,
-/* pos 03b7: 561 */    0xF5 /* 'u' -> */,
-/* pos 03b8: 562 */    0xF4 /* 't' -> */,
-/* pos 03b9: 563 */    0xE8 /* 'h' -> */,
-/* pos 03ba: 564 */    0xE5 /* 'e' -> */,
-/* pos 03bb: 565 */    0xEE /* 'n' -> */,
-/* pos 03bc: 566 */    0xF4 /* 't' -> */,
-/* pos 03bd: 567 */    0xE9 /* 'i' -> */,
-/* pos 03be: 568 */    0xE3 /* 'c' -> */,
-/* pos 03bf: 569 */    0xE1 /* 'a' -> */,
-/* pos 03c0: 570 */    0xF4 /* 't' -> */,
-/* pos 03c1: 571 */    0xE5 /* 'e' -> */,
-/* pos 03c2: 572 */    0xBA /* ':' -> */,
-/* pos 03c3: 573 */    0x00, 0x48                  /* - terminal marker 72 - */,
-/* pos 03c5: 574 */    0xF4 /* 't' -> */,
-/* pos 03c6: 575 */    0xE3 /* 'c' -> */,
-/* pos 03c7: 576 */    0xE8 /* 'h' -> */,
-/* pos 03c8: 577 */    0x00, 0x49                  /* - terminal marker 73 - */,
-/* pos 03ca: 578 */    0xF4 /* 't' -> */,
-/* pos 03cb: 579 */    0x00, 0x4A                  /* - terminal marker 74 - */,
-/* pos 03cd: 580 */    0xEC /* 'l' -> */,
-/* pos 03ce: 581 */    0xE5 /* 'e' -> */,
-/* pos 03cf: 582 */    0xF4 /* 't' -> */,
-/* pos 03d0: 583 */    0xE5 /* 'e' -> */,
-/* pos 03d1: 584 */    0x00, 0x4B                  /* - terminal marker 75 - */,
-/* pos 03d3: 585 */    0x00, 0x4D                  /* - terminal marker 77 - */,
-/* pos 03d5: 586 */    0xE5 /* 'e' -> */,
-/* pos 03d6: 587 */    0xE1 /* 'a' -> */,
-/* pos 03d7: 588 */    0xEC /* 'l' -> */,
-/* pos 03d8: 589 */    0xAD /* '-' -> */,
-/* pos 03d9: 590 */    0xE9 /* 'i' -> */,
-/* pos 03da: 591 */    0xF0 /* 'p' -> */,
-/* pos 03db: 592 */    0xBA /* ':' -> */,
-/* pos 03dc: 593 */    0x00, 0x4E                  /* - terminal marker 78 - */,
-/* pos 03de: 594 */    0xBA /* ':' -> */,
-/* pos 03df: 595 */    0x00, 0x53                  /* - terminal marker 83 - */,
-/* pos 03e1: 596 */    0xEC /* 'l' -> */,
-/* pos 03e2: 597 */    0xE1 /* 'a' -> */,
-/* pos 03e3: 598 */    0xF9 /* 'y' -> */,
-/* pos 03e4: 599 */    0xAD /* '-' -> */,
-/* pos 03e5: 600 */    0xEE /* 'n' -> */,
-/* pos 03e6: 601 */    0xEF /* 'o' -> */,
-/* pos 03e7: 602 */    0xEE /* 'n' -> */,
-/* pos 03e8: 603 */    0xE3 /* 'c' -> */,
-/* pos 03e9: 604 */    0xE5 /* 'e' -> */,
-/* pos 03ea: 605 */    0xBA /* ':' -> */,
-/* pos 03eb: 606 */    0x00, 0x54                  /* - terminal marker 84 - */,
-/* pos 03ed: 607 */    0xAD /* '-' -> */,
-/* pos 03ee: 608 */    0xF7 /* 'w' -> */,
-/* pos 03ef: 609 */    0xE5 /* 'e' -> */,
-/* pos 03f0: 610 */    0xE2 /* 'b' -> */,
-/* pos 03f1: 611 */    0xF3 /* 's' -> */,
-/* pos 03f2: 612 */    0xEF /* 'o' -> */,
-/* pos 03f3: 613 */    0xE3 /* 'c' -> */,
-/* pos 03f4: 614 */    0xEB /* 'k' -> */,
-/* pos 03f5: 615 */    0xE5 /* 'e' -> */,
-/* pos 03f6: 616 */    0xF4 /* 't' -> */,
-/* pos 03f7: 617 */    0xAD /* '-' -> */,
-/* pos 03f8: 618 */    0x64 /* 'd' */, 0x19, 0x00  /* (to 0x0411 state 619) */,
-                       0x65 /* 'e' */, 0x1D, 0x00  /* (to 0x0418 state 625) */,
-                       0x6B /* 'k' */, 0x26, 0x00  /* (to 0x0424 state 636) */,
-                       0x70 /* 'p' */, 0x35, 0x00  /* (to 0x0436 state 643) */,
-                       0x61 /* 'a' */, 0x3C, 0x00  /* (to 0x0440 state 652) */,
-                       0x6E /* 'n' */, 0x41, 0x00  /* (to 0x0448 state 659) */,
-                       0x76 /* 'v' */, 0x47, 0x00  /* (to 0x0451 state 666) */,
-                       0x6F /* 'o' */, 0x4D, 0x00  /* (to 0x045A state 674) */,
-                       0x08, /* fail */
-/* pos 0411: 619 */    0xF2 /* 'r' -> */,
-/* pos 0412: 620 */    0xE1 /* 'a' -> */,
-/* pos 0413: 621 */    0xE6 /* 'f' -> */,
-/* pos 0414: 622 */    0xF4 /* 't' -> */,
-/* pos 0415: 623 */    0xBA /* ':' -> */,
-/* pos 0416: 624 */    0x00, 0x07                  /* - terminal marker  7 - */,
-/* pos 0418: 625 */    0xF8 /* 'x' -> */,
-/* pos 0419: 626 */    0xF4 /* 't' -> */,
-/* pos 041a: 627 */    0xE5 /* 'e' -> */,
-/* pos 041b: 628 */    0xEE /* 'n' -> */,
-/* pos 041c: 629 */    0xF3 /* 's' -> */,
-/* pos 041d: 630 */    0xE9 /* 'i' -> */,
-/* pos 041e: 631 */    0xEF /* 'o' -> */,
-/* pos 041f: 632 */    0xEE /* 'n' -> */,
-/* pos 0420: 633 */    0xF3 /* 's' -> */,
-/* pos 0421: 634 */    0xBA /* ':' -> */,
-/* pos 0422: 635 */    0x00, 0x09                  /* - terminal marker  9 - */,
-/* pos 0424: 636 */    0xE5 /* 'e' -> */,
-/* pos 0425: 637 */    0xF9 /* 'y' -> */,
-/* pos 0426: 638 */    0x31 /* '1' */, 0x0A, 0x00  /* (to 0x0430 state 639) */,
-                       0x32 /* '2' */, 0x0A, 0x00  /* (to 0x0433 state 641) */,
-                       0x3A /* ':' */, 0x23, 0x00  /* (to 0x044F state 665) */,
-                       0x08, /* fail */
-/* pos 0430: 639 */    0xBA /* ':' -> */,
-/* pos 0431: 640 */    0x00, 0x0A                  /* - terminal marker 10 - */,
-/* pos 0433: 641 */    0xBA /* ':' -> */,
-/* pos 0434: 642 */    0x00, 0x0B                  /* - terminal marker 11 - */,
-/* pos 0436: 643 */    0xF2 /* 'r' -> */,
-/* pos 0437: 644 */    0xEF /* 'o' -> */,
-/* pos 0438: 645 */    0xF4 /* 't' -> */,
-/* pos 0439: 646 */    0xEF /* 'o' -> */,
-/* pos 043a: 647 */    0xE3 /* 'c' -> */,
-/* pos 043b: 648 */    0xEF /* 'o' -> */,
-/* pos 043c: 649 */    0xEC /* 'l' -> */,
-/* pos 043d: 650 */    0xBA /* ':' -> */,
-/* pos 043e: 651 */    0x00, 0x0C                  /* - terminal marker 12 - */,
-/* pos 0440: 652 */    0xE3 /* 'c' -> */,
-/* pos 0441: 653 */    0xE3 /* 'c' -> */,
-/* pos 0442: 654 */    0xE5 /* 'e' -> */,
-/* pos 0443: 655 */    0xF0 /* 'p' -> */,
-/* pos 0444: 656 */    0xF4 /* 't' -> */,
-/* pos 0445: 657 */    0xBA /* ':' -> */,
-/* pos 0446: 658 */    0x00, 0x0D                  /* - terminal marker 13 - */,
-/* pos 0448: 659 */    0xEF /* 'o' -> */,
-/* pos 0449: 660 */    0xEE /* 'n' -> */,
-/* pos 044a: 661 */    0xE3 /* 'c' -> */,
-/* pos 044b: 662 */    0xE5 /* 'e' -> */,
-/* pos 044c: 663 */    0xBA /* ':' -> */,
-/* pos 044d: 664 */    0x00, 0x0E                  /* - terminal marker 14 - */,
-/* pos 044f: 665 */    0x00, 0x20                  /* - terminal marker 32 - */,
-/* pos 0451: 666 */    0xE5 /* 'e' -> */,
-/* pos 0452: 667 */    0xF2 /* 'r' -> */,
-/* pos 0453: 668 */    0xF3 /* 's' -> */,
-/* pos 0454: 669 */    0xE9 /* 'i' -> */,
-/* pos 0455: 670 */    0xEF /* 'o' -> */,
-/* pos 0456: 671 */    0xEE /* 'n' -> */,
-/* pos 0457: 672 */    0xBA /* ':' -> */,
-/* pos 0458: 673 */    0x00, 0x21                  /* - terminal marker 33 - */,
-/* pos 045a: 674 */    0xF2 /* 'r' -> */,
-/* pos 045b: 675 */    0xE9 /* 'i' -> */,
-/* pos 045c: 676 */    0xE7 /* 'g' -> */,
-/* pos 045d: 677 */    0xE9 /* 'i' -> */,
-/* pos 045e: 678 */    0xEE /* 'n' -> */,
-/* pos 045f: 679 */    0xBA /* ':' -> */,
-/* pos 0460: 680 */    0x00, 0x22                  /* - terminal marker 34 - */,
-/* pos 0462: 681 */    0xAD /* '-' -> */,
-/* pos 0463: 682 */    0xF3 /* 's' -> */,
-/* pos 0464: 683 */    0xE5 /* 'e' -> */,
-/* pos 0465: 684 */    0xF4 /* 't' -> */,
-/* pos 0466: 685 */    0xF4 /* 't' -> */,
-/* pos 0467: 686 */    0xE9 /* 'i' -> */,
-/* pos 0468: 687 */    0xEE /* 'n' -> */,
-/* pos 0469: 688 */    0xE7 /* 'g' -> */,
-/* pos 046a: 689 */    0xF3 /* 's' -> */,
-/* pos 046b: 690 */    0xBA /* ':' -> */,
-/* pos 046c: 691 */    0x00, 0x10                  /* - terminal marker 16 - */,
-/* pos 046e: 692 */    0x61 /* 'a' */, 0x0D, 0x00  /* (to 0x047B state 693) */,
-                       0x6D /* 'm' */, 0x14, 0x00  /* (to 0x0485 state 702) */,
-                       0x70 /* 'p' */, 0x18, 0x00  /* (to 0x048C state 708) */,
-                       0x73 /* 's' */, 0x20, 0x00  /* (to 0x0497 state 712) */,
-                       0x08, /* fail */
-/* pos 047b: 693 */    0xF5 /* 'u' -> */,
-/* pos 047c: 694 */    0xF4 /* 't' -> */,
-/* pos 047d: 695 */    0xE8 /* 'h' -> */,
-/* pos 047e: 696 */    0xEF /* 'o' -> */,
-/* pos 047f: 697 */    0xF2 /* 'r' -> */,
-/* pos 0480: 698 */    0xE9 /* 'i' -> */,
-/* pos 0481: 699 */    0xF4 /* 't' -> */,
-/* pos 0482: 700 */    0xF9 /* 'y' -> */,
-/* pos 0483: 701 */    0x00, 0x23                  /* - terminal marker 35 - */,
-/* pos 0485: 702 */    0xE5 /* 'e' -> */,
-/* pos 0486: 703 */    0xF4 /* 't' -> */,
-/* pos 0487: 704 */    0xE8 /* 'h' -> */,
-/* pos 0488: 705 */    0xEF /* 'o' -> */,
-/* pos 0489: 706 */    0xE4 /* 'd' -> */,
-/* pos 048a: 707 */    0x00, 0x24                  /* - terminal marker 36 - */,
-/* pos 048c: 708 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0493 state 709) */,
-                       0x72 /* 'r' */, 0x1B, 0x00  /* (to 0x04AA state 723) */,
-                       0x08, /* fail */
-/* pos 0493: 709 */    0xF4 /* 't' -> */,
-/* pos 0494: 710 */    0xE8 /* 'h' -> */,
-/* pos 0495: 711 */    0x00, 0x25                  /* - terminal marker 37 - */,
-/* pos 0497: 712 */    0x63 /* 'c' */, 0x07, 0x00  /* (to 0x049E state 713) */,
-                       0x74 /* 't' */, 0x0A, 0x00  /* (to 0x04A4 state 718) */,
-                       0x08, /* fail */
-/* pos 049e: 713 */    0xE8 /* 'h' -> */,
-/* pos 049f: 714 */    0xE5 /* 'e' -> */,
-/* pos 04a0: 715 */    0xED /* 'm' -> */,
-/* pos 04a1: 716 */    0xE5 /* 'e' -> */,
-/* pos 04a2: 717 */    0x00, 0x26                  /* - terminal marker 38 - */,
-/* pos 04a4: 718 */    0xE1 /* 'a' -> */,
-/* pos 04a5: 719 */    0xF4 /* 't' -> */,
-/* pos 04a6: 720 */    0xF5 /* 'u' -> */,
-/* pos 04a7: 721 */    0xF3 /* 's' -> */,
-/* pos 04a8: 722 */    0x00, 0x27                  /* - terminal marker 39 - */,
-/* pos 04aa: 723 */    0xEF /* 'o' -> */,
-/* pos 04ab: 724 */    0xF4 /* 't' -> */,
-/* pos 04ac: 725 */    0xEF /* 'o' -> */,
-/* pos 04ad: 726 */    0xE3 /* 'c' -> */,
-/* pos 04ae: 727 */    0xEF /* 'o' -> */,
-/* pos 04af: 728 */    0xEC /* 'l' -> */,
-/* pos 04b0: 729 */    0x00, 0x55                  /* - terminal marker 85 - */,
-/* total size 1202 bytes */
+/* pos 0134: 106 */    0x61 /* 'a' */, 0x0A, 0x00  /* (to 0x013E state 107) */,
+                       0x6F /* 'o' */, 0x21, 0x02  /* (to 0x0358 state 487) */,
+                       0x69 /* 'i' */, 0x7B, 0x03  /* (to 0x04B5 state 730) */,
+                       0x08, /* fail */
+/* pos 013e: 107 */    0xE7 /* 'g' -> */,
+/* pos 013f: 108 */    0xED /* 'm' -> */,
+/* pos 0140: 109 */    0xE1 /* 'a' -> */,
+/* pos 0141: 110 */    0xBA /* ':' -> */,
+/* pos 0142: 111 */    0x00, 0x17                  /* - terminal marker 23 - */,
+/* pos 0144: 112 */    0xE3 /* 'c' -> */,
+/* pos 0145: 113 */    0xE8 /* 'h' -> */,
+/* pos 0146: 114 */    0xE5 /* 'e' -> */,
+/* pos 0147: 115 */    0xAD /* '-' -> */,
+/* pos 0148: 116 */    0xE3 /* 'c' -> */,
+/* pos 0149: 117 */    0xEF /* 'o' -> */,
+/* pos 014a: 118 */    0xEE /* 'n' -> */,
+/* pos 014b: 119 */    0xF4 /* 't' -> */,
+/* pos 014c: 120 */    0xF2 /* 'r' -> */,
+/* pos 014d: 121 */    0xEF /* 'o' -> */,
+/* pos 014e: 122 */    0xEC /* 'l' -> */,
+/* pos 014f: 123 */    0xBA /* ':' -> */,
+/* pos 0150: 124 */    0x00, 0x18                  /* - terminal marker 24 - */,
+/* pos 0152: 125 */    0xF4 /* 't' -> */,
+/* pos 0153: 126 */    0xE8 /* 'h' -> */,
+/* pos 0154: 127 */    0xEF /* 'o' -> */,
+/* pos 0155: 128 */    0xF2 /* 'r' -> */,
+/* pos 0156: 129 */    0xE9 /* 'i' -> */,
+/* pos 0157: 130 */    0xFA /* 'z' -> */,
+/* pos 0158: 131 */    0xE1 /* 'a' -> */,
+/* pos 0159: 132 */    0xF4 /* 't' -> */,
+/* pos 015a: 133 */    0xE9 /* 'i' -> */,
+/* pos 015b: 134 */    0xEF /* 'o' -> */,
+/* pos 015c: 135 */    0xEE /* 'n' -> */,
+/* pos 015d: 136 */    0xBA /* ':' -> */,
+/* pos 015e: 137 */    0x00, 0x19                  /* - terminal marker 25 - */,
+/* pos 0160: 138 */    0xEB /* 'k' -> */,
+/* pos 0161: 139 */    0xE9 /* 'i' -> */,
+/* pos 0162: 140 */    0xE5 /* 'e' -> */,
+/* pos 0163: 141 */    0xBA /* ':' -> */,
+/* pos 0164: 142 */    0x00, 0x1A                  /* - terminal marker 26 - */,
+/* pos 0166: 143 */    0xE5 /* 'e' -> */,
+/* pos 0167: 144 */    0xEE /* 'n' -> */,
+/* pos 0168: 145 */    0xF4 /* 't' -> */,
+/* pos 0169: 146 */    0xAD /* '-' -> */,
+/* pos 016a: 147 */    0x6C /* 'l' */, 0x10, 0x00  /* (to 0x017A state 148) */,
+                       0x74 /* 't' */, 0x1E, 0x00  /* (to 0x018B state 155) */,
+                       0x64 /* 'd' */, 0x4C, 0x00  /* (to 0x01BC state 186) */,
+                       0x65 /* 'e' */, 0x56, 0x00  /* (to 0x01C9 state 198) */,
+                       0x72 /* 'r' */, 0x6F, 0x00  /* (to 0x01E5 state 223) */,
+                       0x08, /* fail */
+/* pos 017a: 148 */    0x65 /* 'e' */, 0x0A, 0x00  /* (to 0x0184 state 149) */,
+                       0x61 /* 'a' */, 0x56, 0x00  /* (to 0x01D3 state 207) */,
+                       0x6F /* 'o' */, 0x5C, 0x00  /* (to 0x01DC state 215) */,
+                       0x08, /* fail */
+/* pos 0184: 149 */    0xEE /* 'n' -> */,
+/* pos 0185: 150 */    0xE7 /* 'g' -> */,
+/* pos 0186: 151 */    0xF4 /* 't' -> */,
+/* pos 0187: 152 */    0xE8 /* 'h' -> */,
+/* pos 0188: 153 */    0xBA /* ':' -> */,
+/* pos 0189: 154 */    0x00, 0x1B                  /* - terminal marker 27 - */,
+/* pos 018b: 155 */    0xF9 /* 'y' -> */,
+/* pos 018c: 156 */    0xF0 /* 'p' -> */,
+/* pos 018d: 157 */    0xE5 /* 'e' -> */,
+/* pos 018e: 158 */    0xBA /* ':' -> */,
+/* pos 018f: 159 */    0x00, 0x1C                  /* - terminal marker 28 - */,
+/* pos 0191: 160 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0198 state 161) */,
+                       0x65 /* 'e' */, 0x3C, 0x02  /* (to 0x03D0 state 580) */,
+                       0x08, /* fail */
+/* pos 0198: 161 */    0xF4 /* 't' -> */,
+/* pos 0199: 162 */    0xE5 /* 'e' -> */,
+/* pos 019a: 163 */    0xBA /* ':' -> */,
+/* pos 019b: 164 */    0x00, 0x1D                  /* - terminal marker 29 - */,
+/* pos 019d: 165 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x01A4 state 166) */,
+                       0x65 /* 'e' */, 0xB6, 0x00  /* (to 0x0256 state 304) */,
+                       0x08, /* fail */
+/* pos 01a4: 166 */    0xEE /* 'n' -> */,
+/* pos 01a5: 167 */    0xE7 /* 'g' -> */,
+/* pos 01a6: 168 */    0xE5 /* 'e' -> */,
+/* pos 01a7: 169 */    0xBA /* ':' -> */,
+/* pos 01a8: 170 */    0x00, 0x1E                  /* - terminal marker 30 - */,
+/* pos 01aa: 171 */    0xE1 /* 'a' -> */,
+/* pos 01ab: 172 */    0xEE /* 'n' -> */,
+/* pos 01ac: 173 */    0xE7 /* 'g' -> */,
+/* pos 01ad: 174 */    0xE5 /* 'e' -> */,
+/* pos 01ae: 175 */    0xF3 /* 's' -> */,
+/* pos 01af: 176 */    0xBA /* ':' -> */,
+/* pos 01b0: 177 */    0x00, 0x29                  /* - terminal marker 41 - */,
+/* pos 01b2: 178 */    0xE5 /* 'e' -> */,
+/* pos 01b3: 179 */    0xBA /* ':' -> */,
+/* pos 01b4: 180 */    0x00, 0x2B                  /* - terminal marker 43 - */,
+/* pos 01b6: 181 */    0xEC /* 'l' -> */,
+/* pos 01b7: 182 */    0xEF /* 'o' -> */,
+/* pos 01b8: 183 */    0xF7 /* 'w' -> */,
+/* pos 01b9: 184 */    0xBA /* ':' -> */,
+/* pos 01ba: 185 */    0x00, 0x2C                  /* - terminal marker 44 - */,
+/* pos 01bc: 186 */    0xE9 /* 'i' -> */,
+/* pos 01bd: 187 */    0xF3 /* 's' -> */,
+/* pos 01be: 188 */    0xF0 /* 'p' -> */,
+/* pos 01bf: 189 */    0xEF /* 'o' -> */,
+/* pos 01c0: 190 */    0xF3 /* 's' -> */,
+/* pos 01c1: 191 */    0xE9 /* 'i' -> */,
+/* pos 01c2: 192 */    0xF4 /* 't' -> */,
+/* pos 01c3: 193 */    0xE9 /* 'i' -> */,
+/* pos 01c4: 194 */    0xEF /* 'o' -> */,
+/* pos 01c5: 195 */    0xEE /* 'n' -> */,
+/* pos 01c6: 196 */    0xBA /* ':' -> */,
+/* pos 01c7: 197 */    0x00, 0x2D                  /* - terminal marker 45 - */,
+/* pos 01c9: 198 */    0xEE /* 'n' -> */,
+/* pos 01ca: 199 */    0xE3 /* 'c' -> */,
+/* pos 01cb: 200 */    0xEF /* 'o' -> */,
+/* pos 01cc: 201 */    0xE4 /* 'd' -> */,
+/* pos 01cd: 202 */    0xE9 /* 'i' -> */,
+/* pos 01ce: 203 */    0xEE /* 'n' -> */,
+/* pos 01cf: 204 */    0xE7 /* 'g' -> */,
+/* pos 01d0: 205 */    0xBA /* ':' -> */,
+/* pos 01d1: 206 */    0x00, 0x2E                  /* - terminal marker 46 - */,
+/* pos 01d3: 207 */    0xEE /* 'n' -> */,
+/* pos 01d4: 208 */    0xE7 /* 'g' -> */,
+/* pos 01d5: 209 */    0xF5 /* 'u' -> */,
+/* pos 01d6: 210 */    0xE1 /* 'a' -> */,
+/* pos 01d7: 211 */    0xE7 /* 'g' -> */,
+/* pos 01d8: 212 */    0xE5 /* 'e' -> */,
+/* pos 01d9: 213 */    0xBA /* ':' -> */,
+/* pos 01da: 214 */    0x00, 0x2F                  /* - terminal marker 47 - */,
+/* pos 01dc: 215 */    0xE3 /* 'c' -> */,
+/* pos 01dd: 216 */    0xE1 /* 'a' -> */,
+/* pos 01de: 217 */    0xF4 /* 't' -> */,
+/* pos 01df: 218 */    0xE9 /* 'i' -> */,
+/* pos 01e0: 219 */    0xEF /* 'o' -> */,
+/* pos 01e1: 220 */    0xEE /* 'n' -> */,
+/* pos 01e2: 221 */    0xBA /* ':' -> */,
+/* pos 01e3: 222 */    0x00, 0x30                  /* - terminal marker 48 - */,
+/* pos 01e5: 223 */    0xE1 /* 'a' -> */,
+/* pos 01e6: 224 */    0xEE /* 'n' -> */,
+/* pos 01e7: 225 */    0xE7 /* 'g' -> */,
+/* pos 01e8: 226 */    0xE5 /* 'e' -> */,
+/* pos 01e9: 227 */    0xBA /* ':' -> */,
+/* pos 01ea: 228 */    0x00, 0x31                  /* - terminal marker 49 - */,
+/* pos 01ec: 229 */    0x74 /* 't' */, 0x07, 0x00  /* (to 0x01F3 state 230) */,
+                       0x78 /* 'x' */, 0x09, 0x00  /* (to 0x01F8 state 234) */,
+                       0x08, /* fail */
+/* pos 01f3: 230 */    0xE1 /* 'a' -> */,
+/* pos 01f4: 231 */    0xE7 /* 'g' -> */,
+/* pos 01f5: 232 */    0xBA /* ':' -> */,
+/* pos 01f6: 233 */    0x00, 0x32                  /* - terminal marker 50 - */,
+/* pos 01f8: 234 */    0xF0 /* 'p' -> */,
+/* pos 01f9: 235 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x0200 state 236) */,
+                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x0205 state 240) */,
+                       0x08, /* fail */
+/* pos 0200: 236 */    0xE3 /* 'c' -> */,
+/* pos 0201: 237 */    0xF4 /* 't' -> */,
+/* pos 0202: 238 */    0xBA /* ':' -> */,
+/* pos 0203: 239 */    0x00, 0x33                  /* - terminal marker 51 - */,
+/* pos 0205: 240 */    0xF2 /* 'r' -> */,
+/* pos 0206: 241 */    0xE5 /* 'e' -> */,
+/* pos 0207: 242 */    0xF3 /* 's' -> */,
+/* pos 0208: 243 */    0xBA /* ':' -> */,
+/* pos 0209: 244 */    0x00, 0x34                  /* - terminal marker 52 - */,
+/* pos 020b: 245 */    0xF2 /* 'r' -> */,
+/* pos 020c: 246 */    0xEF /* 'o' -> */,
+/* pos 020d: 247 */    0xED /* 'm' -> */,
+/* pos 020e: 248 */    0xBA /* ':' -> */,
+/* pos 020f: 249 */    0x00, 0x35                  /* - terminal marker 53 - */,
+/* pos 0211: 250 */    0xF4 /* 't' -> */,
+/* pos 0212: 251 */    0xE3 /* 'c' -> */,
+/* pos 0213: 252 */    0xE8 /* 'h' -> */,
+/* pos 0214: 253 */    0xBA /* ':' -> */,
+/* pos 0215: 254 */    0x00, 0x36                  /* - terminal marker 54 - */,
+/* pos 0217: 255 */    0xE1 /* 'a' -> */,
+/* pos 0218: 256 */    0xEE /* 'n' -> */,
+/* pos 0219: 257 */    0xE7 /* 'g' -> */,
+/* pos 021a: 258 */    0xE5 /* 'e' -> */,
+/* pos 021b: 259 */    0xBA /* ':' -> */,
+/* pos 021c: 260 */    0x00, 0x37                  /* - terminal marker 55 - */,
+/* pos 021e: 261 */    0xEE /* 'n' -> */,
+/* pos 021f: 262 */    0xED /* 'm' -> */,
+/* pos 0220: 263 */    0xEF /* 'o' -> */,
+/* pos 0221: 264 */    0xE4 /* 'd' -> */,
+/* pos 0222: 265 */    0xE9 /* 'i' -> */,
+/* pos 0223: 266 */    0xE6 /* 'f' -> */,
+/* pos 0224: 267 */    0xE9 /* 'i' -> */,
+/* pos 0225: 268 */    0xE5 /* 'e' -> */,
+/* pos 0226: 269 */    0xE4 /* 'd' -> */,
+/* pos 0227: 270 */    0xAD /* '-' -> */,
+/* pos 0228: 271 */    0xF3 /* 's' -> */,
+/* pos 0229: 272 */    0xE9 /* 'i' -> */,
+/* pos 022a: 273 */    0xEE /* 'n' -> */,
+/* pos 022b: 274 */    0xE3 /* 'c' -> */,
+/* pos 022c: 275 */    0xE5 /* 'e' -> */,
+/* pos 022d: 276 */    0xBA /* ':' -> */,
+/* pos 022e: 277 */    0x00, 0x38                  /* - terminal marker 56 - */,
+/* pos 0230: 278 */    0x61 /* 'a' */, 0x0A, 0x00  /* (to 0x023A state 279) */,
+                       0x69 /* 'i' */, 0x15, 0x00  /* (to 0x0248 state 292) */,
+                       0x6F /* 'o' */, 0x17, 0x00  /* (to 0x024D state 296) */,
+                       0x08, /* fail */
+/* pos 023a: 279 */    0xF3 /* 's' -> */,
+/* pos 023b: 280 */    0xF4 /* 't' -> */,
+/* pos 023c: 281 */    0xAD /* '-' -> */,
+/* pos 023d: 282 */    0xED /* 'm' -> */,
+/* pos 023e: 283 */    0xEF /* 'o' -> */,
+/* pos 023f: 284 */    0xE4 /* 'd' -> */,
+/* pos 0240: 285 */    0xE9 /* 'i' -> */,
+/* pos 0241: 286 */    0xE6 /* 'f' -> */,
+/* pos 0242: 287 */    0xE9 /* 'i' -> */,
+/* pos 0243: 288 */    0xE5 /* 'e' -> */,
+/* pos 0244: 289 */    0xE4 /* 'd' -> */,
+/* pos 0245: 290 */    0xBA /* ':' -> */,
+/* pos 0246: 291 */    0x00, 0x39                  /* - terminal marker 57 - */,
+/* pos 0248: 292 */    0xEE /* 'n' -> */,
+/* pos 0249: 293 */    0xEB /* 'k' -> */,
+/* pos 024a: 294 */    0xBA /* ':' -> */,
+/* pos 024b: 295 */    0x00, 0x3A                  /* - terminal marker 58 - */,
+/* pos 024d: 296 */    0xE3 /* 'c' -> */,
+/* pos 024e: 297 */    0xE1 /* 'a' -> */,
+/* pos 024f: 298 */    0xF4 /* 't' -> */,
+/* pos 0250: 299 */    0xE9 /* 'i' -> */,
+/* pos 0251: 300 */    0xEF /* 'o' -> */,
+/* pos 0252: 301 */    0xEE /* 'n' -> */,
+/* pos 0253: 302 */    0xBA /* ':' -> */,
+/* pos 0254: 303 */    0x00, 0x3B                  /* - terminal marker 59 - */,
+/* pos 0256: 304 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x0260 state 305) */,
+                       0x74 /* 't' */, 0x14, 0x00  /* (to 0x026D state 311) */,
+                       0x70 /* 'p' */, 0x88, 0x01  /* (to 0x03E4 state 596) */,
+                       0x08, /* fail */
+/* pos 0260: 305 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x0267 state 306) */,
+                       0x65 /* 'e' */, 0xCA, 0x00  /* (to 0x032D state 448) */,
+                       0x08, /* fail */
+/* pos 0267: 306 */    0xE5 /* 'e' -> */,
+/* pos 0268: 307 */    0xF3 /* 's' -> */,
+/* pos 0269: 308 */    0xE8 /* 'h' -> */,
+/* pos 026a: 309 */    0xBA /* ':' -> */,
+/* pos 026b: 310 */    0x00, 0x3F                  /* - terminal marker 63 - */,
+/* pos 026d: 311 */    0xF2 /* 'r' -> */,
+/* pos 026e: 312 */    0xF9 /* 'y' -> */,
+/* pos 026f: 313 */    0xAD /* '-' -> */,
+/* pos 0270: 314 */    0xE1 /* 'a' -> */,
+/* pos 0271: 315 */    0xE6 /* 'f' -> */,
+/* pos 0272: 316 */    0xF4 /* 't' -> */,
+/* pos 0273: 317 */    0xE5 /* 'e' -> */,
+/* pos 0274: 318 */    0xF2 /* 'r' -> */,
+/* pos 0275: 319 */    0xBA /* ':' -> */,
+/* pos 0276: 320 */    0x00, 0x40                  /* - terminal marker 64 - */,
+/* pos 0278: 321 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x027F state 322) */,
+                       0x74 /* 't' */, 0x06, 0x01  /* (to 0x0381 state 514) */,
+                       0x08, /* fail */
+/* pos 027f: 322 */    0x72 /* 'r' */, 0x0A, 0x00  /* (to 0x0289 state 323) */,
+                       0x74 /* 't' */, 0x0D, 0x00  /* (to 0x028F state 328) */,
+                       0x63 /* 'c' */, 0x6B, 0x01  /* (to 0x03F0 state 607) */,
+                       0x08, /* fail */
+/* pos 0289: 323 */    0xF6 /* 'v' -> */,
+/* pos 028a: 324 */    0xE5 /* 'e' -> */,
+/* pos 028b: 325 */    0xF2 /* 'r' -> */,
+/* pos 028c: 326 */    0xBA /* ':' -> */,
+/* pos 028d: 327 */    0x00, 0x41                  /* - terminal marker 65 - */,
+/* pos 028f: 328 */    0xAD /* '-' -> */,
+/* pos 0290: 329 */    0xE3 /* 'c' -> */,
+/* pos 0291: 330 */    0xEF /* 'o' -> */,
+/* pos 0292: 331 */    0xEF /* 'o' -> */,
+/* pos 0293: 332 */    0xEB /* 'k' -> */,
+/* pos 0294: 333 */    0xE9 /* 'i' -> */,
+/* pos 0295: 334 */    0xE5 /* 'e' -> */,
+/* pos 0296: 335 */    0xBA /* ':' -> */,
+/* pos 0297: 336 */    0x00, 0x42                  /* - terminal marker 66 - */,
+/* pos 0299: 337 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x02A0 state 338) */,
+                       0x65 /* 'e' */, 0x45, 0x01  /* (to 0x03E1 state 594) */,
+                       0x08, /* fail */
+/* pos 02a0: 338 */    0xE1 /* 'a' -> */,
+/* pos 02a1: 339 */    0xEE /* 'n' -> */,
+/* pos 02a2: 340 */    0xF3 /* 's' -> */,
+/* pos 02a3: 341 */    0xE6 /* 'f' -> */,
+/* pos 02a4: 342 */    0xE5 /* 'e' -> */,
+/* pos 02a5: 343 */    0xF2 /* 'r' -> */,
+/* pos 02a6: 344 */    0xAD /* '-' -> */,
+/* pos 02a7: 345 */    0xE5 /* 'e' -> */,
+/* pos 02a8: 346 */    0xEE /* 'n' -> */,
+/* pos 02a9: 347 */    0xE3 /* 'c' -> */,
+/* pos 02aa: 348 */    0xEF /* 'o' -> */,
+/* pos 02ab: 349 */    0xE4 /* 'd' -> */,
+/* pos 02ac: 350 */    0xE9 /* 'i' -> */,
+/* pos 02ad: 351 */    0xEE /* 'n' -> */,
+/* pos 02ae: 352 */    0xE7 /* 'g' -> */,
+/* pos 02af: 353 */    0xBA /* ':' -> */,
+/* pos 02b0: 354 */    0x00, 0x44                  /* - terminal marker 68 - */,
+/* pos 02b2: 355 */    0xE9 /* 'i' -> */,
+/* pos 02b3: 356 */    0xAD /* '-' -> */,
+/* pos 02b4: 357 */    0xE1 /* 'a' -> */,
+/* pos 02b5: 358 */    0xF2 /* 'r' -> */,
+/* pos 02b6: 359 */    0xE7 /* 'g' -> */,
+/* pos 02b7: 360 */    0xF3 /* 's' -> */,
+/* pos 02b8: 361 */    0x00, 0x4C                  /* - terminal marker 76 - */,
+/* pos 02ba: 362 */    0xA0 /* ' ' -> */,
+/* pos 02bb: 363 */    0x00, 0x4F                  /* - terminal marker 79 - */,
+/* pos 02bd: 364 */    0xAD /* '-' -> */,
+/* pos 02be: 365 */    0x66 /* 'f' */, 0x0A, 0x00  /* (to 0x02C8 state 366) */,
+                       0x61 /* 'a' */, 0x1D, 0x00  /* (to 0x02DE state 385) */,
+                       0x72 /* 'r' */, 0x14, 0x01  /* (to 0x03D8 state 586) */,
+                       0x08, /* fail */
+/* pos 02c8: 366 */    0xEF /* 'o' -> */,
+/* pos 02c9: 367 */    0xF2 /* 'r' -> */,
+/* pos 02ca: 368 */    0xF7 /* 'w' -> */,
+/* pos 02cb: 369 */    0xE1 /* 'a' -> */,
+/* pos 02cc: 370 */    0xF2 /* 'r' -> */,
+/* pos 02cd: 371 */    0xE4 /* 'd' -> */,
+/* pos 02ce: 372 */    0xE5 /* 'e' -> */,
+/* pos 02cf: 373 */    0xE4 /* 'd' -> */,
+/* pos 02d0: 374 */    0xAD /* '-' -> */,
+/* pos 02d1: 375 */    0xE6 /* 'f' -> */,
+/* pos 02d2: 376 */    0xEF /* 'o' -> */,
+/* pos 02d3: 377 */    0xF2 /* 'r' -> */,
+/* pos 02d4: 378 */    0xBA /* ':' -> */,
+/* pos 02d5: 379 */    0x00, 0x50                  /* - terminal marker 80 - */,
+/* pos 02d7: 380 */    0x00, 0x51                  /* - terminal marker 81 - */,
+/* pos 02d9: 381 */    0xE1 /* 'a' -> */,
+/* pos 02da: 382 */    0xE4 /* 'd' -> */,
+/* pos 02db: 383 */    0xA0 /* ' ' -> */,
+/* pos 02dc: 384 */    0x00, 0x52                  /* - terminal marker 82 - */,
+/* pos 02de: 385 */    0x75 /* 'u' */, 0x07, 0x00  /* (to 0x02E5 state 386) */,
+                       0x6D /* 'm' */, 0x0F, 0x00  /* (to 0x02F0 state 396) */,
+                       0x08, /* fail */
+/* pos 02e5: 386 */    0xF4 /* 't' -> */,
+/* pos 02e6: 387 */    0xE8 /* 'h' -> */,
+/* pos 02e7: 388 */    0xAD /* '-' -> */,
+/* pos 02e8: 389 */    0xF4 /* 't' -> */,
+/* pos 02e9: 390 */    0xEF /* 'o' -> */,
+/* pos 02ea: 391 */    0xEB /* 'k' -> */,
+/* pos 02eb: 392 */    0xE5 /* 'e' -> */,
+/* pos 02ec: 393 */    0xEE /* 'n' -> */,
+/* pos 02ed: 394 */    0xBA /* ':' -> */,
+/* pos 02ee: 395 */    0x00, 0x56                  /* - terminal marker 86 - */,
+/* pos 02f0: 396 */    0xFA /* 'z' -> */,
+/* pos 02f1: 397 */    0xEE /* 'n' -> */,
+/* pos 02f2: 398 */    0xAD /* '-' -> */,
+/* pos 02f3: 399 */    0xE4 /* 'd' -> */,
+/* pos 02f4: 400 */    0xF3 /* 's' -> */,
+/* pos 02f5: 401 */    0xF3 /* 's' -> */,
+/* pos 02f6: 402 */    0xAD /* '-' -> */,
+/* pos 02f7: 403 */    0xF3 /* 's' -> */,
+/* pos 02f8: 404 */    0xE9 /* 'i' -> */,
+/* pos 02f9: 405 */    0xE7 /* 'g' -> */,
+/* pos 02fa: 406 */    0xEE /* 'n' -> */,
+/* pos 02fb: 407 */    0xE1 /* 'a' -> */,
+/* pos 02fc: 408 */    0xF4 /* 't' -> */,
+/* pos 02fd: 409 */    0xF5 /* 'u' -> */,
+/* pos 02fe: 410 */    0xF2 /* 'r' -> */,
+/* pos 02ff: 411 */    0xE5 /* 'e' -> */,
+/* pos 0300: 412 */    0xBA /* ':' -> */,
+/* pos 0301: 413 */    0x00, 0x57                  /* - terminal marker 87 - */,
+/* pos 0303: 414 */    0xF4 /* 't' -> */,
+/* pos 0304: 415 */    0xE9 /* 'i' -> */,
+/* pos 0305: 416 */    0xEF /* 'o' -> */,
+/* pos 0306: 417 */    0xEE /* 'n' -> */,
+/* pos 0307: 418 */    0xF3 /* 's' -> */,
+/* pos 0308: 419 */    0xA0 /* ' ' -> */,
+/* pos 0309: 420 */    0x00, 0x02                  /* - terminal marker  2 - */,
+/* pos 030b: 421 */    0xF3 /* 's' -> */,
+/* pos 030c: 422 */    0xAD /* '-' -> */,
+/* pos 030d: 423 */    0xE3 /* 'c' -> */,
+/* pos 030e: 424 */    0xEF /* 'o' -> */,
+/* pos 030f: 425 */    0xEE /* 'n' -> */,
+/* pos 0310: 426 */    0xF4 /* 't' -> */,
+/* pos 0311: 427 */    0xF2 /* 'r' -> */,
+/* pos 0312: 428 */    0xEF /* 'o' -> */,
+/* pos 0313: 429 */    0xEC /* 'l' -> */,
+/* pos 0314: 430 */    0xAD /* '-' -> */,
+/* pos 0315: 431 */    0x72 /* 'r' */, 0x07, 0x00  /* (to 0x031C state 432) */,
+                       0x61 /* 'a' */, 0x24, 0x00  /* (to 0x033C state 461) */,
+                       0x08, /* fail */
+/* pos 031c: 432 */    0xE5 /* 'e' -> */,
+/* pos 031d: 433 */    0xF1 /* 'q' -> */,
+/* pos 031e: 434 */    0xF5 /* 'u' -> */,
+/* pos 031f: 435 */    0xE5 /* 'e' -> */,
+/* pos 0320: 436 */    0xF3 /* 's' -> */,
+/* pos 0321: 437 */    0xF4 /* 't' -> */,
+/* pos 0322: 438 */    0xAD /* '-' -> */,
+/* pos 0323: 439 */    0xE8 /* 'h' -> */,
+/* pos 0324: 440 */    0xE5 /* 'e' -> */,
+/* pos 0325: 441 */    0xE1 /* 'a' -> */,
+/* pos 0326: 442 */    0xE4 /* 'd' -> */,
+/* pos 0327: 443 */    0xE5 /* 'e' -> */,
+/* pos 0328: 444 */    0xF2 /* 'r' -> */,
+/* pos 0329: 445 */    0xF3 /* 's' -> */,
+/* pos 032a: 446 */    0xBA /* ':' -> */,
+/* pos 032b: 447 */    0x00, 0x12                  /* - terminal marker 18 - */,
+/* pos 032d: 448 */    0xF2 /* 'r' -> */,
+/* pos 032e: 449 */    0xE5 /* 'e' -> */,
+/* pos 032f: 450 */    0xF2 /* 'r' -> */,
+/* pos 0330: 451 */    0xBA /* ':' -> */,
+/* pos 0331: 452 */    0x00, 0x1F                  /* - terminal marker 31 - */,
+/* pos 0333: 453 */    0xE8 /* 'h' -> */,
+/* pos 0334: 454 */    0xE1 /* 'a' -> */,
+/* pos 0335: 455 */    0xF2 /* 'r' -> */,
+/* pos 0336: 456 */    0xF3 /* 's' -> */,
+/* pos 0337: 457 */    0xE5 /* 'e' -> */,
+/* pos 0338: 458 */    0xF4 /* 't' -> */,
+/* pos 0339: 459 */    0xBA /* ':' -> */,
+/* pos 033a: 460 */    0x00, 0x28                  /* - terminal marker 40 - */,
+/* pos 033c: 461 */    0xEC /* 'l' -> */,
+/* pos 033d: 462 */    0xEC /* 'l' -> */,
+/* pos 033e: 463 */    0xEF /* 'o' -> */,
+/* pos 033f: 464 */    0xF7 /* 'w' -> */,
+/* pos 0340: 465 */    0xAD /* '-' -> */,
+/* pos 0341: 466 */    0xEF /* 'o' -> */,
+/* pos 0342: 467 */    0xF2 /* 'r' -> */,
+/* pos 0343: 468 */    0xE9 /* 'i' -> */,
+/* pos 0344: 469 */    0xE7 /* 'g' -> */,
+/* pos 0345: 470 */    0xE9 /* 'i' -> */,
+/* pos 0346: 471 */    0xEE /* 'n' -> */,
+/* pos 0347: 472 */    0xBA /* ':' -> */,
+/* pos 0348: 473 */    0x00, 0x2A                  /* - terminal marker 42 - */,
+/* pos 034a: 474 */    0xE1 /* 'a' -> */,
+/* pos 034b: 475 */    0xF8 /* 'x' -> */,
+/* pos 034c: 476 */    0xAD /* '-' -> */,
+/* pos 034d: 477 */    0xE6 /* 'f' -> */,
+/* pos 034e: 478 */    0xEF /* 'o' -> */,
+/* pos 034f: 479 */    0xF2 /* 'r' -> */,
+/* pos 0350: 480 */    0xF7 /* 'w' -> */,
+/* pos 0351: 481 */    0xE1 /* 'a' -> */,
+/* pos 0352: 482 */    0xF2 /* 'r' -> */,
+/* pos 0353: 483 */    0xE4 /* 'd' -> */,
+/* pos 0354: 484 */    0xF3 /* 's' -> */,
+/* pos 0355: 485 */    0xBA /* ':' -> */,
+/* pos 0356: 486 */    0x00, 0x3C                  /* - terminal marker 60 - */,
+/* pos 0358: 487 */    0xF8 /* 'x' -> */,
+/* pos 0359: 488 */    0xF9 /* 'y' -> */,
+/* pos 035a: 489 */    0x2D /* '-' */, 0x07, 0x00  /* (to 0x0361 state 490) */,
+                       0x20 /* ' ' */, 0x79, 0x00  /* (to 0x03D6 state 585) */,
+                       0x08, /* fail */
+/* pos 0361: 490 */    0xE1 /* 'a' -> */,
+/* pos 0362: 491 */    0xF5 /* 'u' -> */,
+/* pos 0363: 492 */    0xF4 /* 't' -> */,
+/* pos 0364: 493 */    0xE8 /* 'h' -> */,
+/* pos 0365: 494 */    0x65 /* 'e' */, 0x07, 0x00  /* (to 0x036C state 495) */,
+                       0x6F /* 'o' */, 0x0E, 0x00  /* (to 0x0376 state 504) */,
+                       0x08, /* fail */
+/* pos 036c: 495 */    0xEE /* 'n' -> */,
+/* pos 036d: 496 */    0xF4 /* 't' -> */,
+/* pos 036e: 497 */    0xE9 /* 'i' -> */,
+/* pos 036f: 498 */    0xE3 /* 'c' -> */,
+/* pos 0370: 499 */    0xE1 /* 'a' -> */,
+/* pos 0371: 500 */    0xF4 /* 't' -> */,
+/* pos 0372: 501 */    0xE5 /* 'e' -> */,
+/* pos 0373: 502 */    0xBA /* ':' -> */,
+/* pos 0374: 503 */    0x00, 0x3D                  /* - terminal marker 61 - */,
+/* pos 0376: 504 */    0xF2 /* 'r' -> */,
+/* pos 0377: 505 */    0xE9 /* 'i' -> */,
+/* pos 0378: 506 */    0xFA /* 'z' -> */,
+/* pos 0379: 507 */    0xE1 /* 'a' -> */,
+/* pos 037a: 508 */    0xF4 /* 't' -> */,
+/* pos 037b: 509 */    0xE9 /* 'i' -> */,
+/* pos 037c: 510 */    0xEF /* 'o' -> */,
+/* pos 037d: 511 */    0xEE /* 'n' -> */,
+/* pos 037e: 512 */    0xBA /* ':' -> */,
+/* pos 037f: 513 */    0x00, 0x3E                  /* - terminal marker 62 - */,
+/* pos 0381: 514 */    0xF2 /* 'r' -> */,
+/* pos 0382: 515 */    0xE9 /* 'i' -> */,
+/* pos 0383: 516 */    0xE3 /* 'c' -> */,
+/* pos 0384: 517 */    0xF4 /* 't' -> */,
+/* pos 0385: 518 */    0xAD /* '-' -> */,
+/* pos 0386: 519 */    0xF4 /* 't' -> */,
+/* pos 0387: 520 */    0xF2 /* 'r' -> */,
+/* pos 0388: 521 */    0xE1 /* 'a' -> */,
+/* pos 0389: 522 */    0xEE /* 'n' -> */,
+/* pos 038a: 523 */    0xF3 /* 's' -> */,
+/* pos 038b: 524 */    0xF0 /* 'p' -> */,
+/* pos 038c: 525 */    0xEF /* 'o' -> */,
+/* pos 038d: 526 */    0xF2 /* 'r' -> */,
+/* pos 038e: 527 */    0xF4 /* 't' -> */,
+/* pos 038f: 528 */    0xAD /* '-' -> */,
+/* pos 0390: 529 */    0xF3 /* 's' -> */,
+/* pos 0391: 530 */    0xE5 /* 'e' -> */,
+/* pos 0392: 531 */    0xE3 /* 'c' -> */,
+/* pos 0393: 532 */    0xF5 /* 'u' -> */,
+/* pos 0394: 533 */    0xF2 /* 'r' -> */,
+/* pos 0395: 534 */    0xE9 /* 'i' -> */,
+/* pos 0396: 535 */    0xF4 /* 't' -> */,
+/* pos 0397: 536 */    0xF9 /* 'y' -> */,
+/* pos 0398: 537 */    0xBA /* ':' -> */,
+/* pos 0399: 538 */    0x00, 0x43                  /* - terminal marker 67 - */,
+/* pos 039b: 539 */    0xE5 /* 'e' -> */,
+/* pos 039c: 540 */    0xF2 /* 'r' -> */,
+/* pos 039d: 541 */    0xAD /* '-' -> */,
+/* pos 039e: 542 */    0xE1 /* 'a' -> */,
+/* pos 039f: 543 */    0xE7 /* 'g' -> */,
+/* pos 03a0: 544 */    0xE5 /* 'e' -> */,
+/* pos 03a1: 545 */    0xEE /* 'n' -> */,
+/* pos 03a2: 546 */    0xF4 /* 't' -> */,
+/* pos 03a3: 547 */    0xBA /* ':' -> */,
+/* pos 03a4: 548 */    0x00, 0x45                  /* - terminal marker 69 - */,
+/* pos 03a6: 549 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x03AD state 550) */,
+                       0x69 /* 'i' */, 0x09, 0x00  /* (to 0x03B2 state 554) */,
+                       0x08, /* fail */
+/* pos 03ad: 550 */    0xF2 /* 'r' -> */,
+/* pos 03ae: 551 */    0xF9 /* 'y' -> */,
+/* pos 03af: 552 */    0xBA /* ':' -> */,
+/* pos 03b0: 553 */    0x00, 0x46                  /* - terminal marker 70 - */,
+/* pos 03b2: 554 */    0xE1 /* 'a' -> */,
+/* pos 03b3: 555 */    0xBA /* ':' -> */,
+/* pos 03b4: 556 */    0x00, 0x47                  /* - terminal marker 71 - */,
+/* pos 03b6: 557 */    0xF7 /* 'w' -> */,
+/* pos 03b7: 558 */    0xF7 /* 'w' -> */,
+/* pos 03b8: 559 */    0xAD /* '-' -> */,
+/* pos 03b9: 560 */    0xE1 /* 'a' -> */,
+/* pos 03ba: 561 */    0xF5 /* 'u' -> */,
+/* pos 03bb: 562 */    0xF4 /* 't' -> */,
+/* pos 03bc: 563 */    0xE8 /* 'h' -> */,
+/* pos 03bd: 564 */    0xE5 /* 'e' -> */,
+/* pos 03be: 565 */    0xEE /* 'n' -> */,
+/* pos 03bf: 566 */    0xF4 /* 't' -> */,
+/* pos 03c0: 567 */    0xE9 /* 'i' -> */,
+/* pos 03c1: 568 */    0xE3 /* 'c' -> */,
+/* pos 03c2: 569 */    0xE1 /* 'a' -> */,
+/* pos 03c3: 570 */    0xF4 /* 't' -> */,
+/* pos 03c4: 571 */    0xE5 /* 'e' -> */,
+/* pos 03c5: 572 */    0xBA /* ':' -> */,
+/* pos 03c6: 573 */    0x00, 0x48                  /* - terminal marker 72 - */,
+/* pos 03c8: 574 */    0xF4 /* 't' -> */,
+/* pos 03c9: 575 */    0xE3 /* 'c' -> */,
+/* pos 03ca: 576 */    0xE8 /* 'h' -> */,
+/* pos 03cb: 577 */    0x00, 0x49                  /* - terminal marker 73 - */,
+/* pos 03cd: 578 */    0xF4 /* 't' -> */,
+/* pos 03ce: 579 */    0x00, 0x4A                  /* - terminal marker 74 - */,
+/* pos 03d0: 580 */    0xEC /* 'l' -> */,
+/* pos 03d1: 581 */    0xE5 /* 'e' -> */,
+/* pos 03d2: 582 */    0xF4 /* 't' -> */,
+/* pos 03d3: 583 */    0xE5 /* 'e' -> */,
+/* pos 03d4: 584 */    0x00, 0x4B                  /* - terminal marker 75 - */,
+/* pos 03d6: 585 */    0x00, 0x4D                  /* - terminal marker 77 - */,
+/* pos 03d8: 586 */    0xE5 /* 'e' -> */,
+/* pos 03d9: 587 */    0xE1 /* 'a' -> */,
+/* pos 03da: 588 */    0xEC /* 'l' -> */,
+/* pos 03db: 589 */    0xAD /* '-' -> */,
+/* pos 03dc: 590 */    0xE9 /* 'i' -> */,
+/* pos 03dd: 591 */    0xF0 /* 'p' -> */,
+/* pos 03de: 592 */    0xBA /* ':' -> */,
+/* pos 03df: 593 */    0x00, 0x4E                  /* - terminal marker 78 - */,
+/* pos 03e1: 594 */    0xBA /* ':' -> */,
+/* pos 03e2: 595 */    0x00, 0x53                  /* - terminal marker 83 - */,
+/* pos 03e4: 596 */    0xEC /* 'l' -> */,
+/* pos 03e5: 597 */    0xE1 /* 'a' -> */,
+/* pos 03e6: 598 */    0xF9 /* 'y' -> */,
+/* pos 03e7: 599 */    0xAD /* '-' -> */,
+/* pos 03e8: 600 */    0xEE /* 'n' -> */,
+/* pos 03e9: 601 */    0xEF /* 'o' -> */,
+/* pos 03ea: 602 */    0xEE /* 'n' -> */,
+/* pos 03eb: 603 */    0xE3 /* 'c' -> */,
+/* pos 03ec: 604 */    0xE5 /* 'e' -> */,
+/* pos 03ed: 605 */    0xBA /* ':' -> */,
+/* pos 03ee: 606 */    0x00, 0x54                  /* - terminal marker 84 - */,
+/* pos 03f0: 607 */    0xAD /* '-' -> */,
+/* pos 03f1: 608 */    0xF7 /* 'w' -> */,
+/* pos 03f2: 609 */    0xE5 /* 'e' -> */,
+/* pos 03f3: 610 */    0xE2 /* 'b' -> */,
+/* pos 03f4: 611 */    0xF3 /* 's' -> */,
+/* pos 03f5: 612 */    0xEF /* 'o' -> */,
+/* pos 03f6: 613 */    0xE3 /* 'c' -> */,
+/* pos 03f7: 614 */    0xEB /* 'k' -> */,
+/* pos 03f8: 615 */    0xE5 /* 'e' -> */,
+/* pos 03f9: 616 */    0xF4 /* 't' -> */,
+/* pos 03fa: 617 */    0xAD /* '-' -> */,
+/* pos 03fb: 618 */    0x64 /* 'd' */, 0x19, 0x00  /* (to 0x0414 state 619) */,
+                       0x65 /* 'e' */, 0x1D, 0x00  /* (to 0x041B state 625) */,
+                       0x6B /* 'k' */, 0x26, 0x00  /* (to 0x0427 state 636) */,
+                       0x70 /* 'p' */, 0x35, 0x00  /* (to 0x0439 state 643) */,
+                       0x61 /* 'a' */, 0x3C, 0x00  /* (to 0x0443 state 652) */,
+                       0x6E /* 'n' */, 0x41, 0x00  /* (to 0x044B state 659) */,
+                       0x76 /* 'v' */, 0x47, 0x00  /* (to 0x0454 state 666) */,
+                       0x6F /* 'o' */, 0x4D, 0x00  /* (to 0x045D state 674) */,
+                       0x08, /* fail */
+/* pos 0414: 619 */    0xF2 /* 'r' -> */,
+/* pos 0415: 620 */    0xE1 /* 'a' -> */,
+/* pos 0416: 621 */    0xE6 /* 'f' -> */,
+/* pos 0417: 622 */    0xF4 /* 't' -> */,
+/* pos 0418: 623 */    0xBA /* ':' -> */,
+/* pos 0419: 624 */    0x00, 0x07                  /* - terminal marker  7 - */,
+/* pos 041b: 625 */    0xF8 /* 'x' -> */,
+/* pos 041c: 626 */    0xF4 /* 't' -> */,
+/* pos 041d: 627 */    0xE5 /* 'e' -> */,
+/* pos 041e: 628 */    0xEE /* 'n' -> */,
+/* pos 041f: 629 */    0xF3 /* 's' -> */,
+/* pos 0420: 630 */    0xE9 /* 'i' -> */,
+/* pos 0421: 631 */    0xEF /* 'o' -> */,
+/* pos 0422: 632 */    0xEE /* 'n' -> */,
+/* pos 0423: 633 */    0xF3 /* 's' -> */,
+/* pos 0424: 634 */    0xBA /* ':' -> */,
+/* pos 0425: 635 */    0x00, 0x09                  /* - terminal marker  9 - */,
+/* pos 0427: 636 */    0xE5 /* 'e' -> */,
+/* pos 0428: 637 */    0xF9 /* 'y' -> */,
+/* pos 0429: 638 */    0x31 /* '1' */, 0x0A, 0x00  /* (to 0x0433 state 639) */,
+                       0x32 /* '2' */, 0x0A, 0x00  /* (to 0x0436 state 641) */,
+                       0x3A /* ':' */, 0x23, 0x00  /* (to 0x0452 state 665) */,
+                       0x08, /* fail */
+/* pos 0433: 639 */    0xBA /* ':' -> */,
+/* pos 0434: 640 */    0x00, 0x0A                  /* - terminal marker 10 - */,
+/* pos 0436: 641 */    0xBA /* ':' -> */,
+/* pos 0437: 642 */    0x00, 0x0B                  /* - terminal marker 11 - */,
+/* pos 0439: 643 */    0xF2 /* 'r' -> */,
+/* pos 043a: 644 */    0xEF /* 'o' -> */,
+/* pos 043b: 645 */    0xF4 /* 't' -> */,
+/* pos 043c: 646 */    0xEF /* 'o' -> */,
+/* pos 043d: 647 */    0xE3 /* 'c' -> */,
+/* pos 043e: 648 */    0xEF /* 'o' -> */,
+/* pos 043f: 649 */    0xEC /* 'l' -> */,
+/* pos 0440: 650 */    0xBA /* ':' -> */,
+/* pos 0441: 651 */    0x00, 0x0C                  /* - terminal marker 12 - */,
+/* pos 0443: 652 */    0xE3 /* 'c' -> */,
+/* pos 0444: 653 */    0xE3 /* 'c' -> */,
+/* pos 0445: 654 */    0xE5 /* 'e' -> */,
+/* pos 0446: 655 */    0xF0 /* 'p' -> */,
+/* pos 0447: 656 */    0xF4 /* 't' -> */,
+/* pos 0448: 657 */    0xBA /* ':' -> */,
+/* pos 0449: 658 */    0x00, 0x0D                  /* - terminal marker 13 - */,
+/* pos 044b: 659 */    0xEF /* 'o' -> */,
+/* pos 044c: 660 */    0xEE /* 'n' -> */,
+/* pos 044d: 661 */    0xE3 /* 'c' -> */,
+/* pos 044e: 662 */    0xE5 /* 'e' -> */,
+/* pos 044f: 663 */    0xBA /* ':' -> */,
+/* pos 0450: 664 */    0x00, 0x0E                  /* - terminal marker 14 - */,
+/* pos 0452: 665 */    0x00, 0x20                  /* - terminal marker 32 - */,
+/* pos 0454: 666 */    0xE5 /* 'e' -> */,
+/* pos 0455: 667 */    0xF2 /* 'r' -> */,
+/* pos 0456: 668 */    0xF3 /* 's' -> */,
+/* pos 0457: 669 */    0xE9 /* 'i' -> */,
+/* pos 0458: 670 */    0xEF /* 'o' -> */,
+/* pos 0459: 671 */    0xEE /* 'n' -> */,
+/* pos 045a: 672 */    0xBA /* ':' -> */,
+/* pos 045b: 673 */    0x00, 0x21                  /* - terminal marker 33 - */,
+/* pos 045d: 674 */    0xF2 /* 'r' -> */,
+/* pos 045e: 675 */    0xE9 /* 'i' -> */,
+/* pos 045f: 676 */    0xE7 /* 'g' -> */,
+/* pos 0460: 677 */    0xE9 /* 'i' -> */,
+/* pos 0461: 678 */    0xEE /* 'n' -> */,
+/* pos 0462: 679 */    0xBA /* ':' -> */,
+/* pos 0463: 680 */    0x00, 0x22                  /* - terminal marker 34 - */,
+/* pos 0465: 681 */    0xAD /* '-' -> */,
+/* pos 0466: 682 */    0xF3 /* 's' -> */,
+/* pos 0467: 683 */    0xE5 /* 'e' -> */,
+/* pos 0468: 684 */    0xF4 /* 't' -> */,
+/* pos 0469: 685 */    0xF4 /* 't' -> */,
+/* pos 046a: 686 */    0xE9 /* 'i' -> */,
+/* pos 046b: 687 */    0xEE /* 'n' -> */,
+/* pos 046c: 688 */    0xE7 /* 'g' -> */,
+/* pos 046d: 689 */    0xF3 /* 's' -> */,
+/* pos 046e: 690 */    0xBA /* ':' -> */,
+/* pos 046f: 691 */    0x00, 0x10                  /* - terminal marker 16 - */,
+/* pos 0471: 692 */    0x61 /* 'a' */, 0x0D, 0x00  /* (to 0x047E state 693) */,
+                       0x6D /* 'm' */, 0x14, 0x00  /* (to 0x0488 state 702) */,
+                       0x70 /* 'p' */, 0x18, 0x00  /* (to 0x048F state 708) */,
+                       0x73 /* 's' */, 0x20, 0x00  /* (to 0x049A state 712) */,
+                       0x08, /* fail */
+/* pos 047e: 693 */    0xF5 /* 'u' -> */,
+/* pos 047f: 694 */    0xF4 /* 't' -> */,
+/* pos 0480: 695 */    0xE8 /* 'h' -> */,
+/* pos 0481: 696 */    0xEF /* 'o' -> */,
+/* pos 0482: 697 */    0xF2 /* 'r' -> */,
+/* pos 0483: 698 */    0xE9 /* 'i' -> */,
+/* pos 0484: 699 */    0xF4 /* 't' -> */,
+/* pos 0485: 700 */    0xF9 /* 'y' -> */,
+/* pos 0486: 701 */    0x00, 0x23                  /* - terminal marker 35 - */,
+/* pos 0488: 702 */    0xE5 /* 'e' -> */,
+/* pos 0489: 703 */    0xF4 /* 't' -> */,
+/* pos 048a: 704 */    0xE8 /* 'h' -> */,
+/* pos 048b: 705 */    0xEF /* 'o' -> */,
+/* pos 048c: 706 */    0xE4 /* 'd' -> */,
+/* pos 048d: 707 */    0x00, 0x24                  /* - terminal marker 36 - */,
+/* pos 048f: 708 */    0x61 /* 'a' */, 0x07, 0x00  /* (to 0x0496 state 709) */,
+                       0x72 /* 'r' */, 0x1B, 0x00  /* (to 0x04AD state 723) */,
+                       0x08, /* fail */
+/* pos 0496: 709 */    0xF4 /* 't' -> */,
+/* pos 0497: 710 */    0xE8 /* 'h' -> */,
+/* pos 0498: 711 */    0x00, 0x25                  /* - terminal marker 37 - */,
+/* pos 049a: 712 */    0x63 /* 'c' */, 0x07, 0x00  /* (to 0x04A1 state 713) */,
+                       0x74 /* 't' */, 0x0A, 0x00  /* (to 0x04A7 state 718) */,
+                       0x08, /* fail */
+/* pos 04a1: 713 */    0xE8 /* 'h' -> */,
+/* pos 04a2: 714 */    0xE5 /* 'e' -> */,
+/* pos 04a3: 715 */    0xED /* 'm' -> */,
+/* pos 04a4: 716 */    0xE5 /* 'e' -> */,
+/* pos 04a5: 717 */    0x00, 0x26                  /* - terminal marker 38 - */,
+/* pos 04a7: 718 */    0xE1 /* 'a' -> */,
+/* pos 04a8: 719 */    0xF4 /* 't' -> */,
+/* pos 04a9: 720 */    0xF5 /* 'u' -> */,
+/* pos 04aa: 721 */    0xF3 /* 's' -> */,
+/* pos 04ab: 722 */    0x00, 0x27                  /* - terminal marker 39 - */,
+/* pos 04ad: 723 */    0xEF /* 'o' -> */,
+/* pos 04ae: 724 */    0xF4 /* 't' -> */,
+/* pos 04af: 725 */    0xEF /* 'o' -> */,
+/* pos 04b0: 726 */    0xE3 /* 'c' -> */,
+/* pos 04b1: 727 */    0xEF /* 'o' -> */,
+/* pos 04b2: 728 */    0xEC /* 'l' -> */,
+/* pos 04b3: 729 */    0x00, 0x55                  /* - terminal marker 85 - */,
+/* pos 04b5: 730 */    0xEF /* 'o' -> */,
+/* pos 04b6: 731 */    0xF2 /* 'r' -> */,
+/* pos 04b7: 732 */    0xE9 /* 'i' -> */,
+/* pos 04b8: 733 */    0xF4 /* 't' -> */,
+/* pos 04b9: 734 */    0xF9 /* 'y' -> */,
+/* pos 04ba: 735 */    0xBA /* ':' -> */,
+/* pos 04bb: 736 */    0x00, 0x58                  /* - terminal marker 88 - */,
+/* total size 1213 bytes */
 #endif
 
 
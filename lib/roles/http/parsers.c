@@ -39,24 +39,109 @@ static const unsigned char lextable_h1[] = {
 
 #endif
 
-static struct allocated_headers *
-_lws_create_ah(struct lws_context_per_thread *pt, ah_data_idx_t data_size)
+/*
+ * Every ah the pt has is listed on pt->http.ah_owner.  The ones not attached
+ * to a wsi wait on the pt->http.ah_free stack, so attach and detach are
+ * usually just a push or pop.  Optionally some are preallocated in one block
+ * when the context is created, and stay until the pt is destroyed; the rest
+ * come from the heap on demand, and go back to it once they have sat on the
+ * free stack unused for LWS_AH_IDLE_US.
+ *
+ * Each ah and its header data are one allocation, the data follows the
+ * struct.
+ */
+
+#define LWS_AH_STRIDE(_d) ((sizeof(struct allocated_headers) + (_d) + 7) & \
+			   ~(size_t)7)
+#define LWS_AH_IDLE_US (10 * LWS_US_PER_SEC)
+
+static void
+lws_ah_metric(struct lws_context_per_thread *pt, const char *bucket)
 {
-	struct allocated_headers *ah = lws_zalloc(sizeof(*ah), "ah struct");
+#if defined(LWS_WITH_SYS_METRICS)
+	if (pt->context->mth_ah)
+		lws_metrics_hist_bump_priv(pt->context->mth_ah, bucket);
+#endif
+}
 
-	if (!ah)
-		return NULL;
+static void
+_lws_ah_add(struct lws_context_per_thread *pt, struct allocated_headers *ah,
+	    ah_data_idx_t data_size)
+{
+	ah->data = (char *)&ah[1];
+	ah->data_length = data_size;
+	lws_dll2_add_tail(&ah->list, &pt->http.ah_owner);
+	pt->http.ah_pool_length++;
+}
 
-	ah->data = lws_malloc(data_size, "ah data");
-	if (!ah->data) {
+static void
+_lws_ah_free(struct lws_context_per_thread *pt, struct allocated_headers *ah)
+{
+	lws_dll2_remove(&ah->list);
+	pt->http.ah_pool_length--;
+
+	lwsl_info("%s: freed ah %p : pool length %u\n", __func__, ah,
+		  (unsigned int)pt->http.ah_pool_length);
+
+	if (!ah->slab)
 		lws_free(ah);
+}
 
-		return NULL;
+static void
+lws_sul_ah_shrink(lws_sorted_usec_list_t *sul)
+{
+	struct lws_context_per_thread *pt = lws_container_of(sul,
+			struct lws_context_per_thread, http.sul_ah_shrink);
+	struct allocated_headers **pa;
+	lws_usec_t now = lws_now_usecs();
+	int more = 0;
+
+	lws_pt_lock(pt, __func__);
+
+	pa = &pt->http.ah_free;
+	while (*pa) {
+		struct allocated_headers *ah = *pa;
+
+		if (ah->slab || now - ah->freed < LWS_AH_IDLE_US) {
+			more |= !ah->slab;
+			pa = &ah->next_free;
+			continue;
+		}
+
+		*pa = ah->next_free;
+		pt->http.ah_free_length--;
+		_lws_ah_free(pt, ah);
+	}
+
+	if (more) {
+		__lws_sul_insert_us(pt, LWSSULLI_MISS_IF_SUSPENDED, sul,
+				    LWS_AH_IDLE_US);
 	}
-	ah->next = pt->http.ah_list;
-	pt->http.ah_list = ah;
-	ah->data_length = data_size;
-	pt->http.ah_pool_length++;
+
+	lws_pt_unlock(pt);
+}
+
+static struct allocated_headers *
+_lws_ah_get(struct lws_context_per_thread *pt, ah_data_idx_t data_size)
+{
+	struct allocated_headers *ah = pt->http.ah_free;
+
+	if (ah) {
+		pt->http.ah_free = ah->next_free;
+		ah->next_free = NULL;
+		pt->http.ah_free_length--;
+		lws_ah_metric(pt, "hit");
+
+		return ah;
+	}
+
+	lws_ah_metric(pt, "miss");
+
+	ah = lws_zalloc(LWS_AH_STRIDE(data_size), "ah");
+	if (!ah)
+		return NULL;
+
+	_lws_ah_add(pt, ah, data_size);
 
 	lwsl_info("%s: created ah %p (size %d): pool length %u\n", __func__,
 		    ah, (int)data_size, (unsigned int)pt->http.ah_pool_length);
@@ -64,25 +149,65 @@ _lws_create_ah(struct lws_context_per_thread *pt, ah_data_idx_t data_size)
 	return ah;
 }
 
+static void
+_lws_ah_put(struct lws_context_per_thread *pt, struct allocated_headers *ah)
+{
+	ah->in_use = 0;
+	ah->next_free = pt->http.ah_free;
+	pt->http.ah_free = ah;
+	pt->http.ah_free_length++;
+
+	if (ah->slab)
+		return;
+
+	ah->freed = lws_now_usecs();
+	if (!pt->http.sul_ah_shrink.list.owner) {
+		pt->http.sul_ah_shrink.cb = lws_sul_ah_shrink;
+		__lws_sul_insert_us(pt, LWSSULLI_MISS_IF_SUSPENDED,
+				    &pt->http.sul_ah_shrink, LWS_AH_IDLE_US);
+	}
+}
+
 int
-_lws_destroy_ah(struct lws_context_per_thread *pt, struct allocated_headers *ah)
+_lws_ah_pool_prealloc(struct lws_context_per_thread *pt, unsigned int count,
+		      ah_data_idx_t data_size)
 {
-	lws_start_foreach_llp(struct allocated_headers **, a, pt->http.ah_list) {
-		if ((*a) == ah) {
-			*a = ah->next;
-			pt->http.ah_pool_length--;
-			lwsl_info("%s: freed ah %p : pool length %u\n",
-				    __func__, ah,
-				    (unsigned int)pt->http.ah_pool_length);
-			if (ah->data)
-				lws_free(ah->data);
-			lws_free(ah);
+	size_t stride = LWS_AH_STRIDE(data_size);
+	uint8_t *p;
 
-			return 0;
-		}
-	} lws_end_foreach_llp(a, next);
+	p = pt->http.ah_slab = lws_zalloc(stride * count, "ah slab");
+	if (!p)
+		return 1;
 
-	return 1;
+	while (count--) {
+		struct allocated_headers *ah = (struct allocated_headers *)p;
+
+		_lws_ah_add(pt, ah, data_size);
+		ah->slab = 1;
+		ah->next_free = pt->http.ah_free;
+		pt->http.ah_free = ah;
+		pt->http.ah_free_length++;
+		p += stride;
+	}
+
+	lwsl_info("%s: preallocated %u ah (size %d)\n", __func__,
+		  (unsigned int)pt->http.ah_pool_length, (int)data_size);
+
+	return 0;
+}
+
+void
+_lws_ah_pool_destroy(struct lws_context_per_thread *pt)
+{
+	lws_sul_cancel(&pt->http.sul_ah_shrink);
+
+	while (pt->http.ah_owner.head)
+		_lws_ah_free(pt, lws_container_of(pt->http.ah_owner.head,
+					struct allocated_headers, list));
+
+	pt->http.ah_free = NULL;
+	pt->http.ah_free_length = 0;
+	lws_free_set_NULL(pt->http.ah_slab);
 }
 
 void
@@ -174,6 +299,7 @@ _lws_header_ensure_we_are_on_waiting_list(struct lws *wsi)
 	wsi->http.ah_wait_list = pt->http.ah_wait_list;
 	pt->http.ah_wait_list = wsi;
 	pt->http.ah_wait_list_length++;
+	lws_ah_metric(pt, "wait");
 
 	/* we cannot accept input then */
 
@@ -254,7 +380,8 @@ lws_header_table_attach(struct lws *wsi, int autoservice)
 
 	__lws_remove_from_ah_waiting_list(wsi);
 
-	wsi->http.ah = _lws_create_ah(pt, context->max_http_header_data);
+	wsi->http.ah = _lws_ah_get(pt, (ah_data_idx_t)
+					  context->max_http_header_data);
 	if (!wsi->http.ah) { /* we could not create an ah */
 		_lws_header_ensure_we_are_on_waiting_list(wsi);
 
@@ -436,7 +563,7 @@ bail:
 
 nobody_usable_waiting:
 	lwsl_info("%s: nobody usable waiting\n", __func__);
-	_lws_destroy_ah(pt, ah);
+	_lws_ah_put(pt, ah);
 	pt->http.ah_count_in_use--;
 
 	goto bail;
@@ -102,10 +102,12 @@ lws_ranges_reset(struct lws_range_parsing *rp);
  */
 
 struct allocated_headers {
-	struct allocated_headers *next; /* linked list */
+	lws_dll2_t list; /* pt->http.ah_owner, every ah the pt has */
+	struct allocated_headers *next_free; /* pt->http.ah_free stack */
 	struct lws *wsi; /* owner */
-	char *data; /* prepared by context init to point to dedicated storage */
+	char *data; /* points to the storage allocated along with us */
 	ah_data_idx_t data_length;
+	lws_usec_t freed; /* when we went on the free stack */
 	/*
 	 * the randomly ordered fragments, indexed by frag_index and
 	 * lws_fragments->nfrag for continuation.
@@ -139,6 +141,7 @@ struct allocated_headers {
 	int16_t lextable_pos;
 
 	uint8_t in_use;
+	uint8_t slab; /* part of the preallocated block, never freed alone */
 	uint8_t nfrag;
 	char /*enum uri_path_states */ ups;
 	char /*enum uri_esc_states */ ues;
@@ -176,13 +179,17 @@ lws_rewrite_parse(struct lws_rewrite *r, const unsigned char *in, int in_len);
 #endif
 
 struct lws_pt_role_http {
-	struct allocated_headers *ah_list;
+	lws_dll2_owner_t ah_owner; /* every ah, attached or free */
+	struct allocated_headers *ah_free; /* detached ah ready for reuse */
+	void *ah_slab; /* preallocated ah, freed with the pt */
+	lws_sorted_usec_list_t sul_ah_shrink; /* frees ah left idle */
 	struct lws *ah_wait_list;
 #ifdef LWS_WITH_CGI
 	struct lws_cgi *cgi_list;
 #endif
 	int ah_wait_list_length;
 	uint32_t ah_pool_length;
+	uint32_t ah_free_length;
 
 	int ah_count_in_use;
 };
@@ -201,6 +208,10 @@ struct lws_vhost_role_http {
 #if defined(LWS_CLIENT_HTTP_PROXYING)
 	unsigned int http_proxy_port;
 #endif
+#if defined(LWS_WITH_HTTP_STREAM_COMPRESSION) && defined(LWS_WITH_DISKCACHE)
+	struct lws_diskcache_scan *comp_cache;
+	lws_sorted_usec_list_t sul_comp_cache; /* lazy trim */
+#endif
 };
 
 #ifdef LWS_WITH_ACCESS_LOG
@@ -236,6 +247,7 @@ struct _lws_http_mode_related {
 	lws_filepos_t filepos;
 	lws_filepos_t filelen;
 	lws_fop_fd_t fop_fd;
+	const char *content_encoding; /* fop_fd is already in this encoding */
 #endif
 #if defined(LWS_WITH_CLIENT)
 	char multipart_boundary[16];
@@ -258,6 +270,11 @@ struct _lws_http_mode_related {
 	struct lws_compression_support *lcs;
 	lws_comp_ctx_t comp_ctx;
 	unsigned char comp_accept_mask;
+#if defined(LWS_WITH_DISKCACHE)
+	char *comp_cache_name; /* temp name of cache file we are filling */
+	size_t comp_cache_len;
+	int comp_cache_fd;
+#endif
 #endif
 
 	enum http_version request_version;
@@ -279,6 +296,7 @@ struct _lws_http_mode_related {
 	unsigned int multipart:1;
 	unsigned int cgi_transaction_complete:1;
 	unsigned int multipart_issue_boundary:1;
+	unsigned int vary_encoding:1; /* response depends on Accept-Encoding */
 };
 
 
@@ -319,8 +337,12 @@ lws_read_h1(struct lws *wsi, unsigned char *buf, lws_filepos_t len);
 void
 _lws_header_table_reset(struct allocated_headers *ah);
 
-LWS_EXTERN int
-_lws_destroy_ah(struct lws_context_per_thread *pt, struct allocated_headers *ah);
+int
+_lws_ah_pool_prealloc(struct lws_context_per_thread *pt, unsigned int count,
+		      ah_data_idx_t data_size);
+
+void
+_lws_ah_pool_destroy(struct lws_context_per_thread *pt);
 
 int
 lws_http_proxy_start(struct lws *wsi, const struct lws_http_mount *hit,
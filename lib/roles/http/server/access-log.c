@@ -36,6 +36,276 @@
 
 extern const char * const method_names[];
 
+#if defined(LWS_HAVE_PTHREAD_H) && !defined(LWS_PLAT_FREERTOS) && \
+    !defined(WIN32)
+#define LWS_ALOG_THREAD
+#endif
+
+/*
+ * Completed log lines are queued on a per-vhost ring and written out to the
+ * log file in batches, either when enough have built up or the oldest has
+ * waited long enough.  If we have pthreads, a writer thread does the write()
+ * so a slow disk can't stall the event loop, otherwise a sul on pt 0 does it.
+ *
+ * The lock is only held for copying a line in, or the indexes out, never over
+ * the write().  If the ring is full, lines are dropped and counted rather than
+ * waiting for space.
+ */
+
+struct lws_access_log_ring {
+#if defined(LWS_ALOG_THREAD)
+	pthread_t		thread;
+	pthread_mutex_t		lock;
+	pthread_cond_t		cond;
+#else
+	lws_sorted_usec_list_t	sul;
+	struct lws_context	*cx;
+#endif
+#if defined(LWS_WITH_SYS_METRICS)
+	lws_metric_t		*mt;	/* go: lines queued, nogo: dropped */
+#endif
+	uint8_t			*buf;
+	size_t			size;	/* power of 2 */
+	size_t			head;	/* free-running, masked on use */
+	size_t			tail;
+	size_t			batch;
+	lws_usec_t		latency;
+	unsigned long		dropped;
+	int			fd;
+	char			exiting;
+};
+
+/* write out buf between tail and head... called without the lock */
+
+static void
+lws_alog_write(struct lws_access_log_ring *r, size_t tail, size_t head)
+{
+	while (tail != head) {
+		size_t t = tail & (r->size - 1), l = head - tail;
+		ssize_t n;
+
+		if (l > r->size - t)
+			l = r->size - t;
+
+		n = write(r->fd, r->buf + t, l);
+		if (n <= 0) {
+			if (n < 0 && errno == EINTR)
+				continue;
+			lwsl_err("Failed to write log\n");
+			return;
+		}
+		tail += (size_t)n;
+	}
+}
+
+#if defined(LWS_ALOG_THREAD)
+
+static void *
+lws_alog_thread(void *d)
+{
+	struct lws_access_log_ring *r = (struct lws_access_log_ring *)d;
+	struct timespec ts;
+	size_t head, tail;
+
+	pthread_mutex_lock(&r->lock); /* ===================== alog lock */
+
+	while (1) {
+		if (r->head == r->tail) {
+			if (r->exiting)
+				break;
+			pthread_cond_wait(&r->cond, &r->lock);
+			continue;
+		}
+
+		if (!r->exiting && r->head - r->tail < r->batch) {
+			/*
+			 * The first line has just arrived, give some more a
+			 * chance to join it... we're woken early if the batch
+			 * fills up
+			 */
+			clock_gettime(CLOCK_REALTIME, &ts);
+			ts.tv_sec += (time_t)(r->latency / LWS_US_PER_SEC);
+			ts.tv_nsec += (long)((r->latency % LWS_US_PER_SEC) *
+					     LWS_NS_PER_US);
+			if (ts.tv_nsec >= 1000000000l) {
+				ts.tv_sec++;
+				ts.tv_nsec -= 1000000000l;
+			}
+			pthread_cond_timedwait(&r->cond, &r->lock, &ts);
+		}
+
+		head = r->head;
+		tail = r->tail;
+
+		pthread_mutex_unlock(&r->lock); /* ----------- alog unlock */
+		lws_alog_write(r, tail, head);
+		pthread_mutex_lock(&r->lock); /* ============= alog lock */
+
+		r->tail = head;
+	}
+
+	pthread_mutex_unlock(&r->lock); /* ------------------- alog unlock */
+
+	return NULL;
+}
+
+#else
+
+static void
+lws_alog_flush(struct lws_access_log_ring *r)
+{
+	lws_alog_write(r, r->tail, r->head);
+	r->tail = r->head;
+}
+
+static void
+lws_alog_sul_cb(lws_sorted_usec_list_t *sul)
+{
+	lws_alog_flush(lws_container_of(sul, struct lws_access_log_ring, sul));
+}
+
+#endif
+
+static void
+lws_alog_queue(struct lws_access_log_ring *r, const char *line, size_t len)
+{
+	size_t h, l;
+
+#if defined(LWS_ALOG_THREAD)
+	pthread_mutex_lock(&r->lock); /* ===================== alog lock */
+#endif
+
+	if (len > r->size - (r->head - r->tail)) {
+		r->dropped++;
+#if defined(LWS_WITH_SYS_METRICS)
+		lws_metric_event(r->mt, METRES_NOGO, (u_mt_t)len);
+#endif
+		goto bail;
+	}
+
+	h = r->head & (r->size - 1);
+	l = r->size - h;
+	if (l > len)
+		l = len;
+
+	memcpy(r->buf + h, line, l);
+	memcpy(r->buf, line + l, len - l);
+	r->head += len;
+
+#if defined(LWS_WITH_SYS_METRICS)
+	lws_metric_event(r->mt, METRES_GO, (u_mt_t)len);
+#endif
+
+#if defined(LWS_ALOG_THREAD)
+	/* wake the writer if it's idle, or the batch is ready */
+	if (r->head - r->tail == len || r->head - r->tail >= r->batch)
+		pthread_cond_signal(&r->cond);
+#else
+	if (r->head - r->tail >= r->batch)
+		lws_alog_flush(r);
+	else
+		if (!r->sul.list.owner)
+			lws_sul_schedule(r->cx, 0, &r->sul, lws_alog_sul_cb,
+					 r->latency);
+#endif
+
+bail:
+#if defined(LWS_ALOG_THREAD)
+	pthread_mutex_unlock(&r->lock); /* ------------------- alog unlock */
+#endif
+	return;
+}
+
+int
+lws_access_log_init(struct lws_vhost *vh,
+		    const struct lws_context_creation_info *info)
+{
+	struct lws_access_log_ring *r;
+	size_t size = 1;
+#if defined(LWS_WITH_SYS_METRICS)
+	char name[128];
+#endif
+
+	/* round the ring size up to a power of 2 */
+
+	while (size < (info->log_ring_size ? info->log_ring_size : 65536))
+		size <<= 1;
+
+	r = lws_zalloc(sizeof(*r) + size, "access log ring");
+	if (!r)
+		return 1;
+
+	r->buf = (uint8_t *)&r[1];
+	r->size = size;
+	r->fd = vh->log_fd;
+	r->batch = info->log_batch ? info->log_batch : size / 2;
+	if (r->batch > size)
+		r->batch = size;
+	r->latency = (lws_usec_t)(info->log_latency_ms ?
+				info->log_latency_ms : 1000) * LWS_US_PER_MS;
+
+#if defined(LWS_WITH_SYS_METRICS)
+	lws_snprintf(name, sizeof(name), "vh.%s.alog", vh->name);
+	r->mt = lws_metric_create(vh->context, 0, name);
+#endif
+
+#if defined(LWS_ALOG_THREAD)
+	pthread_mutex_init(&r->lock, NULL);
+	pthread_cond_init(&r->cond, NULL);
+	if (pthread_create(&r->thread, NULL, lws_alog_thread, r)) {
+		lwsl_vhost_err(vh, "unable to create access log thread");
+		pthread_cond_destroy(&r->cond);
+		pthread_mutex_destroy(&r->lock);
+#if defined(LWS_WITH_SYS_METRICS)
+		lws_metric_destroy(&r->mt, 0);
+#endif
+		lws_free(r);
+
+		return 1;
+	}
+#else
+	r->cx = vh->context;
+#endif
+
+	vh->alog = r;
+
+	return 0;
+}
+
+void
+lws_access_log_destroy(struct lws_vhost *vh)
+{
+	struct lws_access_log_ring *r = vh->alog;
+
+	if (!r)
+		return;
+
+	/* whatever is still queued is written out before we go */
+
+#if defined(LWS_ALOG_THREAD)
+	pthread_mutex_lock(&r->lock);
+	r->exiting = 1;
+	pthread_cond_signal(&r->cond);
+	pthread_mutex_unlock(&r->lock);
+
+	pthread_join(r->thread, NULL);
+	pthread_cond_destroy(&r->cond);
+	pthread_mutex_destroy(&r->lock);
+#else
+	lws_sul_cancel(&r->sul);
+	lws_alog_flush(r);
+#endif
+
+	if (r->dropped)
+		lwsl_vhost_warn(vh, "%lu access log lines dropped, ring full",
+				r->dropped);
+
+#if defined(LWS_WITH_SYS_METRICS)
+	lws_metric_destroy(&r->mt, 0);
+#endif
+	lws_free_set_NULL(vh->alog);
+}
+
 static const char * const hver[] = {
 	"HTTP/1.0", "HTTP/1.1", "HTTP/2"
 };
@@ -187,8 +457,8 @@ lws_access_log(struct lws *wsi)
 
 	ass[sizeof(ass) - 1] = '\0';
 
-	if ((int)write(wsi->a.vhost->log_fd, ass, (size_t)l) != l)
-		lwsl_err("Failed to write log\n");
+	if (wsi->a.vhost->alog)
+		lws_alog_queue(wsi->a.vhost->alog, ass, (size_t)l);
 
 	if (wsi->http.access_log.header_log) {
 		lws_free(wsi->http.access_log.header_log);
@@ -139,6 +139,9 @@ static const char * const paths_vhosts[] = {
 
 	"vhosts[].disable-no-protocol-ws-upgrades",
 	"vhosts[].h2-half-closed-long-poll",
+	"vhosts[].precompressed",
+	"vhosts[].compression-cache-dir",
+	"vhosts[].compression-cache-size",
 };
 
 enum lejp_vhost_paths {
@@ -213,6 +216,9 @@ enum lejp_vhost_paths {
 
 	LEJPVP_FLAG_DISABLE_NO_PROTOCOL_WS_UPGRADES,
 	LEJPVP_FLAG_H2_HALF_CLOSED_LONG_POLL,
+	LEJPVP_FLAG_PRECOMPRESSED,
+	LEJPVP_COMPRESSION_CACHE_DIR,
+	LEJPVP_COMPRESSION_CACHE_SIZE,
 };
 
 #define MAX_PLUGIN_DIRS 10
@@ -849,6 +855,16 @@ lejp_vhosts_cb(struct lejp_ctx *ctx, char reason)
 		a->info->error_document_404 = a->p;
 		break;
 
+#if defined(LWS_WITH_HTTP_STREAM_COMPRESSION) && defined(LWS_WITH_DISKCACHE)
+	case LEJPVP_COMPRESSION_CACHE_DIR:
+		a->info->http_compression_cache_dir = a->p;
+		break;
+	case LEJPVP_COMPRESSION_CACHE_SIZE:
+		a->info->http_compression_cache_size =
+					(uint64_t)atoll(ctx->buf);
+		return 0;
+#endif
+
 #if defined(LWS_WITH_TLS)
 	case LEJPVP_SSL_OPTION_SET:
 		a->info->ssl_options_set |= atol(ctx->buf);
@@ -910,6 +926,11 @@ lejp_vhosts_cb(struct lejp_ctx *ctx, char reason)
 				LWS_SERVER_OPTION_VH_H2_HALF_CLOSED_LONG_POLL);
 		return 0;
 
+	case LEJPVP_FLAG_PRECOMPRESSED:
+		set_reset_flag(&a->info->options, ctx->buf,
+				LWS_SERVER_OPTION_VH_HTTP_PRECOMPRESSED);
+		return 0;
+
 	default:
 		return 0;
 	}
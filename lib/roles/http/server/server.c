@@ -24,6 +24,10 @@
 
 #include "private-lib-core.h"
 
+#if defined(__linux__)
+#include <linux/filter.h>
+#endif
+
 #if !defined(SOL_TCP) && defined(IPPROTO_TCP)
 #define SOL_TCP IPPROTO_TCP
 #endif
@@ -77,6 +81,38 @@ check_extant(struct lws_dll2 *d, void *user)
 	return 1;
 }
 
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF) && \
+    defined(SO_INCOMING_CPU)
+/*
+ * The listen sockets join the reuseport group in pt order as they listen(),
+ * so the bpf program can return the arriving cpu mod the thread count as the
+ * index of the listen socket to use.  The program belongs to the group, so
+ * we attach it once, when the last one is listening.  Failure isn't fatal,
+ * the kernel just goes back to hashing connections over the group.
+ */
+
+static void
+lws_listen_steer_cpu(struct lws *wsi, int m, int limit)
+{
+	struct sock_filter code[] = {
+		{ BPF_LD  | BPF_W | BPF_ABS, 0, 0, (uint32_t)(SKF_AD_OFF +
+							      SKF_AD_CPU) },
+		{ BPF_ALU | BPF_MOD | BPF_K, 0, 0, (uint32_t)limit },
+		{ BPF_RET | BPF_A,	     0, 0, 0 },
+	};
+	struct sock_fprog prog = { LWS_ARRAY_SIZE(code), code };
+
+	if (setsockopt(wsi->desc.sockfd, SOL_SOCKET, SO_INCOMING_CPU,
+		       &m, sizeof(m)))
+		lwsl_wsi_warn(wsi, "SO_INCOMING_CPU failed %d", LWS_ERRNO);
+
+	if (m == limit - 1 &&
+	    setsockopt(wsi->desc.sockfd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF,
+		       &prog, sizeof(prog)))
+		lwsl_wsi_warn(wsi, "reuseport bpf failed %d", LWS_ERRNO);
+}
+#endif
+
 /*
  * Creates a single listen socket of a specific AF
  */
@@ -370,6 +406,16 @@ done_list:
 			goto bail;
 		}
 
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF) && \
+    defined(SO_INCOMING_CPU)
+		if (limit > 1 &&
+		    lws_check_opt(a->vhost->options,
+				  LWS_SERVER_OPTION_SMP_LISTEN_SHARD) &&
+		    lws_check_opt(a->vhost->options,
+				  LWS_SERVER_OPTION_SMP_LISTEN_STEER_CPU))
+			lws_listen_steer_cpu(wsi, m, limit);
+#endif
+
 		if (wsi)
 			__lws_lc_tag(a->vhost->context,
 				     &a->vhost->context->lcg[LWSLCG_WSI],
@@ -649,6 +695,215 @@ lws_vfs_prepare_flags(struct lws *wsi)
 	return f;
 }
 
+#if defined(LWS_WITH_HTTP_STREAM_COMPRESSION)
+/* content types worth compressing, if the client accepts it */
+
+static int
+lws_http_compressible(const char *content_type)
+{
+	return content_type && (!strncmp(content_type, "text/", 5) ||
+		!strcmp(content_type, "application/javascript") ||
+		!strcmp(content_type, "image/svg+xml"));
+}
+#endif
+
+#if !defined(WIN32) && !defined(LWS_PLAT_FREERTOS)
+
+/*
+ * How much the client wants content-coding enc according to its
+ * Accept-Encoding:, from 0 (not acceptable) to 1000 (q=1)
+ */
+
+static int
+lws_http_accept_encoding_q(struct lws *wsi, const char *enc)
+{
+	const char *a = lws_hdr_simple_ptr(wsi, WSI_TOKEN_HTTP_ACCEPT_ENCODING),
+		   *t, *e;
+	size_t el = strlen(enc);
+	int q, m, star = 0;
+
+	while (a && *a) {
+		while (*a == ' ' || *a == '\t' || *a == ',')
+			a++;
+		t = a;
+		while (*a && *a != ',' && *a != ';' && *a != ' ' && *a != '\t')
+			a++;
+		e = a;
+		while (*a == ' ' || *a == '\t')
+			a++;
+
+		q = 1000;
+		if (*a == ';') {
+			a++;
+			while (*a == ' ' || *a == '\t')
+				a++;
+			if ((*a == 'q' || *a == 'Q') && a[1] == '=') {
+				a += 2;
+				q = *a == '1' ? 1000 : 0;
+				if (*a == '0' || *a == '1')
+					a++;
+				if (*a == '.')
+					for (a++, m = 100; *a >= '0' && *a <= '9';
+					     a++, m /= 10)
+						if (q < 1000)
+							q += (*a - '0') * m;
+			}
+			while (*a && *a != ',')
+				a++;
+		}
+
+		if ((size_t)(e - t) == el && !strncasecmp(t, enc, el))
+			return q;
+		if (e - t == 1 && *t == '*')
+			star = q;
+	}
+
+	return star;
+}
+
+/*
+ * If the vhost allows it, look for file.br / file.gz alongside the file, and
+ * switch to serving the one the client likes best.  If there's none, and the
+ * vhost has a compression cache, see if we already compressed this version of
+ * the file for an encoding the client accepts, or arrange to keep it when we
+ * compress it this time.
+ */
+
+static const struct {
+	const char *encoding;
+	const char *suffix;
+} precomp[] = {
+	{ "br",		".br" }, /* preferred if the client's q is the same */
+	{ "gzip",	".gz" },
+};
+
+static void
+lws_http_serve_select_encoding(struct lws *wsi, const char *path,
+			       const struct lws_http_mount *m)
+{
+	struct lws_context *cx = wsi->a.context;
+	const struct lws_plat_file_ops *fops;
+	lws_fop_fd_t best = NULL, fd;
+	int bq = 0, q, n;
+	lws_fop_flags_t fl;
+	const char *vpath;
+	char sc[280];
+	struct stat st;
+
+	if (!lws_hdr_total_length(wsi, WSI_TOKEN_HTTP_ACCEPT_ENCODING) ||
+	    m->interpret || (wsi->http.fop_fd->flags & (LWS_FOP_FLAG_VIRTUAL |
+						 LWS_FOP_FLAG_COMPR_IS_GZIP)))
+		return;
+
+	if (lws_check_opt(wsi->a.vhost->options,
+			  LWS_SERVER_OPTION_VH_HTTP_PRECOMPRESSED)) {
+		wsi->http.vary_encoding = 1;
+
+		for (n = 0; n < (int)LWS_ARRAY_SIZE(precomp); n++) {
+			q = lws_http_accept_encoding_q(wsi,
+						       precomp[n].encoding);
+			if (q <= bq)
+				continue;
+
+			lws_snprintf(sc, sizeof(sc), "%s%s", path,
+				     precomp[n].suffix);
+			fops = lws_vfs_select_fops(cx->fops, sc, &vpath);
+			fl = LWS_O_RDONLY;
+			fd = fops->LWS_FOP_OPEN(cx->fops, sc, vpath, &fl);
+			if (!fd)
+				continue;
+
+			/* a sidecar older than the file is stale */
+			if ((fl & LWS_FOP_FLAG_VIRTUAL) || fstat(fd->fd, &st) ||
+			    (S_IFMT & st.st_mode) != S_IFREG ||
+			    (uint32_t)st.st_mtime < wsi->http.fop_fd->mod_time) {
+				lws_vfs_file_close(&fd);
+				continue;
+			}
+
+			fd->mod_time = (uint32_t)st.st_mtime;
+			fd->flags |= LWS_FOP_FLAG_MOD_TIME_VALID;
+			if (best)
+				lws_vfs_file_close(&best);
+			best = fd;
+			bq = q;
+			wsi->http.content_encoding = precomp[n].encoding;
+		}
+
+		if (best) {
+			lwsl_info("%s: %s: serving %s%s\n", __func__,
+				  lws_wsi_tag(wsi), path,
+				  wsi->http.content_encoding[0] == 'b' ?
+							".br" : ".gz");
+			lws_vfs_file_close(&wsi->http.fop_fd);
+			wsi->http.fop_fd = best;
+
+			return;
+		}
+	}
+
+#if defined(LWS_WITH_HTTP_STREAM_COMPRESSION) && defined(LWS_WITH_DISKCACHE)
+	{
+		struct lws_diskcache_scan *dc = wsi->a.vhost->http.comp_cache;
+		const char *enc = lws_http_compression_choose(wsi);
+		uint8_t hash[20];
+		char hex[41];
+		int cfd;
+
+		/* a range is served from the file itself, uncompressed */
+
+		if (!dc || !enc ||
+		    lws_hdr_total_length(wsi, WSI_TOKEN_HTTP_RANGE) ||
+		    !lws_http_compressible(lws_get_mimetype(path, m)))
+			return;
+
+		/* the cached output is for this version of the file */
+
+		n = lws_snprintf(sc, sizeof(sc), "%s %llu %lu %s", path,
+			(unsigned long long)lws_vfs_get_length(wsi->http.fop_fd),
+			(unsigned long)wsi->http.fop_fd->mod_time, enc);
+		lws_SHA1((uint8_t *)sc, (size_t)n, hash);
+		lws_hex_from_byte_array(hash, sizeof(hash), hex, sizeof(hex));
+
+		switch (lws_diskcache_query(dc, 0, hex, &cfd, sc, (int)sizeof(sc),
+					    &wsi->http.comp_cache_len)) {
+		case LWS_DISKCACHE_QUERY_EXISTS:
+			close(cfd);
+			fops = lws_vfs_select_fops(cx->fops, sc, &vpath);
+			fl = LWS_O_RDONLY;
+			fd = fops->LWS_FOP_OPEN(cx->fops, sc, vpath, &fl);
+			if (!fd)
+				/* it got trimmed just now */
+				return;
+
+			/* it has the mod time of the file it came from */
+			fd->mod_time = wsi->http.fop_fd->mod_time;
+			fd->flags |= LWS_FOP_FLAG_MOD_TIME_VALID;
+			lws_vfs_file_close(&wsi->http.fop_fd);
+			wsi->http.fop_fd = fd;
+			wsi->http.content_encoding = enc;
+
+			lwsl_info("%s: %s: %s from cache\n", __func__,
+				  lws_wsi_tag(wsi), path);
+			break;
+
+		case LWS_DISKCACHE_QUERY_CREATING:
+			/* lws_serve_http_file() starts the compression */
+			wsi->http.comp_cache_name = lws_strdup(sc);
+			if (!wsi->http.comp_cache_name) {
+				close(cfd);
+				unlink(sc);
+				break;
+			}
+			wsi->http.comp_cache_fd = cfd;
+			break;
+		}
+	}
+#endif
+}
+
+#endif
+
 static int
 lws_http_serve(struct lws *wsi, char *uri, const char *origin,
 	       const struct lws_http_mount *m)
@@ -676,6 +931,8 @@ lws_http_serve(struct lws *wsi, char *uri, const char *origin,
 	int n;
 
 	wsi->handling_404 = 0;
+	wsi->http.content_encoding = NULL;
+	wsi->http.vary_encoding = 0;
 	if (!wsi->a.vhost)
 		return -1;
 
@@ -762,9 +1019,16 @@ lws_http_serve(struct lws *wsi, char *uri, const char *origin,
 	if (spin == 5)
 		lwsl_err("symlink loop %s \n", path);
 
+#if !defined(WIN32) && !defined(LWS_PLAT_FREERTOS)
+	lws_http_serve_select_encoding(wsi, path, m);
+#endif
+
 	n = sprintf(sym, "%08llX%08lX",
 		    (unsigned long long)lws_vfs_get_length(wsi->http.fop_fd),
 		    (unsigned long)lws_vfs_get_mod_time(wsi->http.fop_fd));
+	if (wsi->http.content_encoding)
+		/* each encoding is a different representation */
+		n += sprintf(sym + n, "-%s", wsi->http.content_encoding);
 
 	/* disable ranges if IF_RANGE token invalid */
 
@@ -800,6 +1064,13 @@ lws_http_serve(struct lws *wsi, char *uri, const char *origin,
 					(unsigned char *)sym, n, &p, end))
 				return -1;
 
+			if (wsi->http.vary_encoding &&
+			    lws_add_http_header_by_token(wsi,
+					WSI_TOKEN_HTTP_VARY,
+					(unsigned char *)"Accept-Encoding", 15,
+					&p, end))
+				return -1;
+
 			/* but we still need to send cache control... */
 
 			if (m->cache_max_age && m->cache_reusable) {
@@ -2466,7 +2737,9 @@ upgrade_h2c:
 		wsi->http.ah = ah;
 
 		if (!wsi->h2.h2n) {
-			wsi->h2.h2n = lws_zalloc(sizeof(*wsi->h2.h2n), "h2n");
+			wsi->h2.h2n = lws_slab_zalloc(
+					&wsi->a.context->pt[(int)wsi->tsi],
+					LWS_SLAB_H2N, sizeof(*wsi->h2.h2n));
 			if (!wsi->h2.h2n)
 				return 1;
 		}
@@ -2801,6 +3074,16 @@ lws_serve_http_file(struct lws *wsi, const char *file, const char *content_type,
 	if (lws_add_http_header_status(wsi, (unsigned int)n, &p, end))
 		goto bail;
 
+	if (wsi->http.content_encoding) {
+		/* it's a precompressed or cached variant in this encoding */
+		if (lws_add_http_header_by_token(wsi,
+			WSI_TOKEN_HTTP_CONTENT_ENCODING,
+			(unsigned char *)wsi->http.content_encoding,
+			(int)strlen(wsi->http.content_encoding), &p, end))
+			goto bail;
+		wsi->http.content_encoding = NULL;
+		wsi->http.vary_encoding = 1;
+	} else
 	if ((wsi->http.fop_fd->flags & (LWS_FOP_FLAG_COMPR_ACCEPTABLE_GZIP |
 		       LWS_FOP_FLAG_COMPR_IS_GZIP)) ==
 	    (LWS_FOP_FLAG_COMPR_ACCEPTABLE_GZIP | LWS_FOP_FLAG_COMPR_IS_GZIP)) {
@@ -2818,13 +3101,28 @@ lws_serve_http_file(struct lws *wsi, const char *file, const char *content_type,
 		 * method that the client said he will accept
 		 */
 
-		if (!wsi->interpreting && (
-		     !strncmp(content_type, "text/", 5) ||
-		     !strcmp(content_type, "application/javascript") ||
-		     !strcmp(content_type, "image/svg+xml")))
+		if (!wsi->interpreting && lws_http_compressible(content_type)) {
+			wsi->http.vary_encoding = 1;
 			lws_http_compression_apply(wsi, NULL, &p, end, 0);
+		}
 	}
+#if defined(LWS_WITH_DISKCACHE)
+	if (!wsi->http.lcs
+#if defined(LWS_WITH_RANGES)
+			|| ranges
+#endif
+	)
+		/* the compression cache wanted the output, but there's none */
+		lws_http_compression_cache_abort(wsi);
 #endif
+#endif
+
+	if (wsi->http.vary_encoding) {
+		if (lws_add_http_header_by_token(wsi, WSI_TOKEN_HTTP_VARY,
+				(unsigned char *)"Accept-Encoding", 15, &p, end))
+			goto bail;
+		wsi->http.vary_encoding = 0;
+	}
 
 	if (
 #if defined(LWS_WITH_RANGES)
@@ -3025,6 +3323,36 @@ bail:
 
 #if defined(LWS_WITH_FILE_OPS)
 
+#if defined(LWS_HAVE_SYS_SENDFILE_H)
+/*
+ * Plain h1 with the file on the default platform fops can have the kernel
+ * send the file straight from the page cache.  So can h1 over tls, if the
+ * kernel is doing the tx encryption.  Anything that needs to see or change
+ * the content on the way out can't.
+ */
+
+static int
+lws_http_file_can_sendfile(struct lws *wsi)
+{
+	return lwsi_role_h1(wsi) && !wsi->mux_substream &&
+	       (!lws_is_ssl(wsi) || (lws_tls_ktls_state(wsi) &
+				     LWS_TLS_KTLS_TX)) &&
+	       !wsi->sending_chunked &&
+	       !wsi->interpreting &&
+#if defined(LWS_WITH_IO_URING)
+	       /* must not overtake the headers still queued */
+	       !lws_io_uring_tx_busy(wsi) &&
+#endif
+#if defined(LWS_WITH_HTTP_STREAM_COMPRESSION)
+	       !wsi->http.lcs &&
+#endif
+#if defined(LWS_WITH_RANGES)
+	       wsi->http.range.count_ranges < 2 &&
+#endif
+	       wsi->http.fop_fd->fops == &wsi->a.context->fops_platform;
+}
+#endif
+
 int lws_serve_http_file_fragment(struct lws *wsi)
 {
 	struct lws_context *context = wsi->a.context;
@@ -3118,6 +3446,58 @@ int lws_serve_http_file_fragment(struct lws *wsi)
 		}
 #endif
 
+#if defined(LWS_HAVE_SYS_SENDFILE_H)
+		if (lws_http_file_can_sendfile(wsi)) {
+			/*
+			 * There's no bounce buffer, so no need to restrict
+			 * ourselves to pt_serv_buf_size at a time... the
+			 * socket takes as much as it has room for
+			 */
+			poss = wsi->http.filelen - wsi->http.filepos;
+			if (wsi->a.protocol->tx_packet_size &&
+			    poss > wsi->a.protocol->tx_packet_size)
+				poss = wsi->a.protocol->tx_packet_size;
+#if defined(LWS_WITH_RANGES)
+			if (wsi->http.range.count_ranges &&
+			    poss > wsi->http.range.budget)
+				poss = wsi->http.range.budget;
+#endif
+
+			lws_set_timeout(wsi, PENDING_TIMEOUT_HTTP_CONTENT,
+					(int)context->timeout_secs);
+
+			m = lws_plat_file_sendfile(wsi->http.fop_fd,
+						   wsi->desc.sockfd, poss);
+			wsi->could_have_pending = 1;
+#if defined(LWS_WITH_SYS_METRICS)
+			lws_metric_event(wsi->a.vhost->mt_traffic_tx, (char)
+					 (m < 0 ? METRES_NOGO : METRES_GO),
+					 (u_mt_t)(m < 0 ? 0 : m));
+#endif
+			if (m < 0) {
+				wsi->socket_is_permanently_unusable = 1;
+				goto file_had_it;
+			}
+#ifdef LWS_WITH_ACCESS_LOG
+			wsi->http.access_log.sent += (unsigned int)m;
+#endif
+			wsi->http.filepos += (unsigned int)m;
+
+#if defined(LWS_WITH_RANGES)
+			if (wsi->http.range.count_ranges) {
+				wsi->http.range.budget -= (unsigned int)m;
+				if (!wsi->http.range.budget) {
+					wsi->http.range.inside = 0;
+					wsi->http.range.send_ctr++;
+					if (lws_ranges_next(&wsi->http.range) < 1)
+						finished = 1;
+				}
+			}
+#endif
+			goto all_sent;
+		}
+#endif
+
 		poss = context->pt_serv_buf_size;
 
 #if defined(LWS_ROLE_H2)
@@ -3310,7 +3690,11 @@ all_sent:
 		 * a hugely bloated output buffer if it ever can't send the
 		 * whole chunk...
 		 */
-	} while (!lws_send_pipe_choked(wsi));
+	} while (!lws_send_pipe_choked(wsi)
+#if defined(LWS_ROLE_H2)
+		 && !lws_h2_sched_yield(wsi)
+#endif
+		);
 
 	lws_callback_on_writable(wsi);
 
@@ -24,13 +24,42 @@
 
 #include <private-lib-core.h>
 
+/*
+ * With io_uring, a multishot accept may already have accepted them for us
+ */
+
+static lws_sockfd_type
+lws_listen_accept(struct lws *wsi, struct lws_filter_network_conn_args *filt)
+{
+#if defined(LWS_WITH_IO_URING)
+	if (wsi->a.context->event_loop_ops == &event_loop_ops_io_uring)
+		return lws_io_uring_accept(wsi,
+					   (struct sockaddr *)&filt->cli_addr,
+					   &filt->clilen);
+#endif
+
+	return accept((int)wsi->desc.sockfd, (struct sockaddr *)&filt->cli_addr,
+		      &filt->clilen);
+}
+
+static int
+lws_listen_more(struct lws_context_per_thread *pt, struct lws *wsi)
+{
+#if defined(LWS_WITH_IO_URING)
+	if (wsi->a.context->event_loop_ops == &event_loop_ops_io_uring)
+		return lws_io_uring_accept_pending(wsi);
+#endif
+
+	return lws_poll_listen_fd(&pt->fds[wsi->position_in_fds_table]) > 0;
+}
+
 static int
 rops_handle_POLLIN_listen(struct lws_context_per_thread *pt, struct lws *wsi,
 			  struct lws_pollfd *pollfd)
 {
 	struct lws_context *context = wsi->a.context;
 	struct lws_filter_network_conn_args filt;
-	lws_sock_file_fd_type fd;
+	lws_adopt_desc_t info;
 
 	memset(&filt, 0, sizeof(filt));
 
@@ -81,9 +110,7 @@ rops_handle_POLLIN_listen(struct lws_context_per_thread *pt, struct lws *wsi,
 		 * block the connect queue for other legit peers.
 		 */
 
-		filt.accept_fd = accept((int)pollfd->fd,
-					(struct sockaddr *)&filt.cli_addr,
-					&filt.clilen);
+		filt.accept_fd = lws_listen_accept(wsi, &filt);
 		if (filt.accept_fd == LWS_SOCK_INVALID) {
 			if (LWS_ERRNO == LWS_EAGAIN ||
 			    LWS_ERRNO == LWS_EWOULDBLOCK) {
@@ -143,9 +170,24 @@ rops_handle_POLLIN_listen(struct lws_context_per_thread *pt, struct lws *wsi,
 #endif
 			opts &= ~LWS_ADOPT_ALLOW_SSL;
 
-		fd.sockfd = filt.accept_fd;
-		cwsi = lws_adopt_descriptor_vhost(wsi->a.vhost, (lws_adoption_type)opts, fd,
-				wsi->a.vhost->listen_accept_protocol, NULL);
+		memset(&info, 0, sizeof(info));
+		info.vh = wsi->a.vhost;
+		info.type = (lws_adoption_type)opts;
+		info.fd.sockfd = filt.accept_fd;
+		info.vh_prot_name = wsi->a.vhost->listen_accept_protocol;
+
+		/*
+		 * If each pt has its own listen socket for this vhost and we
+		 * are sharding, the new connection stays on this pt
+		 */
+		cwsi = lws_adopt_descriptor_vhost_tsi(&info,
+#if defined(__linux__)
+				wsi->af != AF_UNIX &&
+				lws_check_opt(wsi->a.vhost->options,
+					LWS_SERVER_OPTION_SMP_LISTEN_SHARD) ?
+						wsi->tsi :
+#endif
+						-1);
 		if (!cwsi) {
 			lwsl_info("%s: vh %s: adopt failed\n", __func__,
 					wsi->a.vhost->name);
@@ -167,7 +209,7 @@ rops_handle_POLLIN_listen(struct lws_context_per_thread *pt, struct lws *wsi,
 
 	} while (pt->fds_count < context->fd_limit_per_thread - 1 &&
 		 wsi->position_in_fds_table != LWS_NO_FDS_POS &&
-		 lws_poll_listen_fd(&pt->fds[wsi->position_in_fds_table]) > 0);
+		 lws_listen_more(pt, wsi));
 
 	return LWS_HPI_RET_HANDLED;
 }
@@ -278,71 +278,262 @@ lws_mqtt_set_client_established(struct lws *wsi)
 }
 
 
-static lws_mqtt_match_topic_return_t
-lws_mqtt_is_topic_matched(const char* sub, const char* pub)
+static uint32_t
+lws_mqtt_trie_hash(const lws_mqtt_tnode_t *parent, const char *name,
+		   size_t len)
 {
-	const char *ppos = pub, *spos = sub;
+	/* FNV-1a over the level name, seeded with the parent node */
+	uint32_t h = 2166136261u ^ (uint32_t)(uintptr_t)parent;
 
-	if (!ppos || !spos) {
-		return LMMTR_TOPIC_MATCH_ERROR;
+	while (len--) {
+		h ^= (uint8_t)*name++;
+		h *= 16777619u;
 	}
 
-	while (*spos) {
-		if (*ppos == '#' || *ppos == '+') {
-			lwsl_err("%s: PUBLISH to wildcard "
-				 "topic \"%s\" not supported\n",
-				 __func__, pub);
-			return LMMTR_TOPIC_MATCH_ERROR;
-		}
-		/* foo/+/bar == foo/xyz/bar ? */
-		if (*spos == '+') {
-			/* Skip ahead */
-			while (*ppos != '\0' && *ppos != '/') {
-				ppos++;
-			}
-		} else if (*spos == '#') {
-			return LMMTR_TOPIC_MATCH;
-		} else {
-			if (*ppos == '\0') {
-				/* foo/bar == foo/bar/# ? */
-				if (!strncmp(spos, "/#", 2))
-					return LMMTR_TOPIC_MATCH;
-				return LMMTR_TOPIC_NOMATCH;
-			/* Non-matching character */
-			} else if (*ppos != *spos) {
-				return LMMTR_TOPIC_NOMATCH;
-			}
-			ppos++;
+	return h;
+}
+
+static lws_mqtt_tnode_t *
+lws_mqtt_trie_lookup(const lws_mqtt_trie_t *t, const lws_mqtt_tnode_t *parent,
+		     const char *name, size_t len)
+{
+	lws_mqtt_tnode_t *n;
+	uint32_t h;
+
+	if (!t->count_buckets)
+		return NULL;
+
+	h = lws_mqtt_trie_hash(parent, name, len);
+
+	for (n = t->buckets[h & (t->count_buckets - 1)]; n; n = n->hnext)
+		if (n->hval == h && n->parent == parent && n->len == len &&
+		    !memcmp(n->name, name, len))
+			return n;
+
+	return NULL;
+}
+
+static int
+lws_mqtt_trie_grow(lws_mqtt_trie_t *t)
+{
+	uint32_t count = t->count_buckets ? t->count_buckets * 2 : 16, b;
+	lws_mqtt_tnode_t **nb, *n, *n1;
+
+	nb = lws_zalloc(count * sizeof(*nb), "mqtt trie hash");
+	if (!nb)
+		return 1;
+
+	for (b = 0; b < t->count_buckets; b++)
+		for (n = t->buckets[b]; n; n = n1) {
+			n1 = n->hnext;
+			n->hnext = nb[n->hval & (count - 1)];
+			nb[n->hval & (count - 1)] = n;
 		}
-		spos++;
+
+	lws_free(t->buckets);
+	t->buckets = nb;
+	t->count_buckets = count;
+
+	return 0;
+}
+
+/* remove nodes that no longer lead to any subscription, from n upwards */
+
+static void
+lws_mqtt_trie_prune(lws_mqtt_trie_t *t, lws_mqtt_tnode_t *n)
+{
+	lws_mqtt_tnode_t **pn, *parent;
+
+	while (n && n->parent && !n->sub && !n->children) {
+		parent = n->parent;
+
+		if (parent->plus == n)
+			parent->plus = NULL;
+		if (parent->hash == n)
+			parent->hash = NULL;
+
+		pn = &t->buckets[n->hval & (t->count_buckets - 1)];
+		while (*pn != n)
+			pn = &(*pn)->hnext;
+		*pn = n->hnext;
+
+		parent->children--;
+		t->count_nodes--;
+		lws_free(n);
+		n = parent;
+	}
+}
+
+/*
+ * Find the node for a subscription filter, treating "+" and "#" as plain level
+ * names, optionally creating any missing nodes on the way
+ */
+
+static lws_mqtt_tnode_t *
+lws_mqtt_trie_filter(lws_mqtt_trie_t *t, const char *filter, int create)
+{
+	lws_mqtt_tnode_t *n, *c;
+	const char *e;
+	size_t len;
+
+	if (!t->root) {
+		if (!create)
+			return NULL;
+		t->root = lws_zalloc(sizeof(*t->root), "mqtt trie root");
+		if (!t->root)
+			return NULL;
 	}
 
-	if (*spos == '\0' && *ppos == '\0')
-		return LMMTR_TOPIC_MATCH;
+	n = t->root;
+	do {
+		e = strchr(filter, '/');
+		len = e ? lws_ptr_diff_size_t(e, filter) : strlen(filter);
+
+		c = lws_mqtt_trie_lookup(t, n, filter, len);
+		if (!c) {
+			if (!create)
+				return NULL;
+
+			if (t->count_nodes >= t->count_buckets &&
+			    lws_mqtt_trie_grow(t))
+				goto oom;
+
+			c = lws_zalloc(sizeof(*c) + len, "mqtt trie node");
+			if (!c)
+				goto oom;
 
-	return LMMTR_TOPIC_NOMATCH;
+			c->parent = n;
+			c->len = (uint16_t)len;
+			memcpy(c->name, filter, len);
+			c->hval = lws_mqtt_trie_hash(n, filter, len);
+			c->hnext = t->buckets[c->hval & (t->count_buckets - 1)];
+			t->buckets[c->hval & (t->count_buckets - 1)] = c;
+			t->count_nodes++;
+			n->children++;
+
+			if (len == 1 && *filter == '+')
+				n->plus = c;
+			if (len == 1 && *filter == '#')
+				n->hash = c;
+		}
+
+		n = c;
+		filter = e + 1;
+	} while (e);
+
+	return n;
+
+oom:
+	lws_mqtt_trie_prune(t, n);
+
+	return NULL;
 }
 
-lws_mqtt_subs_t* lws_mqtt_find_sub(struct _lws_mqtt_related* mqtt,
-				   const char* ptopic) {
-	lws_mqtt_subs_t *s = mqtt->subs_head;
+/*
+ * Walk the trie along the levels of a PUBLISH topic.  Where a level could go
+ * both ways, to a literal child and a "+" child, we try the literal one first
+ * and backtrack; otherwise it's just a loop.
+ */
 
-	while (s) {
-		/*  SUB topic  ==   PUB topic  ? */
-		/* foo/bar/xyz ==  foo/bar/xyz ? */
-		if (!s->wildcard) {
-			if (!strcmp((const char*)s->topic, ptopic))
-				return s;
-		} else {
-			if (lws_mqtt_is_topic_matched(
-			    s->topic, ptopic) == LMMTR_TOPIC_MATCH)
+static lws_mqtt_subs_t *
+lws_mqtt_trie_match(const lws_mqtt_trie_t *t, const lws_mqtt_tnode_t *n,
+		    const char *topic)
+{
+	const lws_mqtt_tnode_t *c;
+	lws_mqtt_subs_t *s;
+	const char *e;
+	size_t len;
+
+	while (1) {
+		/* a "#" here matches whatever is left, including nothing */
+		if (n->hash && n->hash->sub)
+			return n->hash->sub;
+
+		if (!topic) /* no more levels */
+			return n->sub;
+
+		e = strchr(topic, '/');
+		len = e ? lws_ptr_diff_size_t(e, topic) : strlen(topic);
+
+		c = lws_mqtt_trie_lookup(t, n, topic, len);
+		topic = e ? e + 1 : NULL;
+
+		if (c && n->plus) {
+			s = lws_mqtt_trie_match(t, c, topic);
+			if (s)
 				return s;
+			c = n->plus;
 		}
+		if (!c && !(c = n->plus))
+			return NULL;
 
-		s = s->next;
+		n = c;
 	}
+}
 
-	return NULL;
+/*
+ * Returns a subscription whose filter matches the PUBLISH topic, if any
+ */
+
+lws_mqtt_subs_t *
+lws_mqtt_find_sub(struct _lws_mqtt_related *mqtt, const char *ptopic)
+{
+	if (!mqtt->trie.root)
+		return NULL;
+
+	if (strpbrk(ptopic, "+#")) {
+		lwsl_err("%s: PUBLISH to wildcard topic \"%s\" not supported\n",
+			 __func__, ptopic);
+		return NULL;
+	}
+
+	return lws_mqtt_trie_match(&mqtt->trie, mqtt->trie.root, ptopic);
+}
+
+/*
+ * Returns the subscription with exactly this filter, if any
+ */
+
+lws_mqtt_subs_t *
+lws_mqtt_find_sub_exact(struct _lws_mqtt_related *mqtt, const char *filter)
+{
+	lws_mqtt_tnode_t *n = lws_mqtt_trie_filter(&mqtt->trie, filter, 0);
+
+	return n ? n->sub : NULL;
+}
+
+void
+lws_mqtt_destroy_sub(struct _lws_mqtt_related *mqtt, lws_mqtt_subs_t *s)
+{
+	lwsl_info("%s: Removing sub %p from wsi->mqtt %p\n", __func__, s, mqtt);
+
+	lws_dll2_remove(&s->list);
+	s->node->sub = NULL;
+	lws_mqtt_trie_prune(&mqtt->trie, s->node);
+	lws_free(s);
+}
+
+void
+lws_mqtt_destroy_subs(struct _lws_mqtt_related *mqtt)
+{
+	lws_mqtt_tnode_t *n, *n1;
+	uint32_t b;
+
+	lws_start_foreach_dll_safe(struct lws_dll2 *, d, d1,
+				   lws_dll2_get_head(&mqtt->subs)) {
+		lws_dll2_remove(d);
+		lws_free(lws_container_of(d, lws_mqtt_subs_t, list));
+	} lws_end_foreach_dll_safe(d, d1);
+
+	for (b = 0; b < mqtt->trie.count_buckets; b++)
+		for (n = mqtt->trie.buckets[b]; n; n = n1) {
+			n1 = n->hnext;
+			lws_free(n);
+		}
+
+	lws_free(mqtt->trie.buckets);
+	lws_free(mqtt->trie.root);
+	memset(&mqtt->trie, 0, sizeof(mqtt->trie));
 }
 
 static lws_mqtt_validate_topic_return_t
@@ -404,9 +595,10 @@ lws_mqtt_validate_topic(const char *topic, size_t topiclen, uint8_t awsiot)
 static lws_mqtt_subs_t *
 lws_mqtt_create_sub(struct _lws_mqtt_related *mqtt, const char *topic)
 {
+	lws_mqtt_validate_topic_return_t flag;
 	lws_mqtt_subs_t *mysub;
+	lws_mqtt_tnode_t *node;
 	size_t topiclen = strlen(topic);
-	lws_mqtt_validate_topic_return_t flag;
 
 	flag = lws_mqtt_validate_topic(topic, topiclen, mqtt->client.aws_iot);
 	switch (flag) {
@@ -423,14 +615,6 @@ lws_mqtt_create_sub(struct _lws_mqtt_related *mqtt, const char *topic)
 	case LMVTR_VALID:
 	case LMVTR_VALID_WILDCARD:
 	case LMVTR_VALID_SHADOW:
-		mysub = lws_malloc(sizeof(*mysub) + topiclen + 1, "sub");
-		if (!mysub) {
-			lwsl_err("%s: Error allocating mysub\n",
-				 __func__);
-			return NULL;
-		}
-		mysub->wildcard = (flag == LMVTR_VALID_WILDCARD);
-		mysub->shadow = (flag == LMVTR_VALID_SHADOW);
 		break;
 
 	default:
@@ -439,10 +623,38 @@ lws_mqtt_create_sub(struct _lws_mqtt_related *mqtt, const char *topic)
 		return NULL;
 	}
 
-	mysub->next = mqtt->subs_head;
-	mqtt->subs_head = mysub;
-	memcpy(mysub->topic, topic, strlen(topic) + 1);
+	node = lws_mqtt_trie_filter(&mqtt->trie, topic, 1);
+	if (!node) {
+		lwsl_err("%s: Error allocating trie\n", __func__);
+		return NULL;
+	}
+
+	if (node->sub) {
+		/*
+		 * Subscribed again, or again before the UNSUBACK for an
+		 * unsubscribe that took the ref_count to zero came
+		 */
+		node->sub->ref_count++;
+
+		return node->sub;
+	}
+
+	mysub = lws_malloc(sizeof(*mysub) + topiclen + 1, "sub");
+	if (!mysub) {
+		lwsl_err("%s: Error allocating mysub\n",
+			 __func__);
+		lws_mqtt_trie_prune(&mqtt->trie, node);
+		return NULL;
+	}
+
+	memset(&mysub->list, 0, sizeof(mysub->list));
+	mysub->wildcard = (flag == LMVTR_VALID_WILDCARD);
+	mysub->shadow = (flag == LMVTR_VALID_SHADOW);
+	memcpy(mysub->topic, topic, topiclen + 1);
 	mysub->ref_count = 1;
+	mysub->node = node;
+	node->sub = mysub;
+	lws_dll2_add_head(&mysub->list, &mqtt->subs);
 
 	lwsl_info("%s: Created mysub %p for wsi->mqtt %p\n",
 		  __func__, mysub, mqtt);
@@ -450,31 +662,23 @@ lws_mqtt_create_sub(struct _lws_mqtt_related *mqtt, const char *topic)
 	return mysub;
 }
 
-static int
+/*
+ * The server acknowledged we unsubscribed from topics nobody uses any more
+ */
+
+static void
 lws_mqtt_client_remove_subs(struct _lws_mqtt_related *mqtt)
 {
-	lws_mqtt_subs_t *s = mqtt->subs_head;
-	lws_mqtt_subs_t *temp = NULL;
-
-
 	lwsl_info("%s: Called to remove subs from wsi->mqtt %p\n",
 		  __func__, mqtt);
 
-	while (s && s->next) {
-		if (s->next->ref_count == 0)
-			break;
-		s = s->next;
-	}
+	lws_start_foreach_dll_safe(struct lws_dll2 *, d, d1,
+				   lws_dll2_get_head(&mqtt->subs)) {
+		lws_mqtt_subs_t *s = lws_container_of(d, lws_mqtt_subs_t, list);
 
-	if (s && s->next) {
-		temp = s->next;
-		lwsl_info("%s: Removing sub %p from wsi->mqtt %p\n",
-			  __func__, temp, mqtt);
-		s->next = temp->next;
-		lws_free(temp);
-		return 0;
-	}
-	return 1;
+		if (!s->ref_count)
+			lws_mqtt_destroy_sub(mqtt, s);
+	} lws_end_foreach_dll_safe(d, d1);
 }
 
 int
@@ -780,6 +984,8 @@ _lws_mqtt_rx_parser(struct lws *wsi, lws_mqtt_parser_t *par,
 				lwsl_debug("%s: PUBLISH pkt len = %d\n",
 					   __func__, (int)par->cpkt_remlen);
 				/* Move on to PUBLISH's variable header */
+				par->cpkt_id = 0;
+				par->n = 0;
 				par->state = LMQCPP_PUBLISH_VH_TOPIC;
 				break;
 			default:
@@ -790,49 +996,68 @@ _lws_mqtt_rx_parser(struct lws *wsi, lws_mqtt_parser_t *par,
 
 		case LMQCPP_PUBLISH_VH_TOPIC:
 		{
-			lws_mqtt_publish_param_t *pub = NULL;
+			lws_mqtt_publish_param_t *pub =
+				(lws_mqtt_publish_param_t *)wsi->mqtt->rx_cpkt_param;
+			size_t span;
 
-			if (len < 2) {
-				lwsl_notice("%s: topic too short\n", __func__);
-				return -1;
-			}
+			/*
+			 * The topic may arrive split across several reads.  We
+			 * collect its two-byte length first, then receive the
+			 * topic directly into pub->topic.
+			 */
 
-			/* Topic len */
-			par->n = lws_ser_ru16be(buf);
-			buf += 2;
-			len -= 2;
+			if (!pub) {
+				par->cpkt_id = (uint16_t)((par->cpkt_id << 8) |
+							  *buf++);
+				len--;
+				if (++par->n < 2)
+					break;
 
-			if (len < par->n) {/* the way this is written... */
-				lwsl_notice("%s: len breakage\n", __func__);
-				return -1;
-			}
+				/* Invalid topic len */
+				if (!par->cpkt_id ||
+				    2u + par->cpkt_id > par->cpkt_remlen) {
+					lwsl_notice("%s: bad topic len %d\n",
+						    __func__, (int)par->cpkt_id);
+					par->reason = LMQCP_REASON_MALFORMED_PACKET;
+					goto send_reason_and_close;
+				}
+				lwsl_debug("%s: PUBLISH topic len %d\n",
+					   __func__, (int)par->cpkt_id);
 
-			/* Invalid topic len */
-			if (par->n == 0) {
-				lwsl_notice("%s: zero topic len\n", __func__);
-				par->reason = LMQCP_REASON_MALFORMED_PACKET;
-				goto send_reason_and_close;
-			}
-			lwsl_debug("%s: PUBLISH topic len %d\n",
-				   __func__, (int)par->n);
-			assert(!wsi->mqtt->rx_cpkt_param);
-			wsi->mqtt->rx_cpkt_param = lws_zalloc(
-				sizeof(lws_mqtt_publish_param_t), "rx pub param");
-			if (!wsi->mqtt->rx_cpkt_param)
-				goto oom;
-			pub = (lws_mqtt_publish_param_t *)wsi->mqtt->rx_cpkt_param;
+				wsi->mqtt->rx_cpkt_param = lws_zalloc(
+					sizeof(lws_mqtt_publish_param_t),
+					"rx pub param");
+				if (!wsi->mqtt->rx_cpkt_param)
+					goto oom;
+				pub = (lws_mqtt_publish_param_t *)
+						wsi->mqtt->rx_cpkt_param;
 
-			pub->topic_len = (uint16_t)par->n;
+				pub->topic_len = par->cpkt_id;
 
-			/* Topic Name */
-			pub->topic = (char *)lws_zalloc((size_t)pub->topic_len + 1,
-							"rx publish topic");
-			if (!pub->topic)
-				goto oom;
-			lws_strncpy(pub->topic, (const char *)buf,
-				    (size_t)pub->topic_len + 1);
-			buf += pub->topic_len;
-			len -= pub->topic_len;
+				/*
+				 * Topic Name... if we fail, pub and the topic
+				 * are freed when the connection closes
+				 */
+				pub->topic = (char *)lws_zalloc(
+						(size_t)pub->topic_len + 1,
+						"rx publish topic");
+				if (!pub->topic)
+					goto oom;
+
+				par->n = 0;
+				if (!len)
+					break;
+			}
+
+			span = pub->topic_len - par->n;
+			if (span > len)
+				span = len;
+			memcpy(pub->topic + par->n, buf, span);
+			buf += span;
+			len -= span;
+			par->n += (uint32_t)span;
+			if (par->n < pub->topic_len)
+				break;
 
 			/* Extract QoS Level from Fixed Header Flags */
 			pub->qos = (lws_mqtt_qos_levels_t)
@@ -852,6 +1077,8 @@ _lws_mqtt_rx_parser(struct lws *wsi, lws_mqtt_parser_t *par,
 				break;
 			case QOS1:
 			case QOS2:
+				par->cpkt_id = 0;
+				par->n = 0;
 				par->state = LMQCPP_PUBLISH_VH_PKT_ID;
 				break;
 			default:
@@ -867,14 +1094,13 @@ _lws_mqtt_rx_parser(struct lws *wsi, lws_mqtt_parser_t *par,
 			lws_mqtt_publish_param_t *pub =
 				(lws_mqtt_publish_param_t *)wsi->mqtt->rx_cpkt_param;
 
-			if (len < 2) {
-				lwsl_notice("%s: len breakage 2\n", __func__);
-				return -1;
-			}
+			/* the packet id may be split across reads as well */
+
+			par->cpkt_id = (uint16_t)((par->cpkt_id << 8) | *buf++);
+			len--;
+			if (++par->n < 2)
+				break;
 
-			par->cpkt_id = lws_ser_ru16be(buf);
-			buf += 2;
-			len -= 2;
 			wsi->mqtt->peer_ack_pkt_id = par->cpkt_id;
 			lwsl_debug("%s: Packet ID %d\n",
 					__func__, (int)par->cpkt_id);
@@ -1318,7 +1544,7 @@ bail1:
 							LWS_CALLBACK_WSI_DESTROY,
 							NULL, NULL, 0);
 				__lws_vhost_unbind_wsi(w); /* cx + vh lock */
-				lws_free(w);
+				lws_slab_free(w);
 
 				return 0;
 
@@ -2088,7 +2314,7 @@ do_write:
 		 * we must RETRY the publish
 		 */
 		wsi->mqtt->sul_qos_puback_pubrec_wait.cb = lws_mqtt_publish_resend;
-		__lws_sul_insert_us(&pt->pt_sul_owner[wsi->conn_validity_wakesuspend],
+		__lws_sul_insert_us(pt, wsi->conn_validity_wakesuspend,
 				    &wsi->mqtt->sul_qos_puback_pubrec_wait,
 				    3 * LWS_USEC_PER_SEC);
 	}
@@ -2139,7 +2365,8 @@ lws_mqtt_client_send_subcribe(struct lws *wsi, lws_mqtt_subscribe_param_t *sub)
 			lwsl_info("%s: Subscribing to topic[%d] = \"%s\"\n",
 				  __func__, (int)n, sub->topic[n].name);
 
-			mysub = lws_mqtt_find_sub(nwsi->mqtt, sub->topic[n].name);
+			mysub = lws_mqtt_find_sub_exact(nwsi->mqtt,
+							sub->topic[n].name);
 			if (mysub && mysub->ref_count) {
 				mysub->ref_count++; /* another stream using it */
 				exists[n] = 1;
@@ -2301,8 +2528,8 @@ lws_mqtt_client_send_unsubcribe(struct lws *wsi,
 		orphaned = 0;
 		memset(&send_unsub, 0, sizeof(send_unsub));
 		for (n = 0; n < unsub->num_topics; n++) {
-			mysub = lws_mqtt_find_sub(nwsi->mqtt,
-						  unsub->topic[n].name);
+			mysub = lws_mqtt_find_sub_exact(nwsi->mqtt,
+							unsub->topic[n].name);
 			assert(mysub);
 
 			if (mysub && --mysub->ref_count == 0) {
@@ -2310,6 +2537,15 @@ lws_mqtt_client_send_unsubcribe(struct lws *wsi,
 				send_unsub[n] = 1;
 				orphaned++;
 			}
+
+			/* stop delivering it to this stream */
+
+			if (wsi == nwsi)
+				continue;
+			mysub = lws_mqtt_find_sub_exact(wsi->mqtt,
+							unsub->topic[n].name);
+			if (mysub && --mysub->ref_count == 0)
+				lws_mqtt_destroy_sub(wsi->mqtt, mysub);
 		}
 
 		if (!orphaned) {
@@ -2428,7 +2664,7 @@ lws_mqtt_client_send_unsubcribe(struct lws *wsi,
 	wsi->mqtt->inside_unsubscribe = 1;
 
 	wsi->mqtt->sul_unsuback_wait.cb = lws_mqtt_unsuback_timeout;
-	__lws_sul_insert_us(&pt->pt_sul_owner[wsi->conn_validity_wakesuspend],
+	__lws_sul_insert_us(pt, wsi->conn_validity_wakesuspend,
 			    &wsi->mqtt->sul_unsuback_wait,
 			    3 * LWS_USEC_PER_SEC);
 
@@ -2473,7 +2709,7 @@ bail1:
 		lws_free_set_NULL(wsi->user_space);
 
 	wsi->a.protocol->callback(wsi, LWS_CALLBACK_WSI_DESTROY, NULL, NULL, 0);
-	lws_free(wsi);
+	lws_slab_free(wsi);
 
 	return NULL;
 }
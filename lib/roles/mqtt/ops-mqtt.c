@@ -450,7 +450,7 @@ static int
 rops_close_role_mqtt(struct lws_context_per_thread *pt, struct lws *wsi)
 {
 	struct lws *nwsi = lws_get_network_wsi(wsi);
-	lws_mqtt_subs_t	*s, *s1, *mysub;
+	lws_mqtt_subs_t	*s, *mysub;
 	lws_mqttc_t *c;
 
 	if (!wsi->mqtt)
@@ -468,22 +468,23 @@ rops_close_role_mqtt(struct lws_context_per_thread *pt, struct lws *wsi)
 
 	/* clean up any subscription allocations */
 
-	s = wsi->mqtt->subs_head;
-	wsi->mqtt->subs_head = NULL;
-	while (s) {
-		s1 = s->next;
+	lws_start_foreach_dll(struct lws_dll2 *, d,
+			      lws_dll2_get_head(&wsi->mqtt->subs)) {
+		s = lws_container_of(d, lws_mqtt_subs_t, list);
 		/*
 		 * Account for children no longer using nwsi subscription
 		 */
-		mysub = lws_mqtt_find_sub(nwsi->mqtt, (const char *)&s[1]);
+		mysub = nwsi == wsi || !nwsi->mqtt ? NULL :
+			lws_mqtt_find_sub_exact(nwsi->mqtt, s->topic);
 //		assert(mysub); /* if child subscribed, nwsi must feel the same */
 		if (mysub) {
-			assert(mysub->ref_count);
-			mysub->ref_count--;
+			assert(mysub->ref_count >= s->ref_count);
+			mysub->ref_count = (uint8_t)(mysub->ref_count -
+						     s->ref_count);
 		}
-		lws_free(s);
-		s = s1;
-	}
+	} lws_end_foreach_dll(d);
+
+	lws_mqtt_destroy_subs(wsi->mqtt);
 
 	lws_mqtt_publish_param_t *pub =
 			(lws_mqtt_publish_param_t *)
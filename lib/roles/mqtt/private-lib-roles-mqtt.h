@@ -306,15 +306,11 @@ typedef enum {
 	LMVTR_FAILED_SHADOW_FORMAT		= -3,
 } lws_mqtt_validate_topic_return_t;
 
-typedef enum {
-	LMMTR_TOPIC_NOMATCH			= 0,
-	LMMTR_TOPIC_MATCH			= 1,
-
-	LMMTR_TOPIC_MATCH_ERROR			= -1
-} lws_mqtt_match_topic_return_t;
+typedef struct lws_mqtt_tnode lws_mqtt_tnode_t;
 
 typedef struct lws_mqtt_subs {
-	struct lws_mqtt_subs	*next;
+	lws_dll2_t		list; /* owner is mqtt->subs */
+	lws_mqtt_tnode_t	*node; /* the trie node for our last level */
 
 	uint8_t			ref_count; /* number of children referencing */
 
@@ -326,6 +322,38 @@ typedef struct lws_mqtt_subs {
 	char			topic[];
 } lws_mqtt_subs_t;
 
+/*
+ * Each mqtt object indexes its subscriptions in a trie with a node per topic
+ * level, so matching a PUBLISH topic costs in proportion to its depth, not to
+ * how many subscriptions there are.
+ *
+ * The children of every node live in one hash table per trie, keyed on the
+ * parent and the level name.  "+" and "#" children are in there too, but
+ * their parent also points to them directly, since matching always looks for
+ * them.
+ */
+
+struct lws_mqtt_tnode {
+	lws_mqtt_tnode_t	*hnext; /* hash bucket chain */
+	lws_mqtt_tnode_t	*parent; /* NULL only for the root */
+	lws_mqtt_tnode_t	*plus; /* our "+" child, if any */
+	lws_mqtt_tnode_t	*hash; /* our "#" child, if any */
+	lws_mqtt_subs_t		*sub; /* the filter ending at this level */
+	uint32_t		hval;
+	uint32_t		children; /* we're pruned when this and sub are 0 */
+	uint16_t		len;
+
+	/* level name overallocated here, not NUL terminated */
+	char			name[];
+};
+
+typedef struct lws_mqtt_trie {
+	lws_mqtt_tnode_t	*root;
+	lws_mqtt_tnode_t	**buckets;
+	uint32_t		count_buckets; /* 0, or a power of 2 */
+	uint32_t		count_nodes; /* not counting the root */
+} lws_mqtt_trie_t;
+
 typedef struct lws_mqtts {
 	lws_mqtt_parser_t	par;
 	lwsgs_mqtt_states_t	estate;
@@ -357,7 +385,8 @@ struct _lws_mqtt_related {
 	lws_sorted_usec_list_t	sul_unsuback_wait; /* QoS1 unsuback wait TO */
 	lws_sorted_usec_list_t	sul_qos2_pubrec_wait; /* QoS2 pubrec wait TO */
 	struct lws		*wsi; /**< so sul can use lws_container_of */
-	lws_mqtt_subs_t		*subs_head; /**< Linked-list of heap-allocated subscription objects */
+	lws_dll2_owner_t	subs; /**< heap-allocated subscription objects */
+	lws_mqtt_trie_t		trie; /**< subs indexed by topic level */
 	void			*rx_cpkt_param;
 	uint16_t		pkt_id;
 	uint16_t		ack_pkt_id;
@@ -437,5 +466,14 @@ lws_wsi_mqtt_adopt(struct lws *parent_wsi, struct lws *wsi);
 lws_mqtt_subs_t *
 lws_mqtt_find_sub(struct _lws_mqtt_related *mqtt, const char *topic);
 
+lws_mqtt_subs_t *
+lws_mqtt_find_sub_exact(struct _lws_mqtt_related *mqtt, const char *filter);
+
+void
+lws_mqtt_destroy_sub(struct _lws_mqtt_related *mqtt, lws_mqtt_subs_t *s);
+
+void
+lws_mqtt_destroy_subs(struct _lws_mqtt_related *mqtt);
+
 #endif /* _PRIVATE_LIB_ROLES_MQTT */
 
@@ -599,7 +599,7 @@ bail2:
 	__lws_lc_untag(wsi->a.context, &wsi->lc);
 	compatible_close(wsi->desc.sockfd);
 bail1:
-	lws_free(wsi);
+	lws_slab_free(wsi);
 bail:
 	return ret;
 }
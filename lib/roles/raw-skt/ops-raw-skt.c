@@ -112,6 +112,13 @@ rops_handle_POLLIN_raw_skt(struct lws_context_per_thread *pt, struct lws *wsi,
 			goto post_rx;
 #endif
 		default:
+#if defined(LWS_WITH_UDP_MMSG)
+			if (wsi->udp_mmsg) {
+				if (lws_udp_mmsg_rx(wsi))
+					goto fail;
+				goto try_pollout;
+			}
+#endif
 			ebuf.token = NULL;
 			ebuf.len = 0;
 
@@ -177,9 +184,28 @@ try_pollout:
 		return LWS_HPI_RET_HANDLED;
 
 #if defined(LWS_WITH_CLIENT)
-	if (lwsi_state(wsi) == LRS_WAITING_CONNECT &&
-	    !lws_client_connect_3_connect(wsi, NULL, NULL, 0, NULL))
-		return LWS_HPI_RET_WSI_ALREADY_DIED;
+	if (lwsi_state(wsi) == LRS_WAITING_CONNECT) {
+		if (!lws_client_connect_3_connect(wsi, NULL, NULL, 0, NULL))
+			return LWS_HPI_RET_WSI_ALREADY_DIED;
+
+		/*
+		 * If we are still waiting, it moved on to a new attempt that
+		 * wants its own POLLOUT, don't take it away
+		 */
+		if (lwsi_state(wsi) == LRS_WAITING_CONNECT)
+			return LWS_HPI_RET_HANDLED;
+	}
+#endif
+
+#if defined(LWS_WITH_UDP_MMSG)
+	/* batched udp tx the kernel pushed back on goes first */
+	if (wsi->udp_mmsg) {
+		n = lws_udp_flush(wsi);
+		if (n < 0)
+			goto fail;
+		if (n)
+			return LWS_HPI_RET_HANDLED;
+	}
 #endif
 
 	/* one shot */
@@ -199,6 +225,12 @@ try_pollout:
 		goto fail;
 	}
 
+#if defined(LWS_WITH_UDP_MMSG)
+	/* send whatever the callback queued */
+	if (wsi->udp_mmsg && lws_udp_flush(wsi) < 0)
+		goto fail;
+#endif
+
 	return LWS_HPI_RET_HANDLED;
 
 fail:
@@ -0,0 +1,455 @@
+/*
+ * libwebsockets - small server side websockets and web server implementation
+ *
+ * Copyright (C) 2010 - 2021 Andy Green <andy@warmcat.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *
+ * Batched UDP for raw-skt wsi created with LWS_CAUDP_MMSG.
+ *
+ * Each POLLIN drains up to a batch of datagrams with one recvmmsg(), and
+ * hands them to the protocol callback as an array in one
+ * LWS_CALLBACK_RAW_RX_BATCH.  With LWS_CAUDP_GRO, the kernel may coalesce
+ * a run of datagrams from one peer into one big buffer, we split them back
+ * out at the segment size it tells us in the cmsg.
+ *
+ * On tx, lws_udp_queue() copies datagrams into a contiguous per-wsi arena,
+ * which is sent with one sendmmsg() per flush.  With LWS_CAUDP_GSO, runs of
+ * same-size datagrams to the same peer, that are already contiguous in the
+ * arena, become one message with a UDP_SEGMENT cmsg, so the kernel only
+ * walks the stack once for the whole run.
+ */
+
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <private-lib-core.h>
+
+#include <netinet/udp.h>
+
+#if !defined(SOL_UDP)
+#define SOL_UDP 17
+#endif
+#if !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103
+#endif
+#if !defined(UDP_GRO)
+#define UDP_GRO 104
+#endif
+
+#define LWS_UDP_MMSG_BATCH	32	/* rx datagrams per recvmmsg() */
+#define LWS_UDP_MMSG_GRO_BATCH	8	/* rx buffers per recvmmsg() with GRO */
+#define LWS_UDP_MMSG_GRO_SLOT	65536	/* GRO can coalesce up to 64KB */
+#define LWS_UDP_MMSG_DGRAMS	256	/* max dgrams per RX_BATCH callback */
+#define LWS_UDP_MMSG_TX		64	/* also the kernel's UDP_MAX_SEGMENTS */
+#define LWS_UDP_MMSG_TX_ARENA	65536
+#define LWS_UDP_MMSG_MAX_DGRAM	65507
+
+#define LWS_UDP_MMSG_RX_CTL	CMSG_SPACE(sizeof(int))
+#define LWS_UDP_MMSG_TX_CTL	CMSG_SPACE(sizeof(uint16_t))
+
+typedef struct lws_udp_mmsg_txq {
+	size_t			ofs;
+	size_t			len;
+	lws_sockaddr46		sa46;
+} lws_udp_mmsg_txq_t;
+
+struct lws_udp_mmsg {
+	lws_udp_dgram_t		dg[LWS_UDP_MMSG_DGRAMS];
+
+	struct mmsghdr		tmsg[LWS_UDP_MMSG_TX];
+	struct iovec		tiov[LWS_UDP_MMSG_TX];
+	uint8_t			tctl[LWS_UDP_MMSG_TX][LWS_UDP_MMSG_TX_CTL];
+	uint8_t			trun[LWS_UDP_MMSG_TX];
+	lws_udp_mmsg_txq_t	tq[LWS_UDP_MMSG_TX];
+	uint8_t			tbuf[LWS_UDP_MMSG_TX_ARENA];
+
+	/* the rx arrays are overallocated after us, sized by batch */
+
+	struct mmsghdr		*rmsg;
+	struct iovec		*riov;
+	lws_sockaddr46		*rsa;
+	uint8_t			*rctl;
+	uint8_t			*rbuf;
+
+	size_t			slot;
+	size_t			tq_used;
+	unsigned int		batch;
+	unsigned int		tq_count;
+
+	uint8_t			gro:1;
+	uint8_t			gso:1;
+};
+
+int
+lws_udp_mmsg_create(struct lws *wsi, int flags)
+{
+	struct lws_udp_mmsg *m;
+	unsigned int batch = LWS_UDP_MMSG_BATCH;
+	size_t slot = wsi->a.context->pt_serv_buf_size, per;
+	uint8_t *p;
+
+	if (flags & LWS_CAUDP_GRO) {
+		batch = LWS_UDP_MMSG_GRO_BATCH;
+		slot = LWS_UDP_MMSG_GRO_SLOT;
+	}
+
+	per = sizeof(struct mmsghdr) + sizeof(struct iovec) +
+	      sizeof(lws_sockaddr46) + LWS_UDP_MMSG_RX_CTL + slot;
+
+	m = lws_zalloc(sizeof(*m) + (batch * per), "udp mmsg");
+	if (!m)
+		return 1;
+
+	/* with an even batch, each rx array keeps the next one aligned */
+
+	p = (uint8_t *)&m[1];
+	m->rmsg = (struct mmsghdr *)p;
+	p += batch * sizeof(struct mmsghdr);
+	m->riov = (struct iovec *)p;
+	p += batch * sizeof(struct iovec);
+	m->rsa = (lws_sockaddr46 *)p;
+	p += batch * sizeof(lws_sockaddr46);
+	m->rctl = p;
+	p += batch * LWS_UDP_MMSG_RX_CTL;
+	m->rbuf = p;
+
+	m->batch = batch;
+	m->slot = slot;
+	m->gro = !!(flags & LWS_CAUDP_GRO);
+	m->gso = !!(flags & LWS_CAUDP_GSO);
+
+	wsi->udp_mmsg = m;
+
+	return 0;
+}
+
+void
+lws_udp_mmsg_destroy(struct lws *wsi)
+{
+	lws_free_set_NULL(wsi->udp_mmsg);
+}
+
+void
+lws_udp_mmsg_skt_options(struct lws *wsi, lws_sockfd_type fd)
+{
+	int one = 1;
+
+	if (!wsi->udp_mmsg || !wsi->udp_mmsg->gro)
+		return;
+
+	if (setsockopt(fd, SOL_UDP, UDP_GRO, &one, sizeof(one)) < 0) {
+		/* the big rx buffers still work, we just get 1 dgram each */
+		lwsl_wsi_notice(wsi, "no UDP_GRO, errno %d", LWS_ERRNO);
+		wsi->udp_mmsg->gro = 0;
+	}
+}
+
+static int
+lws_udp_mmsg_deliver(struct lws *wsi, unsigned int count)
+{
+	return user_callback_handle_rxflow(wsi->a.protocol->callback, wsi,
+					   LWS_CALLBACK_RAW_RX_BATCH,
+					   wsi->user_space,
+					   wsi->udp_mmsg->dg, count) < 0;
+}
+
+/*
+ * Returns 0 if OK (including if there was nothing to read), or nonzero if the
+ * wsi should be closed
+ */
+
+int
+lws_udp_mmsg_rx(struct lws *wsi)
+{
+	struct lws_udp_mmsg *m = wsi->udp_mmsg;
+	unsigned int n, nd = 0;
+	size_t total = 0;
+	int got;
+
+	for (n = 0; n < m->batch; n++) {
+		struct msghdr *h = &m->rmsg[n].msg_hdr;
+
+		m->riov[n].iov_base = m->rbuf + (n * m->slot);
+		m->riov[n].iov_len = m->slot;
+
+		memset(h, 0, sizeof(*h));
+		h->msg_name = &m->rsa[n];
+		h->msg_namelen = sizeof(m->rsa[n]);
+		h->msg_iov = &m->riov[n];
+		h->msg_iovlen = 1;
+		if (m->gro) {
+			h->msg_control = m->rctl + (n * LWS_UDP_MMSG_RX_CTL);
+			h->msg_controllen = LWS_UDP_MMSG_RX_CTL;
+		}
+	}
+
+	got = recvmmsg(wsi->desc.sockfd, m->rmsg, m->batch, MSG_DONTWAIT, NULL);
+	if (got < 0) {
+		if (LWS_ERRNO == LWS_EAGAIN || LWS_ERRNO == LWS_EWOULDBLOCK ||
+		    LWS_ERRNO == LWS_EINTR)
+			return 0;
+
+		lwsl_wsi_info(wsi, "recvmmsg errno %d", LWS_ERRNO);
+
+		return 1;
+	}
+
+	for (n = 0; n < (unsigned int)got; n++) {
+		struct msghdr *h = &m->rmsg[n].msg_hdr;
+		size_t len = m->rmsg[n].msg_len, seg = len;
+		const uint8_t *p = m->rbuf + (n * m->slot);
+
+		if (h->msg_flags & MSG_TRUNC) {
+			lwsl_wsi_warn(wsi, "dropping truncated dgram");
+			continue;
+		}
+
+		if (m->gro) {
+			struct cmsghdr *cm;
+
+			for (cm = CMSG_FIRSTHDR(h); cm; cm = CMSG_NXTHDR(h, cm))
+				if (cm->cmsg_level == SOL_UDP &&
+				    cm->cmsg_type == UDP_GRO) {
+					int gs;
+
+					memcpy(&gs, CMSG_DATA(cm), sizeof(gs));
+					if (gs > 0)
+						seg = (size_t)gs;
+				}
+		}
+
+		/*
+		 * Without GRO this is one dgram, with GRO it's a run of seg
+		 * sized ones from the same peer, the last may be shorter
+		 */
+
+		do {
+			size_t l = len < seg ? len : seg;
+
+			if (!lws_fi(&wsi->fic, "udp_rx_loss")) {
+				m->dg[nd].buf = p;
+				m->dg[nd].len = l;
+				m->dg[nd].sa46 = m->rsa[n];
+				if (++nd == LWS_UDP_MMSG_DGRAMS) {
+					if (lws_udp_mmsg_deliver(wsi, nd))
+						return 1;
+					nd = 0;
+				}
+			}
+
+			p += l;
+			len -= l;
+			total += l;
+		} while (len);
+	}
+
+	/* so lws_write() and lws_udp_queue(NULL dest) reply to the last one */
+
+	if (got && wsi->udp)
+		wsi->udp->sa46 = m->rsa[got - 1];
+
+#if defined(LWS_WITH_SYS_METRICS) && defined(LWS_WITH_SERVER)
+	if (wsi->a.vhost)
+		lws_metric_event(wsi->a.vhost->mt_traffic_rx, METRES_GO,
+				 (u_mt_t)total);
+#else
+	(void)total;
+#endif
+
+	if (nd && lws_udp_mmsg_deliver(wsi, nd))
+		return 1;
+
+	/* send anything the callback queued as a response */
+
+	return lws_udp_flush(wsi) < 0;
+}
+
+int
+lws_udp_queue(struct lws *wsi, const uint8_t *buf, size_t len,
+	      const lws_sockaddr46 *dest)
+{
+	struct lws_udp_mmsg *m = wsi->udp_mmsg;
+	lws_udp_mmsg_txq_t *q;
+
+	if (!m || len > LWS_UDP_MMSG_MAX_DGRAM)
+		return -1;
+
+	if (lws_fi(&wsi->fic, "udp_tx_loss"))
+		/* pretend it was sent */
+		return 0;
+
+	if (m->tq_count == LWS_UDP_MMSG_TX ||
+	    m->tq_used + len > sizeof(m->tbuf)) {
+		/* no room, try to make some */
+		if (lws_udp_flush(wsi) < 0)
+			return -1;
+		if (m->tq_count == LWS_UDP_MMSG_TX ||
+		    m->tq_used + len > sizeof(m->tbuf))
+			return 1;
+	}
+
+	q = &m->tq[m->tq_count++];
+	q->ofs = m->tq_used;
+	q->len = len;
+	if (dest)
+		q->sa46 = *dest;
+	else
+		q->sa46 = wsi->udp->sa46;
+
+	memcpy(m->tbuf + m->tq_used, buf, len);
+	m->tq_used += len;
+
+#if defined(LWS_WITH_SYS_METRICS)
+	if (wsi->a.vhost)
+		lws_metric_event(wsi->a.vhost->mt_traffic_tx, METRES_GO, len);
+#endif
+
+	return 0;
+}
+
+static int
+lws_udp_mmsg_same_peer(const lws_sockaddr46 *a, const lws_sockaddr46 *b)
+{
+	if (a->sa4.sin_family != b->sa4.sin_family)
+		return 0;
+
+	return !memcmp(a, b, sa46_socklen(a));
+}
+
+int
+lws_udp_flush(struct lws *wsi)
+{
+	struct lws_udp_mmsg *m = wsi->udp_mmsg;
+	unsigned int i, n, nm = 0, done = 0;
+	size_t base;
+	int sent;
+
+	if (!m)
+		return -1;
+
+	if (!m->tq_count)
+		return 0;
+
+	for (i = 0; i < m->tq_count; i += m->trun[nm++]) {
+		struct msghdr *h = &m->tmsg[nm].msg_hdr;
+		size_t seg = m->tq[i].len, tot = seg;
+		unsigned int run = 1;
+
+		/*
+		 * With GSO, extend the run while the next dgram goes to the
+		 * same peer and isn't bigger than the segment size... only the
+		 * last one in a run may be shorter than the others
+		 */
+
+		if (m->gso && seg)
+			while (i + run < m->tq_count &&
+			       run < LWS_UDP_MMSG_TX &&
+			       m->tq[i + run - 1].len == seg &&
+			       m->tq[i + run].len &&
+			       m->tq[i + run].len <= seg &&
+			       tot + m->tq[i + run].len <= LWS_UDP_MMSG_MAX_DGRAM &&
+			       lws_udp_mmsg_same_peer(&m->tq[i].sa46,
+						      &m->tq[i + run].sa46)) {
+				tot += m->tq[i + run].len;
+				run++;
+			}
+
+		m->trun[nm] = (uint8_t)run;
+		m->tiov[nm].iov_base = m->tbuf + m->tq[i].ofs;
+		m->tiov[nm].iov_len = tot;
+
+		memset(h, 0, sizeof(*h));
+		h->msg_iov = &m->tiov[nm];
+		h->msg_iovlen = 1;
+		if (m->tq[i].sa46.sa4.sin_family) {
+			h->msg_name = &m->tq[i].sa46;
+			h->msg_namelen = sa46_socklen(&m->tq[i].sa46);
+		}
+
+		if (run > 1) {
+			struct cmsghdr *cm;
+			uint16_t gs = (uint16_t)seg;
+
+			h->msg_control = m->tctl[nm];
+			h->msg_controllen = LWS_UDP_MMSG_TX_CTL;
+			cm = CMSG_FIRSTHDR(h);
+			cm->cmsg_level = SOL_UDP;
+			cm->cmsg_type = UDP_SEGMENT;
+			cm->cmsg_len = CMSG_LEN(sizeof(gs));
+			memcpy(CMSG_DATA(cm), &gs, sizeof(gs));
+		}
+	}
+
+	sent = sendmmsg(wsi->desc.sockfd, m->tmsg, nm,
+			MSG_DONTWAIT | MSG_NOSIGNAL);
+	if (sent < 0) {
+		if (LWS_ERRNO == LWS_EAGAIN || LWS_ERRNO == LWS_EWOULDBLOCK ||
+		    LWS_ERRNO == LWS_EINTR || LWS_ERRNO == ENOBUFS)
+			sent = 0;
+		else {
+			if (m->gso && (LWS_ERRNO == EIO ||
+				       LWS_ERRNO == EINVAL ||
+				       LWS_ERRNO == ENOPROTOOPT)) {
+				/*
+				 * Some kernels or devices can't do it, just
+				 * send them as separate dgrams from now on
+				 */
+				lwsl_wsi_notice(wsi, "no UDP GSO, errno %d",
+						LWS_ERRNO);
+				m->gso = 0;
+
+				return lws_udp_flush(wsi);
+			}
+
+			lwsl_wsi_info(wsi, "sendmmsg errno %d", LWS_ERRNO);
+
+			return -1;
+		}
+	}
+
+	for (n = 0; n < (unsigned int)sent; n++)
+		done += m->trun[n];
+
+	if (done == m->tq_count) {
+		m->tq_count = 0;
+		m->tq_used = 0;
+
+		return 0;
+	}
+
+	/* the kernel pushed back, keep what's left at the start */
+
+	if (done) {
+		base = m->tq[done].ofs;
+		memmove(m->tbuf, m->tbuf + base, m->tq_used - base);
+		m->tq_used -= base;
+		m->tq_count -= done;
+		for (n = 0; n < m->tq_count; n++) {
+			m->tq[n] = m->tq[n + done];
+			m->tq[n].ofs -= base;
+		}
+	}
+
+	lws_callback_on_writable(wsi);
+
+	return 1;
+}
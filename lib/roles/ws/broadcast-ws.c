@@ -0,0 +1,427 @@
+/*
+ * libwebsockets - small server side websockets and web server implementation
+ *
+ * Copyright (C) 2010 - 2021 Andy Green <andy@warmcat.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * Encode-once ws broadcast
+ *
+ * A broadcast object holds one copy of the message payload, and a list of
+ * "variants", the complete ws frame as it goes on the wire for each distinct
+ * way the connections it was queued on need it.  Variants are made lazily the
+ * first time a connection needing that wire format becomes writeable, so the
+ * message is compressed at most once per permessage-deflate configuration,
+ * however many connections it goes to.
+ *
+ * Each connection has a small ring of references to the broadcasts queued on
+ * it.  The last reference to go frees the broadcast and its variants.
+ */
+
+#include <private-lib-core.h>
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+#include "ext/extension-permessage-deflate.h"
+#endif
+
+typedef struct lws_ws_bcast_variant {
+	struct lws_ws_bcast_variant	*next;
+	uint8_t				*frame; /* into our own allocation */
+	size_t				len;
+	uint16_t			key; /* 0 = uncompressed */
+} lws_ws_bcast_variant_t;
+
+struct lws_ws_bcast {
+	lws_ws_bcast_variant_t		*variants;
+	size_t				len;
+	unsigned int			refcount;
+	uint8_t				opcode;
+
+	/* payload follows */
+};
+
+#define LWS_WS_BCAST_QUEUE_MAX 0x8000
+
+/*
+ * Write a server -> client (unmasked) frame header ending at end, return its
+ * length
+ */
+
+static size_t
+bcast_hdr(uint8_t *end, uint8_t b0, size_t len)
+{
+	uint64_t l = (uint64_t)len;
+	int n;
+
+	if (len < 126) {
+		end[-2] = b0;
+		end[-1] = (uint8_t)len;
+
+		return 2;
+	}
+
+	if (len < 65536) {
+		end[-4] = b0;
+		end[-3] = 126;
+		end[-2] = (uint8_t)(len >> 8);
+		end[-1] = (uint8_t)len;
+
+		return 4;
+	}
+
+	end[-10] = b0;
+	end[-9] = 127;
+	for (n = 1; n <= 8; n++) {
+		end[-n] = (uint8_t)l;
+		l >>= 8;
+	}
+
+	return 10;
+}
+
+/*
+ * Work out which variant wsi needs.  Returns nonzero if it has an active
+ * extension we can't prepare frames for.
+ *
+ * For permessage-deflate, the variant key is made from the negotiated window
+ * size and the compression settings, so connections agreeing on those share
+ * one compressed frame.  zlib can't make raw deflate with a 256-byte window,
+ * which is why the pmd code bumps 8 to 9... but a peer that negotiated 8
+ * can't take a 512-byte window from us, so it gets the message uncompressed,
+ * which permessage-deflate always allows.
+ */
+
+static int
+bcast_key(struct lws *wsi, uint16_t *key, void **ppriv)
+{
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+	struct lws_ext_pm_deflate_priv *priv;
+	int n;
+#endif
+
+	*key = 0;
+	*ppriv = NULL;
+
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+	for (n = 0; n < wsi->ws->count_act_ext; n++) {
+		if (wsi->ws->active_extensions[n]->callback !=
+					lws_extension_callback_pm_deflate)
+			return 1;
+
+		priv = (struct lws_ext_pm_deflate_priv *)
+						wsi->ws->act_ext_user[n];
+		*ppriv = priv;
+		if (priv->args[PMD_SERVER_MAX_WINDOW_BITS] < 9)
+			continue;
+
+		*key = (uint16_t)(0x8000 | (priv->args[PMD_COMP_LEVEL] << 8) |
+				  (priv->args[PMD_MEM_LEVEL] << 4) |
+				  priv->args[PMD_SERVER_MAX_WINDOW_BITS]);
+	}
+#endif
+
+	return 0;
+}
+
+static lws_ws_bcast_variant_t *
+bcast_variant(struct lws_ws_bcast *b, uint16_t key)
+{
+	const uint8_t *payload = (const uint8_t *)&b[1];
+	lws_ws_bcast_variant_t *v;
+	size_t h;
+	uint8_t *p;
+
+	for (v = b->variants; v; v = v->next)
+		if (v->key == key)
+			return v;
+
+	if (!key) {
+		v = lws_malloc(sizeof(*v) + 10 + b->len, "ws bcast variant");
+		if (!v)
+			return NULL;
+
+		p = (uint8_t *)&v[1] + 10;
+		memcpy(p, payload, b->len);
+		h = bcast_hdr(p, (uint8_t)(0x80 | b->opcode), b->len);
+		v->frame = p - h;
+		v->len = h + b->len;
+	} else {
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+		z_stream z;
+		size_t bound;
+		int n;
+
+		/*
+		 * A fresh raw deflate stream for every variant is what makes
+		 * the result decodable by any peer, whatever its inflate
+		 * context has seen before
+		 */
+
+		memset(&z, 0, sizeof(z));
+		if (deflateInit2(&z, (key >> 8) & 0xf, Z_DEFLATED,
+				 -(int)(key & 0xf), (key >> 4) & 0xf,
+				 Z_DEFAULT_STRATEGY) != Z_OK) {
+			lwsl_err("%s: deflateInit2 failed\n", __func__);
+			return NULL;
+		}
+
+		/* room for the SYNC_FLUSH trailer and a little more */
+		bound = (size_t)deflateBound(&z, (uLong)b->len) + 16;
+
+		v = lws_malloc(sizeof(*v) + 10 + bound, "ws bcast variant");
+		if (!v) {
+			deflateEnd(&z);
+			return NULL;
+		}
+
+		p = (uint8_t *)&v[1] + 10;
+		z.next_in = (unsigned char *)payload;
+		z.avail_in = (uInt)b->len;
+		z.next_out = p;
+		z.avail_out = (uInt)bound;
+
+		n = deflate(&z, Z_SYNC_FLUSH);
+		deflateEnd(&z);
+		if (n != Z_OK || z.avail_in || !z.avail_out ||
+		    bound - z.avail_out < 4) {
+			lwsl_err("%s: deflate failed %d\n", __func__, n);
+			lws_free(v);
+
+			return NULL;
+		}
+
+		/* RFC7692 7.2.1: drop the 00 00 ff ff from the end */
+
+		v->len = bound - z.avail_out - 4;
+		h = bcast_hdr(p, (uint8_t)(0x80 | 0x40 | b->opcode), v->len);
+		v->frame = p - h;
+		v->len += h;
+#else
+		return NULL;
+#endif
+	}
+
+	v->key = key;
+	v->next = b->variants;
+	b->variants = v;
+
+	return v;
+}
+
+struct lws_ws_bcast *
+lws_ws_bcast_create(const uint8_t *buf, size_t len, enum lws_write_protocol wp)
+{
+	struct lws_ws_bcast *b;
+
+	if (((int)wp & 0x1f) != LWS_WRITE_TEXT &&
+	    ((int)wp & 0x1f) != LWS_WRITE_BINARY) {
+		lwsl_err("%s: only TEXT or BINARY\n", __func__);
+
+		return NULL;
+	}
+
+	b = lws_malloc(sizeof(*b) + len, "ws bcast");
+	if (!b)
+		return NULL;
+
+	memset(b, 0, sizeof(*b));
+	b->len = len;
+	b->refcount = 1;
+	b->opcode = ((int)wp & 0x1f) == LWS_WRITE_TEXT ? LWSWSOPC_TEXT_FRAME :
+							 LWSWSOPC_BINARY_FRAME;
+	if (len)
+		memcpy(&b[1], buf, len);
+
+	return b;
+}
+
+void
+lws_ws_bcast_release(struct lws_ws_bcast *b)
+{
+	lws_ws_bcast_variant_t *v;
+
+	if (!b || --b->refcount)
+		return;
+
+	while (b->variants) {
+		v = b->variants;
+		b->variants = v->next;
+		lws_free(v);
+	}
+
+	lws_free(b);
+}
+
+int
+lws_ws_bcast_queue(struct lws *wsi, struct lws_ws_bcast *b)
+{
+	struct _lws_websocket_related *ws = wsi->ws;
+	struct lws_ws_bcast **q;
+	unsigned int n, ns;
+	uint16_t key;
+	void *priv;
+
+	if (!lwsi_role_ws(wsi) || !ws || lwsi_role_client(wsi) ||
+	    wsi->mux_substream || bcast_key(wsi, &key, &priv))
+		return 1;
+
+	if (ws->bcq_count == ws->bcq_size) {
+		ns = ws->bcq_size ? (unsigned int)ws->bcq_size * 2u : 4u;
+		if (ns > LWS_WS_BCAST_QUEUE_MAX) {
+			lwsl_wsi_notice(wsi, "bcast queue full");
+			return -1;
+		}
+
+		q = lws_malloc(ns * sizeof(*q), "ws bcast q");
+		if (!q)
+			return -1;
+
+		/* unwrap the old ring into the start of the new one */
+		for (n = 0; n < ws->bcq_count; n++)
+			q[n] = ws->bcq[(ws->bcq_head + n) & (ws->bcq_size - 1u)];
+
+		lws_free(ws->bcq);
+		ws->bcq = q;
+		ws->bcq_head = 0;
+		ws->bcq_size = (uint16_t)ns;
+	}
+
+	ws->bcq[(ws->bcq_head + ws->bcq_count) & (ws->bcq_size - 1u)] = b;
+	ws->bcq_count++;
+	b->refcount++;
+
+	lws_callback_on_writable(wsi);
+
+	return 0;
+}
+
+unsigned int
+lws_ws_bcast_pending(struct lws *wsi)
+{
+	return wsi->ws ? wsi->ws->bcq_count : 0;
+}
+
+/*
+ * Called from ws POLLOUT handling, after control frames, before the user
+ * code gets a WRITEABLE callback.  Returns 0 if the queue was emptied, or
+ * wasn't serviceable right now, 1 if the connection choked and we should
+ * come back, or -1 if the connection failed.
+ */
+
+int
+lws_ws_bcast_drain(struct lws *wsi)
+{
+	struct _lws_websocket_related *ws = wsi->ws;
+	lws_ws_bcast_variant_t *v;
+	struct lws_ws_bcast *b;
+	uint16_t key;
+	void *priv;
+	int m, partial;
+
+	/*
+	 * Never put a broadcast in the middle of a message we are sending...
+	 * if we held one back, we'll be asked back when the message ends
+	 */
+
+	if (lwsi_state(wsi) != LRS_ESTABLISHED || ws->inside_frame ||
+	    ws->tx_msg_open || ws->stashed_write_pending
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+	    || ws->tx_draining_ext
+#endif
+	)
+		return 0;
+
+	if (bcast_key(wsi, &key, &priv))
+		return -1;
+
+	while (ws->bcq_count) {
+		b = ws->bcq[ws->bcq_head];
+
+		v = bcast_variant(b, key);
+		if (!v)
+			return -1;
+
+		/*
+		 * The variant is stable until we drop our ref, so normally
+		 * it goes on the wire directly from there.  If the socket
+		 * doesn't take all of it, the rest is buffered the same as
+		 * lws_issue_raw() does, so it retains the same priority over
+		 * everything else to follow.
+		 */
+
+		m = lws_ssl_capable_write(wsi, v->frame, v->len);
+		wsi->could_have_pending = 1;
+		if (m == LWS_SSL_CAPABLE_ERROR) {
+			wsi->socket_is_permanently_unusable = 1;
+			return -1;
+		}
+		if (m < 0)
+			m = 0;
+
+		partial = (size_t)m != v->len;
+		if (partial &&
+		    lws_buflist_append_segment(&wsi->buflist_out,
+					       v->frame + m,
+					       v->len - (size_t)m) < 0)
+			return -1;
+
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+		/*
+		 * If our own compressor keeps context across messages, its
+		 * history no longer matches what the peer's inflater has
+		 * seen, since that now includes this broadcast
+		 */
+		if (key && ((struct lws_ext_pm_deflate_priv *)priv)->tx_init)
+			deflateReset(
+				&((struct lws_ext_pm_deflate_priv *)priv)->tx);
+#endif
+
+		ws->bcq_head = (uint16_t)((ws->bcq_head + 1u) &
+					  (ws->bcq_size - 1u));
+		ws->bcq_count--;
+		lws_ws_bcast_release(b);
+
+		if (partial) {
+			lws_callback_on_writable(wsi);
+
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+void
+lws_ws_bcast_drop_queue(struct lws *wsi)
+{
+	struct _lws_websocket_related *ws = wsi->ws;
+
+	if (!ws || !ws->bcq)
+		return;
+
+	while (ws->bcq_count) {
+		lws_ws_bcast_release(ws->bcq[ws->bcq_head]);
+		ws->bcq_head = (uint16_t)((ws->bcq_head + 1u) &
+					  (ws->bcq_size - 1u));
+		ws->bcq_count--;
+	}
+
+	lws_free_set_NULL(ws->bcq);
+	ws->bcq_head = 0;
+	ws->bcq_size = 0;
+}
@@ -49,7 +49,8 @@ lws_create_client_ws_object(const struct lws_client_connect_info *i,
 	int v = SPEC_LATEST_SUPPORTED;
 
 	/* allocate the ws struct for the wsi */
-	wsi->ws = lws_zalloc(sizeof(*wsi->ws), "client ws struct");
+	wsi->ws = lws_slab_zalloc(&wsi->a.context->pt[(int)wsi->tsi],
+				  LWS_SLAB_WS, sizeof(*wsi->ws));
 	if (!wsi->ws) {
 		lwsl_wsi_notice(wsi, "OOM");
 		return 1;
@@ -66,10 +67,96 @@ lws_create_client_ws_object(const struct lws_client_connect_info *i,
 }
 
 #if defined(LWS_WITH_CLIENT)
+/*
+ * If the chunk of payload the rx state machine would spill next (the rest of
+ * the frame, or an rx_ubuf full of it) is already sitting in the read buffer,
+ * pass it to the user callback from there instead of copying it through
+ * rx_ubuf.  The callback sees exactly the same sequence of chunks either way.
+ *
+ * Users expect the payload to be NUL-terminated like it is in rx_ubuf, so we
+ * only do it if the buffer continues past the chunk, and restore that byte
+ * afterwards.  Extensions and anything already partly collected in rx_ubuf
+ * take the usual path.
+ *
+ * Returns the number of bytes used, 0 if we didn't do anything, or -1 if the
+ * connection must be dropped.
+ */
+
+static int
+lws_ws_client_frame_is_payload(struct lws *wsi, uint8_t *buf, size_t len)
+{
+	size_t n = wsi->a.protocol->rx_buffer_size ?
+			wsi->a.protocol->rx_buffer_size :
+			wsi->a.context->pt_serv_buf_size;
+	uint8_t c;
+	int m;
+
+	if (wsi->lws_rx_parse_state != LWS_RXPS_WS_FRAME_PAYLOAD ||
+	    wsi->ws->rx_ubuf_head || wsi->ws->this_frame_masked ||
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+	    wsi->ws->count_act_ext ||
+#endif
+	    (wsi->ws->opcode != LWSWSOPC_TEXT_FRAME &&
+	     wsi->ws->opcode != LWSWSOPC_BINARY_FRAME &&
+	     wsi->ws->opcode != LWSWSOPC_CONTINUATION))
+		return 0;
+
+	if (n > wsi->ws->rx_packet_length)
+		n = wsi->ws->rx_packet_length;
+	if (!n || n >= len)
+		return 0;
+
+	wsi->ws->rx_packet_length -= n;
+	if (!wsi->ws->rx_packet_length)
+		wsi->lws_rx_parse_state = LWS_RXPS_NEW;
+
+	if (wsi->ws->check_utf8 && !wsi->ws->defeat_check_utf8) {
+		if (lws_check_utf8(&wsi->ws->utf8, buf, n)) {
+			lws_close_reason(wsi, LWS_CLOSE_STATUS_INVALID_PAYLOAD,
+					 (uint8_t *)"bad utf8", 8);
+			goto utf8_fail;
+		}
+
+		/* we are ending partway through utf-8 character? */
+		if (!wsi->ws->rx_packet_length && wsi->ws->final &&
+		    wsi->ws->utf8) {
+			lwsl_wsi_info(wsi, "FINAL utf8 error");
+			lws_close_reason(wsi, LWS_CLOSE_STATUS_INVALID_PAYLOAD,
+					 (uint8_t *)"partial utf8", 12);
+utf8_fail:
+			lwsl_wsi_info(wsi, "utf8 error");
+			lwsl_hexdump_wsi_info(wsi, buf, n);
+
+			return -1;
+		}
+	}
+
+	if (!wsi->a.protocol->callback ||
+	    lwsi_state(wsi) == LRS_RETURNED_CLOSE ||
+	    lwsi_state(wsi) == LRS_WAITING_TO_SEND_CLOSE ||
+	    lwsi_state(wsi) == LRS_AWAITING_CLOSE_ACK)
+		return (int)n;
+
+	c = buf[n];
+	buf[n] = '\0';
+	m = wsi->a.protocol->callback(wsi, LWS_CALLBACK_CLIENT_RECEIVE,
+				      wsi->user_space, buf, n);
+	buf[n] = c;
+
+	wsi->ws->first_fragment = 0;
+
+	/* if user code wants to close, let caller know */
+	if (m)
+		return -1;
+
+	return (int)n;
+}
+
 int
 lws_ws_handshake_client(struct lws *wsi, unsigned char **buf, size_t len)
 {
 	unsigned char *bufin = *buf;
+	int m;
 
 	if ((lwsi_state(wsi) != LRS_WAITING_PROXY_REPLY) &&
 	    (lwsi_state(wsi) != LRS_H1C_ISSUE_HANDSHAKE) &&
@@ -79,6 +166,10 @@ lws_ws_handshake_client(struct lws *wsi, unsigned char **buf, size_t len)
 
 	lwsl_wsi_debug(wsi, "hs client feels it has %d in", (int)len);
 
+	if (len && wsi->ws && wsi->ws->rx_ubuf_alloc && !wsi->ws->rx_ubuf &&
+	    lws_ws_rx_ubuf_borrow(wsi))
+		return -1;
+
 	while (len) {
 		/*
 		 * we were accepting input but now we stopped doing so
@@ -108,12 +199,12 @@ lws_ws_handshake_client(struct lws *wsi, unsigned char **buf, size_t len)
 			} else
 				*buf += len;
 
+			lws_ws_rx_ubuf_idle(wsi);
+
 			return 0;
 		}
 #if !defined(LWS_WITHOUT_EXTENSIONS)
 		if (wsi->ws->rx_draining_ext) {
-			int m;
-
 			lwsl_wsi_info(wsi, "draining ext");
 			if (lwsi_role_client(wsi))
 				m = lws_ws_client_rx_sm(wsi, 0);
@@ -124,6 +215,66 @@ lws_ws_handshake_client(struct lws *wsi, unsigned char **buf, size_t len)
 			continue;
 		}
 #endif
+		/* take the rest of the frame header in one go if we can */
+		if (wsi->lws_rx_parse_state == LWS_RXPS_04_FRAME_HDR_LEN) {
+			size_t h = lws_ws_rx_hdr_bulk(wsi, *buf, len);
+
+			*buf += h;
+			len -= h;
+			if (!len)
+				break;
+		}
+
+		m = lws_ws_client_frame_is_payload(wsi, *buf, len);
+		if (m < 0) {
+			lwsl_wsi_info(wsi, "frame_is_payload bailed");
+			return -1;
+		}
+		if (m) {
+			*buf += m;
+			len -= (size_t)m;
+			continue;
+		}
+
+		/*
+		 * Collect payload in bulk, except the byte that completes the
+		 * frame or fills rx_ubuf... the state machine must see that
+		 * one, so it can spill
+		 */
+
+		if (wsi->lws_rx_parse_state == LWS_RXPS_WS_FRAME_PAYLOAD) {
+			size_t n = wsi->a.protocol->rx_buffer_size ?
+					wsi->a.protocol->rx_buffer_size :
+					wsi->a.context->pt_serv_buf_size;
+			uint8_t *p;
+
+			n = n > wsi->ws->rx_ubuf_head ?
+					n - wsi->ws->rx_ubuf_head : 0;
+			if (n > wsi->ws->rx_packet_length)
+				n = wsi->ws->rx_packet_length;
+			if (n > len)
+				n = len;
+
+			if (n > 1) {
+				n--;
+				p = &wsi->ws->rx_ubuf[LWS_PRE +
+						      wsi->ws->rx_ubuf_head];
+				if (wsi->ws->this_frame_masked &&
+				    !wsi->ws->all_zero_nonce)
+					wsi->ws->mask_idx = (uint8_t)
+						lws_ws_mask_xor(p, *buf, n,
+							wsi->ws->mask,
+							wsi->ws->mask_idx);
+				else
+					memcpy(p, *buf, n);
+
+				wsi->ws->rx_ubuf_head += (uint32_t)n;
+				wsi->ws->rx_packet_length -= n;
+				*buf += n;
+				len -= n;
+			}
+		}
+
 		/*
 		 * caller will account for buflist usage by studying what
 		 * happened to *buf
@@ -138,6 +289,8 @@ lws_ws_handshake_client(struct lws *wsi, unsigned char **buf, size_t len)
 	}
 	// lwsl_wsi_notice(wsi, "finished with %ld", (long)len);
 
+	lws_ws_rx_ubuf_idle(wsi);
+
 	return 0;
 }
 #endif
@@ -639,14 +792,18 @@ check_accept:
 	if (!n)
 		n = (int)context->pt_serv_buf_size;
 	n += LWS_PRE;
-	wsi->ws->rx_ubuf = lws_malloc((unsigned int)n + 4 /* 0x0000ffff zlib */,
-				"client frame buffer");
-	if (!wsi->ws->rx_ubuf) {
-		lwsl_wsi_err(wsi, "OOM allocating rx buffer %d", n);
-		*cce = "HS: OOM";
-		goto bail2;
-	}
 	wsi->ws->rx_ubuf_alloc = (unsigned int)n;
+	if (!lws_check_opt(wsi->a.vhost->options,
+			   LWS_SERVER_OPTION_WS_LAZY_RX_BUF)) {
+		wsi->ws->rx_ubuf = lws_malloc((unsigned int)n +
+					4 /* 0x0000ffff zlib */,
+					"client frame buffer");
+		if (!wsi->ws->rx_ubuf) {
+			lwsl_wsi_err(wsi, "OOM allocating rx buffer %d", n);
+			*cce = "HS: OOM";
+			goto bail2;
+		}
+	}
 
 	lwsl_wsi_debug(wsi, "handshake OK for protocol %s", wsi->a.protocol->name);
 
@@ -24,8 +24,155 @@
 
 #include <private-lib-core.h>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LWS_WS_MASK_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define LWS_WS_MASK_NEON
+#endif
+
 #define LWS_CPYAPP(ptr, str) { strcpy(ptr, str); ptr += strlen(str); }
 
+unsigned int
+lws_ws_mask_xor(uint8_t *dst, const uint8_t *src, size_t len,
+		const uint8_t *mask, unsigned int idx)
+{
+	unsigned int next = (unsigned int)((idx + len) & 3);
+	uint8_t m[16];
+	uint64_t m64, v;
+	size_t n;
+
+	/*
+	 * Rotate the mask so it starts at idx, then every chunk we do that is
+	 * a multiple of 4 long leaves it in phase for the next one
+	 */
+
+	for (n = 0; n < sizeof(m); n++)
+		m[n] = mask[(idx + n) & 3];
+
+#if defined(LWS_WS_MASK_SSE2)
+	if (len >= 16) {
+		__m128i vm = _mm_loadu_si128((const __m128i *)m);
+
+		do {
+			_mm_storeu_si128((__m128i *)dst, _mm_xor_si128(
+				_mm_loadu_si128((const __m128i *)src), vm));
+			src += 16;
+			dst += 16;
+			len -= 16;
+		} while (len >= 16);
+	}
+#elif defined(LWS_WS_MASK_NEON)
+	if (len >= 16) {
+		uint8x16_t vm = vld1q_u8(m);
+
+		do {
+			vst1q_u8(dst, veorq_u8(vld1q_u8(src), vm));
+			src += 16;
+			dst += 16;
+			len -= 16;
+		} while (len >= 16);
+	}
+#endif
+
+	/* memcpy() so we don't care about alignment, it becomes a mov */
+
+	memcpy(&m64, m, sizeof(m64));
+	while (len >= 8) {
+		memcpy(&v, src, sizeof(v));
+		v ^= m64;
+		memcpy(dst, &v, sizeof(v));
+		src += 8;
+		dst += 8;
+		len -= 8;
+	}
+
+	for (n = 0; n < len; n++)
+		dst[n] = src[n] ^ m[n];
+
+	return next;
+}
+
+/*
+ * The first header byte has already been through the rx state machine, which
+ * validates the opcode against the fragmentation state.  If the rest of the
+ * header (length, extended length and mask key) is all in the buffer, decode
+ * it in one go and move straight to LWS_RXPS_WS_FRAME_PAYLOAD.
+ *
+ * Anything unusual... a zero-length payload that must spill, something the
+ * state machine will reject with a close reason... returns 0 without touching
+ * the wsi, so it's left to the state machine to deal with bytewise.
+ *
+ * Returns the number of header bytes used.
+ */
+
+size_t
+lws_ws_rx_hdr_bulk(struct lws *wsi, const uint8_t *p, size_t len)
+{
+	size_t need = 1, plen;
+	uint8_t c;
+
+	if (wsi->lws_rx_parse_state != LWS_RXPS_04_FRAME_HDR_LEN || !len)
+		return 0;
+
+	c = p[0];
+	if (c & 0x80) {
+		if (lwsi_role_client(wsi))
+			return 0; /* server must not mask */
+		need += 4;
+	}
+
+	switch (c & 0x7f) {
+	case 126:
+		need += 2;
+		break;
+	case 127:
+		need += 8;
+		break;
+	}
+
+	if (len < need)
+		return 0;
+
+	switch (c & 0x7f) {
+	case 126:
+		if (wsi->ws->opcode & 8)
+			return 0;
+		plen = lws_ser_ru16be(p + 1);
+		break;
+	case 127:
+		if ((wsi->ws->opcode & 8) || (p[1] & 0x80))
+			return 0;
+#if defined __LP64__
+		plen = (size_t)lws_ser_ru64be(p + 1);
+#else
+		if (lws_ser_ru32be(p + 1))
+			return 0;
+		plen = lws_ser_ru32be(p + 5);
+#endif
+		break;
+	default:
+		plen = c & 0x7f;
+		break;
+	}
+
+	if (!plen)
+		return 0;
+
+	wsi->ws->this_frame_masked = !!(c & 0x80);
+	wsi->ws->rx_packet_length = plen;
+	if (wsi->ws->this_frame_masked) {
+		p += need - 4;
+		memcpy(wsi->ws->mask, p, 4);
+		wsi->ws->all_zero_nonce = !(p[0] | p[1] | p[2] | p[3]);
+	}
+	wsi->ws->mask_idx = 0;
+	wsi->lws_rx_parse_state = LWS_RXPS_WS_FRAME_PAYLOAD;
+
+	return need;
+}
+
 /*
  * client-parser.c: lws_ws_client_rx_sm() needs to be roughly kept in
  *   sync with changes here, esp related to ext draining
@@ -822,6 +969,92 @@ lws_0405_frame_mask_generate(struct lws *wsi)
 	return 0;
 }
 
+/*
+ * With LWS_SERVER_OPTION_WS_LAZY_RX_BUF, a connection only holds an rx_ubuf
+ * while it is collecting frame payload.  When it goes idle, the buffer waits
+ * on a small per-pt stack for the next connection that needs one of the same
+ * size, using its own first bytes to link the stack.
+ */
+
+struct lws_ws_rx_idle {
+	struct lws_ws_rx_idle		*next;
+	uint32_t			alloc;
+};
+
+#define LWS_WS_RX_POOL_MAX 16
+
+int
+lws_ws_rx_ubuf_borrow(struct lws *wsi)
+{
+	struct lws_context_per_thread *pt = &wsi->a.context->pt[(int)wsi->tsi];
+	struct lws_ws_rx_idle **pi = (struct lws_ws_rx_idle **)&pt->ws.rx_pool;
+
+	while (*pi) {
+		if ((*pi)->alloc == wsi->ws->rx_ubuf_alloc) {
+			wsi->ws->rx_ubuf = (unsigned char *)*pi;
+			*pi = (*pi)->next;
+			pt->ws.rx_pool_count--;
+
+			return 0;
+		}
+		pi = &(*pi)->next;
+	}
+
+	wsi->ws->rx_ubuf = lws_malloc(wsi->ws->rx_ubuf_alloc +
+				      4 /* 0x0000ffff zlib */, "rx_ubuf");
+	if (!wsi->ws->rx_ubuf) {
+		lwsl_wsi_err(wsi, "OOM allocating rx buffer %u",
+			     (unsigned int)wsi->ws->rx_ubuf_alloc);
+		return 1;
+	}
+
+	return 0;
+}
+
+void
+lws_ws_rx_ubuf_idle(struct lws *wsi)
+{
+	struct lws_context_per_thread *pt;
+	struct lws_ws_rx_idle *i;
+
+	if (!wsi->ws || !wsi->ws->rx_ubuf || wsi->ws->rx_ubuf_head ||
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+	    wsi->ws->rx_draining_ext ||
+#endif
+	    !lws_check_opt(wsi->a.vhost->options,
+			   LWS_SERVER_OPTION_WS_LAZY_RX_BUF))
+		return;
+
+	pt = &wsi->a.context->pt[(int)wsi->tsi];
+	if (pt->ws.rx_pool_count >= LWS_WS_RX_POOL_MAX) {
+		lws_free_set_NULL(wsi->ws->rx_ubuf);
+		return;
+	}
+
+	i = (struct lws_ws_rx_idle *)wsi->ws->rx_ubuf;
+	i->alloc = wsi->ws->rx_ubuf_alloc;
+	i->next = (struct lws_ws_rx_idle *)pt->ws.rx_pool;
+	pt->ws.rx_pool = i;
+	pt->ws.rx_pool_count++;
+	wsi->ws->rx_ubuf = NULL;
+}
+
+void
+lws_ws_rx_pool_destroy(struct lws_context_per_thread *pt)
+{
+	struct lws_ws_rx_idle *i = (struct lws_ws_rx_idle *)pt->ws.rx_pool;
+
+	while (i) {
+		struct lws_ws_rx_idle *next = i->next;
+
+		lws_free(i);
+		i = next;
+	}
+
+	pt->ws.rx_pool = NULL;
+	pt->ws.rx_pool_count = 0;
+}
+
 int
 lws_server_init_wsi_for_ws(struct lws *wsi)
 {
@@ -839,12 +1072,17 @@ lws_server_init_wsi_for_ws(struct lws *wsi)
 	if (!n)
 		n = (int)wsi->a.context->pt_serv_buf_size;
 	n += LWS_PRE;
-	wsi->ws->rx_ubuf = lws_malloc((unsigned int)n + 4 /* 0x0000ffff zlib */, "rx_ubuf");
-	if (!wsi->ws->rx_ubuf) {
-		lwsl_err("Out of Mem allocating rx buffer %d\n", n);
-		return 1;
-	}
 	wsi->ws->rx_ubuf_alloc = (uint32_t)n;
+	if (!lws_check_opt(wsi->a.vhost->options,
+			   LWS_SERVER_OPTION_WS_LAZY_RX_BUF)) {
+		wsi->ws->rx_ubuf = lws_malloc((unsigned int)n +
+					4 /* 0x0000ffff zlib */,
+					"rx_ubuf");
+		if (!wsi->ws->rx_ubuf) {
+			lwsl_err("Out of Mem allocating rx buffer %d\n", n);
+			return 1;
+		}
+	}
 
 	/* notify user code that we're ready to roll */
 
@@ -1070,6 +1308,8 @@ rops_handle_POLLIN_ws(struct lws_context_per_thread *pt, struct lws *wsi,
 #endif
 			n = lws_ws_rx_sm(wsi, ALREADY_PROCESSED_IGNORE_CHAR, 0);
 
+		lws_ws_rx_ubuf_idle(wsi);
+
 		return LWS_HPI_RET_HANDLED;
 	}
 
@@ -1349,6 +1589,17 @@ int rops_handle_POLLOUT_ws(struct lws *wsi)
 	if (lwsi_state(wsi) == LRS_RETURNED_CLOSE)
 		return LWS_HP_RET_USER_SERVICE;
 
+	/* Priority 4a: broadcasts queued on us, between whole messages only */
+
+	if (wsi->ws->bcq_count) {
+		n = lws_ws_bcast_drain(wsi);
+		if (n < 0)
+			return LWS_HP_RET_BAIL_DIE;
+		if (n)
+			/* choked, leave POLLOUT active */
+			return LWS_HP_RET_BAIL_OK;
+	}
+
 #if !defined(LWS_WITHOUT_EXTENSIONS)
 	/* Priority 5: Tx path extension with more to send
 	 *
@@ -1564,6 +1815,7 @@ rops_close_role_ws(struct lws_context_per_thread *pt, struct lws *wsi)
 	}
 #endif
 	lws_free_set_NULL(wsi->ws->rx_ubuf);
+	lws_ws_bcast_drop_queue(wsi);
 
 	wsi->ws->pong_payload_len = 0;
 	wsi->ws->pong_pending_flag = 0;
@@ -1788,6 +2040,13 @@ rops_write_role_protocol_ws(struct lws *wsi, unsigned char *buf, size_t len,
 		if (!((*wp) & LWS_WRITE_NO_FIN))
 			n |= 1 << 7;
 
+		if (!(n & 8)) { /* not a control frame */
+			wsi->ws->tx_msg_open = !!((*wp) & LWS_WRITE_NO_FIN);
+			if (!wsi->ws->tx_msg_open && wsi->ws->bcq_count)
+				/* broadcasts were waiting for this to end */
+				lws_callback_on_writable(wsi);
+		}
+
 		if (len < 126) {
 			pre += 2;
 			buf[-pre] = (uint8_t)n;
@@ -1841,9 +2100,9 @@ do_more_inside_frame:
 		 * in v7, just mask the payload
 		 */
 		if (dropmask) { /* never set if already inside frame */
-			for (n = 4; n < (int)len + 4; n++)
-				dropmask[n] = dropmask[n] ^ wsi->ws->mask[
-					(wsi->ws->mask_idx++) & 3];
+			wsi->ws->mask_idx = (uint8_t)lws_ws_mask_xor(
+					dropmask + 4, dropmask + 4, len,
+					wsi->ws->mask, wsi->ws->mask_idx);
 
 			/* copy the frame nonce into place */
 			memcpy(dropmask, wsi->ws->mask, 4);
@@ -2032,8 +2291,10 @@ rops_destroy_role_ws(struct lws *wsi)
 #if defined(LWS_WITH_HTTP_PROXY)
 	lws_dll2_foreach_safe(&wsi->ws->proxy_owner, NULL, ws_destroy_proxy_buf);
 #endif
+	lws_ws_bcast_drop_queue(wsi);
 
-	lws_free_set_NULL(wsi->ws);
+	lws_slab_free(wsi->ws);
+	wsi->ws = NULL;
 
 	return 0;
 }
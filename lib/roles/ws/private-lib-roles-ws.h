@@ -81,11 +81,16 @@ struct lws_vhost_role_ws {
 	const struct lws_extension *extensions;
 };
 
+#endif
+
 struct lws_pt_role_ws {
+#if !defined(LWS_WITHOUT_EXTENSIONS)
 	struct lws *rx_draining_ext_list;
 	struct lws *tx_draining_ext_list;
-};
 #endif
+	void *rx_pool; /* idle rx_ubuf for LWS_SERVER_OPTION_WS_LAZY_RX_BUF */
+	unsigned int rx_pool_count;
+};
 
 #define PAYLOAD_BUF_SIZE 128 - 3 + LWS_PRE
 
@@ -124,6 +129,7 @@ struct _lws_websocket_related {
 	unsigned int send_check_ping:1;
 	unsigned int first_fragment:1;
 	unsigned int peer_has_sent_close:1;
+	unsigned int tx_msg_open:1; /* sent a data frame without FIN */
 #if !defined(LWS_WITHOUT_EXTENSIONS)
 	unsigned int extension_data_pending:1;
 	unsigned int rx_draining_ext:1;
@@ -133,10 +139,16 @@ struct _lws_websocket_related {
 
 	uint8_t mask[4];
 
+	struct lws_ws_bcast **bcq; /* ring of queued broadcasts, pow2 size */
+
 	size_t rx_packet_length;
 	uint32_t rx_ubuf_head;
 	uint32_t rx_ubuf_alloc;
 
+	uint16_t bcq_head;
+	uint16_t bcq_count;
+	uint16_t bcq_size;
+
 	uint8_t pong_payload_len;
 	uint8_t mask_idx;
 	uint8_t opcode;
@@ -165,6 +177,29 @@ struct lws_ext_pm_deflate_rx_ebufs {
 
 int
 lws_ws_handshake_client(struct lws *wsi, unsigned char **buf, size_t len);
+int
+lws_ws_rx_ubuf_borrow(struct lws *wsi);
+void
+lws_ws_rx_ubuf_idle(struct lws *wsi);
+void
+lws_ws_rx_pool_destroy(struct lws_context_per_thread *pt);
+
+size_t
+lws_ws_rx_hdr_bulk(struct lws *wsi, const uint8_t *p, size_t len);
+
+/*
+ * XOR the ws frame mask into len bytes from src to dst (which may be the
+ * same), starting at mask offset idx, using wide operations where possible.
+ * Returns the mask offset for the following data.
+ */
+unsigned int
+lws_ws_mask_xor(uint8_t *dst, const uint8_t *src, size_t len,
+		const uint8_t *mask, unsigned int idx);
+
+int
+lws_ws_bcast_drain(struct lws *wsi);
+void
+lws_ws_bcast_drop_queue(struct lws *wsi);
 
 #if !defined(LWS_WITHOUT_EXTENSIONS)
 LWS_VISIBLE void
@@ -1185,6 +1185,16 @@ lws_ss_policy_parse_begin(struct lws_context *context, int overlay)
 	lejp_construct(&args->jctx, lws_ss_policy_parser_cb, args,
 		       lejp_tokens_policy, LWS_ARRAY_SIZE(lejp_tokens_policy));
 
+	/*
+	 * The policy paths are matched for every member in the policy, so we
+	 * compile them the first time and keep that for any later overlays.
+	 * If we can't, the parser just compares the paths one by one.
+	 */
+	if (!context->pol_paths)
+		context->pol_paths = lejp_path_table_create(lejp_tokens_policy,
+				LWS_ARRAY_SIZE(lejp_tokens_policy), 0);
+	lejp_set_path_table(&args->jctx, context->pol_paths);
+
 	return 0;
 }
 
@@ -366,6 +366,83 @@ typedef struct ss_proxy_onward {
 extern const lws_transport_client_ops_t txp_ops_sspc_wsi;
 extern const lws_transport_proxy_ops_t txp_ops_ssproxy_wsi;
 
+#if defined(LWS_WITH_SECURE_STREAMS_PROXY_SHM)
+
+/*
+ * Shared memory transport between sspc and the proxy, see shm-ring.c
+ */
+
+#define LWS_SSS_SHM_MAGIC		LWS_FOURCC('l', 'w', 's', 'M')
+/* bytes in each direction's ring, must be a power of two */
+#define LWS_SSS_SHM_RING_SIZE		(256 * 1024)
+
+/* sent with the fds by the client when it connects to the proxy */
+
+typedef struct lws_sss_shm_hello {
+	uint32_t			magic;
+	uint32_t			ring_size;
+} lws_sss_shm_hello_t;
+
+/*
+ * Header of one direction's ring in the shared mapping, the data follows it.
+ * head and tail are free-running, the producer owns head and the consumer
+ * owns tail, each on its own cacheline.
+ */
+
+typedef struct lws_sss_shm_ring {
+	uint32_t			head;
+	uint32_t			consumer_idle; /* ring its doorbell */
+	uint8_t				pad1[56];
+	uint32_t			tail;
+	uint32_t			producer_waiting; /* ring its doorbell */
+	uint8_t				pad2[56];
+} lws_sss_shm_ring_t;
+
+typedef struct lws_sss_shm_link {
+	struct lws			*wsi_skt; /* rendezvous, and peer hangup */
+	struct lws			*wsi_bell; /* our eventfd doorbell */
+	void				*priv; /* sspc handle, or proxy conn */
+	uint8_t				*map;
+	size_t				map_len;
+	lws_sss_shm_ring_t		*tx;
+	lws_sss_shm_ring_t		*rx;
+	uint8_t				*tx_data;
+	uint8_t				*rx_data;
+	size_t				min_tx; /* room needed to be writeable */
+	uint32_t			ring_size;
+	int				fd_bell_peer;
+	uint8_t				want_write;
+	uint8_t				up;
+} lws_sss_shm_link_t;
+
+typedef int (*lws_sss_shm_rx_cb_t)(lws_sss_shm_link_t *link,
+				   const uint8_t *buf, size_t len);
+
+struct lws_vhost *
+lws_sss_shm_vhost(struct lws_context *cx, const char *name,
+		  const struct lws_protocols *pcols);
+int
+lws_sss_shm_sockaddr(const char *name, struct sockaddr_un *sun,
+		     socklen_t *len);
+lws_sss_shm_link_t *
+lws_sss_shm_link_client(const char *name, size_t min_tx, int *skt,
+			int *fd_bell);
+int
+lws_sss_shm_link_accept(lws_sss_shm_link_t *link, int skt, int *fd_bell);
+void
+lws_sss_shm_link_destroy(lws_sss_shm_link_t **link);
+size_t
+lws_sss_shm_tx_space(lws_sss_shm_link_t *link);
+size_t
+lws_sss_shm_write(lws_sss_shm_link_t *link, const uint8_t *buf, size_t len);
+void
+lws_sss_shm_req_write(lws_sss_shm_link_t *link);
+int
+lws_sss_shm_writeable(lws_sss_shm_link_t *link);
+int
+lws_sss_shm_bell(lws_sss_shm_link_t *link, lws_sss_shm_rx_cb_t cb);
+#endif
+
 typedef struct lws_sspc_handle {
 	char			rideshare_list[128];
 
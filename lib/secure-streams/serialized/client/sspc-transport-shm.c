@@ -0,0 +1,312 @@
+/*
+ * libwebsockets - small server side websockets and web server implementation
+ *
+ * Copyright (C) 2019 - 2021 Andy Green <andy@warmcat.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *
+ * Client SSPC where the connectivity is implemented by shared memory rings,
+ * see ../shm-ring.c
+ */
+
+#include <private-lib-core.h>
+
+static int
+lws_sss_transport_shm_rx(lws_sss_shm_link_t *link, const uint8_t *buf,
+			 size_t len)
+{
+	lws_sspc_handle_t *h = (lws_sspc_handle_t *)link->priv;
+	lws_ss_state_return_t r;
+
+	if (!h) {
+		lwsl_info("%s: rx when client ss destroyed\n", __func__);
+
+		return 1;
+	}
+
+	r = h->txp_path.ops_in->event_read((lws_transport_priv_t)h, buf, len);
+
+	switch (r) {
+	default:
+		break;
+	case LWSSSSRET_DISCONNECT_ME:
+		lwsl_info("%s: proxlicent RX ended with DISCONNECT_ME\n",
+				__func__);
+		return 1;
+	case LWSSSSRET_DESTROY_ME:
+		lwsl_info("%s: proxlicent RX ended with DESTROY_ME\n",
+				__func__);
+		link->priv = NULL;
+		lws_sspc_destroy(&h);
+		return 1;
+	}
+
+	if (h->state == LPCSCLI_LOCAL_CONNECTED ||
+	    h->state == LPCSCLI_ONWARD_CONNECT)
+		lws_set_timeout(link->wsi_skt, 0, 0);
+
+	return 0;
+}
+
+/*
+ * The doorbell eventfd: rx means the proxy wrote into our rx ring or made
+ * space in our tx ring, writeable is always possible and we use it to
+ * serialize our tx at a safe point
+ */
+
+static int
+lws_sss_transport_shm_bell_cb(struct lws *wsi, enum lws_callback_reasons reason,
+			      void *user, void *in, size_t len)
+{
+	lws_sss_shm_link_t *link = (lws_sss_shm_link_t *)
+					lws_get_opaque_user_data(wsi);
+	lws_sspc_handle_t *h;
+
+	switch (reason) {
+	case LWS_CALLBACK_RAW_RX_FILE:
+		if (!link)
+			return -1;
+
+		if (lws_sss_shm_bell(link, lws_sss_transport_shm_rx))
+			lws_wsi_close(link->wsi_skt, LWS_TO_KILL_ASYNC);
+		break;
+
+	case LWS_CALLBACK_RAW_WRITEABLE_FILE:
+		if (!link || !link->priv)
+			break;
+
+		h = (lws_sspc_handle_t *)link->priv;
+
+		if (!link->up) {
+			link->up = 1;
+			lwsl_sspc_info(h, "CONNECTED (shm)");
+			if (h->txp_path.ops_in->event_connect_disposition(h, 0)) {
+				lws_wsi_close(link->wsi_skt, LWS_TO_KILL_ASYNC);
+				break;
+			}
+			/* see the same timeout in the wsi transport */
+			lws_set_timeout(link->wsi_skt,
+					PENDING_TIMEOUT_AWAITING_CLIENT_HS_SEND, 3);
+			break;
+		}
+
+		if (!lws_sss_shm_writeable(link))
+			break;
+
+		lwsl_sspc_debug(h, "WRITEABLE, state %d", h->state);
+
+		if (h->txp_path.ops_in->event_can_write(h, link->min_tx))
+			lws_wsi_close(link->wsi_skt, LWS_TO_KILL_ASYNC);
+		break;
+
+	case LWS_CALLBACK_RAW_CLOSE_FILE:
+		if (link)
+			link->wsi_bell = NULL;
+		break;
+
+	default:
+		break;
+	}
+
+	return lws_callback_http_dummy(wsi, reason, user, in, len);
+}
+
+/*
+ * The Unix Domain Socket we handed the fds over: after that, anything on it
+ * means the proxy went away
+ */
+
+static int
+lws_sss_transport_shm_link_cb(struct lws *wsi, enum lws_callback_reasons reason,
+			      void *user, void *in, size_t len)
+{
+	lws_sss_shm_link_t *link = (lws_sss_shm_link_t *)
+					lws_get_opaque_user_data(wsi);
+	lws_ss_state_return_t r;
+	lws_sspc_handle_t *h;
+
+	switch (reason) {
+	case LWS_CALLBACK_RAW_RX_FILE:
+		return -1;
+
+	case LWS_CALLBACK_RAW_CLOSE_FILE:
+		if (!link)
+			break;
+
+		lws_set_opaque_user_data(wsi, NULL);
+		h = (lws_sspc_handle_t *)link->priv;
+		link->priv = NULL;
+		lws_sss_shm_link_destroy(&link);
+
+		if (!h)
+			break;
+
+		lwsl_sspc_info(h, "proxy shm link down, wsi %s",
+				  lws_wsi_tag(wsi));
+
+		r = h->txp_path.ops_in->event_closed(h);
+		if (r == LWSSSSRET_DESTROY_ME)
+			lws_sspc_destroy(&h);
+		break;
+
+	default:
+		break;
+	}
+
+	return lws_callback_http_dummy(wsi, reason, user, in, len);
+}
+
+static const struct lws_protocols protocols[] = {
+	{
+		"sspc-shm-link",
+		lws_sss_transport_shm_link_cb,
+		0, 0, 0, NULL, 0
+	},
+	{
+		"sspc-shm-bell",
+		lws_sss_transport_shm_bell_cb,
+		0, 0, 0, NULL, 0
+	},
+	{ NULL, NULL, 0, 0, 0, NULL, 0 }
+};
+
+/*
+ * lws_sss_transport ops for shm transport
+ */
+
+static int
+lws_sss_transport_shm_retry_connect(lws_txp_path_client_t *path,
+				    lws_sspc_handle_t *h)
+{
+	const char *name = h->context->ss_proxy_bind;
+	lws_sss_shm_link_t *link;
+	lws_adopt_desc_t ad;
+	int skt, bell;
+
+	if (h->context->ss_proxy_port) {
+		lwsl_sspc_err(h, "shm transport can't use tcp");
+
+		return 1;
+	}
+
+	if (!name)
+		name = "@proxy.ss.lws";
+
+	link = lws_sss_shm_link_client(name, h->context->max_http_header_data,
+				       &skt, &bell);
+	if (!link)
+		return 1; /* going to need to retry */
+
+	memset(&ad, 0, sizeof(ad));
+	ad.vh = lws_sss_shm_vhost(h->context, "sspc-shm", protocols);
+	ad.type = LWS_ADOPT_RAW_FILE_DESC;
+	ad.fd.filefd = (lws_filefd_type)(long long)skt;
+	ad.opaque = link;
+	ad.vh_prot_name = protocols[0].name;
+
+	if (ad.vh)
+		link->wsi_skt = lws_adopt_descriptor_vhost_via_info(&ad);
+	if (!link->wsi_skt) {
+		close(skt);
+		close(bell);
+		lws_sss_shm_link_destroy(&link);
+
+		return 1;
+	}
+
+	ad.fd.filefd = (lws_filefd_type)(long long)bell;
+	ad.vh_prot_name = protocols[1].name;
+	ad.parent = link->wsi_skt;
+
+	link->wsi_bell = lws_adopt_descriptor_vhost_via_info(&ad);
+	if (!link->wsi_bell) {
+		close(bell);
+		/* the link is freed when the socket wsi closes */
+		lws_wsi_close(link->wsi_skt, LWS_TO_KILL_ASYNC);
+
+		return 1;
+	}
+
+	link->priv = h;
+	path->priv_onw = (lws_transport_priv_t)link;
+
+	lwsl_sspc_notice(h, "%s", link->wsi_skt->lc.gutag);
+
+	/* we report the connection from the first writeable */
+	lws_callback_on_writable(link->wsi_bell);
+
+	return 0; /* in progress */
+}
+
+static void
+lws_sss_transport_shm_req_write(lws_transport_priv_t priv)
+{
+	lws_sss_shm_link_t *link = (lws_sss_shm_link_t *)priv;
+
+	if (link && link->up)
+		lws_sss_shm_req_write(link);
+}
+
+static int
+lws_sss_transport_shm_write(lws_transport_priv_t priv, uint8_t *buf,
+			    size_t len)
+{
+	lws_sss_shm_link_t *link = (lws_sss_shm_link_t *)priv;
+
+	/* we only write from WRITEABLE, when there's min_tx space */
+
+	if (!link || lws_sss_shm_write(link, buf, len) != len) {
+		lwsl_notice("%s: failed\n", __func__);
+
+		return -1;
+	}
+
+	return 0;
+}
+
+static void
+lws_sss_transport_shm_close(lws_transport_priv_t priv)
+{
+	lws_sss_shm_link_t *link = (lws_sss_shm_link_t *)priv;
+
+	if (!link)
+		return;
+
+	link->priv = NULL;
+	lws_wsi_close(link->wsi_skt, LWS_TO_KILL_ASYNC);
+}
+
+static void
+lws_sss_transport_shm_stream_up(lws_transport_priv_t priv)
+{
+	lws_sss_shm_link_t *link = (lws_sss_shm_link_t *)priv;
+
+	lws_set_timeout(link->wsi_skt, NO_PENDING_TIMEOUT, 0);
+}
+
+const lws_transport_client_ops_t lws_transport_shm_client_ops = {
+	.name			= "txp_sspc_shm",
+	.event_retry_connect	= lws_sss_transport_shm_retry_connect,
+	.req_write		= lws_sss_transport_shm_req_write,
+	._write			= lws_sss_transport_shm_write,
+	._close			= lws_sss_transport_shm_close,
+	.event_stream_up	= lws_sss_transport_shm_stream_up,
+	.dsh_splitat		= 1300,
+};
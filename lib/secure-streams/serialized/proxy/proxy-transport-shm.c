@@ -0,0 +1,398 @@
+/*
+ * libwebsockets - small server side websockets and web server implementation
+ *
+ * Copyright (C) 2019 - 2021 Andy Green <andy@warmcat.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *
+ * Proxy side of Client <-> Proxy shared memory rings, see ../shm-ring.c
+ */
+
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include <private-lib-core.h>
+
+/* larger than the biggest non-payload message the proxy writes at once */
+#define LWS_SSS_SHM_PROXY_MIN_TX	(1580 + 64)
+
+static int
+lws_sss_proxy_shm_rx(lws_sss_shm_link_t *link, const uint8_t *buf, size_t len)
+{
+	struct lws_sss_proxy_conn *conn = (struct lws_sss_proxy_conn *)
+								link->priv;
+
+	if (!conn)
+		return 1;
+
+	if (conn->txp_path.ops_in->proxy_read(conn, buf, len))
+		return 1;
+
+	return 0;
+}
+
+static int
+lws_sss_proxy_shm_bell_cb(struct lws *wsi, enum lws_callback_reasons reason,
+			  void *user, void *in, size_t len)
+{
+	lws_sss_shm_link_t *link = (lws_sss_shm_link_t *)
+					lws_get_opaque_user_data(wsi);
+	struct lws_sss_proxy_conn *conn;
+
+	switch (reason) {
+	case LWS_CALLBACK_RAW_RX_FILE:
+		if (!link)
+			return -1;
+
+		if (lws_sss_shm_bell(link, lws_sss_proxy_shm_rx))
+			lws_wsi_close(link->wsi_skt, LWS_TO_KILL_ASYNC);
+		break;
+
+	case LWS_CALLBACK_RAW_WRITEABLE_FILE:
+		if (!link || !link->priv || !lws_sss_shm_writeable(link))
+			break;
+
+		conn = (struct lws_sss_proxy_conn *)link->priv;
+		assert_is_conn(conn);
+
+		if (lws_txp_inside_proxy.event_proxy_can_write(conn
+#if defined(LWS_WITH_SYS_FAULT_INJECTION)
+				, &link->wsi_skt->fic
+#endif
+				))
+			lws_wsi_close(link->wsi_skt, LWS_TO_KILL_ASYNC);
+		break;
+
+	case LWS_CALLBACK_RAW_CLOSE_FILE:
+		if (link)
+			link->wsi_bell = NULL;
+		break;
+
+	default:
+		break;
+	}
+
+	return lws_callback_http_dummy(wsi, reason, user, in, len);
+}
+
+/*
+ * Accepted client socket: the first thing on it is the hello carrying the
+ * shared memory and doorbell fds, after that anything on it means the client
+ * went away
+ */
+
+static int
+lws_sss_proxy_shm_link_cb(struct lws *wsi, enum lws_callback_reasons reason,
+			  void *user, void *in, size_t len)
+{
+	lws_sss_shm_link_t *link = (lws_sss_shm_link_t *)
+					lws_get_opaque_user_data(wsi);
+	struct lws_sss_proxy_conn *conn;
+	lws_adopt_desc_t ad;
+	int bell, n;
+
+	switch (reason) {
+	case LWS_CALLBACK_RAW_RX_FILE:
+		if (!link || link->map)
+			return -1;
+
+		n = lws_sss_shm_link_accept(link, lws_get_socket_fd(wsi), &bell);
+		if (n > 0)
+			break;
+		if (n < 0)
+			return -1;
+
+		memset(&ad, 0, sizeof(ad));
+		ad.vh = lws_get_vhost(wsi);
+		ad.type = LWS_ADOPT_RAW_FILE_DESC;
+		ad.fd.filefd = (lws_filefd_type)(long long)bell;
+		ad.opaque = link;
+		ad.vh_prot_name = "ssproxy-shm-bell";
+		ad.parent = wsi;
+
+		link->wsi_bell = lws_adopt_descriptor_vhost_via_info(&ad);
+		if (!link->wsi_bell) {
+			close(bell);
+
+			return -1;
+		}
+
+		if (lws_txp_inside_proxy.event_new_conn(
+				wsi->a.context,
+				&lws_txp_inside_proxy,
+				NULL,
+#if defined(LWS_WITH_SYS_FAULT_INJECTION)
+				&wsi->fic,
+#endif
+				&conn,
+				(lws_transport_priv_t)link)) {
+			lwsl_err("%s: hangup from new_conn\n", __func__);
+			return -1;
+		}
+
+		link->priv = conn;
+		lwsl_info("%s: %s: shm link up\n", __func__, lws_wsi_tag(wsi));
+
+		/*
+		 * The client must follow up with its initial tx containing the
+		 * streamtype name, the timeout set at accept still applies
+		 */
+		break;
+
+	case LWS_CALLBACK_RAW_CLOSE_FILE:
+		if (!link)
+			break;
+
+		lws_set_opaque_user_data(wsi, NULL);
+		conn = (struct lws_sss_proxy_conn *)link->priv;
+		link->priv = NULL;
+		lws_sss_shm_link_destroy(&link);
+
+		/*
+		 * The client has gone... the SS and possibly the SS onward
+		 * wsi are still live, close_conn deals with those
+		 */
+
+		if (conn)
+			lws_txp_inside_proxy.event_close_conn(conn);
+		break;
+
+	default:
+		break;
+	}
+
+	return lws_callback_http_dummy(wsi, reason, user, in, len);
+}
+
+static int
+lws_sss_proxy_shm_listen_cb(struct lws *wsi, enum lws_callback_reasons reason,
+			    void *user, void *in, size_t len)
+{
+	lws_sss_shm_link_t *link;
+	lws_adopt_desc_t ad;
+	struct lws *nwsi;
+	int fd;
+
+	if (reason != LWS_CALLBACK_RAW_RX_FILE)
+		return lws_callback_http_dummy(wsi, reason, user, in, len);
+
+	fd = accept4(lws_get_socket_fd(wsi), NULL, NULL,
+		     SOCK_NONBLOCK | SOCK_CLOEXEC);
+	if (fd < 0)
+		return 0;
+
+	link = lws_zalloc(sizeof(*link), __func__);
+	if (!link) {
+		close(fd);
+
+		return 0;
+	}
+
+	link->min_tx = LWS_SSS_SHM_PROXY_MIN_TX;
+	link->fd_bell_peer = -1;
+
+	memset(&ad, 0, sizeof(ad));
+	ad.vh = lws_get_vhost(wsi);
+	ad.type = LWS_ADOPT_RAW_FILE_DESC;
+	ad.fd.filefd = (lws_filefd_type)(long long)fd;
+	ad.opaque = link;
+	ad.vh_prot_name = "ssproxy-shm-link";
+
+	nwsi = lws_adopt_descriptor_vhost_via_info(&ad);
+	if (!nwsi) {
+		close(fd);
+		lws_free(link);
+
+		return 0;
+	}
+
+	link->wsi_skt = nwsi;
+	/* the client must send the hello and then its initial tx promptly */
+	lws_set_timeout(nwsi, PENDING_TIMEOUT_AWAITING_CLIENT_HS_SEND, 3);
+
+	return 0;
+}
+
+static const struct lws_protocols protocols[] = {
+	{
+		"ssproxy-shm-listen",
+		lws_sss_proxy_shm_listen_cb,
+		0, 0, 0, NULL, 0
+	},
+	{
+		"ssproxy-shm-link",
+		lws_sss_proxy_shm_link_cb,
+		0, 0, 0, NULL, 0
+	},
+	{
+		"ssproxy-shm-bell",
+		lws_sss_proxy_shm_bell_cb,
+		0, 0, 0, NULL, 0
+	},
+	{ NULL, NULL, 0, 0, 0, NULL, 0 }
+};
+
+static void
+lws_sss_proxy_shm_onward_bind(lws_transport_priv_t priv, lws_ss_handle_t *h)
+{
+	lws_sss_shm_link_t *link = (lws_sss_shm_link_t *)priv;
+
+	__lws_lc_tag_append(&link->wsi_skt->lc, lws_ss_tag(h));
+}
+
+static void
+lws_sss_proxy_shm_req_write(lws_transport_priv_t priv)
+{
+	lws_sss_shm_link_t *link = (lws_sss_shm_link_t *)priv;
+
+	if (link)
+		lws_sss_shm_req_write(link);
+}
+
+#if defined(LWS_WITH_SYS_FAULT_INJECTION)
+static const lws_fi_ctx_t *
+lws_sss_proxy_shm_fault_context(lws_transport_priv_t priv)
+{
+	lws_sss_shm_link_t *link = (lws_sss_shm_link_t *)priv;
+
+	if (!link)
+		return NULL;
+
+	return &link->wsi_skt->fic;
+}
+#endif
+
+/*
+ * Only called when there's at least min_tx space, and nothing the proxy
+ * writes is bigger than that: our flags make the dsh split payload at 1300,
+ * and the other messages fit in 1580.  So it always goes whole, which matters since the
+ * dsh can't consume part of an object.
+ */
+
+static int
+lws_sss_proxy_shm_write(lws_transport_priv_t priv, uint8_t *buf, size_t *len)
+{
+	lws_sss_shm_link_t *link = (lws_sss_shm_link_t *)priv;
+
+	if (!link || lws_sss_shm_write(link, buf, *len) != *len) {
+		lwsl_notice("%s: failed\n", __func__);
+
+		return -1;
+	}
+
+	/* leave *len alone */
+
+	return 0;
+}
+
+static int
+lws_sss_proxy_shm_init_proxy_server(struct lws_context *context,
+			      const struct lws_transport_proxy_ops *txp_ops_inward,
+			      lws_transport_priv_t txp_priv_inward,
+			      lws_txp_path_proxy_t *txp_ppath,
+			      const void *txp_info,
+			      const char *iface, int port)
+{
+	struct sockaddr_un sun;
+	lws_adopt_desc_t ad;
+	socklen_t sl;
+	int fd;
+
+	if (port) {
+		lwsl_err("%s: shm transport can't use tcp\n", __func__);
+
+		return 1;
+	}
+
+	if (!iface)
+		iface = "@proxy.ss.lws";
+
+	if (lws_sss_shm_sockaddr(iface, &sun, &sl))
+		return 1;
+
+	memset(&ad, 0, sizeof(ad));
+	ad.vh = lws_sss_shm_vhost(context, "ssproxy-shm", protocols);
+	if (!ad.vh) {
+		lwsl_err("%s: Failed to create ss proxy vhost\n", __func__);
+
+		return 1;
+	}
+
+	fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		return 1;
+
+	if (sun.sun_path[0])
+		unlink(sun.sun_path);
+
+	if (bind(fd, (struct sockaddr *)&sun, sl) < 0 ||
+	    listen(fd, SOMAXCONN) < 0) {
+		lwsl_err("%s: unable to listen on %s: %d\n", __func__, iface,
+			 errno);
+		close(fd);
+
+		return 1;
+	}
+
+	ad.type = LWS_ADOPT_RAW_FILE_DESC;
+	ad.fd.filefd = (lws_filefd_type)(long long)fd;
+	ad.vh_prot_name = protocols[0].name;
+
+	if (!lws_adopt_descriptor_vhost_via_info(&ad)) {
+		close(fd);
+
+		return 1;
+	}
+
+	lwsl_notice("%s: listening on %s\n", __func__, iface);
+
+	return 0;
+}
+
+static void
+lws_sss_proxy_shm_client_up(lws_transport_priv_t priv)
+{
+	lws_sss_shm_link_t *link = (lws_sss_shm_link_t *)priv;
+
+	lws_set_timeout(link->wsi_skt, 0, 0);
+}
+
+static int
+lws_sss_proxy_shm_check_write_more(lws_transport_priv_t priv)
+{
+	lws_sss_shm_link_t *link = (lws_sss_shm_link_t *)priv;
+
+	return lws_sss_shm_tx_space(link) >= link->min_tx;
+}
+
+const lws_transport_proxy_ops_t lws_transport_shm_proxy_ops = {
+	.name				= "txp_proxy_shm",
+	.init_proxy_server		= lws_sss_proxy_shm_init_proxy_server,
+	.proxy_req_write		= lws_sss_proxy_shm_req_write,
+	.proxy_write			= lws_sss_proxy_shm_write,
+
+	.event_onward_bind		= lws_sss_proxy_shm_onward_bind,
+#if defined(LWS_WITH_SYS_FAULT_INJECTION)
+	.fault_context			= lws_sss_proxy_shm_fault_context,
+#endif
+	.event_client_up		= lws_sss_proxy_shm_client_up,
+	.proxy_check_write_more		= lws_sss_proxy_shm_check_write_more,
+	.flags				= LWS_DSHFLAG_ENABLE_SPLIT,
+};
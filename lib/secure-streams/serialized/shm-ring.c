@@ -0,0 +1,515 @@
+/*
+ * libwebsockets - small server side websockets and web server implementation
+ *
+ * Copyright (C) 2019 - 2021 Andy Green <andy@warmcat.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *
+ * Shared memory rings used by the sspc <-> proxy shm transport
+ *
+ * The client creates a sealed memfd holding one single-producer,
+ * single-consumer byte ring for each direction, and an eventfd doorbell for
+ * each side.  It connects to the proxy's Unix Domain Socket and passes the
+ * three fds over it with SCM_RIGHTS.  After that, the socket only exists so
+ * each side learns when the other has gone away, the serialized SS stream
+ * itself moves through the rings.
+ *
+ * The producer only rings the consumer's doorbell if the consumer said it
+ * was idle, and the consumer only rings the producer's doorbell if the
+ * producer said it was waiting for space, so a busy link costs no syscalls
+ * per write.
+ */
+
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include <private-lib-core.h>
+
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+
+#define LWS_SSS_SHM_HDR		sizeof(lws_sss_shm_ring_t)
+/* cap on ring segments consumed at one service */
+#define LWS_SSS_SHM_RX_BUDGET	16
+
+static void
+lws_sss_shm_ring_bell(int fd)
+{
+	uint64_t one = 1;
+
+	/* EAGAIN means the counter already has a wakeup pending */
+	if (write(fd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN)
+		lwsl_info("%s: doorbell write failed %d\n", __func__, errno);
+}
+
+static void
+lws_sss_shm_link_map(lws_sss_shm_link_t *link, int client)
+{
+	lws_sss_shm_ring_t *c2p = (lws_sss_shm_ring_t *)link->map,
+			   *p2c = (lws_sss_shm_ring_t *)(link->map +
+					LWS_SSS_SHM_HDR + link->ring_size);
+
+	link->tx = client ? c2p : p2c;
+	link->rx = client ? p2c : c2p;
+	link->tx_data = (uint8_t *)(link->tx + 1);
+	link->rx_data = (uint8_t *)(link->rx + 1);
+}
+
+struct lws_vhost *
+lws_sss_shm_vhost(struct lws_context *cx, const char *name,
+		  const struct lws_protocols *pcols)
+{
+	struct lws_context_creation_info info;
+	struct lws_vhost *vh = lws_get_vhost_by_name(cx, name);
+
+	if (vh)
+		return vh;
+
+	memset(&info, 0, sizeof(info));
+	info.vhost_name		= name;
+	info.port		= CONTEXT_PORT_NO_LISTEN_SERVER;
+	info.protocols		= pcols;
+
+	return lws_create_vhost(cx, &info);
+}
+
+/*
+ * "@name" is in the Linux abstract namespace, otherwise it's a filesystem
+ * path.  A leading '+' as used by the wsi transport client is ignored.
+ */
+
+int
+lws_sss_shm_sockaddr(const char *name, struct sockaddr_un *sun, socklen_t *len)
+{
+	size_t n;
+
+	if (*name == '+')
+		name++;
+
+	n = strlen(name);
+	if (!n || n >= sizeof(sun->sun_path))
+		return 1;
+
+	memset(sun, 0, sizeof(*sun));
+	sun->sun_family = AF_UNIX;
+	memcpy(sun->sun_path, name, n);
+	*len = (socklen_t)sizeof(*sun);
+
+	if (*name == '@') {
+		sun->sun_path[0] = '\0';
+		*len = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + n);
+	}
+
+	return 0;
+}
+
+/*
+ * Client side: create the shared mapping and doorbells, connect to the proxy
+ * and hand it the fds.  On success, *skt and *fd_bell are ours to adopt.
+ */
+
+lws_sss_shm_link_t *
+lws_sss_shm_link_client(const char *name, size_t min_tx, int *skt,
+			int *fd_bell)
+{
+	int fds[3] = { -1, -1, -1 }, fd = -1, n;
+	char cbuf[CMSG_SPACE(sizeof(fds))];
+	lws_sss_shm_link_t *link;
+	lws_sss_shm_hello_t hello;
+	struct sockaddr_un sun;
+	struct cmsghdr *cmsg;
+	struct msghdr msg;
+	struct iovec iov;
+	socklen_t sl;
+
+	if (lws_sss_shm_sockaddr(name, &sun, &sl))
+		return NULL;
+
+	link = lws_zalloc(sizeof(*link), __func__);
+	if (!link)
+		return NULL;
+
+	link->ring_size = LWS_SSS_SHM_RING_SIZE;
+	link->map_len = 2 * (LWS_SSS_SHM_HDR + link->ring_size);
+	link->min_tx = min_tx;
+	link->fd_bell_peer = -1;
+
+	fds[0] = memfd_create("lws-sss-shm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	if (fds[0] < 0)
+		goto bail;
+
+	/*
+	 * The proxy refuses a mapping that could be resized under it, since
+	 * touching a truncated mapping would SIGBUS it
+	 */
+
+	if (ftruncate(fds[0], (off_t)link->map_len) ||
+	    fcntl(fds[0], F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW |
+				       F_SEAL_SEAL))
+		goto bail;
+
+	link->map = mmap(NULL, link->map_len, PROT_READ | PROT_WRITE,
+			 MAP_SHARED, fds[0], 0);
+	if (link->map == MAP_FAILED) {
+		link->map = NULL;
+		goto bail;
+	}
+
+	lws_sss_shm_link_map(link, 1);
+	link->tx->consumer_idle = 1;
+	link->rx->consumer_idle = 1;
+
+	fds[1] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC); /* client's */
+	fds[2] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC); /* proxy's */
+	if (fds[1] < 0 || fds[2] < 0)
+		goto bail;
+
+	fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		goto bail;
+
+	if (connect(fd, (struct sockaddr *)&sun, sl) < 0) {
+		lwsl_info("%s: proxy not reachable at %s: %d\n", __func__,
+			  name, errno);
+		goto bail;
+	}
+
+	hello.magic = LWS_SSS_SHM_MAGIC;
+	hello.ring_size = link->ring_size;
+	iov.iov_base = &hello;
+	iov.iov_len = sizeof(hello);
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = cbuf;
+	msg.msg_controllen = sizeof(cbuf);
+
+	cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+	memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+	if (sendmsg(fd, &msg, MSG_NOSIGNAL) != (ssize_t)sizeof(hello)) {
+		lwsl_warn("%s: failed to send hello: %d\n", __func__, errno);
+		goto bail;
+	}
+
+	if (fcntl(fd, F_SETFL, O_NONBLOCK) < 0)
+		goto bail;
+
+	/* the proxy holds its own copy of the memfd now */
+	close(fds[0]);
+
+	link->fd_bell_peer = fds[2];
+	*fd_bell = fds[1];
+	*skt = fd;
+
+	return link;
+
+bail:
+	if (fd >= 0)
+		close(fd);
+	for (n = 0; n < (int)LWS_ARRAY_SIZE(fds); n++)
+		if (fds[n] >= 0)
+			close(fds[n]);
+	if (link->map)
+		munmap(link->map, link->map_len);
+	lws_free(link);
+
+	return NULL;
+}
+
+/*
+ * Proxy side: collect the client's hello and fds from skt.  On success the
+ * rings are mapped and *fd_bell is ours to adopt.
+ */
+
+int
+lws_sss_shm_link_accept(lws_sss_shm_link_t *link, int skt, int *fd_bell)
+{
+	int fds[3] = { -1, -1, -1 }, seals, n, ret = -1;
+	char cbuf[CMSG_SPACE(sizeof(fds))];
+	lws_sss_shm_hello_t hello;
+	struct cmsghdr *cmsg;
+	struct msghdr msg;
+	struct iovec iov;
+	struct stat s;
+	ssize_t r;
+
+	iov.iov_base = &hello;
+	iov.iov_len = sizeof(hello);
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = cbuf;
+	msg.msg_controllen = sizeof(cbuf);
+
+	r = recvmsg(skt, &msg, MSG_CMSG_CLOEXEC);
+	if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		return 1;
+
+	cmsg = CMSG_FIRSTHDR(&msg);
+	if (cmsg && cmsg->cmsg_level == SOL_SOCKET &&
+	    cmsg->cmsg_type == SCM_RIGHTS) {
+		n = (int)((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+		if (n > (int)LWS_ARRAY_SIZE(fds))
+			n = (int)LWS_ARRAY_SIZE(fds);
+		memcpy(fds, CMSG_DATA(cmsg), (unsigned int)n * sizeof(int));
+	}
+
+	if (r != (ssize_t)sizeof(hello) || (msg.msg_flags & MSG_CTRUNC) ||
+	    fds[0] < 0 || fds[1] < 0 || fds[2] < 0 ||
+	    hello.magic != LWS_SSS_SHM_MAGIC) {
+		lwsl_notice("%s: bad hello\n", __func__);
+		goto bail;
+	}
+
+	/* power of two, 4KiB .. 16MiB */
+	if (hello.ring_size < 4096 || hello.ring_size > (16 << 20) ||
+	    (hello.ring_size & (hello.ring_size - 1))) {
+		lwsl_notice("%s: bad ring size %u\n", __func__,
+			    (unsigned int)hello.ring_size);
+		goto bail;
+	}
+
+	link->ring_size = hello.ring_size;
+	link->map_len = 2 * (LWS_SSS_SHM_HDR + link->ring_size);
+
+	seals = fcntl(fds[0], F_GET_SEALS);
+	if (fstat(fds[0], &s) || (size_t)s.st_size != link->map_len ||
+	    seals < 0 || !(seals & F_SEAL_SHRINK)) {
+		lwsl_notice("%s: unsuitable shm\n", __func__);
+		goto bail;
+	}
+
+	link->map = mmap(NULL, link->map_len, PROT_READ | PROT_WRITE,
+			 MAP_SHARED, fds[0], 0);
+	if (link->map == MAP_FAILED) {
+		link->map = NULL;
+		goto bail;
+	}
+
+	lws_sss_shm_link_map(link, 0);
+
+	link->fd_bell_peer = fds[1];
+	*fd_bell = fds[2];
+	fds[1] = fds[2] = -1;
+	ret = 0;
+
+bail:
+	for (n = 0; n < (int)LWS_ARRAY_SIZE(fds); n++)
+		if (fds[n] >= 0)
+			close(fds[n]);
+
+	return ret;
+}
+
+/*
+ * The wsi are closed separately, we just own the mapping and the fd we use
+ * to ring the peer
+ */
+
+void
+lws_sss_shm_link_destroy(lws_sss_shm_link_t **plink)
+{
+	lws_sss_shm_link_t *link = *plink;
+
+	if (!link)
+		return;
+
+	if (link->map)
+		munmap(link->map, link->map_len);
+	if (link->fd_bell_peer >= 0)
+		close(link->fd_bell_peer);
+
+	lws_free_set_NULL(*plink);
+}
+
+size_t
+lws_sss_shm_tx_space(lws_sss_shm_link_t *link)
+{
+	uint32_t used = link->tx->head -
+			__atomic_load_n(&link->tx->tail, __ATOMIC_ACQUIRE);
+
+	if (used > link->ring_size) /* peer corrupted the ring */
+		return 0;
+
+	return link->ring_size - used;
+}
+
+/*
+ * Copies as much of buf as there is space for into the tx ring, returns the
+ * amount copied
+ */
+
+size_t
+lws_sss_shm_write(lws_sss_shm_link_t *link, const uint8_t *buf, size_t len)
+{
+	uint32_t head = link->tx->head, mask = link->ring_size - 1, ofs;
+	size_t space = lws_sss_shm_tx_space(link), seg;
+
+	if (len > space)
+		len = space;
+	if (!len)
+		return 0;
+
+	ofs = head & mask;
+	seg = (size_t)(link->ring_size - ofs);
+	if (seg > len)
+		seg = len;
+
+	memcpy(link->tx_data + ofs, buf, seg);
+	if (seg != len)
+		memcpy(link->tx_data, buf + seg, len - seg);
+
+	__atomic_store_n(&link->tx->head, head + (uint32_t)len,
+			 __ATOMIC_RELEASE);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	if (__atomic_exchange_n(&link->tx->consumer_idle, 0, __ATOMIC_ACQ_REL))
+		lws_sss_shm_ring_bell(link->fd_bell_peer);
+
+	return len;
+}
+
+/*
+ * We want a WRITEABLE on the doorbell wsi when there's at least min_tx of
+ * space in the tx ring.  If there isn't, we ask the consumer to ring us when
+ * it has taken something.
+ */
+
+void
+lws_sss_shm_req_write(lws_sss_shm_link_t *link)
+{
+	link->want_write = 1;
+
+	if (!link->wsi_bell)
+		return;
+
+	if (lws_sss_shm_tx_space(link) < link->min_tx) {
+		__atomic_store_n(&link->tx->producer_waiting, 1,
+				 __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+		if (lws_sss_shm_tx_space(link) < link->min_tx)
+			return;
+
+		/* the consumer made space meanwhile */
+		__atomic_store_n(&link->tx->producer_waiting, 0,
+				 __ATOMIC_RELAXED);
+	}
+
+	lws_callback_on_writable(link->wsi_bell);
+}
+
+/*
+ * Called at WRITEABLE on the doorbell wsi, nonzero if the caller should go
+ * on and write
+ */
+
+int
+lws_sss_shm_writeable(lws_sss_shm_link_t *link)
+{
+	if (!link->want_write)
+		return 0;
+
+	if (lws_sss_shm_tx_space(link) < link->min_tx) {
+		lws_sss_shm_req_write(link);
+
+		return 0;
+	}
+
+	link->want_write = 0;
+
+	return 1;
+}
+
+/*
+ * Our doorbell rang: pass whatever is in the rx ring to cb in place, and
+ * see if the peer made the room we were waiting for.  cb may destroy the
+ * link's owner, in which case it should set link->priv NULL and return
+ * nonzero.
+ */
+
+int
+lws_sss_shm_bell(lws_sss_shm_link_t *link, lws_sss_shm_rx_cb_t cb)
+{
+	uint32_t head, tail, mask = link->ring_size - 1, ofs;
+	int budget = LWS_SSS_SHM_RX_BUDGET;
+	size_t seg;
+	uint64_t v;
+
+	if (read(lws_get_socket_fd(link->wsi_bell), &v, sizeof(v)) < 0 &&
+	    errno != EAGAIN)
+		return -1;
+
+	while (budget--) {
+		head = __atomic_load_n(&link->rx->head, __ATOMIC_ACQUIRE);
+		tail = link->rx->tail;
+
+		if (head - tail > link->ring_size) {
+			lwsl_warn("%s: peer corrupted ring\n", __func__);
+
+			return -1;
+		}
+
+		if (head == tail) {
+			__atomic_store_n(&link->rx->consumer_idle, 1,
+					 __ATOMIC_RELAXED);
+			__atomic_thread_fence(__ATOMIC_SEQ_CST);
+			if (__atomic_load_n(&link->rx->head,
+					    __ATOMIC_ACQUIRE) == tail)
+				break;
+
+			/* the producer wrote meanwhile, it didn't ring */
+			__atomic_store_n(&link->rx->consumer_idle, 0,
+					 __ATOMIC_RELAXED);
+			continue;
+		}
+
+		ofs = tail & mask;
+		seg = (size_t)(link->ring_size - ofs);
+		if (seg > head - tail)
+			seg = head - tail;
+
+		if (cb(link, link->rx_data + ofs, seg))
+			return -1;
+
+		__atomic_store_n(&link->rx->tail, tail + (uint32_t)seg,
+				 __ATOMIC_RELEASE);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+		if (__atomic_exchange_n(&link->rx->producer_waiting, 0,
+					__ATOMIC_ACQ_REL))
+			lws_sss_shm_ring_bell(link->fd_bell_peer);
+	}
+
+	if (budget < 0)
+		/* come back for the rest after other wsi had a turn */
+		lws_sss_shm_ring_bell(lws_get_socket_fd(link->wsi_bell));
+
+	if (link->want_write)
+		lws_sss_shm_req_write(link);
+
+	return 0;
+}
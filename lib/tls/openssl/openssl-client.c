@@ -374,6 +374,7 @@ lws_ssl_client_bio_create(struct lws *wsi)
 	wsi->tls.client_bio = BIO_new_socket((int)(lws_intptr_t)wsi->desc.sockfd,
 					     BIO_NOCLOSE);
 	SSL_set_bio(wsi->tls.ssl, wsi->tls.client_bio, wsi->tls.client_bio);
+	lws_openssl_ktls_enable(wsi);
 
 #ifdef USE_WOLFSSL
 #ifdef USE_OLD_CYASSL
@@ -585,6 +586,7 @@ lws_tls_client_connect(struct lws *wsi, char *errbuf, size_t elen)
 
 		lwsl_info("client connect OK\n");
 		lws_openssl_describe_cipher(wsi);
+		lws_openssl_ktls_check(wsi);
 		return LWS_SSL_CAPABLE_DONE;
 	}
 
@@ -23,6 +23,7 @@
  */
 
 #include "private-lib-core.h"
+#include "private-lib-tls-openssl.h"
 
 /*
  * Care: many openssl apis return 1 for success.  These are translated to the
@@ -678,6 +679,7 @@ lws_tls_server_new_nonblocking(struct lws *wsi, lws_sockfd_type accept_fd)
 
 	SSL_set_ex_data(wsi->tls.ssl, openssl_websocket_private_data_index, wsi);
 	SSL_set_fd(wsi->tls.ssl, (int)(lws_intptr_t)accept_fd);
+	lws_openssl_ktls_enable(wsi);
 
 #ifdef USE_WOLFSSL
 #ifdef USE_OLD_CYASSL
@@ -742,6 +744,7 @@ lws_tls_server_accept(struct lws *wsi)
 			lwsl_info("%s: no client cert CN\n", __func__);
 
 		lws_openssl_describe_cipher(wsi);
+		lws_openssl_ktls_check(wsi);
 
 		if (SSL_pending(wsi->tls.ssl) &&
 		    lws_dll2_is_detached(&wsi->tls.dll_pending_tls))
@@ -48,6 +48,37 @@ int lws_openssl_describe_cipher(struct lws *wsi)
 	return 0;
 }
 
+/*
+ * If the vhost asked for it, let OpenSSL push the session keys down into the
+ * kernel when the handshake completes.  This must be done before the
+ * handshake starts.  Whether the kernel actually took it depends on it having
+ * the tls ulp and on the negotiated cipher, so we find out afterwards.
+ */
+
+void
+lws_openssl_ktls_enable(struct lws *wsi)
+{
+#if defined(SSL_OP_ENABLE_KTLS)
+	if (lws_check_opt(wsi->a.vhost->options, LWS_SERVER_OPTION_KTLS))
+		SSL_set_options(wsi->tls.ssl, SSL_OP_ENABLE_KTLS);
+#endif
+}
+
+void
+lws_openssl_ktls_check(struct lws *wsi)
+{
+#if defined(SSL_OP_ENABLE_KTLS) && defined(BIO_get_ktls_send)
+	if (!lws_check_opt(wsi->a.vhost->options, LWS_SERVER_OPTION_KTLS))
+		return;
+
+	wsi->tls.ktls_tx = !!BIO_get_ktls_send(SSL_get_wbio(wsi->tls.ssl));
+	wsi->tls.ktls_rx = !!BIO_get_ktls_recv(SSL_get_rbio(wsi->tls.ssl));
+
+	lwsl_wsi_info(wsi, "ktls tx %d, rx %d", wsi->tls.ktls_tx,
+		      wsi->tls.ktls_rx);
+#endif
+}
+
 int lws_ssl_get_error(struct lws *wsi, int n)
 {
 	int m;
@@ -353,6 +384,21 @@ lws_ssl_capable_write(struct lws *wsi, unsigned char *buf, size_t len)
 	if (!wsi->tls.ssl)
 		return lws_ssl_capable_write_no_ssl(wsi, buf, len);
 
+	/*
+	 * With kTLS tx the kernel frames and encrypts whatever we send() as
+	 * application data records, so we can skip OpenSSL and its copy
+	 */
+
+	if (wsi->tls.ktls_tx) {
+		n = lws_ssl_capable_write_no_ssl(wsi, buf, len);
+#if defined(LWS_WITH_SYS_METRICS)
+		if (n > 0 && wsi->a.vhost)
+			lws_metric_event(wsi->a.vhost->mt_traffic_tx,
+					 METRES_GO, (u_mt_t)n);
+#endif
+		return n;
+	}
+
 	errno = 0;
 	ERR_clear_error();
 	n = SSL_write(wsi->tls.ssl, buf, (int)(ssize_t)len);
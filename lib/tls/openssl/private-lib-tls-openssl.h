@@ -54,6 +54,12 @@ lws_gencrypto_openssl_hash_to_NID(enum lws_genhash_types hash_type);
 const EVP_MD *
 lws_gencrypto_openssl_hash_to_EVP_MD(enum lws_genhash_types hash_type);
 
+void
+lws_openssl_ktls_enable(struct lws *wsi);
+
+void
+lws_openssl_ktls_check(struct lws *wsi);
+
 #if !defined(LWS_HAVE_BN_bn2binpad)
 int BN_bn2binpad(const BIGNUM *a, unsigned char *to, int tolen);
 #endif
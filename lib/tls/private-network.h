@@ -88,6 +88,8 @@ struct lws_lws_tls {
 	char			err_helper[32];
 	unsigned int		use_ssl;
 	unsigned int		redirect_to_https:1;
+	unsigned int		ktls_tx:1; /* kernel encrypts tx, use send() */
+	unsigned int		ktls_rx:1; /* kernel decrypts rx */
 };
 
 
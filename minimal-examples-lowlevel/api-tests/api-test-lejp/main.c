@@ -445,6 +445,25 @@ static const char * const tok[] = {
 }, * const tok_test11[] = { /* matches for test 11, 12 */
 	"*[][]",
 	"*[]",
+}, * const tok_wc[] = { /* for comparing compiled and linear matching */
+	"a.*.c",
+	"a.*.*",
+	"a.*",
+	"a.b",
+	"x*y",
+	"*[].*",
+	"*[]",
+	"q.*.*.z",
+	"q.**",
+	"s[].*.metadata[].*",
+	"s[].*.metadata",
+	"s[].*",
+	"",
+}, * const wc_paths[] = {
+	"a.b.c", "a.b", "a.bb.d", "a.", "a", "a.b.c.d", "xzy", "xy", "x",
+	"foo[].bar", "foo[]", "foo", "[]", "q.1.2.z", "q.1.2.y", "q.", "q.x",
+	"q.x.", "s[].st.metadata[].ab", "s[].st.metadata", "s[].st", "s[]",
+	"s[].st.metadata[]", "", "zz",
 };
 
 struct lejp_results_pkg {
@@ -528,13 +547,19 @@ test_cb(struct lejp_ctx *ctx, char reason)
 	return 0;
 }
 
+static signed char
+wc_cb(struct lejp_ctx *ctx, char reason)
+{
+	return 0;
+}
+
 int main(int argc, const char **argv)
 {
 	int n, e = 0, logs = LLL_USER | LLL_ERR | LLL_WARN | LLL_NOTICE;
-	struct lejp_ctx ctx;
+	struct lejp_path_table *pt = NULL;
+	struct lejp_ctx ctx, c1;
 	const char *p;
-
-	memset(&ctx, 0, sizeof(ctx));
+	int compiled;
 
 	if ((p = lws_cmdline_option(argc, argv, "-d")))
 		logs = atoi(p);
@@ -542,14 +567,36 @@ int main(int argc, const char **argv)
 	lws_set_log_level(logs, NULL);
 	lwsl_user("LWS API selftest: lws_struct JSON\n");
 
+	/*
+	 * Run the tests once matching linearly, then with compiled paths.
+	 * The expected results see what the last test left in ctx, so each
+	 * run has to start from the same ctx.
+	 */
+
+	for (compiled = 0; compiled < 2; compiled++) {
+	memset(&ctx, 0, sizeof(ctx));
 	for (m = 0; m < (int)LWS_ARRAY_SIZE(json_tests); m++) {
 
-		lwsl_user("%s: ++++++++++++++++ test %d\n", __func__, m + 1);
+		lwsl_user("%s: ++++++++++++++++ test %d%s\n", __func__, m + 1,
+			  compiled ? " (compiled paths)" : "");
 		step = 0;
 
 		lejp_construct(&ctx, test_cb, NULL, rpkg[m].tokens, (uint8_t)rpkg[m].tokens_len);
 		ctx.flags = rpkg[m].ctx_flags;
 
+		if (compiled) {
+			lejp_path_table_destroy(&pt);
+			pt = lejp_path_table_create(rpkg[m].tokens,
+					(uint8_t)rpkg[m].tokens_len, 0);
+			if (!pt) {
+				lwsl_err("%s: path table create failed\n",
+					 __func__);
+				e++;
+				break;
+			}
+			lejp_set_path_table(&ctx, pt);
+		}
+
 		lwsl_hexdump_info(json_tests[m], strlen(json_tests[m]));
 
 		if (m == 7)
@@ -571,6 +618,52 @@ int main(int argc, const char **argv)
 			e++;
 		}
 	}
+	}
+
+	lejp_path_table_destroy(&pt);
+
+	/*
+	 * The compiled table must find the same path, with the same wildcards,
+	 * as comparing each path in turn, including for awkward wildcards
+	 */
+
+	pt = lejp_path_table_create(tok_wc, LWS_ARRAY_SIZE(tok_wc), 0);
+	if (!pt) {
+		lwsl_err("%s: path table create failed\n", __func__);
+		e++;
+	} else {
+		for (n = 0; n < (int)LWS_ARRAY_SIZE(wc_paths); n++) {
+			memset(&ctx, 0, sizeof(ctx));
+			memset(&c1, 0, sizeof(c1));
+			lejp_construct(&ctx, wc_cb, NULL, tok_wc,
+				       LWS_ARRAY_SIZE(tok_wc));
+			lejp_construct(&c1, wc_cb, NULL, tok_wc,
+				       LWS_ARRAY_SIZE(tok_wc));
+			lejp_set_path_table(&c1, pt);
+
+			lws_strncpy(ctx.path, wc_paths[n], sizeof(ctx.path));
+			lws_strncpy(c1.path, wc_paths[n], sizeof(c1.path));
+			ctx.pst[0].ppos = c1.pst[0].ppos =
+					(uint8_t)strlen(wc_paths[n]);
+
+			lejp_check_path_match(&ctx);
+			lejp_check_path_match(&c1);
+
+			if (ctx.path_match != c1.path_match ||
+			    ctx.path_match_len != c1.path_match_len ||
+			    ctx.wildcount != c1.wildcount ||
+			    memcmp(ctx.wild, c1.wild,
+				   ctx.wildcount * sizeof(ctx.wild[0]))) {
+				lwsl_err("%s: '%s': linear %d (%d wild), "
+					 "compiled %d (%d wild)\n", __func__,
+					 wc_paths[n], ctx.path_match,
+					 ctx.wildcount, c1.path_match,
+					 c1.wildcount);
+				e++;
+			}
+		}
+		lejp_path_table_destroy(&pt);
+	}
 
 	{
 		const char *cs;
@@ -0,0 +1,353 @@
+/*
+ * lws-api-test-lws_sul
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This api test confirms lws_sul are serviced strictly in time order across
+ * both pt sul owners, with some cancelled and rescheduled along the way, that
+ * suls due up to days ahead fire in order and on time when the scheduler is
+ * driven with a synthetic clock, and then times scheduling, rescheduling and
+ * cancelling a large number of suls.
+ */
+
+#include <libwebsockets.h>
+
+/*
+ * lws internal, not part of the public api, so this test links against the
+ * static lws library to get at it
+ */
+lws_usec_t
+lws_sul_service_owner(struct lws_context *ctx, int tsi, int owner,
+		      lws_usec_t usnow);
+
+/*
+ * The sorted list is O(N) per schedule, so 1M takes hours without the wheel
+ */
+#if defined(LWS_WITH_SUL_WHEEL)
+#define BENCH_DEFAULT_COUNT 1000000
+#else
+#define BENCH_DEFAULT_COUNT 10000
+#endif
+
+#define ORDER_COUNT 3000
+#define LEVELS_COUNT 4000
+
+struct tsul {
+	lws_sorted_usec_list_t	sul;
+	lws_usec_t		due;
+	char			cancelled;
+	char			fired;
+};
+
+static struct lws_context *cx;
+static lws_sorted_usec_list_t sul_timeout;
+static struct tsul *ts;
+static int fired, expected, misorder, interrupted;
+static lws_usec_t last_due, synth_now;
+static uint32_t seed = 0x12345678;
+
+static uint32_t
+rnd(void)
+{
+	seed = seed * 1103515245u + 12345u;
+
+	return seed >> 8;
+}
+
+static uint64_t
+rnd64(void)
+{
+	return (uint64_t)rnd() << 24 | rnd();
+}
+
+static void
+timeout_cb(lws_sorted_usec_list_t *sul)
+{
+	lwsl_err("%s: timed out\n", __func__);
+	interrupted = 1;
+}
+
+static void
+order_cb(lws_sorted_usec_list_t *sul)
+{
+	struct tsul *t = lws_container_of(sul, struct tsul, sul);
+
+	if (t->cancelled || t->fired)
+		misorder++;
+
+	if (t->due < last_due) {
+		lwsl_err("%s: %d due %lld after %lld\n", __func__,
+			 (int)(t - ts), (long long)t->due,
+			 (long long)last_due);
+		misorder++;
+	}
+
+	t->fired = 1;
+	last_due = t->due;
+	if (++fired == expected)
+		lws_cancel_service(cx);
+}
+
+static void
+schedule(struct tsul *t, lws_usec_t us, int wake)
+{
+	if (wake)
+		lws_sul_schedule_wakesuspend(cx, 0, &t->sul, order_cb, us);
+	else
+		lws_sul_schedule(cx, 0, &t->sul, order_cb, us);
+
+	t->due = t->sul.us;
+}
+
+static int
+test_order(void)
+{
+	int n;
+
+	lwsl_user("%s: %d suls\n", __func__, ORDER_COUNT);
+
+	ts = calloc(ORDER_COUNT, sizeof(*ts));
+	if (!ts)
+		return 1;
+
+	/* spread over 500ms so several wheel slots are involved */
+
+	for (n = 0; n < ORDER_COUNT; n++)
+		schedule(&ts[n], (lws_usec_t)(rnd() % 500000), n & 1);
+
+	expected = ORDER_COUNT;
+
+	for (n = 0; n < ORDER_COUNT; n += 5) {
+		lws_sul_schedule(cx, 0, &ts[n].sul, order_cb,
+				 LWS_SET_TIMER_USEC_CANCEL);
+		ts[n].cancelled = 1;
+		expected--;
+	}
+
+	for (n = 1; n < ORDER_COUNT; n += 7)
+		if (!ts[n].cancelled)
+			schedule(&ts[n], (lws_usec_t)(rnd() % 500000),
+				 !(n & 2));
+
+	lws_sul_schedule(cx, 0, &sul_timeout, timeout_cb, 3 * LWS_US_PER_SEC);
+
+	while (fired < expected && !interrupted && !misorder)
+		if (lws_service(cx, 0) < 0)
+			break;
+
+	lws_sul_cancel(&sul_timeout);
+	free(ts);
+
+	if (fired != expected || misorder) {
+		lwsl_err("%s: fired %d / %d, misorder %d\n", __func__,
+			 fired, expected, misorder);
+		return 1;
+	}
+
+	return 0;
+}
+
+static void
+levels_cb(lws_sorted_usec_list_t *sul)
+{
+	struct tsul *t = lws_container_of(sul, struct tsul, sul);
+
+	if (t->cancelled || t->fired || t->due > synth_now) {
+		lwsl_err("%s: %d due %lld early or unexpected at %lld\n",
+			 __func__, (int)(t - ts), (long long)t->due,
+			 (long long)synth_now);
+		misorder++;
+	}
+
+	if (t->due < last_due) {
+		lwsl_err("%s: %d due %lld after %lld\n", __func__,
+			 (int)(t - ts), (long long)t->due,
+			 (long long)last_due);
+		misorder++;
+	}
+
+	t->fired = 1;
+	last_due = t->due;
+	fired++;
+}
+
+/*
+ * Internal lws timers reschedule themselves from the real time, so we use the
+ * wake-if-suspended owner, which only has our suls on it, and service it with
+ * a synthetic clock that walks forward ~76h in uneven steps.  With
+ * LWS_WITH_SUL_WHEEL the suls start out spread over L0 (< 2^25us), L1
+ * (< 2^31us), L2 (< ~38h) and .later, and are cascaded down as we go.
+ */
+
+static int
+test_levels(void)
+{
+	static const lws_usec_t band[] = {
+		0, 1ll << 25, 1ll << 31, 1ll << 37, 1ll << 38
+	};
+	lws_usec_t base, us;
+	int n, b, steps = 0;
+
+	lwsl_user("%s: %d suls\n", __func__, LEVELS_COUNT);
+
+	ts = calloc(LEVELS_COUNT, sizeof(*ts));
+	if (!ts)
+		return 1;
+
+	fired = misorder = 0;
+	expected = LEVELS_COUNT;
+	last_due = 0;
+
+	for (n = 0; n < LEVELS_COUNT; n++) {
+		b = n & 3;
+
+		/* also put some exactly on, and either side of, the band edges */
+
+		if (n < 4 * 3 * 4)
+			us = band[b] + (n >> 2) % 3 - 1;
+		else
+			us = band[b] + (lws_usec_t)(rnd64() %
+					(uint64_t)(band[b + 1] - band[b]));
+		if (us < 0)
+			us = 0;
+
+		lws_sul_schedule_wakesuspend(cx, 0, &ts[n].sul, levels_cb, us);
+		ts[n].due = ts[n].sul.us;
+	}
+
+	for (n = 3; n < LEVELS_COUNT; n += 11) {
+		lws_sul_cancel(&ts[n].sul);
+		ts[n].cancelled = 1;
+		expected--;
+	}
+
+	base = synth_now = lws_now_usecs();
+
+	while (synth_now < base + band[4] + 1 && !misorder) {
+		/* mostly big steps, some tiny ones to land inside slots */
+		if (steps++ & 1)
+			synth_now += 1 + (lws_usec_t)(rnd64() % (1ull << 30));
+		else
+			synth_now += 1 + (lws_usec_t)(rnd() % 1000);
+
+		lws_sul_service_owner(cx, 0, LWSSULLI_WAKE_IF_SUSPENDED,
+				      synth_now);
+
+		/* everything due by now must have been serviced */
+
+		for (n = 0; n < LEVELS_COUNT; n++)
+			if (!ts[n].cancelled && !ts[n].fired &&
+			    ts[n].due <= synth_now) {
+				lwsl_err("%s: %d due %lld missed at %lld\n",
+					 __func__, n, (long long)ts[n].due,
+					 (long long)synth_now);
+				misorder++;
+				break;
+			}
+	}
+
+	free(ts);
+
+	if (fired != expected || misorder) {
+		lwsl_err("%s: fired %d / %d, misorder %d\n", __func__,
+			 fired, expected, misorder);
+		return 1;
+	}
+
+	lwsl_user("%s: %d steps\n", __func__, steps);
+
+	return 0;
+}
+
+static int
+test_bench(int count)
+{
+	lws_usec_t t0, t1, t2, t3;
+	int n;
+
+	lwsl_user("%s: %d suls\n", __func__, count);
+
+	ts = calloc((size_t)count, sizeof(*ts));
+	if (!ts)
+		return 1;
+
+	/* due between 1s and 2 mins, so none fire while we're busy */
+
+	t0 = lws_now_usecs();
+	for (n = 0; n < count; n++)
+		lws_sul_schedule(cx, 0, &ts[n].sul, order_cb, LWS_US_PER_SEC +
+				 (lws_usec_t)(rnd() % (119 * LWS_US_PER_SEC)));
+
+	/* the same again, like lws_set_timeout() when there is traffic */
+
+	t1 = lws_now_usecs();
+	for (n = 0; n < count; n++)
+		lws_sul_schedule(cx, 0, &ts[n].sul, order_cb, LWS_US_PER_SEC +
+				 (lws_usec_t)(rnd() % (119 * LWS_US_PER_SEC)));
+
+	t2 = lws_now_usecs();
+	for (n = 0; n < count; n++)
+		lws_sul_schedule(cx, 0, &ts[n].sul, order_cb,
+				 LWS_SET_TIMER_USEC_CANCEL);
+	t3 = lws_now_usecs();
+
+	for (n = 0; n < count; n++)
+		if (!lws_dll2_is_detached(&ts[n].sul.list))
+			break;
+
+	free(ts);
+
+	if (n != count) {
+		lwsl_err("%s: sul %d still scheduled\n", __func__, n);
+		return 1;
+	}
+
+	lwsl_user("%s: schedule %lldms, reschedule %lldms, cancel %lldms\n",
+		  __func__, (long long)((t1 - t0) / LWS_US_PER_MS),
+		  (long long)((t2 - t1) / LWS_US_PER_MS),
+		  (long long)((t3 - t2) / LWS_US_PER_MS));
+
+	return 0;
+}
+
+int
+main(int argc, const char **argv)
+{
+	int logs = LLL_USER | LLL_ERR | LLL_WARN | LLL_NOTICE, e = 0,
+	    count = BENCH_DEFAULT_COUNT;
+	struct lws_context_creation_info info;
+	const char *p;
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--count")))
+		count = atoi(p);
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS API selftest: lws_sul\n");
+
+	memset(&info, 0, sizeof info); /* otherwise uninitialized garbage */
+	info.port = CONTEXT_PORT_NO_LISTEN;
+
+	cx = lws_create_context(&info);
+	if (!cx) {
+		lwsl_err("lws init failed\n");
+		return 1;
+	}
+
+	e |= test_order();
+	if (!e)
+		e |= test_levels();
+	if (!e)
+		e |= test_bench(count);
+
+	lws_context_destroy(cx);
+
+	lwsl_user("Completed: %s\n", e ? "FAIL" : "PASS");
+
+	return e;
+}
@@ -0,0 +1,157 @@
+/*
+ * lws-api-test-lws_ws_mask
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This api test confirms lws_ws_mask_xor() matches the simple bytewise ws
+ * masking for every length, alignment and mask phase, then compares the
+ * throughput of the two on 1KB and 64KB frames.
+ */
+
+#include <libwebsockets.h>
+
+/*
+ * lws internal, not part of the public api, so this test links against the
+ * static lws library to get at it
+ */
+unsigned int
+lws_ws_mask_xor(uint8_t *dst, const uint8_t *src, size_t len,
+		const uint8_t *mask, unsigned int idx);
+
+static const uint8_t mask[4] = { 0x12, 0x34, 0x56, 0x78 };
+
+/* how lws used to do it, one byte at a time */
+
+static unsigned int
+mask_bytewise(uint8_t *dst, const uint8_t *src, size_t len,
+	      const uint8_t *m, unsigned int idx)
+{
+	size_t n;
+
+	for (n = 0; n < len; n++)
+		dst[n] = src[n] ^ m[(idx++) & 3];
+
+	return idx & 3;
+}
+
+static int
+test_match(void)
+{
+	uint8_t src[160], a[160], b[160];
+	unsigned int idx, ia, ib;
+	size_t n, ofs, len;
+
+	for (n = 0; n < sizeof(src); n++)
+		src[n] = (uint8_t)(n * 7 + 3);
+
+	for (idx = 0; idx < 4; idx++)
+		for (ofs = 0; ofs < 8; ofs++)
+			for (len = 0; len + ofs <= 128; len++) {
+				memset(a, 0xaa, sizeof(a));
+				memset(b, 0xaa, sizeof(b));
+
+				ia = mask_bytewise(a + ofs, src + ofs, len,
+						   mask, idx);
+				ib = lws_ws_mask_xor(b + ofs, src + ofs, len,
+						     mask, idx);
+				if (ia != ib || memcmp(a, b, sizeof(a))) {
+					lwsl_err("%s: idx %u, ofs %d, len %d\n",
+						 __func__, idx, (int)ofs,
+						 (int)len);
+					return 1;
+				}
+
+				/* and in place, like the rx path */
+
+				memcpy(b, src, sizeof(b));
+				lws_ws_mask_xor(b + ofs, b + ofs, len, mask,
+						idx);
+				if (memcmp(a + ofs, b + ofs, len)) {
+					lwsl_err("%s: in place idx %u, ofs %d, "
+						 "len %d\n", __func__, idx,
+						 (int)ofs, (int)len);
+					return 1;
+				}
+			}
+
+	return 0;
+}
+
+typedef unsigned int (*mask_fn_t)(uint8_t *dst, const uint8_t *src,
+				  size_t len, const uint8_t *m,
+				  unsigned int idx);
+
+static unsigned int
+bench(mask_fn_t fn, uint8_t *dst, const uint8_t *src, size_t frame)
+{
+	size_t total = 256 * 1024 * 1024, done = 0;
+	lws_usec_t t = lws_now_usecs();
+	unsigned int idx = 0;
+
+	while (done < total) {
+		idx = fn(dst, src, frame, mask, idx);
+		done += frame;
+	}
+
+	t = lws_now_usecs() - t;
+	if (!t)
+		t = 1;
+
+	return (unsigned int)(((uint64_t)total * LWS_US_PER_SEC) /
+			      ((uint64_t)t * 1024 * 1024));
+}
+
+static int
+test_bench(void)
+{
+	static const size_t frames[] = { 1024, 65536 };
+	uint8_t *src, *dst;
+	size_t n;
+
+	src = malloc(frames[1]);
+	dst = malloc(frames[1]);
+	if (!src || !dst) {
+		free(src);
+		free(dst);
+		return 1;
+	}
+
+	for (n = 0; n < frames[1]; n++)
+		src[n] = (uint8_t)n;
+
+	for (n = 0; n < LWS_ARRAY_SIZE(frames); n++)
+		lwsl_user("%s: %6dB frames: bytewise %5uMB/s, "
+			  "lws_ws_mask_xor %5uMB/s\n", __func__,
+			  (int)frames[n], bench(mask_bytewise, dst, src,
+						frames[n]),
+			  bench(lws_ws_mask_xor, dst, src, frames[n]));
+
+	free(src);
+	free(dst);
+
+	return 0;
+}
+
+int
+main(int argc, const char **argv)
+{
+	int logs = LLL_USER | LLL_ERR | LLL_WARN | LLL_NOTICE, e;
+	const char *p;
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS API selftest: lws_ws_mask\n");
+
+	e = test_match();
+	if (!e)
+		e = test_bench();
+
+	lwsl_user("Completed: %s\n", e ? "FAIL" : "PASS");
+
+	return e;
+}
@@ -77,6 +77,7 @@ int main(int argc, const char **argv)
 	lws_set_log_level(logs, NULL);
 	lwsl_user("LWS minimal http server eventlib | visit http://localhost:7681\n");
 	lwsl_user(" [-s (ssl)] [--uv (libuv)] [--ev (libev)] [--event (libevent)]\n");
+	lwsl_user(" [--epoll (builtin epoll)] [--io_uring (builtin io_uring)]\n");
 
 	memset(&info, 0, sizeof info); /* otherwise uninitialized garbage */
 	info.port = 7681;
@@ -106,8 +107,13 @@ int main(int argc, const char **argv)
 			else
 				if (lws_cmdline_option(argc, argv, "--glib"))
 					info.options |= LWS_SERVER_OPTION_GLIB;
-				else
+				else {
+					if (lws_cmdline_option(argc, argv, "--epoll"))
+						info.options |= LWS_SERVER_OPTION_EPOLL;
+					if (lws_cmdline_option(argc, argv, "--io_uring"))
+						info.options |= LWS_SERVER_OPTION_IO_URING;
 					signal(SIGINT, sigint_handler);
+				}
 
 	context = lws_create_context(&info);
 	if (!context) {
@@ -0,0 +1,1437 @@
+/*
+ * lws-minimal-http-server-h2-hpack-decode
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This measures how fast the lws h2 server gets through request header
+ * blocks.  It serves h2 with prior knowledge (no tls) on loopback, and a raw
+ * client in the same process replays HEADERS frames recorded from browser-
+ * like page loads, each one on a fresh h2 connection, so that the references
+ * to the dynamic table in the recorded blocks line up.
+ *
+ * The server checks the :path and user-agent of every request came out of
+ * its HPACK decoder as recorded, and responds minimally.  One trace was
+ * recorded with a header table size of 0, so it is all Huffman-coded
+ * literals, which is where the decoder itself shows up most.
+ */
+
+#include <libwebsockets.h>
+#include <string.h>
+#include <stdlib.h>
+#include <signal.h>
+
+/*
+ * Request header blocks as encoded by nghttp2, for a page load with Chrome's
+ * request headers and then one with Firefox's, including a cookie header.
+ * The first block of each inserts most of the headers in the dynamic table,
+ * the later ones refer to them.
+ */
+
+static const uint8_t chrome[] = {
+	0x82, 0x84, 0x86, 0x41, 0x8a, 0x08, 0x9d, 0x5c, 0x0b, 0x81,
+	0x70, 0xdc, 0x75, 0xe0, 0x03, 0x53, 0xc0, 0x49, 0x7c, 0xa5,
+	0x89, 0xd3, 0x4d, 0x1f, 0x43, 0xae, 0xba, 0x0c, 0x41, 0xa4,
+	0xc7, 0xa9, 0x8f, 0x33, 0xa6, 0x9a, 0x3f, 0xdf, 0x9a, 0x68,
+	0xfa, 0x1d, 0x75, 0xd0, 0x62, 0x0d, 0x26, 0x3d, 0x4c, 0x79,
+	0xa6, 0x8f, 0xbe, 0xd0, 0x01, 0x77, 0xfe, 0x8d, 0x48, 0xe6,
+	0x2b, 0x03, 0xee, 0x69, 0x7e, 0x8d, 0x48, 0xe6, 0x2b, 0x1e,
+	0x0b, 0x1d, 0x7f, 0x5f, 0x2c, 0x7c, 0xfd, 0xf6, 0x80, 0x0b,
+	0xbd, 0x50, 0x8d, 0x9b, 0xd9, 0xab, 0xfa, 0x52, 0x42, 0xcb,
+	0x40, 0xd2, 0x5f, 0xa5, 0x23, 0xb3, 0x7a, 0xce, 0xd0, 0x7f,
+	0x66, 0xa2, 0x81, 0xb0, 0xda, 0xe0, 0x53, 0xfa, 0xfc, 0x08,
+	0x7e, 0xd4, 0xce, 0x6a, 0xad, 0xf2, 0xa7, 0x97, 0x9c, 0x89,
+	0xc6, 0xbf, 0xb5, 0x21, 0xae, 0xba, 0x0b, 0xc8, 0xb1, 0xe6,
+	0x32, 0x58, 0x6d, 0x97, 0x57, 0x65, 0xc5, 0x3f, 0xac, 0xd8,
+	0xf7, 0xe8, 0xcf, 0xf4, 0xa5, 0x06, 0xea, 0x55, 0x31, 0x14,
+	0x9d, 0x4f, 0xfd, 0xa9, 0x7a, 0x7b, 0x0f, 0x49, 0x58, 0x08,
+	0x80, 0xb8, 0x17, 0x02, 0xe0, 0x53, 0x70, 0xe5, 0x1d, 0x86,
+	0x61, 0xb6, 0x5d, 0x5d, 0x97, 0x3f, 0x51, 0x8b, 0x2d, 0x4b,
+	0x62, 0xbb, 0xf4, 0x5a, 0xbe, 0xfb, 0x40, 0x05, 0xdf, 0x40,
+	0x87, 0x41, 0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xff, 0xa2, 0xfe,
+	0x74, 0x9d, 0x31, 0x42, 0xa5, 0xdb, 0x07, 0x54, 0x9f, 0xcf,
+	0xdf, 0x78, 0x3f, 0x97, 0xbf, 0x9f, 0xa5, 0x3f, 0x9b, 0xd3,
+	0xd8, 0x7a, 0x4d, 0x6d, 0x3f, 0xcf, 0xdf, 0x78, 0x3f, 0x90,
+	0x88, 0x1f, 0xcf, 0x40, 0x8b, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xad, 0x49, 0xe3, 0x35, 0x05, 0x02, 0x3f, 0x30, 0x40,
+	0x8d, 0x41, 0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x5d, 0x03,
+	0x4c, 0xa7, 0xb2, 0x9f, 0x07, 0x22, 0x4c, 0x69, 0x6e, 0x75,
+	0x78, 0x22, 0x40, 0x8a, 0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27,
+	0x59, 0x06, 0x49, 0x7f, 0x88, 0x40, 0xe9, 0x2a, 0xc7, 0xb0,
+	0xd3, 0x1a, 0xaf, 0x40, 0x8a, 0x41, 0x48, 0xb4, 0xa5, 0x49,
+	0x27, 0x5a, 0x93, 0xc8, 0x5f, 0x86, 0xa8, 0x7d, 0xcd, 0x30,
+	0xd2, 0x5f, 0x40, 0x8a, 0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27,
+	0x5a, 0x42, 0xa1, 0x3f, 0x86, 0x90, 0xe4, 0xb6, 0x92, 0xd4,
+	0x9f, 0x40, 0x92, 0xb6, 0xb9, 0xac, 0x1c, 0x85, 0x58, 0xd5,
+	0x20, 0xa4, 0xb6, 0xc2, 0xad, 0x61, 0x7b, 0x5a, 0x54, 0x25,
+	0x1f, 0x01, 0x31, 0x73, 0x8f, 0x9d, 0x29, 0xad, 0x17, 0x18,
+	0x60, 0xbe, 0x47, 0x4d, 0x74, 0x15, 0x72, 0x1e, 0x96, 0x3f,
+	0x60, 0xf3, 0x8a, 0x61, 0xc1, 0x8a, 0x10, 0xae, 0x25, 0xc2,
+	0x26, 0x5a, 0x6d, 0xc7, 0x5e, 0x7c, 0x0b, 0x85, 0xd0, 0x00,
+	0x00, 0x00, 0x00, 0x0f, 0xb5, 0x22, 0x98, 0xd2, 0x41, 0x8a,
+	0x10, 0xae, 0x25, 0xdf, 0x79, 0xd7, 0x1b, 0x69, 0x91, 0x05,
+	0x70, 0xba, 0x00, 0x00, 0x00, 0x00, 0x01, 0xf6, 0xa2, 0x0a,
+	0x84, 0x18, 0xf5, 0x40, 0x5f, 0x59, 0x42, 0x41, 0x71, 0xf5,
+	0x93, 0xa1, 0xcd, 0xcf, 0x97, 0x9a, 0xf9, 0x8b, 0x81, 0xb3,
+	0xde, 0xcb, 0x41, 0x71, 0xc2, 0x6d, 0x5d, 0x30, 0x33, 0xa2,
+	0xfc, 0x3e, 0x34, 0x5f, 0x87, 0xc6, 0x8b, 0xf7, 0x5f, 0x5c,
+	0x82, 0xa2, 0xa8, 0xe9, 0xc2, 0x09, 0x3f, 0x32, 0xd1, 0xf6,
+	0xa2, 0x67, 0x2d, 0x25, 0x82, 0x41, 0xd9, 0xd7, 0xed, 0x4a,
+	0x07, 0x54, 0xd0, 0x16, 0xa5, 0xb1, 0x5d,
+	0x82, 0x04, 0x89, 0x60, 0x88, 0x43, 0x08, 0x32, 0x4a, 0xb9,
+	0x10, 0x8f, 0x86, 0xcb, 0xca, 0xc9, 0xc8, 0xc7, 0xc6, 0xc5,
+	0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+	0x82, 0x04, 0x88, 0x63, 0xa2, 0x18, 0x1d, 0x75, 0xaf, 0xd1,
+	0x1f, 0x86, 0xcb, 0xca, 0xc9, 0xc8, 0xc7, 0xc6, 0xc5, 0xc4,
+	0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+	0x82, 0x04, 0x8a, 0x63, 0xa2, 0x18, 0xee, 0x5a, 0xa4, 0x3d,
+	0x8b, 0xf4, 0x47, 0x86, 0xcb, 0xca, 0xc9, 0xc8, 0xc7, 0xc6,
+	0xc5, 0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+	0x82, 0x04, 0x8a, 0x60, 0xd4, 0xcc, 0xc5, 0x07, 0x98, 0xeb,
+	0xa3, 0xbc, 0xdf, 0x86, 0xcb, 0xca, 0xc9, 0xc8, 0xc7, 0xc6,
+	0xc5, 0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+	0x82, 0x04, 0x93, 0x60, 0xd4, 0xcc, 0xc4, 0xe5, 0xb0, 0xeb,
+	0xf4, 0xae, 0x6f, 0xf3, 0xc4, 0x01, 0x10, 0x01, 0xf1, 0xda,
+	0x07, 0x81, 0x86, 0xcb, 0xca, 0xc9, 0xc8, 0xc7, 0xc6, 0xc5,
+	0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+	0x82, 0x04, 0x8d, 0x62, 0x53, 0xd4, 0x94, 0x30, 0x6a, 0x92,
+	0x5b, 0x17, 0xf0, 0x79, 0x65, 0x17, 0x86, 0xcb, 0xca, 0xc9,
+	0xc8, 0xc7, 0xc6, 0xc5, 0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf,
+	0xbe,
+	0x82, 0x04, 0x89, 0x60, 0x75, 0x99, 0x8e, 0xe1, 0x62, 0xd4,
+	0x16, 0xcf, 0x86, 0xcb, 0xca, 0xc9, 0xc8, 0xc7, 0xc6, 0xc5,
+	0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+	0x82, 0x04, 0x8e, 0x60, 0x75, 0x99, 0x8e, 0xe1, 0x62, 0x52,
+	0x96, 0x4f, 0xf2, 0xb1, 0xcc, 0x58, 0x03, 0x86, 0xcb, 0xca,
+	0xc9, 0xc8, 0xc7, 0xc6, 0xc5, 0xc4, 0xc3, 0xc2, 0xc1, 0xc0,
+	0xbf, 0xbe,
+	0x82, 0x04, 0x8e, 0x60, 0x75, 0x99, 0x8e, 0xe1, 0x62, 0x52,
+	0x96, 0x4f, 0xf2, 0xb1, 0xcc, 0x58, 0x05, 0x86, 0xcb, 0xca,
+	0xc9, 0xc8, 0xc7, 0xc6, 0xc5, 0xc4, 0xc3, 0xc2, 0xc1, 0xc0,
+	0xbf, 0xbe,
+	0x82, 0x04, 0x89, 0x62, 0x51, 0xf7, 0x31, 0x0f, 0x52, 0xe6,
+	0x21, 0xff, 0x86, 0xcb, 0xca, 0xc9, 0xc8, 0xc7, 0xc6, 0xc5,
+	0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+	0x82, 0x04, 0x89, 0x60, 0xd4, 0xcc, 0xc0, 0xc2, 0xbf, 0x82,
+	0xc7, 0x5f, 0x86, 0xcb, 0xca, 0xc9, 0xc8, 0xc7, 0xc6, 0xc5,
+	0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+	0x82, 0x04, 0x89, 0x60, 0xd4, 0xcc, 0xc0, 0xc4, 0xbf, 0x82,
+	0xc7, 0x5f, 0x86, 0xcb, 0xca, 0xc9, 0xc8, 0xc7, 0xc6, 0xc5,
+	0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+	0x82, 0x04, 0x89, 0x60, 0xd4, 0xcc, 0xc0, 0xd9, 0x5f, 0xc1,
+	0x63, 0xaf, 0x86, 0xcb, 0xca, 0xc9, 0xc8, 0xc7, 0xc6, 0xc5,
+	0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+	0x82, 0x04, 0x89, 0x60, 0xd4, 0xcc, 0xc0, 0xda, 0x5f, 0xc1,
+	0x63, 0xaf, 0x86, 0xcb, 0xca, 0xc9, 0xc8, 0xc7, 0xc6, 0xc5,
+	0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+	0x82, 0x04, 0x8a, 0x62, 0x91, 0xd4, 0x69, 0x4a, 0x84, 0xaf,
+	0xd1, 0x07, 0xab, 0x86, 0xcb, 0xca, 0xc9, 0xc8, 0xc7, 0xc6,
+	0xc5, 0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+};
+
+static const uint16_t chrome_lens[] = {
+	487, 27, 26, 28, 28, 37, 31, 27, 32, 32, 27, 27, 27, 27, 27, 28
+};
+
+static const uint8_t firefox[] = {
+	0x82, 0x85, 0x86, 0x41, 0x8a, 0x08, 0x9d, 0x5c, 0x0b, 0x81,
+	0x70, 0xdc, 0x75, 0xe0, 0x07, 0x53, 0x03, 0x2a, 0x2f, 0x2a,
+	0x50, 0x8d, 0x9b, 0xd9, 0xab, 0xfa, 0x52, 0x42, 0xcb, 0x40,
+	0xd2, 0x5f, 0xa5, 0x23, 0xb3, 0x7a, 0xbb, 0xd0, 0x7f, 0x66,
+	0xa2, 0x81, 0xb0, 0xda, 0xe0, 0x53, 0xfa, 0xfc, 0x08, 0x7e,
+	0xd4, 0xe1, 0x1d, 0xb5, 0x26, 0xdf, 0xb5, 0x33, 0x9a, 0xab,
+	0x7c, 0xa9, 0xe5, 0xe7, 0x22, 0x71, 0xaf, 0xb5, 0x2c, 0xef,
+	0x70, 0x22, 0x0a, 0xe0, 0xfe, 0xd4, 0xc4, 0x52, 0x75, 0x3b,
+	0x02, 0x00, 0x40, 0x00, 0x80, 0x2a, 0x61, 0x35, 0x85, 0x94,
+	0xfe, 0x58, 0x08, 0x82, 0xb8, 0x3f, 0x51, 0x8b, 0x2d, 0x4b,
+	0x70, 0xdd, 0xf4, 0x5a, 0xbe, 0xfb, 0x40, 0x05, 0xdb, 0x40,
+	0x03, 0x64, 0x6e, 0x74, 0x01, 0x31, 0x40, 0x02, 0x74, 0x65,
+	0x86, 0x4d, 0x83, 0x35, 0x05, 0xb1, 0x1f, 0x40, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x42, 0xa1, 0x3f, 0x84,
+	0x2d, 0x35, 0xa7, 0xd7, 0x40, 0x8a, 0x41, 0x48, 0xb4, 0xa5,
+	0x49, 0x27, 0x5a, 0x93, 0xc8, 0x5f, 0x83, 0x21, 0xec, 0x47,
+	0x40, 0x8a, 0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27, 0x59, 0x06,
+	0x49, 0x7f, 0x88, 0x40, 0xe9, 0x2a, 0xc7, 0xb0, 0xd3, 0x1a,
+	0xaf, 0x60, 0xa4, 0x41, 0xa4, 0x81, 0xe9, 0x42, 0xd1, 0x5a,
+	0x6e, 0x52, 0x14, 0xa3, 0x0b, 0x8e, 0x8d, 0xb1, 0xb2, 0xe4,
+	0x85, 0x92, 0x46, 0xa3, 0x28, 0xc4, 0xdb, 0x4c, 0xfd, 0xa9,
+	0x5d, 0x85, 0x95, 0x10, 0x10, 0xf4, 0xd6, 0x32, 0x27,
+	0x82, 0x04, 0x8b, 0x61, 0x09, 0x1a, 0x4c, 0x46, 0x29, 0x19,
+	0xaa, 0x5c, 0x88, 0x47, 0x86, 0xc8, 0xc7, 0xc6, 0xc5, 0xc4,
+	0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+	0x82, 0x04, 0x8b, 0x61, 0x09, 0x1a, 0x4c, 0x46, 0x29, 0x19,
+	0xaa, 0x5f, 0xa2, 0x3f, 0x86, 0xc8, 0xc7, 0xc6, 0xc5, 0xc4,
+	0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+	0x82, 0x04, 0x90, 0x61, 0x09, 0x1a, 0x4c, 0x46, 0x0d, 0x4c,
+	0xcc, 0x46, 0x3a, 0xaa, 0x2d, 0x8b, 0xd7, 0x54, 0xdf, 0x86,
+	0xc8, 0xc7, 0xc6, 0xc5, 0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf,
+	0xbe,
+	0x82, 0x04, 0x90, 0x61, 0x09, 0x1a, 0x4c, 0x46, 0x0d, 0x4c,
+	0xcc, 0x18, 0x87, 0xa9, 0x60, 0xaf, 0x5d, 0x53, 0x7f, 0x86,
+	0xc8, 0xc7, 0xc6, 0xc5, 0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf,
+	0xbe,
+	0x82, 0x04, 0x90, 0x61, 0x09, 0x1a, 0x4c, 0x46, 0x0d, 0x4c,
+	0xcc, 0x18, 0x87, 0xa9, 0x61, 0x2f, 0x5d, 0x53, 0x7f, 0x86,
+	0xc8, 0xc7, 0xc6, 0xc5, 0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf,
+	0xbe,
+	0x82, 0x04, 0x8e, 0x60, 0x75, 0x99, 0x84, 0x14, 0x76, 0x12,
+	0x7f, 0xf3, 0xb4, 0x13, 0xd6, 0x32, 0x75, 0x86, 0xc8, 0xc7,
+	0xc6, 0xc5, 0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+	0x82, 0x04, 0x90, 0x60, 0x75, 0x99, 0x84, 0x14, 0x76, 0x12,
+	0x7f, 0xf3, 0xb4, 0x13, 0xdb, 0x2c, 0xb4, 0x8e, 0xaf, 0x86,
+	0xc8, 0xc7, 0xc6, 0xc5, 0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf,
+	0xbe,
+	0x82, 0x04, 0x8f, 0x61, 0x09, 0x1a, 0x4c, 0x46, 0x25, 0x3d,
+	0x49, 0x43, 0x03, 0x5f, 0xc1, 0xe5, 0x94, 0x5f, 0x86, 0xc8,
+	0xc7, 0xc6, 0xc5, 0xc4, 0xc3, 0xc2, 0xc1, 0xc0, 0xbf, 0xbe,
+	0x82, 0x04, 0x88, 0x62, 0xc3, 0xc6, 0x74, 0xa1, 0x74, 0xf9,
+	0x4f, 0x86, 0xc8, 0xc7, 0xc6, 0xc5, 0xc4, 0xc3, 0xc2, 0xc1,
+	0xc0, 0xbf, 0xbe,
+};
+
+static const uint16_t firefox_lens[] = {
+	219, 26, 26, 31, 31, 31, 29, 31, 30, 23
+};
+
+/*
+ * The Chrome page load again, but recorded with SETTINGS_HEADER_TABLE_SIZE
+ * of 0, so every header is sent as a Huffman-coded literal every time
+ */
+
+static const uint8_t chrome_literal[] = {
+	0x20, 0x82, 0x84, 0x86, 0x01, 0x8a, 0x08, 0x9d, 0x5c, 0x0b,
+	0x81, 0x70, 0xdc, 0x75, 0xe0, 0x0b, 0x0f, 0x04, 0xc0, 0x49,
+	0x7c, 0xa5, 0x89, 0xd3, 0x4d, 0x1f, 0x43, 0xae, 0xba, 0x0c,
+	0x41, 0xa4, 0xc7, 0xa9, 0x8f, 0x33, 0xa6, 0x9a, 0x3f, 0xdf,
+	0x9a, 0x68, 0xfa, 0x1d, 0x75, 0xd0, 0x62, 0x0d, 0x26, 0x3d,
+	0x4c, 0x79, 0xa6, 0x8f, 0xbe, 0xd0, 0x01, 0x77, 0xfe, 0x8d,
+	0x48, 0xe6, 0x2b, 0x03, 0xee, 0x69, 0x7e, 0x8d, 0x48, 0xe6,
+	0x2b, 0x1e, 0x0b, 0x1d, 0x7f, 0x5f, 0x2c, 0x7c, 0xfd, 0xf6,
+	0x80, 0x0b, 0xbd, 0x0f, 0x01, 0x8d, 0x9b, 0xd9, 0xab, 0xfa,
+	0x52, 0x42, 0xcb, 0x40, 0xd2, 0x5f, 0xa5, 0x23, 0xb3, 0x0f,
+	0x2b, 0xce, 0xd0, 0x7f, 0x66, 0xa2, 0x81, 0xb0, 0xda, 0xe0,
+	0x53, 0xfa, 0xfc, 0x08, 0x7e, 0xd4, 0xce, 0x6a, 0xad, 0xf2,
+	0xa7, 0x97, 0x9c, 0x89, 0xc6, 0xbf, 0xb5, 0x21, 0xae, 0xba,
+	0x0b, 0xc8, 0xb1, 0xe6, 0x32, 0x58, 0x6d, 0x97, 0x57, 0x65,
+	0xc5, 0x3f, 0xac, 0xd8, 0xf7, 0xe8, 0xcf, 0xf4, 0xa5, 0x06,
+	0xea, 0x55, 0x31, 0x14, 0x9d, 0x4f, 0xfd, 0xa9, 0x7a, 0x7b,
+	0x0f, 0x49, 0x58, 0x08, 0x80, 0xb8, 0x17, 0x02, 0xe0, 0x53,
+	0x70, 0xe5, 0x1d, 0x86, 0x61, 0xb6, 0x5d, 0x5d, 0x97, 0x3f,
+	0x0f, 0x02, 0x8b, 0x2d, 0x4b, 0x62, 0xbb, 0xf4, 0x5a, 0xbe,
+	0xfb, 0x40, 0x05, 0xdf, 0x00, 0x87, 0x41, 0x48, 0xb1, 0x27,
+	0x5a, 0xd1, 0xff, 0xa2, 0xfe, 0x74, 0x9d, 0x31, 0x42, 0xa5,
+	0xdb, 0x07, 0x54, 0x9f, 0xcf, 0xdf, 0x78, 0x3f, 0x97, 0xbf,
+	0x9f, 0xa5, 0x3f, 0x9b, 0xd3, 0xd8, 0x7a, 0x4d, 0x6d, 0x3f,
+	0xcf, 0xdf, 0x78, 0x3f, 0x90, 0x88, 0x1f, 0xcf, 0x00, 0x8b,
+	0x41, 0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x49, 0xe3, 0x35,
+	0x05, 0x02, 0x3f, 0x30, 0x00, 0x8d, 0x41, 0x48, 0xb1, 0x27,
+	0x5a, 0xd1, 0xad, 0x5d, 0x03, 0x4c, 0xa7, 0xb2, 0x9f, 0x07,
+	0x22, 0x4c, 0x69, 0x6e, 0x75, 0x78, 0x22, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x59, 0x06, 0x49, 0x7f, 0x88,
+	0x40, 0xe9, 0x2a, 0xc7, 0xb0, 0xd3, 0x1a, 0xaf, 0x00, 0x8a,
+	0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x93, 0xc8, 0x5f,
+	0x86, 0xa8, 0x7d, 0xcd, 0x30, 0xd2, 0x5f, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x42, 0xa1, 0x3f, 0x86,
+	0x90, 0xe4, 0xb6, 0x92, 0xd4, 0x9f, 0x00, 0x92, 0xb6, 0xb9,
+	0xac, 0x1c, 0x85, 0x58, 0xd5, 0x20, 0xa4, 0xb6, 0xc2, 0xad,
+	0x61, 0x7b, 0x5a, 0x54, 0x25, 0x1f, 0x01, 0x31, 0x0f, 0x24,
+	0x8f, 0x9d, 0x29, 0xad, 0x17, 0x18, 0x60, 0xbe, 0x47, 0x4d,
+	0x74, 0x15, 0x72, 0x1e, 0x96, 0x3f, 0x0f, 0x11, 0xf3, 0x8a,
+	0x61, 0xc1, 0x8a, 0x10, 0xae, 0x25, 0xc2, 0x26, 0x5a, 0x6d,
+	0xc7, 0x5e, 0x7c, 0x0b, 0x85, 0xd0, 0x00, 0x00, 0x00, 0x00,
+	0x0f, 0xb5, 0x22, 0x98, 0xd2, 0x41, 0x8a, 0x10, 0xae, 0x25,
+	0xdf, 0x79, 0xd7, 0x1b, 0x69, 0x91, 0x05, 0x70, 0xba, 0x00,
+	0x00, 0x00, 0x00, 0x01, 0xf6, 0xa2, 0x0a, 0x84, 0x18, 0xf5,
+	0x40, 0x5f, 0x59, 0x42, 0x41, 0x71, 0xf5, 0x93, 0xa1, 0xcd,
+	0xcf, 0x97, 0x9a, 0xf9, 0x8b, 0x81, 0xb3, 0xde, 0xcb, 0x41,
+	0x71, 0xc2, 0x6d, 0x5d, 0x30, 0x33, 0xa2, 0xfc, 0x3e, 0x34,
+	0x5f, 0x87, 0xc6, 0x8b, 0xf7, 0x5f, 0x5c, 0x82, 0xa2, 0xa8,
+	0xe9, 0xc2, 0x09, 0x3f, 0x32, 0xd1, 0xf6, 0xa2, 0x67, 0x2d,
+	0x25, 0x82, 0x41, 0xd9, 0xd7, 0xed, 0x4a, 0x07, 0x54, 0xd0,
+	0x16, 0xa5, 0xb1, 0x5d,
+	0x82, 0x04, 0x89, 0x60, 0x88, 0x43, 0x08, 0x32, 0x4a, 0xb9,
+	0x10, 0x8f, 0x86, 0x01, 0x8a, 0x08, 0x9d, 0x5c, 0x0b, 0x81,
+	0x70, 0xdc, 0x75, 0xe0, 0x0b, 0x0f, 0x04, 0xc0, 0x49, 0x7c,
+	0xa5, 0x89, 0xd3, 0x4d, 0x1f, 0x43, 0xae, 0xba, 0x0c, 0x41,
+	0xa4, 0xc7, 0xa9, 0x8f, 0x33, 0xa6, 0x9a, 0x3f, 0xdf, 0x9a,
+	0x68, 0xfa, 0x1d, 0x75, 0xd0, 0x62, 0x0d, 0x26, 0x3d, 0x4c,
+	0x79, 0xa6, 0x8f, 0xbe, 0xd0, 0x01, 0x77, 0xfe, 0x8d, 0x48,
+	0xe6, 0x2b, 0x03, 0xee, 0x69, 0x7e, 0x8d, 0x48, 0xe6, 0x2b,
+	0x1e, 0x0b, 0x1d, 0x7f, 0x5f, 0x2c, 0x7c, 0xfd, 0xf6, 0x80,
+	0x0b, 0xbd, 0x0f, 0x01, 0x8d, 0x9b, 0xd9, 0xab, 0xfa, 0x52,
+	0x42, 0xcb, 0x40, 0xd2, 0x5f, 0xa5, 0x23, 0xb3, 0x0f, 0x2b,
+	0xce, 0xd0, 0x7f, 0x66, 0xa2, 0x81, 0xb0, 0xda, 0xe0, 0x53,
+	0xfa, 0xfc, 0x08, 0x7e, 0xd4, 0xce, 0x6a, 0xad, 0xf2, 0xa7,
+	0x97, 0x9c, 0x89, 0xc6, 0xbf, 0xb5, 0x21, 0xae, 0xba, 0x0b,
+	0xc8, 0xb1, 0xe6, 0x32, 0x58, 0x6d, 0x97, 0x57, 0x65, 0xc5,
+	0x3f, 0xac, 0xd8, 0xf7, 0xe8, 0xcf, 0xf4, 0xa5, 0x06, 0xea,
+	0x55, 0x31, 0x14, 0x9d, 0x4f, 0xfd, 0xa9, 0x7a, 0x7b, 0x0f,
+	0x49, 0x58, 0x08, 0x80, 0xb8, 0x17, 0x02, 0xe0, 0x53, 0x70,
+	0xe5, 0x1d, 0x86, 0x61, 0xb6, 0x5d, 0x5d, 0x97, 0x3f, 0x0f,
+	0x02, 0x8b, 0x2d, 0x4b, 0x62, 0xbb, 0xf4, 0x5a, 0xbe, 0xfb,
+	0x40, 0x05, 0xdf, 0x00, 0x87, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xff, 0xa2, 0xfe, 0x74, 0x9d, 0x31, 0x42, 0xa5, 0xdb,
+	0x07, 0x54, 0x9f, 0xcf, 0xdf, 0x78, 0x3f, 0x97, 0xbf, 0x9f,
+	0xa5, 0x3f, 0x9b, 0xd3, 0xd8, 0x7a, 0x4d, 0x6d, 0x3f, 0xcf,
+	0xdf, 0x78, 0x3f, 0x90, 0x88, 0x1f, 0xcf, 0x00, 0x8b, 0x41,
+	0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x49, 0xe3, 0x35, 0x05,
+	0x02, 0x3f, 0x30, 0x00, 0x8d, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xad, 0x5d, 0x03, 0x4c, 0xa7, 0xb2, 0x9f, 0x07, 0x22,
+	0x4c, 0x69, 0x6e, 0x75, 0x78, 0x22, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x59, 0x06, 0x49, 0x7f, 0x88, 0x40,
+	0xe9, 0x2a, 0xc7, 0xb0, 0xd3, 0x1a, 0xaf, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x93, 0xc8, 0x5f, 0x86,
+	0xa8, 0x7d, 0xcd, 0x30, 0xd2, 0x5f, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x42, 0xa1, 0x3f, 0x86, 0x90,
+	0xe4, 0xb6, 0x92, 0xd4, 0x9f, 0x00, 0x92, 0xb6, 0xb9, 0xac,
+	0x1c, 0x85, 0x58, 0xd5, 0x20, 0xa4, 0xb6, 0xc2, 0xad, 0x61,
+	0x7b, 0x5a, 0x54, 0x25, 0x1f, 0x01, 0x31, 0x0f, 0x24, 0x8f,
+	0x9d, 0x29, 0xad, 0x17, 0x18, 0x60, 0xbe, 0x47, 0x4d, 0x74,
+	0x15, 0x72, 0x1e, 0x96, 0x3f, 0x0f, 0x11, 0xf3, 0x8a, 0x61,
+	0xc1, 0x8a, 0x10, 0xae, 0x25, 0xc2, 0x26, 0x5a, 0x6d, 0xc7,
+	0x5e, 0x7c, 0x0b, 0x85, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x0f,
+	0xb5, 0x22, 0x98, 0xd2, 0x41, 0x8a, 0x10, 0xae, 0x25, 0xdf,
+	0x79, 0xd7, 0x1b, 0x69, 0x91, 0x05, 0x70, 0xba, 0x00, 0x00,
+	0x00, 0x00, 0x01, 0xf6, 0xa2, 0x0a, 0x84, 0x18, 0xf5, 0x40,
+	0x5f, 0x59, 0x42, 0x41, 0x71, 0xf5, 0x93, 0xa1, 0xcd, 0xcf,
+	0x97, 0x9a, 0xf9, 0x8b, 0x81, 0xb3, 0xde, 0xcb, 0x41, 0x71,
+	0xc2, 0x6d, 0x5d, 0x30, 0x33, 0xa2, 0xfc, 0x3e, 0x34, 0x5f,
+	0x87, 0xc6, 0x8b, 0xf7, 0x5f, 0x5c, 0x82, 0xa2, 0xa8, 0xe9,
+	0xc2, 0x09, 0x3f, 0x32, 0xd1, 0xf6, 0xa2, 0x67, 0x2d, 0x25,
+	0x82, 0x41, 0xd9, 0xd7, 0xed, 0x4a, 0x07, 0x54, 0xd0, 0x16,
+	0xa5, 0xb1, 0x5d,
+	0x82, 0x04, 0x88, 0x63, 0xa2, 0x18, 0x1d, 0x75, 0xaf, 0xd1,
+	0x1f, 0x86, 0x01, 0x8a, 0x08, 0x9d, 0x5c, 0x0b, 0x81, 0x70,
+	0xdc, 0x75, 0xe0, 0x0b, 0x0f, 0x04, 0xc0, 0x49, 0x7c, 0xa5,
+	0x89, 0xd3, 0x4d, 0x1f, 0x43, 0xae, 0xba, 0x0c, 0x41, 0xa4,
+	0xc7, 0xa9, 0x8f, 0x33, 0xa6, 0x9a, 0x3f, 0xdf, 0x9a, 0x68,
+	0xfa, 0x1d, 0x75, 0xd0, 0x62, 0x0d, 0x26, 0x3d, 0x4c, 0x79,
+	0xa6, 0x8f, 0xbe, 0xd0, 0x01, 0x77, 0xfe, 0x8d, 0x48, 0xe6,
+	0x2b, 0x03, 0xee, 0x69, 0x7e, 0x8d, 0x48, 0xe6, 0x2b, 0x1e,
+	0x0b, 0x1d, 0x7f, 0x5f, 0x2c, 0x7c, 0xfd, 0xf6, 0x80, 0x0b,
+	0xbd, 0x0f, 0x01, 0x8d, 0x9b, 0xd9, 0xab, 0xfa, 0x52, 0x42,
+	0xcb, 0x40, 0xd2, 0x5f, 0xa5, 0x23, 0xb3, 0x0f, 0x2b, 0xce,
+	0xd0, 0x7f, 0x66, 0xa2, 0x81, 0xb0, 0xda, 0xe0, 0x53, 0xfa,
+	0xfc, 0x08, 0x7e, 0xd4, 0xce, 0x6a, 0xad, 0xf2, 0xa7, 0x97,
+	0x9c, 0x89, 0xc6, 0xbf, 0xb5, 0x21, 0xae, 0xba, 0x0b, 0xc8,
+	0xb1, 0xe6, 0x32, 0x58, 0x6d, 0x97, 0x57, 0x65, 0xc5, 0x3f,
+	0xac, 0xd8, 0xf7, 0xe8, 0xcf, 0xf4, 0xa5, 0x06, 0xea, 0x55,
+	0x31, 0x14, 0x9d, 0x4f, 0xfd, 0xa9, 0x7a, 0x7b, 0x0f, 0x49,
+	0x58, 0x08, 0x80, 0xb8, 0x17, 0x02, 0xe0, 0x53, 0x70, 0xe5,
+	0x1d, 0x86, 0x61, 0xb6, 0x5d, 0x5d, 0x97, 0x3f, 0x0f, 0x02,
+	0x8b, 0x2d, 0x4b, 0x62, 0xbb, 0xf4, 0x5a, 0xbe, 0xfb, 0x40,
+	0x05, 0xdf, 0x00, 0x87, 0x41, 0x48, 0xb1, 0x27, 0x5a, 0xd1,
+	0xff, 0xa2, 0xfe, 0x74, 0x9d, 0x31, 0x42, 0xa5, 0xdb, 0x07,
+	0x54, 0x9f, 0xcf, 0xdf, 0x78, 0x3f, 0x97, 0xbf, 0x9f, 0xa5,
+	0x3f, 0x9b, 0xd3, 0xd8, 0x7a, 0x4d, 0x6d, 0x3f, 0xcf, 0xdf,
+	0x78, 0x3f, 0x90, 0x88, 0x1f, 0xcf, 0x00, 0x8b, 0x41, 0x48,
+	0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x49, 0xe3, 0x35, 0x05, 0x02,
+	0x3f, 0x30, 0x00, 0x8d, 0x41, 0x48, 0xb1, 0x27, 0x5a, 0xd1,
+	0xad, 0x5d, 0x03, 0x4c, 0xa7, 0xb2, 0x9f, 0x07, 0x22, 0x4c,
+	0x69, 0x6e, 0x75, 0x78, 0x22, 0x00, 0x8a, 0x41, 0x48, 0xb4,
+	0xa5, 0x49, 0x27, 0x59, 0x06, 0x49, 0x7f, 0x88, 0x40, 0xe9,
+	0x2a, 0xc7, 0xb0, 0xd3, 0x1a, 0xaf, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x93, 0xc8, 0x5f, 0x86, 0xa8,
+	0x7d, 0xcd, 0x30, 0xd2, 0x5f, 0x00, 0x8a, 0x41, 0x48, 0xb4,
+	0xa5, 0x49, 0x27, 0x5a, 0x42, 0xa1, 0x3f, 0x86, 0x90, 0xe4,
+	0xb6, 0x92, 0xd4, 0x9f, 0x00, 0x92, 0xb6, 0xb9, 0xac, 0x1c,
+	0x85, 0x58, 0xd5, 0x20, 0xa4, 0xb6, 0xc2, 0xad, 0x61, 0x7b,
+	0x5a, 0x54, 0x25, 0x1f, 0x01, 0x31, 0x0f, 0x24, 0x8f, 0x9d,
+	0x29, 0xad, 0x17, 0x18, 0x60, 0xbe, 0x47, 0x4d, 0x74, 0x15,
+	0x72, 0x1e, 0x96, 0x3f, 0x0f, 0x11, 0xf3, 0x8a, 0x61, 0xc1,
+	0x8a, 0x10, 0xae, 0x25, 0xc2, 0x26, 0x5a, 0x6d, 0xc7, 0x5e,
+	0x7c, 0x0b, 0x85, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x0f, 0xb5,
+	0x22, 0x98, 0xd2, 0x41, 0x8a, 0x10, 0xae, 0x25, 0xdf, 0x79,
+	0xd7, 0x1b, 0x69, 0x91, 0x05, 0x70, 0xba, 0x00, 0x00, 0x00,
+	0x00, 0x01, 0xf6, 0xa2, 0x0a, 0x84, 0x18, 0xf5, 0x40, 0x5f,
+	0x59, 0x42, 0x41, 0x71, 0xf5, 0x93, 0xa1, 0xcd, 0xcf, 0x97,
+	0x9a, 0xf9, 0x8b, 0x81, 0xb3, 0xde, 0xcb, 0x41, 0x71, 0xc2,
+	0x6d, 0x5d, 0x30, 0x33, 0xa2, 0xfc, 0x3e, 0x34, 0x5f, 0x87,
+	0xc6, 0x8b, 0xf7, 0x5f, 0x5c, 0x82, 0xa2, 0xa8, 0xe9, 0xc2,
+	0x09, 0x3f, 0x32, 0xd1, 0xf6, 0xa2, 0x67, 0x2d, 0x25, 0x82,
+	0x41, 0xd9, 0xd7, 0xed, 0x4a, 0x07, 0x54, 0xd0, 0x16, 0xa5,
+	0xb1, 0x5d,
+	0x82, 0x04, 0x8a, 0x63, 0xa2, 0x18, 0xee, 0x5a, 0xa4, 0x3d,
+	0x8b, 0xf4, 0x47, 0x86, 0x01, 0x8a, 0x08, 0x9d, 0x5c, 0x0b,
+	0x81, 0x70, 0xdc, 0x75, 0xe0, 0x0b, 0x0f, 0x04, 0xc0, 0x49,
+	0x7c, 0xa5, 0x89, 0xd3, 0x4d, 0x1f, 0x43, 0xae, 0xba, 0x0c,
+	0x41, 0xa4, 0xc7, 0xa9, 0x8f, 0x33, 0xa6, 0x9a, 0x3f, 0xdf,
+	0x9a, 0x68, 0xfa, 0x1d, 0x75, 0xd0, 0x62, 0x0d, 0x26, 0x3d,
+	0x4c, 0x79, 0xa6, 0x8f, 0xbe, 0xd0, 0x01, 0x77, 0xfe, 0x8d,
+	0x48, 0xe6, 0x2b, 0x03, 0xee, 0x69, 0x7e, 0x8d, 0x48, 0xe6,
+	0x2b, 0x1e, 0x0b, 0x1d, 0x7f, 0x5f, 0x2c, 0x7c, 0xfd, 0xf6,
+	0x80, 0x0b, 0xbd, 0x0f, 0x01, 0x8d, 0x9b, 0xd9, 0xab, 0xfa,
+	0x52, 0x42, 0xcb, 0x40, 0xd2, 0x5f, 0xa5, 0x23, 0xb3, 0x0f,
+	0x2b, 0xce, 0xd0, 0x7f, 0x66, 0xa2, 0x81, 0xb0, 0xda, 0xe0,
+	0x53, 0xfa, 0xfc, 0x08, 0x7e, 0xd4, 0xce, 0x6a, 0xad, 0xf2,
+	0xa7, 0x97, 0x9c, 0x89, 0xc6, 0xbf, 0xb5, 0x21, 0xae, 0xba,
+	0x0b, 0xc8, 0xb1, 0xe6, 0x32, 0x58, 0x6d, 0x97, 0x57, 0x65,
+	0xc5, 0x3f, 0xac, 0xd8, 0xf7, 0xe8, 0xcf, 0xf4, 0xa5, 0x06,
+	0xea, 0x55, 0x31, 0x14, 0x9d, 0x4f, 0xfd, 0xa9, 0x7a, 0x7b,
+	0x0f, 0x49, 0x58, 0x08, 0x80, 0xb8, 0x17, 0x02, 0xe0, 0x53,
+	0x70, 0xe5, 0x1d, 0x86, 0x61, 0xb6, 0x5d, 0x5d, 0x97, 0x3f,
+	0x0f, 0x02, 0x8b, 0x2d, 0x4b, 0x62, 0xbb, 0xf4, 0x5a, 0xbe,
+	0xfb, 0x40, 0x05, 0xdf, 0x00, 0x87, 0x41, 0x48, 0xb1, 0x27,
+	0x5a, 0xd1, 0xff, 0xa2, 0xfe, 0x74, 0x9d, 0x31, 0x42, 0xa5,
+	0xdb, 0x07, 0x54, 0x9f, 0xcf, 0xdf, 0x78, 0x3f, 0x97, 0xbf,
+	0x9f, 0xa5, 0x3f, 0x9b, 0xd3, 0xd8, 0x7a, 0x4d, 0x6d, 0x3f,
+	0xcf, 0xdf, 0x78, 0x3f, 0x90, 0x88, 0x1f, 0xcf, 0x00, 0x8b,
+	0x41, 0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x49, 0xe3, 0x35,
+	0x05, 0x02, 0x3f, 0x30, 0x00, 0x8d, 0x41, 0x48, 0xb1, 0x27,
+	0x5a, 0xd1, 0xad, 0x5d, 0x03, 0x4c, 0xa7, 0xb2, 0x9f, 0x07,
+	0x22, 0x4c, 0x69, 0x6e, 0x75, 0x78, 0x22, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x59, 0x06, 0x49, 0x7f, 0x88,
+	0x40, 0xe9, 0x2a, 0xc7, 0xb0, 0xd3, 0x1a, 0xaf, 0x00, 0x8a,
+	0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x93, 0xc8, 0x5f,
+	0x86, 0xa8, 0x7d, 0xcd, 0x30, 0xd2, 0x5f, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x42, 0xa1, 0x3f, 0x86,
+	0x90, 0xe4, 0xb6, 0x92, 0xd4, 0x9f, 0x00, 0x92, 0xb6, 0xb9,
+	0xac, 0x1c, 0x85, 0x58, 0xd5, 0x20, 0xa4, 0xb6, 0xc2, 0xad,
+	0x61, 0x7b, 0x5a, 0x54, 0x25, 0x1f, 0x01, 0x31, 0x0f, 0x24,
+	0x8f, 0x9d, 0x29, 0xad, 0x17, 0x18, 0x60, 0xbe, 0x47, 0x4d,
+	0x74, 0x15, 0x72, 0x1e, 0x96, 0x3f, 0x0f, 0x11, 0xf3, 0x8a,
+	0x61, 0xc1, 0x8a, 0x10, 0xae, 0x25, 0xc2, 0x26, 0x5a, 0x6d,
+	0xc7, 0x5e, 0x7c, 0x0b, 0x85, 0xd0, 0x00, 0x00, 0x00, 0x00,
+	0x0f, 0xb5, 0x22, 0x98, 0xd2, 0x41, 0x8a, 0x10, 0xae, 0x25,
+	0xdf, 0x79, 0xd7, 0x1b, 0x69, 0x91, 0x05, 0x70, 0xba, 0x00,
+	0x00, 0x00, 0x00, 0x01, 0xf6, 0xa2, 0x0a, 0x84, 0x18, 0xf5,
+	0x40, 0x5f, 0x59, 0x42, 0x41, 0x71, 0xf5, 0x93, 0xa1, 0xcd,
+	0xcf, 0x97, 0x9a, 0xf9, 0x8b, 0x81, 0xb3, 0xde, 0xcb, 0x41,
+	0x71, 0xc2, 0x6d, 0x5d, 0x30, 0x33, 0xa2, 0xfc, 0x3e, 0x34,
+	0x5f, 0x87, 0xc6, 0x8b, 0xf7, 0x5f, 0x5c, 0x82, 0xa2, 0xa8,
+	0xe9, 0xc2, 0x09, 0x3f, 0x32, 0xd1, 0xf6, 0xa2, 0x67, 0x2d,
+	0x25, 0x82, 0x41, 0xd9, 0xd7, 0xed, 0x4a, 0x07, 0x54, 0xd0,
+	0x16, 0xa5, 0xb1, 0x5d,
+	0x82, 0x04, 0x8a, 0x60, 0xd4, 0xcc, 0xc5, 0x07, 0x98, 0xeb,
+	0xa3, 0xbc, 0xdf, 0x86, 0x01, 0x8a, 0x08, 0x9d, 0x5c, 0x0b,
+	0x81, 0x70, 0xdc, 0x75, 0xe0, 0x0b, 0x0f, 0x04, 0xc0, 0x49,
+	0x7c, 0xa5, 0x89, 0xd3, 0x4d, 0x1f, 0x43, 0xae, 0xba, 0x0c,
+	0x41, 0xa4, 0xc7, 0xa9, 0x8f, 0x33, 0xa6, 0x9a, 0x3f, 0xdf,
+	0x9a, 0x68, 0xfa, 0x1d, 0x75, 0xd0, 0x62, 0x0d, 0x26, 0x3d,
+	0x4c, 0x79, 0xa6, 0x8f, 0xbe, 0xd0, 0x01, 0x77, 0xfe, 0x8d,
+	0x48, 0xe6, 0x2b, 0x03, 0xee, 0x69, 0x7e, 0x8d, 0x48, 0xe6,
+	0x2b, 0x1e, 0x0b, 0x1d, 0x7f, 0x5f, 0x2c, 0x7c, 0xfd, 0xf6,
+	0x80, 0x0b, 0xbd, 0x0f, 0x01, 0x8d, 0x9b, 0xd9, 0xab, 0xfa,
+	0x52, 0x42, 0xcb, 0x40, 0xd2, 0x5f, 0xa5, 0x23, 0xb3, 0x0f,
+	0x2b, 0xce, 0xd0, 0x7f, 0x66, 0xa2, 0x81, 0xb0, 0xda, 0xe0,
+	0x53, 0xfa, 0xfc, 0x08, 0x7e, 0xd4, 0xce, 0x6a, 0xad, 0xf2,
+	0xa7, 0x97, 0x9c, 0x89, 0xc6, 0xbf, 0xb5, 0x21, 0xae, 0xba,
+	0x0b, 0xc8, 0xb1, 0xe6, 0x32, 0x58, 0x6d, 0x97, 0x57, 0x65,
+	0xc5, 0x3f, 0xac, 0xd8, 0xf7, 0xe8, 0xcf, 0xf4, 0xa5, 0x06,
+	0xea, 0x55, 0x31, 0x14, 0x9d, 0x4f, 0xfd, 0xa9, 0x7a, 0x7b,
+	0x0f, 0x49, 0x58, 0x08, 0x80, 0xb8, 0x17, 0x02, 0xe0, 0x53,
+	0x70, 0xe5, 0x1d, 0x86, 0x61, 0xb6, 0x5d, 0x5d, 0x97, 0x3f,
+	0x0f, 0x02, 0x8b, 0x2d, 0x4b, 0x62, 0xbb, 0xf4, 0x5a, 0xbe,
+	0xfb, 0x40, 0x05, 0xdf, 0x00, 0x87, 0x41, 0x48, 0xb1, 0x27,
+	0x5a, 0xd1, 0xff, 0xa2, 0xfe, 0x74, 0x9d, 0x31, 0x42, 0xa5,
+	0xdb, 0x07, 0x54, 0x9f, 0xcf, 0xdf, 0x78, 0x3f, 0x97, 0xbf,
+	0x9f, 0xa5, 0x3f, 0x9b, 0xd3, 0xd8, 0x7a, 0x4d, 0x6d, 0x3f,
+	0xcf, 0xdf, 0x78, 0x3f, 0x90, 0x88, 0x1f, 0xcf, 0x00, 0x8b,
+	0x41, 0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x49, 0xe3, 0x35,
+	0x05, 0x02, 0x3f, 0x30, 0x00, 0x8d, 0x41, 0x48, 0xb1, 0x27,
+	0x5a, 0xd1, 0xad, 0x5d, 0x03, 0x4c, 0xa7, 0xb2, 0x9f, 0x07,
+	0x22, 0x4c, 0x69, 0x6e, 0x75, 0x78, 0x22, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x59, 0x06, 0x49, 0x7f, 0x88,
+	0x40, 0xe9, 0x2a, 0xc7, 0xb0, 0xd3, 0x1a, 0xaf, 0x00, 0x8a,
+	0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x93, 0xc8, 0x5f,
+	0x86, 0xa8, 0x7d, 0xcd, 0x30, 0xd2, 0x5f, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x42, 0xa1, 0x3f, 0x86,
+	0x90, 0xe4, 0xb6, 0x92, 0xd4, 0x9f, 0x00, 0x92, 0xb6, 0xb9,
+	0xac, 0x1c, 0x85, 0x58, 0xd5, 0x20, 0xa4, 0xb6, 0xc2, 0xad,
+	0x61, 0x7b, 0x5a, 0x54, 0x25, 0x1f, 0x01, 0x31, 0x0f, 0x24,
+	0x8f, 0x9d, 0x29, 0xad, 0x17, 0x18, 0x60, 0xbe, 0x47, 0x4d,
+	0x74, 0x15, 0x72, 0x1e, 0x96, 0x3f, 0x0f, 0x11, 0xf3, 0x8a,
+	0x61, 0xc1, 0x8a, 0x10, 0xae, 0x25, 0xc2, 0x26, 0x5a, 0x6d,
+	0xc7, 0x5e, 0x7c, 0x0b, 0x85, 0xd0, 0x00, 0x00, 0x00, 0x00,
+	0x0f, 0xb5, 0x22, 0x98, 0xd2, 0x41, 0x8a, 0x10, 0xae, 0x25,
+	0xdf, 0x79, 0xd7, 0x1b, 0x69, 0x91, 0x05, 0x70, 0xba, 0x00,
+	0x00, 0x00, 0x00, 0x01, 0xf6, 0xa2, 0x0a, 0x84, 0x18, 0xf5,
+	0x40, 0x5f, 0x59, 0x42, 0x41, 0x71, 0xf5, 0x93, 0xa1, 0xcd,
+	0xcf, 0x97, 0x9a, 0xf9, 0x8b, 0x81, 0xb3, 0xde, 0xcb, 0x41,
+	0x71, 0xc2, 0x6d, 0x5d, 0x30, 0x33, 0xa2, 0xfc, 0x3e, 0x34,
+	0x5f, 0x87, 0xc6, 0x8b, 0xf7, 0x5f, 0x5c, 0x82, 0xa2, 0xa8,
+	0xe9, 0xc2, 0x09, 0x3f, 0x32, 0xd1, 0xf6, 0xa2, 0x67, 0x2d,
+	0x25, 0x82, 0x41, 0xd9, 0xd7, 0xed, 0x4a, 0x07, 0x54, 0xd0,
+	0x16, 0xa5, 0xb1, 0x5d,
+	0x82, 0x04, 0x93, 0x60, 0xd4, 0xcc, 0xc4, 0xe5, 0xb0, 0xeb,
+	0xf4, 0xae, 0x6f, 0xf3, 0xc4, 0x01, 0x10, 0x01, 0xf1, 0xda,
+	0x07, 0x81, 0x86, 0x01, 0x8a, 0x08, 0x9d, 0x5c, 0x0b, 0x81,
+	0x70, 0xdc, 0x75, 0xe0, 0x0b, 0x0f, 0x04, 0xc0, 0x49, 0x7c,
+	0xa5, 0x89, 0xd3, 0x4d, 0x1f, 0x43, 0xae, 0xba, 0x0c, 0x41,
+	0xa4, 0xc7, 0xa9, 0x8f, 0x33, 0xa6, 0x9a, 0x3f, 0xdf, 0x9a,
+	0x68, 0xfa, 0x1d, 0x75, 0xd0, 0x62, 0x0d, 0x26, 0x3d, 0x4c,
+	0x79, 0xa6, 0x8f, 0xbe, 0xd0, 0x01, 0x77, 0xfe, 0x8d, 0x48,
+	0xe6, 0x2b, 0x03, 0xee, 0x69, 0x7e, 0x8d, 0x48, 0xe6, 0x2b,
+	0x1e, 0x0b, 0x1d, 0x7f, 0x5f, 0x2c, 0x7c, 0xfd, 0xf6, 0x80,
+	0x0b, 0xbd, 0x0f, 0x01, 0x8d, 0x9b, 0xd9, 0xab, 0xfa, 0x52,
+	0x42, 0xcb, 0x40, 0xd2, 0x5f, 0xa5, 0x23, 0xb3, 0x0f, 0x2b,
+	0xce, 0xd0, 0x7f, 0x66, 0xa2, 0x81, 0xb0, 0xda, 0xe0, 0x53,
+	0xfa, 0xfc, 0x08, 0x7e, 0xd4, 0xce, 0x6a, 0xad, 0xf2, 0xa7,
+	0x97, 0x9c, 0x89, 0xc6, 0xbf, 0xb5, 0x21, 0xae, 0xba, 0x0b,
+	0xc8, 0xb1, 0xe6, 0x32, 0x58, 0x6d, 0x97, 0x57, 0x65, 0xc5,
+	0x3f, 0xac, 0xd8, 0xf7, 0xe8, 0xcf, 0xf4, 0xa5, 0x06, 0xea,
+	0x55, 0x31, 0x14, 0x9d, 0x4f, 0xfd, 0xa9, 0x7a, 0x7b, 0x0f,
+	0x49, 0x58, 0x08, 0x80, 0xb8, 0x17, 0x02, 0xe0, 0x53, 0x70,
+	0xe5, 0x1d, 0x86, 0x61, 0xb6, 0x5d, 0x5d, 0x97, 0x3f, 0x0f,
+	0x02, 0x8b, 0x2d, 0x4b, 0x62, 0xbb, 0xf4, 0x5a, 0xbe, 0xfb,
+	0x40, 0x05, 0xdf, 0x00, 0x87, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xff, 0xa2, 0xfe, 0x74, 0x9d, 0x31, 0x42, 0xa5, 0xdb,
+	0x07, 0x54, 0x9f, 0xcf, 0xdf, 0x78, 0x3f, 0x97, 0xbf, 0x9f,
+	0xa5, 0x3f, 0x9b, 0xd3, 0xd8, 0x7a, 0x4d, 0x6d, 0x3f, 0xcf,
+	0xdf, 0x78, 0x3f, 0x90, 0x88, 0x1f, 0xcf, 0x00, 0x8b, 0x41,
+	0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x49, 0xe3, 0x35, 0x05,
+	0x02, 0x3f, 0x30, 0x00, 0x8d, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xad, 0x5d, 0x03, 0x4c, 0xa7, 0xb2, 0x9f, 0x07, 0x22,
+	0x4c, 0x69, 0x6e, 0x75, 0x78, 0x22, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x59, 0x06, 0x49, 0x7f, 0x88, 0x40,
+	0xe9, 0x2a, 0xc7, 0xb0, 0xd3, 0x1a, 0xaf, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x93, 0xc8, 0x5f, 0x86,
+	0xa8, 0x7d, 0xcd, 0x30, 0xd2, 0x5f, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x42, 0xa1, 0x3f, 0x86, 0x90,
+	0xe4, 0xb6, 0x92, 0xd4, 0x9f, 0x00, 0x92, 0xb6, 0xb9, 0xac,
+	0x1c, 0x85, 0x58, 0xd5, 0x20, 0xa4, 0xb6, 0xc2, 0xad, 0x61,
+	0x7b, 0x5a, 0x54, 0x25, 0x1f, 0x01, 0x31, 0x0f, 0x24, 0x8f,
+	0x9d, 0x29, 0xad, 0x17, 0x18, 0x60, 0xbe, 0x47, 0x4d, 0x74,
+	0x15, 0x72, 0x1e, 0x96, 0x3f, 0x0f, 0x11, 0xf3, 0x8a, 0x61,
+	0xc1, 0x8a, 0x10, 0xae, 0x25, 0xc2, 0x26, 0x5a, 0x6d, 0xc7,
+	0x5e, 0x7c, 0x0b, 0x85, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x0f,
+	0xb5, 0x22, 0x98, 0xd2, 0x41, 0x8a, 0x10, 0xae, 0x25, 0xdf,
+	0x79, 0xd7, 0x1b, 0x69, 0x91, 0x05, 0x70, 0xba, 0x00, 0x00,
+	0x00, 0x00, 0x01, 0xf6, 0xa2, 0x0a, 0x84, 0x18, 0xf5, 0x40,
+	0x5f, 0x59, 0x42, 0x41, 0x71, 0xf5, 0x93, 0xa1, 0xcd, 0xcf,
+	0x97, 0x9a, 0xf9, 0x8b, 0x81, 0xb3, 0xde, 0xcb, 0x41, 0x71,
+	0xc2, 0x6d, 0x5d, 0x30, 0x33, 0xa2, 0xfc, 0x3e, 0x34, 0x5f,
+	0x87, 0xc6, 0x8b, 0xf7, 0x5f, 0x5c, 0x82, 0xa2, 0xa8, 0xe9,
+	0xc2, 0x09, 0x3f, 0x32, 0xd1, 0xf6, 0xa2, 0x67, 0x2d, 0x25,
+	0x82, 0x41, 0xd9, 0xd7, 0xed, 0x4a, 0x07, 0x54, 0xd0, 0x16,
+	0xa5, 0xb1, 0x5d,
+	0x82, 0x04, 0x8d, 0x62, 0x53, 0xd4, 0x94, 0x30, 0x6a, 0x92,
+	0x5b, 0x17, 0xf0, 0x79, 0x65, 0x17, 0x86, 0x01, 0x8a, 0x08,
+	0x9d, 0x5c, 0x0b, 0x81, 0x70, 0xdc, 0x75, 0xe0, 0x0b, 0x0f,
+	0x04, 0xc0, 0x49, 0x7c, 0xa5, 0x89, 0xd3, 0x4d, 0x1f, 0x43,
+	0xae, 0xba, 0x0c, 0x41, 0xa4, 0xc7, 0xa9, 0x8f, 0x33, 0xa6,
+	0x9a, 0x3f, 0xdf, 0x9a, 0x68, 0xfa, 0x1d, 0x75, 0xd0, 0x62,
+	0x0d, 0x26, 0x3d, 0x4c, 0x79, 0xa6, 0x8f, 0xbe, 0xd0, 0x01,
+	0x77, 0xfe, 0x8d, 0x48, 0xe6, 0x2b, 0x03, 0xee, 0x69, 0x7e,
+	0x8d, 0x48, 0xe6, 0x2b, 0x1e, 0x0b, 0x1d, 0x7f, 0x5f, 0x2c,
+	0x7c, 0xfd, 0xf6, 0x80, 0x0b, 0xbd, 0x0f, 0x01, 0x8d, 0x9b,
+	0xd9, 0xab, 0xfa, 0x52, 0x42, 0xcb, 0x40, 0xd2, 0x5f, 0xa5,
+	0x23, 0xb3, 0x0f, 0x2b, 0xce, 0xd0, 0x7f, 0x66, 0xa2, 0x81,
+	0xb0, 0xda, 0xe0, 0x53, 0xfa, 0xfc, 0x08, 0x7e, 0xd4, 0xce,
+	0x6a, 0xad, 0xf2, 0xa7, 0x97, 0x9c, 0x89, 0xc6, 0xbf, 0xb5,
+	0x21, 0xae, 0xba, 0x0b, 0xc8, 0xb1, 0xe6, 0x32, 0x58, 0x6d,
+	0x97, 0x57, 0x65, 0xc5, 0x3f, 0xac, 0xd8, 0xf7, 0xe8, 0xcf,
+	0xf4, 0xa5, 0x06, 0xea, 0x55, 0x31, 0x14, 0x9d, 0x4f, 0xfd,
+	0xa9, 0x7a, 0x7b, 0x0f, 0x49, 0x58, 0x08, 0x80, 0xb8, 0x17,
+	0x02, 0xe0, 0x53, 0x70, 0xe5, 0x1d, 0x86, 0x61, 0xb6, 0x5d,
+	0x5d, 0x97, 0x3f, 0x0f, 0x02, 0x8b, 0x2d, 0x4b, 0x62, 0xbb,
+	0xf4, 0x5a, 0xbe, 0xfb, 0x40, 0x05, 0xdf, 0x00, 0x87, 0x41,
+	0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xff, 0xa2, 0xfe, 0x74, 0x9d,
+	0x31, 0x42, 0xa5, 0xdb, 0x07, 0x54, 0x9f, 0xcf, 0xdf, 0x78,
+	0x3f, 0x97, 0xbf, 0x9f, 0xa5, 0x3f, 0x9b, 0xd3, 0xd8, 0x7a,
+	0x4d, 0x6d, 0x3f, 0xcf, 0xdf, 0x78, 0x3f, 0x90, 0x88, 0x1f,
+	0xcf, 0x00, 0x8b, 0x41, 0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad,
+	0x49, 0xe3, 0x35, 0x05, 0x02, 0x3f, 0x30, 0x00, 0x8d, 0x41,
+	0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x5d, 0x03, 0x4c, 0xa7,
+	0xb2, 0x9f, 0x07, 0x22, 0x4c, 0x69, 0x6e, 0x75, 0x78, 0x22,
+	0x00, 0x8a, 0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27, 0x59, 0x06,
+	0x49, 0x7f, 0x88, 0x40, 0xe9, 0x2a, 0xc7, 0xb0, 0xd3, 0x1a,
+	0xaf, 0x00, 0x8a, 0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a,
+	0x93, 0xc8, 0x5f, 0x86, 0xa8, 0x7d, 0xcd, 0x30, 0xd2, 0x5f,
+	0x00, 0x8a, 0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x42,
+	0xa1, 0x3f, 0x86, 0x90, 0xe4, 0xb6, 0x92, 0xd4, 0x9f, 0x00,
+	0x92, 0xb6, 0xb9, 0xac, 0x1c, 0x85, 0x58, 0xd5, 0x20, 0xa4,
+	0xb6, 0xc2, 0xad, 0x61, 0x7b, 0x5a, 0x54, 0x25, 0x1f, 0x01,
+	0x31, 0x0f, 0x24, 0x8f, 0x9d, 0x29, 0xad, 0x17, 0x18, 0x60,
+	0xbe, 0x47, 0x4d, 0x74, 0x15, 0x72, 0x1e, 0x96, 0x3f, 0x0f,
+	0x11, 0xf3, 0x8a, 0x61, 0xc1, 0x8a, 0x10, 0xae, 0x25, 0xc2,
+	0x26, 0x5a, 0x6d, 0xc7, 0x5e, 0x7c, 0x0b, 0x85, 0xd0, 0x00,
+	0x00, 0x00, 0x00, 0x0f, 0xb5, 0x22, 0x98, 0xd2, 0x41, 0x8a,
+	0x10, 0xae, 0x25, 0xdf, 0x79, 0xd7, 0x1b, 0x69, 0x91, 0x05,
+	0x70, 0xba, 0x00, 0x00, 0x00, 0x00, 0x01, 0xf6, 0xa2, 0x0a,
+	0x84, 0x18, 0xf5, 0x40, 0x5f, 0x59, 0x42, 0x41, 0x71, 0xf5,
+	0x93, 0xa1, 0xcd, 0xcf, 0x97, 0x9a, 0xf9, 0x8b, 0x81, 0xb3,
+	0xde, 0xcb, 0x41, 0x71, 0xc2, 0x6d, 0x5d, 0x30, 0x33, 0xa2,
+	0xfc, 0x3e, 0x34, 0x5f, 0x87, 0xc6, 0x8b, 0xf7, 0x5f, 0x5c,
+	0x82, 0xa2, 0xa8, 0xe9, 0xc2, 0x09, 0x3f, 0x32, 0xd1, 0xf6,
+	0xa2, 0x67, 0x2d, 0x25, 0x82, 0x41, 0xd9, 0xd7, 0xed, 0x4a,
+	0x07, 0x54, 0xd0, 0x16, 0xa5, 0xb1, 0x5d,
+	0x82, 0x04, 0x89, 0x60, 0x75, 0x99, 0x8e, 0xe1, 0x62, 0xd4,
+	0x16, 0xcf, 0x86, 0x01, 0x8a, 0x08, 0x9d, 0x5c, 0x0b, 0x81,
+	0x70, 0xdc, 0x75, 0xe0, 0x0b, 0x0f, 0x04, 0xc0, 0x49, 0x7c,
+	0xa5, 0x89, 0xd3, 0x4d, 0x1f, 0x43, 0xae, 0xba, 0x0c, 0x41,
+	0xa4, 0xc7, 0xa9, 0x8f, 0x33, 0xa6, 0x9a, 0x3f, 0xdf, 0x9a,
+	0x68, 0xfa, 0x1d, 0x75, 0xd0, 0x62, 0x0d, 0x26, 0x3d, 0x4c,
+	0x79, 0xa6, 0x8f, 0xbe, 0xd0, 0x01, 0x77, 0xfe, 0x8d, 0x48,
+	0xe6, 0x2b, 0x03, 0xee, 0x69, 0x7e, 0x8d, 0x48, 0xe6, 0x2b,
+	0x1e, 0x0b, 0x1d, 0x7f, 0x5f, 0x2c, 0x7c, 0xfd, 0xf6, 0x80,
+	0x0b, 0xbd, 0x0f, 0x01, 0x8d, 0x9b, 0xd9, 0xab, 0xfa, 0x52,
+	0x42, 0xcb, 0x40, 0xd2, 0x5f, 0xa5, 0x23, 0xb3, 0x0f, 0x2b,
+	0xce, 0xd0, 0x7f, 0x66, 0xa2, 0x81, 0xb0, 0xda, 0xe0, 0x53,
+	0xfa, 0xfc, 0x08, 0x7e, 0xd4, 0xce, 0x6a, 0xad, 0xf2, 0xa7,
+	0x97, 0x9c, 0x89, 0xc6, 0xbf, 0xb5, 0x21, 0xae, 0xba, 0x0b,
+	0xc8, 0xb1, 0xe6, 0x32, 0x58, 0x6d, 0x97, 0x57, 0x65, 0xc5,
+	0x3f, 0xac, 0xd8, 0xf7, 0xe8, 0xcf, 0xf4, 0xa5, 0x06, 0xea,
+	0x55, 0x31, 0x14, 0x9d, 0x4f, 0xfd, 0xa9, 0x7a, 0x7b, 0x0f,
+	0x49, 0x58, 0x08, 0x80, 0xb8, 0x17, 0x02, 0xe0, 0x53, 0x70,
+	0xe5, 0x1d, 0x86, 0x61, 0xb6, 0x5d, 0x5d, 0x97, 0x3f, 0x0f,
+	0x02, 0x8b, 0x2d, 0x4b, 0x62, 0xbb, 0xf4, 0x5a, 0xbe, 0xfb,
+	0x40, 0x05, 0xdf, 0x00, 0x87, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xff, 0xa2, 0xfe, 0x74, 0x9d, 0x31, 0x42, 0xa5, 0xdb,
+	0x07, 0x54, 0x9f, 0xcf, 0xdf, 0x78, 0x3f, 0x97, 0xbf, 0x9f,
+	0xa5, 0x3f, 0x9b, 0xd3, 0xd8, 0x7a, 0x4d, 0x6d, 0x3f, 0xcf,
+	0xdf, 0x78, 0x3f, 0x90, 0x88, 0x1f, 0xcf, 0x00, 0x8b, 0x41,
+	0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x49, 0xe3, 0x35, 0x05,
+	0x02, 0x3f, 0x30, 0x00, 0x8d, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xad, 0x5d, 0x03, 0x4c, 0xa7, 0xb2, 0x9f, 0x07, 0x22,
+	0x4c, 0x69, 0x6e, 0x75, 0x78, 0x22, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x59, 0x06, 0x49, 0x7f, 0x88, 0x40,
+	0xe9, 0x2a, 0xc7, 0xb0, 0xd3, 0x1a, 0xaf, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x93, 0xc8, 0x5f, 0x86,
+	0xa8, 0x7d, 0xcd, 0x30, 0xd2, 0x5f, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x42, 0xa1, 0x3f, 0x86, 0x90,
+	0xe4, 0xb6, 0x92, 0xd4, 0x9f, 0x00, 0x92, 0xb6, 0xb9, 0xac,
+	0x1c, 0x85, 0x58, 0xd5, 0x20, 0xa4, 0xb6, 0xc2, 0xad, 0x61,
+	0x7b, 0x5a, 0x54, 0x25, 0x1f, 0x01, 0x31, 0x0f, 0x24, 0x8f,
+	0x9d, 0x29, 0xad, 0x17, 0x18, 0x60, 0xbe, 0x47, 0x4d, 0x74,
+	0x15, 0x72, 0x1e, 0x96, 0x3f, 0x0f, 0x11, 0xf3, 0x8a, 0x61,
+	0xc1, 0x8a, 0x10, 0xae, 0x25, 0xc2, 0x26, 0x5a, 0x6d, 0xc7,
+	0x5e, 0x7c, 0x0b, 0x85, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x0f,
+	0xb5, 0x22, 0x98, 0xd2, 0x41, 0x8a, 0x10, 0xae, 0x25, 0xdf,
+	0x79, 0xd7, 0x1b, 0x69, 0x91, 0x05, 0x70, 0xba, 0x00, 0x00,
+	0x00, 0x00, 0x01, 0xf6, 0xa2, 0x0a, 0x84, 0x18, 0xf5, 0x40,
+	0x5f, 0x59, 0x42, 0x41, 0x71, 0xf5, 0x93, 0xa1, 0xcd, 0xcf,
+	0x97, 0x9a, 0xf9, 0x8b, 0x81, 0xb3, 0xde, 0xcb, 0x41, 0x71,
+	0xc2, 0x6d, 0x5d, 0x30, 0x33, 0xa2, 0xfc, 0x3e, 0x34, 0x5f,
+	0x87, 0xc6, 0x8b, 0xf7, 0x5f, 0x5c, 0x82, 0xa2, 0xa8, 0xe9,
+	0xc2, 0x09, 0x3f, 0x32, 0xd1, 0xf6, 0xa2, 0x67, 0x2d, 0x25,
+	0x82, 0x41, 0xd9, 0xd7, 0xed, 0x4a, 0x07, 0x54, 0xd0, 0x16,
+	0xa5, 0xb1, 0x5d,
+	0x82, 0x04, 0x8e, 0x60, 0x75, 0x99, 0x8e, 0xe1, 0x62, 0x52,
+	0x96, 0x4f, 0xf2, 0xb1, 0xcc, 0x58, 0x03, 0x86, 0x01, 0x8a,
+	0x08, 0x9d, 0x5c, 0x0b, 0x81, 0x70, 0xdc, 0x75, 0xe0, 0x0b,
+	0x0f, 0x04, 0xc0, 0x49, 0x7c, 0xa5, 0x89, 0xd3, 0x4d, 0x1f,
+	0x43, 0xae, 0xba, 0x0c, 0x41, 0xa4, 0xc7, 0xa9, 0x8f, 0x33,
+	0xa6, 0x9a, 0x3f, 0xdf, 0x9a, 0x68, 0xfa, 0x1d, 0x75, 0xd0,
+	0x62, 0x0d, 0x26, 0x3d, 0x4c, 0x79, 0xa6, 0x8f, 0xbe, 0xd0,
+	0x01, 0x77, 0xfe, 0x8d, 0x48, 0xe6, 0x2b, 0x03, 0xee, 0x69,
+	0x7e, 0x8d, 0x48, 0xe6, 0x2b, 0x1e, 0x0b, 0x1d, 0x7f, 0x5f,
+	0x2c, 0x7c, 0xfd, 0xf6, 0x80, 0x0b, 0xbd, 0x0f, 0x01, 0x8d,
+	0x9b, 0xd9, 0xab, 0xfa, 0x52, 0x42, 0xcb, 0x40, 0xd2, 0x5f,
+	0xa5, 0x23, 0xb3, 0x0f, 0x2b, 0xce, 0xd0, 0x7f, 0x66, 0xa2,
+	0x81, 0xb0, 0xda, 0xe0, 0x53, 0xfa, 0xfc, 0x08, 0x7e, 0xd4,
+	0xce, 0x6a, 0xad, 0xf2, 0xa7, 0x97, 0x9c, 0x89, 0xc6, 0xbf,
+	0xb5, 0x21, 0xae, 0xba, 0x0b, 0xc8, 0xb1, 0xe6, 0x32, 0x58,
+	0x6d, 0x97, 0x57, 0x65, 0xc5, 0x3f, 0xac, 0xd8, 0xf7, 0xe8,
+	0xcf, 0xf4, 0xa5, 0x06, 0xea, 0x55, 0x31, 0x14, 0x9d, 0x4f,
+	0xfd, 0xa9, 0x7a, 0x7b, 0x0f, 0x49, 0x58, 0x08, 0x80, 0xb8,
+	0x17, 0x02, 0xe0, 0x53, 0x70, 0xe5, 0x1d, 0x86, 0x61, 0xb6,
+	0x5d, 0x5d, 0x97, 0x3f, 0x0f, 0x02, 0x8b, 0x2d, 0x4b, 0x62,
+	0xbb, 0xf4, 0x5a, 0xbe, 0xfb, 0x40, 0x05, 0xdf, 0x00, 0x87,
+	0x41, 0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xff, 0xa2, 0xfe, 0x74,
+	0x9d, 0x31, 0x42, 0xa5, 0xdb, 0x07, 0x54, 0x9f, 0xcf, 0xdf,
+	0x78, 0x3f, 0x97, 0xbf, 0x9f, 0xa5, 0x3f, 0x9b, 0xd3, 0xd8,
+	0x7a, 0x4d, 0x6d, 0x3f, 0xcf, 0xdf, 0x78, 0x3f, 0x90, 0x88,
+	0x1f, 0xcf, 0x00, 0x8b, 0x41, 0x48, 0xb1, 0x27, 0x5a, 0xd1,
+	0xad, 0x49, 0xe3, 0x35, 0x05, 0x02, 0x3f, 0x30, 0x00, 0x8d,
+	0x41, 0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x5d, 0x03, 0x4c,
+	0xa7, 0xb2, 0x9f, 0x07, 0x22, 0x4c, 0x69, 0x6e, 0x75, 0x78,
+	0x22, 0x00, 0x8a, 0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27, 0x59,
+	0x06, 0x49, 0x7f, 0x88, 0x40, 0xe9, 0x2a, 0xc7, 0xb0, 0xd3,
+	0x1a, 0xaf, 0x00, 0x8a, 0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27,
+	0x5a, 0x93, 0xc8, 0x5f, 0x86, 0xa8, 0x7d, 0xcd, 0x30, 0xd2,
+	0x5f, 0x00, 0x8a, 0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a,
+	0x42, 0xa1, 0x3f, 0x86, 0x90, 0xe4, 0xb6, 0x92, 0xd4, 0x9f,
+	0x00, 0x92, 0xb6, 0xb9, 0xac, 0x1c, 0x85, 0x58, 0xd5, 0x20,
+	0xa4, 0xb6, 0xc2, 0xad, 0x61, 0x7b, 0x5a, 0x54, 0x25, 0x1f,
+	0x01, 0x31, 0x0f, 0x24, 0x8f, 0x9d, 0x29, 0xad, 0x17, 0x18,
+	0x60, 0xbe, 0x47, 0x4d, 0x74, 0x15, 0x72, 0x1e, 0x96, 0x3f,
+	0x0f, 0x11, 0xf3, 0x8a, 0x61, 0xc1, 0x8a, 0x10, 0xae, 0x25,
+	0xc2, 0x26, 0x5a, 0x6d, 0xc7, 0x5e, 0x7c, 0x0b, 0x85, 0xd0,
+	0x00, 0x00, 0x00, 0x00, 0x0f, 0xb5, 0x22, 0x98, 0xd2, 0x41,
+	0x8a, 0x10, 0xae, 0x25, 0xdf, 0x79, 0xd7, 0x1b, 0x69, 0x91,
+	0x05, 0x70, 0xba, 0x00, 0x00, 0x00, 0x00, 0x01, 0xf6, 0xa2,
+	0x0a, 0x84, 0x18, 0xf5, 0x40, 0x5f, 0x59, 0x42, 0x41, 0x71,
+	0xf5, 0x93, 0xa1, 0xcd, 0xcf, 0x97, 0x9a, 0xf9, 0x8b, 0x81,
+	0xb3, 0xde, 0xcb, 0x41, 0x71, 0xc2, 0x6d, 0x5d, 0x30, 0x33,
+	0xa2, 0xfc, 0x3e, 0x34, 0x5f, 0x87, 0xc6, 0x8b, 0xf7, 0x5f,
+	0x5c, 0x82, 0xa2, 0xa8, 0xe9, 0xc2, 0x09, 0x3f, 0x32, 0xd1,
+	0xf6, 0xa2, 0x67, 0x2d, 0x25, 0x82, 0x41, 0xd9, 0xd7, 0xed,
+	0x4a, 0x07, 0x54, 0xd0, 0x16, 0xa5, 0xb1, 0x5d,
+	0x82, 0x04, 0x8e, 0x60, 0x75, 0x99, 0x8e, 0xe1, 0x62, 0x52,
+	0x96, 0x4f, 0xf2, 0xb1, 0xcc, 0x58, 0x05, 0x86, 0x01, 0x8a,
+	0x08, 0x9d, 0x5c, 0x0b, 0x81, 0x70, 0xdc, 0x75, 0xe0, 0x0b,
+	0x0f, 0x04, 0xc0, 0x49, 0x7c, 0xa5, 0x89, 0xd3, 0x4d, 0x1f,
+	0x43, 0xae, 0xba, 0x0c, 0x41, 0xa4, 0xc7, 0xa9, 0x8f, 0x33,
+	0xa6, 0x9a, 0x3f, 0xdf, 0x9a, 0x68, 0xfa, 0x1d, 0x75, 0xd0,
+	0x62, 0x0d, 0x26, 0x3d, 0x4c, 0x79, 0xa6, 0x8f, 0xbe, 0xd0,
+	0x01, 0x77, 0xfe, 0x8d, 0x48, 0xe6, 0x2b, 0x03, 0xee, 0x69,
+	0x7e, 0x8d, 0x48, 0xe6, 0x2b, 0x1e, 0x0b, 0x1d, 0x7f, 0x5f,
+	0x2c, 0x7c, 0xfd, 0xf6, 0x80, 0x0b, 0xbd, 0x0f, 0x01, 0x8d,
+	0x9b, 0xd9, 0xab, 0xfa, 0x52, 0x42, 0xcb, 0x40, 0xd2, 0x5f,
+	0xa5, 0x23, 0xb3, 0x0f, 0x2b, 0xce, 0xd0, 0x7f, 0x66, 0xa2,
+	0x81, 0xb0, 0xda, 0xe0, 0x53, 0xfa, 0xfc, 0x08, 0x7e, 0xd4,
+	0xce, 0x6a, 0xad, 0xf2, 0xa7, 0x97, 0x9c, 0x89, 0xc6, 0xbf,
+	0xb5, 0x21, 0xae, 0xba, 0x0b, 0xc8, 0xb1, 0xe6, 0x32, 0x58,
+	0x6d, 0x97, 0x57, 0x65, 0xc5, 0x3f, 0xac, 0xd8, 0xf7, 0xe8,
+	0xcf, 0xf4, 0xa5, 0x06, 0xea, 0x55, 0x31, 0x14, 0x9d, 0x4f,
+	0xfd, 0xa9, 0x7a, 0x7b, 0x0f, 0x49, 0x58, 0x08, 0x80, 0xb8,
+	0x17, 0x02, 0xe0, 0x53, 0x70, 0xe5, 0x1d, 0x86, 0x61, 0xb6,
+	0x5d, 0x5d, 0x97, 0x3f, 0x0f, 0x02, 0x8b, 0x2d, 0x4b, 0x62,
+	0xbb, 0xf4, 0x5a, 0xbe, 0xfb, 0x40, 0x05, 0xdf, 0x00, 0x87,
+	0x41, 0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xff, 0xa2, 0xfe, 0x74,
+	0x9d, 0x31, 0x42, 0xa5, 0xdb, 0x07, 0x54, 0x9f, 0xcf, 0xdf,
+	0x78, 0x3f, 0x97, 0xbf, 0x9f, 0xa5, 0x3f, 0x9b, 0xd3, 0xd8,
+	0x7a, 0x4d, 0x6d, 0x3f, 0xcf, 0xdf, 0x78, 0x3f, 0x90, 0x88,
+	0x1f, 0xcf, 0x00, 0x8b, 0x41, 0x48, 0xb1, 0x27, 0x5a, 0xd1,
+	0xad, 0x49, 0xe3, 0x35, 0x05, 0x02, 0x3f, 0x30, 0x00, 0x8d,
+	0x41, 0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x5d, 0x03, 0x4c,
+	0xa7, 0xb2, 0x9f, 0x07, 0x22, 0x4c, 0x69, 0x6e, 0x75, 0x78,
+	0x22, 0x00, 0x8a, 0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27, 0x59,
+	0x06, 0x49, 0x7f, 0x88, 0x40, 0xe9, 0x2a, 0xc7, 0xb0, 0xd3,
+	0x1a, 0xaf, 0x00, 0x8a, 0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27,
+	0x5a, 0x93, 0xc8, 0x5f, 0x86, 0xa8, 0x7d, 0xcd, 0x30, 0xd2,
+	0x5f, 0x00, 0x8a, 0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a,
+	0x42, 0xa1, 0x3f, 0x86, 0x90, 0xe4, 0xb6, 0x92, 0xd4, 0x9f,
+	0x00, 0x92, 0xb6, 0xb9, 0xac, 0x1c, 0x85, 0x58, 0xd5, 0x20,
+	0xa4, 0xb6, 0xc2, 0xad, 0x61, 0x7b, 0x5a, 0x54, 0x25, 0x1f,
+	0x01, 0x31, 0x0f, 0x24, 0x8f, 0x9d, 0x29, 0xad, 0x17, 0x18,
+	0x60, 0xbe, 0x47, 0x4d, 0x74, 0x15, 0x72, 0x1e, 0x96, 0x3f,
+	0x0f, 0x11, 0xf3, 0x8a, 0x61, 0xc1, 0x8a, 0x10, 0xae, 0x25,
+	0xc2, 0x26, 0x5a, 0x6d, 0xc7, 0x5e, 0x7c, 0x0b, 0x85, 0xd0,
+	0x00, 0x00, 0x00, 0x00, 0x0f, 0xb5, 0x22, 0x98, 0xd2, 0x41,
+	0x8a, 0x10, 0xae, 0x25, 0xdf, 0x79, 0xd7, 0x1b, 0x69, 0x91,
+	0x05, 0x70, 0xba, 0x00, 0x00, 0x00, 0x00, 0x01, 0xf6, 0xa2,
+	0x0a, 0x84, 0x18, 0xf5, 0x40, 0x5f, 0x59, 0x42, 0x41, 0x71,
+	0xf5, 0x93, 0xa1, 0xcd, 0xcf, 0x97, 0x9a, 0xf9, 0x8b, 0x81,
+	0xb3, 0xde, 0xcb, 0x41, 0x71, 0xc2, 0x6d, 0x5d, 0x30, 0x33,
+	0xa2, 0xfc, 0x3e, 0x34, 0x5f, 0x87, 0xc6, 0x8b, 0xf7, 0x5f,
+	0x5c, 0x82, 0xa2, 0xa8, 0xe9, 0xc2, 0x09, 0x3f, 0x32, 0xd1,
+	0xf6, 0xa2, 0x67, 0x2d, 0x25, 0x82, 0x41, 0xd9, 0xd7, 0xed,
+	0x4a, 0x07, 0x54, 0xd0, 0x16, 0xa5, 0xb1, 0x5d,
+	0x82, 0x04, 0x89, 0x62, 0x51, 0xf7, 0x31, 0x0f, 0x52, 0xe6,
+	0x21, 0xff, 0x86, 0x01, 0x8a, 0x08, 0x9d, 0x5c, 0x0b, 0x81,
+	0x70, 0xdc, 0x75, 0xe0, 0x0b, 0x0f, 0x04, 0xc0, 0x49, 0x7c,
+	0xa5, 0x89, 0xd3, 0x4d, 0x1f, 0x43, 0xae, 0xba, 0x0c, 0x41,
+	0xa4, 0xc7, 0xa9, 0x8f, 0x33, 0xa6, 0x9a, 0x3f, 0xdf, 0x9a,
+	0x68, 0xfa, 0x1d, 0x75, 0xd0, 0x62, 0x0d, 0x26, 0x3d, 0x4c,
+	0x79, 0xa6, 0x8f, 0xbe, 0xd0, 0x01, 0x77, 0xfe, 0x8d, 0x48,
+	0xe6, 0x2b, 0x03, 0xee, 0x69, 0x7e, 0x8d, 0x48, 0xe6, 0x2b,
+	0x1e, 0x0b, 0x1d, 0x7f, 0x5f, 0x2c, 0x7c, 0xfd, 0xf6, 0x80,
+	0x0b, 0xbd, 0x0f, 0x01, 0x8d, 0x9b, 0xd9, 0xab, 0xfa, 0x52,
+	0x42, 0xcb, 0x40, 0xd2, 0x5f, 0xa5, 0x23, 0xb3, 0x0f, 0x2b,
+	0xce, 0xd0, 0x7f, 0x66, 0xa2, 0x81, 0xb0, 0xda, 0xe0, 0x53,
+	0xfa, 0xfc, 0x08, 0x7e, 0xd4, 0xce, 0x6a, 0xad, 0xf2, 0xa7,
+	0x97, 0x9c, 0x89, 0xc6, 0xbf, 0xb5, 0x21, 0xae, 0xba, 0x0b,
+	0xc8, 0xb1, 0xe6, 0x32, 0x58, 0x6d, 0x97, 0x57, 0x65, 0xc5,
+	0x3f, 0xac, 0xd8, 0xf7, 0xe8, 0xcf, 0xf4, 0xa5, 0x06, 0xea,
+	0x55, 0x31, 0x14, 0x9d, 0x4f, 0xfd, 0xa9, 0x7a, 0x7b, 0x0f,
+	0x49, 0x58, 0x08, 0x80, 0xb8, 0x17, 0x02, 0xe0, 0x53, 0x70,
+	0xe5, 0x1d, 0x86, 0x61, 0xb6, 0x5d, 0x5d, 0x97, 0x3f, 0x0f,
+	0x02, 0x8b, 0x2d, 0x4b, 0x62, 0xbb, 0xf4, 0x5a, 0xbe, 0xfb,
+	0x40, 0x05, 0xdf, 0x00, 0x87, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xff, 0xa2, 0xfe, 0x74, 0x9d, 0x31, 0x42, 0xa5, 0xdb,
+	0x07, 0x54, 0x9f, 0xcf, 0xdf, 0x78, 0x3f, 0x97, 0xbf, 0x9f,
+	0xa5, 0x3f, 0x9b, 0xd3, 0xd8, 0x7a, 0x4d, 0x6d, 0x3f, 0xcf,
+	0xdf, 0x78, 0x3f, 0x90, 0x88, 0x1f, 0xcf, 0x00, 0x8b, 0x41,
+	0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x49, 0xe3, 0x35, 0x05,
+	0x02, 0x3f, 0x30, 0x00, 0x8d, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xad, 0x5d, 0x03, 0x4c, 0xa7, 0xb2, 0x9f, 0x07, 0x22,
+	0x4c, 0x69, 0x6e, 0x75, 0x78, 0x22, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x59, 0x06, 0x49, 0x7f, 0x88, 0x40,
+	0xe9, 0x2a, 0xc7, 0xb0, 0xd3, 0x1a, 0xaf, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x93, 0xc8, 0x5f, 0x86,
+	0xa8, 0x7d, 0xcd, 0x30, 0xd2, 0x5f, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x42, 0xa1, 0x3f, 0x86, 0x90,
+	0xe4, 0xb6, 0x92, 0xd4, 0x9f, 0x00, 0x92, 0xb6, 0xb9, 0xac,
+	0x1c, 0x85, 0x58, 0xd5, 0x20, 0xa4, 0xb6, 0xc2, 0xad, 0x61,
+	0x7b, 0x5a, 0x54, 0x25, 0x1f, 0x01, 0x31, 0x0f, 0x24, 0x8f,
+	0x9d, 0x29, 0xad, 0x17, 0x18, 0x60, 0xbe, 0x47, 0x4d, 0x74,
+	0x15, 0x72, 0x1e, 0x96, 0x3f, 0x0f, 0x11, 0xf3, 0x8a, 0x61,
+	0xc1, 0x8a, 0x10, 0xae, 0x25, 0xc2, 0x26, 0x5a, 0x6d, 0xc7,
+	0x5e, 0x7c, 0x0b, 0x85, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x0f,
+	0xb5, 0x22, 0x98, 0xd2, 0x41, 0x8a, 0x10, 0xae, 0x25, 0xdf,
+	0x79, 0xd7, 0x1b, 0x69, 0x91, 0x05, 0x70, 0xba, 0x00, 0x00,
+	0x00, 0x00, 0x01, 0xf6, 0xa2, 0x0a, 0x84, 0x18, 0xf5, 0x40,
+	0x5f, 0x59, 0x42, 0x41, 0x71, 0xf5, 0x93, 0xa1, 0xcd, 0xcf,
+	0x97, 0x9a, 0xf9, 0x8b, 0x81, 0xb3, 0xde, 0xcb, 0x41, 0x71,
+	0xc2, 0x6d, 0x5d, 0x30, 0x33, 0xa2, 0xfc, 0x3e, 0x34, 0x5f,
+	0x87, 0xc6, 0x8b, 0xf7, 0x5f, 0x5c, 0x82, 0xa2, 0xa8, 0xe9,
+	0xc2, 0x09, 0x3f, 0x32, 0xd1, 0xf6, 0xa2, 0x67, 0x2d, 0x25,
+	0x82, 0x41, 0xd9, 0xd7, 0xed, 0x4a, 0x07, 0x54, 0xd0, 0x16,
+	0xa5, 0xb1, 0x5d,
+	0x82, 0x04, 0x89, 0x60, 0xd4, 0xcc, 0xc0, 0xc2, 0xbf, 0x82,
+	0xc7, 0x5f, 0x86, 0x01, 0x8a, 0x08, 0x9d, 0x5c, 0x0b, 0x81,
+	0x70, 0xdc, 0x75, 0xe0, 0x0b, 0x0f, 0x04, 0xc0, 0x49, 0x7c,
+	0xa5, 0x89, 0xd3, 0x4d, 0x1f, 0x43, 0xae, 0xba, 0x0c, 0x41,
+	0xa4, 0xc7, 0xa9, 0x8f, 0x33, 0xa6, 0x9a, 0x3f, 0xdf, 0x9a,
+	0x68, 0xfa, 0x1d, 0x75, 0xd0, 0x62, 0x0d, 0x26, 0x3d, 0x4c,
+	0x79, 0xa6, 0x8f, 0xbe, 0xd0, 0x01, 0x77, 0xfe, 0x8d, 0x48,
+	0xe6, 0x2b, 0x03, 0xee, 0x69, 0x7e, 0x8d, 0x48, 0xe6, 0x2b,
+	0x1e, 0x0b, 0x1d, 0x7f, 0x5f, 0x2c, 0x7c, 0xfd, 0xf6, 0x80,
+	0x0b, 0xbd, 0x0f, 0x01, 0x8d, 0x9b, 0xd9, 0xab, 0xfa, 0x52,
+	0x42, 0xcb, 0x40, 0xd2, 0x5f, 0xa5, 0x23, 0xb3, 0x0f, 0x2b,
+	0xce, 0xd0, 0x7f, 0x66, 0xa2, 0x81, 0xb0, 0xda, 0xe0, 0x53,
+	0xfa, 0xfc, 0x08, 0x7e, 0xd4, 0xce, 0x6a, 0xad, 0xf2, 0xa7,
+	0x97, 0x9c, 0x89, 0xc6, 0xbf, 0xb5, 0x21, 0xae, 0xba, 0x0b,
+	0xc8, 0xb1, 0xe6, 0x32, 0x58, 0x6d, 0x97, 0x57, 0x65, 0xc5,
+	0x3f, 0xac, 0xd8, 0xf7, 0xe8, 0xcf, 0xf4, 0xa5, 0x06, 0xea,
+	0x55, 0x31, 0x14, 0x9d, 0x4f, 0xfd, 0xa9, 0x7a, 0x7b, 0x0f,
+	0x49, 0x58, 0x08, 0x80, 0xb8, 0x17, 0x02, 0xe0, 0x53, 0x70,
+	0xe5, 0x1d, 0x86, 0x61, 0xb6, 0x5d, 0x5d, 0x97, 0x3f, 0x0f,
+	0x02, 0x8b, 0x2d, 0x4b, 0x62, 0xbb, 0xf4, 0x5a, 0xbe, 0xfb,
+	0x40, 0x05, 0xdf, 0x00, 0x87, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xff, 0xa2, 0xfe, 0x74, 0x9d, 0x31, 0x42, 0xa5, 0xdb,
+	0x07, 0x54, 0x9f, 0xcf, 0xdf, 0x78, 0x3f, 0x97, 0xbf, 0x9f,
+	0xa5, 0x3f, 0x9b, 0xd3, 0xd8, 0x7a, 0x4d, 0x6d, 0x3f, 0xcf,
+	0xdf, 0x78, 0x3f, 0x90, 0x88, 0x1f, 0xcf, 0x00, 0x8b, 0x41,
+	0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x49, 0xe3, 0x35, 0x05,
+	0x02, 0x3f, 0x30, 0x00, 0x8d, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xad, 0x5d, 0x03, 0x4c, 0xa7, 0xb2, 0x9f, 0x07, 0x22,
+	0x4c, 0x69, 0x6e, 0x75, 0x78, 0x22, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x59, 0x06, 0x49, 0x7f, 0x88, 0x40,
+	0xe9, 0x2a, 0xc7, 0xb0, 0xd3, 0x1a, 0xaf, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x93, 0xc8, 0x5f, 0x86,
+	0xa8, 0x7d, 0xcd, 0x30, 0xd2, 0x5f, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x42, 0xa1, 0x3f, 0x86, 0x90,
+	0xe4, 0xb6, 0x92, 0xd4, 0x9f, 0x00, 0x92, 0xb6, 0xb9, 0xac,
+	0x1c, 0x85, 0x58, 0xd5, 0x20, 0xa4, 0xb6, 0xc2, 0xad, 0x61,
+	0x7b, 0x5a, 0x54, 0x25, 0x1f, 0x01, 0x31, 0x0f, 0x24, 0x8f,
+	0x9d, 0x29, 0xad, 0x17, 0x18, 0x60, 0xbe, 0x47, 0x4d, 0x74,
+	0x15, 0x72, 0x1e, 0x96, 0x3f, 0x0f, 0x11, 0xf3, 0x8a, 0x61,
+	0xc1, 0x8a, 0x10, 0xae, 0x25, 0xc2, 0x26, 0x5a, 0x6d, 0xc7,
+	0x5e, 0x7c, 0x0b, 0x85, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x0f,
+	0xb5, 0x22, 0x98, 0xd2, 0x41, 0x8a, 0x10, 0xae, 0x25, 0xdf,
+	0x79, 0xd7, 0x1b, 0x69, 0x91, 0x05, 0x70, 0xba, 0x00, 0x00,
+	0x00, 0x00, 0x01, 0xf6, 0xa2, 0x0a, 0x84, 0x18, 0xf5, 0x40,
+	0x5f, 0x59, 0x42, 0x41, 0x71, 0xf5, 0x93, 0xa1, 0xcd, 0xcf,
+	0x97, 0x9a, 0xf9, 0x8b, 0x81, 0xb3, 0xde, 0xcb, 0x41, 0x71,
+	0xc2, 0x6d, 0x5d, 0x30, 0x33, 0xa2, 0xfc, 0x3e, 0x34, 0x5f,
+	0x87, 0xc6, 0x8b, 0xf7, 0x5f, 0x5c, 0x82, 0xa2, 0xa8, 0xe9,
+	0xc2, 0x09, 0x3f, 0x32, 0xd1, 0xf6, 0xa2, 0x67, 0x2d, 0x25,
+	0x82, 0x41, 0xd9, 0xd7, 0xed, 0x4a, 0x07, 0x54, 0xd0, 0x16,
+	0xa5, 0xb1, 0x5d,
+	0x82, 0x04, 0x89, 0x60, 0xd4, 0xcc, 0xc0, 0xc4, 0xbf, 0x82,
+	0xc7, 0x5f, 0x86, 0x01, 0x8a, 0x08, 0x9d, 0x5c, 0x0b, 0x81,
+	0x70, 0xdc, 0x75, 0xe0, 0x0b, 0x0f, 0x04, 0xc0, 0x49, 0x7c,
+	0xa5, 0x89, 0xd3, 0x4d, 0x1f, 0x43, 0xae, 0xba, 0x0c, 0x41,
+	0xa4, 0xc7, 0xa9, 0x8f, 0x33, 0xa6, 0x9a, 0x3f, 0xdf, 0x9a,
+	0x68, 0xfa, 0x1d, 0x75, 0xd0, 0x62, 0x0d, 0x26, 0x3d, 0x4c,
+	0x79, 0xa6, 0x8f, 0xbe, 0xd0, 0x01, 0x77, 0xfe, 0x8d, 0x48,
+	0xe6, 0x2b, 0x03, 0xee, 0x69, 0x7e, 0x8d, 0x48, 0xe6, 0x2b,
+	0x1e, 0x0b, 0x1d, 0x7f, 0x5f, 0x2c, 0x7c, 0xfd, 0xf6, 0x80,
+	0x0b, 0xbd, 0x0f, 0x01, 0x8d, 0x9b, 0xd9, 0xab, 0xfa, 0x52,
+	0x42, 0xcb, 0x40, 0xd2, 0x5f, 0xa5, 0x23, 0xb3, 0x0f, 0x2b,
+	0xce, 0xd0, 0x7f, 0x66, 0xa2, 0x81, 0xb0, 0xda, 0xe0, 0x53,
+	0xfa, 0xfc, 0x08, 0x7e, 0xd4, 0xce, 0x6a, 0xad, 0xf2, 0xa7,
+	0x97, 0x9c, 0x89, 0xc6, 0xbf, 0xb5, 0x21, 0xae, 0xba, 0x0b,
+	0xc8, 0xb1, 0xe6, 0x32, 0x58, 0x6d, 0x97, 0x57, 0x65, 0xc5,
+	0x3f, 0xac, 0xd8, 0xf7, 0xe8, 0xcf, 0xf4, 0xa5, 0x06, 0xea,
+	0x55, 0x31, 0x14, 0x9d, 0x4f, 0xfd, 0xa9, 0x7a, 0x7b, 0x0f,
+	0x49, 0x58, 0x08, 0x80, 0xb8, 0x17, 0x02, 0xe0, 0x53, 0x70,
+	0xe5, 0x1d, 0x86, 0x61, 0xb6, 0x5d, 0x5d, 0x97, 0x3f, 0x0f,
+	0x02, 0x8b, 0x2d, 0x4b, 0x62, 0xbb, 0xf4, 0x5a, 0xbe, 0xfb,
+	0x40, 0x05, 0xdf, 0x00, 0x87, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xff, 0xa2, 0xfe, 0x74, 0x9d, 0x31, 0x42, 0xa5, 0xdb,
+	0x07, 0x54, 0x9f, 0xcf, 0xdf, 0x78, 0x3f, 0x97, 0xbf, 0x9f,
+	0xa5, 0x3f, 0x9b, 0xd3, 0xd8, 0x7a, 0x4d, 0x6d, 0x3f, 0xcf,
+	0xdf, 0x78, 0x3f, 0x90, 0x88, 0x1f, 0xcf, 0x00, 0x8b, 0x41,
+	0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x49, 0xe3, 0x35, 0x05,
+	0x02, 0x3f, 0x30, 0x00, 0x8d, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xad, 0x5d, 0x03, 0x4c, 0xa7, 0xb2, 0x9f, 0x07, 0x22,
+	0x4c, 0x69, 0x6e, 0x75, 0x78, 0x22, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x59, 0x06, 0x49, 0x7f, 0x88, 0x40,
+	0xe9, 0x2a, 0xc7, 0xb0, 0xd3, 0x1a, 0xaf, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x93, 0xc8, 0x5f, 0x86,
+	0xa8, 0x7d, 0xcd, 0x30, 0xd2, 0x5f, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x42, 0xa1, 0x3f, 0x86, 0x90,
+	0xe4, 0xb6, 0x92, 0xd4, 0x9f, 0x00, 0x92, 0xb6, 0xb9, 0xac,
+	0x1c, 0x85, 0x58, 0xd5, 0x20, 0xa4, 0xb6, 0xc2, 0xad, 0x61,
+	0x7b, 0x5a, 0x54, 0x25, 0x1f, 0x01, 0x31, 0x0f, 0x24, 0x8f,
+	0x9d, 0x29, 0xad, 0x17, 0x18, 0x60, 0xbe, 0x47, 0x4d, 0x74,
+	0x15, 0x72, 0x1e, 0x96, 0x3f, 0x0f, 0x11, 0xf3, 0x8a, 0x61,
+	0xc1, 0x8a, 0x10, 0xae, 0x25, 0xc2, 0x26, 0x5a, 0x6d, 0xc7,
+	0x5e, 0x7c, 0x0b, 0x85, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x0f,
+	0xb5, 0x22, 0x98, 0xd2, 0x41, 0x8a, 0x10, 0xae, 0x25, 0xdf,
+	0x79, 0xd7, 0x1b, 0x69, 0x91, 0x05, 0x70, 0xba, 0x00, 0x00,
+	0x00, 0x00, 0x01, 0xf6, 0xa2, 0x0a, 0x84, 0x18, 0xf5, 0x40,
+	0x5f, 0x59, 0x42, 0x41, 0x71, 0xf5, 0x93, 0xa1, 0xcd, 0xcf,
+	0x97, 0x9a, 0xf9, 0x8b, 0x81, 0xb3, 0xde, 0xcb, 0x41, 0x71,
+	0xc2, 0x6d, 0x5d, 0x30, 0x33, 0xa2, 0xfc, 0x3e, 0x34, 0x5f,
+	0x87, 0xc6, 0x8b, 0xf7, 0x5f, 0x5c, 0x82, 0xa2, 0xa8, 0xe9,
+	0xc2, 0x09, 0x3f, 0x32, 0xd1, 0xf6, 0xa2, 0x67, 0x2d, 0x25,
+	0x82, 0x41, 0xd9, 0xd7, 0xed, 0x4a, 0x07, 0x54, 0xd0, 0x16,
+	0xa5, 0xb1, 0x5d,
+	0x82, 0x04, 0x89, 0x60, 0xd4, 0xcc, 0xc0, 0xd9, 0x5f, 0xc1,
+	0x63, 0xaf, 0x86, 0x01, 0x8a, 0x08, 0x9d, 0x5c, 0x0b, 0x81,
+	0x70, 0xdc, 0x75, 0xe0, 0x0b, 0x0f, 0x04, 0xc0, 0x49, 0x7c,
+	0xa5, 0x89, 0xd3, 0x4d, 0x1f, 0x43, 0xae, 0xba, 0x0c, 0x41,
+	0xa4, 0xc7, 0xa9, 0x8f, 0x33, 0xa6, 0x9a, 0x3f, 0xdf, 0x9a,
+	0x68, 0xfa, 0x1d, 0x75, 0xd0, 0x62, 0x0d, 0x26, 0x3d, 0x4c,
+	0x79, 0xa6, 0x8f, 0xbe, 0xd0, 0x01, 0x77, 0xfe, 0x8d, 0x48,
+	0xe6, 0x2b, 0x03, 0xee, 0x69, 0x7e, 0x8d, 0x48, 0xe6, 0x2b,
+	0x1e, 0x0b, 0x1d, 0x7f, 0x5f, 0x2c, 0x7c, 0xfd, 0xf6, 0x80,
+	0x0b, 0xbd, 0x0f, 0x01, 0x8d, 0x9b, 0xd9, 0xab, 0xfa, 0x52,
+	0x42, 0xcb, 0x40, 0xd2, 0x5f, 0xa5, 0x23, 0xb3, 0x0f, 0x2b,
+	0xce, 0xd0, 0x7f, 0x66, 0xa2, 0x81, 0xb0, 0xda, 0xe0, 0x53,
+	0xfa, 0xfc, 0x08, 0x7e, 0xd4, 0xce, 0x6a, 0xad, 0xf2, 0xa7,
+	0x97, 0x9c, 0x89, 0xc6, 0xbf, 0xb5, 0x21, 0xae, 0xba, 0x0b,
+	0xc8, 0xb1, 0xe6, 0x32, 0x58, 0x6d, 0x97, 0x57, 0x65, 0xc5,
+	0x3f, 0xac, 0xd8, 0xf7, 0xe8, 0xcf, 0xf4, 0xa5, 0x06, 0xea,
+	0x55, 0x31, 0x14, 0x9d, 0x4f, 0xfd, 0xa9, 0x7a, 0x7b, 0x0f,
+	0x49, 0x58, 0x08, 0x80, 0xb8, 0x17, 0x02, 0xe0, 0x53, 0x70,
+	0xe5, 0x1d, 0x86, 0x61, 0xb6, 0x5d, 0x5d, 0x97, 0x3f, 0x0f,
+	0x02, 0x8b, 0x2d, 0x4b, 0x62, 0xbb, 0xf4, 0x5a, 0xbe, 0xfb,
+	0x40, 0x05, 0xdf, 0x00, 0x87, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xff, 0xa2, 0xfe, 0x74, 0x9d, 0x31, 0x42, 0xa5, 0xdb,
+	0x07, 0x54, 0x9f, 0xcf, 0xdf, 0x78, 0x3f, 0x97, 0xbf, 0x9f,
+	0xa5, 0x3f, 0x9b, 0xd3, 0xd8, 0x7a, 0x4d, 0x6d, 0x3f, 0xcf,
+	0xdf, 0x78, 0x3f, 0x90, 0x88, 0x1f, 0xcf, 0x00, 0x8b, 0x41,
+	0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x49, 0xe3, 0x35, 0x05,
+	0x02, 0x3f, 0x30, 0x00, 0x8d, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xad, 0x5d, 0x03, 0x4c, 0xa7, 0xb2, 0x9f, 0x07, 0x22,
+	0x4c, 0x69, 0x6e, 0x75, 0x78, 0x22, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x59, 0x06, 0x49, 0x7f, 0x88, 0x40,
+	0xe9, 0x2a, 0xc7, 0xb0, 0xd3, 0x1a, 0xaf, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x93, 0xc8, 0x5f, 0x86,
+	0xa8, 0x7d, 0xcd, 0x30, 0xd2, 0x5f, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x42, 0xa1, 0x3f, 0x86, 0x90,
+	0xe4, 0xb6, 0x92, 0xd4, 0x9f, 0x00, 0x92, 0xb6, 0xb9, 0xac,
+	0x1c, 0x85, 0x58, 0xd5, 0x20, 0xa4, 0xb6, 0xc2, 0xad, 0x61,
+	0x7b, 0x5a, 0x54, 0x25, 0x1f, 0x01, 0x31, 0x0f, 0x24, 0x8f,
+	0x9d, 0x29, 0xad, 0x17, 0x18, 0x60, 0xbe, 0x47, 0x4d, 0x74,
+	0x15, 0x72, 0x1e, 0x96, 0x3f, 0x0f, 0x11, 0xf3, 0x8a, 0x61,
+	0xc1, 0x8a, 0x10, 0xae, 0x25, 0xc2, 0x26, 0x5a, 0x6d, 0xc7,
+	0x5e, 0x7c, 0x0b, 0x85, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x0f,
+	0xb5, 0x22, 0x98, 0xd2, 0x41, 0x8a, 0x10, 0xae, 0x25, 0xdf,
+	0x79, 0xd7, 0x1b, 0x69, 0x91, 0x05, 0x70, 0xba, 0x00, 0x00,
+	0x00, 0x00, 0x01, 0xf6, 0xa2, 0x0a, 0x84, 0x18, 0xf5, 0x40,
+	0x5f, 0x59, 0x42, 0x41, 0x71, 0xf5, 0x93, 0xa1, 0xcd, 0xcf,
+	0x97, 0x9a, 0xf9, 0x8b, 0x81, 0xb3, 0xde, 0xcb, 0x41, 0x71,
+	0xc2, 0x6d, 0x5d, 0x30, 0x33, 0xa2, 0xfc, 0x3e, 0x34, 0x5f,
+	0x87, 0xc6, 0x8b, 0xf7, 0x5f, 0x5c, 0x82, 0xa2, 0xa8, 0xe9,
+	0xc2, 0x09, 0x3f, 0x32, 0xd1, 0xf6, 0xa2, 0x67, 0x2d, 0x25,
+	0x82, 0x41, 0xd9, 0xd7, 0xed, 0x4a, 0x07, 0x54, 0xd0, 0x16,
+	0xa5, 0xb1, 0x5d,
+	0x82, 0x04, 0x89, 0x60, 0xd4, 0xcc, 0xc0, 0xda, 0x5f, 0xc1,
+	0x63, 0xaf, 0x86, 0x01, 0x8a, 0x08, 0x9d, 0x5c, 0x0b, 0x81,
+	0x70, 0xdc, 0x75, 0xe0, 0x0b, 0x0f, 0x04, 0xc0, 0x49, 0x7c,
+	0xa5, 0x89, 0xd3, 0x4d, 0x1f, 0x43, 0xae, 0xba, 0x0c, 0x41,
+	0xa4, 0xc7, 0xa9, 0x8f, 0x33, 0xa6, 0x9a, 0x3f, 0xdf, 0x9a,
+	0x68, 0xfa, 0x1d, 0x75, 0xd0, 0x62, 0x0d, 0x26, 0x3d, 0x4c,
+	0x79, 0xa6, 0x8f, 0xbe, 0xd0, 0x01, 0x77, 0xfe, 0x8d, 0x48,
+	0xe6, 0x2b, 0x03, 0xee, 0x69, 0x7e, 0x8d, 0x48, 0xe6, 0x2b,
+	0x1e, 0x0b, 0x1d, 0x7f, 0x5f, 0x2c, 0x7c, 0xfd, 0xf6, 0x80,
+	0x0b, 0xbd, 0x0f, 0x01, 0x8d, 0x9b, 0xd9, 0xab, 0xfa, 0x52,
+	0x42, 0xcb, 0x40, 0xd2, 0x5f, 0xa5, 0x23, 0xb3, 0x0f, 0x2b,
+	0xce, 0xd0, 0x7f, 0x66, 0xa2, 0x81, 0xb0, 0xda, 0xe0, 0x53,
+	0xfa, 0xfc, 0x08, 0x7e, 0xd4, 0xce, 0x6a, 0xad, 0xf2, 0xa7,
+	0x97, 0x9c, 0x89, 0xc6, 0xbf, 0xb5, 0x21, 0xae, 0xba, 0x0b,
+	0xc8, 0xb1, 0xe6, 0x32, 0x58, 0x6d, 0x97, 0x57, 0x65, 0xc5,
+	0x3f, 0xac, 0xd8, 0xf7, 0xe8, 0xcf, 0xf4, 0xa5, 0x06, 0xea,
+	0x55, 0x31, 0x14, 0x9d, 0x4f, 0xfd, 0xa9, 0x7a, 0x7b, 0x0f,
+	0x49, 0x58, 0x08, 0x80, 0xb8, 0x17, 0x02, 0xe0, 0x53, 0x70,
+	0xe5, 0x1d, 0x86, 0x61, 0xb6, 0x5d, 0x5d, 0x97, 0x3f, 0x0f,
+	0x02, 0x8b, 0x2d, 0x4b, 0x62, 0xbb, 0xf4, 0x5a, 0xbe, 0xfb,
+	0x40, 0x05, 0xdf, 0x00, 0x87, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xff, 0xa2, 0xfe, 0x74, 0x9d, 0x31, 0x42, 0xa5, 0xdb,
+	0x07, 0x54, 0x9f, 0xcf, 0xdf, 0x78, 0x3f, 0x97, 0xbf, 0x9f,
+	0xa5, 0x3f, 0x9b, 0xd3, 0xd8, 0x7a, 0x4d, 0x6d, 0x3f, 0xcf,
+	0xdf, 0x78, 0x3f, 0x90, 0x88, 0x1f, 0xcf, 0x00, 0x8b, 0x41,
+	0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x49, 0xe3, 0x35, 0x05,
+	0x02, 0x3f, 0x30, 0x00, 0x8d, 0x41, 0x48, 0xb1, 0x27, 0x5a,
+	0xd1, 0xad, 0x5d, 0x03, 0x4c, 0xa7, 0xb2, 0x9f, 0x07, 0x22,
+	0x4c, 0x69, 0x6e, 0x75, 0x78, 0x22, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x59, 0x06, 0x49, 0x7f, 0x88, 0x40,
+	0xe9, 0x2a, 0xc7, 0xb0, 0xd3, 0x1a, 0xaf, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x93, 0xc8, 0x5f, 0x86,
+	0xa8, 0x7d, 0xcd, 0x30, 0xd2, 0x5f, 0x00, 0x8a, 0x41, 0x48,
+	0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x42, 0xa1, 0x3f, 0x86, 0x90,
+	0xe4, 0xb6, 0x92, 0xd4, 0x9f, 0x00, 0x92, 0xb6, 0xb9, 0xac,
+	0x1c, 0x85, 0x58, 0xd5, 0x20, 0xa4, 0xb6, 0xc2, 0xad, 0x61,
+	0x7b, 0x5a, 0x54, 0x25, 0x1f, 0x01, 0x31, 0x0f, 0x24, 0x8f,
+	0x9d, 0x29, 0xad, 0x17, 0x18, 0x60, 0xbe, 0x47, 0x4d, 0x74,
+	0x15, 0x72, 0x1e, 0x96, 0x3f, 0x0f, 0x11, 0xf3, 0x8a, 0x61,
+	0xc1, 0x8a, 0x10, 0xae, 0x25, 0xc2, 0x26, 0x5a, 0x6d, 0xc7,
+	0x5e, 0x7c, 0x0b, 0x85, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x0f,
+	0xb5, 0x22, 0x98, 0xd2, 0x41, 0x8a, 0x10, 0xae, 0x25, 0xdf,
+	0x79, 0xd7, 0x1b, 0x69, 0x91, 0x05, 0x70, 0xba, 0x00, 0x00,
+	0x00, 0x00, 0x01, 0xf6, 0xa2, 0x0a, 0x84, 0x18, 0xf5, 0x40,
+	0x5f, 0x59, 0x42, 0x41, 0x71, 0xf5, 0x93, 0xa1, 0xcd, 0xcf,
+	0x97, 0x9a, 0xf9, 0x8b, 0x81, 0xb3, 0xde, 0xcb, 0x41, 0x71,
+	0xc2, 0x6d, 0x5d, 0x30, 0x33, 0xa2, 0xfc, 0x3e, 0x34, 0x5f,
+	0x87, 0xc6, 0x8b, 0xf7, 0x5f, 0x5c, 0x82, 0xa2, 0xa8, 0xe9,
+	0xc2, 0x09, 0x3f, 0x32, 0xd1, 0xf6, 0xa2, 0x67, 0x2d, 0x25,
+	0x82, 0x41, 0xd9, 0xd7, 0xed, 0x4a, 0x07, 0x54, 0xd0, 0x16,
+	0xa5, 0xb1, 0x5d,
+	0x82, 0x04, 0x8a, 0x62, 0x91, 0xd4, 0x69, 0x4a, 0x84, 0xaf,
+	0xd1, 0x07, 0xab, 0x86, 0x01, 0x8a, 0x08, 0x9d, 0x5c, 0x0b,
+	0x81, 0x70, 0xdc, 0x75, 0xe0, 0x0b, 0x0f, 0x04, 0xc0, 0x49,
+	0x7c, 0xa5, 0x89, 0xd3, 0x4d, 0x1f, 0x43, 0xae, 0xba, 0x0c,
+	0x41, 0xa4, 0xc7, 0xa9, 0x8f, 0x33, 0xa6, 0x9a, 0x3f, 0xdf,
+	0x9a, 0x68, 0xfa, 0x1d, 0x75, 0xd0, 0x62, 0x0d, 0x26, 0x3d,
+	0x4c, 0x79, 0xa6, 0x8f, 0xbe, 0xd0, 0x01, 0x77, 0xfe, 0x8d,
+	0x48, 0xe6, 0x2b, 0x03, 0xee, 0x69, 0x7e, 0x8d, 0x48, 0xe6,
+	0x2b, 0x1e, 0x0b, 0x1d, 0x7f, 0x5f, 0x2c, 0x7c, 0xfd, 0xf6,
+	0x80, 0x0b, 0xbd, 0x0f, 0x01, 0x8d, 0x9b, 0xd9, 0xab, 0xfa,
+	0x52, 0x42, 0xcb, 0x40, 0xd2, 0x5f, 0xa5, 0x23, 0xb3, 0x0f,
+	0x2b, 0xce, 0xd0, 0x7f, 0x66, 0xa2, 0x81, 0xb0, 0xda, 0xe0,
+	0x53, 0xfa, 0xfc, 0x08, 0x7e, 0xd4, 0xce, 0x6a, 0xad, 0xf2,
+	0xa7, 0x97, 0x9c, 0x89, 0xc6, 0xbf, 0xb5, 0x21, 0xae, 0xba,
+	0x0b, 0xc8, 0xb1, 0xe6, 0x32, 0x58, 0x6d, 0x97, 0x57, 0x65,
+	0xc5, 0x3f, 0xac, 0xd8, 0xf7, 0xe8, 0xcf, 0xf4, 0xa5, 0x06,
+	0xea, 0x55, 0x31, 0x14, 0x9d, 0x4f, 0xfd, 0xa9, 0x7a, 0x7b,
+	0x0f, 0x49, 0x58, 0x08, 0x80, 0xb8, 0x17, 0x02, 0xe0, 0x53,
+	0x70, 0xe5, 0x1d, 0x86, 0x61, 0xb6, 0x5d, 0x5d, 0x97, 0x3f,
+	0x0f, 0x02, 0x8b, 0x2d, 0x4b, 0x62, 0xbb, 0xf4, 0x5a, 0xbe,
+	0xfb, 0x40, 0x05, 0xdf, 0x00, 0x87, 0x41, 0x48, 0xb1, 0x27,
+	0x5a, 0xd1, 0xff, 0xa2, 0xfe, 0x74, 0x9d, 0x31, 0x42, 0xa5,
+	0xdb, 0x07, 0x54, 0x9f, 0xcf, 0xdf, 0x78, 0x3f, 0x97, 0xbf,
+	0x9f, 0xa5, 0x3f, 0x9b, 0xd3, 0xd8, 0x7a, 0x4d, 0x6d, 0x3f,
+	0xcf, 0xdf, 0x78, 0x3f, 0x90, 0x88, 0x1f, 0xcf, 0x00, 0x8b,
+	0x41, 0x48, 0xb1, 0x27, 0x5a, 0xd1, 0xad, 0x49, 0xe3, 0x35,
+	0x05, 0x02, 0x3f, 0x30, 0x00, 0x8d, 0x41, 0x48, 0xb1, 0x27,
+	0x5a, 0xd1, 0xad, 0x5d, 0x03, 0x4c, 0xa7, 0xb2, 0x9f, 0x07,
+	0x22, 0x4c, 0x69, 0x6e, 0x75, 0x78, 0x22, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x59, 0x06, 0x49, 0x7f, 0x88,
+	0x40, 0xe9, 0x2a, 0xc7, 0xb0, 0xd3, 0x1a, 0xaf, 0x00, 0x8a,
+	0x41, 0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x93, 0xc8, 0x5f,
+	0x86, 0xa8, 0x7d, 0xcd, 0x30, 0xd2, 0x5f, 0x00, 0x8a, 0x41,
+	0x48, 0xb4, 0xa5, 0x49, 0x27, 0x5a, 0x42, 0xa1, 0x3f, 0x86,
+	0x90, 0xe4, 0xb6, 0x92, 0xd4, 0x9f, 0x00, 0x92, 0xb6, 0xb9,
+	0xac, 0x1c, 0x85, 0x58, 0xd5, 0x20, 0xa4, 0xb6, 0xc2, 0xad,
+	0x61, 0x7b, 0x5a, 0x54, 0x25, 0x1f, 0x01, 0x31, 0x0f, 0x24,
+	0x8f, 0x9d, 0x29, 0xad, 0x17, 0x18, 0x60, 0xbe, 0x47, 0x4d,
+	0x74, 0x15, 0x72, 0x1e, 0x96, 0x3f, 0x0f, 0x11, 0xf3, 0x8a,
+	0x61, 0xc1, 0x8a, 0x10, 0xae, 0x25, 0xc2, 0x26, 0x5a, 0x6d,
+	0xc7, 0x5e, 0x7c, 0x0b, 0x85, 0xd0, 0x00, 0x00, 0x00, 0x00,
+	0x0f, 0xb5, 0x22, 0x98, 0xd2, 0x41, 0x8a, 0x10, 0xae, 0x25,
+	0xdf, 0x79, 0xd7, 0x1b, 0x69, 0x91, 0x05, 0x70, 0xba, 0x00,
+	0x00, 0x00, 0x00, 0x01, 0xf6, 0xa2, 0x0a, 0x84, 0x18, 0xf5,
+	0x40, 0x5f, 0x59, 0x42, 0x41, 0x71, 0xf5, 0x93, 0xa1, 0xcd,
+	0xcf, 0x97, 0x9a, 0xf9, 0x8b, 0x81, 0xb3, 0xde, 0xcb, 0x41,
+	0x71, 0xc2, 0x6d, 0x5d, 0x30, 0x33, 0xa2, 0xfc, 0x3e, 0x34,
+	0x5f, 0x87, 0xc6, 0x8b, 0xf7, 0x5f, 0x5c, 0x82, 0xa2, 0xa8,
+	0xe9, 0xc2, 0x09, 0x3f, 0x32, 0xd1, 0xf6, 0xa2, 0x67, 0x2d,
+	0x25, 0x82, 0x41, 0xd9, 0xd7, 0xed, 0x4a, 0x07, 0x54, 0xd0,
+	0x16, 0xa5, 0xb1, 0x5d,
+};
+
+static const uint16_t chrome_literal_lens[] = {
+	494, 503, 502, 504, 504, 513, 507, 503, 508, 508, 503, 503, 503,
+	503, 503, 504
+};
+
+/* RFC7541 C.4, requests with Huffman coding */
+
+static const uint8_t rfc7541[] = {
+	0x82, 0x86, 0x84, 0x41, 0x8c, 0xf1, 0xe3, 0xc2, 0xe5, 0xf2,
+	0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff,
+	0x82, 0x86, 0x84, 0xbe, 0x58, 0x86, 0xa8, 0xeb, 0x10, 0x64,
+	0x9c, 0xbf,
+	0x82, 0x87, 0x85, 0xbf, 0x40, 0x88, 0x25, 0xa8, 0x49, 0xe9,
+	0x5b, 0xa9, 0x7d, 0x7f, 0x89, 0x25, 0xa8, 0x49, 0xe9, 0x5b,
+	0xb8, 0xe8, 0xb4, 0xbf,
+};
+
+static const uint16_t rfc7541_lens[] = {
+	17, 12, 24
+};
+
+static const char * const chrome_paths[] = {
+	"/", "/css/site.css", "/js/app.js", "/js/vendor.js", "/img/logo.svg",
+	"/img/hero.jpg?w=1200&q=80", "/fonts/inter.woff2", "/api/v1/user",
+	"/api/v1/feed?page=1", "/api/v1/feed?page=2", "/favicon.ico",
+	"/img/a1.webp", "/img/a2.webp", "/img/a3.webp", "/img/a4.webp",
+	"/manifest.json"
+}, * const firefox_paths[] = {
+	"/index.html", "/static/main.css", "/static/main.js",
+	"/static/img/banner.png", "/static/img/icon-1.png",
+	"/static/img/icon-2.png", "/api/search?q=hpack",
+	"/api/search?q=huffman", "/static/fonts/a.woff2", "/robots.txt"
+}, * const rfc7541_paths[] = {
+	"/", "/", "/index.html"
+};
+
+struct trace {
+	const char		*name;
+	const uint8_t		*blocks;
+	const uint16_t		*lens;
+	const char * const	*paths;
+	const char		*ua;
+	int			count;
+};
+
+#define UA_CHROME "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 " \
+		  "(KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36"
+
+static const struct trace traces[] = {
+	{ "chrome", chrome, chrome_lens, chrome_paths, UA_CHROME,
+	  (int)LWS_ARRAY_SIZE(chrome_lens) },
+	{ "firefox", firefox, firefox_lens, firefox_paths,
+	  "Mozilla/5.0 (X11; Ubuntu; Linux x86_64; rv:121.0) Gecko/20100101 "
+	  "Firefox/121.0",
+	  (int)LWS_ARRAY_SIZE(firefox_lens) },
+	{ "chrome-literal", chrome_literal, chrome_literal_lens, chrome_paths,
+	  UA_CHROME, (int)LWS_ARRAY_SIZE(chrome_literal_lens) },
+	{ "rfc7541", rfc7541, rfc7541_lens, rfc7541_paths, NULL,
+	  (int)LWS_ARRAY_SIZE(rfc7541_lens) },
+};
+
+/* lws allows 24 concurrent streams per connection by default */
+#define IN_FLIGHT 16
+
+static const uint8_t preface[] = {
+	'P', 'R', 'I', ' ', '*', ' ', 'H', 'T', 'T', 'P', '/', '2', '.', '0',
+	'\r', '\n', '\r', '\n', 'S', 'M', '\r', '\n', '\r', '\n',
+	0, 0, 0, 4, 0, 0, 0, 0, 0	/* empty SETTINGS */
+}, settings_ack[] = {
+	0, 0, 0, 4, 1, 0, 0, 0, 0
+};
+
+static struct stats {
+	lws_usec_t		us;
+	size_t			bytes;
+	size_t			blocks;
+} stats[LWS_ARRAY_SIZE(traces)], *st;
+
+static struct lws_context *context;
+static const struct trace *tr;
+static lws_usec_t started;
+static int rounds = 200, port = 7698, interrupted, failed, idle = 1,
+	   sent, answered, pending_ack, sent_preface;
+static size_t pos, rxlen;
+static uint8_t rx[2048];
+static uint32_t seen;
+
+/*
+ * lws may get to the streams in any order, and it keeps the query string
+ * separately, so match what we got with a recorded path we didn't see yet
+ */
+
+static int
+check(struct lws *wsi)
+{
+	char v[256];
+	size_t l;
+	int n;
+
+	if (lws_hdr_copy(wsi, v, sizeof(v), WSI_TOKEN_HTTP_COLON_PATH) < 0)
+		return 1;
+
+	for (n = 0; n < tr->count; n++) {
+		l = strcspn(tr->paths[n], "?");
+		if (!(seen & (1u << n)) && strlen(v) == l &&
+		    !strncmp(v, tr->paths[n], l))
+			break;
+	}
+	if (n == tr->count) {
+		lwsl_err("%s: unexpected :path '%s'\n", __func__, v);
+		return 1;
+	}
+	seen |= 1u << n;
+
+	if (tr->ua && (lws_hdr_copy(wsi, v, sizeof(v),
+				    WSI_TOKEN_HTTP_USER_AGENT) < 0 ||
+		       strcmp(v, tr->ua))) {
+		lwsl_err("%s: user-agent '%s'\n", __func__, v);
+		return 1;
+	}
+
+	return 0;
+}
+
+static int
+serve(struct lws *wsi)
+{
+	uint8_t buf[LWS_PRE + 256], *start = &buf[LWS_PRE], *p = start,
+		*end = &buf[sizeof(buf) - 1];
+
+	if (check(wsi))
+		failed = 1;
+
+	if (lws_add_http_common_headers(wsi, HTTP_STATUS_OK, "text/plain", 2,
+					&p, end) ||
+	    lws_finalize_write_http_header(wsi, start, &p, end))
+		return 1;
+
+	memcpy(start, "ok", 2);
+
+	return lws_write(wsi, start, 2, LWS_WRITE_HTTP_FINAL) != 2;
+}
+
+/* just enough h2 framing to see the responses end */
+
+static int
+client_rx(struct lws *wsi, const uint8_t *in, size_t len)
+{
+	size_t fl;
+
+	if (rxlen + len > sizeof(rx)) {
+		lwsl_err("%s: rx overflow\n", __func__);
+		return 1;
+	}
+	memcpy(rx + rxlen, in, len);
+	rxlen += len;
+
+	while (rxlen >= 9) {
+		fl = 9u + (size_t)((rx[0] << 16) | (rx[1] << 8) | rx[2]);
+		if (fl > sizeof(rx)) {
+			lwsl_err("%s: frame too large\n", __func__);
+			return 1;
+		}
+		if (rxlen < fl)
+			break;
+
+		switch (rx[3]) {
+		case 0: /* DATA */
+		case 1: /* HEADERS */
+			if (rx[4] & 1) /* END_STREAM */
+				answered++;
+			break;
+		case 4: /* SETTINGS */
+			if (!(rx[4] & 1))
+				pending_ack = 1;
+			break;
+		case 7: /* GOAWAY */
+			lwsl_err("%s: GOAWAY\n", __func__);
+			return 1;
+		}
+
+		memmove(rx, rx + fl, rxlen - fl);
+		rxlen -= fl;
+	}
+
+	return 0;
+}
+
+static int
+client_tx(struct lws *wsi)
+{
+	uint8_t buf[LWS_PRE + 4096], *start = &buf[LWS_PRE], *p = start,
+		*end = &buf[sizeof(buf)];
+	unsigned int sid;
+	size_t l;
+
+	if (!sent_preface) {
+		memcpy(p, preface, sizeof(preface));
+		p += sizeof(preface);
+		sent_preface = 1;
+	}
+
+	if (pending_ack) {
+		memcpy(p, settings_ack, sizeof(settings_ack));
+		p += sizeof(settings_ack);
+		pending_ack = 0;
+	}
+
+	while (sent < tr->count && sent - answered < IN_FLIGHT) {
+		l = tr->lens[sent];
+		if (lws_ptr_diff_size_t(end, p) < 9 + l)
+			break;
+
+		sid = (unsigned int)(sent * 2) + 1;
+		*p++ = (uint8_t)(l >> 16);
+		*p++ = (uint8_t)(l >> 8);
+		*p++ = (uint8_t)l;
+		*p++ = 1;	/* HEADERS */
+		*p++ = 4 | 1;	/* END_HEADERS | END_STREAM */
+		*p++ = (uint8_t)(sid >> 24);
+		*p++ = (uint8_t)(sid >> 16);
+		*p++ = (uint8_t)(sid >> 8);
+		*p++ = (uint8_t)sid;
+		memcpy(p, tr->blocks + pos, l);
+		p += l;
+		pos += l;
+		st->bytes += l;
+		st->blocks++;
+		sent++;
+	}
+
+	if (p == start)
+		return 0;
+
+	l = lws_ptr_diff_size_t(p, start);
+
+	return lws_write(wsi, start, l, LWS_WRITE_RAW) != (int)l;
+}
+
+static int
+callback_hpack_decode(struct lws *wsi, enum lws_callback_reasons reason,
+		      void *user, void *in, size_t len)
+{
+	switch (reason) {
+
+	/* the server side */
+
+	case LWS_CALLBACK_HTTP:
+		return serve(wsi) ? -1 : lws_http_transaction_completed(wsi);
+
+	default:
+		break;
+	}
+
+	return lws_callback_http_dummy(wsi, reason, user, in, len);
+}
+
+static int
+callback_raw_client(struct lws *wsi, enum lws_callback_reasons reason,
+		    void *user, void *in, size_t len)
+{
+	switch (reason) {
+	case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
+		lwsl_err("CLIENT_CONNECTION_ERROR: %s\n",
+			 in ? (char *)in : "(null)");
+		failed = 1;
+		idle = 1;
+		break;
+
+	case LWS_CALLBACK_RAW_CONNECTED:
+		lws_callback_on_writable(wsi);
+		break;
+
+	case LWS_CALLBACK_RAW_RX:
+		if (client_rx(wsi, (const uint8_t *)in, len)) {
+			failed = 1;
+			return -1;
+		}
+		if (answered == tr->count)
+			/* this connection's page load is complete */
+			return -1;
+		if (pending_ack || (sent < tr->count &&
+				    sent - answered < IN_FLIGHT))
+			lws_callback_on_writable(wsi);
+		break;
+
+	case LWS_CALLBACK_RAW_WRITEABLE:
+		if (client_tx(wsi))
+			return -1;
+		break;
+
+	case LWS_CALLBACK_RAW_CLOSE:
+		if (answered != tr->count) {
+			lwsl_err("%s: closed after %d of %d\n", __func__,
+				 answered, tr->count);
+			failed = 1;
+		}
+		st->us += lws_now_usecs() - started;
+		idle = 1;
+		lws_cancel_service(lws_get_context(wsi));
+		break;
+
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+static const struct lws_protocols protocols[] = {
+	{ "http", callback_hpack_decode, 0, 0, 0, NULL, 0 },
+	{ "raw-h2", callback_raw_client, 0, 0, 0, NULL, 0 },
+	LWS_PROTOCOL_LIST_TERM
+};
+
+static int
+start_trace(int n)
+{
+	struct lws_client_connect_info i;
+
+	tr = &traces[n];
+	st = &stats[n];
+	started = lws_now_usecs();
+	pos = rxlen = 0;
+	seen = 0;
+	sent = answered = pending_ack = sent_preface = 0;
+	idle = 0;
+
+	memset(&i, 0, sizeof i); /* otherwise uninitialized garbage */
+	i.context = context;
+	i.address = "127.0.0.1";
+	i.host = i.address;
+	i.origin = i.address;
+	i.port = port;
+	i.method = "RAW";
+	i.local_protocol_name = protocols[1].name;
+
+	if (!lws_client_connect_via_info(&i)) {
+		lwsl_err("%s: client connect failed\n", __func__);
+		failed = 1;
+		return 1;
+	}
+
+	return 0;
+}
+
+static void
+sigint_handler(int sig)
+{
+	interrupted = 1;
+}
+
+int
+main(int argc, const char **argv)
+{
+	int logs = LLL_USER | LLL_ERR | LLL_WARN, e = 1, n = 0;
+	struct lws_context_creation_info info;
+	const char *p;
+
+	signal(SIGINT, sigint_handler);
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--rounds")))
+		rounds = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--port")))
+		port = atoi(p);
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS minimal http server h2 hpack decode\n");
+
+	memset(&info, 0, sizeof info); /* otherwise uninitialized garbage */
+	info.port = port;
+	info.iface = "127.0.0.1";
+	info.protocols = protocols;
+	info.options = LWS_SERVER_OPTION_H2_PRIOR_KNOWLEDGE;
+
+	context = lws_create_context(&info);
+	if (!context) {
+		lwsl_err("lws init failed\n");
+		return 1;
+	}
+
+	while (!failed && !interrupted) {
+		if (idle) {
+			if (n == rounds * (int)LWS_ARRAY_SIZE(traces))
+				break;
+			if (start_trace(n++ % (int)LWS_ARRAY_SIZE(traces)))
+				break;
+		}
+		if (lws_service(context, 0) < 0)
+			break;
+	}
+
+	if (!failed && !interrupted &&
+	    n == rounds * (int)LWS_ARRAY_SIZE(traces)) {
+		for (n = 0; n < (int)LWS_ARRAY_SIZE(traces); n++)
+			lwsl_user("%-14s %6zu blocks, avg %3zu bytes: %6.2fus "
+				  "per request, %5.2fMB/s of header block\n",
+				  traces[n].name, stats[n].blocks,
+				  stats[n].bytes / stats[n].blocks,
+				  (double)stats[n].us /
+						(double)stats[n].blocks,
+				  (double)stats[n].bytes /
+						(double)stats[n].us);
+		e = 0;
+	}
+
+	lws_context_destroy(context);
+
+	lwsl_user("Completed: %s\n", e ? "FAIL" : "PASS");
+
+	return e;
+}
@@ -0,0 +1,572 @@
+/*
+ * lws-minimal-http-server-h2-hpack
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This serves a small dynamic http response with a typical set of API
+ * response headers over h2 on loopback, and fetches it repeatedly with an lws
+ * client in the same process, as streams on the same h2 connection.
+ *
+ * The server measures the size of each HPACK header block it produced, and
+ * compares it to what the same headers cost as plain literals.  The client
+ * checks every response header arrived intact through its HPACK decoder,
+ * including the ones that were sent as references to its dynamic table.
+ *
+ * It goes through several phases, each on its own h2 connection, that make
+ * the encoder evict entries, abandon header blocks it had started, change the
+ * size of its dynamic table partway through, and work with clients that
+ * advertise a small, or zero, SETTINGS_HEADER_TABLE_SIZE.
+ */
+
+#include <libwebsockets.h>
+#include <string.h>
+#include <stdlib.h>
+#include <signal.h>
+
+/*
+ * lws internal, not part of the public api, so this test links against the
+ * static lws library to get at it.  It's what lws calls when the peer's
+ * SETTINGS change the header table size.
+ */
+void
+lws_hpack_enc_peer_table_size(struct lws *nwsi, uint32_t size);
+
+struct hdr {
+	enum lws_token_indexes	tok;
+	const char		*value;
+};
+
+/* a typical set of response headers for an API call */
+
+static const struct hdr hdrs[] = {
+	{ WSI_TOKEN_HTTP_SERVER,	"lws-minimal-http-server-h2-hpack" },
+	{ WSI_TOKEN_HTTP_CONTENT_TYPE,	"application/json; charset=utf-8" },
+	{ WSI_TOKEN_HTTP_CACHE_CONTROL,	"no-store, no-cache, must-revalidate" },
+	{ WSI_TOKEN_HTTP_ACCESS_CONTROL_ALLOW_ORIGIN, "https://example.com" },
+	{ WSI_TOKEN_HTTP_STRICT_TRANSPORT_SECURITY,
+				"max-age=15768000; includeSubDomains" },
+	{ WSI_TOKEN_HTTP_VARY,		"Accept-Encoding, Origin" },
+	/* must never be indexed, RFC7541 7.1.3 */
+	{ WSI_TOKEN_HTTP_SET_COOKIE,	"sid=31d4d96e407aad42; Path=/; Secure; "
+					"HttpOnly" },
+};
+
+struct phase {
+	const char		*name;
+	int			table;	 /* SETTINGS_HEADER_TABLE_SIZE the
+					  * client advertises, -1 = default */
+	int			count;
+	char			vary;	 /* headers with per-response values */
+	char			rollback; /* abandon a block before some */
+	char			resize;	 /* change the table size partway */
+};
+
+static struct phase phases[] = {
+	/* the same headers every time, the count is from --count */
+	{ "repeat",	-1, 100, 0, 0, 0 },
+	/* new values all the time, the table fills up and evicts */
+	{ "evict",	-1,  60, 1, 0, 0 },
+	/* some blocks are built and thrown away before the real one */
+	{ "rollback",	-1,  30, 1, 1, 0 },
+	/* the table size goes to 0 and back, then down and back up */
+	{ "resize",	-1,  20, 1, 0, 1 },
+	/* the client only allows a small table, some fields won't fit */
+	{ "small",	256, 30, 1, 0, 0 },
+	/* the client doesn't allow a dynamic table at all */
+	{ "zero",	  0, 20, 0, 0, 0 },
+};
+
+struct stats {
+	size_t			first;
+	size_t			rest;
+	size_t			literal;
+};
+
+struct pss {
+	int			completed;
+};
+
+static struct stats stats[LWS_ARRAY_SIZE(phases)];
+static struct lws_vhost *vhosts[LWS_ARRAY_SIZE(phases)];
+static int port = 7697, cur, done, served, failed, interrupted;
+static struct lws_context *context;
+
+/* how big the old encoder made it: literal name and value, no Huffman */
+
+static size_t
+literal_len(size_t nlen, size_t vlen)
+{
+	return 1 + (nlen < 127 ? 1u : 2u) + nlen + (vlen < 127 ? 1u : 2u) + vlen;
+}
+
+/*
+ * The headers whose values change from response to response.  The first one
+ * is always new, and too big for the small table, the second one comes round
+ * again every few responses.
+ */
+
+static int
+vary_value(int which, int req, char *buf, size_t len)
+{
+	if (!which)
+		return lws_snprintf(buf, len, "/api/v1/items/%d?fields=id,name,"
+			"owner,created,modified,tags,attributes,permissions,"
+			"links,history,comments,attachments,related,parent,"
+			"children,siblings,revisions,metadata&expand=owner,"
+			"tags&page=%d&per_page=50", req * 7919, req);
+
+	return lws_snprintf(buf, len, "</static/style-%d.css>; rel=preload; "
+			    "as=style", req % 4);
+}
+
+static const enum lws_token_indexes vary_tok[] = {
+	WSI_TOKEN_HTTP_CONTENT_LOCATION, WSI_TOKEN_HTTP_LINK
+};
+
+static int
+add_header(struct lws *wsi, enum lws_token_indexes tok, const char *value,
+	   int vlen, size_t *lit, unsigned char **p, unsigned char *end)
+{
+	const char *name = (const char *)lws_token_to_string(tok);
+	unsigned char *b = *p;
+
+	if (lws_add_http_header_by_token(wsi, tok, (unsigned char *)value, vlen,
+					 p, end))
+		return 1;
+
+	*lit += literal_len(strlen(name) - 1, (size_t)vlen);
+
+	/*
+	 * Never indexed literals are 0001xxxx, we can find it at the start
+	 * of what we just added, since the table size update can only come
+	 * before the :status
+	 */
+
+	if (tok == WSI_TOKEN_HTTP_SET_COOKIE && (*b & 0xf0) != 0x10) {
+		lwsl_err("%s: set-cookie not sent never-indexed: 0x%02x\n",
+			 __func__, *b);
+		failed = 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Start a header block with fields that would go into the dynamic table, and
+ * then abandon it, like a server that runs out of space and starts again.
+ * The peer never sees these, so the encoder must forget them.
+ */
+
+static int
+abandoned_block(struct lws *wsi, int req)
+{
+	uint8_t buf[LWS_PRE + 512], *p = &buf[LWS_PRE],
+		*end = &buf[sizeof(buf) - 1];
+	char v[64];
+	int n;
+
+	if (lws_add_http_header_status(wsi, HTTP_STATUS_OK, &p, end))
+		return 1;
+
+	n = lws_snprintf(v, sizeof(v), "/abandoned/%d", req);
+	if (lws_add_http_header_by_token(wsi, WSI_TOKEN_HTTP_CONTENT_LOCATION,
+					 (unsigned char *)v, n, &p, end))
+		return 1;
+
+	/* the same name and value the real block will use */
+
+	n = vary_value(1, req, v, sizeof(v));
+
+	return lws_add_http_header_by_token(wsi, WSI_TOKEN_HTTP_LINK,
+					    (unsigned char *)v, n, &p, end);
+}
+
+static int
+serve(struct lws *wsi)
+{
+	uint8_t buf[LWS_PRE + 2048], *start = &buf[LWS_PRE], *p = start,
+		*end = &buf[sizeof(buf) - 1];
+	const struct phase *ph = &phases[cur];
+	struct stats *st = &stats[cur];
+	struct lws *nwsi = lws_get_network_wsi(wsi);
+	int n, bl, req = served++, update = 0;
+	char body[64], cl[16], v[256];
+	size_t lit = 0;
+
+	bl = lws_snprintf(body, sizeof(body), "{\"req\":%d}", req);
+
+	/*
+	 * As if the peer sent SETTINGS changing its header table size.  The
+	 * next block must start with a size update for the smallest size it
+	 * had in between, if that's less than the final one, RFC7541 4.2
+	 */
+
+	if (ph->resize)
+		switch (req) {
+		case 5:
+			lws_hpack_enc_peer_table_size(nwsi, 0);
+			lws_hpack_enc_peer_table_size(nwsi, 4096);
+			update = 1;
+			break;
+		case 10:
+			lws_hpack_enc_peer_table_size(nwsi, 512);
+			update = 1;
+			break;
+		case 15:
+			lws_hpack_enc_peer_table_size(nwsi, 4096);
+			update = 1;
+			break;
+		}
+
+	/* the client told it a different size in its SETTINGS */
+
+	if (ph->table >= 0 && !req)
+		update = 1;
+
+	if (ph->rollback && req % 3 == 1 && abandoned_block(wsi, req))
+		return 1;
+
+	if (lws_add_http_header_status(wsi, HTTP_STATUS_OK, &p, end))
+		return 1;
+	lit += literal_len(7, 3);
+
+	/* a dynamic table size update is 001xxxxx, before any field */
+
+	if (((*start & 0xe0) == 0x20) != update ||
+	    (update && !ph->table && *start != 0x20) ||
+	    (update && ph->resize && req == 5 && *start != 0x20)) {
+		lwsl_err("%s: %s: block %d starts 0x%02x\n", __func__,
+			 ph->name, req, *start);
+		failed = 1;
+	}
+
+	for (n = 0; n < (int)LWS_ARRAY_SIZE(hdrs); n++)
+		if (add_header(wsi, hdrs[n].tok, hdrs[n].value,
+			       (int)strlen(hdrs[n].value), &lit, &p, end))
+			return 1;
+
+	if (ph->vary)
+		for (n = 0; n < (int)LWS_ARRAY_SIZE(vary_tok); n++)
+			if (add_header(wsi, vary_tok[n], v,
+				       vary_value(n, req, v, sizeof(v)),
+				       &lit, &p, end))
+				return 1;
+
+	if (lws_add_http_header_by_name(wsi, (unsigned char *)"x-request-id:",
+					(unsigned char *)body + 7,
+					bl - 8, &p, end))
+		return 1;
+	lit += literal_len(12, (size_t)bl - 8);
+
+	if (lws_add_http_header_content_length(wsi, (lws_filepos_t)bl, &p, end))
+		return 1;
+	lit += literal_len(14, (size_t)lws_snprintf(cl, sizeof(cl), "%d", bl));
+
+	if (!req)
+		st->first = lws_ptr_diff_size_t(p, start);
+	else
+		st->rest += lws_ptr_diff_size_t(p, start);
+	st->literal += lit;
+
+	if (lws_finalize_write_http_header(wsi, start, &p, end))
+		return 1;
+
+	memcpy(start, body, (size_t)bl);
+
+	return lws_write(wsi, start, (size_t)bl, LWS_WRITE_HTTP_FINAL) != bl;
+}
+
+static int
+check_value(struct lws *wsi, enum lws_token_indexes tok, const char *exp)
+{
+	char v[256];
+
+	if (lws_hdr_copy(wsi, v, sizeof(v), tok) < 0 || strcmp(v, exp)) {
+		lwsl_err("%s: %s: %s: '%s'\n", __func__, phases[cur].name,
+			 lws_token_to_string(tok), v);
+		return 1;
+	}
+
+	return 0;
+}
+
+static int
+check(struct lws *wsi)
+{
+	char v[256];
+	int n;
+
+	if (lws_http_client_http_response(wsi) != 200) {
+		lwsl_err("%s: response %d\n", __func__,
+			 (int)lws_http_client_http_response(wsi));
+		return 1;
+	}
+
+	for (n = 0; n < (int)LWS_ARRAY_SIZE(hdrs); n++)
+		if (check_value(wsi, hdrs[n].tok, hdrs[n].value))
+			return 1;
+
+	if (phases[cur].vary)
+		for (n = 0; n < (int)LWS_ARRAY_SIZE(vary_tok); n++) {
+			vary_value(n, done, v, sizeof(v));
+			if (check_value(wsi, vary_tok[n], v))
+				return 1;
+		}
+
+	return 0;
+}
+
+static int
+start_req(void);
+
+static int
+callback_hpack(struct lws *wsi, enum lws_callback_reasons reason,
+	       void *user, void *in, size_t len)
+{
+	struct pss *pss = (struct pss *)user;
+
+	switch (reason) {
+
+	/* the server side */
+
+	case LWS_CALLBACK_HTTP:
+		return serve(wsi) ? -1 : lws_http_transaction_completed(wsi);
+
+	/* the client side */
+
+	case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
+		lwsl_err("CLIENT_CONNECTION_ERROR: %s\n",
+			 in ? (char *)in : "(null)");
+		failed = 1;
+		lws_cancel_service(lws_get_context(wsi));
+		break;
+
+	case LWS_CALLBACK_RECEIVE_CLIENT_HTTP_READ:
+		return 0;
+
+	case LWS_CALLBACK_RECEIVE_CLIENT_HTTP:
+		{
+			char buffer[1024 + LWS_PRE];
+			char *px = buffer + LWS_PRE;
+			int lenx = sizeof(buffer) - LWS_PRE;
+
+			if (lws_http_client_read(wsi, &px, &lenx) < 0)
+				return -1;
+		}
+		return 0;
+
+	case LWS_CALLBACK_COMPLETED_CLIENT_HTTP:
+		/*
+		 * Streams joining the existing h2 connection see ESTABLISHED
+		 * before their response arrived, so check the headers here
+		 */
+		if (check(wsi))
+			failed = 1;
+		pss->completed = 1;
+		if (++done == phases[cur].count) {
+			/* the next phase is on a new connection */
+			done = served = 0;
+			cur++;
+		}
+		if (cur < (int)LWS_ARRAY_SIZE(phases) && !failed)
+			start_req();
+		lws_cancel_service(lws_get_context(wsi));
+		break;
+
+	case LWS_CALLBACK_CLOSED_CLIENT_HTTP:
+		if (pss && !pss->completed) {
+			lwsl_err("%s: closed early\n", __func__);
+			failed = 1;
+		}
+		lws_cancel_service(lws_get_context(wsi));
+		break;
+
+	default:
+		break;
+	}
+
+	return lws_callback_http_dummy(wsi, reason, user, in, len);
+}
+
+static const struct lws_protocols protocols[] = {
+	{ "http", callback_hpack, sizeof(struct pss), 0, 0, NULL, 0 },
+	LWS_PROTOCOL_LIST_TERM
+};
+
+static int
+start_req(void)
+{
+	struct lws_client_connect_info i;
+
+	memset(&i, 0, sizeof i); /* otherwise uninitialized garbage */
+	i.context = context;
+	i.ssl_connection = LCCSCF_USE_SSL | LCCSCF_ALLOW_SELFSIGNED |
+			   LCCSCF_SKIP_SERVER_CERT_HOSTNAME_CHECK |
+			   LCCSCF_PIPELINE;
+	i.port = port;
+	i.address = "localhost";
+	i.path = "/api";
+	i.host = i.address;
+	i.origin = i.address;
+	i.method = "GET";
+	i.alpn = "h2";
+	i.protocol = protocols[0].name;
+	/* the phase's own client vhost, if it needs different SETTINGS */
+	i.vhost = vhosts[cur];
+
+	if (!lws_client_connect_via_info(&i)) {
+		lwsl_err("%s: client connect failed\n", __func__);
+		failed = 1;
+		return 1;
+	}
+
+	return 0;
+}
+
+static void
+sigint_handler(int sig)
+{
+	interrupted = 1;
+}
+
+int
+main(int argc, const char **argv)
+{
+	int logs = LLL_USER | LLL_ERR | LLL_WARN, e = 1, n;
+	struct lws_context_creation_info info;
+	const struct stats *st;
+	lws_usec_t timeout;
+	size_t first, avg;
+	const char *p;
+
+	signal(SIGINT, sigint_handler);
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--count")))
+		phases[0].count = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--port")))
+		port = atoi(p);
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS minimal http server h2 hpack\n");
+
+	if (phases[0].count < 2) {
+		lwsl_err("--count must be at least 2\n");
+		return 1;
+	}
+
+	memset(&info, 0, sizeof info); /* otherwise uninitialized garbage */
+	info.port = port;
+	info.protocols = protocols;
+	info.options = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
+	info.ssl_cert_filepath = "localhost-100y.cert";
+	info.ssl_private_key_filepath = "localhost-100y.key";
+
+	context = lws_create_context(&info);
+	if (!context) {
+		lwsl_err("lws init failed\n");
+		return 1;
+	}
+
+	/*
+	 * Client vhosts for the phases that advertise their own header table
+	 * size, the rest of the settings are the lws defaults
+	 */
+
+	for (n = 0; n < (int)LWS_ARRAY_SIZE(phases); n++) {
+		if (phases[n].table < 0)
+			continue;
+
+		memset(&info, 0, sizeof info);
+		info.port = CONTEXT_PORT_NO_LISTEN;
+		info.protocols = protocols;
+		info.vhost_name = phases[n].name;
+		info.options = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
+		info.http2_settings[0] = 1;
+		info.http2_settings[H2SET_HEADER_TABLE_SIZE] =
+						(uint32_t)phases[n].table;
+		info.http2_settings[H2SET_ENABLE_PUSH] = 0;
+		info.http2_settings[H2SET_MAX_CONCURRENT_STREAMS] = 24;
+		info.http2_settings[H2SET_INITIAL_WINDOW_SIZE] = 0;
+		info.http2_settings[H2SET_MAX_FRAME_SIZE] = 16384;
+		info.http2_settings[H2SET_MAX_HEADER_LIST_SIZE] = 4096;
+
+		vhosts[n] = lws_create_vhost(context, &info);
+		if (!vhosts[n]) {
+			lwsl_err("%s: client vhost failed\n", __func__);
+			goto bail;
+		}
+	}
+
+	if (lws_cmdline_option(argc, argv, "-s")) {
+		/* just serve, eg, for nghttp -nv https://localhost:7697/api */
+		while (!interrupted)
+			if (lws_service(context, 0) < 0)
+				break;
+		e = 0;
+		goto bail;
+	}
+
+	if (start_req())
+		goto bail;
+
+	timeout = lws_now_usecs() + (30 * LWS_US_PER_SEC);
+	while (cur < (int)LWS_ARRAY_SIZE(phases) && !failed &&
+	       lws_now_usecs() < timeout)
+		if (lws_service(context, 0) < 0)
+			break;
+
+	if (cur != (int)LWS_ARRAY_SIZE(phases) || failed) {
+		lwsl_err("%s: %s: %d of %d ok\n", __func__,
+			 cur < (int)LWS_ARRAY_SIZE(phases) ?
+				phases[cur].name : "-", done,
+			 cur < (int)LWS_ARRAY_SIZE(phases) ?
+				phases[cur].count : 0);
+		goto bail;
+	}
+
+	for (n = 0; n < (int)LWS_ARRAY_SIZE(phases); n++) {
+		st = &stats[n];
+		avg = st->rest / (size_t)(phases[n].count - 1);
+		lwsl_user("%-8s %3d responses: header block first %3zu, then "
+			  "avg %3zu bytes, vs %3zu as literals, total %zu%%\n",
+			  phases[n].name, phases[n].count, st->first, avg,
+			  st->literal / (size_t)phases[n].count,
+			  ((st->first + st->rest) * 100) / st->literal);
+	}
+
+	/* if the dynamic table isn't working, there's no big saving */
+
+	st = &stats[0];
+	if ((st->first + st->rest) * 3 >= st->literal) {
+		lwsl_err("%s: repeat: not much smaller than literals\n",
+			 __func__);
+		goto bail;
+	}
+
+	/* ... and if there's no table, each block costs about the same */
+
+	st = &stats[LWS_ARRAY_SIZE(phases) - 1];
+	first = st->first;
+	avg = st->rest / (size_t)(phases[LWS_ARRAY_SIZE(phases) - 1].count - 1);
+	if (avg + 4 < first) {
+		lwsl_err("%s: zero: later blocks smaller than the first\n",
+			 __func__);
+		goto bail;
+	}
+
+	e = 0;
+
+bail:
+	lws_context_destroy(context);
+
+	lwsl_user("Completed: %s\n", e ? "FAIL" : "PASS");
+
+	return e;
+}
@@ -0,0 +1,340 @@
+/*
+ * lws-minimal-http-server-h2-priority
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This serves a large and a small file over h2 on loopback, and fetches them
+ * with an lws client in the same process, on the same h2 connection.  Once the
+ * large one is well under way, it asks for the small one with an RFC9218
+ * "priority: u=0" header, and measures how long it took to see the first
+ * byte of the response body, and the whole thing.
+ *
+ * It does it first with the default round-robin stream scheduling, and then
+ * again with LWS_SERVER_OPTION_H2_PRIORITY on the vhost.
+ */
+
+#include <libwebsockets.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+struct req {
+	lws_usec_t		start;
+	lws_usec_t		ttfb;
+	lws_usec_t		end;
+	size_t			rx;
+	size_t			expected;
+	int			done;
+	int			fail;
+};
+
+static struct req big, small;
+static size_t file_size = 100 * 1024 * 1024, small_size = 16 * 1024;
+static int port = 7695, want_small;
+static struct lws_context *context;
+static char dir[64];
+
+static const struct lws_protocol_vhost_options pvo_mime = {
+	NULL, NULL, ".bin", "application/octet-stream"
+};
+
+static const struct lws_http_mount mount = {
+	/* .mount_next */		NULL,		/* linked-list "next" */
+	/* .mountpoint */		"/",		/* mountpoint URL */
+	/* .origin */			dir,		/* serve from dir */
+	/* .def */			"big.bin",	/* default filename */
+	/* .protocol */			NULL,
+	/* .cgienv */			NULL,
+	/* .extra_mimetypes */		&pvo_mime,
+	/* .interpret */		NULL,
+	/* .cgi_timeout */		0,
+	/* .cache_max_age */		0,
+	/* .auth_mask */		0,
+	/* .cache_reusable */		0,
+	/* .cache_revalidate */		0,
+	/* .cache_intermediaries */	0,
+	/* .cache_no */			0,
+	/* .origin_protocol */		LWSMPRO_FILE,	/* files in a dir */
+	/* .mountpoint_len */		1,		/* char count */
+	/* .basic_auth_login_file */	NULL,
+};
+
+static int
+callback_prio(struct lws *wsi, enum lws_callback_reasons reason,
+	      void *user, void *in, size_t len)
+{
+	struct req *r = (struct req *)lws_get_opaque_user_data(wsi);
+
+	switch (reason) {
+
+	/* the client side */
+
+	case LWS_CALLBACK_CLIENT_APPEND_HANDSHAKE_HEADER:
+		if (r == &small) {
+			unsigned char **p = (unsigned char **)in,
+				      *end = (*p) + len;
+
+			if (lws_add_http_header_by_token(wsi,
+					WSI_TOKEN_HTTP_PRIORITY,
+					(unsigned char *)"u=0", 3, p, end))
+				return -1;
+		}
+		break;
+
+	case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
+		lwsl_err("CLIENT_CONNECTION_ERROR: %s\n",
+			 in ? (char *)in : "(null)");
+		if (r) {
+			r->fail = 1;
+			r->done = 1;
+		}
+		lws_cancel_service(lws_get_context(wsi));
+		break;
+
+	case LWS_CALLBACK_RECEIVE_CLIENT_HTTP_READ:
+		if (!r)
+			return 0;
+		if (!r->ttfb)
+			r->ttfb = lws_now_usecs();
+		r->rx += len;
+		if (r == &big && !want_small && big.rx >= file_size / 8) {
+			/* the big one is well under way, ask for the small */
+			want_small = 1;
+			lws_cancel_service(lws_get_context(wsi));
+		}
+		return 0;
+
+	case LWS_CALLBACK_RECEIVE_CLIENT_HTTP:
+		{
+			char buffer[16384 + LWS_PRE];
+			char *px = buffer + LWS_PRE;
+			int lenx = sizeof(buffer) - LWS_PRE;
+
+			if (lws_http_client_read(wsi, &px, &lenx) < 0)
+				return -1;
+		}
+		return 0;
+
+	case LWS_CALLBACK_COMPLETED_CLIENT_HTTP:
+		if (r) {
+			r->end = lws_now_usecs();
+			r->done = 1;
+		}
+		lws_cancel_service(lws_get_context(wsi));
+		break;
+
+	case LWS_CALLBACK_CLOSED_CLIENT_HTTP:
+		if (r && !r->done) {
+			r->fail = 1;
+			r->done = 1;
+		}
+		lws_cancel_service(lws_get_context(wsi));
+		break;
+
+	default:
+		break;
+	}
+
+	return lws_callback_http_dummy(wsi, reason, user, in, len);
+}
+
+static const struct lws_protocols protocols[] = {
+	{ "http", callback_prio, 0, 0, 0, NULL, 0 },
+	LWS_PROTOCOL_LIST_TERM
+};
+
+static int
+make_file(const char *name, size_t size)
+{
+	uint8_t buf[4096];
+	size_t n, done = 0;
+	char path[128];
+	int fd;
+
+	lws_snprintf(path, sizeof(path), "%s/%s", dir, name);
+
+	for (n = 0; n < sizeof(buf); n++)
+		buf[n] = (uint8_t)(n * 13);
+
+	fd = open(path, O_CREAT | O_TRUNC | O_WRONLY, 0600);
+	if (fd < 0)
+		return 1;
+
+	while (done < size) {
+		n = size - done;
+		if (n > sizeof(buf))
+			n = sizeof(buf);
+		if (write(fd, buf, n) != (ssize_t)n) {
+			close(fd);
+			return 1;
+		}
+		done += n;
+	}
+
+	close(fd);
+
+	return 0;
+}
+
+static int
+start(struct req *r, const char *path, size_t expected)
+{
+	struct lws_client_connect_info i;
+
+	memset(r, 0, sizeof(*r));
+	r->expected = expected;
+
+	memset(&i, 0, sizeof i); /* otherwise uninitialized garbage */
+	i.context = context;
+	i.ssl_connection = LCCSCF_USE_SSL | LCCSCF_ALLOW_SELFSIGNED |
+			   LCCSCF_SKIP_SERVER_CERT_HOSTNAME_CHECK |
+			   LCCSCF_PIPELINE;
+	i.port = port;
+	i.address = "localhost";
+	i.path = path;
+	i.host = i.address;
+	i.origin = i.address;
+	i.method = "GET";
+	i.alpn = "h2";
+	i.protocol = protocols[0].name;
+	i.opaque_user_data = r;
+
+	r->start = lws_now_usecs();
+	if (!lws_client_connect_via_info(&i)) {
+		lwsl_err("%s: client connect failed\n", __func__);
+		return 1;
+	}
+
+	return 0;
+}
+
+static int
+run_pass(int prio)
+{
+	struct lws_context_creation_info info;
+	lws_usec_t timeout;
+	int e = 1;
+
+	want_small = 0;
+	memset(&small, 0, sizeof(small));
+
+	memset(&info, 0, sizeof info); /* otherwise uninitialized garbage */
+	info.port = port;
+	info.mounts = &mount;
+	info.protocols = protocols;
+	info.options = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
+	if (prio)
+		info.options |= LWS_SERVER_OPTION_H2_PRIORITY;
+	info.ssl_cert_filepath = "localhost-100y.cert";
+	info.ssl_private_key_filepath = "localhost-100y.key";
+
+	context = lws_create_context(&info);
+	if (!context) {
+		lwsl_err("lws init failed\n");
+		return 1;
+	}
+
+	if (start(&big, "/big.bin", file_size))
+		goto bail;
+
+	timeout = big.start + (120 * LWS_US_PER_SEC);
+	while ((!big.done || !small.done) && lws_now_usecs() < timeout) {
+		if (lws_service(context, 0) < 0)
+			break;
+		if (want_small == 1) {
+			want_small = 2;
+			if (start(&small, "/small.bin", small_size))
+				break;
+		}
+		if (big.fail || small.fail)
+			break;
+	}
+
+	if (!big.done || !small.done)
+		lwsl_err("%s: timed out\n", __func__);
+	else
+		if (big.fail || small.fail || big.rx != big.expected ||
+		    small.rx != small.expected)
+			lwsl_err("%s: big rx %llu, small rx %llu\n", __func__,
+				 (unsigned long long)big.rx,
+				 (unsigned long long)small.rx);
+		else
+			e = 0;
+
+bail:
+	lws_context_destroy(context);
+
+	return e;
+}
+
+static void
+report(const char *name)
+{
+	lws_usec_t t = big.end - big.start;
+
+	if (!t)
+		t = 1;
+
+	lwsl_user("%s: small ttfb %lldus, done %lldus, big %lluMB/s\n", name,
+		  (long long)(small.ttfb - small.start),
+		  (long long)(small.end - small.start),
+		  (unsigned long long)(((uint64_t)big.rx * LWS_US_PER_SEC) /
+				       ((uint64_t)t * 1024 * 1024)));
+}
+
+int
+main(int argc, const char **argv)
+{
+	int logs = LLL_USER | LLL_ERR | LLL_WARN, e = 1;
+	char path[128];
+	const char *p;
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--size")))
+		file_size = (size_t)atoi(p) * 1024 * 1024;
+
+	if ((p = lws_cmdline_option(argc, argv, "--port")))
+		port = atoi(p);
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS minimal http server h2 priority\n");
+
+	lws_strncpy(dir, "/tmp/lws-h2-prio-XXXXXX", sizeof(dir));
+	if (!mkdtemp(dir)) {
+		lwsl_err("%s: unable to create temp dir\n", __func__);
+		return 1;
+	}
+
+	if (make_file("big.bin", file_size) ||
+	    make_file("small.bin", small_size)) {
+		lwsl_err("%s: unable to create files in %s\n", __func__, dir);
+		goto bail;
+	}
+
+	if (run_pass(0))
+		goto bail;
+	report("round-robin");
+
+	if (run_pass(1))
+		goto bail;
+	report("priority   ");
+
+	e = 0;
+
+bail:
+	lws_snprintf(path, sizeof(path), "%s/big.bin", dir);
+	unlink(path);
+	lws_snprintf(path, sizeof(path), "%s/small.bin", dir);
+	unlink(path);
+	rmdir(dir);
+
+	lwsl_user("Completed: %s\n", e ? "FAIL" : "PASS");
+
+	return e;
+}
@@ -0,0 +1,343 @@
+/*
+ * lws-minimal-http-server-ktls-bench
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This serves a large file over https on loopback and fetches it with an lws
+ * client in the same process, first with the tls done in userspace by
+ * OpenSSL, and then again with LWS_SERVER_OPTION_KTLS.  It reports the
+ * throughput of both and whether the kernel actually took over the tls.
+ *
+ * If the kernel doesn't have the tls ulp (modprobe tls), or the tls library
+ * was built without ktls support, the second pass is just userspace tls
+ * again, which is also reported.  With --require-ktls, that is a failure.
+ */
+
+#include <libwebsockets.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#endif
+
+struct pass {
+	lws_usec_t		start;
+	lws_usec_t		end;
+	size_t			rx;
+	int			ktls_srv;
+	int			ktls_cli;
+	int			done;
+	int			fail;
+};
+
+static struct pass *cur;
+static size_t file_size = 64 * 1024 * 1024;
+static int port = 7690;
+static char dir[64];
+
+static const struct lws_protocol_vhost_options pvo_mime = {
+	NULL, NULL, ".bin", "application/octet-stream"
+};
+
+static const struct lws_http_mount mount = {
+	/* .mount_next */		NULL,		/* linked-list "next" */
+	/* .mountpoint */		"/",		/* mountpoint URL */
+	/* .origin */			dir,		/* serve from dir */
+	/* .def */			"bench.bin",	/* default filename */
+	/* .protocol */			NULL,
+	/* .cgienv */			NULL,
+	/* .extra_mimetypes */		&pvo_mime,
+	/* .interpret */		NULL,
+	/* .cgi_timeout */		0,
+	/* .cache_max_age */		0,
+	/* .auth_mask */		0,
+	/* .cache_reusable */		0,
+	/* .cache_revalidate */		0,
+	/* .cache_intermediaries */	0,
+	/* .cache_no */			0,
+	/* .origin_protocol */		LWSMPRO_FILE,	/* files in a dir */
+	/* .mountpoint_len */		1,		/* char count */
+	/* .basic_auth_login_file */	NULL,
+};
+
+static int
+callback_bench(struct lws *wsi, enum lws_callback_reasons reason,
+	       void *user, void *in, size_t len)
+{
+	switch (reason) {
+
+	/* the server side */
+
+	case LWS_CALLBACK_HTTP_FILE_COMPLETION:
+		cur->ktls_srv = lws_tls_ktls_state(wsi);
+		break;
+
+	/* the client side */
+
+	case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
+		lwsl_err("CLIENT_CONNECTION_ERROR: %s\n",
+			 in ? (char *)in : "(null)");
+		cur->fail = 1;
+		cur->done = 1;
+		lws_cancel_service(lws_get_context(wsi));
+		break;
+
+	case LWS_CALLBACK_ESTABLISHED_CLIENT_HTTP:
+		cur->ktls_cli = lws_tls_ktls_state(wsi);
+		break;
+
+	case LWS_CALLBACK_RECEIVE_CLIENT_HTTP_READ:
+		cur->rx += len;
+		return 0;
+
+	case LWS_CALLBACK_RECEIVE_CLIENT_HTTP:
+		{
+			char buffer[16384 + LWS_PRE];
+			char *px = buffer + LWS_PRE;
+			int lenx = sizeof(buffer) - LWS_PRE;
+
+			if (lws_http_client_read(wsi, &px, &lenx) < 0)
+				return -1;
+		}
+		return 0;
+
+	case LWS_CALLBACK_COMPLETED_CLIENT_HTTP:
+		cur->end = lws_now_usecs();
+		cur->done = 1;
+		lws_cancel_service(lws_get_context(wsi));
+		break;
+
+	case LWS_CALLBACK_CLOSED_CLIENT_HTTP:
+		if (!cur->done) {
+			cur->fail = 1;
+			cur->done = 1;
+		}
+		lws_cancel_service(lws_get_context(wsi));
+		break;
+
+	default:
+		break;
+	}
+
+	return lws_callback_http_dummy(wsi, reason, user, in, len);
+}
+
+static const struct lws_protocols protocols[] = {
+	{ "http", callback_bench, 0, 0, 0, NULL, 0 },
+	LWS_PROTOCOL_LIST_TERM
+};
+
+static int
+make_file(const char *path)
+{
+	uint8_t buf[4096];
+	size_t n, done = 0;
+	int fd;
+
+	for (n = 0; n < sizeof(buf); n++)
+		buf[n] = (uint8_t)(n * 13);
+
+	fd = open(path, O_CREAT | O_TRUNC | O_WRONLY, 0600);
+	if (fd < 0)
+		return 1;
+
+	while (done < file_size) {
+		n = file_size - done;
+		if (n > sizeof(buf))
+			n = sizeof(buf);
+		if (write(fd, buf, n) != (ssize_t)n) {
+			close(fd);
+			return 1;
+		}
+		done += n;
+	}
+
+	close(fd);
+
+	return 0;
+}
+
+static int
+run_pass(struct pass *p, int ktls)
+{
+	struct lws_context_creation_info info;
+	struct lws_client_connect_info i;
+	struct lws_context *context;
+	struct lws *client_wsi;
+	lws_usec_t timeout;
+
+	memset(p, 0, sizeof(*p));
+	cur = p;
+
+	memset(&info, 0, sizeof info); /* otherwise uninitialized garbage */
+	info.port = port;
+	info.mounts = &mount;
+	info.protocols = protocols;
+	info.options = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
+	if (ktls)
+		info.options |= LWS_SERVER_OPTION_KTLS;
+	info.ssl_cert_filepath = "localhost-100y.cert";
+	info.ssl_private_key_filepath = "localhost-100y.key";
+
+	context = lws_create_context(&info);
+	if (!context) {
+		lwsl_err("lws init failed\n");
+		return 1;
+	}
+
+	memset(&i, 0, sizeof i); /* otherwise uninitialized garbage */
+	i.context = context;
+	i.ssl_connection = LCCSCF_USE_SSL | LCCSCF_ALLOW_SELFSIGNED |
+			   LCCSCF_SKIP_SERVER_CERT_HOSTNAME_CHECK;
+	i.port = port;
+	i.address = "localhost";
+	i.path = "/bench.bin";
+	i.host = i.address;
+	i.origin = i.address;
+	i.method = "GET";
+	i.alpn = "http/1.1";
+	i.protocol = protocols[0].name;
+	i.pwsi = &client_wsi;
+
+	p->start = lws_now_usecs();
+	if (!lws_client_connect_via_info(&i)) {
+		lwsl_err("%s: client connect failed\n", __func__);
+		lws_context_destroy(context);
+		return 1;
+	}
+
+	timeout = p->start + (60 * LWS_US_PER_SEC);
+	while (!p->done && lws_now_usecs() < timeout)
+		if (lws_service(context, 0) < 0)
+			break;
+
+	lws_context_destroy(context);
+
+	if (!p->done)
+		lwsl_err("%s: timed out\n", __func__);
+
+	if (!p->done || p->fail || p->rx != file_size) {
+		lwsl_err("%s: rx %llu / %llu\n", __func__,
+			 (unsigned long long)p->rx,
+			 (unsigned long long)file_size);
+		return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Setting the tls ulp on a socket that isn't connected fails with ENOENT if
+ * the kernel doesn't have it, or ENOTCONN from the ulp itself if it does
+ */
+
+static int
+ktls_ulp_available(void)
+{
+#if defined(__linux__) && defined(TCP_ULP)
+	int fd = socket(AF_INET, SOCK_STREAM, 0), n;
+
+	if (fd < 0)
+		return 0;
+
+	n = setsockopt(fd, IPPROTO_TCP, TCP_ULP, "tls", 3) && errno == ENOENT;
+	close(fd);
+
+	return !n;
+#else
+	return 0;
+#endif
+}
+
+static void
+report(const char *name, struct pass *p)
+{
+	lws_usec_t t = p->end - p->start;
+
+	if (!t)
+		t = 1;
+
+	lwsl_user("%s: %lluMB in %lldms, %lluMB/s (server ktls tx %d rx %d, "
+		  "client ktls tx %d rx %d)\n", name,
+		  (unsigned long long)(p->rx / (1024 * 1024)),
+		  (long long)(t / LWS_US_PER_MS),
+		  (unsigned long long)(((uint64_t)p->rx * LWS_US_PER_SEC) /
+				       ((uint64_t)t * 1024 * 1024)),
+		  !!(p->ktls_srv & LWS_TLS_KTLS_TX),
+		  !!(p->ktls_srv & LWS_TLS_KTLS_RX),
+		  !!(p->ktls_cli & LWS_TLS_KTLS_TX),
+		  !!(p->ktls_cli & LWS_TLS_KTLS_RX));
+}
+
+int
+main(int argc, const char **argv)
+{
+	int logs = LLL_USER | LLL_ERR | LLL_WARN, e = 1, require;
+	struct pass user, kernel;
+	char path[128];
+	const char *p;
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--size")))
+		file_size = (size_t)atoi(p) * 1024 * 1024;
+
+	if ((p = lws_cmdline_option(argc, argv, "--port")))
+		port = atoi(p);
+
+	require = !!lws_cmdline_option(argc, argv, "--require-ktls");
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS minimal http server ktls bench\n");
+
+	lws_strncpy(dir, "/tmp/lws-ktls-bench-XXXXXX", sizeof(dir));
+	if (!mkdtemp(dir)) {
+		lwsl_err("%s: unable to create temp dir\n", __func__);
+		return 1;
+	}
+	lws_snprintf(path, sizeof(path), "%s/bench.bin", dir);
+
+	if (make_file(path)) {
+		lwsl_err("%s: unable to create %s\n", __func__, path);
+		goto bail;
+	}
+
+	if (run_pass(&user, 0) || run_pass(&kernel, 1))
+		goto bail;
+
+	report("userspace tls", &user);
+	report("ktls option  ", &kernel);
+
+	if (!(kernel.ktls_srv & LWS_TLS_KTLS_TX)) {
+		if (!ktls_ulp_available())
+			lwsl_user("The kernel has no tls ulp, try modprobe tls\n");
+		else
+			lwsl_user("The kernel has the tls ulp but didn't take "
+				  "the server tx, is OpenSSL built with ktls?\n");
+
+		if (require) {
+			lwsl_err("%s: --require-ktls but no ktls tx\n",
+				 __func__);
+			goto bail;
+		}
+	}
+
+	e = 0;
+
+bail:
+	unlink(path);
+	rmdir(dir);
+
+	lwsl_user("Completed: %s\n", e ? "FAIL" : "PASS");
+
+	return e;
+}
@@ -0,0 +1,590 @@
+/*
+ * lws-minimal-http-server-precompressed
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This serves a directory of files with precompressed .br and .gz sidecars
+ * from a vhost with LWS_SERVER_OPTION_VH_HTTP_PRECOMPRESSED, and fetches them
+ * with an lws client in the same process using a series of different
+ * Accept-Encoding: headers.  It checks each response has the expected status,
+ * Content-Encoding:, ETag:, Vary: and body.
+ *
+ * If lws was built with both LWS_WITH_HTTP_STREAM_COMPRESSION and
+ * LWS_WITH_DISKCACHE, the vhost also has a compression cache, and it checks
+ * a file without sidecars is compressed into the cache once, served from it
+ * after that, and that a transfer abandoned partway doesn't leave anything in
+ * the cache.
+ */
+
+#include <libwebsockets.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+
+#if defined(LWS_WITH_HTTP_STREAM_COMPRESSION) && defined(LWS_WITH_DISKCACHE)
+#define COMP_CACHE
+#endif
+
+struct tcase {
+	const char	*path;
+	const char	*accept;	/* Accept-Encoding: to send */
+	const char	*etag_of;	/* fixture the ETag: comes from, or NULL
+					 * for the compression cache file */
+	const char	*enc;		/* Content-Encoding: we expect, or NULL */
+	int		status;
+	char		tagged;		/* ETag: has the encoding appended */
+	char		inm;		/* send If-None-Match: with last ETag: */
+	char		hangup;		/* hang up after the first body */
+	char		clen;		/* expect a Content-Length: */
+	char		body;		/* body must be etag_of's content */
+};
+
+static const struct tcase cases[] = {
+	/* equal q, brotli wins */
+	{ "/data.json", "gzip, br", "data.json.br", "br", 200, 1, 0, 0, 1, 1 },
+	/* the same representation revalidates, with Vary: on the 304 */
+	{ "/data.json", "gzip, br", "data.json.br", "br", 304, 1, 1, 0, 0, 0 },
+	/* the br ETag: doesn't match the gzip representation */
+	{ "/data.json", "gzip", "data.json.gz", "gzip", 200, 1, 1, 0, 1, 1 },
+	{ "/data.json", "gzip;q=1.0, br;q=0.5",
+				"data.json.gz", "gzip", 200, 1, 0, 0, 1, 1 },
+	{ "/data.json", "br;q=0, gzip",
+				"data.json.gz", "gzip", 200, 1, 0, 0, 1, 1 },
+	{ "/data.json", "*;q=0.1", "data.json.br", "br", 200, 1, 0, 0, 1, 1 },
+	{ "/data.json", "br;q=0, *",
+				"data.json.gz", "gzip", 200, 1, 0, 0, 1, 1 },
+	{ "/data.json", "identity", "data.json", NULL, 200, 0, 0, 0, 1, 1 },
+	{ "/data.json", "br;q=0, gzip;q=0.000",
+				"data.json", NULL, 200, 0, 0, 0, 1, 1 },
+	/* the .br sidecar is older than the file, so it must be ignored */
+	{ "/stale.json", "br, gzip",
+				"stale.json.gz", "gzip", 200, 1, 0, 0, 1, 1 },
+	{ "/stale.json", "br", "stale.json", NULL, 200, 0, 0, 0, 1, 1 },
+#if defined(COMP_CACHE)
+	/* hanging up partway through compressing abandons the cache file */
+	{ "/big.txt", "deflate", "big.txt", "deflate", 200, 0, 0, 1, 0, 0 },
+	/* compressed on the fly, and the output kept in the cache */
+	{ "/big.txt", "deflate", "big.txt", "deflate", 200, 0, 0, 0, 0, 0 },
+	/* served from the cache, with a length and its own ETag: */
+	{ "/big.txt", "deflate", NULL, "deflate", 200, 1, 0, 0, 1, 0 },
+	{ "/big.txt", "deflate", NULL, "deflate", 304, 1, 1, 0, 0, 0 },
+#endif
+};
+
+struct result {
+	char		rx[256];
+	size_t		rxlen;
+	int		done;
+};
+
+static struct result results[LWS_ARRAY_SIZE(cases)];
+static int port = 7706, cur, finished, failed;
+static struct lws_context *context;
+static lws_sorted_usec_list_t sul_next;
+static char dir[64], etag[64];
+static time_t mtime;
+
+static const struct lws_http_mount mount = {
+	/* .mount_next */		NULL,		/* linked-list "next" */
+	/* .mountpoint */		"/",		/* mountpoint URL */
+	/* .origin */			dir,		/* serve from dir */
+	/* .def */			"data.json",	/* default filename */
+	/* .protocol */			NULL,
+	/* .cgienv */			NULL,
+	/* .extra_mimetypes */		NULL,
+	/* .interpret */		NULL,
+	/* .cgi_timeout */		0,
+	/* .cache_max_age */		0,
+	/* .auth_mask */		0,
+	/* .cache_reusable */		0,
+	/* .cache_revalidate */		0,
+	/* .cache_intermediaries */	0,
+	/* .cache_no */			0,
+	/* .origin_protocol */		LWSMPRO_FILE,	/* files in a dir */
+	/* .mountpoint_len */		1,		/* char count */
+	/* .basic_auth_login_file */	NULL,
+};
+
+static int
+make_file(const char *name, const char *content, size_t len, time_t t)
+{
+	struct timeval tv[2];
+	char path[128];
+	int fd, n;
+
+	lws_snprintf(path, sizeof(path), "%s/%s", dir, name);
+
+	fd = open(path, O_CREAT | O_TRUNC | O_WRONLY, 0600);
+	if (fd < 0)
+		return 1;
+
+	n = write(fd, content, len) != (ssize_t)len;
+	close(fd);
+
+	/* the sidecars are only used if they're not older than the file */
+
+	memset(tv, 0, sizeof(tv));
+	tv[0].tv_sec = tv[1].tv_sec = t;
+
+	return n || utimes(path, tv);
+}
+
+static int
+load_file(const char *name, char *buf, size_t len, size_t *flen)
+{
+	char path[128];
+	ssize_t n;
+	int fd;
+
+	lws_snprintf(path, sizeof(path), "%s/%s", dir, name);
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return 1;
+	n = read(fd, buf, len);
+	close(fd);
+	if (n < 0)
+		return 1;
+
+	*flen = (size_t)n;
+
+	return 0;
+}
+
+#if defined(COMP_CACHE)
+
+/*
+ * Big enough that the server can't have finished sending it by the time the
+ * client sees the first part and hangs up, and not too compressible
+ */
+
+static int
+make_big(const char *name, size_t size, time_t t)
+{
+	char *buf = malloc(size);
+	uint32_t seed = 0x12345678;
+	size_t n;
+	int r;
+
+	if (!buf)
+		return 1;
+
+	for (n = 0; n < size; n++) {
+		seed = seed * 1103515245u + 12345u;
+		buf[n] = (char)((seed >> 24) % 28 < 26 ?
+				'a' + (seed >> 24) % 28 : (n & 1 ? ' ' : '\n'));
+	}
+
+	r = make_file(name, buf, size, t);
+	free(buf);
+
+	return r;
+}
+
+#endif
+
+/* count (or delete) the files under d, and the temp ones with ~ in the name */
+
+static int
+scan(const char *d, int *temps, int del)
+{
+	struct dirent *de;
+	char path[256];
+	struct stat s;
+	int count = 0;
+	DIR *dp;
+
+	dp = opendir(d);
+	if (!dp)
+		return 0;
+
+	while ((de = readdir(dp))) {
+		if (de->d_name[0] == '.')
+			continue;
+		lws_snprintf(path, sizeof(path), "%s/%s", d, de->d_name);
+		if (stat(path, &s))
+			continue;
+		if ((s.st_mode & S_IFMT) == S_IFDIR) {
+			count += scan(path, temps, del);
+			if (del)
+				rmdir(path);
+			continue;
+		}
+		if (strchr(de->d_name, '~'))
+			(*temps)++;
+		else
+			count++;
+		if (del)
+			unlink(path);
+	}
+
+	closedir(dp);
+
+	return count;
+}
+
+static int
+check_headers(struct lws *wsi, const struct tcase *c)
+{
+	char v[128], exp[64];
+	size_t flen;
+	struct stat s;
+	int st;
+
+	st = (int)lws_http_client_http_response(wsi);
+	if (st != c->status) {
+		lwsl_err("%s: status %d\n", __func__, st);
+		return 1;
+	}
+
+	if (lws_hdr_copy(wsi, v, sizeof(v),
+			 WSI_TOKEN_HTTP_CONTENT_ENCODING) < 0 ||
+	    strcmp(v, st == 304 || !c->enc ? "" : c->enc)) {
+		lwsl_err("%s: content-encoding '%s'\n", __func__, v);
+		return 1;
+	}
+
+	if (lws_hdr_copy(wsi, v, sizeof(v), WSI_TOKEN_HTTP_VARY) < 0 ||
+	    strcmp(v, "Accept-Encoding")) {
+		lwsl_err("%s: vary '%s'\n", __func__, v);
+		return 1;
+	}
+
+	if (!lws_hdr_total_length(wsi, WSI_TOKEN_HTTP_CONTENT_LENGTH) !=
+								!c->clen) {
+		lwsl_err("%s: content-length %s\n", __func__,
+			 c->clen ? "missing" : "unexpected");
+		return 1;
+	}
+
+	/* the ETag: is made from the length and mtime of what is served */
+
+	if (c->etag_of) {
+		lws_snprintf(v, sizeof(v), "%s/%s", dir, c->etag_of);
+		if (stat(v, &s))
+			return 1;
+		flen = (size_t)s.st_size;
+	} else {
+		if (st == 304)
+			/* no length with this, but it's still the last one */
+			flen = (size_t)strtoull(etag, NULL, 16) >> 32;
+		else {
+			if (lws_hdr_copy(wsi, v, sizeof(v),
+					 WSI_TOKEN_HTTP_CONTENT_LENGTH) < 0)
+				return 1;
+			flen = (size_t)atoll(v);
+		}
+	}
+
+	lws_snprintf(exp, sizeof(exp), "%08llX%08lX%s%s",
+		     (unsigned long long)flen, (unsigned long)mtime,
+		     c->tagged ? "-" : "", c->tagged ? c->enc : "");
+
+	if (lws_hdr_copy(wsi, etag, sizeof(etag), WSI_TOKEN_HTTP_ETAG) < 0 ||
+	    strcmp(etag, exp)) {
+		lwsl_err("%s: etag '%s', expected '%s'\n", __func__, etag, exp);
+		return 1;
+	}
+
+	return 0;
+}
+
+static void
+next_case(lws_sorted_usec_list_t *sul);
+
+static void
+case_done(struct result *r)
+{
+	const struct tcase *c = &cases[r - results];
+
+	if (r->done)
+		return;
+	r->done = 1;
+
+	if (c->body && c->status == 200) {
+		char b[256];
+		size_t flen;
+
+		if (load_file(c->etag_of, b, sizeof(b), &flen) ||
+		    flen != r->rxlen || memcmp(b, r->rx, flen)) {
+			lwsl_err("%s: %s: body mismatch\n", __func__, c->path);
+			failed = 1;
+		}
+	}
+
+	lwsl_user("%-11s %-22s -> %d %s%s\n", c->path, c->accept, c->status,
+		  c->enc ? c->enc : "identity", failed ? ": FAIL" : "");
+
+	/* give the server time to notice a hangup before we go on */
+
+	lws_sul_schedule(context, 0, &sul_next, next_case,
+			 c->hangup ? 200 * LWS_US_PER_MS : 1);
+	lws_cancel_service(context);
+}
+
+static int
+callback_precomp(struct lws *wsi, enum lws_callback_reasons reason,
+		 void *user, void *in, size_t len)
+{
+	struct result *r = (struct result *)lws_get_opaque_user_data(wsi);
+	const struct tcase *c = r ? &cases[r - results] : NULL;
+	int rcvbuf;
+
+	switch (reason) {
+
+	/* the client side */
+
+	case LWS_CALLBACK_CONNECTING:
+		if (c && c->hangup) {
+			/* so the server can't send it all before we hang up */
+			rcvbuf = 4096;
+			setsockopt((int)(intptr_t)in, SOL_SOCKET, SO_RCVBUF,
+				   (const void *)&rcvbuf, sizeof(rcvbuf));
+		}
+		break;
+
+	case LWS_CALLBACK_CLIENT_APPEND_HANDSHAKE_HEADER:
+		if (c) {
+			unsigned char **p = (unsigned char **)in,
+				      *end = (*p) + len;
+
+			if (lws_add_http_header_by_token(wsi,
+					WSI_TOKEN_HTTP_ACCEPT_ENCODING,
+					(unsigned char *)c->accept,
+					(int)strlen(c->accept), p, end))
+				return -1;
+
+			if (c->inm && lws_add_http_header_by_token(wsi,
+					WSI_TOKEN_HTTP_IF_NONE_MATCH,
+					(unsigned char *)etag,
+					(int)strlen(etag), p, end))
+				return -1;
+		}
+		break;
+
+	case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
+		lwsl_err("CLIENT_CONNECTION_ERROR: %s\n",
+			 in ? (char *)in : "(null)");
+		failed = 1;
+		lws_cancel_service(lws_get_context(wsi));
+		break;
+
+	case LWS_CALLBACK_ESTABLISHED_CLIENT_HTTP:
+		if (!c)
+			break;
+		if (check_headers(wsi, c)) {
+			lwsl_err("%s: %s, Accept-Encoding: %s\n", __func__,
+				 c->path, c->accept);
+			failed = 1;
+		}
+		if (c->status == 304) {
+			/* there's no body, we're done with it */
+			case_done(r);
+			lws_set_timeout(wsi, PENDING_TIMEOUT_USER_OK,
+					LWS_TO_KILL_ASYNC);
+		}
+		break;
+
+	case LWS_CALLBACK_RECEIVE_CLIENT_HTTP_READ:
+		if (!r || r->done)
+			return 0;
+		if (c->hangup) {
+			/* the server is still going, abandon it partway */
+			case_done(r);
+			return -1;
+		}
+		if (r->rxlen + len > sizeof(r->rx))
+			len = sizeof(r->rx) - r->rxlen;
+		memcpy(r->rx + r->rxlen, in, len);
+		r->rxlen += len;
+		return 0;
+
+	case LWS_CALLBACK_RECEIVE_CLIENT_HTTP:
+		{
+			char buffer[4096 + LWS_PRE];
+			char *px = buffer + LWS_PRE;
+			int lenx = sizeof(buffer) - LWS_PRE;
+
+			if (lws_http_client_read(wsi, &px, &lenx) < 0)
+				return -1;
+		}
+		return 0;
+
+	case LWS_CALLBACK_COMPLETED_CLIENT_HTTP:
+		if (r)
+			case_done(r);
+		break;
+
+	case LWS_CALLBACK_CLOSED_CLIENT_HTTP:
+		if (r && !r->done) {
+			lwsl_err("%s: %s closed early\n", __func__, c->path);
+			failed = 1;
+			lws_cancel_service(lws_get_context(wsi));
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	return lws_callback_http_dummy(wsi, reason, user, in, len);
+}
+
+static const struct lws_protocols protocols[] = {
+	{ "http", callback_precomp, 0, 0, 0, NULL, 0 },
+	LWS_PROTOCOL_LIST_TERM
+};
+
+static void
+next_case(lws_sorted_usec_list_t *sul)
+{
+	struct lws_client_connect_info i;
+#if defined(COMP_CACHE)
+	char path[128];
+	int temps = 0;
+
+	if (cur && cases[cur - 1].hangup) {
+		lws_snprintf(path, sizeof(path), "%s/cache", dir);
+		if (scan(path, &temps, 0) || temps) {
+			lwsl_err("%s: abandoned cache file left behind\n",
+				 __func__);
+			failed = 1;
+			return;
+		}
+	}
+#endif
+
+	if (failed || cur == (int)LWS_ARRAY_SIZE(cases)) {
+		finished = 1;
+		return;
+	}
+
+	memset(&i, 0, sizeof i); /* otherwise uninitialized garbage */
+	i.context = context;
+	i.port = port;
+	i.address = "localhost";
+	i.path = cases[cur].path;
+	i.host = i.address;
+	i.origin = i.address;
+	i.method = "GET";
+	i.protocol = protocols[0].name;
+	i.opaque_user_data = &results[cur++];
+
+	if (!lws_client_connect_via_info(&i)) {
+		lwsl_err("%s: client connect failed\n", __func__);
+		failed = 1;
+	}
+}
+
+int
+main(int argc, const char **argv)
+{
+	int logs = LLL_USER | LLL_ERR | LLL_WARN, e = 1, temps = 0;
+	struct lws_context_creation_info info;
+	lws_usec_t timeout;
+	static const char
+		data[] = "{\"representation\": \"identity\"}\n",
+		br[] = "not really brotli, but the .br sidecar\n",
+		gz[] = "not really gzip, but the .gz sidecar\n";
+	const char *p;
+#if defined(COMP_CACHE)
+	char cache[80];
+	int finals;
+#endif
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--port")))
+		port = atoi(p);
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS minimal http server precompressed\n");
+
+	lws_strncpy(dir, "/tmp/lws-precomp-XXXXXX", sizeof(dir));
+	if (!mkdtemp(dir)) {
+		lwsl_err("%s: unable to create temp dir\n", __func__);
+		return 1;
+	}
+
+	/*
+	 * The sidecars don't have to really be compressed, since the client
+	 * doesn't decode them, it's enough that they are different.  json
+	 * isn't compressed on the fly, so that can't get involved either.
+	 */
+
+	mtime = time(NULL) - 1000;
+	if (make_file("data.json", data, sizeof(data) - 1, mtime) ||
+	    make_file("data.json.br", br, sizeof(br) - 1, mtime) ||
+	    make_file("data.json.gz", gz, sizeof(gz) - 1, mtime) ||
+	    make_file("stale.json", data, sizeof(data) - 1, mtime) ||
+	    make_file("stale.json.br", br, sizeof(br) - 1, mtime - 100) ||
+	    make_file("stale.json.gz", gz, sizeof(gz) - 1, mtime)
+#if defined(COMP_CACHE)
+	    || make_big("big.txt", 2 * 1024 * 1024, mtime)
+#endif
+	   ) {
+		lwsl_err("%s: unable to create files in %s\n", __func__, dir);
+		goto bail1;
+	}
+
+	memset(&info, 0, sizeof info); /* otherwise uninitialized garbage */
+	info.port = port;
+	info.mounts = &mount;
+	info.protocols = protocols;
+	info.options = LWS_SERVER_OPTION_VH_HTTP_PRECOMPRESSED;
+#if defined(COMP_CACHE)
+	lws_snprintf(cache, sizeof(cache), "%s/cache", dir);
+	info.http_compression_cache_dir = cache;
+#endif
+
+	context = lws_create_context(&info);
+	if (!context) {
+		lwsl_err("lws init failed\n");
+		goto bail1;
+	}
+
+	next_case(&sul_next);
+
+	timeout = lws_now_usecs() + (30 * LWS_US_PER_SEC);
+	while (!finished && !failed && lws_now_usecs() < timeout)
+		if (lws_service(context, 0) < 0)
+			break;
+
+	if (!finished || failed) {
+		lwsl_err("%s: %d of %d cases ok\n", __func__, cur - 1,
+			 (int)LWS_ARRAY_SIZE(cases));
+		goto bail;
+	}
+
+#if defined(COMP_CACHE)
+	/* the one finished compression is all that was kept */
+
+	finals = scan(cache, &temps, 0);
+	if (finals != 1 || temps) {
+		lwsl_err("%s: %d cache files, %d temp\n", __func__, finals,
+			 temps);
+		goto bail;
+	}
+#endif
+
+	e = 0;
+
+bail:
+	lws_context_destroy(context);
+bail1:
+	scan(dir, &temps, 1);
+	rmdir(dir);
+
+	lwsl_user("Completed: %s\n", e ? "FAIL" : "PASS");
+
+	return e;
+}
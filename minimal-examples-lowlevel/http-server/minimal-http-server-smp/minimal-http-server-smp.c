@@ -16,8 +16,17 @@
  * the real number of threads possible is decided by the LWS_MAX_SMP that lws
  * was configured with, by default that is 1.  Lws will limit the number of
  * requested threads to the number possible.
+ *
+ * With --bench, instead of serving forever it measures how many connections
+ * per second it can accept and serve with 1, then 2... up to the number of
+ * service threads, using blocking client threads as the load.  --shard and
+ * --steer select LWS_SERVER_OPTION_SMP_LISTEN_SHARD and
+ * LWS_SERVER_OPTION_SMP_LISTEN_STEER_CPU, --pin pins service thread n to cpu n.
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
 #include <libwebsockets.h>
 #include <string.h>
 #include <signal.h>
@@ -26,13 +35,26 @@
 #if defined(pid_t)
 #undef pid_t
 #endif
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
 #endif
 #include <pthread.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
 #define COUNT_THREADS 8
 
 static struct lws_context *context;
-static int interrupted;
+static int interrupted, pin;
+
+#if !defined(WIN32)
+static pthread_mutex_t lock_count = PTHREAD_MUTEX_INITIALIZER;
+static int bench_done, bench_port = 7681, per_tsi[LWS_MAX_SMP];
+static unsigned int bench_conns;
 
 static const struct lws_http_mount mount = {
 	/* .mount_next */		NULL,		/* linked-list "next" */
@@ -55,8 +77,94 @@ static const struct lws_http_mount mount = {
 	/* .basic_auth_login_file */	NULL,
 };
 
+/*
+ * We just want to count the new server connections each service thread got
+ */
+
+static int
+callback_count(struct lws *wsi, enum lws_callback_reasons reason,
+	       void *user, void *in, size_t len)
+{
+	if (reason == LWS_CALLBACK_WSI_CREATE && lws_get_tsi(wsi) < LWS_MAX_SMP) {
+		pthread_mutex_lock(&lock_count);
+		per_tsi[lws_get_tsi(wsi)]++;
+		pthread_mutex_unlock(&lock_count);
+	}
+
+	return lws_callback_http_dummy(wsi, reason, user, in, len);
+}
+
+static const struct lws_protocols protocols[] = {
+	{ "http", callback_count, 0, 0, 0, NULL, 0 },
+	LWS_PROTOCOL_LIST_TERM
+};
+
+/*
+ * Each load thread does connect, GET /, read until the server closes, as fast
+ * as it can until we tell it to stop
+ */
+
+static void *
+thread_load(void *d)
+{
+	static const char req[] = "GET / HTTP/1.1\r\nHost: 127.0.0.1\r\n"
+				  "Connection: close\r\n\r\n";
+	struct sockaddr_in sin;
+	unsigned int count = 0;
+	char buf[4096];
+	int fd;
+
+	memset(&sin, 0, sizeof(sin));
+	sin.sin_family = AF_INET;
+	sin.sin_port = htons((uint16_t)bench_port);
+	sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	while (!bench_done) {
+		fd = socket(AF_INET, SOCK_STREAM, 0);
+		if (fd < 0)
+			break;
+
+		if (connect(fd, (struct sockaddr *)&sin, sizeof(sin)) ||
+		    write(fd, req, sizeof(req) - 1) != (ssize_t)sizeof(req) - 1) {
+			close(fd);
+			continue;
+		}
+
+		while (read(fd, buf, sizeof(buf)) > 0)
+			;
+
+		close(fd);
+		count++;
+	}
+
+	pthread_mutex_lock(&lock_count);
+	bench_conns += count;
+	pthread_mutex_unlock(&lock_count);
+
+	return NULL;
+}
+#endif
+
+static void
+pin_thread(int n)
+{
+#if defined(__linux__)
+	cpu_set_t cs;
+
+	if (!pin)
+		return;
+
+	CPU_ZERO(&cs);
+	CPU_SET((size_t)n, &cs);
+	if (pthread_setaffinity_np(pthread_self(), sizeof(cs), &cs))
+		lwsl_warn("%s: unable to pin thread %d\n", __func__, n);
+#endif
+}
+
 void *thread_service(void *threadid)
 {
+	pin_thread((int)(lws_intptr_t)threadid);
+
 	while (lws_service_tsi(context, 10000,
 			       (int)(lws_intptr_t)threadid) >= 0 &&
 	       !interrupted)
@@ -73,13 +181,92 @@ void sigint_handler(int sig)
 	lws_cancel_service(context);
 }
 
+static void
+start_service_threads(pthread_t *pts)
+{
+	int n;
+
+	for (n = 0; n < lws_get_count_threads(context); n++)
+		if (pthread_create(&pts[n], NULL, thread_service,
+				   (void *)(lws_intptr_t)n))
+			lwsl_err("Failed to start service thread\n");
+}
+
+static void
+join_service_threads(pthread_t *pts)
+{
+	int n = lws_get_count_threads(context);
+	void *retval;
+
+	while ((--n) >= 0)
+		pthread_join(pts[n], &retval);
+}
+
+#if !defined(WIN32)
+static int
+bench(struct lws_context_creation_info *info, int max_threads, int clients,
+      int secs)
+{
+	pthread_t pthread_service[COUNT_THREADS], pthread_load[64];
+	char dist[128];
+	int t, n, m;
+
+	info->protocols = protocols;
+	bench_port = info->port;
+
+	if (clients > (int)LWS_ARRAY_SIZE(pthread_load))
+		clients = (int)LWS_ARRAY_SIZE(pthread_load);
+	if (max_threads > LWS_MAX_SMP)
+		max_threads = LWS_MAX_SMP;
+
+	for (t = 1; t <= max_threads; t++) {
+		info->count_threads = (unsigned int)t;
+		memset(per_tsi, 0, sizeof(per_tsi));
+		bench_conns = 0;
+		bench_done = 0;
+		interrupted = 0;
+
+		context = lws_create_context(info);
+		if (!context) {
+			lwsl_err("lws init failed\n");
+			return 1;
+		}
+
+		start_service_threads(pthread_service);
+
+		for (n = 0; n < clients; n++)
+			pthread_create(&pthread_load[n], NULL, thread_load, NULL);
+
+		sleep((unsigned int)secs);
+		bench_done = 1;
+
+		for (n = 0; n < clients; n++)
+			pthread_join(pthread_load[n], NULL);
+
+		interrupted = 1;
+		lws_cancel_service(context);
+		join_service_threads(pthread_service);
+		lws_context_destroy(context);
+
+		dist[0] = '\0';
+		for (n = 0, m = 0; n < t; n++)
+			m += lws_snprintf(dist + m, sizeof(dist) - (size_t)m,
+					  " %d", per_tsi[n]);
+
+		lwsl_user("%d service threads: %u conn/s, per thread:%s\n", t,
+			  bench_conns / (unsigned int)secs, dist);
+	}
+
+	return 0;
+}
+#endif
+
 int main(int argc, const char **argv)
 {
 	pthread_t pthread_service[COUNT_THREADS];
 	struct lws_context_creation_info info;
-	void *retval;
 	const char *p;
-	int n = 0, logs = LLL_USER | LLL_ERR | LLL_WARN | LLL_NOTICE
+	int logs = LLL_USER | LLL_ERR | LLL_WARN | LLL_NOTICE
 			/* for LLL_ verbosity above NOTICE to be built into lws,
 			 * lws must have been configured and built with
 			 * -DCMAKE_BUILD_TYPE=DEBUG instead of =RELEASE */
@@ -107,14 +294,34 @@ int main(int argc, const char **argv)
 	} else
 		info.count_threads = COUNT_THREADS;
 
+	if (lws_cmdline_option(argc, argv, "--shard"))
+		info.options |= LWS_SERVER_OPTION_SMP_LISTEN_SHARD;
+	if (lws_cmdline_option(argc, argv, "--steer"))
+		info.options |= LWS_SERVER_OPTION_SMP_LISTEN_SHARD |
+				LWS_SERVER_OPTION_SMP_LISTEN_STEER_CPU;
+	pin = !!lws_cmdline_option(argc, argv, "--pin");
+
 #if defined(LWS_WITH_TLS)
 	if (lws_cmdline_option(argc, argv, "-s")) {
-		info.options = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
+		info.options |= LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
 		info.ssl_cert_filepath = "localhost-100y.cert";
 		info.ssl_private_key_filepath = "localhost-100y.key";
 	}
 #endif
 
+#if !defined(WIN32)
+	if (lws_cmdline_option(argc, argv, "--bench")) {
+		int clients = 8, secs = 3;
+
+		if ((p = lws_cmdline_option(argc, argv, "--clients")))
+			clients = atoi(p);
+		if ((p = lws_cmdline_option(argc, argv, "--secs")))
+			secs = atoi(p);
+
+		return bench(&info, (int)info.count_threads, clients, secs);
+	}
+#endif
+
 	context = lws_create_context(&info);
 	if (!context) {
 		lwsl_err("lws init failed\n");
@@ -125,15 +332,11 @@ int main(int argc, const char **argv)
 
 	/* start all the service threads */
 
-	for (n = 0; n < lws_get_count_threads(context); n++)
-		if (pthread_create(&pthread_service[n], NULL, thread_service,
-				   (void *)(lws_intptr_t)n))
-			lwsl_err("Failed to start service thread\n");
+	start_service_threads(pthread_service);
 
 	/* wait for all the service threads to exit */
 
-	while ((--n) >= 0)
-		pthread_join(pthread_service[n], &retval);
+	join_service_threads(pthread_service);
 
 	lws_context_destroy(context);
 
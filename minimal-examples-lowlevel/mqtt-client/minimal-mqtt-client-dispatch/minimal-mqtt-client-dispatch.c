@@ -0,0 +1,409 @@
+/*
+ * lws-minimal-mqtt-client-dispatch
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This measures how fast lws dispatches incoming PUBLISH to a client holding
+ * many subscriptions, some with "+" and "#" wildcards.
+ *
+ * So it doesn't need a real broker, it runs a tiny fake one on a raw listen
+ * socket in the same process.  That acks the client's SUBSCRIBEs, and when
+ * it has seen them all, sends a stream of QoS0 PUBLISH, a quarter of which
+ * match none of the subscriptions, and the rest match an exact, "+" or "#"
+ * subscription.  The client checks it got exactly the ones that match.
+ */
+
+#include <libwebsockets.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <signal.h>
+
+/* lws takes at most this many topics per SUBSCRIBE */
+#define TOPICS_PER_SUB 7
+
+static struct lws_context *context;
+static int interrupted, failed, done, subs = 10000, publishes = 20000,
+	   port = 1884, subscribed, published, received;
+static lws_usec_t us_start, us_subscribed, us_done;
+
+/*
+ * 90% of the subscriptions are exact, then 9% like region/n/+/status and 1%
+ * like alerts/n/#
+ */
+
+static void
+sub_topic(int n, char *buf, size_t len)
+{
+	int exact = (subs * 90) / 100, plus = (subs * 99) / 100;
+
+	if (n < exact)
+		lws_snprintf(buf, len, "fleet/%d/telemetry", n);
+	else if (n < plus)
+		lws_snprintf(buf, len, "region/%d/+/status", n - exact);
+	else
+		lws_snprintf(buf, len, "alerts/%d/#", n - plus);
+}
+
+static void
+pub_topic(int n, char *buf, size_t len)
+{
+	int exact = (subs * 90) / 100, plus = (subs * 99) / 100 - exact,
+	    hash = subs - exact - plus, r = (int)(((unsigned int)n * 2654435761u)
+							>> 8);
+
+	switch (n & 3) {
+	case 0:
+		lws_snprintf(buf, len, "fleet/%d/telemetry", r % exact);
+		break;
+	case 1:
+		lws_snprintf(buf, len, "region/%d/dev%d/status", r % plus, n);
+		break;
+	case 2:
+		lws_snprintf(buf, len, "alerts/%d/%d/level", r % hash, n);
+		break;
+	default: /* matches nothing */
+		lws_snprintf(buf, len, "fleet/%d/config", r % exact);
+		break;
+	}
+}
+
+/* the fake broker */
+
+struct pss_broker {
+	uint8_t		rx[1024];
+	size_t		rxlen;
+	uint16_t	pending_subacks[8];
+	uint8_t		pending_codes[8];
+	int		count_subacks;
+	uint8_t		connack;
+};
+
+static int
+broker_rx(struct lws *wsi, struct pss_broker *pss, const uint8_t *in,
+	  size_t len)
+{
+	size_t rl, hl, o;
+	int n;
+
+	if (pss->rxlen + len > sizeof(pss->rx))
+		return 1;
+	memcpy(pss->rx + pss->rxlen, in, len);
+	pss->rxlen += len;
+
+	while (pss->rxlen >= 2) {
+		/* fixed header, with remaining length in up to 4 VBI bytes */
+		rl = 0;
+		for (hl = 1; hl < 5; hl++) {
+			if (hl >= pss->rxlen)
+				return 0;
+			rl |= (size_t)(pss->rx[hl] & 0x7f) << (7 * (hl - 1));
+			if (!(pss->rx[hl] & 0x80))
+				break;
+		}
+		hl++;
+		if (hl + rl > sizeof(pss->rx))
+			return 1;
+		if (pss->rxlen < hl + rl)
+			return 0;
+
+		switch (pss->rx[0] >> 4) {
+		case 1: /* CONNECT */
+			pss->connack = 1;
+			break;
+		case 8: /* SUBSCRIBE */
+			if (pss->count_subacks == LWS_ARRAY_SIZE(pss->pending_subacks))
+				return 1;
+			pss->pending_subacks[pss->count_subacks] =
+				(uint16_t)((pss->rx[hl] << 8) | pss->rx[hl + 1]);
+			/* count the topics */
+			n = 0;
+			for (o = hl + 2; o + 2 < hl + rl; n++)
+				o += 2u + (size_t)((pss->rx[o] << 8) |
+						   pss->rx[o + 1]) + 1u;
+			pss->pending_codes[pss->count_subacks++] = (uint8_t)n;
+			subscribed += n;
+			break;
+		case 12: /* PINGREQ */
+		case 14: /* DISCONNECT */
+		default:
+			break;
+		}
+
+		memmove(pss->rx, pss->rx + hl + rl, pss->rxlen - hl - rl);
+		pss->rxlen -= hl + rl;
+	}
+
+	return 0;
+}
+
+static int
+broker_tx(struct lws *wsi, struct pss_broker *pss)
+{
+	uint8_t buf[LWS_PRE + 8192], *start = &buf[LWS_PRE], *p = start;
+	char topic[64];
+	size_t tl;
+	int n;
+
+	if (pss->connack) {
+		*p++ = 0x20;
+		*p++ = 2;
+		*p++ = 0;
+		*p++ = 0;
+		pss->connack = 0;
+	}
+
+	for (n = 0; n < pss->count_subacks; n++) {
+		*p++ = 0x90;
+		*p++ = (uint8_t)(2 + pss->pending_codes[n]);
+		*p++ = (uint8_t)(pss->pending_subacks[n] >> 8);
+		*p++ = (uint8_t)pss->pending_subacks[n];
+		memset(p, 0, pss->pending_codes[n]); /* granted QoS0 */
+		p += pss->pending_codes[n];
+	}
+	pss->count_subacks = 0;
+
+	/* once everything is subscribed, send the PUBLISH */
+
+	while (subscribed == subs && published < publishes &&
+	       lws_ptr_diff_size_t(&buf[sizeof(buf)], p) > 128) {
+		pub_topic(published++, topic, sizeof(topic));
+		tl = strlen(topic);
+		*p++ = 0x30;
+		*p++ = (uint8_t)(2 + tl + 1);
+		*p++ = 0;
+		*p++ = (uint8_t)tl;
+		memcpy(p, topic, tl);
+		p += tl;
+		*p++ = 'x';
+	}
+
+	if (subscribed == subs && published < publishes)
+		lws_callback_on_writable(wsi);
+
+	if (p == start)
+		return 0;
+
+	return lws_write(wsi, start, lws_ptr_diff_size_t(p, start),
+			 LWS_WRITE_RAW) != lws_ptr_diff(p, start);
+}
+
+static int
+callback_broker(struct lws *wsi, enum lws_callback_reasons reason,
+		void *user, void *in, size_t len)
+{
+	struct pss_broker *pss = (struct pss_broker *)user;
+
+	switch (reason) {
+	case LWS_CALLBACK_RAW_RX:
+		if (broker_rx(wsi, pss, (const uint8_t *)in, len)) {
+			lwsl_err("%s: bad rx\n", __func__);
+			return -1;
+		}
+		if (pss->connack || pss->count_subacks)
+			lws_callback_on_writable(wsi);
+		break;
+
+	case LWS_CALLBACK_RAW_WRITEABLE:
+		if (broker_tx(wsi, pss))
+			return -1;
+		break;
+
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+/* the client */
+
+static lws_mqtt_topic_elem_t topics[TOPICS_PER_SUB];
+static char topic_names[TOPICS_PER_SUB][64];
+static int next_sub;
+
+static const lws_mqtt_client_connect_param_t client_connect_param = {
+	.client_id			= "lwsMqttDispatch",
+	.keep_alive			= 60,
+	.clean_start			= 1,
+	.client_id_nofree		= 1,
+	.username_nofree		= 1,
+	.password_nofree		= 1,
+};
+
+static int
+subscribe_next(struct lws *wsi)
+{
+	lws_mqtt_subscribe_param_t sub;
+	int n = 0;
+
+	memset(&sub, 0, sizeof(sub));
+
+	while (n < TOPICS_PER_SUB && next_sub < subs) {
+		sub_topic(next_sub++, topic_names[n], sizeof(topic_names[n]));
+		topics[n].name = topic_names[n];
+		topics[n].qos = QOS0;
+		n++;
+	}
+
+	sub.topic = topics;
+	sub.num_topics = (uint32_t)n;
+
+	return lws_mqtt_client_send_subcribe(wsi, &sub);
+}
+
+static int
+callback_mqtt(struct lws *wsi, enum lws_callback_reasons reason,
+	      void *user, void *in, size_t len)
+{
+	lws_mqtt_publish_param_t *pub;
+
+	switch (reason) {
+	case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
+		lwsl_err("%s: CLIENT_CONNECTION_ERROR: %s\n", __func__,
+			 in ? (char *)in : "(null)");
+		failed = 1;
+		break;
+
+	case LWS_CALLBACK_MQTT_CLIENT_CLOSED:
+		if (!done) {
+			lwsl_err("%s: closed early\n", __func__);
+			failed = 1;
+		}
+		break;
+
+	case LWS_CALLBACK_MQTT_CLIENT_ESTABLISHED:
+	case LWS_CALLBACK_MQTT_SUBSCRIBED:
+		if (next_sub < subs) {
+			lws_callback_on_writable(wsi);
+			break;
+		}
+		lwsl_user("%d subscriptions in %lldms\n", subs,
+			  (long long)((lws_now_usecs() - us_start) /
+				      LWS_US_PER_MS));
+		us_subscribed = lws_now_usecs();
+		break;
+
+	case LWS_CALLBACK_MQTT_CLIENT_WRITEABLE:
+		if (next_sub < subs && subscribe_next(wsi)) {
+			lwsl_err("%s: subscribe failed\n", __func__);
+			failed = 1;
+			return -1;
+		}
+		break;
+
+	case LWS_CALLBACK_MQTT_CLIENT_RX:
+		pub = (lws_mqtt_publish_param_t *)in;
+		if (strstr(pub->topic, "/config")) {
+			lwsl_err("%s: unexpected %s\n", __func__, pub->topic);
+			failed = 1;
+		}
+		/* three quarters of the PUBLISH should reach us */
+		if (++received == publishes - publishes / 4) {
+			us_done = lws_now_usecs();
+			done = 1;
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+static const struct lws_protocols protocols[] = {
+	{ "broker", callback_broker, sizeof(struct pss_broker), 0, 0, NULL, 0 },
+	{ "mqtt", callback_mqtt, 0, 0, 0, NULL, 0 },
+	LWS_PROTOCOL_LIST_TERM
+};
+
+static void
+sigint_handler(int sig)
+{
+	interrupted = 1;
+}
+
+int
+main(int argc, const char **argv)
+{
+	int logs = LLL_USER | LLL_ERR | LLL_WARN, e = 1;
+	struct lws_context_creation_info info;
+	struct lws_client_connect_info i;
+	lws_usec_t timeout;
+	const char *p;
+
+	signal(SIGINT, sigint_handler);
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--subs")))
+		subs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--publishes")))
+		publishes = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--port")))
+		port = atoi(p);
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS minimal mqtt client dispatch\n");
+
+	if (subs < 100 || publishes < 4) {
+		lwsl_err("--subs must be at least 100, --publishes 4\n");
+		return 1;
+	}
+
+	memset(&info, 0, sizeof info); /* otherwise uninitialized garbage */
+	info.port = port;
+	info.iface = "127.0.0.1";
+	info.protocols = protocols;
+	info.options = LWS_SERVER_OPTION_ONLY_RAW; /* the fake broker */
+
+	context = lws_create_context(&info);
+	if (!context) {
+		lwsl_err("lws init failed\n");
+		return 1;
+	}
+
+	memset(&i, 0, sizeof i);
+	i.mqtt_cp = &client_connect_param;
+	i.context = context;
+	i.address = "127.0.0.1";
+	i.host = i.address;
+	i.protocol = protocols[1].name;
+	i.method = "MQTT";
+	i.port = port;
+
+	us_start = lws_now_usecs();
+	if (!lws_client_connect_via_info(&i)) {
+		lwsl_err("%s: client connect failed\n", __func__);
+		goto bail;
+	}
+
+	timeout = lws_now_usecs() + (120 * LWS_US_PER_SEC);
+	while (!done && !failed && !interrupted && lws_now_usecs() < timeout)
+		if (lws_service(context, 0) < 0)
+			break;
+
+	if (done && !failed) {
+		lwsl_user("%d PUBLISH, %d delivered, in %lldms: %.2fus each\n",
+			  publishes, received,
+			  (long long)((us_done - us_subscribed) / LWS_US_PER_MS),
+			  (double)(us_done - us_subscribed) / (double)publishes);
+		e = 0;
+	} else
+		lwsl_err("%s: subscribed %d, published %d, received %d\n",
+			 __func__, subscribed, published, received);
+
+bail:
+	lws_context_destroy(context);
+
+	lwsl_user("Completed: %s\n", e ? "FAIL" : "PASS");
+
+	return e;
+}
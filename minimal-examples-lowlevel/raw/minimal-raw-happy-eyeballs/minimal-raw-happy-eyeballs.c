@@ -0,0 +1,350 @@
+/*
+ * lws-minimal-raw-happy-eyeballs
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This makes a raw client connection to a name that resolves to two
+ * addresses, eg, "localhost" with both 127.0.0.1 and ::1 in /etc/hosts.
+ *
+ * On the same port, one of the addresses has a listener whose accept queue
+ * is full, so it silently drops our SYNs, and the other has a listener that
+ * will complete the connection.  It does it twice, blackholing each address
+ * in turn, so whichever one lws prefers to try first, one of the passes has
+ * to race the other address to connect in good time.
+ */
+
+#include <libwebsockets.h>
+#include <string.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+
+#define FILL 4
+
+struct pass {
+	lws_sockaddr46		good;
+	lws_usec_t		start;
+	lws_usec_t		connected;
+	int			done;
+	int			bad;
+	int			raced;
+};
+
+static struct pass *cur;
+static int interrupted;
+
+#if defined(LWS_WITH_CONMON)
+static void
+dump_attempts(struct lws *wsi)
+{
+	static const char * const disp[] = {
+		"ongoing", "connected", "failed", "timed out", "cancelled"
+	};
+	struct lws_conmon cm;
+	char ads[48];
+	int n;
+
+	lws_conmon_wsi_take(wsi, &cm);
+
+	for (n = 0; n < cm.count_attempts; n++) {
+		lws_conmon_attempt_t *a = &cm.attempts[n];
+
+		lws_sa46_write_numeric_address(&a->peer46, ads, sizeof(ads));
+		lwsl_user("  attempt %d: %s, start +%ums, %ums, %s\n", n, ads,
+			  (unsigned int)(a->ciu_start / 1000),
+			  (unsigned int)(a->ciu_attempt / 1000),
+			  a->disposition < LWS_ARRAY_SIZE(disp) ?
+					disp[a->disposition] : "?");
+	}
+
+	if (cm.count_attempts > 1)
+		cur->raced = 1;
+
+	lws_conmon_release(&cm);
+}
+#endif
+
+static int
+callback_raw_client(struct lws *wsi, enum lws_callback_reasons reason,
+		    void *user, void *in, size_t len)
+{
+	lws_sockaddr46 sa46;
+	socklen_t sl = sizeof(sa46);
+	char ads[48];
+
+	switch (reason) {
+	case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
+		lwsl_err("CLIENT_CONNECTION_ERROR: %s\n",
+			 in ? (char *)in : "(null)");
+		cur->bad = 1;
+		cur->done = 1;
+		break;
+
+	case LWS_CALLBACK_RAW_CONNECTED:
+		cur->connected = lws_now_usecs();
+
+		memset(&sa46, 0, sizeof(sa46));
+		if (getpeername(lws_get_socket_fd(wsi), (struct sockaddr *)&sa46,
+				&sl) || lws_sa46_compare_ads(&sa46, &cur->good)) {
+			lws_sa46_write_numeric_address(&sa46, ads, sizeof(ads));
+			lwsl_err("connected to unexpected peer %s\n", ads);
+			cur->bad = 1;
+		}
+
+		lwsl_user("connected after %lldms\n",
+			  (long long)((cur->connected - cur->start) /
+				      LWS_US_PER_MS));
+#if defined(LWS_WITH_CONMON)
+		dump_attempts(wsi);
+#endif
+		/* the context destroy closes it */
+		cur->done = 1;
+		break;
+
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+static const struct lws_protocols protocols[] = {
+	{ "raw-he", callback_raw_client, 0, 0, 0, NULL, 0 },
+	LWS_PROTOCOL_LIST_TERM
+};
+
+static void
+sigint_handler(int sig)
+{
+	interrupted = 1;
+}
+
+static int
+listener(const struct addrinfo *ai, int port, int backlog)
+{
+	lws_sockaddr46 sa46;
+	int fd, one = 1;
+
+	memset(&sa46, 0, sizeof(sa46));
+	memcpy(&sa46, ai->ai_addr, ai->ai_addrlen);
+	sa46_sockport(&sa46, htons((uint16_t)port));
+
+	fd = socket(ai->ai_family, SOCK_STREAM, 0);
+	if (fd < 0)
+		return -1;
+
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (const void *)&one,
+		   sizeof(one));
+
+	if (bind(fd, (struct sockaddr *)&sa46, ai->ai_addrlen) ||
+	    listen(fd, backlog)) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static int
+usable(const struct addrinfo *ai)
+{
+	int fd = listener(ai, 0, 1);
+
+	if (fd < 0)
+		return 0;
+
+	close(fd);
+
+	return 1;
+}
+
+/*
+ * A listener that never accepts, with a backlog of zero filled up by a few
+ * connections of our own, doesn't answer any more SYNs
+ */
+
+static int
+blackhole(const struct addrinfo *ai, int port, int *fill)
+{
+	lws_sockaddr46 sa46;
+	int fd, n;
+
+	fd = listener(ai, port, 0);
+	if (fd < 0)
+		return -1;
+
+	memset(&sa46, 0, sizeof(sa46));
+	memcpy(&sa46, ai->ai_addr, ai->ai_addrlen);
+	sa46_sockport(&sa46, htons((uint16_t)port));
+
+	for (n = 0; n < FILL; n++) {
+		fill[n] = socket(ai->ai_family, SOCK_STREAM, 0);
+		if (fill[n] < 0)
+			continue;
+		fcntl(fill[n], F_SETFL, O_NONBLOCK);
+		connect(fill[n], (struct sockaddr *)&sa46, ai->ai_addrlen);
+	}
+
+	/* give the handshakes that will complete time to do so */
+	usleep(100000);
+
+	return fd;
+}
+
+static int
+run_pass(struct pass *p, const char *host, const struct addrinfo *bad,
+	 const struct addrinfo *good, int port)
+{
+	struct lws_context_creation_info info;
+	struct lws_client_connect_info i;
+	struct lws_context *context;
+	int fill[FILL], lg, lb, n, ret = 1;
+	lws_usec_t timeout;
+	char ads[48];
+
+	memset(p, 0, sizeof(*p));
+	memcpy(&p->good, good->ai_addr, good->ai_addrlen);
+	sa46_sockport(&p->good, htons((uint16_t)port));
+	cur = p;
+
+	for (n = 0; n < FILL; n++)
+		fill[n] = -1;
+
+	lws_sa46_write_numeric_address((lws_sockaddr46 *)bad->ai_addr, ads,
+				       sizeof(ads));
+	lwsl_user("%s blackholed, port %d\n", ads, port);
+
+	lg = listener(good, port, 16);
+	lb = blackhole(bad, port, fill);
+	if (lg < 0 || lb < 0) {
+		lwsl_err("%s: unable to listen on port %d\n", __func__, port);
+		goto bail1;
+	}
+
+	memset(&info, 0, sizeof info);
+	info.port = CONTEXT_PORT_NO_LISTEN;
+	info.protocols = protocols;
+	/* so one attempt after the other can't pass the test */
+	info.timeout_secs = 5;
+
+	context = lws_create_context(&info);
+	if (!context)
+		goto bail1;
+
+	memset(&i, 0, sizeof i);
+	i.context = context;
+	i.address = host;
+	i.host = host;
+	i.origin = host;
+	i.port = port;
+	i.method = "RAW";
+	i.local_protocol_name = protocols[0].name;
+	i.ssl_connection = LCCSCF_CONMON;
+
+	p->start = lws_now_usecs();
+	if (!lws_client_connect_via_info(&i)) {
+		lwsl_err("%s: connect failed\n", __func__);
+		goto bail;
+	}
+
+	timeout = lws_now_usecs() + (8 * LWS_US_PER_SEC);
+	while (!p->done && !interrupted && lws_now_usecs() < timeout)
+		if (lws_service(context, 0) < 0)
+			break;
+
+	if (!p->done)
+		lwsl_err("%s: timed out\n", __func__);
+	else
+		if (!p->bad && p->connected - p->start < 2 * LWS_US_PER_SEC)
+			ret = 0;
+
+bail:
+	lws_context_destroy(context);
+bail1:
+	for (n = 0; n < FILL; n++)
+		if (fill[n] >= 0)
+			close(fill[n]);
+	if (lb >= 0)
+		close(lb);
+	if (lg >= 0)
+		close(lg);
+
+	return ret;
+}
+
+int
+main(int argc, const char **argv)
+{
+	int logs = LLL_USER | LLL_ERR | LLL_WARN, e = 1, port = 7696;
+	const struct addrinfo *a0, *a1;
+	const char *p, *host = "localhost";
+	struct addrinfo h, *result;
+	struct pass pass[2];
+
+	signal(SIGINT, sigint_handler);
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--host")))
+		host = p;
+
+	if ((p = lws_cmdline_option(argc, argv, "--port")))
+		port = atoi(p);
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS minimal raw happy eyeballs: %s\n", host);
+
+	memset(&h, 0, sizeof(h));
+	h.ai_family = AF_UNSPEC;
+	h.ai_socktype = SOCK_STREAM;
+
+	if (getaddrinfo(host, NULL, &h, &result)) {
+		lwsl_err("unable to resolve %s\n", host);
+		return 1;
+	}
+
+	/* we need two addresses, one of each family */
+
+	a0 = result;
+	a1 = a0->ai_next;
+	while (a1 && a1->ai_family == a0->ai_family)
+		a1 = a1->ai_next;
+
+	/*
+	 * lws resolves the name itself, so the race needs it to give both
+	 * families, and this box to be able to use both of them.  If it
+	 * can't, there's nothing to test here, so don't fail
+	 */
+
+	if (!a1 || !usable(a0) || !usable(a1)) {
+		lwsl_user("%s doesn't resolve to a usable IPv4 and IPv6 "
+			  "address, eg, add \"::1 localhost\" to /etc/hosts, "
+			  "skipping\n", host);
+		freeaddrinfo(result);
+		lwsl_user("Completed: PASS\n");
+		return 0;
+	}
+
+	if (!run_pass(&pass[0], host, a0, a1, port) &&
+	    !run_pass(&pass[1], host, a1, a0, port + 1)) {
+#if defined(LWS_WITH_CONMON)
+		if (!pass[0].raced && !pass[1].raced)
+			lwsl_err("neither pass raced a second attempt\n");
+		else
+#endif
+			e = 0;
+	}
+
+	freeaddrinfo(result);
+
+	lwsl_user("Completed: %s\n", e ? "FAIL" : "PASS");
+
+	return e;
+}
@@ -0,0 +1,300 @@
+/*
+ * lws-minimal-raw-threadpool-bench
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This measures how many tiny tasks per second a threadpool can take from
+ * several service threads at once, run, and hand back to be reaped.
+ *
+ * One end of a socketpair per feeder is adopted as a raw file wsi, lws
+ * spreads them over the service threads.  Each feeder keeps a window of
+ * tasks in flight on the threadpool, reaping the completed ones and
+ * topping it up again from its WRITEABLE callback, until it has put its
+ * share of the tasks through.
+ */
+
+#include <libwebsockets.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#define MAX_PTS		16
+#define MAX_FEEDERS	64
+#define WINDOW		64
+
+struct feeder {
+	struct lws		*wsi;
+	int			target;
+	int			enqueued;
+	int			completed;
+	int			in_flight;
+	int			fds[2];
+};
+
+static struct lws_context *context;
+static struct lws_threadpool *tp;
+static struct feeder feeders[MAX_FEEDERS];
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static int count = 2000000, pts = 4, workers = 4, feeders_per_pt = 4,
+	   feeders_done, feeder_count, fail;
+static volatile int interrupted;
+static lws_usec_t t_start, t_end;
+static volatile uint32_t sink;
+
+static enum lws_threadpool_task_return
+task_function(void *user, enum lws_threadpool_task_status s)
+{
+	uint32_t h = 0x811c9dc5;
+	int n;
+
+	/* a microtask: just enough work to not be nothing */
+
+	for (n = 0; n < 64; n++)
+		h = (h ^ (uint32_t)n) * 0x01000193;
+	sink = h;
+
+	return LWS_TP_RETURN_FINISHED;
+}
+
+static int
+reap_cb(struct lws_threadpool_task *task, void *user)
+{
+	struct feeder *f = (struct feeder *)user;
+	void *tu;
+
+	switch (lws_threadpool_task_status(task, &tu)) {
+	case LWS_TP_STATUS_FINISHED:
+		f->completed++;
+		f->in_flight--;
+		break;
+	case LWS_TP_STATUS_STOPPED:
+		f->in_flight--;
+		fail = 1;
+		break;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+static int
+feed(struct feeder *f)
+{
+	struct lws_threadpool_task_args args;
+
+	lws_threadpool_foreach_task_wsi(f->wsi, f, reap_cb);
+
+	memset(&args, 0, sizeof(args));
+	args.wsi = f->wsi;
+	args.user = f;
+	args.task = task_function;
+
+	while (f->in_flight < WINDOW && f->enqueued < f->target) {
+		if (!lws_threadpool_enqueue(tp, &args, "bench")) {
+			lwsl_err("%s: enqueue failed\n", __func__);
+			fail = 1;
+			break;
+		}
+		f->enqueued++;
+		f->in_flight++;
+	}
+
+	if (f->completed < f->target && !fail)
+		/* the threadpool will get us a WRITEABLE when there's more */
+		return 0;
+
+	pthread_mutex_lock(&lock);
+	if (++feeders_done == feeder_count) {
+		t_end = lws_now_usecs();
+		interrupted = 1;
+		lws_cancel_service(context);
+	}
+	pthread_mutex_unlock(&lock);
+
+	return 0;
+}
+
+static int
+callback_bench(struct lws *wsi, enum lws_callback_reasons reason,
+	       void *user, void *in, size_t len)
+{
+	struct feeder *f = (struct feeder *)lws_get_opaque_user_data(wsi);
+
+	switch (reason) {
+	case LWS_CALLBACK_RAW_ADOPT_FILE:
+		f->wsi = wsi;
+		break;
+
+	case LWS_CALLBACK_RAW_WRITEABLE_FILE:
+		if (f->completed < f->target)
+			return feed(f);
+		break;
+
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+static const struct lws_protocols protocols[] = {
+	{ "bench", callback_bench, 0, 0, 0, NULL, 0 },
+	LWS_PROTOCOL_LIST_TERM
+};
+
+static void *
+thread_service(void *threadid)
+{
+	while (lws_service_tsi(context, 0,
+			       (int)(lws_intptr_t)threadid) >= 0 &&
+	       !interrupted)
+		;
+
+	return NULL;
+}
+
+int
+main(int argc, const char **argv)
+{
+	struct lws_threadpool_create_args cargs;
+	struct lws_context_creation_info info;
+	pthread_t pthread_service[MAX_PTS];
+	lws_adopt_desc_t ad;
+	struct lws_vhost *vh;
+	int logs = LLL_USER | LLL_ERR | LLL_WARN, n;
+	lws_usec_t t;
+	const char *p;
+	void *retval;
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--count")))
+		count = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--pts")))
+		pts = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--workers")))
+		workers = atoi(p);
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS minimal raw threadpool bench\n");
+
+	if (pts < 1 || pts > MAX_PTS)
+		pts = MAX_PTS;
+
+	memset(&info, 0, sizeof info); /* otherwise uninitialized garbage */
+	info.port = CONTEXT_PORT_NO_LISTEN_SERVER;
+	info.protocols = protocols;
+	info.count_threads = (unsigned int)pts;
+
+	context = lws_create_context(&info);
+	if (!context) {
+		lwsl_err("lws init failed\n");
+		return 1;
+	}
+
+	/* the context may give us fewer service threads than we asked for */
+	pts = lws_get_count_threads(context);
+
+	memset(&cargs, 0, sizeof(cargs));
+	cargs.threads = workers;
+	cargs.max_queue_depth = MAX_FEEDERS * WINDOW;
+	if (lws_cmdline_option(argc, argv, "--pin"))
+		cargs.cpu_affinity = 1;
+
+	tp = lws_threadpool_create(context, &cargs, "bench");
+	if (!tp) {
+		lwsl_err("threadpool creation failed\n");
+		fail = 1;
+		goto bail;
+	}
+
+	vh = lws_get_vhost_by_name(context, "default");
+
+	feeder_count = pts * feeders_per_pt;
+	if (feeder_count > MAX_FEEDERS)
+		feeder_count = MAX_FEEDERS;
+
+	/* lws puts each new adoption on the least busy service thread */
+
+	for (n = 0; n < feeder_count; n++) {
+		struct feeder *f = &feeders[n];
+
+		f->target = count / feeder_count +
+			    (n < count % feeder_count);
+
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, f->fds)) {
+			lwsl_err("socketpair failed\n");
+			fail = 1;
+			goto bail1;
+		}
+
+		memset(&ad, 0, sizeof(ad));
+		ad.vh = vh;
+		ad.type = LWS_ADOPT_RAW_FILE_DESC;
+		ad.fd.filefd = (lws_filefd_type)(lws_intptr_t)f->fds[0];
+		ad.vh_prot_name = protocols[0].name;
+		ad.opaque = f;
+
+		if (!lws_adopt_descriptor_vhost_via_info(&ad)) {
+			lwsl_err("adopt failed\n");
+			close(f->fds[0]);
+			close(f->fds[1]);
+			fail = 1;
+			goto bail1;
+		}
+	}
+
+	t_start = lws_now_usecs();
+
+	for (n = 0; n < feeder_count; n++)
+		lws_callback_on_writable(feeders[n].wsi);
+
+	for (n = 1; n < pts; n++)
+		if (pthread_create(&pthread_service[n], NULL, thread_service,
+				   (void *)(lws_intptr_t)n)) {
+			lwsl_err("Failed to start service thread\n");
+			fail = 1;
+			interrupted = 1;
+			pts = n;
+			break;
+		}
+
+	thread_service((void *)(lws_intptr_t)0);
+
+	for (n = 1; n < pts; n++)
+		pthread_join(pthread_service[n], &retval);
+
+	t = t_end - t_start;
+	if (!fail && t > 0)
+		lwsl_user("%d tasks from %d pts on %d workers in %lldms, "
+			  "%llu tasks/s\n", count, pts, workers,
+			  (long long)(t / LWS_US_PER_MS),
+			  (unsigned long long)(((uint64_t)count *
+						LWS_US_PER_SEC) / (uint64_t)t));
+	else
+		fail = 1;
+
+bail1:
+	lws_threadpool_finish(tp);
+	lws_threadpool_destroy(tp);
+
+	for (n = 0; n < feeder_count; n++)
+		if (feeders[n].wsi)
+			close(feeders[n].fds[1]);
+
+bail:
+	lws_context_destroy(context);
+
+	lwsl_user("Completed: %s\n", fail ? "FAIL" : "PASS");
+
+	return fail;
+}
@@ -0,0 +1,327 @@
+/*
+ * lws-minimal-raw-udp-mmsg-bench
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This sends datagrams between two lws UDP wsi on loopback, in the same
+ * event loop, and measures the rate.  It does it first with the usual one
+ * datagram per read / write, and then with wsi created with LWS_CAUDP_MMSG,
+ * where rx is drained with recvmmsg() and tx is queued with lws_udp_queue()
+ * and sent with sendmmsg(), and finally adding LWS_CAUDP_GSO and
+ * LWS_CAUDP_GRO on top.
+ *
+ * The sender keeps a window of datagrams in flight and waits for the
+ * receiver to see them, so the kernel socket buffers don't overflow.
+ */
+
+#include <libwebsockets.h>
+#include <string.h>
+#include <stdlib.h>
+#include <signal.h>
+
+/* keep what's in flight well inside the default socket rx buffer */
+#define WINDOW_BYTES 65536
+#define WINDOW_MAX 64
+
+struct pass {
+	const char		*name;
+	int			flags;
+
+	lws_usec_t		start;
+	lws_usec_t		end;
+	unsigned int		sent;
+	unsigned int		rxd;
+	unsigned int		lost;
+	unsigned int		rxd_last;
+	unsigned int		bad;
+	int			done;
+};
+
+static struct pass passes[] = {
+	{ .name = "plain    ", .flags = 0 },
+#if defined(LWS_WITH_UDP_MMSG)
+	{ .name = "mmsg     ", .flags = LWS_CAUDP_MMSG },
+	{ .name = "gso + gro", .flags = LWS_CAUDP_GSO | LWS_CAUDP_GRO },
+#endif
+};
+
+/*
+ * The plain pass reads into pt_serv_buf_size (4096 by default) less LWS_PRE,
+ * so that's the biggest dgram all the passes can take
+ */
+static uint8_t payload[4096];
+static unsigned int count = 1000000, size = 1200, window;
+static struct lws *wsi_tx, *wsi_rx;
+static lws_sorted_usec_list_t sul;
+static struct pass *cur;
+static int interrupted;
+
+static void
+check_done(void)
+{
+	if (cur->rxd + cur->lost < count)
+		return;
+
+	cur->end = lws_now_usecs();
+	cur->done = 1;
+}
+
+static void
+rx(unsigned int n)
+{
+	if (!cur->start)
+		return;
+
+	cur->rxd += n;
+	check_done();
+
+	/* the window drained, send the next one */
+	if (!cur->done && cur->sent == cur->rxd + cur->lost)
+		lws_callback_on_writable(wsi_tx);
+}
+
+/*
+ * If nothing arrived for a while, what's in flight was dropped, count it as
+ * lost and move on
+ */
+
+static void
+watchdog(lws_sorted_usec_list_t *s)
+{
+	if (cur->done)
+		return;
+
+	if (cur->rxd == cur->rxd_last && cur->sent > cur->rxd + cur->lost) {
+		cur->lost = cur->sent - cur->rxd;
+		check_done();
+		if (!cur->done)
+			lws_callback_on_writable(wsi_tx);
+	}
+	cur->rxd_last = cur->rxd;
+
+	lws_sul_schedule(lws_get_context(wsi_tx), 0, &sul, watchdog,
+			 100 * LWS_US_PER_MS);
+}
+
+static int
+callback_udp_bench(struct lws *wsi, enum lws_callback_reasons reason,
+		   void *user, void *in, size_t len)
+{
+	unsigned int n;
+
+	switch (reason) {
+	case LWS_CALLBACK_RAW_RX:
+		if (wsi != wsi_rx)
+			break;
+		if (len != size)
+			cur->bad++;
+		rx(1);
+		break;
+
+#if defined(LWS_WITH_UDP_MMSG)
+	case LWS_CALLBACK_RAW_RX_BATCH:
+	{
+		const lws_udp_dgram_t *dg = (const lws_udp_dgram_t *)in;
+
+		if (wsi != wsi_rx)
+			break;
+
+		/* GRO must have been split back into the original dgrams */
+		for (n = 0; n < (unsigned int)len; n++)
+			if (dg[n].len != size || dg[n].buf[size - 1] != 0x5a)
+				cur->bad++;
+		rx((unsigned int)len);
+		break;
+	}
+#endif
+
+	case LWS_CALLBACK_RAW_WRITEABLE:
+		if (wsi != wsi_tx || cur->done ||
+		    cur->sent != cur->rxd + cur->lost)
+			break;
+
+		if (!cur->start) {
+			cur->start = lws_now_usecs();
+			lws_sul_schedule(lws_get_context(wsi), 0, &sul,
+					 watchdog, 100 * LWS_US_PER_MS);
+		}
+
+		for (n = 0; n < window && cur->sent < count; n++) {
+#if defined(LWS_WITH_UDP_MMSG)
+			if (cur->flags) {
+				/* lws sends these when we return */
+				if (lws_udp_queue(wsi, &payload[LWS_PRE], size,
+						  NULL))
+					break;
+			} else
+#endif
+			if (lws_write(wsi, &payload[LWS_PRE], size,
+				      LWS_WRITE_RAW) != (int)size) {
+				lwsl_err("%s: tx failed\n", __func__);
+				cur->bad++;
+				cur->end = lws_now_usecs();
+				cur->done = 1;
+				break;
+			}
+			cur->sent++;
+		}
+		break;
+
+	case LWS_CALLBACK_RAW_CLOSE:
+		if (wsi == wsi_tx)
+			wsi_tx = NULL;
+		if (wsi == wsi_rx)
+			wsi_rx = NULL;
+		break;
+
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+static const struct lws_protocols protocols[] = {
+	{ "udp-bench", callback_udp_bench, 0, 0, 0, NULL, 0 },
+	LWS_PROTOCOL_LIST_TERM
+};
+
+static void
+sigint_handler(int sig)
+{
+	interrupted = 1;
+}
+
+static int
+run_pass(struct pass *p, int port)
+{
+	struct lws_context_creation_info info;
+	struct lws_context *context;
+	struct lws_vhost *vh;
+	lws_usec_t timeout;
+	int ret = 1;
+
+	cur = p;
+
+	memset(&info, 0, sizeof info);
+	info.options = LWS_SERVER_OPTION_EXPLICIT_VHOSTS;
+
+	context = lws_create_context(&info);
+	if (!context)
+		return 1;
+
+	info.port = CONTEXT_PORT_NO_LISTEN_SERVER;
+	info.protocols = protocols;
+
+	vh = lws_create_vhost(context, &info);
+	if (!vh)
+		goto bail;
+
+	wsi_rx = lws_create_adopt_udp(vh, NULL, port,
+				      LWS_CAUDP_BIND | p->flags,
+				      protocols[0].name, NULL, NULL, NULL,
+				      NULL, "rx");
+	wsi_tx = lws_create_adopt_udp(vh, "127.0.0.1", port, p->flags,
+				      protocols[0].name, NULL, NULL, NULL,
+				      NULL, "tx");
+	if (!wsi_rx || !wsi_tx) {
+		lwsl_err("%s: udp wsi creation failed\n", __func__);
+		goto bail;
+	}
+
+	lws_callback_on_writable(wsi_tx);
+
+	timeout = lws_now_usecs() + (60 * LWS_US_PER_SEC);
+	while (!p->done && !interrupted && lws_now_usecs() < timeout)
+		if (lws_service(context, 0) < 0)
+			break;
+
+	if (p->done)
+		ret = 0;
+	else
+		lwsl_err("%s: %s: timed out\n", __func__, p->name);
+
+bail:
+	lws_sul_cancel(&sul);
+	lws_context_destroy(context);
+
+	return ret;
+}
+
+int
+main(int argc, const char **argv)
+{
+	int logs = LLL_USER | LLL_ERR | LLL_WARN, e = 0,
+	    port = 7695;
+	const char *p;
+	size_t n;
+
+	signal(SIGINT, sigint_handler);
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--count")))
+		count = (unsigned int)atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--size")))
+		size = (unsigned int)atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--port")))
+		port = atoi(p);
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS minimal raw udp mmsg bench: %u x %u byte dgrams\n",
+		  count, size);
+
+	if (!count || !size || size > sizeof(payload) - LWS_PRE) {
+		lwsl_err("bad --count or --size\n");
+		return 1;
+	}
+
+	memset(payload, 0x5a, sizeof(payload));
+
+	window = WINDOW_BYTES / size;
+	if (!window)
+		window = 1;
+	if (window > WINDOW_MAX)
+		window = WINDOW_MAX;
+
+	for (n = 0; n < LWS_ARRAY_SIZE(passes); n++) {
+		struct pass *ps = &passes[n];
+		lws_usec_t t;
+
+		if (run_pass(ps, port)) {
+			e = 1;
+			break;
+		}
+
+		t = ps->end - ps->start;
+		if (!t)
+			t = 1;
+
+		lwsl_user("%s: %u dgrams in %lldms, %llu dgrams/s, %lluMB/s, "
+			  "lost %u, bad %u\n", ps->name, ps->rxd,
+			  (long long)(t / LWS_US_PER_MS),
+			  (unsigned long long)(((uint64_t)ps->rxd *
+						LWS_US_PER_SEC) / (uint64_t)t),
+			  (unsigned long long)(((uint64_t)ps->rxd * size *
+				LWS_US_PER_SEC) / ((uint64_t)t * 1024 * 1024)),
+			  ps->lost, ps->bad);
+
+		/* loopback shouldn't lose more than the odd window */
+		if (ps->lost > count / 100 || ps->bad)
+			e = 1;
+	}
+
+#if !defined(LWS_WITH_UDP_MMSG)
+	lwsl_user("mmsg: not built, needs -DLWS_WITH_UDP_MMSG=1\n");
+#endif
+
+	lwsl_user("Completed: %s\n", e ? "FAIL" : "PASS");
+
+	return e;
+}
@@ -0,0 +1,272 @@
+/*
+ * lws-minimal-secure-streams-policy-bench
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This measures how long lws takes to parse a large JSON Secure Streams
+ * policy.  It generates a policy with many streamtypes, each using a
+ * different mix of the streamtype members, and has lws parse it again and
+ * again, checking each time that it ended up with all the streamtypes.
+ *
+ * Every member name in the policy is matched against the path table of the
+ * policy parser, so this is dominated by how fast lejp can find which of
+ * its paths, if any, the current JSON path matches.
+ */
+
+#include <libwebsockets.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <signal.h>
+
+static int interrupted, streamtypes = 200, loops = 100, members;
+
+static const char * const protos[] = { "h1", "h2", "ws", "mqtt" };
+
+/*
+ * Each streamtype gets the common members, then ones specific to its
+ * protocol, so the policy uses most of the paths the parser knows about
+ */
+
+static char *
+policy_create(size_t *len)
+{
+	size_t alloc = 4096 + (size_t)streamtypes * 2048;
+	char *buf = malloc(alloc), *p = buf, *end = buf + alloc;
+	int n;
+
+	if (!buf)
+		return NULL;
+
+	p += lws_snprintf(p, lws_ptr_diff_size_t(end, p),
+		"{\n"
+		" \"release\": \"01234567\",\n"
+		" \"product\": \"policy-bench\",\n"
+		" \"schema-version\": 1,\n"
+		" \"retry\": [");
+	members += 3;
+
+	for (n = 0; n < 8; n++) {
+		p += lws_snprintf(p, lws_ptr_diff_size_t(end, p),
+			"%s{ \"retry%d\": {"
+			" \"backoff\": [1000, 2000, 3000, 5000, 10000],"
+			" \"conceal\": %d, \"jitterpc\": 20,"
+			" \"svalidping\": 30, \"svalidhup\": 35 }}",
+			n ? ",\n  " : "\n  ", n, 5 + n);
+		members += 6;
+	}
+
+	p += lws_snprintf(p, lws_ptr_diff_size_t(end, p),
+		"\n ],\n \"certs\": [");
+
+	for (n = 0; n < 4; n++) {
+		p += lws_snprintf(p, lws_ptr_diff_size_t(end, p),
+			"%s{ \"cert%d\": \"MIIBszCCAVmgAwIBAgIUbm90IGEgcmVhbCBjZXJ0\" }",
+			n ? ", " : "", n);
+		members++;
+	}
+
+	p += lws_snprintf(p, lws_ptr_diff_size_t(end, p),
+		"],\n \"trust_stores\": [");
+
+	for (n = 0; n < 4; n++) {
+		p += lws_snprintf(p, lws_ptr_diff_size_t(end, p),
+			"%s{ \"name\": \"store%d\", \"stack\": [\"cert%d\"] }",
+			n ? ", " : "", n, n);
+		members += 2;
+	}
+
+	p += lws_snprintf(p, lws_ptr_diff_size_t(end, p), "],\n \"s\": [");
+
+	for (n = 0; n < streamtypes && lws_ptr_diff(end, p) > 2048; n++) {
+		const char *proto = protos[n & 3];
+
+		p += lws_snprintf(p, lws_ptr_diff_size_t(end, p),
+			"%s{ \"stream%d\": {\n"
+			"   \"endpoint\": \"host%d.example.com\",\n"
+			"   \"port\": %d, \"protocol\": \"%s\",\n"
+			"   \"tls\": true, \"tls_trust_store\": \"store%d\",\n"
+			"   \"opportunistic\": %s, \"nailed_up\": false,\n"
+			"   \"allow_redirects\": true, \"retry\": \"retry%d\",\n"
+			"   \"timeout_ms\": %d, \"attr_low_latency\": true,\n"
+			"   \"metadata\": [{ \"ctype\": \"content-type\","
+					" \"auth\": \"authorization\","
+					" \"tag%d\": \"\" }],\n",
+			n ? ",\n  " : "\n  ", n, n, 443 + (n & 7), proto,
+			n & 3, n & 1 ? "true" : "false", n & 7,
+			1000 + n, n);
+		members += 16;
+
+		switch (n & 3) {
+		case 0:
+		case 1:
+			p += lws_snprintf(p, lws_ptr_diff_size_t(end, p),
+				"   \"http_method\": \"POST\","
+				" \"http_url\": \"api/v%d/things/${thing}\",\n"
+				"   \"http_auth_header\": \"authorization:\","
+				" \"http_auth_preamble\": \"Bearer \",\n"
+				"   \"http_mime_content_type\": \"application/json\","
+				" \"http_expect\": 200,\n"
+				"   \"http_resp_map\": [{ \"530\": 1530 },"
+						" { \"531\": 1531 }],\n"
+				"   \"nghttp2_quirk_end_stream\": true,"
+				" \"h2q_oflow_txcr\": true,\n"
+				"   \"http_no_content_length\": false,"
+				" \"http_fail_redirect\": false\n",
+				n);
+			members += 13;
+			break;
+		case 2:
+			p += lws_snprintf(p, lws_ptr_diff_size_t(end, p),
+				"   \"http_method\": \"GET\","
+				" \"http_url\": \"live/%d\",\n"
+				"   \"ws_subprotocol\": \"lws-bench\","
+				" \"ws_binary\": true,\n"
+				"   \"ws_prioritize_reads\": true,"
+				" \"long_poll\": false\n",
+				n);
+			members += 6;
+			break;
+		default:
+			p += lws_snprintf(p, lws_ptr_diff_size_t(end, p),
+				"   \"mqtt_topic\": \"fleet/%d/telemetry\","
+				" \"mqtt_subscribe\": \"fleet/%d/cmd\",\n"
+				"   \"mqtt_qos\": 1, \"mqtt_retain\": false,"
+				" \"mqtt_keep_alive\": 60,\n"
+				"   \"mqtt_clean_start\": true,"
+				" \"mqtt_will_topic\": \"fleet/%d/gone\",\n"
+				"   \"mqtt_will_message\": \"bye\","
+				" \"mqtt_will_qos\": 1,"
+				" \"mqtt_will_retain\": false\n",
+				n, n, n);
+			members += 10;
+			break;
+		}
+
+		p += lws_snprintf(p, lws_ptr_diff_size_t(end, p), "  }}");
+	}
+
+	p += lws_snprintf(p, lws_ptr_diff_size_t(end, p), "\n ]\n}\n");
+
+	if (n != streamtypes) {
+		lwsl_err("%s: policy buffer too small\n", __func__);
+		free(buf);
+		return NULL;
+	}
+
+	*len = lws_ptr_diff_size_t(p, buf);
+
+	return buf;
+}
+
+static int
+policy_parse(struct lws_context *context, const char *pol, size_t len)
+{
+	const lws_ss_policy_t *pp;
+	int n = 0;
+
+	if (lws_ss_policy_parse_begin(context, 0))
+		return 1;
+
+	if (lws_ss_policy_parse(context, (const uint8_t *)pol, len) < 0)
+		/* it already abandoned the parse */
+		return 1;
+
+	for (pp = lws_ss_policy_get(context); pp; pp = pp->next)
+		n++;
+
+	lws_ss_policy_parse_abandon(context);
+
+	if (n != streamtypes) {
+		lwsl_err("%s: parsed %d streamtypes, expected %d\n", __func__,
+			 n, streamtypes);
+		return 1;
+	}
+
+	return 0;
+}
+
+static void
+sigint_handler(int sig)
+{
+	interrupted = 1;
+}
+
+int
+main(int argc, const char **argv)
+{
+	int logs = LLL_USER | LLL_ERR | LLL_WARN, e = 1, n;
+	struct lws_context_creation_info info;
+	struct lws_context *context;
+	lws_usec_t us;
+	const char *p;
+	size_t len;
+	char *pol;
+
+	signal(SIGINT, sigint_handler);
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--streamtypes")))
+		streamtypes = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--loops")))
+		loops = atoi(p);
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS minimal secure streams policy bench\n");
+
+	if (streamtypes < 1 || loops < 1) {
+		lwsl_err("--streamtypes and --loops must be at least 1\n");
+		return 1;
+	}
+
+	pol = policy_create(&len);
+	if (!pol)
+		return 1;
+
+	/*
+	 * We don't set LWS_SERVER_OPTION_EXPLICIT_VHOSTS, so the context
+	 * doesn't take on a policy of its own, we only use it to parse ours
+	 */
+
+	memset(&info, 0, sizeof info); /* otherwise uninitialized garbage */
+	info.port = CONTEXT_PORT_NO_LISTEN;
+
+	context = lws_create_context(&info);
+	if (!context) {
+		lwsl_err("lws init failed\n");
+		goto bail1;
+	}
+
+	/* once to warm up and check it parses at all */
+
+	if (policy_parse(context, pol, len))
+		goto bail;
+
+	us = lws_now_usecs();
+	for (n = 0; n < loops && !interrupted; n++)
+		if (policy_parse(context, pol, len))
+			goto bail;
+	us = lws_now_usecs() - us;
+	if (!n)
+		goto bail;
+
+	lwsl_user("%d streamtypes, %d members, %lu bytes: %lldus per parse, "
+		  "%lldns per member\n", streamtypes, members, (unsigned long)len,
+		  (long long)(us / n), (long long)((us * 1000) / n / members));
+	e = 0;
+
+bail:
+	lws_context_destroy(context);
+bail1:
+	free(pol);
+
+	lwsl_user("Completed: %s\n", e ? "FAIL" : "PASS");
+
+	return e;
+}
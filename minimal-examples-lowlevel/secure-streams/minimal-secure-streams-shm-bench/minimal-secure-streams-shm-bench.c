@@ -0,0 +1,407 @@
+/*
+ * lws-minimal-secure-streams-shm-bench
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This measures how fast a Secure Streams client can receive through the SS
+ * proxy, first over the default wsi (Unix Domain Socket) transport between
+ * the client and the proxy, and then over the shared memory transport.
+ *
+ * It forks a plain http server that serves the payload and, for each pass, a
+ * proxy process.  This process is the sspc client, it reports the throughput
+ * from the onward connection coming up to the end of the payload.
+ */
+
+#include <libwebsockets.h>
+#include <string.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+struct pass {
+	lws_usec_t		start;
+	lws_usec_t		end;
+	size_t			rx;
+	int			done;
+	int			fail;
+};
+
+typedef struct bench {
+	struct lws_sspc_handle	*ss;
+	void			*opaque_data;
+} bench_t;
+
+static struct lws_context *context;
+static size_t payload_size = 64 * 1024 * 1024;
+static int interrupted, port = 7694;
+static char policy[1024], sock[64], csock[66];
+static lws_state_notify_link_t nl;
+static struct pass *cur;
+
+static void
+sigterm_handler(int sig)
+{
+	interrupted = 1;
+	lws_cancel_service(context);
+}
+
+static int
+serve(struct lws_context_creation_info *info)
+{
+	signal(SIGTERM, sigterm_handler);
+
+	context = lws_create_context(info);
+	if (!context)
+		return 1;
+
+	while (!interrupted)
+		if (lws_service(context, 0) < 0)
+			break;
+
+	lws_context_destroy(context);
+
+	return 0;
+}
+
+/*
+ * The http server the proxy fetches the payload from
+ */
+
+static int
+callback_payload(struct lws *wsi, enum lws_callback_reasons reason,
+		 void *user, void *in, size_t len)
+{
+	uint8_t buf[LWS_PRE + 32768], *start = &buf[LWS_PRE], *p = start,
+		*end = &buf[sizeof(buf) - 1];
+	size_t *left = (size_t *)user, n;
+
+	switch (reason) {
+	case LWS_CALLBACK_HTTP:
+		*left = payload_size;
+		if (lws_add_http_common_headers(wsi, HTTP_STATUS_OK,
+				"application/octet-stream", payload_size,
+				&p, end) ||
+		    lws_finalize_write_http_header(wsi, start, &p, end))
+			return 1;
+
+		lws_callback_on_writable(wsi);
+		return 0;
+
+	case LWS_CALLBACK_HTTP_WRITEABLE:
+		n = *left;
+		if (n > sizeof(buf) - LWS_PRE)
+			n = sizeof(buf) - LWS_PRE;
+		memset(start, (int)(*left & 0xff), n);
+		*left -= n;
+
+		if (lws_write(wsi, start, n, *left ? LWS_WRITE_HTTP :
+						     LWS_WRITE_HTTP_FINAL) !=
+							(int)n)
+			return 1;
+
+		if (*left)
+			lws_callback_on_writable(wsi);
+		else if (lws_http_transaction_completed(wsi))
+			return -1;
+		return 0;
+
+	default:
+		break;
+	}
+
+	return lws_callback_http_dummy(wsi, reason, user, in, len);
+}
+
+static const struct lws_protocols server_protocols[] = {
+	{ "http", callback_payload, sizeof(size_t), 0, 0, NULL, 0 },
+	LWS_PROTOCOL_LIST_TERM
+};
+
+static int
+run_server(void)
+{
+	struct lws_context_creation_info info;
+
+	memset(&info, 0, sizeof info);
+	info.port = port;
+	info.iface = "127.0.0.1";
+	info.protocols = server_protocols;
+
+	return serve(&info);
+}
+
+/*
+ * The proxy, it creates the proxy listener once the system state is
+ * operational
+ */
+
+static int
+app_system_state_nf(lws_state_manager_t *mgr, lws_state_notify_link_t *link,
+		    int current, int target)
+{
+	struct lws_context *cx = lws_system_context_from_system_mgr(mgr);
+
+	if (target == LWS_SYSTATE_OPERATIONAL &&
+	    current == LWS_SYSTATE_OPERATIONAL &&
+	    lws_ss_proxy_create(cx, sock, 0)) {
+		lwsl_err("%s: failed to create ss proxy\n", __func__);
+		return -1;
+	}
+
+	return 0;
+}
+
+static lws_state_notify_link_t * const app_notifier_list[] = {
+	&nl, NULL
+};
+
+static int
+run_proxy(int shm)
+{
+	struct lws_context_creation_info info;
+
+	/* the proxy logs each rx flow control transition as a user message */
+	lws_set_log_level(LLL_ERR | LLL_WARN, NULL);
+
+	lws_snprintf(policy, sizeof(policy),
+		"{"
+		  "\"release\":"		"\"01234567\","
+		  "\"product\":"		"\"myproduct\","
+		  "\"schema-version\":"		"1,"
+		  "\"retry\": [{\"default\": {"
+			"\"backoff\": [1000, 2000],"
+			"\"conceal\":"		"2,"
+			"\"jitterpc\":"		"20,"
+			"\"svalidping\":"	"30,"
+			"\"svalidhup\":"	"35"
+		  "}}],"
+		  "\"s\": [{\"bench\": {"
+			"\"endpoint\":"		"\"127.0.0.1\","
+			"\"port\":"		"%d,"
+			"\"protocol\":"		"\"h1\","
+			"\"http_method\":"	"\"GET\","
+			"\"http_url\":"		"\"bench\","
+			"\"retry\":"		"\"default\","
+			"\"proxy_buflen\":"	"1048576,"
+			"\"proxy_buflen_rxflow_on_above\":"	"786432,"
+			"\"proxy_buflen_rxflow_off_below\":"	"262144"
+		  "}}]"
+		"}", port);
+
+	memset(&info, 0, sizeof info);
+	info.port = CONTEXT_PORT_NO_LISTEN;
+	info.pss_policies_json = policy;
+	info.options = LWS_SERVER_OPTION_EXPLICIT_VHOSTS;
+	nl.name = "app";
+	nl.notify_cb = app_system_state_nf;
+	info.register_notifier_list = app_notifier_list;
+#if defined(LWS_WITH_SECURE_STREAMS_PROXY_SHM)
+	if (shm)
+		info.txp_ops_ssproxy = &lws_transport_shm_proxy_ops;
+#endif
+
+	return serve(&info);
+}
+
+/*
+ * The sspc client, in this process
+ */
+
+static lws_ss_state_return_t
+bench_rx(void *userobj, const uint8_t *buf, size_t len, int flags)
+{
+	cur->rx += len;
+
+	if (flags & LWSSS_FLAG_EOM) {
+		cur->end = lws_now_usecs();
+		cur->done = 1;
+	}
+
+	return LWSSSSRET_OK;
+}
+
+static lws_ss_state_return_t
+bench_tx(void *userobj, lws_ss_tx_ordinal_t ord, uint8_t *buf, size_t *len,
+	 int *flags)
+{
+	return LWSSSSRET_TX_DONT_SEND;
+}
+
+static lws_ss_state_return_t
+bench_state(void *userobj, void *sh, lws_ss_constate_t state,
+	    lws_ss_tx_ordinal_t ack)
+{
+	bench_t *b = (bench_t *)userobj;
+
+	switch (state) {
+	case LWSSSCS_CREATING:
+		return lws_sspc_client_connect(b->ss);
+
+	case LWSSSCS_CONNECTED:
+		cur->start = lws_now_usecs();
+		break;
+
+	case LWSSSCS_DISCONNECTED:
+	case LWSSSCS_ALL_RETRIES_FAILED:
+		if (!cur->done) {
+			cur->fail = 1;
+			cur->done = 1;
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	return LWSSSSRET_OK;
+}
+
+static const lws_ss_info_t ssi = {
+	.handle_offset			= offsetof(bench_t, ss),
+	.opaque_user_data_offset	= offsetof(bench_t, opaque_data),
+	.rx				= bench_rx,
+	.tx				= bench_tx,
+	.state				= bench_state,
+	.user_alloc			= sizeof(bench_t),
+	.streamtype			= "bench",
+};
+
+static int
+run_pass(struct pass *p, int shm)
+{
+	struct lws_context_creation_info info;
+	struct lws_sspc_handle *h;
+	lws_usec_t timeout;
+	pid_t proxy;
+	int ret = 1;
+
+	memset(p, 0, sizeof(*p));
+	cur = p;
+
+	lws_snprintf(sock, sizeof(sock), "@lws-ss-shm-bench-%d-%d",
+		     (int)getpid(), shm);
+
+	proxy = fork();
+	if (proxy < 0)
+		return 1;
+	if (!proxy)
+		_exit(run_proxy(shm));
+
+	memset(&info, 0, sizeof info);
+	info.port = CONTEXT_PORT_NO_LISTEN;
+	info.protocols = lws_sspc_protocols;
+	/* the client side marks a Unix Domain Socket address with + */
+	lws_snprintf(csock, sizeof(csock), "+%s", sock);
+	info.ss_proxy_bind = csock;
+#if defined(LWS_WITH_SECURE_STREAMS_PROXY_SHM)
+	if (shm)
+		info.txp_ops_sspc = &lws_transport_shm_client_ops;
+#endif
+
+	context = lws_create_context(&info);
+	if (!context)
+		goto bail;
+
+	/* until the proxy is up, this retries at 1Hz */
+
+	if (lws_sspc_create(context, 0, &ssi, NULL, &h, NULL, NULL)) {
+		lwsl_err("%s: failed to create sspc\n", __func__);
+		lws_context_destroy(context);
+		goto bail;
+	}
+
+	timeout = lws_now_usecs() + (60 * LWS_US_PER_SEC);
+	while (!p->done && lws_now_usecs() < timeout)
+		if (lws_service(context, 0) < 0)
+			break;
+
+	lws_sspc_destroy(&h);
+	lws_context_destroy(context);
+
+	if (!p->done)
+		lwsl_err("%s: timed out\n", __func__);
+
+	if (p->done && !p->fail && p->rx == payload_size)
+		ret = 0;
+	else
+		lwsl_err("%s: rx %llu / %llu\n", __func__,
+			 (unsigned long long)p->rx,
+			 (unsigned long long)payload_size);
+
+bail:
+	kill(proxy, SIGTERM);
+	waitpid(proxy, NULL, 0);
+
+	return ret;
+}
+
+static void
+report(const char *name, struct pass *p)
+{
+	lws_usec_t t = p->end - p->start;
+
+	if (!t)
+		t = 1;
+
+	lwsl_user("%s: %lluMB in %lldms, %lluMB/s\n", name,
+		  (unsigned long long)(p->rx / (1024 * 1024)),
+		  (long long)(t / LWS_US_PER_MS),
+		  (unsigned long long)(((uint64_t)p->rx * LWS_US_PER_SEC) /
+				       ((uint64_t)t * 1024 * 1024)));
+}
+
+int
+main(int argc, const char **argv)
+{
+	int logs = LLL_USER | LLL_ERR | LLL_WARN, e = 1;
+	struct pass wsi, shm;
+	const char *p;
+	pid_t server;
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--size")))
+		payload_size = (size_t)atoi(p) * 1024 * 1024;
+
+	if ((p = lws_cmdline_option(argc, argv, "--port")))
+		port = atoi(p);
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS minimal secure streams shm bench\n");
+
+	server = fork();
+	if (server < 0)
+		return 1;
+	if (!server)
+		_exit(run_server());
+
+	if (run_pass(&wsi, 0))
+		goto bail;
+	report("wsi transport", &wsi);
+
+#if defined(LWS_WITH_SECURE_STREAMS_PROXY_SHM)
+	if (run_pass(&shm, 1))
+		goto bail;
+	report("shm transport", &shm);
+#else
+	(void)shm;
+	lwsl_user("shm transport: not built, "
+		  "needs -DLWS_WITH_SECURE_STREAMS_PROXY_SHM=1\n");
+#endif
+
+	e = 0;
+
+bail:
+	kill(server, SIGTERM);
+	waitpid(server, NULL, 0);
+
+	lwsl_user("Completed: %s\n", e ? "FAIL" : "PASS");
+
+	return e;
+}
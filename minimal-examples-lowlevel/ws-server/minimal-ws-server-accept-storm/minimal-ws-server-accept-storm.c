@@ -0,0 +1,210 @@
+/*
+ * lws-minimal-ws-server-accept-storm
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This measures how many ws connections per second an lws server can accept,
+ * upgrade and close again.
+ *
+ * A thread opens connections to the server on loopback in bursts, using plain
+ * blocking sockets so the client side costs as little as possible, sends a ws
+ * upgrade on each, waits for the 101 responses and closes them all, while the
+ * main thread services the lws server.
+ *
+ * Build lws with and without -DLWS_WITH_WSI_SLAB=1 to compare struct lws and
+ * the ws structs coming from per-service thread slab caches, or the heap.
+ */
+
+#include <libwebsockets.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define BURST 64
+
+static struct lws_context *context;
+static int port = 7702, count = 20000, established, fail;
+static volatile int done;
+static lws_usec_t t_start, t_end;
+
+static const char upgrade[] =
+	"GET / HTTP/1.1\r\n"
+	"Host: 127.0.0.1\r\n"
+	"Upgrade: websocket\r\n"
+	"Connection: Upgrade\r\n"
+	"Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+	"Sec-WebSocket-Protocol: storm\r\n"
+	"Sec-WebSocket-Version: 13\r\n\r\n";
+
+static int
+callback_storm(struct lws *wsi, enum lws_callback_reasons reason,
+	       void *user, void *in, size_t len)
+{
+	if (reason == LWS_CALLBACK_ESTABLISHED)
+		established++;
+
+	return 0;
+}
+
+static const struct lws_protocols protocols[] = {
+	{ "storm", callback_storm, 0, 0, 0, NULL, 0 },
+	LWS_PROTOCOL_LIST_TERM
+};
+
+static int
+storm_connect(const struct sockaddr_in *sin)
+{
+	struct timeval tv = { 5, 0 };
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+	if (fd < 0)
+		return -1;
+
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+	if (connect(fd, (const struct sockaddr *)sin, sizeof(*sin)) ||
+	    write(fd, upgrade, sizeof(upgrade) - 1) !=
+					(ssize_t)(sizeof(upgrade) - 1)) {
+		close(fd);
+
+		return -1;
+	}
+
+	return fd;
+}
+
+static int
+storm_response(int fd)
+{
+	char buf[512];
+	size_t n = 0;
+	ssize_t m;
+
+	/* we just need to see the end of the 101 headers */
+
+	while (n < sizeof(buf) - 1) {
+		m = read(fd, buf + n, sizeof(buf) - 1 - n);
+		if (m <= 0)
+			return 1;
+		n += (size_t)m;
+		buf[n] = '\0';
+		if (strstr(buf, "\r\n\r\n"))
+			return strncmp(buf, "HTTP/1.1 101", 12) != 0;
+	}
+
+	return 1;
+}
+
+static void *
+thread_storm(void *d)
+{
+	struct sockaddr_in sin;
+	int fds[BURST], n, b, m;
+
+	memset(&sin, 0, sizeof(sin));
+	sin.sin_family = AF_INET;
+	sin.sin_port = htons((uint16_t)port);
+	sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	t_start = lws_now_usecs();
+
+	for (n = 0; n < count && !fail; n += b) {
+		b = count - n < BURST ? count - n : BURST;
+
+		for (m = 0; m < b; m++) {
+			fds[m] = storm_connect(&sin);
+			if (fds[m] < 0) {
+				fail = 1;
+				b = m;
+				break;
+			}
+		}
+
+		for (m = 0; m < b; m++) {
+			if (!fail && storm_response(fds[m]))
+				fail = 1;
+			close(fds[m]);
+		}
+	}
+
+	t_end = lws_now_usecs();
+	done = 1;
+	lws_cancel_service(context);
+
+	return NULL;
+}
+
+int
+main(int argc, const char **argv)
+{
+	int logs = LLL_USER | LLL_ERR | LLL_WARN;
+	struct lws_context_creation_info info;
+	lws_usec_t t;
+	pthread_t pt;
+	const char *p;
+	void *retval;
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--count")))
+		count = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--port")))
+		port = atoi(p);
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS minimal ws server accept storm\n");
+
+	memset(&info, 0, sizeof info); /* otherwise uninitialized garbage */
+	info.port = port;
+	info.protocols = protocols;
+
+	context = lws_create_context(&info);
+	if (!context) {
+		lwsl_err("lws init failed\n");
+		return 1;
+	}
+
+	if (pthread_create(&pt, NULL, thread_storm, NULL)) {
+		lwsl_err("thread creation failed\n");
+		lws_context_destroy(context);
+		return 1;
+	}
+
+	while (!done)
+		if (lws_service(context, 0) < 0)
+			break;
+
+	pthread_join(pt, &retval);
+	lws_context_destroy(context);
+
+	t = t_end - t_start;
+	if (!t)
+		t = 1;
+
+	if (!fail && established == count)
+		lwsl_user("%s: %d connections in %lldms, %llu/s\n",
+#if defined(LWS_WITH_WSI_SLAB)
+			  "slab",
+#else
+			  "heap",
+#endif
+			  count, (long long)(t / LWS_US_PER_MS),
+			  (unsigned long long)(((uint64_t)count *
+						LWS_US_PER_SEC) / (uint64_t)t));
+	else
+		fail = 1;
+
+	lwsl_user("Completed: %s\n", fail ? "FAIL" : "PASS");
+
+	return fail;
+}
@@ -0,0 +1,622 @@
+/*
+ * lws-minimal-ws-server-broadcast
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This measures what it costs the server to send the same messages to many
+ * ws clients, either using lws_write() on each connection, which frames and
+ * compresses every message again for each one, or queuing one encode-once
+ * lws_ws_bcast object per message on all of them.
+ *
+ * A thread opens the clients on loopback using plain blocking sockets, so the
+ * client side costs as little as possible.  A third of them don't offer
+ * permessage-deflate, and the server uses a smaller window for every other
+ * one that does, so there are three different wire formats.  Each message
+ * goes to every client, and the clients check everything arrives intact and
+ * in order.
+ *
+ * With --private, each message is followed by a private message to that
+ * client which is the same every time, so the connection's own compressor
+ * refers back to the last one across the broadcast... this checks lws resets
+ * it after a broadcast went out on the connection.
+ */
+
+#include <libwebsockets.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+#include <zlib.h>
+#endif
+
+#define BURST		64
+#define MSG_MAX		2048
+#define RX_MAX		16384
+
+struct pss {
+	lws_dll2_t		list;
+	struct lws		*wsi;
+	int			next;	/* next round to send */
+	int			priv;	/* private messages sent */
+};
+
+struct conn {
+	uint8_t			rx[RX_MAX];
+	uint8_t			msg[RX_MAX + 4];
+	uint8_t			out[MSG_MAX];
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+	z_stream		inf;
+#endif
+	size_t			used;
+	size_t			mlen;
+	int			fd;
+	int			bseq;
+	int			privs;
+	char			comp;
+	char			mcomp;
+};
+
+static struct lws_context *context;
+static int port = 7704, clients = 300, rounds = 200, per_wsi, privates, fail,
+	   fallback, started;
+static volatile int done;
+static lws_usec_t t_start, t_end, cpu_start, cpu_end;
+static lws_dll2_owner_t owner;
+static struct lws_ws_bcast **bcasts;
+static uint8_t *msgs[1000], priv_msg[LWS_PRE + 256];
+static size_t msg_len[1000], priv_len;
+
+static const char *ext_offer[] = {
+	"",
+	"Sec-WebSocket-Extensions: permessage-deflate; "
+		"client_max_window_bits\r\n",
+	"Sec-WebSocket-Extensions: permessage-deflate\r\n",
+};
+
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+static const struct lws_extension extensions[] = {
+	{
+		"permessage-deflate",
+		lws_extension_callback_pm_deflate,
+		"permessage-deflate"
+		 "; client_no_context_takeover"
+		 "; client_max_window_bits"
+	},
+	{ NULL, NULL, NULL /* terminator */ }
+};
+#endif
+
+static lws_usec_t
+cpu_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+	return ((lws_usec_t)ts.tv_sec * LWS_US_PER_SEC) + (ts.tv_nsec / 1000);
+}
+
+/* something like a market data update, so it compresses like real data */
+
+static void
+make_msg(int r)
+{
+	static const char *syms[] = { "AAPL", "MSFT", "GOOG", "AMZN",
+				      "NVDA", "META", "TSLA", "NFLX" };
+	uint32_t seed = (uint32_t)r * 2654435761u;
+	char *p = (char *)msgs[r] + LWS_PRE;
+	int n, i;
+
+	n = lws_snprintf(p, MSG_MAX, "{\"seq\":%d,\"quotes\":[", r);
+	for (i = 0; i < 20; i++) {
+		seed = seed * 1103515245u + 12345u;
+		n += lws_snprintf(p + n, (size_t)(MSG_MAX - n),
+			"%s{\"sym\":\"%s\",\"bid\":%u.%02u,\"ask\":%u.%02u,"
+			"\"size\":%u}", i ? "," : "", syms[(seed >> 16) & 7],
+			100 + ((seed >> 8) & 0xff), seed % 100,
+			101 + ((seed >> 8) & 0xff), (seed >> 4) % 100,
+			(seed >> 20) & 0x3ff);
+	}
+	n += lws_snprintf(p + n, (size_t)(MSG_MAX - n), "]}");
+
+	msg_len[r] = (size_t)n;
+}
+
+static int
+callback_bcast(struct lws *wsi, enum lws_callback_reasons reason,
+	       void *user, void *in, size_t len)
+{
+	struct pss *pss = (struct pss *)user;
+	int n;
+
+	switch (reason) {
+	case LWS_CALLBACK_ESTABLISHED:
+		pss->wsi = wsi;
+		lws_dll2_add_tail(&pss->list, &owner);
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+		/*
+		 * The peer can always take a smaller window than it agreed
+		 * to, this gives the broadcasts another variant to make
+		 */
+		if (owner.count & 1)
+			lws_set_extension_option(wsi, "permessage-deflate",
+						 "server_max_window_bits", "10");
+#endif
+		if ((int)owner.count != clients)
+			break;
+
+		/* everybody is here, start sending to all of them */
+
+		started = 1;
+		t_start = lws_now_usecs();
+		cpu_start = cpu_us();
+		lws_start_foreach_dll(struct lws_dll2 *, d, owner.head) {
+			lws_callback_on_writable(lws_container_of(d,
+						struct pss, list)->wsi);
+		} lws_end_foreach_dll(d);
+		break;
+
+	case LWS_CALLBACK_CLOSED:
+		lws_dll2_remove(&pss->list);
+		break;
+
+	case LWS_CALLBACK_SERVER_WRITEABLE:
+		if (!started)
+			break;
+
+		if (per_wsi) {
+			/* the message, and its private follow-up */
+
+			if (pss->next < rounds && pss->priv == pss->next) {
+				n = lws_write(wsi, msgs[pss->next] + LWS_PRE,
+					      msg_len[pss->next],
+					      LWS_WRITE_TEXT);
+				if (n < (int)msg_len[pss->next])
+					return -1;
+				pss->next++;
+				if (lws_partial_buffered(wsi)) {
+					lws_callback_on_writable(wsi);
+					break;
+				}
+			}
+		}
+
+		if (pss->priv < pss->next) {
+			if (privates) {
+				n = lws_write(wsi, priv_msg + LWS_PRE,
+					      priv_len, LWS_WRITE_TEXT);
+				if (n < (int)priv_len)
+					return -1;
+			}
+			pss->priv++;
+		}
+
+		if (!per_wsi && pss->next < rounds) {
+			/*
+			 * lws sends it next time we're writeable, before
+			 * our WRITEABLE callback
+			 */
+			n = lws_ws_bcast_queue(wsi, bcasts[pss->next]);
+			if (n < 0)
+				return -1;
+			if (n) {
+				/* this wsi can't share frames */
+				fallback++;
+				n = lws_write(wsi, msgs[pss->next] + LWS_PRE,
+					      msg_len[pss->next],
+					      LWS_WRITE_TEXT);
+				if (n < (int)msg_len[pss->next])
+					return -1;
+			}
+			pss->next++;
+			break;
+		}
+
+		if (pss->priv < rounds)
+			lws_callback_on_writable(wsi);
+		break;
+
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+static const struct lws_protocols protocols[] = {
+	{ "bcast", callback_bcast, sizeof(struct pss), 0, 0, NULL, 0 },
+	LWS_PROTOCOL_LIST_TERM
+};
+
+static int
+conn_open(struct conn *c, const struct sockaddr_in *sin, int idx)
+{
+	struct timeval tv = { 5, 0 };
+	char req[512];
+	int n;
+
+	c->fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (c->fd < 0)
+		return 1;
+
+	setsockopt(c->fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+	n = lws_snprintf(req, sizeof(req),
+			"GET / HTTP/1.1\r\n"
+			"Host: 127.0.0.1\r\n"
+			"Upgrade: websocket\r\n"
+			"Connection: Upgrade\r\n"
+			"Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+			"Sec-WebSocket-Protocol: bcast\r\n"
+			"%s"
+			"Sec-WebSocket-Version: 13\r\n\r\n", ext_offer[idx % 3]);
+
+	return connect(c->fd, (const struct sockaddr *)sin, sizeof(*sin)) ||
+	       write(c->fd, req, (size_t)n) != (ssize_t)n;
+}
+
+static int
+conn_upgraded(struct conn *c, int idx)
+{
+	ssize_t m;
+	char *e;
+
+	/* the 101, and maybe the start of the first frames behind it */
+
+	while (c->used < sizeof(c->rx) - 1) {
+		m = read(c->fd, c->rx + c->used, sizeof(c->rx) - 1 - c->used);
+		if (m <= 0)
+			return 1;
+		c->used += (size_t)m;
+		c->rx[c->used] = '\0';
+
+		e = strstr((char *)c->rx, "\r\n\r\n");
+		if (!e)
+			continue;
+
+		if (strncmp((char *)c->rx, "HTTP/1.1 101", 12))
+			return 1;
+
+		*e = '\0';
+		c->comp = !!strstr((char *)c->rx, "permessage-deflate");
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+		if (c->comp != !!(idx % 3)) {
+			lwsl_err("%s: pmd not negotiated as expected\n",
+				 __func__);
+			return 1;
+		}
+		if (c->comp && inflateInit2(&c->inf, -15) != Z_OK)
+			return 1;
+#endif
+		e += 4;
+		c->used -= lws_ptr_diff_size_t(e, c->rx);
+		memmove(c->rx, e, c->used);
+
+		return 0;
+	}
+
+	return 1;
+}
+
+static int
+conn_message(struct conn *c)
+{
+	const uint8_t *m = c->msg;
+	size_t len = c->mlen;
+
+	if (c->mcomp) {
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+		static const uint8_t trail[] = { 0, 0, 0xff, 0xff };
+
+		memcpy(c->msg + c->mlen, trail, 4);
+		c->inf.next_in = c->msg;
+		c->inf.avail_in = (uInt)c->mlen + 4;
+		c->inf.next_out = c->out;
+		c->inf.avail_out = sizeof(c->out);
+		if (inflate(&c->inf, Z_SYNC_FLUSH) != Z_OK ||
+		    c->inf.avail_in) {
+			lwsl_err("%s: inflate failed: %s\n", __func__,
+				 c->inf.msg ? c->inf.msg : "");
+			return 1;
+		}
+		m = c->out;
+		len = sizeof(c->out) - c->inf.avail_out;
+#else
+		return 1;
+#endif
+	}
+
+	if (c->bseq < rounds && len == msg_len[c->bseq] &&
+	    !memcmp(m, msgs[c->bseq] + LWS_PRE, len)) {
+		if (privates && c->privs != c->bseq)
+			return 1;
+		c->bseq++;
+
+		return 0;
+	}
+
+	if (len == priv_len && !memcmp(m, priv_msg + LWS_PRE, len) &&
+	    c->privs < c->bseq) {
+		c->privs++;
+
+		return 0;
+	}
+
+	lwsl_err("%s: unexpected message (seq %d, priv %d)\n", __func__,
+		 c->bseq, c->privs);
+
+	return 1;
+}
+
+static int
+conn_parse(struct conn *c)
+{
+	size_t hl, plen, pos = 0;
+	uint8_t *p;
+
+	while (c->used - pos >= 2) {
+		p = c->rx + pos;
+		hl = 2;
+		plen = p[1] & 0x7f;
+		if (plen == 126) {
+			hl = 4;
+			if (c->used - pos < hl)
+				break;
+			plen = (size_t)((p[2] << 8) | p[3]);
+		} else if (plen == 127)
+			return 1; /* never that big here */
+
+		if (c->used - pos < hl + plen)
+			break;
+
+		if (p[0] & 8)
+			return 1; /* not expecting any control frames */
+
+		if (p[0] & 0xf) { /* not CONTINUATION, a new message */
+			c->mcomp = !!(p[0] & 0x40);
+			c->mlen = 0;
+			if (c->mcomp && !c->comp)
+				return 1;
+		}
+
+		if (c->mlen + plen > RX_MAX)
+			return 1;
+		memcpy(c->msg + c->mlen, p + hl, plen);
+		c->mlen += plen;
+
+		if ((p[0] & 0x80) && conn_message(c))
+			return 1;
+
+		pos += hl + plen;
+	}
+
+	c->used -= pos;
+	memmove(c->rx, c->rx + pos, c->used);
+
+	return 0;
+}
+
+static int
+conn_rx(struct conn *c)
+{
+	ssize_t r;
+
+	r = read(c->fd, c->rx + c->used, sizeof(c->rx) - c->used);
+	if (r <= 0)
+		return 1;
+	c->used += (size_t)r;
+
+	return conn_parse(c);
+}
+
+static void *
+thread_clients(void *d)
+{
+	struct pollfd *pfd = NULL;
+	struct conn *conns = NULL;
+	struct sockaddr_in sin;
+	int n, b, m, finished = 0;
+
+	memset(&sin, 0, sizeof(sin));
+	sin.sin_family = AF_INET;
+	sin.sin_port = htons((uint16_t)port);
+	sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	conns = calloc((size_t)clients, sizeof(*conns));
+	pfd = calloc((size_t)clients, sizeof(*pfd));
+	if (!conns || !pfd)
+		goto bail;
+
+	for (n = 0; n < clients; n++)
+		conns[n].fd = -1;
+
+	for (n = 0; n < clients; n += b) {
+		b = clients - n < BURST ? clients - n : BURST;
+
+		for (m = n; m < n + b; m++)
+			if (conn_open(&conns[m], &sin, m))
+				goto bail;
+
+		for (m = n; m < n + b; m++)
+			if (conn_upgraded(&conns[m], m))
+				goto bail;
+	}
+
+	/* frames may have arrived behind the 101 already */
+
+	for (n = 0; n < clients; n++) {
+		if (conn_parse(&conns[n]))
+			goto bail;
+		pfd[n].fd = conns[n].fd;
+		pfd[n].events = POLLIN;
+	}
+
+	while (finished < clients) {
+		n = poll(pfd, (nfds_t)clients, 5000);
+		if (n <= 0) {
+			lwsl_err("%s: stalled\n", __func__);
+			goto bail;
+		}
+
+		for (n = 0; n < clients; n++) {
+			if (!(pfd[n].revents & POLLIN))
+				continue;
+
+			if (conn_rx(&conns[n]))
+				goto bail;
+
+			if (conns[n].bseq == rounds &&
+			    (!privates || conns[n].privs == rounds)) {
+				pfd[n].fd = -1;
+				finished++;
+			}
+		}
+	}
+
+	t_end = lws_now_usecs();
+	goto out;
+
+bail:
+	fail = 1;
+out:
+	if (conns)
+		for (n = 0; n < clients; n++) {
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+			if (conns[n].comp)
+				inflateEnd(&conns[n].inf);
+#endif
+			if (conns[n].fd >= 0)
+				close(conns[n].fd);
+		}
+	free(conns);
+	free(pfd);
+
+	done = 1;
+	lws_cancel_service(context);
+
+	return NULL;
+}
+
+int
+main(int argc, const char **argv)
+{
+	int logs = LLL_USER | LLL_ERR | LLL_WARN, n;
+	struct lws_context_creation_info info;
+	pthread_t pt;
+	const char *p;
+	void *retval;
+	lws_usec_t t;
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--clients")))
+		clients = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--rounds")))
+		rounds = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--port")))
+		port = atoi(p);
+
+	per_wsi = !!lws_cmdline_option(argc, argv, "--per-wsi");
+	privates = !!lws_cmdline_option(argc, argv, "--private");
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS minimal ws server broadcast (%s)\n",
+		  per_wsi ? "lws_write per wsi" : "encode-once");
+
+	if (clients < 1 || rounds < 1 ||
+	    rounds > (int)LWS_ARRAY_SIZE(msgs)) {
+		lwsl_err("--clients must be > 0, --rounds 1 .. %d\n",
+			 (int)LWS_ARRAY_SIZE(msgs));
+		return 1;
+	}
+
+	bcasts = calloc((size_t)rounds, sizeof(*bcasts));
+	if (!bcasts)
+		return 1;
+
+	for (n = 0; n < rounds; n++) {
+		msgs[n] = malloc(LWS_PRE + MSG_MAX);
+		if (!msgs[n])
+			return 1;
+		make_msg(n);
+
+		/* encode-once mode holds these until the end */
+		if (!per_wsi) {
+			bcasts[n] = lws_ws_bcast_create(msgs[n] + LWS_PRE,
+							msg_len[n],
+							LWS_WRITE_TEXT);
+			if (!bcasts[n])
+				return 1;
+		}
+	}
+
+	priv_len = (size_t)lws_snprintf((char *)priv_msg + LWS_PRE,
+			sizeof(priv_msg) - LWS_PRE,
+			"{\"private\":{\"account\":\"0042-7781\",\"alerts\":[],"
+			"\"watchlist\":[\"AAPL\",\"NVDA\",\"TSLA\"],"
+			"\"note\":\"positions unchanged since last update\"}}");
+
+	memset(&info, 0, sizeof info); /* otherwise uninitialized garbage */
+	info.port = port;
+	info.protocols = protocols;
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+	info.extensions = extensions;
+#endif
+
+	context = lws_create_context(&info);
+	if (!context) {
+		lwsl_err("lws init failed\n");
+		return 1;
+	}
+
+	if (pthread_create(&pt, NULL, thread_clients, NULL)) {
+		lwsl_err("thread creation failed\n");
+		lws_context_destroy(context);
+		return 1;
+	}
+
+	while (!done)
+		if (lws_service(context, 0) < 0)
+			break;
+
+	cpu_end = cpu_us();
+	pthread_join(pt, &retval);
+	lws_context_destroy(context);
+
+	for (n = 0; n < rounds; n++) {
+		lws_ws_bcast_release(bcasts[n]);
+		free(msgs[n]);
+	}
+	free(bcasts);
+
+	t = t_end - t_start;
+	if (!fail && t > 0) {
+		lwsl_user("%d clients x %d messages: server cpu %lldms, "
+			  "%lldns per message per client, wall %lldms\n",
+			  clients, rounds,
+			  (long long)((cpu_end - cpu_start) / LWS_US_PER_MS),
+			  (long long)(((cpu_end - cpu_start) * 1000) /
+				      ((lws_usec_t)clients * rounds)),
+			  (long long)(t / LWS_US_PER_MS));
+		if (fallback)
+			lwsl_user("%d sent by lws_write()\n", fallback);
+	} else
+		fail = 1;
+
+	lwsl_user("Completed: %s\n", fail ? "FAIL" : "PASS");
+
+	return fail;
+}
@@ -0,0 +1,200 @@
+/*
+ * lws-minimal-ws-server-idle-mem
+ *
+ * Written in 2010-2021 by Andy Green <andy@warmcat.com>
+ *
+ * This file is made available under the Creative Commons CC0 1.0
+ * Universal Public Domain Dedication.
+ *
+ * This opens a lot of ws connections on loopback from an lws client in the
+ * same process, has each send one message, and then measures how much lws
+ * heap each connection costs while it sits idle.
+ *
+ * It does it first with the default per-connection rx buffers, and then
+ * again with LWS_SERVER_OPTION_WS_LAZY_RX_BUF on the vhost.
+ *
+ * To exclude the fixed costs, like pooled ah and rx buffers that are kept
+ * for reuse, the connections are opened in two equal batches and only the
+ * growth across the second batch is counted.
+ */
+
+#include <libwebsockets.h>
+#include <string.h>
+#include <stdlib.h>
+
+static struct lws_context *context;
+static lws_sorted_usec_list_t sul_settle;
+static int port = 7700, count = 1000, rx, up, fail;
+
+static int
+callback_idle(struct lws *wsi, enum lws_callback_reasons reason,
+	      void *user, void *in, size_t len)
+{
+	uint8_t buf[LWS_PRE + 16];
+
+	switch (reason) {
+
+	/* the server side */
+
+	case LWS_CALLBACK_RECEIVE:
+		rx++;
+		break;
+
+	/* the client side */
+
+	case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
+		if (!fail)
+			lwsl_err("CLIENT_CONNECTION_ERROR: %s\n",
+				 in ? (char *)in : "(null)");
+		fail = 1;
+		break;
+
+	case LWS_CALLBACK_CLIENT_ESTABLISHED:
+		up++;
+		lws_callback_on_writable(wsi);
+		break;
+
+	case LWS_CALLBACK_CLIENT_WRITEABLE:
+		memcpy(&buf[LWS_PRE], "hello", 5);
+		if (lws_write(wsi, &buf[LWS_PRE], 5, LWS_WRITE_TEXT) < 5)
+			return -1;
+		break;
+
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+static const struct lws_protocols protocols[] = {
+	{ "idle", callback_idle, 0, 0, 0, NULL, 0 },
+	LWS_PROTOCOL_LIST_TERM
+};
+
+static void
+settle_cb(lws_sorted_usec_list_t *sul)
+{
+	/* nothing to do, it just makes the event loop come around */
+
+	lws_sul_schedule(context, 0, &sul_settle, settle_cb,
+			 100 * LWS_US_PER_MS);
+}
+
+static int
+settle(int until_rx, lws_usec_t us)
+{
+	lws_usec_t end = lws_now_usecs() + us;
+
+	lws_sul_schedule(context, 0, &sul_settle, settle_cb, us);
+
+	while (!fail && (rx < until_rx || lws_now_usecs() < end))
+		if (lws_service(context, 0) < 0 ||
+		    lws_now_usecs() > end + (20 * LWS_US_PER_SEC))
+			return 1;
+
+	return fail;
+}
+
+static int
+batch(void)
+{
+	struct lws_client_connect_info i;
+	int n;
+
+	memset(&i, 0, sizeof i); /* otherwise uninitialized garbage */
+	i.context = context;
+	i.port = port;
+	i.address = "127.0.0.1";
+	i.path = "/";
+	i.host = i.address;
+	i.origin = i.address;
+	i.protocol = protocols[0].name;
+
+	for (n = 0; n < count; n++)
+		if (!lws_client_connect_via_info(&i)) {
+			lwsl_err("%s: client connect failed\n", __func__);
+			return 1;
+		}
+
+	return 0;
+}
+
+static int
+run_pass(const char *name, int lazy)
+{
+	struct lws_context_creation_info info;
+	size_t heap1, heap2;
+	int e = 1;
+
+	rx = up = fail = 0;
+
+	memset(&info, 0, sizeof info); /* otherwise uninitialized garbage */
+	info.port = port;
+	info.protocols = protocols;
+	if (lazy)
+		info.options |= LWS_SERVER_OPTION_WS_LAZY_RX_BUF;
+
+	context = lws_create_context(&info);
+	if (!context) {
+		lwsl_err("lws init failed\n");
+		return 1;
+	}
+
+	if (batch() || settle(count, 100 * LWS_US_PER_MS))
+		goto bail;
+	heap1 = lws_get_allocated_heap();
+
+	if (batch() || settle(count * 2, 100 * LWS_US_PER_MS))
+		goto bail;
+	heap2 = lws_get_allocated_heap();
+
+	if (up != count * 2) {
+		lwsl_err("%s: only %d / %d up\n", __func__, up, count * 2);
+		goto bail;
+	}
+
+	if (!heap2)
+		lwsl_user("%s: heap accounting not available on this platform\n",
+			  name);
+	else
+		lwsl_user("%s: %d idle connections, %lu bytes heap each "
+			  "(client + server side)\n", name, count * 2,
+			  (unsigned long)((heap2 - heap1) / (size_t)count));
+
+	e = 0;
+
+bail:
+	if (e)
+		lwsl_err("%s: failed, rx %d, up %d\n", name, rx, up);
+	lws_sul_cancel(&sul_settle);
+	lws_context_destroy(context);
+
+	return e;
+}
+
+int
+main(int argc, const char **argv)
+{
+	int logs = LLL_USER | LLL_ERR | LLL_WARN, e;
+	const char *p;
+
+	if ((p = lws_cmdline_option(argc, argv, "-d")))
+		logs = atoi(p);
+
+	if ((p = lws_cmdline_option(argc, argv, "--count")))
+		count = atoi(p) / 2;
+
+	if ((p = lws_cmdline_option(argc, argv, "--port")))
+		port = atoi(p);
+
+	lws_set_log_level(logs, NULL);
+	lwsl_user("LWS minimal ws server idle mem\n");
+
+	e = run_pass("per-connection rx buf", 0) ||
+	    run_pass("lazy rx buf          ", 1);
+
+	lwsl_user("Completed: %s\n", e ? "FAIL" : "PASS");
+
+	return e;
+}